@@ -29,6 +29,7 @@ function (ltjs_add_defaults)
 			$<$<CONFIG:DEBUG>:_DEBUG>
 			$<$<BOOL:${LTJS_SDL_BACKEND}>:LTJS_SDL_BACKEND>
 			$<$<BOOL:${LTJS_USE_D3DX9}>:LTJS_USE_D3DX9>
+			$<$<BOOL:${LTJS_PROFILER}>:LTJS_PROFILER>
 	)
 
 	if (MSVC)
@@ -50,11 +50,15 @@
 #include "systimer.h"
 #include "ltobjectcreate.h"
 #include "particlesystem.h"
+#include "animtracker.h"
 #include "client_ticks.h"
 #include "iltdrawprim.h"
 
 #include "dtxmgr.h"
 
+#include "ltjs_profiler.h"
+#include "workerpool.h"
+
 //------------------------------------------------------------------
 //------------------------------------------------------------------
 // Holders and their headers.
@@ -127,10 +131,13 @@ extern int32 g_ScreenWidth, g_ScreenHeight;
 extern int32 g_CV_FullLightScale;
 extern LTVector g_ConsoleModelAdd;
 extern float g_CV_MaxFPS;
+extern int32 g_CV_MaxFPSSpinUS;
 extern int32 g_CV_ForceConsole;
 extern int32 g_CV_RenderEnable;
 extern int32 g_CV_ForceSoundDisable;
 extern int32 g_CV_DrawDebugGeometry;
+extern int32 g_CV_ShowPoseCacheStats;
+extern int32 g_CV_ShowModelSkinRebinds;
 
 #ifdef LITHTECH_ESD
 ILTRealAudioPlayer* g_pRealAudioPlayer = LTNULL;
@@ -229,6 +236,7 @@ LTRESULT CClientMgr::Init(const char *resTrees[MAX_RESTREES], uint32 nResTrees,
     m_hShellModule = NULL;
 
 	m_LastReceiveBandwidth = 0;
+	m_nModelSkinRebinds = 0;
     m_bInputState = true;
     m_bTrackingInputDevices = false;
 	SetFrameCode(0); //
@@ -754,30 +762,14 @@ void CClientMgr::TermConsole()
 }
 
 
-void cm_HandleMaxFPS(uint32 frameTicks)
+void cm_HandleMaxFPS(CFramePacer &pacer)
 {
-    float frameSeconds, wantedSeconds, startTime, curTime;
-    uint32 i;
-
-    if (g_CV_MaxFPS == 0.0f)
-        return;
-
-    g_CV_MaxFPS = LTCLAMP(g_CV_MaxFPS, 1.0f, 200.0f);
-
-    wantedSeconds = 1.0f / g_CV_MaxFPS;
-    frameSeconds = (float)frameTicks / cnt_NumTicksPerSecond();
-    if (frameSeconds < wantedSeconds)
+    if (g_CV_MaxFPS != 0.0f)
     {
-        startTime = time_GetTime();
-        for (i=0; i < 500; i++)
-        {
-            curTime = time_GetTime();
-            if ((curTime - startTime) > (wantedSeconds - frameSeconds))
-                break;
-
-            dsi_ClientSleep(1); // Sleep for 1 millisecond.
-        }
+        g_CV_MaxFPS = LTCLAMP(g_CV_MaxFPS, 1.0f, 1000.0f);
     }
+
+    pacer.EndFrame(g_CV_MaxFPS, (uint32)LTMAX(g_CV_MaxFPSSpinUS, 0));
 }
 
 
@@ -789,6 +781,9 @@ LTRESULT CClientMgr::Update()
     LTRESULT dResult;
     static LTRect rFPS (480,10,630,80);
 
+    LTJS_PROFILE_FRAME();
+    LTJS_PROFILE_ZONE("ClientMgr::Update");
+
 #ifndef _FINAL
     uint32 frameTicks;
 
@@ -874,6 +869,7 @@ LTRESULT CClientMgr::Update()
     if (dsi_IsClientActive())
 	{
         CountAdder cntAdd(&g_Ticks_Input);
+        LTJS_PROFILE_ZONE("ClientMgr::ProcessAllInput");
         ProcessAllInput(false);
     }
 
@@ -884,7 +880,10 @@ LTRESULT CClientMgr::Update()
 		// EndShell switches on these bools to determine if it should delay
 		// the deletion of m_pCurShell or if it should do it immediately.
 		m_bInCurShellUpdate = true;
-        dResult = m_pCurShell->Update();
+		{
+			LTJS_PROFILE_ZONE("ClientShell::Update");
+			dResult = m_pCurShell->Update();
+		}
 		m_bInCurShellUpdate = false;
 
 		// A shell was deleted this update.  Delete it now that we know it 
@@ -959,6 +958,21 @@ LTRESULT CClientMgr::Update()
             (float)dm_GetBytesAllocated() / 1000.0f, foo);
     }
 
+    // Model pose cache usage for this frame.
+    if (g_CV_ShowPoseCacheStats)
+    {
+		const ModelInstance::SPoseCacheStats &PoseStats = ModelInstance::GetPoseCacheStats(ClientType);
+        con_WhitePrintf("Client pose cache: %u hits, %u misses, %u evaluations",
+            PoseStats.m_nHits, PoseStats.m_nMisses, PoseStats.m_nEvaluations);
+    }
+
+	ModelInstance::GetPoseCacheStats(ClientType).Clear();
+
+    if (g_CV_ShowModelSkinRebinds)
+    {
+        con_WhitePrintf("Client model skin rebinds: %u", m_nModelSkinRebinds);
+    }
+
     // Tick counts.
     frameTicks = cnt_EndCounter(totalCounter);
 	g_Ticks_Total += frameTicks;
@@ -969,10 +983,10 @@ LTRESULT CClientMgr::Update()
     // For debugging...
     MaybeDrawConsole();
 
-    cm_HandleMaxFPS(frameTicks);                    // Lock framerate if they want.
-
 #endif
 
+    cm_HandleMaxFPS(m_FramePacer);                  // Lock framerate if they want.
+
     GraphicsBenchmarkingUpdate();  // Update the benchmark mgr
 
     #ifdef LITHTECH_ESD
@@ -1065,6 +1079,8 @@ void CClientMgr::ShowDrawSurface(uint flags)
 
     graph_mgr->Mgr()->Draw();
 
+    LTJS_PROFILE_ZONE("ClientMgr::SwapBuffers");
+
     if (r_GetRenderStruct()->m_bInitted) {
         r_GetRenderStruct()->SwapBuffers(flags); }
 }
@@ -1113,6 +1129,7 @@ LTRESULT CClientMgr::PlaySound(PlaySoundInfo *pPlaySoundInfo, FileRef *pFile, fl
 void CClientMgr::UpdateAllSounds()
 {
 	CountAdder cntAdd(&g_Ticks_Sound);
+	LTJS_PROFILE_ZONE("ClientMgr::UpdateAllSounds");
 
     if (!GetClientILTSoundMgrImpl()->IsValid() || !GetClientILTSoundMgrImpl()->IsEnabled())
         return;
@@ -1838,6 +1855,8 @@ bool CClientMgr::Render(CameraInstance *pCamera, int drawMode, LTObject **pObjec
     if (!r_IsRenderInitted() || m_bRendering)
         return false;
 
+    LTJS_PROFILE_ZONE("ClientMgr::Render");
+
     pDesc = &sceneDesc;
     pRenderStruct = r_GetRenderStruct();
 
@@ -2121,132 +2140,14 @@ LTRESULT CClientMgr::RemoveObjectFromClientWorld(LTObject *pObject)
 }
 
 
-void CClientMgr::UpdateParticleSystems()
-{
-    LTParticleSystem  *pSystem;
-    int nNewParticles;
-    LTLink *pCur, *pListHead;
-    uint32 flags;
-    LTBOOL bChanged;
-
-    if (m_nFrameTimeMS > 0)
-    {
-        pListHead = &m_ObjectMgr.m_ObjectLists[OT_PARTICLESYSTEM].m_Head;
-        for (pCur=pListHead->m_pNext; pCur != pListHead; pCur=pCur->m_pNext)
-        {
-            pSystem = (LTParticleSystem*)pCur->m_pData;
-
-            // Set its FLAG_WASDRAWN appropriately and avoid updating if possible.
-            flags = pSystem->m_Flags;
-            pSystem->m_Flags &= ~(FLAG_WASDRAWN | FLAG_INTERNAL1);
-            if (!(flags & FLAG_UPDATEUNSEEN) && !(flags & FLAG_INTERNAL1) && (pSystem->m_nChangedParticles == 0))
-            {
-                continue;
-            }
-            pSystem->m_Flags |= FLAG_WASDRAWN;
-
-			//now if we are paused though, we don't want to continue updating
-			if(pSystem->IsPaused())
-				continue;
-
-            if (pSystem->m_pSprite)
-            {
-                spr_UpdateTracker(&pSystem->m_SpriteTracker, m_nFrameTimeMS);
-                if (pSystem->m_SpriteTracker.m_pCurFrame)
-                    pSystem->m_pCurTexture = pSystem->m_SpriteTracker.m_pCurFrame->m_pTex;
-                else
-                    pSystem->m_pCurTexture = LTNULL;
-            }
-
-            nNewParticles = pSystem->m_nChangedParticles;
-
-            ps_StartUpdatingPositions(pSystem);
-            ps_UpdateParticles(pSystem, m_FrameTime);
-            bChanged = ps_EndUpdatingPositions(pSystem);
-
-			// Possibly do a MoveObject() on it to get it into the correct node.
-			if(nNewParticles > 0 || bChanged)
-			{
-				MoveObject(pSystem, &pSystem->GetPos(), LTTRUE);
-			}
-
-            pSystem->m_nChangedParticles = 0;
-        }
-    }
-}
-
-// update sprite anims only actually.
-void CClientMgr::UpdateAnimations()
-{
-    LTLink *pCur, *pListHead;
-
-    if (m_nFrameTimeMS > 0)
-    {
-        // Update sprite instances.
-        pListHead = &m_ObjectMgr.m_ObjectLists[OT_SPRITE].m_Head;
-        for (pCur=pListHead->m_pNext; pCur != pListHead; pCur=pCur->m_pNext)
-        {
-			SpriteInstance* pSprite = (SpriteInstance*)pCur->m_pData;
-
-			if(!pSprite->IsPaused())
-			{
-				spr_UpdateTracker(&pSprite->m_SpriteTracker, m_nFrameTimeMS);
-			}
-        }
-    }
-}
-
-void CClientMgr::UpdatePolyGrids() {
-    LTLink *pListHead, *pCur;
-    LTPolyGrid *pGrid;
-    uint32 flags, msFrameTime;
-
-    msFrameTime = m_nFrameTimeMS;
-    if (msFrameTime)
-    {
-        pListHead = &m_ObjectMgr.m_ObjectLists[OT_POLYGRID].m_Head;
-        for (pCur=pListHead->m_pNext; pCur != pListHead; pCur=pCur->m_pNext)
-        {
-            pGrid = (LTPolyGrid*)pCur->m_pData;
-
-            // Set its FLAG_WASDRAWN appropriately and avoid updating if possible.
-            flags = pGrid->m_Flags;
-            pGrid->m_Flags &= ~(FLAG_WASDRAWN | FLAG_INTERNAL1);
-            if (!(flags & FLAG_UPDATEUNSEEN) && !(flags & FLAG_INTERNAL1))
-            {
-                continue;
-            }
-            pGrid->m_Flags |= FLAG_WASDRAWN;
-
-            if (!pGrid->IsPaused() && pGrid->m_pSprite)
-            {
-                spr_UpdateTracker(&pGrid->m_SpriteTracker, msFrameTime);
-            }
-        }
-    }
-}
-
-
-void CClientMgr::UpdateLineSystems() {
-    LTLink *pListHead, *pCur;
-    LineSystem *pSystem;
-
-    pListHead = &m_ObjectMgr.m_ObjectLists[OT_LINESYSTEM].m_Head;
-    for (pCur=pListHead->m_pNext; pCur != pListHead; pCur=pCur->m_pNext)
-    {
-        pSystem = (LineSystem*)pCur->m_pData;
-
-		if(pSystem->m_bChanged)
-		{
-			// Do MoveObject to get it located correctly.
-			MoveObject(pSystem, &pSystem->GetPos(), LTTRUE);
-		}
-
-        pSystem->m_bChanged = LTFALSE;
-    }
-}
-
+//the object update pass is only split across threads for at least this many objects
+#define OBJECTUPDATE_THREAD_MIN_OBJECTS	64
+#define OBJECTUPDATE_MAX_BANDS			8
 
+extern int32 g_CV_ModelAnimLOD;
+extern float g_CV_ModelAnimLODScreenSize;
+extern int32 g_CV_ModelAnimLODDrawnMS;
+extern int32 g_CV_ModelAnimLODHiddenMS;
 
 uint32 g_Ticks_UpdateObjects;
 
@@ -2289,51 +2190,274 @@ static void ClientStringKeyCallback(LTAnimTracker *pTracker, AnimKeyFrame *pFram
     }
 #endif
 
-void CClientMgr::UpdateModels()
+//returns how long a model can go between pose evaluations, 0 if it should be evaluated every frame
+static uint32 GetModelAnimLODInterval(const ModelInstance *pModel)
 {
-	//determine if any time has even elapsed
-    if (m_nFrameTimeMS)
-    {
-		//it has, so we need to run through and update all models
-        LTLink *pListHead = &m_ObjectMgr.m_ObjectLists[OT_MODEL].m_Head;
+	if(!g_CV_ModelAnimLOD || (pModel->m_Flags & (FLAG_UPDATEUNSEEN | FLAG_REALLYCLOSE)))
+		return 0;
 
-		ModelInstance *pModel;
-		uint32         i;
+	//it wasn't drawn last frame
+	if(pModel->m_fAnimLODScreenSize <= 0.0f)
+		return (uint32)LTMAX(g_CV_ModelAnimLODHiddenMS, 0);
 
-		for (LTLink *pCur = pListHead->m_pNext; pCur != pListHead; pCur = pCur->m_pNext)
-        {
-            pModel = (ModelInstance*)pCur->m_pData;
+	if(pModel->m_fAnimLODScreenSize >= g_CV_ModelAnimLODScreenSize)
+		return 0;
+
+	//the smaller it is on screen, the longer it can go
+	float fScale = 1.0f - pModel->m_fAnimLODScreenSize / g_CV_ModelAnimLODScreenSize;
+	return (uint32)(LTMAX(g_CV_ModelAnimLODDrawnMS, 0) * fScale);
+}
+
+//returns true if advancing the model by nFrameTimeMS could fire one of its string keys
+static bool ModelPassesStringKey(ModelInstance *pModel, uint32 nFrameTimeMS)
+{
+	for (LTAnimTracker *pTracker = pModel->m_AnimTrackers; pTracker; pTracker = pTracker->GetNext())
+	{
+		if (trk_PassesStringKey(pTracker, nFrameTimeMS))
+			return true;
+	}
+
+	return false;
+}
+
+//advances the model animations and its sprite skins. The trackers always play on, so their times
+//and string keys are on time, but models that are small on screen or hidden keep their cached pose
+//for a while instead of evaluating a new one
+static void UpdateModelAnimation(ModelInstance *pModel, uint32 nFrameTimeMS)
+{
+	uint32 nInterval = GetModelAnimLODInterval(pModel);
+
+	pModel->m_fAnimLODScreenSize = 0.0f;
+	pModel->m_nAnimLODPendingMS += nFrameTimeMS;
+	pModel->m_bAnimLODHoldPose = (pModel->m_nAnimLODPendingMS < nInterval);
+
+	if(!pModel->m_bAnimLODHoldPose)
+		pModel->m_nAnimLODPendingMS = 0;
+
+	//setup the string callback and update the model animation
+	pModel->SetStringKeyCallback(ClientStringKeyCallback);
+	pModel->ClientUpdate(nFrameTimeMS);
+
+	//count down how many sprites we have to update. This is mainly because most
+	//don't have sprites, or only a single one so it avoids the need to go through
+	//every texture index since there can be quite a few
+	uint32 nSpritesLeft = pModel->m_nNumSprites;
+
+	for (uint32 i = 0; nSpritesLeft && (i < MAX_MODEL_TEXTURES); i++)
+	{
+		if (pModel->m_pSprites[i])
+		{
+			spr_UpdateTracker(&pModel->m_SpriteTrackers[i], nFrameTimeMS);
+
+			//we have one sprite left to update
+			nSpritesLeft--;
+		}
+	}
+}
+
+//the parallel half of the object update. This only touches the object itself, anything that
+//relinks it in the world tree or calls out of the engine is flagged for CommitObjectUpdate
+static void UpdateObjectParallel(ClientObjectUpdate &update, uint32 nFrameTimeMS, float fFrameTime)
+{
+	switch(update.m_pObject->m_ObjectType)
+	{
+		case OT_SPRITE:
+		{
+			SpriteInstance *pSprite = (SpriteInstance*)update.m_pObject;
+
+			if(!pSprite->IsPaused())
+			{
+				spr_UpdateTracker(&pSprite->m_SpriteTracker, nFrameTimeMS);
+			}
+		}
+		break;
+
+		case OT_PARTICLESYSTEM:
+		{
+			LTParticleSystem *pSystem = (LTParticleSystem*)update.m_pObject;
+
+			// Set its FLAG_WASDRAWN appropriately and avoid updating if possible.
+			uint32 flags = pSystem->m_Flags;
+			pSystem->m_Flags &= ~(FLAG_WASDRAWN | FLAG_INTERNAL1);
+			if (!(flags & FLAG_UPDATEUNSEEN) && !(flags & FLAG_INTERNAL1) && (pSystem->m_nChangedParticles == 0))
+			{
+				break;
+			}
+			pSystem->m_Flags |= FLAG_WASDRAWN;
+
+			//now if we are paused though, we don't want to continue updating
+			if(pSystem->IsPaused())
+				break;
+
+			if (pSystem->m_pSprite)
+			{
+				spr_UpdateTracker(&pSystem->m_SpriteTracker, nFrameTimeMS);
+				if (pSystem->m_SpriteTracker.m_pCurFrame)
+					pSystem->m_pCurTexture = pSystem->m_SpriteTracker.m_pCurFrame->m_pTex;
+				else
+					pSystem->m_pCurTexture = LTNULL;
+			}
+
+			int nNewParticles = pSystem->m_nChangedParticles;
+
+			ps_StartUpdatingPositions(pSystem);
+			ps_UpdateParticles(pSystem, fFrameTime, &update.m_pDeadParticles);
+			LTBOOL bChanged = ps_EndUpdatingPositions(pSystem);
+
+			// Possibly do a MoveObject() on it to get it into the correct node.
+			update.m_bMoveObject = (nNewParticles > 0 || bChanged);
+			update.m_bCommit = true;
+		}
+		break;
+
+		case OT_POLYGRID:
+		{
+			LTPolyGrid *pGrid = (LTPolyGrid*)update.m_pObject;
+
+			// Set its FLAG_WASDRAWN appropriately and avoid updating if possible.
+			uint32 flags = pGrid->m_Flags;
+			pGrid->m_Flags &= ~(FLAG_WASDRAWN | FLAG_INTERNAL1);
+			if (!(flags & FLAG_UPDATEUNSEEN) && !(flags & FLAG_INTERNAL1))
+			{
+				break;
+			}
+			pGrid->m_Flags |= FLAG_WASDRAWN;
+
+			if (!pGrid->IsPaused() && pGrid->m_pSprite)
+			{
+				spr_UpdateTracker(&pGrid->m_SpriteTracker, nFrameTimeMS);
+			}
+		}
+		break;
+
+		case OT_LINESYSTEM:
+		{
+			// Only the MoveObject is left to do.
+			update.m_bCommit = true;
+		}
+		break;
+
+		case OT_MODEL:
+		{
+			ModelInstance *pModel = (ModelInstance*)update.m_pObject;
 
 			//but don't update paused models
-			if(!pModel->IsPaused())
+			if(pModel->IsPaused())
+				break;
+
+			//models that get their string keys are animated afterwards on the main thread when they
+			//go past one, until then there is no callback that could touch anything else
+			if((pModel->cd.m_ClientFlags & CF_NOTIFYMODELKEYS) && ModelPassesStringKey(pModel, nFrameTimeMS))
 			{
-				//setup the string callback and update the model animation
-				pModel->SetStringKeyCallback(ClientStringKeyCallback);
-				pModel->ClientUpdate(m_nFrameTimeMS);
+				break;
+			}
 
-				//count down how many sprites we have to update. This is mainly because most
-				//don't have sprites, or only a single one so it avoids the need to go through
-				//every texture index since there can be quite a few
-				uint32 nSpritesLeft = pModel->m_nNumSprites;
+			UpdateModelAnimation(pModel, nFrameTimeMS);
+			pModel->m_bAnimUpdated = true;
 
-				for (i = 0; nSpritesLeft && (i < MAX_MODEL_TEXTURES); i++)
-				{
-					if (pModel->m_pSprites[i])
-					{
-						spr_UpdateTracker(&pModel->m_SpriteTrackers[i], m_nFrameTimeMS);
-
-						FileRef        skinName;
-						skinName.m_pFilename = pModel->m_SpriteTrackers[i].m_pCurFrame->m_pTex->m_pFile->m_Filename;
-						skinName.m_FileType = FILE_CLIENTFILE;
-						AddSharedTexture2(&skinName, pModel->m_pSkins[i]);
-
-						//we have one sprite left to update
-						nSpritesLeft--;
-					}
-				}
+			//the sprite skins still need to be bound
+			update.m_bCommit = (pModel->m_nNumSprites > 0);
+		}
+		break;
+	}
+}
+
+void CClientMgr::GatherObjectUpdates()
+{
+	//the commits are done in this order
+	static const uint32 s_UpdateTypes[] = { OT_SPRITE, OT_PARTICLESYSTEM, OT_POLYGRID, OT_LINESYSTEM, OT_MODEL };
+
+	m_ObjectUpdates.clear();
+
+	for (uint32 nType = 0; nType < sizeof(s_UpdateTypes) / sizeof(s_UpdateTypes[0]); nType++)
+	{
+		//line systems are the only objects that are updated when no time has elapsed
+		if (!m_nFrameTimeMS && (s_UpdateTypes[nType] != OT_LINESYSTEM))
+			continue;
+
+		LTLink *pListHead = &m_ObjectMgr.m_ObjectLists[s_UpdateTypes[nType]].m_Head;
+		for (LTLink *pCur = pListHead->m_pNext; pCur != pListHead; pCur = pCur->m_pNext)
+		{
+			ClientObjectUpdate update;
+			update.m_pObject		= (LTObject*)pCur->m_pData;
+			update.m_pDeadParticles	= LTNULL;
+			update.m_bMoveObject	= false;
+			update.m_bCommit		= false;
+
+			m_ObjectUpdates.push_back(update);
+		}
+	}
+}
+
+void CClientMgr::CommitObjectUpdate(ClientObjectUpdate &update)
+{
+	switch(update.m_pObject->m_ObjectType)
+	{
+		case OT_PARTICLESYSTEM:
+		{
+			LTParticleSystem *pSystem = (LTParticleSystem*)update.m_pObject;
+
+			ps_FreeParticles(pSystem, update.m_pDeadParticles);
+			ps_BounceParticles(pSystem);
+
+			if(update.m_bMoveObject)
+			{
+				MoveObject(pSystem, &pSystem->GetPos(), LTTRUE);
 			}
-        }
-    }
+
+			pSystem->m_nChangedParticles = 0;
+		}
+		break;
+
+		case OT_LINESYSTEM:
+		{
+			LineSystem *pSystem = (LineSystem*)update.m_pObject;
+
+			if(pSystem->m_bChanged)
+			{
+				// Do MoveObject to get it located correctly.
+				MoveObject(pSystem, &pSystem->GetPos(), LTTRUE);
+			}
+
+			pSystem->m_bChanged = LTFALSE;
+		}
+		break;
+
+		case OT_MODEL:
+		{
+			BindModelSpriteSkins((ModelInstance*)update.m_pObject);
+		}
+		break;
+	}
+}
+
+void CClientMgr::BindModelSpriteSkins(ModelInstance *pModel)
+{
+	uint32 nSpritesLeft = pModel->m_nNumSprites;
+
+	for (uint32 i = 0; nSpritesLeft && (i < MAX_MODEL_TEXTURES); i++)
+	{
+		if (pModel->m_pSprites[i])
+		{
+			SpriteEntry *pFrame = pModel->m_SpriteTrackers[i].m_pCurFrame;
+			SharedTexture *pSkin = pModel->m_pSkins[i];
+
+			//only look the texture up again if the sprite moved on to another frame, or the
+			//skin was released or unbound from the renderer since
+			if ((pFrame != pModel->m_pSkinSpriteFrames[i]) || !pSkin || !pSkin->m_pRenderData)
+			{
+				FileRef        skinName;
+				skinName.m_pFilename = pFrame->m_pTex->m_pFile->m_Filename;
+				skinName.m_FileType = FILE_CLIENTFILE;
+				AddSharedTexture2(&skinName, pModel->m_pSkins[i]);
+
+				pModel->m_pSkinSpriteFrames[i] = pFrame;
+				m_nModelSkinRebinds++;
+			}
+
+			nSpritesLeft--;
+		}
+	}
 }
 
 
@@ -2341,12 +2465,57 @@ void CClientMgr::UpdateObjects()
 {
 	g_Ticks_UpdateObjects = 0;
 	CountAdder cntUpdate(&g_Ticks_UpdateObjects);
+	LTJS_PROFILE_ZONE("ClientMgr::UpdateObjects");
+
+	GatherObjectUpdates();
+
+	uint32	nFrameTimeMS	= m_nFrameTimeMS;
+	float	fFrameTime		= m_FrameTime;
+	ClientObjectUpdate *pUpdates = m_ObjectUpdates.empty() ? LTNULL : &m_ObjectUpdates[0];
+
+	m_nModelSkinRebinds = 0;
+
+	//advance the trackers, particles and model animations, on worker threads if there are enough objects.
+	//Each update only touches its own object, so the results don't depend on how the list is split
+	uint32 nNumUpdates = (uint32)m_ObjectUpdates.size();
+	uint32 nMaxBands = (nNumUpdates >= OBJECTUPDATE_THREAD_MIN_OBJECTS) ? OBJECTUPDATE_MAX_BANDS : 1;
+
+	wp_ForEachBand(nNumUpdates, nMaxBands, [=](uint32 nStart, uint32 nEnd)
+	{
+		for(uint32 nCurr = nStart; nCurr < nEnd; nCurr++)
+		{
+			UpdateObjectParallel(pUpdates[nCurr], nFrameTimeMS, fFrameTime);
+		}
+	});
+
+	//then do the world tree moves and anything that calls out of the engine here, in list order
+	for(uint32 nCurr = 0; nCurr < m_ObjectUpdates.size(); nCurr++)
+	{
+		if(m_ObjectUpdates[nCurr].m_bCommit)
+		{
+			CommitObjectUpdate(m_ObjectUpdates[nCurr]);
+		}
+	}
+
+	//models that go past a string key this frame are animated last, walking the list like before so
+	//the client shell sees the keys in order and can change animations or remove objects from OnModelKey
+	if (m_nFrameTimeMS)
+	{
+		LTLink *pListHead = &m_ObjectMgr.m_ObjectLists[OT_MODEL].m_Head;
+
+		for (LTLink *pCur = pListHead->m_pNext; pCur != pListHead; pCur = pCur->m_pNext)
+		{
+			ModelInstance *pModel = (ModelInstance*)pCur->m_pData;
 
-    UpdateAnimations();
-    UpdateParticleSystems();
-    UpdatePolyGrids();
-    UpdateLineSystems();
-    UpdateModels();
+			if(!pModel->m_bAnimUpdated && !pModel->IsPaused() && (pModel->cd.m_ClientFlags & CF_NOTIFYMODELKEYS))
+			{
+				UpdateModelAnimation(pModel, m_nFrameTimeMS);
+				BindModelSpriteSkins(pModel);
+			}
+
+			pModel->m_bAnimUpdated = false;
+		}
+	}
 
 	IncrementFrameCode();
 
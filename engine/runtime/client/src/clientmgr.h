@@ -68,6 +68,10 @@ class CLTRealVideoMgr;
 
 #include <vector>
 
+#ifndef __FRAMEPACER_H__
+#include "framepacer.h"
+#endif
+
 //----------------------------------------------------------------------------
 //Above here are headers that probably wont be needed after certain things
 //are removed from the client mgr.
@@ -127,6 +131,23 @@ extern LeechDef g_ModelInheritLeechDef;
 
 
 
+// One object in CClientMgr::UpdateObjects.  The parallel part of the update
+// fills in what's left for the main thread to do.
+struct ClientObjectUpdate
+{
+    LTObject        *m_pObject;
+
+    // Particles that died, freed on the main thread.
+    PSParticle      *m_pDeadParticles;
+
+    // Needs a MoveObject to be relinked in the world tree.
+    bool            m_bMoveObject;
+
+    // Has anything for CommitObjectUpdate.
+    bool            m_bCommit;
+};
+
+
 class CClientMgr {
     // Main stuff.
     public:
@@ -458,11 +479,19 @@ class CClientMgr {
 		// Remove the object from our internal client object list
 		void RemoveClientObject(LTObject *pObj);
 
-        void UpdateModels();
-        void UpdateLineSystems();
-        void UpdatePolyGrids();
-        void UpdateAnimations();
-        void UpdateParticleSystems();
+        // The object update pass, see UpdateObjects.
+        void GatherObjectUpdates();
+        void CommitObjectUpdate(ClientObjectUpdate &update);
+        void BindModelSpriteSkins(ModelInstance *pModel);
+
+        // Objects being updated this frame, in list order.
+        std::vector<ClientObjectUpdate> m_ObjectUpdates;
+
+        // How many sprite skins had their texture looked up this frame.
+        uint32                  m_nModelSkinRebinds;
+
+        // Holds the frame rate to MaxFPS.
+        CFramePacer             m_FramePacer;
 
 
         // ------------------------------------------------------------------ //
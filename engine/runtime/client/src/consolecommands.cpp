@@ -25,6 +25,8 @@
 
 #include "client_ticks.h"
 
+#include "ltjs_profiler.h"
+
 //------------------------------------------------------------------
 //------------------------------------------------------------------
 // Holders and their headers.
@@ -546,6 +548,49 @@ static void con_ShowTicks(int argc, const char *argv[])
 	}
 }
 
+// Show the frame pacer's frame time statistics, and optionally start them over
+static void con_FramePacing(int argc, const char *argv[])
+{
+	FramePacerStats stats;
+	g_pClientMgr->m_FramePacer.GetStats(stats);
+
+	con_Printf(CONRGB(192,192,255), 0, "Frames: %u  Late: %u", stats.m_nFrames, stats.m_nLateFrames);
+	con_Printf(CONRGB(192,192,255), 0, "Frame time (ms): mean %.3f  std dev %.3f  min %.3f  max %.3f",
+		stats.m_fMeanMS, stats.m_fStdDevMS, stats.m_fMinMS, stats.m_fMaxMS);
+	con_Printf(CONRGB(192,192,255), 0, "Mean deadline overshoot (ms): %.3f", stats.m_fMeanOvershootMS);
+
+	if ((argc > 0) && (stricmp(argv[0], "reset") == 0))
+	{
+		g_pClientMgr->m_FramePacer.ResetStats();
+	}
+}
+
+// Dump the last N frames of the profiler as Chrome trace-event JSON
+static void con_ProfileDump(int argc, const char *argv[])
+{
+#ifdef LTJS_PROFILER
+	ltjs::Profiler *pProfiler = ltjs::get_profiler();
+	if (!pProfiler)
+	{
+		con_Printf(CONRGB(255,192,192), 0, "Error: Profiler is not initialized");
+		return;
+	}
+
+	int nFrames = (argc > 0) ? atoi(argv[0]) : 60;
+	if (nFrames < 1)
+		nFrames = 1;
+
+	const char *pFileName = (argc > 1) ? argv[1] : "ltjs_profile.json";
+
+	if (pProfiler->dump_chrome_trace(nFrames, pFileName))
+		dsi_ConsolePrint("Wrote %d frame(s) of profile data to %s", nFrames, pFileName);
+	else
+		con_Printf(CONRGB(255,192,192), 0, "Error: Unable to write profile data to %s", pFileName);
+#else
+	con_Printf(CONRGB(255,192,192), 0, "Error: Profiler is not compiled in (LTJS_PROFILER)");
+#endif // LTJS_PROFILER
+}
+
 // Manipulate the console's history
 static void con_ConsoleHistory(int argc, const char *argv[])
 {
@@ -872,6 +917,8 @@ static LTCommandStruct g_LTCommandStructs[] =
 	"MoveConsole", con_MoveConsole, 0,
 	"Mem", LTMemConsole, 0,
 	"ShowTicks", con_ShowTicks, 0,
+	"ProfileDump", con_ProfileDump, 0,
+	"FramePacing", con_FramePacing, 0,
 };	
 
 #define NUM_COMMANDSTRUCTS	(sizeof(g_LTCommandStructs) / sizeof(LTCommandStruct))
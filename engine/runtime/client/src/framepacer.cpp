@@ -0,0 +1,158 @@
+
+#include "bdefs.h"
+#include "framepacer.h"
+
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+
+// The default clock, on std::chrono::steady_clock.
+class CSystemFramePacerClock : public IFramePacerClock
+{
+public:
+    uint64 GetTimeNS()
+    {
+        return (uint64)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void Sleep(uint32 nMS)
+    {
+        if (nMS)
+            std::this_thread::sleep_for(std::chrono::milliseconds(nMS));
+        else
+            std::this_thread::yield();
+    }
+};
+
+static CSystemFramePacerClock g_SystemFramePacerClock;
+
+
+
+CFramePacer::CFramePacer(IFramePacerClock *pClock)
+{
+    m_pClock = pClock ? pClock : &g_SystemFramePacerClock;
+
+    m_nPeriodNS = 0;
+    m_nDeadlineNS = 0;
+    m_nLastFrameEndNS = 0;
+
+    ResetStats();
+}
+
+
+void CFramePacer::EndFrame(float fMaxFPS, uint32 nSpinUS)
+{
+    uint64 nNow = m_pClock->GetTimeNS();
+
+    if (fMaxFPS <= 0.0f)
+    {
+        m_nDeadlineNS = 0;
+        AddFrameStats(nNow);
+        return;
+    }
+
+    uint64 nPeriod = (uint64)(1000000000.0 / fMaxFPS);
+
+    //the first paced frame, or a new cap, schedules from the end of the last frame
+    if (!m_nDeadlineNS || (nPeriod != m_nPeriodNS))
+    {
+        m_nPeriodNS = nPeriod;
+        m_nDeadlineNS = (m_nLastFrameEndNS ? m_nLastFrameEndNS : nNow) + nPeriod;
+    }
+
+    if (nNow > m_nDeadlineNS)
+    {
+        m_nLateFrames++;
+
+        //a frame that was under a period late is made up for by the next deadline coming
+        //around on schedule, but after a longer hitch we start over from now rather than
+        //rushing through a run of frames to catch up
+        if (nNow - m_nDeadlineNS >= m_nPeriodNS)
+            m_nDeadlineNS = nNow;
+    }
+    else
+    {
+        //sleep while the deadline is far enough off that waking up late can't miss it...
+        uint64 nSpinNS = (uint64)nSpinUS * 1000;
+        while (nNow + nSpinNS < m_nDeadlineNS)
+        {
+            uint32 nSleepMS = (uint32)((m_nDeadlineNS - nNow - nSpinNS) / 1000000);
+            if (!nSleepMS)
+                break;
+
+            m_pClock->Sleep(nSleepMS);
+            nNow = m_pClock->GetTimeNS();
+        }
+
+        //...and spin the rest of the way
+        while (nNow < m_nDeadlineNS)
+        {
+            m_pClock->Sleep(0);
+            nNow = m_pClock->GetTimeNS();
+        }
+
+        m_nPacedFrames++;
+        m_fOvershootSum += (double)(nNow - m_nDeadlineNS);
+    }
+
+    //the next deadline is a period after this one, not after whenever we woke up, so
+    //wakeup jitter doesn't add up over frames
+    m_nDeadlineNS += m_nPeriodNS;
+
+    AddFrameStats(nNow);
+}
+
+
+void CFramePacer::AddFrameStats(uint64 nFrameEnd)
+{
+    if (m_nLastFrameEndNS)
+    {
+        uint64 nInterval = nFrameEnd - m_nLastFrameEndNS;
+
+        m_nFrames++;
+
+        double fDelta = (double)nInterval - m_fMean;
+        m_fMean += fDelta / m_nFrames;
+        m_fM2 += fDelta * ((double)nInterval - m_fMean);
+
+        if (m_nFrames == 1)
+        {
+            m_nMin = m_nMax = nInterval;
+        }
+        else
+        {
+            m_nMin = LTMIN(m_nMin, nInterval);
+            m_nMax = LTMAX(m_nMax, nInterval);
+        }
+    }
+
+    m_nLastFrameEndNS = nFrameEnd;
+}
+
+
+void CFramePacer::GetStats(FramePacerStats &stats) const
+{
+    stats.m_nFrames = m_nFrames;
+    stats.m_nLateFrames = m_nLateFrames;
+    stats.m_fMeanMS = m_fMean / 1000000.0;
+    stats.m_fStdDevMS = (m_nFrames > 1) ? sqrt(m_fM2 / m_nFrames) / 1000000.0 : 0.0;
+    stats.m_fMinMS = (double)m_nMin / 1000000.0;
+    stats.m_fMaxMS = (double)m_nMax / 1000000.0;
+    stats.m_fMeanOvershootMS = m_nPacedFrames ? (m_fOvershootSum / m_nPacedFrames) / 1000000.0 : 0.0;
+}
+
+
+void CFramePacer::ResetStats()
+{
+    m_nFrames = 0;
+    m_nLateFrames = 0;
+    m_nPacedFrames = 0;
+    m_fMean = 0.0;
+    m_fM2 = 0.0;
+    m_nMin = 0;
+    m_nMax = 0;
+    m_fOvershootSum = 0.0;
+}
+
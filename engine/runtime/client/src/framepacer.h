@@ -0,0 +1,79 @@
+
+// This module defines the client frame pacer, which holds the frame rate to
+// MaxFPS and keeps frame time statistics.
+
+#ifndef __FRAMEPACER_H__
+#define __FRAMEPACER_H__
+
+#ifndef __LTINTEGER_H__
+#include "ltinteger.h"
+#endif
+
+
+// The time source the pacer waits on.  The default one uses the monotonic
+// system clock, another one can be handed to the pacer to drive it by hand.
+class IFramePacerClock
+{
+public:
+    virtual ~IFramePacerClock() {}
+
+    // Monotonic time in nanoseconds.
+    virtual uint64  GetTimeNS() = 0;
+
+    // Give up the CPU for about this many milliseconds, or just yield it if nMS is 0.
+    virtual void    Sleep(uint32 nMS) = 0;
+};
+
+
+// Frame time statistics, in milliseconds.
+struct FramePacerStats
+{
+    uint32  m_nFrames;          // Frame intervals measured.
+    uint32  m_nLateFrames;      // Frames that ended after their deadline.
+    double  m_fMeanMS;
+    double  m_fStdDevMS;
+    double  m_fMinMS;
+    double  m_fMaxMS;
+    double  m_fMeanOvershootMS; // How far past the deadline paced frames ended, on average.
+};
+
+
+class CFramePacer
+{
+public:
+
+    // Uses the system clock if pClock is LTNULL.  The pacer doesn't own the clock.
+    CFramePacer(IFramePacerClock *pClock = LTNULL);
+
+    // Called once at the end of each frame.  If fMaxFPS is above zero it waits
+    // until the frame's deadline, otherwise it only measures the frame.
+    // nSpinUS is how long before the deadline it stops sleeping and spins.
+    void    EndFrame(float fMaxFPS, uint32 nSpinUS);
+
+    void    GetStats(FramePacerStats &stats) const;
+    void    ResetStats();
+
+private:
+
+    void    AddFrameStats(uint64 nFrameEnd);
+
+    IFramePacerClock    *m_pClock;
+
+    uint64      m_nPeriodNS;        // Frame period the deadline is scheduled with.
+    uint64      m_nDeadlineNS;      // When the current frame should end, 0 if not scheduled.
+    uint64      m_nLastFrameEndNS;  // When the last frame ended, 0 if none yet.
+
+    // Running frame interval statistics (Welford), in nanoseconds.
+    uint32      m_nFrames;
+    uint32      m_nLateFrames;
+    uint32      m_nPacedFrames;
+    double      m_fMean;
+    double      m_fM2;
+    uint64      m_nMin;
+    uint64      m_nMax;
+    double      m_fOvershootSum;
+};
+
+
+#endif  // __FRAMEPACER_H__
+
@@ -73,7 +73,16 @@ void CLTMessage_Read_Client::Free()
 LTVector CLTMessage_Read_Client::ReadCompPos(CPacket_Read &cPacket)
 {
 	CompWorldPos cCompPos;
+	ReadCompPos(cPacket, cCompPos);
 
+	LTVector vResult;
+	g_pWorld->DecodeCompressWorldPosition(&vResult, &cCompPos);
+
+	return vResult;
+}
+
+void CLTMessage_Read_Client::ReadCompPos(CPacket_Read &cPacket, CompWorldPos &cCompPos)
+{
 	cCompPos.m_Pos[0] = cPacket.Readuint16();
 	cCompPos.m_Pos[1] = cPacket.Readuint16();
 	cCompPos.m_Pos[2] = cPacket.Readuint16();
@@ -82,11 +91,6 @@ LTVector CLTMessage_Read_Client::ReadCompPos(CPacket_Read &cPacket)
 	#else
 		cCompPos.m_Extra = 0;
 	#endif
-
-	LTVector vResult;
-	g_pWorld->DecodeCompressWorldPosition(&vResult, &cCompPos);
-
-	return vResult;
 }
 
 HOBJECT CLTMessage_Read_Client::ReadObject(CPacket_Read &cPacket)
@@ -35,6 +35,8 @@ public:
 	// Static functions for reading straight from a CPacket_Read
 	static LTVector ReadCompPos(CPacket_Read &cPacket);
 	static HOBJECT ReadObject(CPacket_Read &cPacket);
+	// Read a position without decompressing it
+	static void ReadCompPos(CPacket_Read &cPacket, CompWorldPos &cCompPos);
 
 	static LTVector PeekCompPos(const CPacket_Read &cPacket);
 	static HOBJECT PeekObject(const CPacket_Read &cPacket);
@@ -232,9 +232,8 @@ static void ps_HandleParticleCollisions(LTParticleSystem *pSystem, LTFLOAT t)
 }
 
 
-void ps_UpdateParticles(LTParticleSystem *pSystem, LTFLOAT t)
+void ps_UpdateParticles(LTParticleSystem *pSystem, LTFLOAT t, PSParticle **ppDeadList)
 {
-	LTVector basePos = pSystem->GetPos();
 	uint32 flags = pSystem->m_psFlags;
 
 	//see if we need to handle intersections with other objects
@@ -276,7 +275,21 @@ void ps_UpdateParticles(LTParticleSystem *pSystem, LTFLOAT t)
 			if(pParticle->m_Lifetime < 0.0f)
 			{
 				pNext = pParticle->m_pNext;
-				ps_RemoveParticle(pSystem, pParticle);
+
+				if(ppDeadList)
+				{
+					pParticle->m_pPrev->m_pNext = pParticle->m_pNext;
+					pParticle->m_pNext->m_pPrev = pParticle->m_pPrev;
+					pSystem->m_nParticles--;
+
+					pParticle->m_pNext = *ppDeadList;
+					*ppDeadList = pParticle;
+				}
+				else
+				{
+					ps_RemoveParticle(pSystem, pParticle);
+				}
+
 				pParticle = pNext;
 				continue;
 			}
@@ -291,10 +304,19 @@ void ps_UpdateParticles(LTParticleSystem *pSystem, LTFLOAT t)
 			pParticle = pParticle->m_pNext;
 		}
 	}
+}
 
 
-	// Bounce the particles.
-	if(flags & PS_BOUNCE)
+void ps_BounceParticles(LTParticleSystem *pSystem)
+{
+	LTVector basePos = pSystem->GetPos();
+	PSParticle *pParticle, *pEnd;
+
+	// Dumb systems don't move their particles.
+	if(pSystem->m_psFlags & PS_DUMB)
+		return;
+
+	if(pSystem->m_psFlags & PS_BOUNCE)
 	{
 		ClientIntersectQuery iQuery;
 		ClientIntersectInfo iInfo;
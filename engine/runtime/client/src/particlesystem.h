@@ -37,8 +37,14 @@ void ps_AddParticles(LTParticleSystem *pSystem, uint32 nParticles,
                     LTFLOAT minLifetime, LTFLOAT maxLifetime);
 
 // This should be called just before rendering so that it can update
-// its bounding box.
-void ps_UpdateParticles(LTParticleSystem *pSystem, LTFLOAT t);
+// its bounding box.  If ppDeadList is set, particles that die are put on
+// it instead of being freed, so this only touches the system itself and
+// can be run on any thread.  Free them with ps_FreeParticles.
+void ps_UpdateParticles(LTParticleSystem *pSystem, LTFLOAT t, PSParticle **ppDeadList=LTNULL);
+
+// Bounces PS_BOUNCE particles off the world below the system.  This
+// queries the world so it has to be done on the main thread.
+void ps_BounceParticles(LTParticleSystem *pSystem);
 void ps_UpdateParticleBoundingBox(LTParticleSystem *pSystem);
 
 // Remove a particle.
@@ -49,6 +55,16 @@ inline void ps_RemoveParticle(LTParticleSystem *pSystem, PSParticle *pParticle)
     pSystem->m_nParticles--;
 }
 
+// Free a list of particles from ps_UpdateParticles, chained through m_pNext.
+inline void ps_FreeParticles(LTParticleSystem *pSystem, PSParticle *pDeadList) {
+    PSParticle *pNext;
+
+    for (; pDeadList; pDeadList = pNext) {
+        pNext = pDeadList->m_pNext;
+        sb_Free(pSystem->m_pParticleBank, pDeadList);
+    }
+}
+
 
 // Stretch the bounding box to fit the vector's position.
 inline void ps_UpdateBox(LTParticleSystem *pSystem, const LTVector &cPos, float fSize) 
@@ -113,6 +113,9 @@ LTRESULT ModelSetTexture(FileRef *pRef, ModelInstance* pInstance, uint32 index)
     const char *pName;
     LTRESULT dResult;
 
+	//the skin gets bound here, so the sprite skin binding has to start over
+	pInstance->m_pSkinSpriteFrames[index] = LTNULL;
+
 	//see if we had a sprite setup on this slot
 	if(pInstance->m_pSprites[index])
 	{
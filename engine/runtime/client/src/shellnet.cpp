@@ -34,6 +34,8 @@
 
 #include "misctools.h"
 
+#include <vector>
+
 //------------------------------------------------------------------
 //------------------------------------------------------------------
 // Holders and their headers.
@@ -45,6 +47,11 @@
 static IWorldClientBSP *world_bsp_client;
 define_holder(IWorldClientBSP, world_bsp_client);
 
+//ICompress, for the unguaranteed update data
+#include "compress.h"
+static ICompress *compress;
+define_holder(ICompress, compress);
+
 //IClientFileMgr
 #include "client_filemgr.h"
 static IClientFileMgr *client_file_mgr;
@@ -126,6 +133,8 @@ static LTRESULT SwitchModelAnim(CClientShell *pShell,
         trk_SetAtKeyFrame(pTracker, animTime);
     }
 
+	pInstance->ResetCachedPose();
+
     return LT_OK;
 }
 
@@ -1207,99 +1216,220 @@ static LTRESULT OnUpdatePacket(CClientShell *pShell, CPacket_Read &cPacket)
 
 
  
+// An object update from an unguaranteed update packet.  The updates are read ahead
+// so the positions and rotations can be decompressed together, then applied in order.
+struct UnguaranteedUpdate
+{
+	static const uint32 k_nNone = 0xFFFFFFFF;
+
+	uint16		m_nID;
+	uint8		m_nFlags;
+	// Indices into the decompressed arrays, or k_nNone
+	uint32		m_nPos;
+	uint32		m_nVel;
+	uint32		m_nRot;
+	LTRotation	m_rYRotation;
+	// Where the animation info starts in the packet
+	uint32		m_nAnimInfoPos;
+};
+
+struct UnguaranteedUpdateBatch
+{
+	void Clear()
+	{
+		m_Updates.clear();
+		m_CompPositions.clear();
+		m_CompVelocities.clear();
+		m_CompRotations.clear();
+	}
+
+	std::vector<UnguaranteedUpdate>	m_Updates;
+
+	std::vector<CompWorldPos>		m_CompPositions;
+	std::vector<CompVector>			m_CompVelocities;
+	std::vector<CompRot>			m_CompRotations;
+
+	std::vector<LTVector>			m_Positions;
+	std::vector<LTVector>			m_Velocities;
+	std::vector<LTRotation>			m_Rotations;
+};
+
+// Note : Kept around so the memory can be reused from packet to packet
+static UnguaranteedUpdateBatch g_UnguaranteedBatch;
+
+static void ApplyUnguaranteedUpdate(CClientShell *pShell, const UnguaranteedUpdateBatch &cBatch, 
+	const UnguaranteedUpdate &cUpdate, CPacket_Read &cPacket)
+{
+	LTObject *pObject = g_pClientMgr->FindObject(cUpdate.m_nID);
+
+	if ((cUpdate.m_nFlags & UUF_POS) && pObject) 
+	{
+		LTVector newPos = cBatch.m_Positions[cUpdate.m_nPos];
+		LTVector newVel;
+		if (cUpdate.m_nVel != UnguaranteedUpdate::k_nNone)
+			newVel = cBatch.m_Velocities[cUpdate.m_nVel];
+		else
+			newVel.Init();
+
+		bool bSameAsLast = false;
+		ClientData *pData;
+		pData = &pObject->cd;
+		if (pData)
+		{
+			if (newPos.NearlyEquals(pData->m_LastUpdatePosServer, 0.1f) && 
+				(newVel.NearlyEquals(pObject->m_Velocity, 0.1f)))
+				bSameAsLast = true;
+			if (!pData->m_MovingLink.IsTiedOff())
+				bSameAsLast = false;
+		}
+		// Skip duplicate updates
+		if (!bSameAsLast)
+		{
+			CompWorldPos cCompPos;
+			LTVector vCurCompPos;
+			world_bsp_client->EncodeCompressWorldPosition(&cCompPos, &pObject->GetPos());
+			world_bsp_client->DecodeCompressWorldPosition(&vCurCompPos, &cCompPos);
+			if (!vCurCompPos.NearlyEquals(newPos, 0.001f))
+			{
+				pd_OnObjectMove(pShell, pObject, &newPos, &newVel, false, false);
+			}
+		}
+	}
+
+	if ((cUpdate.m_nFlags & UUF_YROTATION) && pObject) 
+	{
+		LTRotation newRot = cUpdate.m_rYRotation;
+		pd_OnObjectRotate(pShell, pObject, &newRot, false, false);
+	}
+	else if ((cUpdate.m_nFlags & UUF_ROT) && pObject) 
+	{
+		LTRotation newRot = cBatch.m_Rotations[cUpdate.m_nRot];
+		pd_OnObjectRotate(pShell, pObject, &newRot, false, false);
+	}
+
+	// The animation info was skipped over when it was read, so go back for it now
+	if ((cUpdate.m_nFlags & UUF_ANIMINFO) && pObject) 
+	{
+		cPacket.SeekTo(cUpdate.m_nAnimInfoPos);
+		ReadAnimInfo(pShell, ToModel(pObject), cPacket, true, false);
+	}
+}
+ 
 static LTRESULT OnUnguaranteedUpdatePacket(CClientShell *pShell, CPacket_Read &cPacket) 
 {
-    uint16 id;
-	uint8 flags;
-    LTVector newPos, newVel;
-    LTRotation newRot;
-    LTObject *pObject;
+	UnguaranteedUpdateBatch &cBatch = g_UnguaranteedBatch;
     LTRESULT dResult;
 
     while (!cPacket.EOP())
 	{
-		id = cPacket.Readuint16();
-        flags = static_cast<uint8>(cPacket.ReadBits(UUF_FLAGCOUNT));
+		cBatch.Clear();
 
-        if (id == ID_TIMESTAMP) 
+		bool bEndPacket = false;
+		bool bDeadPacket = false;
+
+		// Read the object updates up to the timestamp
+		while (!cPacket.EOP())
 		{
-            // Read the rest of the packet.
-            dResult = ReadEndPacket(pShell, cPacket);
-            if (dResult != LT_OK) 
+			UnguaranteedUpdate cUpdate;
+			cUpdate.m_nID = cPacket.Readuint16();
+			cUpdate.m_nFlags = static_cast<uint8>(cPacket.ReadBits(UUF_FLAGCOUNT));
+
+			if (cUpdate.m_nID == ID_TIMESTAMP) 
 			{
-                return dResult;
-            }
-        }
-        else 
-		{
-            pObject = g_pClientMgr->FindObject(id);
-           			
-            if (flags & UUF_POS) 
+				bEndPacket = true;
+				break;
+			}
+
+			cUpdate.m_nPos = UnguaranteedUpdate::k_nNone;
+			cUpdate.m_nVel = UnguaranteedUpdate::k_nNone;
+			cUpdate.m_nRot = UnguaranteedUpdate::k_nNone;
+			cUpdate.m_nAnimInfoPos = 0;
+
+			if (cUpdate.m_nFlags & UUF_POS) 
 			{
-				newPos = CLTMessage_Read_Client::ReadCompPos(cPacket);
-				if (cPacket.Readbool())
-					newVel = CLTMessage_Read::ReadCompLTVector(cPacket);
-				else
-					newVel.Init();
+				CompWorldPos cCompPos;
+				CLTMessage_Read_Client::ReadCompPos(cPacket, cCompPos);
+				cUpdate.m_nPos = (uint32)cBatch.m_CompPositions.size();
+				cBatch.m_CompPositions.push_back(cCompPos);
 
-                if (pObject) 
+				if (cPacket.Readbool())
 				{
-					bool bSameAsLast = false;
-					ClientData *pData;
-					pData = &pObject->cd;
-					if (pData)
-					{
-						if (newPos.NearlyEquals(pData->m_LastUpdatePosServer, 0.1f) && 
-							(newVel.NearlyEquals(pObject->m_Velocity, 0.1f)))
-							bSameAsLast = true;
-						if (!pData->m_MovingLink.IsTiedOff())
-							bSameAsLast = false;
-					}
-					// Skip duplicate updates
-					if (!bSameAsLast)
-					{
-						CompWorldPos cCompPos;
-						LTVector vCurCompPos;
-						world_bsp_client->EncodeCompressWorldPosition(&cCompPos, &pObject->GetPos());
-						world_bsp_client->DecodeCompressWorldPosition(&vCurCompPos, &cCompPos);
-						if (!vCurCompPos.NearlyEquals(newPos, 0.001f))
-						{
-							pd_OnObjectMove(pShell, pObject, &newPos, &newVel, false, false);
-						}
-					}
-                }
-            }
+					CompVector cCompVel;
+					CLTMessage_Read::ReadCompLTVector(cPacket, cCompVel);
+					cUpdate.m_nVel = (uint32)cBatch.m_CompVelocities.size();
+					cBatch.m_CompVelocities.push_back(cCompVel);
+				}
+			}
 
-            if (flags & UUF_YROTATION) 
+			if (cUpdate.m_nFlags & UUF_YROTATION) 
 			{
-				newRot = CLTMessage_Read::ReadYRotation(cPacket);
-			
-                if (pObject) 
-				{
-                    pd_OnObjectRotate(pShell, pObject, &newRot, false, false);
-                }
-            }
-            else if (flags & UUF_ROT) 
+				cUpdate.m_rYRotation = CLTMessage_Read::ReadYRotation(cPacket);
+			}
+			else if (cUpdate.m_nFlags & UUF_ROT) 
 			{
-				newRot = CLTMessage_Read::ReadCompLTRotation(cPacket);
-			
-                if (pObject) 
-				{
-                    pd_OnObjectRotate(pShell, pObject, &newRot, false, false);
-                }
-            }
-        
-            if (flags & UUF_ANIMINFO) 
+				CompRot cCompRot;
+				CLTMessage_Read::ReadCompLTRotation(cPacket, cCompRot);
+				cUpdate.m_nRot = (uint32)cBatch.m_CompRotations.size();
+				cBatch.m_CompRotations.push_back(cCompRot);
+			}
+
+			if (cUpdate.m_nFlags & UUF_ANIMINFO) 
 			{
+				LTObject *pObject = g_pClientMgr->FindObject(cUpdate.m_nID);
 				if (pObject && (pObject->m_ObjectType != OT_MODEL))
 				{
 					// If we got an animinfo update on a non-model, this packet is probably dead...  Stop reading it.
 					ASSERT(!"AnimInfo update on non-model object!");
+					cUpdate.m_nFlags &= ~UUF_ANIMINFO;
+					cBatch.m_Updates.push_back(cUpdate);
+					bDeadPacket = true;
 					break;
 				}
-				ReadAnimInfo(pShell, pObject ? ToModel(pObject) : NULL, cPacket, true, false);
+
+				// Skip over it for now
+				cUpdate.m_nAnimInfoPos = cPacket.Tell();
+				ReadAnimInfo(pShell, NULL, cPacket, true, false);
+			}
+
+			cBatch.m_Updates.push_back(cUpdate);
+		}
+
+		// Decompress everything that was read
+		uint32 nPositions = (uint32)cBatch.m_CompPositions.size();
+		cBatch.m_Positions.resize(nPositions);
+		if (nPositions)
+			world_bsp_client->DecodeCompressWorldPositions(&cBatch.m_Positions[0], &cBatch.m_CompPositions[0], nPositions);
+
+		uint32 nVelocities = (uint32)cBatch.m_CompVelocities.size();
+		cBatch.m_Velocities.resize(nVelocities);
+		if (nVelocities)
+			compress->DecodeCompressVectors(&cBatch.m_Velocities[0], &cBatch.m_CompVelocities[0], nVelocities);
+
+		uint32 nRotations = (uint32)cBatch.m_CompRotations.size();
+		cBatch.m_Rotations.resize(nRotations);
+		if (nRotations)
+			compress->UncompressRotations(&cBatch.m_CompRotations[0], &cBatch.m_Rotations[0], nRotations);
+
+		// Apply the updates in the order they were sent
+		uint32 nReadPos = cPacket.Tell();
+		for (uint32 nUpdate = 0; nUpdate < cBatch.m_Updates.size(); nUpdate++)
+		{
+			ApplyUnguaranteedUpdate(pShell, cBatch, cBatch.m_Updates[nUpdate], cPacket);
+		}
+		cPacket.SeekTo(nReadPos);
+
+		if (bDeadPacket)
+			break;
+
+		if (bEndPacket)
+		{
+            // Read the rest of the packet.
+            dResult = ReadEndPacket(pShell, cPacket);
+            if (dResult != LT_OK) 
+			{
+                return dResult;
             }
-        }
+		}
     }
 
     return LT_OK;
@@ -103,6 +103,8 @@ public:
 	bool IntersectSweptSphere(const LTVector& vStart, const LTVector& vEnd, float fRadius, LTVector& vPos, LTVector& vNormal);
 	void EncodeCompressWorldPosition(CompWorldPos *pPos, const LTVector *pVal);
 	void DecodeCompressWorldPosition(LTVector *pVal, const CompWorldPos *pPos);
+	void EncodeCompressWorldPositions(CompWorldPos *pPos, const LTVector *pVals, uint32 nCount);
+	void DecodeCompressWorldPositions(LTVector *pVals, const CompWorldPos *pPos, uint32 nCount);
 
 
     //-----------------------------------------------------
@@ -258,6 +260,16 @@ void CWorldClientBSP::DecodeCompressWorldPosition(LTVector *pVal, const CompWorl
 	compress->DecodeCompressWorldPosition(pVal, pPos, world_bsp_shared->ExtentsMin(), world_bsp_shared->ExtentsMax());
 }
 
+void CWorldClientBSP::EncodeCompressWorldPositions(CompWorldPos *pPos, const LTVector *pVals, uint32 nCount)
+{
+	compress->EncodeCompressWorldPositions(pPos, pVals, nCount, world_bsp_shared->ExtentsMin(), world_bsp_shared->ExtentsDiffInv());
+}
+
+void CWorldClientBSP::DecodeCompressWorldPositions(LTVector *pVals, const CompWorldPos *pPos, uint32 nCount)
+{
+	compress->DecodeCompressWorldPositions(pVals, pPos, nCount, world_bsp_shared->ExtentsMin(), world_bsp_shared->ExtentsMax());
+}
+
 
 
 //---------------------------------------------------------------------------
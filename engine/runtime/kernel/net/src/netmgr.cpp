@@ -849,19 +849,27 @@ CBaseDriver* CNetMgr::AddDriver(const char *pInfo)
 
 	if (pDriver)
 	{
-		pDriver->m_pNetMgr = this;
+		pDriver = AddDriver(pDriver);
+	}
 
-		if (!pDriver->Init())
-		{
-			delete pDriver;
-			return LTNULL;
-		}
+	return pDriver;
+}
 
-		LT_MEM_TRACK_ALLOC(m_Drivers.Append(pDriver), LT_MEM_TYPE_NETWORKING);
 
-		pDriver->UpdateGUID(m_guidApp);
+CBaseDriver* CNetMgr::AddDriver(CBaseDriver *pDriver)
+{
+	pDriver->m_pNetMgr = this;
+
+	if (!pDriver->Init())
+	{
+		delete pDriver;
+		return LTNULL;
 	}
 
+	LT_MEM_TRACK_ALLOC(m_Drivers.Append(pDriver), LT_MEM_TYPE_NETWORKING);
+
+	pDriver->UpdateGUID(m_guidApp);
+
 	return pDriver;
 }
 
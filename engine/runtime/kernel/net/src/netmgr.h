@@ -321,6 +321,9 @@ class CNetMgr
 		void			Update(const char *pPrefix, float fCurTime, bool bAllowTimeout=true);
 
 		CBaseDriver*	AddDriver( const char *pDriverInfo );
+		// Adds a driver made outside the net manager.  The net manager owns it from
+		// here on, and deletes it if it doesn't initialize.
+		CBaseDriver*	AddDriver( CBaseDriver *pDriver );
 		CBaseDriver*	GetDriver( const char* sDriver );
 		void			RemoveDriver( CBaseDriver *pDriver );
 
@@ -10,6 +10,8 @@
 #include "syslthread.h"
 #include "systhread.h"
 
+#include "ltjs_profiler.h"
+
 
 #ifdef __LINUX
 #include <fcntl.h>
@@ -3753,6 +3755,8 @@ uint32 CUDPDriver::Thread_Listen()
 	cTimeout.tv_sec = k_nListenThread_Timeout / 1000;
 	cTimeout.tv_usec = (k_nListenThread_Timeout % 1000) * 1000;
 
+	LTJS_PROFILE_THREAD("UDPListen");
+
 	// Ok, we're starting now...
 	m_cEvent_Thread_Listen_Ready.Set();
 
@@ -3889,6 +3893,8 @@ uint32 CUDPDriver::Thread_Listen()
 			continue;
 		}
 
+		LTJS_PROFILE_ZONE("UDPDriver::HandleIncomingPacket");
+
 		if (cIncomingPacket.Peekuint32() == UNCONNECTED_DATA_TOKEN)
 		{
 			// Parse the unconnected data packet
@@ -19,6 +19,9 @@
 #include "ltjs_sys_event_queue.h"
 #endif // LTJS_SDL_BACKEND
 
+#include "ltjs_logger.h"
+#include "ltjs_profiler.h"
+
 
 #ifdef LITHTECH_ESD
 #include "ltrealaudio_impl.h"
@@ -521,6 +524,13 @@ bool initialize()
 		return false;
 	}
 
+	ltjs::install_crash_logger_flush();
+
+#ifdef LTJS_PROFILER
+	ltjs::initialize_profiler();
+	LTJS_PROFILE_THREAD("Main");
+#endif // LTJS_PROFILER
+
 #ifdef LTJS_SDL_BACKEND
 	g_language_mgr = ltjs::make_language_mgr();
 	g_language_mgr->initialize("ltjs");
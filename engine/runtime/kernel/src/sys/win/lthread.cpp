@@ -2,6 +2,8 @@
 #include "bdefs.h"
 #include "lthread.h"
 
+#include "ltjs_profiler.h"
+
 
 // How long the threads sleep between checking messages.
 #define THREAD_SLEEP_INTERVAL 20
@@ -309,6 +311,8 @@ void LThread::ThreadRun()
 	aWaitEvents[0] = ToHandle(m_hStopEvent);
 	aWaitEvents[1] = ToHandle(m_Incoming.GetMsgEvent());
 
+	LTJS_PROFILE_THREAD("Loader");
+
 	// Loop until we're told to stop
 	while (WaitForMultipleObjects(2, aWaitEvents, FALSE, INFINITE) != WAIT_OBJECT_0)
 	{
@@ -321,6 +325,7 @@ void LThread::ThreadRun()
 			m_Incoming.PopMessage();
 
 			// Process it
+			LTJS_PROFILE_ZONE("LThread::ProcessMessage");
 			ProcessMessage(msg);
 		}
 		else
@@ -178,29 +178,110 @@ static AnimKeyFrame* trk_NextPositionFrame(LTAnimTracker *pTracker, uint32 iStar
 }
 
 // ----------------------------------------------------------------
-// ProcessKey
-// Process keyframes that have callbacks associated with them.
+// FindKeyFrame( anim, time, start-key )
+// Returns the first key at or after iStartKey whose time is at or past
+// msTime, or the number of keys if there is none.  Steady playback stays
+// on the same key or passes the next one, so those are checked before
+// falling back to a binary search for seeks and big time steps.
 // ----------------------------------------------------------------
-static void trk_ProcessKey(LTAnimTracker *pTracker, ModelAnim *pAnim, uint32 iFrame)
+static uint32 trk_FindKeyFrame(ModelAnim *pAnim, uint32 msTime, uint32 iStartKey)
 {
-	AnimKeyFrame *pNextPosition;
-	uint32 iNextPosition;
-	AnimKeyFrame *pFrame;
+	uint32 nKeys = pAnim->m_KeyFrames.GetSize();
+	const AnimKeyFrame *pKeys = pAnim->m_KeyFrames.GetArray();
 
+	if(iStartKey >= nKeys)
+		return iStartKey;
 
-	pFrame = &pAnim->m_KeyFrames[iFrame];	
+	uint32 iKey;
+	for(iKey = iStartKey; (iKey < nKeys) && (iKey < iStartKey + 2); iKey++)
+	{
+		if(msTime <= pKeys[iKey].m_Time)
+			return iKey;
+	}
 
-	// Is there a string for this key?
-	if(pTracker->m_StringKeyCallback != NULL && pFrame->m_pString[0] != 0)
+	uint32 iLow = iKey;
+	uint32 iHigh = nKeys;
+	while(iLow < iHigh)
 	{
-		// Save the current keyframe
-		AnimKeyFrame *pOldKeyFrame = pTracker->GetCurFrame();
-		pTracker->m_StringKeyCallback(pTracker, pFrame);
-		// Jump out if they changed it on us...
-		if (pTracker->GetCurFrame() != pOldKeyFrame)
-			return;
+		uint32 iMid = iLow + ((iHigh - iLow) >> 1);
+		if(pKeys[iMid].m_Time < msTime)
+			iLow = iMid + 1;
+		else
+			iHigh = iMid;
+	}
+
+	return iLow;
+}
+
+// ----------------------------------------------------------------
+// FindCommandKey( anim, key )
+// Returns the position in the anim's command key index of the first
+// key with a string at or after iKey.
+// ----------------------------------------------------------------
+static uint32 trk_FindCommandKey(ModelAnim *pAnim, uint32 iKey)
+{
+	uint32 iLow = 0;
+	uint32 iHigh = pAnim->m_CommandKeys.GetSize();
+	while(iLow < iHigh)
+	{
+		uint32 iMid = iLow + ((iHigh - iLow) >> 1);
+		if(pAnim->m_CommandKeys[iMid] < iKey)
+			iLow = iMid + 1;
+		else
+			iHigh = iMid;
 	}
 
+	return iLow;
+}
+
+// ----------------------------------------------------------------
+// PassesStringKey( tracker, delta )
+// Follows trk_ScanToKeyFrame without changing the tracker.  Finishing a
+// transition is reported as passing a key rather than following the
+// reset.
+// ----------------------------------------------------------------
+bool trk_PassesStringKey(LTAnimTracker *pTracker, uint32 msDelta)
+{
+	if(!(pTracker->m_Flags & AT_PLAYING) || !pTracker->IsValid())
+		return false;
+
+	ModelAnim *pCurAnim = pTracker->GetCurAnim();
+	msDelta = (uint32)(msDelta * pTracker->m_RateModifier);
+
+	if((pTracker->m_InterpolationMS != NOT_INTERPOLATING) && (pCurAnim->m_InterpolationMS != 0))
+	{
+		return ((uint32)pTracker->m_InterpolationMS + msDelta > pCurAnim->m_InterpolationMS);
+	}
+
+	if((pCurAnim->m_KeyFrames.GetSize() <= 1) || (pCurAnim->m_CommandKeys.GetSize() == 0))
+		return false;
+
+	uint32 iEndKey = pCurAnim->m_KeyFrames.GetSize() - 1;
+	uint32 msTime = pTracker->m_TimeRef.m_Cur.m_Time + msDelta;
+
+	if(!(pTracker->m_Flags & AT_LOOPING))
+	{
+		msTime = MIN(msTime, (pCurAnim->m_KeyFrames[iEndKey].m_Time+1));
+	}
+
+	uint32 iStartKey = pTracker->m_CurKey;
+	uint32 iTargetKey = trk_FindKeyFrame(pCurAnim, msTime, iStartKey);
+	if(iTargetKey <= iStartKey)
+		return false;
+
+	uint32 iCommand = trk_FindCommandKey(pCurAnim, iStartKey);
+	return (iCommand < pCurAnim->m_CommandKeys.GetSize()) && (pCurAnim->m_CommandKeys[iCommand] < iTargetKey);
+}
+
+// ----------------------------------------------------------------
+// SetPassedKeyFrame
+// Sets up the frame locators for a tracker that just went past iFrame.
+// ----------------------------------------------------------------
+static void trk_SetPassedKeyFrame(LTAnimTracker *pTracker, ModelAnim *pAnim, uint32 iFrame)
+{
+	AnimKeyFrame *pNextPosition;
+	uint32 iNextPosition;
+
 	pNextPosition = trk_NextPositionFrame(pTracker, iFrame+1, iNextPosition);
 	if(pNextPosition)
 	{
@@ -223,6 +304,66 @@ static void trk_ProcessKey(LTAnimTracker *pTracker, ModelAnim *pAnim, uint32 iFr
 	ASSERT(pTracker->IsValid());
 }
 
+// ----------------------------------------------------------------
+// ProcessKey
+// Process keyframes that have callbacks associated with them.
+// Returns false if the callback moved the tracker to another frame.
+// ----------------------------------------------------------------
+static bool trk_ProcessKey(LTAnimTracker *pTracker, ModelAnim *pAnim, uint32 iFrame)
+{
+	AnimKeyFrame *pFrame;
+
+
+	pFrame = &pAnim->m_KeyFrames[iFrame];	
+
+	// Is there a string for this key?
+	if(pTracker->m_StringKeyCallback != NULL && pFrame->m_pString[0] != 0)
+	{
+		// Save the current keyframe
+		AnimKeyFrame *pOldKeyFrame = pTracker->GetCurFrame();
+		pTracker->m_StringKeyCallback(pTracker, pFrame);
+		// Jump out if they changed it on us...
+		if (pTracker->GetCurFrame() != pOldKeyFrame)
+			return false;
+	}
+
+	trk_SetPassedKeyFrame(pTracker, pAnim, iFrame);
+	return true;
+}
+
+// ----------------------------------------------------------------
+// ProcessPassedKeys
+// Handles the tracker going past the keys [iFirst, iEnd).  Only the keys
+// with strings are visited, in order, with the frame locators where a
+// key by key scan would have left them.  Returns false if a callback
+// moved the tracker, m_CurKey is then whatever the callback left it at.
+// ----------------------------------------------------------------
+static bool trk_ProcessPassedKeys(LTAnimTracker *pTracker, ModelAnim *pAnim, uint32 iFirst, uint32 iEnd)
+{
+	ASSERT(iFirst < iEnd);
+
+	if(pTracker->m_StringKeyCallback != NULL)
+	{
+		uint32 nCommandKeys = pAnim->m_CommandKeys.GetSize();
+		for(uint32 iCommand = trk_FindCommandKey(pAnim, iFirst); iCommand < nCommandKeys; iCommand++)
+		{
+			uint32 iKey = pAnim->m_CommandKeys[iCommand];
+			if(iKey >= iEnd)
+				break;
+
+			if(iKey > iFirst)
+				trk_SetPassedKeyFrame(pTracker, pAnim, iKey - 1);
+
+			pTracker->m_CurKey = iKey;
+			if(!trk_ProcessKey(pTracker, pAnim, iKey))
+				return false;
+		}
+	}
+
+	trk_SetPassedKeyFrame(pTracker, pAnim, iEnd - 1);
+	return true;
+}
+
 // ----------------------------------------------------------------
 // UpdatePositionInterpolant( tracker )
 // Finds the position between key frames. For doing linear/spherical
@@ -311,33 +452,26 @@ void trk_SetAtKeyFrame(LTAnimTracker *pTracker, uint32 msTime)
 	}
 
 	// Now find the keyframes..
-	uint32 lastkeyTime = 0;
-	uint32 keyTime;
-	while(pTracker->m_CurKey <= iEndKey)
+	pTracker->m_CurKey = trk_FindKeyFrame(pCurAnim, msTime, 0);
+	if(pTracker->m_CurKey <= iEndKey)
 	{
-		keyTime = pCurAnim->m_KeyFrames[pTracker->m_CurKey].m_Time;
-		if(msTime <= keyTime)
-		{
-			pTracker->m_TimeRef.m_Prev.m_iFrame = (uint16)pTracker->m_CurKey > 0 ? (uint16)pTracker->m_CurKey-1 : 0;
-			pTracker->m_TimeRef.m_Cur.m_iFrame = (uint16)pTracker->m_CurKey;
-			// Compute the percent into the next keyframe (if there is one).  Avoid any divide by zero's.
-			if ( (keyTime - lastkeyTime) == 0 ) 
-			{
-				pTracker->m_TimeRef.m_Percent = 0.0f;
-			}
-			else
-			{
-				pTracker->m_TimeRef.m_Prev.m_Time = lastkeyTime;	
-				pTracker->m_TimeRef.m_Cur.m_Time = msTime;
-				pTracker->m_TimeRef.m_Percent = (LTFLOAT)(msTime - lastkeyTime)/(LTFLOAT)(keyTime - lastkeyTime);
-				ASSERT((pTracker->m_TimeRef.m_Percent >= 0.0f) && (pTracker->m_TimeRef.m_Percent <= 1.0f));
-			}
+		uint32 keyTime = pCurAnim->m_KeyFrames[pTracker->m_CurKey].m_Time;
+		uint32 lastkeyTime = (pTracker->m_CurKey > 0) ? pCurAnim->m_KeyFrames[pTracker->m_CurKey - 1].m_Time : 0;
 
-			break;
+		pTracker->m_TimeRef.m_Prev.m_iFrame = (uint16)pTracker->m_CurKey > 0 ? (uint16)pTracker->m_CurKey-1 : 0;
+		pTracker->m_TimeRef.m_Cur.m_iFrame = (uint16)pTracker->m_CurKey;
+		// Compute the percent into the next keyframe (if there is one).  Avoid any divide by zero's.
+		if ( (keyTime - lastkeyTime) == 0 ) 
+		{
+			pTracker->m_TimeRef.m_Percent = 0.0f;
+		}
+		else
+		{
+			pTracker->m_TimeRef.m_Prev.m_Time = lastkeyTime;	
+			pTracker->m_TimeRef.m_Cur.m_Time = msTime;
+			pTracker->m_TimeRef.m_Percent = (LTFLOAT)(msTime - lastkeyTime)/(LTFLOAT)(keyTime - lastkeyTime);
+			ASSERT((pTracker->m_TimeRef.m_Percent >= 0.0f) && (pTracker->m_TimeRef.m_Percent <= 1.0f));
 		}
-
-		lastkeyTime = keyTime;
-		++pTracker->m_CurKey;
 	}
 
 	ASSERT(pTracker->IsValid());
@@ -419,24 +553,37 @@ void trk_ScanToKeyFrame(LTAnimTracker *pTracker, uint32 msDelta, bool bProcessKe
 		pTracker->m_TimeRef.m_Cur.m_Time = MIN(pTracker->m_TimeRef.m_Cur.m_Time, (endTime+1));
 	}
 	
-	// Now scan thru the keyframes..
-	uint32 keyTime;
-	while(pTracker->m_CurKey <= iEndKey)
+	// Find the key we end up on and handle the ones we went past.
+	uint32 iStartKey = pTracker->m_CurKey;
+	uint32 iTargetKey = trk_FindKeyFrame(pCurAnim, pTracker->m_TimeRef.m_Cur.m_Time, iStartKey);
+
+	if(bProcessKeys && (iTargetKey > iStartKey))
 	{
-		keyTime = pCurAnim->m_KeyFrames[pTracker->m_CurKey].m_Time;
-		if(pTracker->m_TimeRef.m_Cur.m_Time <= keyTime)
+		if(trk_ProcessPassedKeys(pTracker, pCurAnim, iStartKey, iTargetKey))
 		{
-			break;
+			pTracker->m_CurKey = iTargetKey;
 		}
 		else
 		{
-			if(bProcessKeys)
+			// A string key callback moved the tracker, carry on from wherever it
+			// left it one key at a time.
+			++pTracker->m_CurKey;
+
+			uint32 keyTime;
+			while(pTracker->m_CurKey <= iEndKey)
 			{
+				keyTime = pCurAnim->m_KeyFrames[pTracker->m_CurKey].m_Time;
+				if(pTracker->m_TimeRef.m_Cur.m_Time <= keyTime)
+					break;
+
 				trk_ProcessKey(pTracker, pCurAnim, pTracker->m_CurKey);
+				++pTracker->m_CurKey;
 			}
 		}
-
-		++pTracker->m_CurKey;
+	}
+	else
+	{
+		pTracker->m_CurKey = iTargetKey;
 	}
 
 	if(pTracker->m_CurKey >= (iEndKey+1) && (pTracker->m_Flags & AT_LOOPING))
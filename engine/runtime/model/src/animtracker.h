@@ -32,6 +32,10 @@ void trk_Init(LTAnimTracker *pTracker, Model *pModel, uint32 iAnim);
 
 void trk_Update(LTAnimTracker *pTracker, uint32 msDelta);
 
+// Returns true if trk_Update with msDelta could go past a key with a string.  It
+// can say true when it wouldn't, but never false when it would.
+bool trk_PassesStringKey(LTAnimTracker *pTracker, uint32 msDelta);
+
 bool trk_IsStopped(LTAnimTracker *pTracker);
 void trk_SetCurTime(LTAnimTracker *pTracker, uint32 msTime, bool bTransition);
 
@@ -342,6 +342,7 @@ void ModelAnim::Term()
 	}
 
 	m_KeyFrames.Term(GetAlloc());
+	m_CommandKeys.Term(GetAlloc());
 }
 
 uint32 ModelAnim::GetAnimTime() const
@@ -487,6 +487,10 @@ public:
 
 	CMoArray<AnimKeyFrame, NoCache>	m_KeyFrames;
 
+	// Indices into m_KeyFrames of the keys that have a string, in time order.
+	// The trackers use this to fire string keys without visiting every key.
+	CMoArray<uint32, NoCache>		m_CommandKeys;
+
 	// The time we interpolate into this animation
 	uint32			m_InterpolationMS;
 
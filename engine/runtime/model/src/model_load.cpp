@@ -412,6 +412,27 @@ bool ModelAnim::Load(ILTStream &file, uint8*& pAnimData)
 		}
 	}
 
+	// Build the index of keys that carry strings.
+	uint32 nCommandKeys = 0;
+	for(i=0; i < nKeyFrames; i++)
+	{
+		if(m_KeyFrames[i].m_pString[0] != 0)
+			nCommandKeys++;
+	}
+
+	if(!m_CommandKeys.SetSize2(nCommandKeys, GetAlloc()))
+	{
+		Term();
+		return false;
+	}
+
+	nCommandKeys = 0;
+	for(i=0; i < nKeyFrames; i++)
+	{
+		if(m_KeyFrames[i].m_pString[0] != 0)
+			m_CommandKeys[nCommandKeys++] = i;
+	}
+
 
 	//allocate our animation node list.
 
@@ -1,4 +1,5 @@
 #include "build_aabb.h"
+#include "ltmem.h"
 #include "math_phys.h"
 
 
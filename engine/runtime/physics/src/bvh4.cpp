@@ -0,0 +1,707 @@
+#include "bvh4.h"
+#include "ltmem.h"
+#include <float.h>
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define BVH4_SSE2
+#include <emmintrin.h>
+#endif
+
+
+//build parameters
+#define BVH4_MAX_LEAF		4	//max triangles in a leaf
+#define BVH4_BIN_COUNT		16	//SAH bins per axis
+#define BVH4_NODE_COST		1.f	//cost of a node test relative to a triangle test
+
+//traversal stack entries kept on the program stack
+#define BVH4_LOCAL_STACK	192
+
+
+//---------------------------------------------------------------------------//
+void LTTriangleIndexList::Grow()
+{
+	const uint32 size = 2 * m_Size;
+	uint32* pIndex;
+
+	LT_MEM_TRACK_ALLOC(pIndex = new uint32[size],LT_MEM_TYPE_PHYSICS);
+
+	for( uint32 i=0 ; i<m_Count ; i++ )
+		pIndex[i] = m_pIndex[i];
+
+	if( m_pIndex != m_Local )
+		delete [] m_pIndex;
+
+	m_pIndex = pIndex;
+	m_Size = size;
+}
+
+
+//---------------------------------------------------------------------------//
+//state shared by the build routines
+struct bvh4_build
+{
+	LTBVH4_Node*		node;	//node array
+	uint32				nc;		//nodes used
+	uint32*				ti;		//triangle indices, partitioned in place
+	const LTAABB*		tb;		//triangle bounds
+	const LTVector3f*	tcen;	//triangle centroids
+	uint32				depth;	//max node depth
+};
+
+
+//---------------------------------------------------------------------------//
+static inline void grow_bounds( LTAABB& b, const LTAABB& t )
+{
+	b.Min.x = LTMIN( b.Min.x, t.Min.x );
+	b.Min.y = LTMIN( b.Min.y, t.Min.y );
+	b.Min.z = LTMIN( b.Min.z, t.Min.z );
+	b.Max.x = LTMAX( b.Max.x, t.Max.x );
+	b.Max.y = LTMAX( b.Max.y, t.Max.y );
+	b.Max.z = LTMAX( b.Max.z, t.Max.z );
+}
+
+
+//---------------------------------------------------------------------------//
+static inline void empty_bounds( LTAABB& b )
+{
+	b.Min = LTVector3f( FLT_MAX, FLT_MAX, FLT_MAX );
+	b.Max = LTVector3f( -FLT_MAX, -FLT_MAX, -FLT_MAX );
+}
+
+
+//---------------------------------------------------------------------------//
+//half the surface area, which is all the SAH needs
+static inline float half_area( const LTAABB& b )
+{
+	const LTVector3f e = b.Max - b.Min;
+
+	return e.x*e.y + e.y*e.z + e.z*e.x;
+}
+
+
+//---------------------------------------------------------------------------//
+//bounds of triangles [beg,end) and of their centroids
+static void range_bounds
+(
+	LTAABB&				b,		//triangle bounds
+	LTAABB&				cb,		//centroid bounds
+	const bvh4_build&	s,
+	const uint32		beg,
+	const uint32		end
+)
+{
+	empty_bounds( b );
+	empty_bounds( cb );
+
+	for( uint32 i=beg ; i<end ; i++ )
+	{
+		const uint32 t = s.ti[i];
+
+		grow_bounds( b, s.tb[t] );
+		grow_bounds( cb, LTAABB( s.tcen[t], s.tcen[t] ) );
+	}
+}
+
+
+//---------------------------------------------------------------------------//
+static inline int32 bin_index( const float c, const float cmin, const float k )
+{
+	const int32 bin = int32( (c - cmin) * k );
+
+	if( bin < 0 )
+		return 0;
+
+	return bin < BVH4_BIN_COUNT ? bin : BVH4_BIN_COUNT-1;
+}
+
+
+//---------------------------------------------------------------------------//
+//Find the binned SAH split of triangles [beg,end) and partition them around
+//it.  Return false if the triangles should stay together in a leaf.
+static bool sah_split
+(
+	uint32&			mid,	//[Return parameter] first triangle of the right side
+	bvh4_build&		s,
+	const uint32	beg,
+	const uint32	end
+)
+{
+	const uint32 n = end - beg;
+
+	if( n < 2 )
+		return false;
+
+	LTAABB b, cb;
+
+	range_bounds( b, cb, s, beg, end );
+
+	int32 best_axis = -1;
+	int32 best_bin = 0;
+	float best_cost = FLT_MAX;
+
+	for( int32 axis=0 ; axis<3 ; axis++ )
+	{
+		const float cmin = cb.Min[axis];
+		const float ext = cb.Max[axis] - cmin;
+
+		//all centroids in the same plane
+		if( ext <= 0 )
+			continue;
+
+		const float k = BVH4_BIN_COUNT / ext;
+		uint32 count[BVH4_BIN_COUNT];
+		LTAABB bound[BVH4_BIN_COUNT];
+
+		for( int32 i=0 ; i<BVH4_BIN_COUNT ; i++ )
+		{
+			count[i] = 0;
+			empty_bounds( bound[i] );
+		}
+
+		for( uint32 i=beg ; i<end ; i++ )
+		{
+			const uint32 t = s.ti[i];
+			const int32 bin = bin_index( s.tcen[t][axis], cmin, k );
+
+			count[bin]++;
+			grow_bounds( bound[bin], s.tb[t] );
+		}
+
+		//cost of everything right of each split plane
+		float right_cost[BVH4_BIN_COUNT];
+		LTAABB right;
+		uint32 rc = 0;
+
+		empty_bounds( right );
+
+		for( int32 i=BVH4_BIN_COUNT-1 ; i>0 ; i-- )
+		{
+			rc += count[i];
+			grow_bounds( right, bound[i] );
+			right_cost[i] = rc ? half_area( right ) * rc : 0;
+		}
+
+		//sweep the split plane from the left
+		LTAABB left;
+		uint32 lc = 0;
+
+		empty_bounds( left );
+
+		for( int32 i=0 ; i<BVH4_BIN_COUNT-1 ; i++ )
+		{
+			lc += count[i];
+			grow_bounds( left, bound[i] );
+
+			//both sides need triangles
+			if( lc == 0 || lc == n )
+				continue;
+
+			const float cost = half_area( left ) * lc + right_cost[i+1];
+
+			if( cost < best_cost )
+			{
+				best_cost = cost;
+				best_axis = axis;
+				best_bin = i;
+			}
+		}
+	}
+
+	if( best_axis < 0 )
+	{
+		//every centroid is in the same place, so
+		//only split if the leaf would be too big
+		if( n <= BVH4_MAX_LEAF )
+			return false;
+
+		mid = beg + n/2;
+		return true;
+	}
+
+	//compare with the cost of testing every triangle
+	const float area = half_area( b );
+
+	if( n <= BVH4_MAX_LEAF && BVH4_NODE_COST * area + best_cost >= area * n )
+		return false;
+
+	//partition the triangles around the split plane
+	const float cmin = cb.Min[best_axis];
+	const float k = BVH4_BIN_COUNT / (cb.Max[best_axis] - cmin);
+	uint32 i = beg;
+	uint32 j = end;
+
+	while( i < j )
+	{
+		const uint32 t = s.ti[i];
+
+		if( bin_index( s.tcen[t][best_axis], cmin, k ) <= best_bin )
+		{
+			i++;
+		}
+		else
+		{
+			s.ti[i] = s.ti[--j];
+			s.ti[j] = t;
+		}
+	}
+
+	mid = i;
+	return true;
+}
+
+
+//---------------------------------------------------------------------------//
+//recursively build the node for triangles [beg,end), returns its index
+static uint32 build_node
+(
+	bvh4_build&		s,
+	const uint32	beg,
+	const uint32	end,
+	const uint32	depth
+)
+{
+	const uint32 ni = s.nc++;
+
+	s.depth = LTMAX( s.depth, depth );
+
+	//ALGORITHM:  Start with all the triangles in one cluster, then keep
+	//splitting the cluster with the largest surface area until there are
+	//four of them, or every cluster is better off as a leaf.
+	uint32 cbeg[4], cend[4];
+	LTAABB cbox[4];
+	bool leaf[4];
+	int32 cc = 1;
+
+	LTAABB cen;
+	cbeg[0] = beg;
+	cend[0] = end;
+	leaf[0] = false;
+	range_bounds( cbox[0], cen, s, beg, end );
+
+	while( cc < 4 )
+	{
+		int32 best = -1;
+		float best_area = -1;
+
+		for( int32 c=0 ; c<cc ; c++ )
+		{
+			if( !leaf[c] && half_area( cbox[c] ) > best_area )
+			{
+				best = c;
+				best_area = half_area( cbox[c] );
+			}
+		}
+
+		if( best < 0 )
+			break;
+
+		uint32 mid;
+
+		if( sah_split( mid, s, cbeg[best], cend[best] ) )
+		{
+			cbeg[cc] = mid;
+			cend[cc] = cend[best];
+			leaf[cc] = false;
+			range_bounds( cbox[cc], cen, s, mid, cend[cc] );
+
+			cend[best] = mid;
+			range_bounds( cbox[best], cen, s, cbeg[best], mid );
+
+			cc++;
+		}
+		else
+		{
+			leaf[best] = true;
+		}
+	}
+
+	for( int32 c=0 ; c<4 ; c++ )
+	{
+		LTBVH4_Node& nd = s.node[ni];
+
+		if( c >= cc )
+		{
+			//unused lane, inverted bounds never pass a test
+			nd.MinX[c] = nd.MinY[c] = nd.MinZ[c] = FLT_MAX;
+			nd.MaxX[c] = nd.MaxY[c] = nd.MaxZ[c] = -FLT_MAX;
+			nd.Child[c] = 0;
+			nd.Count[c] = 0;
+			continue;
+		}
+
+		nd.MinX[c] = cbox[c].Min.x;
+		nd.MinY[c] = cbox[c].Min.y;
+		nd.MinZ[c] = cbox[c].Min.z;
+		nd.MaxX[c] = cbox[c].Max.x;
+		nd.MaxY[c] = cbox[c].Max.y;
+		nd.MaxZ[c] = cbox[c].Max.z;
+
+		//clusters that were never considered for a split may still be leaves
+		uint32 mid;
+
+		if( !leaf[c] && !sah_split( mid, s, cbeg[c], cend[c] ) )
+			leaf[c] = true;
+
+		if( leaf[c] )
+		{
+			nd.Child[c] = cbeg[c];
+			nd.Count[c] = cend[c] - cbeg[c];
+		}
+		else
+		{
+			//NOTE:  the node array is allocated up front, so nd stays valid
+			nd.Child[c] = build_node( s, cbeg[c], cend[c], depth + 1 );
+			nd.Count[c] = 0;
+		}
+	}
+
+	return ni;
+}
+
+
+//---------------------------------------------------------------------------//
+LTBVH4::LTBVH4()
+	:	m_pNode(NULL),
+		m_NCount(0),
+		m_pTri(NULL),
+		m_TCount(0),
+		m_Depth(0)
+{}
+
+
+//---------------------------------------------------------------------------//
+LTBVH4::~LTBVH4()
+{
+	Term();
+}
+
+
+//---------------------------------------------------------------------------//
+void LTBVH4::Term()
+{
+	delete [] m_pNode;
+	delete [] m_pTri;
+
+	m_pNode = NULL;
+	m_pTri = NULL;
+	m_NCount = m_TCount = m_Depth = 0;
+}
+
+
+//---------------------------------------------------------------------------//
+bool LTBVH4::Build( const LTTriangle tri[], const uint32 tc, const LTVector3f V[] )
+{
+	Term();
+
+	if( tc == 0 )
+		return false;
+
+	//every node but the root has at least two children and every
+	//leaf has at least one triangle, so there are at most tc nodes
+	LT_MEM_TRACK_ALLOC(m_pNode = new LTBVH4_Node[tc],LT_MEM_TYPE_PHYSICS);
+	LT_MEM_TRACK_ALLOC(m_pTri = new uint32[tc],LT_MEM_TYPE_PHYSICS);
+	m_TCount = tc;
+
+	//triangle bounds and centroids
+	LTAABB* tb;
+	LTVector3f* tcen;
+
+	LT_MEM_TRACK_ALLOC(tb = new LTAABB[tc],LT_MEM_TYPE_PHYSICS);
+	LT_MEM_TRACK_ALLOC(tcen = new LTVector3f[tc],LT_MEM_TYPE_PHYSICS);
+
+	for( uint32 i=0 ; i<tc ; i++ )
+	{
+		const LTVector3f& v0 = V[ tri[i].v[0] ];
+		const LTVector3f& v1 = V[ tri[i].v[1] ];
+		const LTVector3f& v2 = V[ tri[i].v[2] ];
+
+		tb[i] = LTAABB( v0, v0 );
+		grow_bounds( tb[i], LTAABB( v1, v1 ) );
+		grow_bounds( tb[i], LTAABB( v2, v2 ) );
+		tcen[i] = tb[i].Center();
+
+		m_pTri[i] = i;
+	}
+
+	bvh4_build s;
+	s.node	= m_pNode;
+	s.nc	= 0;
+	s.ti	= m_pTri;
+	s.tb	= tb;
+	s.tcen	= tcen;
+	s.depth	= 0;
+
+	build_node( s, 0, tc, 1 );
+
+	m_NCount = s.nc;
+	m_Depth = s.depth;
+
+	delete [] tb;
+	delete [] tcen;
+
+	return true;
+}
+
+
+//---------------------------------------------------------------------------//
+//Traversal stack, which only goes to the heap for very deep trees.  Each
+//node visited replaces itself with at most four children.
+class bvh4_stack
+{
+public:
+
+	bvh4_stack( const uint32 depth )
+		:	m_pEntry(m_Local),
+			m_Count(0)
+	{
+		const uint32 size = 3*depth + 1;
+
+		if( size > BVH4_LOCAL_STACK )
+			LT_MEM_TRACK_ALLOC(m_pEntry = new uint32[size],LT_MEM_TYPE_PHYSICS);
+	}
+
+	~bvh4_stack()
+	{
+		if( m_pEntry != m_Local )
+			delete [] m_pEntry;
+	}
+
+	void Push( const uint32 ni )	{ m_pEntry[m_Count++] = ni; }
+	uint32 Pop()					{ return m_pEntry[--m_Count]; }
+	bool Empty() const				{ return m_Count == 0; }
+
+private:
+
+	uint32* m_pEntry;
+	uint32 m_Count;
+	uint32 m_Local[BVH4_LOCAL_STACK];
+};
+
+
+//---------------------------------------------------------------------------//
+//Walk the tree, testing the four children of each node with Q::Test()
+template<class Q>
+static bool bvh4_traverse
+(
+	LTBVH4_Callback&	cb,
+	const Q&			q,
+	const LTBVH4_Node	node[],
+	const uint32		ti[],
+	const uint32		depth
+)
+{
+	bvh4_stack stack( depth );
+	bool bFound = false;
+
+	stack.Push( 0 );
+
+	while( !stack.Empty() )
+	{
+		const LTBVH4_Node& nd = node[ stack.Pop() ];
+		const uint32 mask = q.Test( nd );
+
+		if( !mask )
+			continue;
+
+		for( int32 c=0 ; c<4 ; c++ )
+		{
+			if( !(mask & (1 << c)) )
+				continue;
+
+			if( nd.Count[c] )
+			{
+				//report the leaf's triangles
+				const uint32* pTri = &ti[ nd.Child[c] ];
+
+				for( uint32 i=0 ; i<nd.Count[c] ; i++ )
+				{
+					bFound = true;
+
+					if( !cb.Triangle( pTri[i] ) )
+						return true;
+				}
+			}
+			else
+			{
+				stack.Push( nd.Child[c] );
+			}
+		}
+	}
+
+	return bFound;
+}
+
+
+//---------------------------------------------------------------------------//
+//box overlap test
+struct bvh4_box_query
+{
+#ifdef BVH4_SSE2
+	__m128 bmin[3], bmax[3];
+#endif
+	LTAABB box;
+
+	bvh4_box_query( const LTAABB& b )
+		:	box(b)
+	{
+#ifdef BVH4_SSE2
+		for( int32 i=0 ; i<3 ; i++ )
+		{
+			bmin[i] = _mm_set1_ps( b.Min[i] );
+			bmax[i] = _mm_set1_ps( b.Max[i] );
+		}
+#endif
+	}
+
+	//returns a bit for each child that overlaps the box
+	uint32 Test( const LTBVH4_Node& nd ) const
+	{
+#ifdef BVH4_SSE2
+		__m128 ok = _mm_and_ps( _mm_cmple_ps( bmin[0], _mm_loadu_ps(nd.MaxX) ),
+								_mm_cmple_ps( _mm_loadu_ps(nd.MinX), bmax[0] ) );
+		ok = _mm_and_ps( ok, _mm_and_ps( _mm_cmple_ps( bmin[1], _mm_loadu_ps(nd.MaxY) ),
+										_mm_cmple_ps( _mm_loadu_ps(nd.MinY), bmax[1] ) ) );
+		ok = _mm_and_ps( ok, _mm_and_ps( _mm_cmple_ps( bmin[2], _mm_loadu_ps(nd.MaxZ) ),
+										_mm_cmple_ps( _mm_loadu_ps(nd.MinZ), bmax[2] ) ) );
+
+		return (uint32)_mm_movemask_ps( ok );
+#else
+		uint32 mask = 0;
+
+		for( int32 c=0 ; c<4 ; c++ )
+		{
+			if(	box.Min.x <= nd.MaxX[c] && nd.MinX[c] <= box.Max.x
+				&&
+				box.Min.y <= nd.MaxY[c] && nd.MinY[c] <= box.Max.y
+				&&
+				box.Min.z <= nd.MaxZ[c] && nd.MinZ[c] <= box.Max.z )
+				mask |= 1 << c;
+		}
+
+		return mask;
+#endif
+	}
+};
+
+
+//---------------------------------------------------------------------------//
+//swept box test
+struct bvh4_sweep_query
+{
+	//ALGORITHM:  A box with half-dimensions d moving from p0 to p1 touches
+	//a child if the segment p0->p1 hits the child expanded by d.  The slab
+	//test takes the near plane from min or max depending on the direction,
+	//so a child with inverted bounds is never hit.
+	bool neg[3];		//moving towards -axis
+	float onear[3];		//p0 offset by the expansion of the near plane
+	float ofar[3];		//p0 offset by the expansion of the far plane
+	float inv[3];		//1/(p1-p0)
+#ifdef BVH4_SSE2
+	__m128 vonear[3], vofar[3], vinv[3];
+#endif
+
+	bvh4_sweep_query( const LTVector3f& p0, const LTVector3f& p1, const LTVector3f& d )
+	{
+		for( int32 i=0 ; i<3 ; i++ )
+		{
+			const float dir = p1[i] - p0[i];
+
+			neg[i] = dir < 0;
+
+			//near plane is min-d moving up, max+d moving down
+			onear[i] = neg[i] ? p0[i] - d[i] : p0[i] + d[i];
+			ofar[i] = neg[i] ? p0[i] + d[i] : p0[i] - d[i];
+
+			//NOTE:  a large finite value instead of infinity
+			//keeps (plane - p0) == 0 from giving a NaN
+			if( dir > 1e-20f || dir < -1e-20f )
+				inv[i] = 1 / dir;
+			else
+				inv[i] = neg[i] ? -1e30f : 1e30f;
+
+#ifdef BVH4_SSE2
+			vonear[i] = _mm_set1_ps( onear[i] );
+			vofar[i] = _mm_set1_ps( ofar[i] );
+			vinv[i] = _mm_set1_ps( inv[i] );
+#endif
+		}
+	}
+
+	//returns a bit for each child that the swept box touches
+	uint32 Test( const LTBVH4_Node& nd ) const
+	{
+		const float* pNear[3] =
+		{
+			neg[0] ? nd.MaxX : nd.MinX,
+			neg[1] ? nd.MaxY : nd.MinY,
+			neg[2] ? nd.MaxZ : nd.MinZ
+		};
+		const float* pFar[3] =
+		{
+			neg[0] ? nd.MinX : nd.MaxX,
+			neg[1] ? nd.MinY : nd.MaxY,
+			neg[2] ? nd.MinZ : nd.MaxZ
+		};
+
+#ifdef BVH4_SSE2
+		__m128 tnear = _mm_setzero_ps();
+		__m128 tfar = _mm_set1_ps( 1.f );
+
+		for( int32 i=0 ; i<3 ; i++ )
+		{
+			tnear = _mm_max_ps( tnear, _mm_mul_ps( _mm_sub_ps( _mm_loadu_ps(pNear[i]), vonear[i] ), vinv[i] ) );
+			tfar = _mm_min_ps( tfar, _mm_mul_ps( _mm_sub_ps( _mm_loadu_ps(pFar[i]), vofar[i] ), vinv[i] ) );
+		}
+
+		return (uint32)_mm_movemask_ps( _mm_cmple_ps( tnear, tfar ) );
+#else
+		uint32 mask = 0;
+
+		for( int32 c=0 ; c<4 ; c++ )
+		{
+			float tnear = 0;
+			float tfar = 1;
+
+			for( int32 i=0 ; i<3 ; i++ )
+			{
+				tnear = LTMAX( tnear, (pNear[i][c] - onear[i]) * inv[i] );
+				tfar = LTMIN( tfar, (pFar[i][c] - ofar[i]) * inv[i] );
+			}
+
+			if( tnear <= tfar )
+				mask |= 1 << c;
+		}
+
+		return mask;
+#endif
+	}
+};
+
+
+//---------------------------------------------------------------------------//
+bool LTBVH4::BoxSweep
+(
+	LTBVH4_Callback&	cb,
+	const LTVector3f&	p0,
+	const LTVector3f&	p1,
+	const LTVector3f&	d
+) const
+{
+	if( !m_pNode )
+		return false;
+
+	return bvh4_traverse( cb, bvh4_sweep_query( p0, p1, d ), m_pNode, m_pTri, m_Depth );
+}
+
+
+//---------------------------------------------------------------------------//
+bool LTBVH4::BoxIntersect( LTBVH4_Callback& cb, const LTAABB& box ) const
+{
+	if( !m_pNode )
+		return false;
+
+	return bvh4_traverse( cb, bvh4_box_query( box ), m_pNode, m_pTri, m_Depth );
+}
+
+
+//EOF
@@ -1,4 +1,5 @@
 #include "collision_data.h"
+#include "ltmem.h"
 #include "build_aabb.h"
 #include <string.h>
 
@@ -2,6 +2,7 @@
 #include "sphere.h"
 #include "obb.h"
 #include "cylinder.h"
+#include "ltmem.h"
 
 
 //---------------------------------------------------------------------------//
@@ -31,6 +32,40 @@ inline void SwapIntersectInfo( LTIntersectInfo& ii, const ILTCollisionObject& o
 }
 
 
+//---------------------------------------------------------------------------//
+LTGJKCache* LTGJKPairCache::Find( const HOBJECT hA, const HOBJECT hB )
+{
+	//static geometry has no handle to tell it apart
+	if( !hA || !hB )
+		return NULL;
+
+	const uint32 a = (uint32)(size_t)hA;
+	const uint32 b = (uint32)(size_t)hB;
+	Entry& e = m_Table[ ((a>>4) * 31 + (b>>4)) & (TABLE_SIZE-1) ];
+
+	//take the slot over from another pair
+	if( e.m_hA != hA || e.m_hB != hB )
+	{
+		e.m_hA = hA;
+		e.m_hB = hB;
+		e.m_Cache = LTGJKCache();
+	}
+
+	return &e.m_Cache;
+}
+
+//---------------------------------------------------------------------------//
+void LTGJKPairCache::Clear()
+{
+	for( int32 i=0 ; i<TABLE_SIZE ; i++ )
+	{
+		m_Table[i].m_hA = NULL;
+		m_Table[i].m_hB = NULL;
+		m_Table[i].m_Cache = LTGJKCache();
+	}
+}
+
+
 //---------------------------------------------------------------------------//
 bool LTCollisionSphere::Hit
 (
@@ -147,12 +182,7 @@ bool LTCollisionSphere::HitMesh
 	//mesh extents
 	const LTVector3f& min = mesh.m_pData->m_Min;
 	const LTVector3f& max = mesh.m_pData->m_Max;
-	//aabb node array
-	const LTAABB_Node* node = mesh.m_pData->Nodes();
-	//TODO:  use a dynamic array
-	const uint16 tc_max = 128;//max number of triangle indices
-	uint16 ti[tc_max];//array of triangle indices
-	uint16 tc = 0;//number of potential Triangles
+	LTTriangleIndexList ti;//indices of potential triangles
 	bool bHit = false;
 
 	//set object handle (who it hit)
@@ -166,7 +196,7 @@ bool LTCollisionSphere::HitMesh
 	//get the indices of the triangles that the sphere
 	//might have hit along its path from p0 to p1, and
 	//report the first contact
-	if( AABBTreeBoxSweep( ti, tc, tc_max, min, max, node, C0, C1, d ) )
+	if( mesh.BVH().BoxSweep( ti, C0, C1, d ) )
 	{
 		const LTTriangle* tri = mesh.m_pData->Triangles();//Triangles
 		const LTVector3u16* V = mesh.m_pData->Vertices();//packed Vertices
@@ -174,7 +204,7 @@ bool LTCollisionSphere::HitMesh
 		const float s = 1 / float(0xFFFF);//scale factor
 
 		//sweep the sphere against each triangle
-		for( uint16 i=0 ; i<tc ; i++ )
+		for( uint32 i=0 ; i<ti.Count() ; i++ )
 		{
 			const LTTriangle& t = tri[ ti[i] ];
 			LTVector3f v[3];//unpacked Vertices
@@ -204,7 +234,7 @@ bool LTCollisionSphere::HitMesh
 					//contact point, world frame
 					ci.m_P = (1-u)*m_P0 + u*m_P1 - r*n;
 					//this triangle's surface properties
-					ci.m_Sb = mesh.m_pData->FindSurface( ti[i] );
+					ci.m_Sb = mesh.m_pData->FindSurface( (uint16)ti[i] );
 
 					//apply filter
 					if( cf.Condition( ci ) )
@@ -337,16 +367,11 @@ bool LTCollisionSphere::IntersectMesh
 	//mesh extents
 	const LTVector3f& min = mesh.m_pData->m_Min;
 	const LTVector3f& max = mesh.m_pData->m_Max;
-	//aabb nodes
-	const LTAABB_Node* node = mesh.m_pData->Nodes();
-	//TODO:  use a dynamic array
-	const uint16 tc_max = 128;//max number of triangle indices
-	uint16 ti[tc_max];//array of triangle indices
-	uint16 tc = 0;//number of potential Triangles
+	LTTriangleIndexList ti;//indices of potential triangles
 
 	//get a list of triangles the
 	//sphere might be intersecting
-	if( AABBTreeBoxIntersect( ti, tc, tc_max, min, max, node, box ) )
+	if( mesh.BVH().BoxIntersect( ti, box ) )
 	{
 		const LTTriangle* tri = mesh.m_pData->Triangles();//Triangles
 		const LTVector3u16* V = mesh.m_pData->Vertices();//packed Vertices
@@ -361,7 +386,7 @@ bool LTCollisionSphere::IntersectMesh
 		info.m_hObj = mesh.m_hObj;
 
 		//check sphere against each triangle
-		for( int32 i=0 ; i<tc ; i++ )
+		for( uint32 i=0 ; i<ti.Count() ; i++ )
 		{
 			const LTTriangle& t = tri[ ti[i] ];
 			LTVector3f v[3];//unpacked Vertices
@@ -516,7 +541,7 @@ bool LTCollisionBox::HitBox
 	LTVector3f pa, pb, n;
 	float u;
 
-	if( OBBSweep(u,n,pa,pb,A0,A1,m_Dim,B0,B1,b.m_Dim) )
+	if( OBBSweep(u,n,pa,pb,A0,A1,m_Dim,B0,B1,b.m_Dim,FindGJKCache(m_hObj,b.m_hObj)) )
 	{
 		ci.m_hObj = b.m_hObj;//other object
 		ci.m_U = u;//normalized time of contact
@@ -908,7 +933,7 @@ bool LTCollisionCylinder::HitSphere
 	//normalized time of collision
 	float u;
 
-		if( SphereCylinderSweep(u,n,pa,pb,A0,A1,ra,B0,B1,rb,hh) )
+		if( SphereCylinderSweep(u,n,pa,pb,A0,A1,ra,B0,B1,rb,hh,FindGJKCache(s.m_hObj,m_hObj)) )
 		{
 			ci.m_hObj = s.m_hObj;//other object
 			ci.m_U = u;//normalized time of contact
@@ -949,7 +974,7 @@ bool LTCollisionCylinder::HitBox
 	//normalized time of collision
 	float u;
 
-		if( CylinderBoxSweep(u,n,pa,pb,A0,A1,r,hh,B0,B1,dim) )
+		if( CylinderBoxSweep(u,n,pa,pb,A0,A1,r,hh,B0,B1,dim,FindGJKCache(m_hObj,b.m_hObj)) )
 		{
 			ci.m_hObj = b.m_hObj;//other object
 			ci.m_U = u;//normalized time of contact
@@ -991,7 +1016,7 @@ bool LTCollisionCylinder::HitCylinder
 	//normalized time of collision
 	float u;
 
-		if( CylinderSweep(u,n,pa,pb,A0,A1,ra,ha,B0,B1,rb,hb) )
+		if( CylinderSweep(u,n,pa,pb,A0,A1,ra,ha,B0,B1,rb,hb,FindGJKCache(m_hObj,c.m_hObj)) )
 		{
 			ci.m_hObj = c.m_hObj;//other object
 			ci.m_U = u;//normalized time of contact
@@ -1199,6 +1224,37 @@ LTCollisionMesh::~LTCollisionMesh()
 	//delete memory
 	if( m_pData && m_Delete )
 		delete m_pData;
+
+	delete m_pBVH;
+}
+
+//---------------------------------------------------------------------------//
+const LTBVH4& LTCollisionMesh::BVH() const
+{
+	if( !m_pBVH )
+	{
+		LT_MEM_TRACK_ALLOC(m_pBVH = new LTBVH4,LT_MEM_TYPE_PHYSICS);
+
+		//unpack the vertices so the triangle bounds match the
+		//vertices used by the narrow phase tests
+		const LTVector3f& min = m_pData->m_Min;
+		const LTVector3f e = m_pData->m_Max - min;//dimensions of root node
+		const float s = 1 / float(0xFFFF);//scale factor
+		const LTVector3u16* Vs = m_pData->Vertices();//packed vertices
+		const uint32 vc = m_pData->m_VCount;
+		LTVector3f* V;
+
+		LT_MEM_TRACK_ALLOC(V = new LTVector3f[vc],LT_MEM_TYPE_PHYSICS);
+
+		for( uint32 i=0 ; i<vc ; i++ )
+			V[i] = UnpackVector( Vs[i], min, e, s );
+
+		m_pBVH->Build( m_pData->Triangles(), m_pData->m_TCount, V );
+
+		delete [] V;
+	}
+
+	return *m_pBVH;
 }
 
 //---------------------------------------------------------------------------//
@@ -1416,18 +1472,14 @@ bool LTCollisionMesh::IntersectSegment
 	const LTVector3f l0 = F1.TransformPointToLocal( p0 );
 	const LTVector3f l1 = F1.TransformPointToLocal( p1 );
 	const LTVector3f dim(0,0,0);
-	//get the aabb tree data
+	//mesh extents
 	const LTVector3f& min = this->m_pData->m_Min;//root extents
 	const LTVector3f& max = this->m_pData->m_Max;
-	const LTAABB_Node* node = this->m_pData->Nodes();//aabb node array
-	//TODO:  use a dynamic array
-	const uint16 tc_max = 128;//max number of triangle indices
-	uint16 ti[tc_max];//array of triangle indices
-	uint16 tc = 0;//number of potential Triangles
+	LTTriangleIndexList ti;//indices of potential triangles
 
 	//get a list of potential triangles then
 	//check each of them for intersection
-	if( AABBTreeBoxSweep( ti, tc, tc_max, min, max, node, l0, l1, dim ) )
+	if( BVH().BoxSweep( ti, l0, l1, dim ) )
 	{
 		const LTTriangle* tri = this->m_pData->Triangles();//Triangles
 		const LTVector3u16* V = this->m_pData->Vertices();//packed Vertices
@@ -1435,7 +1487,7 @@ bool LTCollisionMesh::IntersectSegment
 		const float s = 1 / float(0xFFFF);//scale factor
 
 		//check line segment against each triangle
-		for( int32 i=0 ; i<tc ; i++ )
+		for( uint32 i=0 ; i<ti.Count() ; i++ )
 		{
 			const LTTriangle& t = tri[ ti[i] ];
 			const LTVector3f v0 = UnpackVector( V[t.v[0]], min, e, s );
@@ -12,7 +12,8 @@ bool SphereCylinderClosestPoints
 	const float			ra,
 	const LTCoordinateFrameQ& B,
 	const float			rb,
-	const float			hh
+	const float			hh,
+	LTGJKCache*			pCache
 )
 {
 	//if A and B intersect, then a and b cannot be found
@@ -26,7 +27,7 @@ bool SphereCylinderClosestPoints
 	LTSphereSupportMap Sa( A, ra );
 	LTCylinderSupportMap Sb( B.m_O, B, rb, hh );
 
-		GJK_ClosestPoints( a, b, Sa, Sb );
+		GJK_ClosestPoints( a, b, Sa, Sb, pCache );
 
 	return true;
 }
@@ -45,7 +46,8 @@ bool SphereCylinderSweep
 	const LTCoordinateFrameQ& B0,
 	const LTCoordinateFrameQ& B1,
 	const float			rb,
-	const float			hh
+	const float			hh,
+	LTGJKCache*			pCache
 )
 {
 	//ALGORITHM:  Use a line-OBB test with expanded box dims.
@@ -61,7 +63,7 @@ bool SphereCylinderSweep
 		const LTCoordinateFrameQ Bi = Interpolate(B0,B1,u);
 
 		//calculate n using the closest points between A and B
-		if( !SphereCylinderClosestPoints(a,b,Ai,ra,Bi,rb,hh) )
+		if( !SphereCylinderClosestPoints(a,b,Ai,ra,Bi,rb,hh,pCache) )
 			return false;
 
 		const LTVector3f v = a - b;//separating axis
@@ -88,7 +90,8 @@ bool CylinderBoxClosestPoints
 	const float			r,
 	const float			hh,
 	const LTCoordinateFrameQ& B,
-	const LTVector3f&	dim
+	const LTVector3f&	dim,
+	LTGJKCache*			pCache
 )
 {
 	//if A and B intersect, then a and b cannot be found
@@ -102,7 +105,7 @@ bool CylinderBoxClosestPoints
 	LTCylinderSupportMap Sa( A.m_O, A, r, hh );
 	LTBoxSupportMap Sb( B.m_O, B, dim );
 
-		GJK_ClosestPoints( a, b, Sa, Sb );
+		GJK_ClosestPoints( a, b, Sa, Sb, pCache );
 
 	return true;
 }
@@ -121,7 +124,8 @@ bool CylinderBoxSweep
 	const float			hh,
 	const LTCoordinateFrameQ& B0,
 	const LTCoordinateFrameQ& B1,
-	const LTVector3f&	dim
+	const LTVector3f&	dim,
+	LTGJKCache*			pCache
 )
 {
 	//ALGORITHM:  If A and B intersect at time t1, find the closest points
@@ -136,7 +140,7 @@ bool CylinderBoxSweep
 		return false;
 
 	//find the closest points between A and B
-	if( !CylinderBoxClosestPoints(a,b,A0,r,hh,B0,dim) )
+	if( !CylinderBoxClosestPoints(a,b,A0,r,hh,B0,dim,pCache) )
 		return false;
 
 	u = 0;//TODO:  iterate a more accurate u
@@ -163,7 +167,8 @@ bool CylinderClosestPoints
 	const float			ha,
 	const LTCoordinateFrameQ& B,
 	const float			rb,
-	const float			hb
+	const float			hb,
+	LTGJKCache*			pCache
 )
 {
 	//if A and B intersect, then a and b cannot be found
@@ -178,7 +183,7 @@ bool CylinderClosestPoints
 	LTCylinderSupportMap Sa( A.m_O, A, ra, ha );
 	LTCylinderSupportMap Sb( B.m_O, B, rb, hb );
 
-		GJK_ClosestPoints( a, b, Sa, Sb );
+		GJK_ClosestPoints( a, b, Sa, Sb, pCache );
 
 	return true;
 }
@@ -198,7 +203,8 @@ bool CylinderSweep
 	const LTCoordinateFrameQ& B0,
 	const LTCoordinateFrameQ& B1,
 	const float			rb,
-	const float			hb
+	const float			hb,
+	LTGJKCache*			pCache
 )
 {
 	//ALGORITHM:  If A and B intersect at time t1, find the closest points
@@ -214,7 +220,7 @@ bool CylinderSweep
 		return false;
 
 	//find the closest points between A and B
-	if( !CylinderClosestPoints(a,b,A0,ra,ha,B0,rb,hb) )
+	if( !CylinderClosestPoints(a,b,A0,ra,ha,B0,rb,hb,pCache) )
 		return false;
 
 	u = 0;//TODO:  iterate a more accurate u
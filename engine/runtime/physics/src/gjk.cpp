@@ -80,21 +80,23 @@ const int32 xbit_table[14] =
 
 //---------------------------------------------------------------------------//
 //compute the cofactors of the matrices corresponding
-//to each feature on the simplex Y
-void compute_cofactors( float del[4][16], const LTVector3f y[4], const int32 N )
+//to each feature on the simplex Y; they're products of
+//differences of dot products, which float can't resolve
+//for the thin simplices of curved shapes
+void compute_cofactors( double del[4][16], const LTVector3f y[4], const int32 N )
 {
-	float dy[4][4];
+	double dy[4][4];
 
 	//precompute dot products y[i].y[j]
 	for( int32 i=0 ; i<N ; i++ )
 	{
 		for( int32 j=0 ; j<N ; j++ )
 		{
-			dy[i][j] = y[i].Dot(y[j]);
+			dy[i][j] = (double)y[i].x*y[j].x + (double)y[i].y*y[j].y + (double)y[i].z*y[j].z;
 		}
 	}
 
-	float* pc = (float*)del;
+	double* pc = (double*)del;
 
 	//initialize c[][] to 0, or else closest_feature()
 	//may fail since higher order cofactors may be >0
@@ -156,7 +158,7 @@ void compute_cofactors( float del[4][16], const LTVector3f y[4], const int32 N )
 bool closest_feature
 (
 	const int32 xbits,		//defines simplex X
-	const float del[4][16],	//cofactors del[i]( X )
+	const double del[4][16],	//cofactors del[i]( X )
 	const int32 N			//number of points in Y
 )
 {
@@ -183,12 +185,14 @@ bool closest_feature
 }
 
 //---------------------------------------------------------------------------//
-const LTVector3f determine_X_and_v
+bool determine_X_and_v
 (
-	float		del[4][16],
+	LTVector3f&	v,
+	double		del[4][16],
 	LTVector3f	p[4],
 	LTVector3f	q[4],
 	LTVector3f	y[4],
+	LTVector3f	dir[4],
 	float		lam[4],
 	int32&		N
 )
@@ -208,7 +212,8 @@ const LTVector3f determine_X_and_v
 	if( 1==N )
 	{
 		lam[0] = 1.f;
-		return y[0];
+		v = y[0];
+		return true;
 	}
 
 	//compute the cofactors of the matrices corresponding
@@ -227,15 +232,15 @@ const LTVector3f determine_X_and_v
 		//origin of configuration space
 		if( closest_feature( xbits, del, N ) )
 		{
-			float detA = 0;
+			double detA = 0;
 
 			//det(A) = Sum( del[i]( X ) )
 			for( int32 i=0 ; i<N ; i++ )
 				if( xbits & (1<<i) )//i is in Ix
 					detA += del[i][xbits];
 
-			LTVector3f v(0,0,0);//separating axis = v(conv(X)) = v(conv(Y))
-			const float s = 1/detA;
+			v.Init();//separating axis = v(conv(X)) = v(conv(Y))
+			const double s = 1/detA;
 
 			N=0;//reset N OUTSIDE of loop
 
@@ -248,8 +253,9 @@ const LTVector3f determine_X_and_v
 					p[N]	= p[i];
 					q[N]	= q[i];
 					y[N]	= y[i];
+					dir[N]	= dir[i];
 					//interpolation parameter
-					lam[N]	= s * del[i][xbits];
+					lam[N]	= (float)(s * del[i][xbits]);
 					//separating axis
 					v		+= lam[N] * y[N];
 					//point count
@@ -260,15 +266,17 @@ const LTVector3f determine_X_and_v
 			if( 4 == N )//contains origin
 				v.Init();
 
-			return v;//found it, stop
+			return true;//found it, stop
 		}
 	}
 
-	//NOTE:  Because we're using only 7 digits of precision,
-	//we might not be able to resolve highly ill-conditioned
-	//simplices.  In this case, just return (0,0,0) so the
-	//algorithm terminates.
-	return LTVector3f(0,0,0);
+	//NOTE:  The vertices only have 7 digits of precision, so
+	//even with double precision cofactors we might not be able
+	//to resolve highly ill-conditioned simplices.  In this
+	//case return false, leaving the
+	//simplex, lam and v as they were, so the caller can
+	//stop with the last simplex it could resolve.
+	return false;
 }
 
 
@@ -286,15 +294,32 @@ bool degenerate_Y( const LTVector3f y[4], const int32 N, const float eps )
 }
 
 
+//---------------------------------------------------------------------------//
+//evaluate a support mapping without going through the v-table
+template< class S >
+inline const LTVector3f support( S& s, const LTVector3f& v )
+{
+	return s.S::operator () ( v );
+}
+
+//the abstract interface has to go through the v-table
+inline const LTVector3f support( ILTSupportMap& s, const LTVector3f& v )
+{
+	return s( v );
+}
+
+
 //---------------------------------------------------------------------------//
 //given two support mappings sA and sB, compute the closest points between
 //objects A and B, return the distance d between them
-float GJK_ClosestPoints
+template< class SA, class SB >
+static float gjk_closest_points
 (
 	LTVector3f& a,
 	LTVector3f& b,
-	ILTSupportMap& sA,
-	ILTSupportMap& sB,
+	SA& sA,
+	SB& sB,
+	LTGJKCache* pCache,
 	const float eps
 )
 {
@@ -303,13 +328,53 @@ float GJK_ClosestPoints
 	//closest points a and b when the algorithm terminates
 	LTVector3f p[4], q[4];
 	LTVector3f y[4];//simplex vertices of A-B in parent coordinates
+	LTVector3f dir[4];//search directions that produced y[], parent coordinates
 	int32 N = 0;//number of points in p[], q[] and y[]
-	LTVector3f v = sA.Position() - sB.Position();//current separating axis
+	LTVector3f v;//current separating axis
 	float lam[4] = {1.f,0.f,0.f,0.f};//interpolation parameters
-	float d = v.Length();//distance between A and B
+	float d = 0;//distance between A and B
 	float mu = 0.f;//lower bound on d
-	float del[4][16];//cofactors for features of simplex
+	double del[4][16];//cofactors for features of simplex
 	int32 iter = 0;
+	bool bWarm = false;//started from the cached simplex
+
+	//warm start from the simplex of the last query; the
+	//shapes have moved since, so only the directions are
+	//reused and the support points are found again
+	if( pCache && pCache->m_Count )
+	{
+		for( int32 i=0 ; i<pCache->m_Count ; i++ )
+		{
+			dir[N] = pCache->m_Dir[i];
+			p[N] = support( sA, sA.TransformVectorToLocal(dir[N]) );
+			q[N] = support( sB, sB.TransformVectorToLocal(-dir[N]) );
+			y[N] = sA.TransformPointToParent( p[N] ) - sB.TransformPointToParent( q[N] );
+			N++;
+
+			//several directions can map to the same vertex
+			if( degenerate_Y(y,N,eps) )
+				N--;
+		}
+
+		//an old simplex that can't be resolved any more is no help
+		if( determine_X_and_v( v, del, p, q, y, dir, lam, N ) )
+		{
+			d = v.Length();
+			bWarm = true;
+		}
+		else
+		{
+			N = 0;
+			lam[0] = 1.f;
+		}
+	}
+
+	//cold start
+	if( !bWarm )
+	{
+		v = sA.Position() - sB.Position();
+		d = v.Length();
+	}
 
 	while( d>eps && iter<50 )
 	{
@@ -317,8 +382,9 @@ float GJK_ClosestPoints
 		iter++;
 
 		//support points in their respective local frames
-		p[N] = sA( sA.TransformVectorToLocal(-v) );
-		q[N] = sB( sB.TransformVectorToLocal(v) );
+		dir[N] = -v;
+		p[N] = support( sA, sA.TransformVectorToLocal(-v) );
+		q[N] = support( sB, sB.TransformVectorToLocal(v) );
 
 		//transform a and b to the same parent frame
 		a = sA.TransformPointToParent( p[N] );
@@ -335,14 +401,24 @@ float GJK_ClosestPoints
 		//the closest point on A-B to O
 		mu = Max( mu, v.Dot(w) / d );
 
+		//if the search stops here, v came from the simplex without
+		//w, so w must not be used for the closest points (its lam
+		//is left over from an earlier iteration)
 		if( d-mu <= d*eps )//relative error
+		{
+			if( N>1 )
+				N--;
 			break;
+		}
 
 		//if w is equal to any of the points already in the simplex
 		//Y, then w is the closest point in A-B to origin and d has
 		//been found to within eps
 		if( degenerate_Y(y,N,eps) )
+		{
+			N--;
 			break;
+		}
 		//NOTE:  To guarantee maximum accuracy for {a,b}, the
 		//degeneracy condition can be used to terminate, but the
 		//accuracy gains seem to be negligable and the iteration
@@ -350,14 +426,41 @@ float GJK_ClosestPoints
 
 		//y[] goes in as Y={yi} and comes out as X={xi},
 		//N is adjusted accordingly, shuffle p[] and q[]
-		//as well and determine lam[i]
-		v = determine_X_and_v( del, p, q, y, lam, N );
+		//as well and determine lam[i]; if Y is too ill-
+		//conditioned to resolve, stop with the simplex
+		//without w, which is as close as we can get
+		if( !determine_X_and_v( v, del, p, q, y, dir, lam, N ) )
+		{
+			if( N>1 )
+				N--;
+			break;
+		}
 
 		//distance from closest feature on simplex
 		//to origin, 0 if simplex contains origin
 		d = v.Length();
 	}
 
+	//NOTE:  a tetrahedron too ill-conditioned to resolve can also
+	//look like it contains the origin, and an old simplex is more
+	//likely to be ill-conditioned, so let a cold start decide
+	//whether the objects really touch
+	if( bWarm && d<=eps )
+	{
+		pCache->m_Count = 0;
+		return gjk_closest_points( a, b, sA, sB, pCache, eps );
+	}
+
+	//remember the simplex for the next query
+	if( pCache )
+	{
+		for( int32 i=0 ; i<N ; i++ )
+			pCache->m_Dir[i] = dir[i];
+
+		pCache->m_Count = N;
+		pCache->m_Iterations = iter;
+	}
+
 	//set a and b to 0
 	a.Init();
 	b.Init();
@@ -377,4 +480,93 @@ float GJK_ClosestPoints
 	return d;
 }
 
+
+//---------------------------------------------------------------------------//
+float GJK_ClosestPoints
+(
+	LTVector3f& a,
+	LTVector3f& b,
+	ILTSupportMap& sA,
+	ILTSupportMap& sB,
+	const float eps
+)
+{
+	return gjk_closest_points( a, b, sA, sB, (LTGJKCache*)NULL, eps );
+}
+
+
+//---------------------------------------------------------------------------//
+float GJK_ClosestPoints
+(
+	LTVector3f& a,
+	LTVector3f& b,
+	ILTSupportMap& sA,
+	ILTSupportMap& sB,
+	LTGJKCache* pCache,
+	const float eps
+)
+{
+	return gjk_closest_points( a, b, sA, sB, pCache, eps );
+}
+
+
+//---------------------------------------------------------------------------//
+float GJK_ClosestPoints
+(
+	LTVector3f& a,
+	LTVector3f& b,
+	LTSphereSupportMap& sA,
+	LTCylinderSupportMap& sB,
+	LTGJKCache* pCache,
+	const float eps
+)
+{
+	return gjk_closest_points( a, b, sA, sB, pCache, eps );
+}
+
+
+//---------------------------------------------------------------------------//
+float GJK_ClosestPoints
+(
+	LTVector3f& a,
+	LTVector3f& b,
+	LTCylinderSupportMap& sA,
+	LTBoxSupportMap& sB,
+	LTGJKCache* pCache,
+	const float eps
+)
+{
+	return gjk_closest_points( a, b, sA, sB, pCache, eps );
+}
+
+
+//---------------------------------------------------------------------------//
+float GJK_ClosestPoints
+(
+	LTVector3f& a,
+	LTVector3f& b,
+	LTCylinderSupportMap& sA,
+	LTCylinderSupportMap& sB,
+	LTGJKCache* pCache,
+	const float eps
+)
+{
+	return gjk_closest_points( a, b, sA, sB, pCache, eps );
+}
+
+
+//---------------------------------------------------------------------------//
+float GJK_ClosestPoints
+(
+	LTVector3f& a,
+	LTVector3f& b,
+	LTBoxSupportMap& sA,
+	LTBoxSupportMap& sB,
+	LTGJKCache* pCache,
+	const float eps
+)
+{
+	return gjk_closest_points( a, b, sA, sB, pCache, eps );
+}
+
 //EOF
@@ -40,6 +40,8 @@ LTCollisionMgr::~LTCollisionMgr()
 //---------------------------------------------------------------------------//
 void LTCollisionMgr::Term()
 {
+	m_GJKCache.Clear();
+
 	//delete any left over collision objects allocated by
 	//the engine, such as world models and static geometry
 	ObjectList::iterator i;
@@ -232,6 +234,10 @@ void LTCollisionMgr::Add( ILTCollisionObject* o )
 	assert( o );
 #endif
 
+	//NOTE:  the cache pointer is kept when the object is removed,
+	//Collide() and Intersect() take the object out while testing it
+	o->m_pGJKCache = &m_GJKCache;
+
 	m_Objects.push_back( o );
 }
 
@@ -31,6 +31,9 @@ public:
     //A list of abstract collision objects
     ObjectList m_Objects;
 
+    //GJK simplices of object pairs, for warm starting
+    LTGJKPairCache m_GJKCache;
+
 public:
 
     LTCollisionMgr()
@@ -335,7 +335,8 @@ bool OBBClosestPoints
 	const LTCoordinateFrameQ&	A,
 	const LTVector3f&			da,
 	const LTCoordinateFrameQ&	B,
-	const LTVector3f&			db
+	const LTVector3f&			db,
+	LTGJKCache*					pCache
 )
 {
 		//if A and B intersect, then a and b cannot be found
@@ -346,7 +347,7 @@ bool OBBClosestPoints
 	LTBoxSupportMap Sa( A.m_O, A, da );
 	LTBoxSupportMap Sb( B.m_O, B, db );
 
-		GJK_ClosestPoints( a, b, Sa, Sb );
+		GJK_ClosestPoints( a, b, Sa, Sb, pCache );
 
 	return true;
 }
@@ -364,7 +365,8 @@ bool OBBSweep
 	const LTVector3f&			da,	//half-dimensions of A
 	const LTCoordinateFrameQ&	B0,	//first position/orientation of B
 	const LTCoordinateFrameQ&	B1,	//second position/orientation of B
-	const LTVector3f&			db	//half-dimensions of B
+	const LTVector3f&			db,	//half-dimensions of B
+	LTGJKCache*					pCache	//GJK simplex of the last query
 )
 {
 	//ALGORITHM:  If A and B intersect at time t1, find the closest points
@@ -377,7 +379,7 @@ bool OBBSweep
 		return false;
 
 	//find the closest points between A and B
-	if( !OBBClosestPoints(a,b,A0,da,B0,db) )
+	if( !OBBClosestPoints(a,b,A0,da,B0,db,pCache) )
 		return false;
 
 	u = 0;//for now, this is always true
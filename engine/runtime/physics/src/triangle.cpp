@@ -1,4 +1,5 @@
 #include "triangle.h"
+#include "ltmem.h"
 #include "math_phys.h"
 
 
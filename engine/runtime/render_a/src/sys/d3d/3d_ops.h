@@ -18,15 +18,6 @@
 
 #define CLIP_EPSILON	0.00001f
 
-#define CPLANE_NEAR_INDEX		0
-#define CPLANE_FAR_INDEX		1
-#define CPLANE_LEFT_INDEX		2
-#define CPLANE_TOP_INDEX		3
-#define CPLANE_RIGHT_INDEX		4
-#define CPLANE_BOTTOM_INDEX		5
-
-#define NUM_CLIPPLANES			6
-
 // Near Z is always this.
 #define NEARZ			7.0f
 #define MAX_FARZ		500000.0f
@@ -1,5 +1,5 @@
 
-#include "precompile.h"
+#include "bdefs.h"
 
 #include "aabb.h"
 
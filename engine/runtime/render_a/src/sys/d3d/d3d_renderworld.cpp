@@ -32,6 +32,8 @@ CD3D_RenderWorld::CD3D_RenderWorld() :
 	m_nOccludeCollectTime(0),
 	m_bBlocksDirty(true)
 {
+	memset(&m_sOcclusionCompare, 0, sizeof(m_sOcclusionCompare));
+
 	for (uint32 nShaderLoop = 0; nShaderLoop < k_eShader_Num + 2; ++nShaderLoop)
 		m_aShaders[nShaderLoop] = 0;
 }
@@ -186,11 +188,14 @@ void CD3D_RenderWorld::GetRBChildrenSorted(const ViewParams& Params, CD3D_Render
 	}
 }
 
-void CD3D_RenderWorld::GetFrustumRBList(const ViewParams& Params, TRBList &cList)
+void CD3D_RenderWorld::GetFrustumRBList(const ViewParams& Params, TRBList &cList, bool bUseOcclusionBuffer)
 {
 	typedef std::stack<CD3D_RenderBlock*> TRBQueue;
 	static TRBQueue cRBQueue;
 
+	// Only use the buffer if it was built for this view
+	bUseOcclusionBuffer = bUseOcclusionBuffer && m_cOcclusionBuffer.IsValid(Params);
+
 	cRBQueue.push(m_pRenderBlocks);
 	while (!cRBQueue.empty())
 	{
@@ -198,6 +203,8 @@ void CD3D_RenderWorld::GetFrustumRBList(const ViewParams& Params, TRBList &cList
 		cRBQueue.pop();
 		if (!Params.ViewAABBIntersect(pCurBlock->GetBoundsMin(), pCurBlock->GetBoundsMax()))
 			continue;
+		if (bUseOcclusionBuffer && m_cOcclusionBuffer.IsAABBOccluded(pCurBlock->GetBoundsMin(), pCurBlock->GetBoundsMax()))
+			continue;
 		cList.push_back(pCurBlock);
 		CD3D_RenderBlock *pChild1, *pChild2;
 		GetRBChildrenSorted(Params, pCurBlock, pChild1, pChild2);
@@ -247,6 +254,8 @@ void CD3D_RenderWorld::StartFrame(const ViewParams& Params)
 {
 	m_aOccluderOutlines.clear();
 	m_nOccludeCollectTime = 0;
+	m_cOcclusionBuffer.Term();
+	memset(&m_sOcclusionCompare, 0, sizeof(m_sOcclusionCompare));
 
 	// Don't do any occluder stuff if we're fiddling with console variables
 	if (g_CV_DebugRBAll.m_Val || g_CV_DebugRBCur.m_Val || g_CV_DebugRBFrustum.m_Val)
@@ -279,6 +288,10 @@ void CD3D_RenderWorld::GetFrameOccluders(const ViewParams& Params)
 
 	m_fFrameOccluders_ScreenArea = 0.0f;
 
+	bool bUseOcclusionBuffer = (g_CV_RBOcclusionBuffer.m_Val != 0) || (g_CV_DebugRBCompareOcclusion.m_Val != 0);
+	if (bUseOcclusionBuffer)
+		m_cOcclusionBuffer.Init(Params);
+
 	// Get the occluders from the RB's in the frustum
 	cRBQueue.push_back(m_pRenderBlocks);
 	while (!cRBQueue.empty())
@@ -326,9 +339,15 @@ void CD3D_RenderWorld::GetFrameOccluders(const ViewParams& Params)
 			COccluder_2D &cNewOccluder = m_aFrameOccluders.back();
 			cNewOccluder.InitOutline(Params, cOccludee.m_aVisible[0], sOccluderPoly.m_cPlane);
 			m_fFrameOccluders_ScreenArea += cNewOccluder.m_fScreenArea;
+
+			if (bUseOcclusionBuffer)
+				m_cOcclusionBuffer.AddOccluder(cOccludee.m_aVisible[0]);
 		}
 	}
 
+	if (bUseOcclusionBuffer)
+		m_cOcclusionBuffer.Finish();
+
 	// Sort the occluders by screen area
 	if (g_CV_DebugRBSortOccluders.m_Val && (m_aFrameOccluders.size() > 1))
 	{
@@ -362,10 +381,6 @@ bool CD3D_RenderWorld::IsAABBVisible(const ViewParams& Params, const LTVector &v
 		return true;
 	}
 
-	// Use a static occludee
-	static COccludee cOccludee;
-	cOccludee.Init();
-
 	PolySide nBoxSide = m_cFrameFrustumOccluder.ClassifyAABB(vMin, vMax, Params.m_FarZ);
 	if (nBoxSide == BackSide)
 	{
@@ -377,6 +392,48 @@ bool CD3D_RenderWorld::IsAABBVisible(const ViewParams& Params, const LTVector &v
 	if (!bUseOccluders || m_aFrameOccluders.empty())
 		return true;
 
+	bool bVisible;
+
+	if (!m_cOcclusionBuffer.IsValid(Params))
+	{
+		bVisible = IsAABBVisible_Clip(Params, vMin, vMax, nBoxSide);
+	}
+	else if (g_CV_DebugRBCompareOcclusion.m_Val)
+	{
+		// Run both paths and keep score, using the clipping result
+		bool bBufferVisible;
+		{
+			CountAdder cBufferTime(&m_sOcclusionCompare.m_nBufferTime);
+			bBufferVisible = !m_cOcclusionBuffer.IsAABBOccluded(vMin, vMax);
+		}
+		{
+			CountAdder cClipTime(&m_sOcclusionCompare.m_nClipTime);
+			bVisible = IsAABBVisible_Clip(Params, vMin, vMax, nBoxSide);
+		}
+
+		++m_sOcclusionCompare.m_nTested;
+		m_sOcclusionCompare.m_nClipCulled += bVisible ? 0 : 1;
+		m_sOcclusionCompare.m_nBufferCulled += bBufferVisible ? 0 : 1;
+		m_sOcclusionCompare.m_nClipOnly += (!bVisible && bBufferVisible) ? 1 : 0;
+		m_sOcclusionCompare.m_nBufferOnly += (bVisible && !bBufferVisible) ? 1 : 0;
+	}
+	else
+	{
+		bVisible = !m_cOcclusionBuffer.IsAABBOccluded(vMin, vMax);
+	}
+
+	if(!bVisible)
+		IncFrameStat(eFS_OccluderCulledCount, 1);	
+
+	return bVisible;
+}
+
+bool CD3D_RenderWorld::IsAABBVisible_Clip(const ViewParams& Params, const LTVector &vMin, const LTVector &vMax, PolySide nBoxSide) const
+{
+	// Use a static occludee
+	static COccludee cOccludee;
+	cOccludee.Init();
+
 	cOccludee.InitAABB(Params, vMin, vMax, true);
 	if (nBoxSide == Intersect)
 	{
@@ -427,9 +484,6 @@ bool CD3D_RenderWorld::IsAABBVisible(const ViewParams& Params, const LTVector &v
 		ASSERT((nResult != FrontSide) || (cOccludee.m_aOccluded.empty()));
 	}
 
-	if(!bVisible)
-		IncFrameStat(eFS_OccluderCulledCount, 1);	
-
 	return bVisible;
 }
 
@@ -495,7 +549,8 @@ bool CD3D_RenderWorld::DrawAggregateShader(uint32 nNumFrustumPlanes, const LTPla
 	static TRBList aVisibleRBs;
 	aVisibleRBs.clear();
 
-	GetFrustumRBList(Params, aVisibleRBs);
+	// Blocks hidden from the camera can't show anything the aggregate draws
+	GetFrustumRBList(Params, aVisibleRBs, g_CV_RBOcclusionBuffer.m_Val != 0);
 
 	EAABBCorner *aCorners = (EAABBCorner*)alloca(nNumFrustumPlanes * sizeof(EAABBCorner));
 	for (uint32 nCurCorner = 0; nCurCorner < nNumFrustumPlanes; ++nCurCorner)
@@ -708,6 +763,16 @@ void CD3D_RenderWorld::Draw(const ViewParams& Params, bool bTransformed)
 	if (g_CV_DebugRBTime.m_Val)
 		dsi_ConsolePrint("RB Time - Collect : %d  Occlude : %d  Draw : %d", m_nOccludeCollectTime, nOccludeTime, nDrawTime);
 
+	if (g_CV_DebugRBCompareOcclusion.m_Val && !bTransformed)
+	{
+		const SOcclusionCompare &sCompare = m_sOcclusionCompare;
+		dsi_ConsolePrint("RB Occlusion - Tested : %d  Clip : %d culled, %d ticks  Buffer : %d culled, %d ticks (%d occluders)  Clip only : %d  Buffer only : %d",
+			sCompare.m_nTested,
+			sCompare.m_nClipCulled, sCompare.m_nClipTime,
+			sCompare.m_nBufferCulled, sCompare.m_nBufferTime, m_cOcclusionBuffer.GetNumOccluders(),
+			sCompare.m_nClipOnly, sCompare.m_nBufferOnly);
+	}
+
 	if (g_CV_ShowMemStats_Render.m_Val)
 	{
 		if (!bTransformed)
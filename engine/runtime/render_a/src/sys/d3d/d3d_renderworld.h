@@ -8,6 +8,7 @@ class CD3D_RenderBlock;
 class ViewParams;
 
 #include "d3d_renderworld_occluder.h"
+#include "d3d_renderworld_occlusionbuffer.h"
 #include "erendershader.h"
 #include "memstats_world.h"
 
@@ -84,7 +85,8 @@ private:
 private:
 	void DebugTri(const ViewParams& pParams);
 
-	void GetFrustumRBList(const ViewParams& pParams, TRBList &cList);
+	// Set bUseOcclusionBuffer to also skip the blocks hidden by this frame's occlusion buffer
+	void GetFrustumRBList(const ViewParams& pParams, TRBList &cList, bool bUseOcclusionBuffer = false);
 
 	void DrawOccluder(const COccludee::COutline &cOutline);
 	
@@ -93,6 +95,9 @@ private:
 	// Build the occluder list for the current frame
 	void GetFrameOccluders(const ViewParams& pParams);
 
+	// Occlusion test by clipping the box outline against each of the frame occluders
+	bool IsAABBVisible_Clip(const ViewParams& pParams, const LTVector &vMin, const LTVector &vMax, PolySide nBoxSide) const;
+
 	// Get a worldmodel name hash ID
 	uint32 GetWMNameHash(const char *pName);
 
@@ -113,6 +118,20 @@ private:
 	// Track how long it took to build the occluder list
 	uint32 m_nOccludeCollectTime;
 
+	// Depth buffer of the frame occluders
+	COcclusionBuffer m_cOcclusionBuffer;
+
+	// Occlusion path comparison for the current frame (DebugRBCompareOcclusion)
+	struct SOcclusionCompare
+	{
+		uint32 m_nTested;
+		uint32 m_nClipCulled, m_nClipTime;
+		uint32 m_nBufferCulled, m_nBufferTime;
+		// Culled by one path but not the other
+		uint32 m_nClipOnly, m_nBufferOnly;
+	};
+	mutable SOcclusionCompare m_sOcclusionCompare;
+
 	bool m_bBlocksDirty;
 
 	// Our list of shaders (Plus extra space for the invalid ID/ number constant)
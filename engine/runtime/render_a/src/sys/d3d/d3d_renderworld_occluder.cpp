@@ -1,7 +1,8 @@
 //////////////////////////////////////////////////////////////////////////////
 // Render world occluder/occludee implementation
 
-#include "precompile.h"
+// No Direct3D in here, the occlusion tests build it on its own
+#include "bdefs.h"
 
 #include "d3d_renderworld_occluder.h"
 
@@ -12,8 +13,6 @@
 
 #include "rendererconsolevars.h"
 
-#include "3d_ops.h"
-
 #include <algorithm>
 
 //////////////////////////////////////////////////////////////////////////////
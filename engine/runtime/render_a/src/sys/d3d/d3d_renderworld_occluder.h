@@ -7,6 +7,8 @@
 #include "aabb.h"
 #include <vector.h>
 
+#include <vector>
+
 struct SRBGeometryPoly;
 class ViewParams;
 
@@ -32,6 +34,9 @@ public:
 		friend iterator;
 		friend const_iterator;
 	public:
+		// Most vertices an outline can hold
+		static const int k_MaxVerts = 32;
+
 		COutline() : m_pEndVert(m_aVerts) {}
 		COutline(const COutline &cOther) : 
 			m_pEndVert(iterator(m_aVerts) + cOther.size())
@@ -116,8 +121,7 @@ public:
 		float CalcArea() const;
 		float CalcArea2D() const;
 	private:
-		enum { k_MaxVerts = 32 };
-		enum { k_nDataStride = 3 };
+		static const int k_nDataStride = 3;
 		float m_aVerts[k_MaxVerts * k_nDataStride];
 		iterator m_pEndVert;
 	};
@@ -0,0 +1,349 @@
+//////////////////////////////////////////////////////////////////////////////
+// Render world software occlusion buffer implementation
+
+// Doesn't touch Direct3D, so it only needs the engine types and builds outside the renderer too
+#include "bdefs.h"
+
+#include "d3d_renderworld_occlusionbuffer.h"
+#include "d3d_viewparams.h"
+
+#include <float.h>
+#include <math.h>
+#include <string.h>
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define OCCLUSIONBUFFER_SSE2
+#include <emmintrin.h>
+#endif
+
+// Points closer to the eye plane than this can't be projected reliably
+static const float k_fMinW = 0.0001f;
+
+// Occluder depths are pushed back by this fraction to absorb the rounding in the depth plane
+static const float k_fOccluderDepthBias = 1.0f - 0.0001f;
+
+// How far past the pixel corners an edge has to be for the pixel to count as covered, in pixels
+static const float k_fEdgeEpsilon = 0.01f;
+
+COcclusionBuffer::COcclusionBuffer() :
+	m_nNumOccluders(0),
+	m_bValid(false)
+{
+}
+
+void COcclusionBuffer::Init(const ViewParams& Params)
+{
+	m_bValid = false;
+	m_nNumOccluders = 0;
+
+	if ((Params.m_fScreenWidth <= 0.0f) || (Params.m_fScreenHeight <= 0.0f))
+		return;
+
+	LT_MEM_TRACK_ALLOC(m_aDepth.resize(k_nWidth * k_nHeight), LT_MEM_TYPE_RENDERER);
+	LT_MEM_TRACK_ALLOC(m_aTileDepth.resize(k_nTilesX * k_nTilesY), LT_MEM_TYPE_RENDERER);
+
+	memset(&m_aDepth[0], 0, sizeof(float) * m_aDepth.size());
+	memset(&m_aTileDepth[0], 0, sizeof(float) * m_aTileDepth.size());
+
+	m_mFullTransform = Params.m_FullTransform;
+
+	// Fold the screen to buffer scale into the transform
+	// x' = (x / w - left) * fScaleX = (row0 - left * row3) * fScaleX / w
+	float fScaleX = (float)k_nWidth / Params.m_fScreenWidth;
+	float fScaleY = (float)k_nHeight / Params.m_fScreenHeight;
+	float fLeft = (float)Params.m_Rect.left;
+	float fTop = (float)Params.m_Rect.top;
+
+	m_mTransform = m_mFullTransform;
+	for (uint32 nCol = 0; nCol < 4; ++nCol)
+	{
+		m_mTransform.m[0][nCol] = (m_mFullTransform.m[0][nCol] - fLeft * m_mFullTransform.m[3][nCol]) * fScaleX;
+		m_mTransform.m[1][nCol] = (m_mFullTransform.m[1][nCol] - fTop * m_mFullTransform.m[3][nCol]) * fScaleY;
+	}
+
+	m_bValid = true;
+}
+
+bool COcclusionBuffer::IsValid(const ViewParams& Params) const
+{
+	return m_bValid && (memcmp(m_mFullTransform.m, Params.m_FullTransform.m, sizeof(m_mFullTransform.m)) == 0);
+}
+
+bool COcclusionBuffer::TransformPt(const LTVector &vPt, float *pX, float *pY, float *pInvW) const
+{
+	const LTMatrix &mTrans = m_mTransform;
+
+	float fW = mTrans.m[3][0] * vPt.x + mTrans.m[3][1] * vPt.y + mTrans.m[3][2] * vPt.z + mTrans.m[3][3];
+	if (fW < k_fMinW)
+		return false;
+
+	float fInvW = 1.0f / fW;
+	*pX = (mTrans.m[0][0] * vPt.x + mTrans.m[0][1] * vPt.y + mTrans.m[0][2] * vPt.z + mTrans.m[0][3]) * fInvW;
+	*pY = (mTrans.m[1][0] * vPt.x + mTrans.m[1][1] * vPt.y + mTrans.m[1][2] * vPt.z + mTrans.m[1][3]) * fInvW;
+	*pInvW = fInvW;
+
+	return true;
+}
+
+void COcclusionBuffer::FillSpan(int32 nY, int32 nMinX, int32 nMaxX, float fDepth0, float fDepthX, float fMinDepth)
+{
+	float *pRow = &m_aDepth[nY * k_nWidth];
+	int32 nX = nMinX;
+
+#ifdef OCCLUSIONBUFFER_SSE2
+	__m128 vDepth0 = _mm_set1_ps(fDepth0);
+	__m128 vDepthX = _mm_set1_ps(fDepthX);
+	__m128 vMinDepth = _mm_set1_ps(fMinDepth);
+	__m128 vX = _mm_setr_ps((float)nX, (float)(nX + 1), (float)(nX + 2), (float)(nX + 3));
+	__m128 vFour = _mm_set1_ps(4.0f);
+
+	for (; (nX + 3) <= nMaxX; nX += 4)
+	{
+		__m128 vDepth = _mm_max_ps(_mm_add_ps(vDepth0, _mm_mul_ps(vDepthX, vX)), vMinDepth);
+		_mm_storeu_ps(&pRow[nX], _mm_max_ps(_mm_loadu_ps(&pRow[nX]), vDepth));
+		vX = _mm_add_ps(vX, vFour);
+	}
+#endif // OCCLUSIONBUFFER_SSE2
+
+	for (; nX <= nMaxX; ++nX)
+	{
+		float fDepth = LTMAX(fDepth0 + fDepthX * (float)nX, fMinDepth);
+		pRow[nX] = LTMAX(pRow[nX], fDepth);
+	}
+}
+
+void COcclusionBuffer::AddOccluder(const COccludee::COutline &cOutline)
+{
+	if (!m_bValid)
+		return;
+
+	uint32 nNumVerts = cOutline.size();
+	if (nNumVerts < 3)
+		return;
+
+	const uint32 k_nMaxVerts = COccludee::COutline::k_MaxVerts;
+	ASSERT(nNumVerts <= k_nMaxVerts);
+
+	float aX[k_nMaxVerts], aY[k_nMaxVerts], aInvW[k_nMaxVerts];
+
+	float fMinX = FLT_MAX, fMinY = FLT_MAX, fMaxX = -FLT_MAX, fMaxY = -FLT_MAX;
+	float fMinInvW = FLT_MAX;
+
+	for (uint32 nCurVert = 0; nCurVert < nNumVerts; ++nCurVert)
+	{
+		// Don't try to draw anything that touches the eye plane
+		if (!TransformPt(cOutline[nCurVert], &aX[nCurVert], &aY[nCurVert], &aInvW[nCurVert]))
+			return;
+
+		fMinX = LTMIN(fMinX, aX[nCurVert]);
+		fMinY = LTMIN(fMinY, aY[nCurVert]);
+		fMaxX = LTMAX(fMaxX, aX[nCurVert]);
+		fMaxY = LTMAX(fMaxY, aY[nCurVert]);
+		fMinInvW = LTMIN(fMinInvW, aInvW[nCurVert]);
+	}
+
+	// Get the winding, and the biggest fan triangle to build the depth plane from
+	float fArea = 0.0f;
+	float fBestArea = 0.0f;
+	uint32 nBestVert = 1;
+	for (uint32 nAreaLoop = 1; (nAreaLoop + 1) < nNumVerts; ++nAreaLoop)
+	{
+		float fTriArea =
+			(aX[nAreaLoop] - aX[0]) * (aY[nAreaLoop + 1] - aY[0]) -
+			(aX[nAreaLoop + 1] - aX[0]) * (aY[nAreaLoop] - aY[0]);
+		fArea += fTriArea;
+		if (fabsf(fTriArea) > fabsf(fBestArea))
+		{
+			fBestArea = fTriArea;
+			nBestVert = nAreaLoop;
+		}
+	}
+
+	// Skip anything edge-on or too small to cover a pixel
+	if ((fabsf(fArea) < 2.0f) || (fMaxX < 0.0f) || (fMaxY < 0.0f) || (fMinX > (float)k_nWidth) || (fMinY > (float)k_nHeight))
+		return;
+
+	float fOrient = (fArea > 0.0f) ? 1.0f : -1.0f;
+
+	// 1/w is linear in screen space, so solve for its gradient on the best triangle
+	float fDX1 = aX[nBestVert] - aX[0];
+	float fDY1 = aY[nBestVert] - aY[0];
+	float fDX2 = aX[nBestVert + 1] - aX[0];
+	float fDY2 = aY[nBestVert + 1] - aY[0];
+	float fDI1 = aInvW[nBestVert] - aInvW[0];
+	float fDI2 = aInvW[nBestVert + 1] - aInvW[0];
+	float fInvDet = 1.0f / fBestArea;
+	float fDepthX = (fDI1 * fDY2 - fDI2 * fDY1) * fInvDet;
+	float fDepthY = (fDX1 * fDI2 - fDX2 * fDI1) * fInvDet;
+
+	// Depth at the center of pixel (0, 0), moved to the farthest corner of the pixel,
+	// and pushed back a little.  The polygon's farthest vertex bounds it from below,
+	// since only pixels completely inside the polygon get written.
+	float fDepthOrigin = aInvW[0] + fDepthX * (0.5f - aX[0]) + fDepthY * (0.5f - aY[0]);
+	fDepthOrigin -= 0.5f * (fabsf(fDepthX) + fabsf(fDepthY));
+	fDepthOrigin *= k_fOccluderDepthBias;
+	fDepthX *= k_fOccluderDepthBias;
+	fDepthY *= k_fOccluderDepthBias;
+	fMinInvW *= k_fOccluderDepthBias;
+
+	// Edge equations E(x, y) = A * x + B * y + C, positive inside.  A pixel is covered if
+	// E at its center is more than half its extent along the edge normal inside every edge.
+	float aEdgeA[k_nMaxVerts], aEdgeB[k_nMaxVerts], aEdgeC[k_nMaxVerts];
+	uint32 nNumEdges = 0;
+
+	uint32 nPrevVert = nNumVerts - 1;
+	for (uint32 nCurVert = 0; nCurVert < nNumVerts; nPrevVert = nCurVert++)
+	{
+		float fEdgeX = aX[nCurVert] - aX[nPrevVert];
+		float fEdgeY = aY[nCurVert] - aY[nPrevVert];
+		float fA = -fOrient * fEdgeY;
+		float fB = fOrient * fEdgeX;
+		float fExtent = fabsf(fA) + fabsf(fB);
+		if (fExtent < 0.0001f)
+			continue;
+
+		aEdgeA[nNumEdges] = fA;
+		aEdgeB[nNumEdges] = fB;
+		aEdgeC[nNumEdges] = -(fA * aX[nPrevVert] + fB * aY[nPrevVert]) - (0.5f + k_fEdgeEpsilon) * fExtent;
+		++nNumEdges;
+	}
+
+	// Note : Clamp before converting, the vertices can project a long way off-screen
+	int32 nMinY = (int32)LTMAX(floorf(fMinY), 0.0f);
+	int32 nMaxY = (int32)LTMIN(ceilf(fMaxY), (float)k_nHeight) - 1;
+	int32 nBoundsMinX = (int32)LTMAX(floorf(fMinX), 0.0f);
+	int32 nBoundsMaxX = (int32)LTMIN(ceilf(fMaxX), (float)k_nWidth) - 1;
+
+	for (int32 nY = nMinY; nY <= nMaxY; ++nY)
+	{
+		float fCenterY = (float)nY + 0.5f;
+
+		// Intersect the edge half-planes with this row
+		float fSpanMinX = (float)nBoundsMinX;
+		float fSpanMaxX = (float)nBoundsMaxX;
+		for (uint32 nCurEdge = 0; nCurEdge < nNumEdges; ++nCurEdge)
+		{
+			float fA = aEdgeA[nCurEdge];
+			float fRowC = aEdgeB[nCurEdge] * fCenterY + aEdgeC[nCurEdge];
+			if (fA > 0.0f)
+				fSpanMinX = LTMAX(fSpanMinX, ceilf(-fRowC / fA - 0.5f));
+			else if (fA < 0.0f)
+				fSpanMaxX = LTMIN(fSpanMaxX, floorf(-fRowC / fA - 0.5f));
+			else if (fRowC < 0.0f)
+				fSpanMaxX = -1.0f;
+
+			if (fSpanMinX > fSpanMaxX)
+				break;
+		}
+
+		if (fSpanMinX > fSpanMaxX)
+			continue;
+
+		FillSpan(nY, (int32)fSpanMinX, (int32)fSpanMaxX, fDepthOrigin + fDepthY * (float)nY, fDepthX, fMinInvW);
+	}
+
+	++m_nNumOccluders;
+}
+
+void COcclusionBuffer::Finish()
+{
+	if (!m_bValid)
+		return;
+
+	float *pTileDepth = &m_aTileDepth[0];
+
+	for (uint32 nTileY = 0; nTileY < k_nTilesY; ++nTileY)
+	{
+		for (uint32 nTileX = 0; nTileX < k_nTilesX; ++nTileX, ++pTileDepth)
+		{
+			const float *pRow = &m_aDepth[(nTileY * k_nTileSize) * k_nWidth + nTileX * k_nTileSize];
+
+#ifdef OCCLUSIONBUFFER_SSE2
+			__m128 vMin = _mm_min_ps(_mm_loadu_ps(pRow), _mm_loadu_ps(pRow + 4));
+			for (uint32 nRow = 1; nRow < k_nTileSize; ++nRow)
+			{
+				pRow += k_nWidth;
+				vMin = _mm_min_ps(vMin, _mm_min_ps(_mm_loadu_ps(pRow), _mm_loadu_ps(pRow + 4)));
+			}
+			vMin = _mm_min_ps(vMin, _mm_shuffle_ps(vMin, vMin, _MM_SHUFFLE(1, 0, 3, 2)));
+			vMin = _mm_min_ps(vMin, _mm_shuffle_ps(vMin, vMin, _MM_SHUFFLE(2, 3, 0, 1)));
+			*pTileDepth = _mm_cvtss_f32(vMin);
+#else
+			float fMin = pRow[0];
+			for (uint32 nRow = 0; nRow < k_nTileSize; ++nRow, pRow += k_nWidth)
+			{
+				for (uint32 nCol = 0; nCol < k_nTileSize; ++nCol)
+					fMin = LTMIN(fMin, pRow[nCol]);
+			}
+			*pTileDepth = fMin;
+#endif // OCCLUSIONBUFFER_SSE2
+		}
+	}
+}
+
+bool COcclusionBuffer::IsAABBOccluded(const LTVector &vMin, const LTVector &vMax) const
+{
+	if (!m_bValid || !m_nNumOccluders)
+		return false;
+
+	// Get the screen bounds and the nearest depth of the corners
+	float fMinX = FLT_MAX, fMinY = FLT_MAX, fMaxX = -FLT_MAX, fMaxY = -FLT_MAX;
+	float fMaxInvW = 0.0f;
+
+	for (uint32 nCorner = 0; nCorner < 8; ++nCorner)
+	{
+		LTVector vCorner(
+			(nCorner & 1) ? vMax.x : vMin.x,
+			(nCorner & 2) ? vMax.y : vMin.y,
+			(nCorner & 4) ? vMax.z : vMin.z);
+
+		float fX, fY, fInvW;
+		if (!TransformPt(vCorner, &fX, &fY, &fInvW))
+			return false;
+
+		fMinX = LTMIN(fMinX, fX);
+		fMinY = LTMIN(fMinY, fY);
+		fMaxX = LTMAX(fMaxX, fX);
+		fMaxY = LTMAX(fMaxY, fY);
+		fMaxInvW = LTMAX(fMaxInvW, fInvW);
+	}
+
+	// Off-screen boxes are the frustum's problem
+	if ((fMaxX < 0.0f) || (fMaxY < 0.0f) || (fMinX > (float)k_nWidth) || (fMinY > (float)k_nHeight))
+		return false;
+
+	// Every pixel the rectangle touches
+	int32 nMinX = (int32)LTMAX(floorf(fMinX), 0.0f);
+	int32 nMinY = (int32)LTMAX(floorf(fMinY), 0.0f);
+	int32 nMaxX = (int32)LTMIN(ceilf(fMaxX), (float)k_nWidth) - 1;
+	int32 nMaxY = (int32)LTMIN(ceilf(fMaxY), (float)k_nHeight) - 1;
+	if ((nMinX > nMaxX) || (nMinY > nMaxY))
+		return false;
+
+	for (int32 nTileY = nMinY / k_nTileSize; nTileY <= nMaxY / k_nTileSize; ++nTileY)
+	{
+		for (int32 nTileX = nMinX / k_nTileSize; nTileX <= nMaxX / k_nTileSize; ++nTileX)
+		{
+			// The whole tile is in front of the box
+			if (m_aTileDepth[nTileY * k_nTilesX + nTileX] > fMaxInvW)
+				continue;
+
+			int32 nPixelMinX = LTMAX(nMinX, nTileX * (int32)k_nTileSize);
+			int32 nPixelMaxX = LTMIN(nMaxX, nTileX * (int32)k_nTileSize + (int32)k_nTileSize - 1);
+			int32 nPixelMinY = LTMAX(nMinY, nTileY * (int32)k_nTileSize);
+			int32 nPixelMaxY = LTMIN(nMaxY, nTileY * (int32)k_nTileSize + (int32)k_nTileSize - 1);
+
+			for (int32 nY = nPixelMinY; nY <= nPixelMaxY; ++nY)
+			{
+				const float *pRow = &m_aDepth[nY * k_nWidth];
+				for (int32 nX = nPixelMinX; nX <= nPixelMaxX; ++nX)
+				{
+					if (pRow[nX] <= fMaxInvW)
+						return false;
+				}
+			}
+		}
+	}
+
+	return true;
+}
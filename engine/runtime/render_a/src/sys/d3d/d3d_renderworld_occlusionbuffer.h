@@ -0,0 +1,80 @@
+//////////////////////////////////////////////////////////////////////////////
+// Render world software occlusion buffer
+
+#ifndef __D3D_RENDERWORLD_OCCLUSIONBUFFER_H__
+#define __D3D_RENDERWORLD_OCCLUSIONBUFFER_H__
+
+#include "d3d_renderworld_occluder.h"
+
+#include <vector>
+
+class ViewParams;
+
+// Low-resolution depth buffer of the frame occluders, used in place of clipping
+// every occludee against every occluder.
+//
+// Depth is stored as 1/w (larger is nearer, 0 is empty), which is linear in screen space.
+// Both sides of the test are conservative: an occluder only covers the pixels that are
+// completely inside it, at the farthest depth it has within each pixel, and a box is tested
+// over every pixel it touches at the nearest depth of its corners.  So a box is only
+// reported as occluded if the clipping path would have found it occluded as well.
+//
+// Only depends on the view transform, so it can be driven from recorded view parameters.
+class COcclusionBuffer
+{
+public:
+	static const int k_nWidth = 256;
+	static const int k_nHeight = 128;
+
+	// Hierarchical-Z tile size, in pixels
+	static const int k_nTileSize = 8;
+	static const int k_nTilesX = k_nWidth / k_nTileSize;
+	static const int k_nTilesY = k_nHeight / k_nTileSize;
+
+	COcclusionBuffer();
+
+	// Clear the buffer and set it up for the given view
+	void Init(const ViewParams& Params);
+
+	// Forget the current frame; IsValid will fail until the next Init
+	void Term() { m_bValid = false; }
+
+	// Rasterize a convex occluder outline in world space.
+	// The outline must have been clipped to the near plane.
+	void AddOccluder(const COccludee::COutline &cOutline);
+
+	// Build the hierarchical-Z after the last occluder has been added
+	void Finish();
+
+	// Was the buffer built for this view?
+	bool IsValid(const ViewParams& Params) const;
+
+	// Is the world-space box entirely behind the occluders?
+	bool IsAABBOccluded(const LTVector &vMin, const LTVector &vMax) const;
+
+	uint32 GetNumOccluders() const { return m_nNumOccluders; }
+
+private:
+	// Write the depth plane into the pixels [nMinX, nMaxX] of row nY, keeping the nearest depth
+	void FillSpan(int32 nY, int32 nMinX, int32 nMaxX, float fDepth0, float fDepthX, float fMinDepth);
+
+	// Transform a point into buffer space.  Returns false if it's behind the eye.
+	bool TransformPt(const LTVector &vPt, float *pX, float *pY, float *pInvW) const;
+
+private:
+	// The view transform the buffer was built for
+	LTMatrix m_mFullTransform;
+	// World to buffer space transform
+	LTMatrix m_mTransform;
+
+	// 1/w of the nearest occluder for each pixel
+	// Note : These are only allocated on the first Init, since every worldmodel has a render world
+	std::vector<float> m_aDepth;
+	// Farthest (smallest) 1/w in each tile
+	std::vector<float> m_aTileDepth;
+
+	uint32 m_nNumOccluders;
+	bool m_bValid;
+};
+
+#endif //__D3D_RENDERWORLD_OCCLUSIONBUFFER_H__
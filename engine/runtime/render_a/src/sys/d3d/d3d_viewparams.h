@@ -12,6 +12,14 @@
 
 #define NUM_CLIPPLANES	6
 
+// Indices into ViewParams::m_ClipPlanes
+#define CPLANE_NEAR_INDEX		0
+#define CPLANE_FAR_INDEX		1
+#define CPLANE_LEFT_INDEX		2
+#define CPLANE_TOP_INDEX		3
+#define CPLANE_RIGHT_INDEX		4
+#define CPLANE_BOTTOM_INDEX		5
+
 
 // This structure holds the info that is used to precalculate a bunch
 // of view frustum stuff.  All its member are specified in camera
@@ -0,0 +1,88 @@
+// d3dmeshrendobj_vablend.h
+//	Frame blending for the vertex animated meshes. No D3D in here, so the
+// blend can be built and timed outside the renderer.
+
+#ifndef __D3DMESHRENDOBJ_VABLEND_H__
+#define __D3DMESHRENDOBJ_VABLEND_H__
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define VA_SSE2
+#include <emmintrin.h>
+#endif
+
+
+class CDefVertexLst;
+
+// We keep a list of duplicated verts (UV sharing causes this). We minimize anim data this way, but they need to be recopied at the end, using this list...
+struct DupMap				{ uint16 iSrcVert;  uint16 iDstVert; };
+
+
+// pRes = pA + (pB - pA) * t over nCount floats...
+inline void va_LerpFloats(float* pRes, const float* pA, const float* pB, float t, uint32 nCount)
+{
+	uint32 i = 0;
+
+#ifdef VA_SSE2
+	__m128 vT = _mm_set1_ps(t);
+	for (; i + 4 <= nCount; i += 4)
+	{
+		__m128 vA = _mm_loadu_ps(&pA[i]);
+		__m128 vB = _mm_loadu_ps(&pB[i]);
+		_mm_storeu_ps(&pRes[i], _mm_add_ps(vA, _mm_mul_ps(_mm_sub_ps(vB, vA), vT)));
+	}
+#endif
+
+	for (; i < nCount; ++i)
+	{
+		pRes[i] = pA[i] + ((pB[i] - pA[i]) * t);
+	}
+}
+
+// Write a position into a locked VB. Only 12 bytes of each vertex are written, so plain stores: streaming
+// them leaves partial lines that flush one by one, and the VB is already write combined when it's in video memory...
+inline void va_WritePos(uint8* pDest, const float* pPos)
+{
+	float* pDstPos = (float*)pDest;
+	pDstPos[0] = pPos[0]; pDstPos[1] = pPos[1]; pDstPos[2] = pPos[2];
+}
+
+// Write the blended positions of the undup verts into a locked VB, then the dup verts from the same positions...
+inline void va_WriteVerts(uint8* pVertData, uint32 nVertexSize, const float* pBlendedVerts, uint32 nUnDupVertCount,
+	const DupMap* pDupMapList, uint32 nDupMapListCount)
+{
+	uint8* pCurVert = pVertData;
+	for (uint32 i = 0; i < nUnDupVertCount; ++i)
+	{
+		va_WritePos(pCurVert, &pBlendedVerts[i * 3]);
+		pCurVert += nVertexSize;
+	}
+
+	for (uint32 i = 0; i < nDupMapListCount; ++i)
+	{
+		assert(pDupMapList[i].iSrcVert < nUnDupVertCount);
+		va_WritePos(pVertData + ((uint32)pDupMapList[i].iDstVert * nVertexSize), &pBlendedVerts[(uint32)pDupMapList[i].iSrcVert * 3]);
+	}
+}
+
+// The frame pair and blend that's currently in a VB (other passes and instances in the same anim state can skip the update)...
+struct VABlendState
+{
+	VABlendState()			{ Clear(); }
+
+	void Clear()			{ m_pFrames[0] = NULL; m_pFrames[1] = NULL; m_fPercent = 0.0f; }
+
+	bool Matches(const CDefVertexLst* pFrame0, const CDefVertexLst* pFrame1, float fPercent) const
+	{
+		return (pFrame0 == m_pFrames[0]) && (pFrame1 == m_pFrames[1]) && (fPercent == m_fPercent);
+	}
+
+	void Set(const CDefVertexLst* pFrame0, const CDefVertexLst* pFrame1, float fPercent)
+	{
+		m_pFrames[0] = pFrame0; m_pFrames[1] = pFrame1; m_fPercent = fPercent;
+	}
+
+	const CDefVertexLst*	m_pFrames[2];
+	float					m_fPercent;
+};
+
+#endif
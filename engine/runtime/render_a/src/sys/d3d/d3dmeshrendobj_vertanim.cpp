@@ -3,6 +3,7 @@
 #include "precompile.h"
 
 #include "d3dmeshrendobj_vertanim.h"
+#include "d3dmeshrendobj_vablend.h"
 #include "model.h"
 #include "ltanimtracker.h"
 #include "renderstruct.h"
@@ -49,6 +50,8 @@ void CD3DVAMesh::Reset()
 	m_iDupMapListCount	= 0;
 	m_pDupMapList		= NULL;
 	m_pIndexData		= NULL;
+	m_pBlendedVerts		= NULL;
+	m_VBBlend.Clear();
 	m_bSWVertProcessing	= ((g_Device.GetDeviceCaps()->DevCaps & D3DDEVCAPS_HWTRANSFORMANDLIGHT) == 0) ? true : false;
 
 
@@ -74,6 +77,7 @@ void CD3DVAMesh::FreeAll()
 	m_VBController.FreeAll();
 	if (m_pDupMapList)	{ delete[] m_pDupMapList; m_pDupMapList = NULL; }
 	if (m_pIndexData)	{ delete[] m_pIndexData; m_pIndexData = NULL; }
+	if (m_pBlendedVerts) { delete[] m_pBlendedVerts; m_pBlendedVerts = NULL; }
 	for (uint32 i = 0; i < 4; ++i) { if (m_pVertData[i]) { delete[] m_pVertData[i];  m_pVertData[i] = NULL; } }
 
 	Reset();
@@ -127,6 +131,8 @@ bool CD3DVAMesh::Load(ILTStream& File, LTB_Header& LTBHeader)
 	LT_MEM_TRACK_ALLOC(m_pDupMapList = new DupMap[m_iDupMapListCount],LT_MEM_TYPE_RENDERER);
 	File.Read(m_pDupMapList,sizeof(DupMap) * m_iDupMapListCount);
 
+	LT_MEM_TRACK_ALLOC(m_pBlendedVerts = new float[m_iUnDupVertCount * 3],LT_MEM_TYPE_RENDERER);
+
 	// Create the VBs and stuff...
 	ReCreateObject();
 
@@ -169,12 +175,16 @@ void CD3DVAMesh::ReCreateObject()
 	m_VBController.Lock(VertexBufferController::eINDEX,false);
 	memcpy(m_VBController.getIndexData(),m_pIndexData,sizeof(uint16) * m_iPolyCount * 3);
 	m_VBController.UnLock(VertexBufferController::eINDEX);
+
+	// The VB has the bind pose now...
+	m_VBBlend.Clear();
 }
 
 // We're loosing focus, free the stuff...
 void CD3DVAMesh::FreeDeviceObjects()
 {
 	m_VBController.FreeAll();									// Free our VB...
+	m_VBBlend.Clear();
 }
 
 // Update the VA verts (the model has the anim)...
@@ -200,6 +210,14 @@ void CD3DVAMesh::UpdateVA(Model* pModel, AnimTimeRef* pAnimTimeRef)
 		pDefVerts[1] = pDefVerts[0];
 	}
 
+	// The VB already has this blend (an earlier pass, or another instance in the same anim state)...
+	if (m_VBBlend.Matches(pDefVerts[0], pDefVerts[1], percent))
+		return;
+
+	// Blend the frames in sys mem (the frame data is a packed xyz array, so it's one flat lerp)...
+	assert(pDefVerts[0]->size() >= m_iUnDupVertCount && pDefVerts[1]->size() >= m_iUnDupVertCount);
+	va_LerpFloats(m_pBlendedVerts, pDefVerts[0]->getArray(), pDefVerts[1]->getArray(), percent, m_iUnDupVertCount * 3);
+
 	// Get the vertex animation  multiply it by current transforms
 	if (!m_VBController.Lock(VertexBufferController::eVERTSTREAM0,false))
 	{
@@ -207,38 +225,15 @@ void CD3DVAMesh::UpdateVA(Model* pModel, AnimTimeRef* pAnimTimeRef)
 		return;
 	}
 
-	uint8* pVertData		= (uint8*)m_VBController.getVertexData(0);
-	uint32 Vertex_Size		= m_VBController.getVertexSize(0);
-	//uint32 NormalOffset		= m_VBController.getXYZSize();
-    int i = 0;
-	for (i = 0; i < (int)m_iUnDupVertCount ; ++i)
-	{
-		const float *prv_val = pDefVerts[0]->getValue(i);
-		const float *cur_val = pDefVerts[1]->getValue(i);
-
-		float val[3] ;
-		vertexLerp(val, prv_val, cur_val, percent);
-
-		D3DVECTOR* pPos		= (D3DVECTOR*)(pVertData);
-		pPos->x = val[0]; pPos->y = val[1]; pPos->z = val[2];
-
-		pVertData += Vertex_Size;
-	}
-
-	// Copy the DupVerts...
-	pVertData		= (uint8*)m_VBController.getVertexData(0);
-	for (i = 0;i < (int)m_iDupMapListCount; ++i)
-	{
-		D3DVECTOR* pDstVert = (D3DVECTOR*)(pVertData + ((uint32)m_pDupMapList[i].iDstVert * Vertex_Size));
-		D3DVECTOR* pSrcVert = (D3DVECTOR*)(pVertData + ((uint32)m_pDupMapList[i].iSrcVert * Vertex_Size));
-		pDstVert->x = pSrcVert->x; pDstVert->y = pSrcVert->y; pDstVert->z = pSrcVert->z;
-	}
+	va_WriteVerts((uint8*)m_VBController.getVertexData(0), m_VBController.getVertexSize(0), m_pBlendedVerts, m_iUnDupVertCount, m_pDupMapList, m_iDupMapListCount);
 
 	if (!m_VBController.UnLock(VertexBufferController::eVERTSTREAM0))
 	{
 		assert(0);
 		return;
 	}
+
+	m_VBBlend.Set(pDefVerts[0], pDefVerts[1], percent);
 }
 
 void CD3DVAMesh::Render(ModelInstance *pInstance, D3DMATRIX& WorldTransform, CD3DRenderStyle* pRenderStyle, uint32 iRenderPass)
@@ -9,6 +9,7 @@
 #include "common_stuff.h"
 #include "vertexbuffercontroller.h"
 #include "d3d_renderstyle.h"
+#include "d3dmeshrendobj_vablend.h"
 
 
 
@@ -17,9 +18,6 @@ class ModelInstance;
 
 
 
-// We keep a list of duplicated verts (UV sharing causes this). We minimize anim data this way, but they need to be recopied at the end, using this list...
-struct DupMap				{ uint16 iSrcVert;  uint16 iDstVert; };
-
 class CD3DVAMesh : public CDIVAMesh
 {
 public:
@@ -43,13 +41,6 @@ public:
 	void					CalcUsedNodes( Model *);
 private:
 
-	void vertexLerp(float *res, const float *a, const float *b, float t )
-	{
-		res[0] = a[0] + ((b[0] - a[0]) * t);
-		res[1] = a[1] + ((b[1] - a[1]) * t);
-		res[2] = a[2] + ((b[2] - a[2]) * t);
-	}
-
 	VertexBufferController	m_VBController;			// Our Vertex Buffer Controller - he ownz the buffers...
 	uint32					m_iBoneEffector;
 	uint32					m_iAnimNodeIdx;
@@ -70,6 +61,12 @@ private:
 	// Sys mem copies of our data...
 	uint8*					m_pVertData[4];
 	uint8*					m_pIndexData;
+
+	// Blended positions of the undup verts (xyz), the VB is write only so the dup verts are copied from here...
+	float*					m_pBlendedVerts;
+
+	// The frame pair and blend that's currently in the VB...
+	VABlendState			m_VBBlend;
 };
 
 #endif
@@ -38,6 +38,26 @@ define_holder(IClientShell, i_client_shell);
 #include "lteffectshadermgr.h"
 #include "ltshaderdevicestateimp.h"
 #include "rendererconsolevars.h"
+#include "workerpool.h"
+
+#include <vector>
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define POLYGRID_SSE2
+#include <emmintrin.h>
+#endif
+
+//the vector and fresnel generation is only split across threads for grids with at least this many vertices
+#define POLYGRID_THREAD_MIN_VERTS	16384
+#define POLYGRID_MAX_BANDS			8
+
+//runs Func(nStart, nEnd) over [0, nCount) on the worker pool if the grid has at least
+//POLYGRID_THREAD_MIN_VERTS vertices. Each item must only write its own vertices
+template<class F>
+static void ForEachPolyGridBand(uint32 nCount, uint32 nNumVerts, F Func)
+{
+	wp_ForEachBand(nCount, (nNumVerts >= POLYGRID_THREAD_MIN_VERTS) ? POLYGRID_MAX_BANDS : 1, Func);
+}
 
 //Interface for the client file manager
 #include "client_filemgr.h"
@@ -299,6 +319,195 @@ private:
 //the global cache of tables
 static CFresnelTableCache g_FresnelCache;
 
+//----------------------------------------------------------------------------
+// CPolyGridVertCache
+//   Holds on to the generated vertices of polygrids that haven't changed since
+//	the last time they were drawn, so that static grids don't need to be
+//	regenerated every frame
+//----------------------------------------------------------------------------
+class CPolyGridVertCache
+{
+public:
+
+	enum {	CACHE_SIZE	= 8 };
+
+	//the settings other than the samples, color table and valid mask that the vertices are
+	//generated from. This is compared bytewise, so it must be cleared before it is filled in
+	struct SKey
+	{
+		LTVector	m_vDims;
+		float		m_fXScale;
+		float		m_fYScale;
+		float		m_fXPan;
+		float		m_fYPan;
+		float		m_fUScale;
+		float		m_fVScale;
+		float		m_fFresnelVolumeIOR;
+		float		m_fBaseReflection;
+		uint32		m_nWidth;
+		uint32		m_nHeight;
+		uint32		m_nVertexSize;
+		uint32		m_nVertexType;
+		uint32		m_nColor;
+		uint32		m_nFresnel;
+	};
+
+	CPolyGridVertCache() : m_pPending(NULL)
+	{
+		for(uint32 nCurrElem = 0; nCurrElem < CACHE_SIZE; nCurrElem++)
+		{
+			m_Entries[nCurrElem].m_pGrid		= NULL;
+			m_Entries[nCurrElem].m_nIdleCount	= 0;
+			m_Entries[nCurrElem].m_nNumVerts	= 0;
+			m_Entries[nCurrElem].m_bStable		= false;
+			m_Entries[nCurrElem].m_bValidVerts	= false;
+		}
+	}
+
+	//returns the vertices of the polygrid if they are still up to date, otherwise NULL, and
+	//SetVerts should be called once they have been generated. pCameraPos is the camera in
+	//the space of the polygrid if the vertices depend upon it
+	const void* GetVerts(const LTPolyGrid* pGrid, const SKey& Key, const LTVector* pCameraPos, uint32& nNumVerts)
+	{
+		//build up the signature of everything the vertices come from
+		uint32 nNumSamples	= Key.m_nWidth * Key.m_nHeight;
+		uint32 nMaskSize	= pGrid->m_pValidMask ? pGrid->m_nValidMaskWidth * pGrid->m_Height * sizeof(uint32) : 0;
+
+		m_Signature.resize(sizeof(Key) + sizeof(pGrid->m_ColorTable) + nNumSamples + nMaskSize);
+
+		uint8* pSig = &m_Signature[0];
+		memcpy(pSig, &Key, sizeof(Key));									pSig += sizeof(Key);
+		memcpy(pSig, pGrid->m_ColorTable, sizeof(pGrid->m_ColorTable));	pSig += sizeof(pGrid->m_ColorTable);
+		memcpy(pSig, pGrid->m_Data, nNumSamples);							pSig += nNumSamples;
+		if(nMaskSize)
+			memcpy(pSig, pGrid->m_pValidMask, nMaskSize);
+
+		SEntry* pEntry = FindEntry(pGrid);
+		m_pPending = pEntry;
+
+		if(pEntry->m_Signature != m_Signature)
+		{
+			//the grid is changing, so don't bother holding onto its vertices until it settles down
+			pEntry->m_Signature.swap(m_Signature);
+			pEntry->m_bStable		= false;
+			pEntry->m_bValidVerts	= false;
+			return NULL;
+		}
+
+		pEntry->m_bStable = true;
+
+		if(!pEntry->m_bValidVerts)
+			return NULL;
+
+		if(pCameraPos && ((*pCameraPos - pEntry->m_vCameraPos).MagSqr() > Sqr(g_CV_PolyGridVertCacheCameraDist.m_Val)))
+			return NULL;
+
+		nNumVerts = pEntry->m_nNumVerts;
+		return &pEntry->m_Verts[0];
+	}
+
+	//hands the vertices generated after GetVerts failed over to the cache
+	void SetVerts(const void* pVerts, uint32 nNumVerts, uint32 nVertexSize, const LTVector& vCameraPos)
+	{
+		SEntry* pEntry = m_pPending;
+		m_pPending = NULL;
+
+		//only grids that stayed the same since the last frame are worth copying
+		if(!pEntry || !pEntry->m_bStable || (nNumVerts == 0))
+			return;
+
+		pEntry->m_Verts.resize(nNumVerts * nVertexSize);
+		memcpy(&pEntry->m_Verts[0], pVerts, nNumVerts * nVertexSize);
+
+		pEntry->m_nNumVerts		= nNumVerts;
+		pEntry->m_vCameraPos	= vCameraPos;
+		pEntry->m_bValidVerts	= true;
+	}
+
+	//frees all of the cached vertices
+	void Free()
+	{
+		for(uint32 nCurrElem = 0; nCurrElem < CACHE_SIZE; nCurrElem++)
+		{
+			SEntry& Entry = m_Entries[nCurrElem];
+
+			std::vector<uint8>().swap(Entry.m_Signature);
+			std::vector<uint8>().swap(Entry.m_Verts);
+
+			Entry.m_pGrid		= NULL;
+			Entry.m_bStable		= false;
+			Entry.m_bValidVerts	= false;
+		}
+
+		std::vector<uint8>().swap(m_Signature);
+		m_pPending = NULL;
+	}
+
+private:
+
+	struct SEntry
+	{
+		//the grid this entry was last used for. Grids can be freed without us knowing, so this
+		//is only used to find the entry, the signature decides if the vertices are valid
+		const LTPolyGrid*	m_pGrid;
+		uint32				m_nIdleCount;
+
+		std::vector<uint8>	m_Signature;
+		bool				m_bStable;
+
+		std::vector<uint8>	m_Verts;
+		uint32				m_nNumVerts;
+		LTVector			m_vCameraPos;
+		bool				m_bValidVerts;
+	};
+
+	//finds the entry for the grid, or takes over the longest idle one
+	SEntry* FindEntry(const LTPolyGrid* pGrid)
+	{
+		SEntry* pFound	= NULL;
+		SEntry* pIdle	= &m_Entries[0];
+
+		for(uint32 nCurrElem = 0; nCurrElem < CACHE_SIZE; nCurrElem++)
+		{
+			SEntry& Entry = m_Entries[nCurrElem];
+
+			if(Entry.m_pGrid == pGrid)
+			{
+				pFound = &Entry;
+			}
+			else
+			{
+				Entry.m_nIdleCount++;
+
+				if(Entry.m_nIdleCount > pIdle->m_nIdleCount)
+					pIdle = &Entry;
+			}
+		}
+
+		if(!pFound)
+		{
+			pFound = pIdle;
+			pFound->m_pGrid			= pGrid;
+			pFound->m_bStable		= false;
+			pFound->m_bValidVerts	= false;
+			pFound->m_Signature.clear();
+		}
+
+		pFound->m_nIdleCount = 0;
+		return pFound;
+	}
+
+	SEntry				m_Entries[CACHE_SIZE];
+
+	//the entry waiting on SetVerts
+	SEntry*				m_pPending;
+
+	//scratch space for building the signature
+	std::vector<uint8>	m_Signature;
+};
+
+static CPolyGridVertCache g_PolyGridVertCache;
+
 // ---------------------------------------------------------------- //
 // Internal functions.
 // ---------------------------------------------------------------- //
@@ -404,6 +613,60 @@ static void d3d_UnsetEnvMapTextureStates()
 	d3d_SetDefaultBlendStates();
 }
 
+#ifdef POLYGRID_SSE2
+
+//normalizes four vectors at once, the same way LTVector::Normalize does
+static inline void NormalizeVectors4(__m128& vX, __m128& vY, __m128& vZ)
+{
+	__m128 vLenSqr	= _mm_add_ps(_mm_add_ps(_mm_mul_ps(vX, vX), _mm_mul_ps(vY, vY)), _mm_mul_ps(vZ, vZ));
+	__m128 vInvLen	= _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(vLenSqr));
+
+	vX = _mm_mul_ps(vX, vInvLen);
+	vY = _mm_mul_ps(vY, vInvLen);
+	vZ = _mm_mul_ps(vZ, vInvLen);
+}
+
+//stores four vectors into the vertices, pVec points to the vector of the first vertex
+static inline void StoreVectors4(LTVector* pVec, uint32 nVertexSize, __m128 vX, __m128 vY, __m128 vZ)
+{
+	float fX[4], fY[4], fZ[4];
+	_mm_storeu_ps(fX, vX);
+	_mm_storeu_ps(fY, vY);
+	_mm_storeu_ps(fZ, vZ);
+
+	for(uint32 nCurr = 0; nCurr < 4; nCurr++)
+	{
+		pVec->x = fX[nCurr];
+		pVec->y = fY[nCurr];
+		pVec->z = fZ[nCurr];
+
+		pVec = (LTVector*)((uint8*)pVec + nVertexSize);
+	}
+}
+
+//loads four samples starting at pData as integers
+static inline __m128i LoadSamples4(const char* pData)
+{
+	int32 nPacked;
+	memcpy(&nPacked, pData, sizeof(nPacked));
+
+	//sign extend the bytes out to 32 bits
+	__m128i vVal = _mm_cvtsi32_si128(nPacked);
+	vVal = _mm_unpacklo_epi8(vVal, vVal);
+	vVal = _mm_unpacklo_epi16(vVal, vVal);
+	return _mm_srai_epi32(vVal, 24);
+}
+
+//finds the scaled height differences across the four interior samples starting at pData,
+//matching the offsets of -1, 1, -nWidth, nWidth used for the scalar interior vertices
+static inline void LoadSlopes4(const char* pData, int32 nWidth, __m128 vYScale, __m128& vSlopeX, __m128& vSlopeZ)
+{
+	vSlopeX = _mm_mul_ps(_mm_cvtepi32_ps(_mm_sub_epi32(LoadSamples4(pData - 1), LoadSamples4(pData + 1))), vYScale);
+	vSlopeZ = _mm_mul_ps(_mm_cvtepi32_ps(_mm_sub_epi32(LoadSamples4(pData - nWidth), LoadSamples4(pData + nWidth))), vYScale);
+}
+
+#endif
+
 //Given an index for a vertex to calculate a normal for, as well as index offsets to
 //form two basis vectors for a plane, it will calculate the normal and store it in
 //the vertex of the specified index
@@ -487,8 +750,129 @@ static inline void GenerateBasisSpace(char* pData, CPolyGridBumpVertex* pVert, i
 	assert(pVert->m_vBasisUp.Dot(LTVector(0.0f, 1.0f, 0.0f)) > 0.0f);
 }
 
-template <class Function, class VertType>
-static void GeneratePolyGridVectors(LTPolyGrid* pGrid, VertType* pVert, Function GenFunction)
+//Row versions of the above for nCount vertices in the interior of the grid, which use the
+//offsets -1, 1, -nWidth, nWidth. These produce exactly the same results as the single vertex versions
+static void GenerateNormalRow(char* pData, CPolyGridVertex* pVert, int32 nCount, int32 nWidth,
+							  float fWidth, float fHeight, float fWidthTimesHeight, float fYScale)
+{
+	int32 nCurr = 0;
+
+#ifdef POLYGRID_SSE2
+	__m128 vYScale	= _mm_set1_ps(fYScale);
+	__m128 vWidth	= _mm_set1_ps(fWidth);
+	__m128 vHeight	= _mm_set1_ps(fHeight);
+	__m128 vWH		= _mm_set1_ps(fWidthTimesHeight);
+
+	for(; nCurr + 4 <= nCount; nCurr += 4)
+	{
+		__m128 vSlopeX, vSlopeZ;
+		LoadSlopes4(pData + nCurr, nWidth, vYScale, vSlopeX, vSlopeZ);
+
+		__m128 vX = _mm_mul_ps(vSlopeX, vHeight);
+		__m128 vY = vWH;
+		__m128 vZ = _mm_mul_ps(vSlopeZ, vWidth);
+		NormalizeVectors4(vX, vY, vZ);
+
+		StoreVectors4(&pVert[nCurr].m_Normal, sizeof(CPolyGridVertex), vX, vY, vZ);
+	}
+#endif
+
+	for(; nCurr < nCount; nCurr++)
+	{
+		GenerateNormal(pData + nCurr, pVert + nCurr, -1, 1, -nWidth, nWidth, fWidth, fHeight, fWidthTimesHeight, fYScale);
+	}
+}
+
+static void GenerateEffectBasisSpaceRow(char* pData, CPolyGridEffectVertex* pVert, int32 nCount, int32 nWidth,
+										float fWidth, float fHeight, float fWidthTimesHeight, float fYScale)
+{
+	int32 nCurr = 0;
+
+#ifdef POLYGRID_SSE2
+	__m128 vYScale	= _mm_set1_ps(fYScale);
+	__m128 vWidth	= _mm_set1_ps(fWidth);
+	__m128 vHeight	= _mm_set1_ps(fHeight);
+	__m128 vWH		= _mm_set1_ps(fWidthTimesHeight);
+	__m128 vZero	= _mm_setzero_ps();
+
+	for(; nCurr + 4 <= nCount; nCurr += 4)
+	{
+		__m128 vSlopeX, vSlopeZ;
+		LoadSlopes4(pData + nCurr, nWidth, vYScale, vSlopeX, vSlopeZ);
+
+		__m128 vBinormalX = _mm_mul_ps(vSlopeX, vHeight);
+		__m128 vBinormalY = vWH;
+		__m128 vBinormalZ = _mm_mul_ps(vSlopeZ, vWidth);
+		NormalizeVectors4(vBinormalX, vBinormalY, vBinormalZ);
+
+		__m128 vNormalX = vZero;
+		__m128 vNormalY = vSlopeZ;
+		__m128 vNormalZ = vHeight;
+		NormalizeVectors4(vNormalX, vNormalY, vNormalZ);
+
+		__m128 vTangentX = _mm_sub_ps(vZero, vWidth);
+		__m128 vTangentY = vSlopeX;
+		__m128 vTangentZ = vZero;
+		NormalizeVectors4(vTangentX, vTangentY, vTangentZ);
+
+		StoreVectors4(&pVert[nCurr].m_Binormal, sizeof(CPolyGridEffectVertex), vBinormalX, vBinormalY, vBinormalZ);
+		StoreVectors4(&pVert[nCurr].m_Normal, sizeof(CPolyGridEffectVertex), vNormalX, vNormalY, vNormalZ);
+		StoreVectors4(&pVert[nCurr].m_Tangent, sizeof(CPolyGridEffectVertex), vTangentX, vTangentY, vTangentZ);
+	}
+#endif
+
+	for(; nCurr < nCount; nCurr++)
+	{
+		GenerateEffectBasisSpace(pData + nCurr, pVert + nCurr, -1, 1, -nWidth, nWidth, fWidth, fHeight, fWidthTimesHeight, fYScale);
+	}
+}
+
+static void GenerateBasisSpaceRow(char* pData, CPolyGridBumpVertex* pVert, int32 nCount, int32 nWidth,
+								  float fWidth, float fHeight, float fWidthTimesHeight, float fYScale)
+{
+	int32 nCurr = 0;
+
+#ifdef POLYGRID_SSE2
+	__m128 vYScale	= _mm_set1_ps(fYScale);
+	__m128 vWidth	= _mm_set1_ps(fWidth);
+	__m128 vHeight	= _mm_set1_ps(fHeight);
+	__m128 vWH		= _mm_set1_ps(fWidthTimesHeight);
+	__m128 vZero	= _mm_setzero_ps();
+
+	for(; nCurr + 4 <= nCount; nCurr += 4)
+	{
+		__m128 vSlopeX, vSlopeZ;
+		LoadSlopes4(pData + nCurr, nWidth, vYScale, vSlopeX, vSlopeZ);
+
+		__m128 vUpX = _mm_mul_ps(vSlopeX, vHeight);
+		__m128 vUpY = vWH;
+		__m128 vUpZ = _mm_mul_ps(vSlopeZ, vWidth);
+		NormalizeVectors4(vUpX, vUpY, vUpZ);
+
+		__m128 vForwardX = vZero;
+		__m128 vForwardY = vSlopeZ;
+		__m128 vForwardZ = vHeight;
+		NormalizeVectors4(vForwardX, vForwardY, vForwardZ);
+
+		__m128 vRightX = _mm_sub_ps(vZero, vWidth);
+		__m128 vRightY = vSlopeX;
+		__m128 vRightZ = vZero;
+		NormalizeVectors4(vRightX, vRightY, vRightZ);
+
+		StoreVectors4(&pVert[nCurr].m_vBasisUp, sizeof(CPolyGridBumpVertex), vUpX, vUpY, vUpZ);
+		StoreVectors4(&pVert[nCurr].m_vBasisForward, sizeof(CPolyGridBumpVertex), vForwardX, vForwardY, vForwardZ);
+		StoreVectors4(&pVert[nCurr].m_vBasisRight, sizeof(CPolyGridBumpVertex), vRightX, vRightY, vRightZ);
+	}
+#endif
+
+	for(; nCurr < nCount; nCurr++)
+	{
+		GenerateBasisSpace(pData + nCurr, pVert + nCurr, -1, 1, -nWidth, nWidth, fWidth, fHeight, fWidthTimesHeight, fYScale);
+	}
+}
+
+template <class Function, class RowFunction, class VertType>
+static void GeneratePolyGridVectors(LTPolyGrid* pGrid, VertType* pVert, Function GenFunction, RowFunction GenRowFunction)
 {
 	//get the dims of ths polygrid
 	int32 nWidth	= pGrid->m_Width;
@@ -540,22 +924,20 @@ static void GeneratePolyGridVectors(LTPolyGrid* pGrid, VertType* pVert, Function
 		GenFunction(pData + nCurrY + nWidth - 1, pVert + nCurrY + nWidth - 1, 0, -1, nWidth, -nWidth, fWidth, fHeight, fWidthTimesHeight, fYScale);
 	}
 
-	//now generate the internals of the polygrid
-	for(nCurrY = 1; nCurrY < nHeight - 1; nCurrY++)
+	//now generate the internals of the polygrid, a row at a time
+	ForEachPolyGridBand(nHeight - 2, nTotal, [&](uint32 nStartRow, uint32 nEndRow)
 	{
-		uint32 nPos = nCurrY * nWidth + 1;
-
-		for(nCurrX = 1; nCurrX < nWidth - 1; nCurrX++)
+		for(uint32 nRow = nStartRow + 1; nRow < nEndRow + 1; nRow++)
 		{
-			GenFunction(pData + nPos, pVert + nPos, -1, 1, -nWidth, nWidth, fWidth, fHeight, fWidthTimesHeight, fYScale);
-			nPos++;
+			uint32 nPos = nRow * nWidth + 1;
+			GenRowFunction(pData + nPos, pVert + nPos, nWidth - 2, nWidth, fWidth, fHeight, fWidthTimesHeight, fYScale);
 		}
-	}
+	});
 }
 
-static void GeneratePolyGridFresnelAlpha(const LTVector& vViewPos, CPolyGridVertex* pVerts, LTPolyGrid* pGrid, uint32 nNumVerts)
+//transforms the camera position into the space of the polygrid
+static LTVector GetPolyGridCameraPos(const LTVector& vViewPos, LTPolyGrid* pGrid)
 {
-	//we need to transform the camera position into our view space
 	LTMatrix mInvWorldTrans;
 
 	mInvWorldTrans.Identity();
@@ -566,384 +948,190 @@ static void GeneratePolyGridFresnelAlpha(const LTVector& vViewPos, CPolyGridVert
 
 	mInvWorldTrans = mOrientation * mInvWorldTrans;
 
-	LTVector vCameraPos = mInvWorldTrans * vViewPos;
+	return mInvWorldTrans * vViewPos;
+}
 
-	//now generate the internals of the polygrid
-	CPolyGridVertex* pCurrVert	= pVerts;
-	CPolyGridVertex* pEnd		= pCurrVert + nNumVerts;
+//applies the fresnel term to the alpha of the vertices in [nStart, nEnd)
+static void GenerateFresnelAlphaSpan(const LTVector& vCameraPos, CPolyGridVertex* pVerts, const CFresnelTable* pTable, uint32 nStart, uint32 nEnd)
+{
+	uint32 nCurrVert = nStart;
 
-	//determine the fresnel table that we are going to be using
-	const CFresnelTable* pTable = g_FresnelCache.GetTable(LTMAX(1.0003f, pGrid->m_fFresnelVolumeIOR), pGrid->m_fBaseReflection);
+#ifdef POLYGRID_SSE2
+	__m128 vCamX = _mm_set1_ps(vCameraPos.x);
+	__m128 vCamY = _mm_set1_ps(vCameraPos.y);
+	__m128 vCamZ = _mm_set1_ps(vCameraPos.z);
+
+	for(; nCurrVert + 4 <= nEnd; nCurrVert += 4)
+	{
+		CPolyGridVertex* pVert = &pVerts[nCurrVert];
+
+		__m128 vToX = _mm_sub_ps(vCamX, _mm_setr_ps(pVert[0].m_Vec.x, pVert[1].m_Vec.x, pVert[2].m_Vec.x, pVert[3].m_Vec.x));
+		__m128 vToY = _mm_sub_ps(vCamY, _mm_setr_ps(pVert[0].m_Vec.y, pVert[1].m_Vec.y, pVert[2].m_Vec.y, pVert[3].m_Vec.y));
+		__m128 vToZ = _mm_sub_ps(vCamZ, _mm_setr_ps(pVert[0].m_Vec.z, pVert[1].m_Vec.z, pVert[2].m_Vec.z, pVert[3].m_Vec.z));
+
+		__m128 vNX = _mm_setr_ps(pVert[0].m_Normal.x, pVert[1].m_Normal.x, pVert[2].m_Normal.x, pVert[3].m_Normal.x);
+		__m128 vNY = _mm_setr_ps(pVert[0].m_Normal.y, pVert[1].m_Normal.y, pVert[2].m_Normal.y, pVert[3].m_Normal.y);
+		__m128 vNZ = _mm_setr_ps(pVert[0].m_Normal.z, pVert[1].m_Normal.z, pVert[2].m_Normal.z, pVert[3].m_Normal.z);
 
-	//use a vector from the camera to the center of the grid to base our approximations off of. The further
-	//we get to the edges the more likely this error will be, but it is better than another sqrt per vert
-	LTVector vToPGPt;
+		__m128 vDot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vToX, vNX), _mm_mul_ps(vToY, vNY)), _mm_mul_ps(vToZ, vNZ));
+		__m128 vMag = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(vToX, vToX), _mm_mul_ps(vToY, vToY)), _mm_mul_ps(vToZ, vToZ)));
 
-	while(pCurrVert < pEnd)
+		float fCos[4];
+		_mm_storeu_ps(fCos, _mm_div_ps(vDot, vMag));
+
+		pVert[0].m_nColor |= pTable->GetValue(fCos[0]);
+		pVert[1].m_nColor |= pTable->GetValue(fCos[1]);
+		pVert[2].m_nColor |= pTable->GetValue(fCos[2]);
+		pVert[3].m_nColor |= pTable->GetValue(fCos[3]);
+	}
+#endif
+
+	for(; nCurrVert < nEnd; nCurrVert++)
 	{
-		//the correct but slow way, so only do it every once in a while
-		//if((pCurrVert - g_TriVertList) % 4 == 0)
-		{
-			vToPGPt = vCameraPos - pCurrVert->m_Vec;
-		}
+		CPolyGridVertex* pVert = &pVerts[nCurrVert];
 
-		pCurrVert->m_nColor |= pTable->GetValue(vToPGPt.Dot(pCurrVert->m_Normal) / vToPGPt.Mag());
-		++pCurrVert;
+		LTVector vToPGPt = vCameraPos - pVert->m_Vec;
+		pVert->m_nColor |= pTable->GetValue(vToPGPt.Dot(pVert->m_Normal) / vToPGPt.Mag());
 	}
 }
 
-static void GeneratePolyGridFresnelAlphaAndCamera(const LTVector& vViewPos, CPolyGridBumpVertex* pVerts, LTPolyGrid* pGrid, uint32 nNumVerts)
+static void GeneratePolyGridFresnelAlpha(const LTVector& vCameraPos, CPolyGridVertex* pVerts, LTPolyGrid* pGrid, uint32 nNumVerts)
 {
-	//we need to transform the camera position into our view space
-	LTMatrix mInvWorldTrans;
+	//determine the fresnel table that we are going to be using
+	const CFresnelTable* pTable = g_FresnelCache.GetTable(LTMAX(1.0003f, pGrid->m_fFresnelVolumeIOR), pGrid->m_fBaseReflection);
 
-	mInvWorldTrans.Identity();
-	mInvWorldTrans.SetTranslation(-pGrid->GetPos());
+	ForEachPolyGridBand(nNumVerts, nNumVerts, [&](uint32 nStart, uint32 nEnd)
+	{
+		GenerateFresnelAlphaSpan(vCameraPos, pVerts, pTable, nStart, nEnd);
+	});
+}
 
-	LTMatrix mOrientation;
-	pGrid->m_Rotation.ConvertToMatrix(mOrientation);
+//sets up the eye vector and applies the fresnel term to the alpha of the vertices in [nStart, nEnd)
+static void GenerateFresnelAlphaAndCameraSpan(const LTVector& vCameraPos, CPolyGridBumpVertex* pVerts, const CFresnelTable* pTable, uint32 nStart, uint32 nEnd)
+{
+	uint32 nCurrVert = nStart;
 
-	mInvWorldTrans = mOrientation * mInvWorldTrans;
+#ifdef POLYGRID_SSE2
+	__m128 vCamX = _mm_set1_ps(vCameraPos.x);
+	__m128 vCamY = _mm_set1_ps(vCameraPos.y);
+	__m128 vCamZ = _mm_set1_ps(vCameraPos.z);
 
-	LTVector vCameraPos = mInvWorldTrans * vViewPos;
+	for(; nCurrVert + 4 <= nEnd; nCurrVert += 4)
+	{
+		CPolyGridBumpVertex* pVert = &pVerts[nCurrVert];
 
-	//now generate the internals of the polygrid
-	CPolyGridBumpVertex* pCurrVert	= pVerts;
-	CPolyGridBumpVertex* pEnd		= pCurrVert + nNumVerts;
+		__m128 vToX = _mm_sub_ps(vCamX, _mm_setr_ps(pVert[0].m_Vec.x, pVert[1].m_Vec.x, pVert[2].m_Vec.x, pVert[3].m_Vec.x));
+		__m128 vToY = _mm_sub_ps(vCamY, _mm_setr_ps(pVert[0].m_Vec.y, pVert[1].m_Vec.y, pVert[2].m_Vec.y, pVert[3].m_Vec.y));
+		__m128 vToZ = _mm_sub_ps(vCamZ, _mm_setr_ps(pVert[0].m_Vec.z, pVert[1].m_Vec.z, pVert[2].m_Vec.z, pVert[3].m_Vec.z));
+		NormalizeVectors4(vToX, vToY, vToZ);
 
-	//determine the fresnel table that we are going to be using
-	const CFresnelTable* pTable = g_FresnelCache.GetTable(LTMAX(1.0003f, pGrid->m_fFresnelVolumeIOR), pGrid->m_fBaseReflection);
+		__m128 vUpX = _mm_setr_ps(pVert[0].m_vBasisUp.x, pVert[1].m_vBasisUp.x, pVert[2].m_vBasisUp.x, pVert[3].m_vBasisUp.x);
+		__m128 vUpY = _mm_setr_ps(pVert[0].m_vBasisUp.y, pVert[1].m_vBasisUp.y, pVert[2].m_vBasisUp.y, pVert[3].m_vBasisUp.y);
+		__m128 vUpZ = _mm_setr_ps(pVert[0].m_vBasisUp.z, pVert[1].m_vBasisUp.z, pVert[2].m_vBasisUp.z, pVert[3].m_vBasisUp.z);
 
-	//use a vector from the camera to the center of the grid to base our approximations off of. The further
-	//we get to the edges the more likely this error will be, but it is better than another sqrt per vert
-	LTVector vToPGPt;
+		__m128 vDot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vToX, vUpX), _mm_mul_ps(vToY, vUpY)), _mm_mul_ps(vToZ, vUpZ));
 
-	while(pCurrVert < pEnd)
-	{
-		//the correct but slow way, so only do it every once in a while
-		//if((pCurrVert - g_TriVertList) % 4 == 0)
+		float fEyeX[4], fEyeY[4], fEyeZ[4], fCos[4];
+		_mm_storeu_ps(fEyeX, vToX);
+		_mm_storeu_ps(fEyeY, vToY);
+		_mm_storeu_ps(fEyeZ, vToZ);
+		_mm_storeu_ps(fCos, vDot);
+
+		for(uint32 nCurr = 0; nCurr < 4; nCurr++)
 		{
-			vToPGPt = vCameraPos - pCurrVert->m_Vec;
-			vToPGPt.Normalize();
+			pVert[nCurr].m_fEyeX = fEyeX[nCurr];
+			pVert[nCurr].m_fEyeY = fEyeY[nCurr];
+			pVert[nCurr].m_fEyeZ = fEyeZ[nCurr];
+
+			pVert[nCurr].m_nColor |= pTable->GetValue(fCos[nCurr]);
 		}
+	}
+#endif
+
+	for(; nCurrVert < nEnd; nCurrVert++)
+	{
+		CPolyGridBumpVertex* pVert = &pVerts[nCurrVert];
+
+		LTVector vToPGPt = vCameraPos - pVert->m_Vec;
+		vToPGPt.Normalize();
 
-		pCurrVert->m_fEyeX = vToPGPt.x;
-		pCurrVert->m_fEyeY = vToPGPt.y;
-		pCurrVert->m_fEyeZ = vToPGPt.z;
+		pVert->m_fEyeX = vToPGPt.x;
+		pVert->m_fEyeY = vToPGPt.y;
+		pVert->m_fEyeZ = vToPGPt.z;
 
-		pCurrVert->m_nColor |= pTable->GetValue(vToPGPt.Dot(pCurrVert->m_vBasisUp));
-		++pCurrVert;
+		pVert->m_nColor |= pTable->GetValue(vToPGPt.Dot(pVert->m_vBasisUp));
 	}
 }
 
+static void GeneratePolyGridFresnelAlphaAndCamera(const LTVector& vCameraPos, CPolyGridBumpVertex* pVerts, LTPolyGrid* pGrid, uint32 nNumVerts)
+{
+	//determine the fresnel table that we are going to be using
+	const CFresnelTable* pTable = g_FresnelCache.GetTable(LTMAX(1.0003f, pGrid->m_fFresnelVolumeIOR), pGrid->m_fBaseReflection);
 
+	ForEachPolyGridBand(nNumVerts, nNumVerts, [&](uint32 nStart, uint32 nEnd)
+	{
+		GenerateFresnelAlphaAndCameraSpan(vCameraPos, pVerts, pTable, nStart, nEnd);
+	});
+}
 
-void d3d_DrawPolyGrid(const ViewParams &Params, LTObject *pObj)
-{
-	//the global pixel shader to be used for the water bumpmapping and a flag indicating if
-	//creation failed
-	bool				s_bPixelShaderFailed = false;
 
-	//make sure that the polygrid is valid
-	assert(pObj);
 
-	//get our polygrid
-    LTPolyGrid *pGrid = (LTPolyGrid*)pObj;
+//fills in g_TriVertList with the vertices of the polygrid, and returns the number of vertices
+static uint32 d3d_GeneratePolyGridVerts(LTPolyGrid* pGrid, bool bBumpMap, bool bEffect, uint8 nColorAlpha, float fPGUScale, float fPGVScale)
+{
+	//cache the half dimensions
+	float fHalfGridWidth  = ((float)pGrid->m_Width - 1) * 0.5f;
+	float fHalfGridHeight = ((float)pGrid->m_Height - 1) * 0.5f;
 
-	// Make sure it's initialized.
-	if(!pGrid->m_Data)
-		return;
+	float fScaledR = pGrid->m_ColorR * MATH_ONE_OVER_255;
+	float fScaledG = pGrid->m_ColorG * MATH_ONE_OVER_255;
+	float fScaledB = pGrid->m_ColorB * MATH_ONE_OVER_255;
 
-	//must have an index buffer
-	if(!pGrid->m_Indices || (pGrid->m_nIndices == 0))
-		return;
+	uint32 nColorTable[256];
+	for(uint32 nCurrColor = 0; nCurrColor < 256; nCurrColor++)
+	{
+		//Note that the color table is 0..255, object color is 0..255 as well
+		nColorTable[nCurrColor] = D3DRGBA_255(	pGrid->m_ColorTable[nCurrColor].x * fScaledR,
+												pGrid->m_ColorTable[nCurrColor].y * fScaledG,
+												pGrid->m_ColorTable[nCurrColor].z * fScaledB,
+												nColorAlpha);
+	}
 
-	//and of course, make sure that the size is reasonable
-	if((pGrid->m_Width < 2) || (pGrid->m_Height < 2))
-		return;
+	//calculate our position increments
+	float fXInc			= pGrid->GetDims().x * 2.0f / (pGrid->m_Width - 1);
+	float fZInc			= pGrid->GetDims().z * 2.0f / (pGrid->m_Height - 1);
+	float fYScale		= pGrid->GetDims().y / 127.0f;
 
-	IncFrameStat(eFS_PolyGridTriangles, pGrid->m_nTris);
+	float fXStart		= -fHalfGridWidth * fXInc;
+	float fCurrX		= fXStart;
+	float fCurrZ		= -fHalfGridHeight * fZInc;
 
-	//cache the half dimensions
-	float fHalfGridWidth  = ((float)pGrid->m_Width - 1) * 0.5f;
-	float fHalfGridHeight = ((float)pGrid->m_Height - 1) * 0.5f;
 
-	//now we need to build our color lookup table for this polygrid, this is faster for any
-	//polygrid that is larger than 8x8, and even then we can get a nice tight loop that
-	//should still be rather optimal
+	int8* pDataPos		= (int8*)pGrid->m_Data;
+	int8* pDataEnd		= pDataPos + pGrid->m_Width * pGrid->m_Height;
+	int8* pLineDataEnd	= pDataPos + pGrid->m_Width;
 
-	// Set the blending mode based on the flags.
-	uint32 nSrcBlend, nDestBlend, nFog, nFogColor;
-	d3d_GetBlendStates(pGrid, nSrcBlend, nDestBlend, nFog, nFogColor);
-	StateSet ssSrcBlend(D3DRS_SRCBLEND, nSrcBlend);
-	StateSet ssDestBlend(D3DRS_DESTBLEND, nDestBlend);
-	StateSet ssFog(D3DRS_FOGENABLE, nFog);
-	StateSet ssFogColor(D3DRS_FOGCOLOR, nFogColor);
+	uint32* pColor		= nColorTable + 128;
 
-	//flag indicating whether or not
-	bool bEnvMap		= false;
-	bool bCubicEnvMap	= false;
-	bool bBumpMap		= false;
+	float fXScale		= pGrid->m_xScale / ((pGrid->m_Width - 1) * fXInc);
+	float fZScale		= pGrid->m_yScale / ((pGrid->m_Height - 1) * fZInc);
 
-	//vertex information
-	uint32 nVertexSize  = sizeof(CPolyGridVertex);
-	uint32 nVertexFVF	= POLYGRIDVERTEX_FORMAT;
+	float fStartU		= (float)fmod(pGrid->m_xPan * fPGUScale, 1.0f);
+	float fStartV		= (float)fmod(pGrid->m_yPan * fPGVScale, 1.0f);
 
-	//UV scales to adjust the texture by (defaults to 1, but if we are bump mapping, this will
-	//be set to the detail texture scale)
-	float	fPGUScale	= 1.0f;
-	float	fPGVScale	= 1.0f;
+	float fCurrU		= fStartU;
+	float fCurrV		= fStartV;
 
-	// Set the texture if necessary.
-	SpriteTracker* pTracker = nullptr;
+	float fUInc			= fXInc * fXScale * fPGUScale;
+	float fVInc			= fZInc * fZScale * fPGVScale;
 
-	LTPixelShader *pPixelShader = NULL;
+	int32 nWidth		= pGrid->m_Width;
+	float fSpacingX		= fXInc * 2.0f;
+	float fSpacingZ		= fZInc * 2.0f;
 
-	if(pGrid->m_pSprite)
-	{
-		pTracker = &pGrid->m_SpriteTracker;
-		if(pTracker->m_pCurFrame)
-		{
-			SharedTexture* pTex = pTracker->m_pCurFrame->m_pTex;
-			if(pTex)
-			{
-				//get the type of this texture
-				ESharedTexType eTexType = pTex->m_eTexType;
-                static_cast<void>(eTexType);
-
-				//the base texture
-				SharedTexture* pBaseTex		= NULL;
-				//the environment map
-				SharedTexture* pEnvMapTex	= pGrid->m_pEnvMap;
-				//the bumpmap
-				SharedTexture* pBumpMapTex	= NULL;
-
-				//determine our texture data
-				if(pGrid->m_nPGFlags & PG_NORMALMAPSPRITE)
-				{
-					//only use a bump map texture if we actually have an environment map
-					if(pEnvMapTex)
-						pBumpMapTex	= pTex;
-				}
-				else
-				{
-					//we have a normal texture
-					pBaseTex	= pTex;
-				}
-
-				// Set up the environment mapping texture if applicable
-				if(	pEnvMapTex && g_CV_EnvMapPolyGrids.m_Val)
-				{
-					//see if the is a cubic environment map
-					RTexture *pRenderTexture = (RTexture*)pEnvMapTex->m_pRenderData;
-					if(pRenderTexture && pRenderTexture->IsCubeMap())
-					{
-						bCubicEnvMap = true;
-					}
-
-					bEnvMap = true;
-				}
-
-				if(	pBumpMapTex && g_CV_BumpMapPolyGrids.m_Val)
-				{
-					//we now need to make sure that the bump map shader is valid
-
-					//see if we need to load it
-					if (!s_bPixelShaderFailed)
-					{
-#if LTJS_USE_D3DX9
-						// Get the pixel shader.
-						pPixelShader = LTPixelShaderMgr::GetSingleton().GetPixelShader(LTPixelShader::PIXELSHADER_ENVBUMPMAP);
-						if (NULL == pPixelShader)
-						{
-							FileRef ref;
-							ref.m_FileType 	= FILE_ANYFILE;
-							ref.m_pFilename = "ps\\envbumpmap.psh";
-
-							// Try to load it.
-							ILTStream *pStream = g_pIClientFileMgr->OpenFile(&ref);
-							if (NULL != pStream)
-							{
-								if (LTPixelShaderMgr::GetSingleton().AddPixelShader(pStream, ref.m_pFilename,
-																					LTPixelShader::PIXELSHADER_ENVBUMPMAP, true))
-								{
-									pPixelShader = LTPixelShaderMgr::GetSingleton().GetPixelShader(LTPixelShader::PIXELSHADER_ENVBUMPMAP);
-								}
-
-								// Close the file.
-								pStream->Release();
-							}
-						}
-#endif // LTJS_USE_D3DX9
-					}
-
-					// See if we can continue.
-					if (NULL != pPixelShader && pPixelShader->IsValidShader())
-					{
-						bBumpMap	= true;
-						nVertexSize = sizeof(CPolyGridBumpVertex);
-						nVertexFVF	= POLYGRIDBUMPVERTEX_FORMAT;
-						fPGUScale	= ((RTexture*)pBumpMapTex->m_pRenderData)->m_DetailTextureScale;
-						fPGVScale	= fPGUScale;
-					}
-					else
-					{
-						//we failed to create the shader, the device can't support it
-						s_bPixelShaderFailed = true;
-					}
-				}
-
-				//setup the textures based upon the configuration
-				if(bBumpMap)
-				{
-					d3d_SetTexture(pBumpMapTex, 0, eFS_PolyGridBumpMapTexMemory);
-					d3d_SetTexture(pEnvMapTex, 3, eFS_PolyGridEnvMapTexMemory);
-				}
-				else
-				{
-#if LTJS_USE_D3DX9
-					LTEffectImpl* pEffect = (LTEffectImpl*)LTEffectShaderMgr::GetSingleton().GetEffectShader(pGrid->m_nEffectShaderID);
-					if(pEffect)
-					{
-						ID3DXEffect* pD3DEffect = pEffect->GetEffect();
-						if(pD3DEffect)
-						{
-							nVertexSize = sizeof(CPolyGridEffectVertex); 
-
-							RTexture* pRTexture = (RTexture*)pBaseTex->m_pRenderData;
-							pD3DEffect->SetTexture("texture0", pRTexture->m_pD3DTexture);
-
-							if(bEnvMap)
-							{
-								pRTexture = (RTexture*)pEnvMapTex->m_pRenderData;
-								pD3DEffect->SetTexture("texture1", pRTexture->m_pD3DTexture);
-							}
-
-						}
-					}else
-#endif // LTJS_USE_D3DX9
-					{
-						d3d_SetTexture(pBaseTex, 0, eFS_PolyGridBaseTexMemory);
-
-						if(bEnvMap)
-						{
-							d3d_SetTexture(pEnvMapTex, 1, eFS_PolyGridEnvMapTexMemory);
-						}
-					}
-				}
-			}
-			else
-			{
-				//if we didn't set any texture, we need to make sure and clear out the texture
-				//channel
-				d3d_DisableTexture(0);
-			}
-		}
-	}
-
-	//specify that we were visible
-	pGrid->m_Flags |= FLAG_INTERNAL1;
-
-	// Build the vertex list.
-	uint32 nBufferSize = pGrid->m_Width * pGrid->m_Height * nVertexSize;
-	if(nBufferSize > g_TriVertListSize)
-	{
-		//we need to reallocate our list of vertices
-		dfree(g_TriVertList);
-		LT_MEM_TRACK_ALLOC(g_TriVertList = dalloc(nBufferSize),LT_MEM_TYPE_RENDERER);
-
-		//check the allocation
-		if(!g_TriVertList)
-		{
-			g_TriVertListSize = 0;
-			return;
-		}
-
-		g_TriVertListSize = nBufferSize;
-	}
-
-	//determine if this polygrid should be lit or not
-	bool bFresnel = (pGrid->m_nPGFlags & PG_FRESNEL) && (g_CV_FresnelPolyGrids.m_Val) ? true : false;
-
-	//determine what alpha value we should use
-	uint8 nColorAlpha = 0;
-	if(!bEnvMap)
-		nColorAlpha = 255;
-	else if(!bFresnel)
-		nColorAlpha = 128;
-
-	float fScaledR = pGrid->m_ColorR * MATH_ONE_OVER_255;
-	float fScaledG = pGrid->m_ColorG * MATH_ONE_OVER_255;
-	float fScaledB = pGrid->m_ColorB * MATH_ONE_OVER_255;
-
-	uint32 nColorTable[256];
-	for(uint32 nCurrColor = 0; nCurrColor < 256; nCurrColor++)
-	{
-		//Note that the color table is 0..255, object color is 0..255 as well
-		nColorTable[nCurrColor] = D3DRGBA_255(	pGrid->m_ColorTable[nCurrColor].x * fScaledR,
-												pGrid->m_ColorTable[nCurrColor].y * fScaledG,
-												pGrid->m_ColorTable[nCurrColor].z * fScaledB,
-												nColorAlpha);
-	}
-
-	//setup our world matrix to represent a space that holds the orientation of the polygrid
-	//as well as the center position. This allows all operations to take place
-	//as if performed on the XZ plane (note that we don't do the scale as that tends
-	//to mess up normals)
-	LTMatrix mWorldTrans;
-	LTVector vUnitScale(1.0f, 1.0f, 1.0f);
-	d3d_SetupTransformation(&pGrid->GetPos(), (float*)&pGrid->m_Rotation, &vUnitScale, &mWorldTrans);
-	d3d_SetD3DMat(D3DTS_WORLD, &mWorldTrans);
-
-	//calculate our position increments
-	float fXInc			= pGrid->GetDims().x * 2.0f / (pGrid->m_Width - 1);
-	float fZInc			= pGrid->GetDims().z * 2.0f / (pGrid->m_Height - 1);
-	float fYScale		= pGrid->GetDims().y / 127.0f;
-
-	float fXStart		= -fHalfGridWidth * fXInc;
-	float fCurrX		= fXStart;
-	float fCurrZ		= -fHalfGridHeight * fZInc;
-
-
-	int8* pDataPos		= (int8*)pGrid->m_Data;
-	int8* pDataEnd		= pDataPos + pGrid->m_Width * pGrid->m_Height;
-	int8* pLineDataEnd	= pDataPos + pGrid->m_Width;
-
-	uint32* pColor		= nColorTable + 128;
-
-	float fXScale		= pGrid->m_xScale / ((pGrid->m_Width - 1) * fXInc);
-	float fZScale		= pGrid->m_yScale / ((pGrid->m_Height - 1) * fZInc);
-
-	float fStartU		= (float)fmod(pGrid->m_xPan * fPGUScale, 1.0f);
-	float fStartV		= (float)fmod(pGrid->m_yPan * fPGVScale, 1.0f);
-
-	float fCurrU		= fStartU;
-	float fCurrV		= fStartV;
-
-	float fUInc			= fXInc * fXScale * fPGUScale;
-	float fVInc			= fZInc * fZScale * fPGVScale;
-
-	int32 nWidth		= pGrid->m_Width;
-	float fSpacingX		= fXInc * 2.0f;
-	float fSpacingZ		= fZInc * 2.0f;
-
-	uint32 nNumVerts;
-
-	bool bEffect = false;
-
-#if LTJS_USE_D3DX9
-	LTEffectImpl* pEffect = (LTEffectImpl*)LTEffectShaderMgr::GetSingleton().GetEffectShader(pGrid->m_nEffectShaderID);
-	if(pEffect)
-	{
-		ID3DXEffect* pD3DEffect = pEffect->GetEffect();
-		if(pD3DEffect)
-		{
-			bEffect = true;
-		}
-	}
-#endif // LTJS_USE_D3DX9
-
-	if(bBumpMap)
+	uint32 nNumVerts;
+
+	if(bBumpMap)
 	{
 		CPolyGridBumpVertex* pVertexPos = (CPolyGridBumpVertex*)g_TriVertList;
 
@@ -1044,7 +1232,7 @@ void d3d_DrawPolyGrid(const ViewParams &Params, LTObject *pObj)
 			}
 
 			//now we need to generate the normals for the polygrid
-			GeneratePolyGridVectors(pGrid, (CPolyGridBumpVertex*)g_TriVertList, GenerateBasisSpace);
+			GeneratePolyGridVectors(pGrid, (CPolyGridBumpVertex*)g_TriVertList, GenerateBasisSpace, GenerateBasisSpaceRow);
 		}
 	}
 	else if(bEffect)
@@ -1155,13 +1343,13 @@ void d3d_DrawPolyGrid(const ViewParams &Params, LTObject *pObj)
 				ID3DXEffect* pD3DEffect = pEffect2->GetEffect();
 				if(pD3DEffect)
 				{
-					GeneratePolyGridVectors(pGrid, (CPolyGridEffectVertex*)g_TriVertList, GenerateEffectBasisSpace);
+					GeneratePolyGridVectors(pGrid, (CPolyGridEffectVertex*)g_TriVertList, GenerateEffectBasisSpace, GenerateEffectBasisSpaceRow);
 				}
 			}
 			else
 #endif // LTJS_USE_D3DX9
 			{
-				GeneratePolyGridVectors(pGrid, (CPolyGridVertex*)g_TriVertList, GenerateNormal);
+				GeneratePolyGridVectors(pGrid, (CPolyGridVertex*)g_TriVertList, GenerateNormal, GenerateNormalRow);
 			}
 		}
 	}
@@ -1273,17 +1461,328 @@ void d3d_DrawPolyGrid(const ViewParams &Params, LTObject *pObj)
 				ID3DXEffect* pD3DEffect = pEffect3->GetEffect();
 				if(pD3DEffect)
 				{
-					GeneratePolyGridVectors(pGrid, (CPolyGridEffectVertex*)g_TriVertList, GenerateEffectBasisSpace);
+					GeneratePolyGridVectors(pGrid, (CPolyGridEffectVertex*)g_TriVertList, GenerateEffectBasisSpace, GenerateEffectBasisSpaceRow);
 				}
 			}
 			else
 #endif // LTJS_USE_D3DX9
 			{
-				GeneratePolyGridVectors(pGrid, (CPolyGridVertex*)g_TriVertList, GenerateNormal);
+				GeneratePolyGridVectors(pGrid, (CPolyGridVertex*)g_TriVertList, GenerateNormal, GenerateNormalRow);
 			}
 		}
 	}
 
+	return nNumVerts;
+}
+
+
+void d3d_DrawPolyGrid(const ViewParams &Params, LTObject *pObj)
+{
+	//the global pixel shader to be used for the water bumpmapping and a flag indicating if
+	//creation failed
+	bool				s_bPixelShaderFailed = false;
+
+	//make sure that the polygrid is valid
+	assert(pObj);
+
+	//get our polygrid
+    LTPolyGrid *pGrid = (LTPolyGrid*)pObj;
+
+	// Make sure it's initialized.
+	if(!pGrid->m_Data)
+		return;
+
+	//must have an index buffer
+	if(!pGrid->m_Indices || (pGrid->m_nIndices == 0))
+		return;
+
+	//and of course, make sure that the size is reasonable
+	if((pGrid->m_Width < 2) || (pGrid->m_Height < 2))
+		return;
+
+	IncFrameStat(eFS_PolyGridTriangles, pGrid->m_nTris);
+
+	//now we need to build our color lookup table for this polygrid, this is faster for any
+	//polygrid that is larger than 8x8, and even then we can get a nice tight loop that
+	//should still be rather optimal
+
+	// Set the blending mode based on the flags.
+	uint32 nSrcBlend, nDestBlend, nFog, nFogColor;
+	d3d_GetBlendStates(pGrid, nSrcBlend, nDestBlend, nFog, nFogColor);
+	StateSet ssSrcBlend(D3DRS_SRCBLEND, nSrcBlend);
+	StateSet ssDestBlend(D3DRS_DESTBLEND, nDestBlend);
+	StateSet ssFog(D3DRS_FOGENABLE, nFog);
+	StateSet ssFogColor(D3DRS_FOGCOLOR, nFogColor);
+
+	//flag indicating whether or not
+	bool bEnvMap		= false;
+	bool bCubicEnvMap	= false;
+	bool bBumpMap		= false;
+
+	//vertex information
+	uint32 nVertexSize  = sizeof(CPolyGridVertex);
+	uint32 nVertexFVF	= POLYGRIDVERTEX_FORMAT;
+
+	//UV scales to adjust the texture by (defaults to 1, but if we are bump mapping, this will
+	//be set to the detail texture scale)
+	float	fPGUScale	= 1.0f;
+	float	fPGVScale	= 1.0f;
+
+	// Set the texture if necessary.
+	SpriteTracker* pTracker = nullptr;
+
+	LTPixelShader *pPixelShader = NULL;
+
+	if(pGrid->m_pSprite)
+	{
+		pTracker = &pGrid->m_SpriteTracker;
+		if(pTracker->m_pCurFrame)
+		{
+			SharedTexture* pTex = pTracker->m_pCurFrame->m_pTex;
+			if(pTex)
+			{
+				//get the type of this texture
+				ESharedTexType eTexType = pTex->m_eTexType;
+                static_cast<void>(eTexType);
+
+				//the base texture
+				SharedTexture* pBaseTex		= NULL;
+				//the environment map
+				SharedTexture* pEnvMapTex	= pGrid->m_pEnvMap;
+				//the bumpmap
+				SharedTexture* pBumpMapTex	= NULL;
+
+				//determine our texture data
+				if(pGrid->m_nPGFlags & PG_NORMALMAPSPRITE)
+				{
+					//only use a bump map texture if we actually have an environment map
+					if(pEnvMapTex)
+						pBumpMapTex	= pTex;
+				}
+				else
+				{
+					//we have a normal texture
+					pBaseTex	= pTex;
+				}
+
+				// Set up the environment mapping texture if applicable
+				if(	pEnvMapTex && g_CV_EnvMapPolyGrids.m_Val)
+				{
+					//see if the is a cubic environment map
+					RTexture *pRenderTexture = (RTexture*)pEnvMapTex->m_pRenderData;
+					if(pRenderTexture && pRenderTexture->IsCubeMap())
+					{
+						bCubicEnvMap = true;
+					}
+
+					bEnvMap = true;
+				}
+
+				if(	pBumpMapTex && g_CV_BumpMapPolyGrids.m_Val)
+				{
+					//we now need to make sure that the bump map shader is valid
+
+					//see if we need to load it
+					if (!s_bPixelShaderFailed)
+					{
+#if LTJS_USE_D3DX9
+						// Get the pixel shader.
+						pPixelShader = LTPixelShaderMgr::GetSingleton().GetPixelShader(LTPixelShader::PIXELSHADER_ENVBUMPMAP);
+						if (NULL == pPixelShader)
+						{
+							FileRef ref;
+							ref.m_FileType 	= FILE_ANYFILE;
+							ref.m_pFilename = "ps\\envbumpmap.psh";
+
+							// Try to load it.
+							ILTStream *pStream = g_pIClientFileMgr->OpenFile(&ref);
+							if (NULL != pStream)
+							{
+								if (LTPixelShaderMgr::GetSingleton().AddPixelShader(pStream, ref.m_pFilename,
+																					LTPixelShader::PIXELSHADER_ENVBUMPMAP, true))
+								{
+									pPixelShader = LTPixelShaderMgr::GetSingleton().GetPixelShader(LTPixelShader::PIXELSHADER_ENVBUMPMAP);
+								}
+
+								// Close the file.
+								pStream->Release();
+							}
+						}
+#endif // LTJS_USE_D3DX9
+					}
+
+					// See if we can continue.
+					if (NULL != pPixelShader && pPixelShader->IsValidShader())
+					{
+						bBumpMap	= true;
+						nVertexSize = sizeof(CPolyGridBumpVertex);
+						nVertexFVF	= POLYGRIDBUMPVERTEX_FORMAT;
+						fPGUScale	= ((RTexture*)pBumpMapTex->m_pRenderData)->m_DetailTextureScale;
+						fPGVScale	= fPGUScale;
+					}
+					else
+					{
+						//we failed to create the shader, the device can't support it
+						s_bPixelShaderFailed = true;
+					}
+				}
+
+				//setup the textures based upon the configuration
+				if(bBumpMap)
+				{
+					d3d_SetTexture(pBumpMapTex, 0, eFS_PolyGridBumpMapTexMemory);
+					d3d_SetTexture(pEnvMapTex, 3, eFS_PolyGridEnvMapTexMemory);
+				}
+				else
+				{
+#if LTJS_USE_D3DX9
+					LTEffectImpl* pEffect = (LTEffectImpl*)LTEffectShaderMgr::GetSingleton().GetEffectShader(pGrid->m_nEffectShaderID);
+					if(pEffect)
+					{
+						ID3DXEffect* pD3DEffect = pEffect->GetEffect();
+						if(pD3DEffect)
+						{
+							nVertexSize = sizeof(CPolyGridEffectVertex); 
+
+							RTexture* pRTexture = (RTexture*)pBaseTex->m_pRenderData;
+							pD3DEffect->SetTexture("texture0", pRTexture->m_pD3DTexture);
+
+							if(bEnvMap)
+							{
+								pRTexture = (RTexture*)pEnvMapTex->m_pRenderData;
+								pD3DEffect->SetTexture("texture1", pRTexture->m_pD3DTexture);
+							}
+
+						}
+					}else
+#endif // LTJS_USE_D3DX9
+					{
+						d3d_SetTexture(pBaseTex, 0, eFS_PolyGridBaseTexMemory);
+
+						if(bEnvMap)
+						{
+							d3d_SetTexture(pEnvMapTex, 1, eFS_PolyGridEnvMapTexMemory);
+						}
+					}
+				}
+			}
+			else
+			{
+				//if we didn't set any texture, we need to make sure and clear out the texture
+				//channel
+				d3d_DisableTexture(0);
+			}
+		}
+	}
+
+	//specify that we were visible
+	pGrid->m_Flags |= FLAG_INTERNAL1;
+
+	//determine if this polygrid should be lit or not
+	bool bFresnel = (pGrid->m_nPGFlags & PG_FRESNEL) && (g_CV_FresnelPolyGrids.m_Val) ? true : false;
+
+	//determine what alpha value we should use
+	uint8 nColorAlpha = 0;
+	if(!bEnvMap)
+		nColorAlpha = 255;
+	else if(!bFresnel)
+		nColorAlpha = 128;
+
+	//setup our world matrix to represent a space that holds the orientation of the polygrid
+	//as well as the center position. This allows all operations to take place
+	//as if performed on the XZ plane (note that we don't do the scale as that tends
+	//to mess up normals)
+	LTMatrix mWorldTrans;
+	LTVector vUnitScale(1.0f, 1.0f, 1.0f);
+	d3d_SetupTransformation(&pGrid->GetPos(), (float*)&pGrid->m_Rotation, &vUnitScale, &mWorldTrans);
+	d3d_SetD3DMat(D3DTS_WORLD, &mWorldTrans);
+
+	bool bEffect = false;
+
+#if LTJS_USE_D3DX9
+	LTEffectImpl* pEffect = (LTEffectImpl*)LTEffectShaderMgr::GetSingleton().GetEffectShader(pGrid->m_nEffectShaderID);
+	if(pEffect)
+	{
+		ID3DXEffect* pD3DEffect = pEffect->GetEffect();
+		if(pD3DEffect)
+		{
+			bEffect = true;
+		}
+	}
+#endif // LTJS_USE_D3DX9
+
+	//see if the vertices from the last time this polygrid was drawn can be reused. The fresnel
+	//and bumpmap eye vectors depend upon where the camera is relative to the grid
+	bool bCameraDependent = bBumpMap || bFresnel;
+	LTVector vCameraPos(0.0f, 0.0f, 0.0f);
+	if(bCameraDependent)
+		vCameraPos = GetPolyGridCameraPos(Params.m_Pos, pGrid);
+
+	CPolyGridVertCache::SKey CacheKey;
+	memset(&CacheKey, 0, sizeof(CacheKey));
+	CacheKey.m_vDims				= pGrid->GetDims();
+	CacheKey.m_fXScale				= pGrid->m_xScale;
+	CacheKey.m_fYScale				= pGrid->m_yScale;
+	CacheKey.m_fXPan				= pGrid->m_xPan;
+	CacheKey.m_fYPan				= pGrid->m_yPan;
+	CacheKey.m_fUScale				= fPGUScale;
+	CacheKey.m_fVScale				= fPGVScale;
+	CacheKey.m_fFresnelVolumeIOR	= pGrid->m_fFresnelVolumeIOR;
+	CacheKey.m_fBaseReflection		= pGrid->m_fBaseReflection;
+	CacheKey.m_nWidth				= pGrid->m_Width;
+	CacheKey.m_nHeight				= pGrid->m_Height;
+	CacheKey.m_nVertexSize			= nVertexSize;
+	CacheKey.m_nVertexType			= bBumpMap ? 2 : (bEffect ? 1 : 0);
+	CacheKey.m_nColor				= D3DRGBA_255(pGrid->m_ColorR, pGrid->m_ColorG, pGrid->m_ColorB, nColorAlpha);
+	CacheKey.m_nFresnel			= bFresnel ? 1 : 0;
+
+	uint32 nNumVerts = 0;
+	const void* pVertList = NULL;
+
+	if(g_CV_PolyGridVertCache.m_Val)
+	{
+		pVertList = g_PolyGridVertCache.GetVerts(pGrid, CacheKey, bCameraDependent ? &vCameraPos : NULL, nNumVerts);
+	}
+
+	if(!pVertList)
+	{
+		uint32 nBufferSize = pGrid->m_Width * pGrid->m_Height * nVertexSize;
+		if(nBufferSize > g_TriVertListSize)
+		{
+			//we need to reallocate our list of vertices
+			dfree(g_TriVertList);
+			LT_MEM_TRACK_ALLOC(g_TriVertList = dalloc(nBufferSize),LT_MEM_TYPE_RENDERER);
+
+			//check the allocation
+			if(!g_TriVertList)
+			{
+				g_TriVertListSize = 0;
+				return;
+			}
+
+			g_TriVertListSize = nBufferSize;
+		}
+
+		nNumVerts = d3d_GeneratePolyGridVerts(pGrid, bBumpMap, bEffect, nColorAlpha, fPGUScale, fPGVScale);
+
+		//generate the alpha if we can use it
+		if(bBumpMap)
+		{
+			GeneratePolyGridFresnelAlphaAndCamera(vCameraPos, (CPolyGridBumpVertex*)g_TriVertList, pGrid, nNumVerts);
+		}
+		else if(bFresnel)
+		{
+			GeneratePolyGridFresnelAlpha(vCameraPos, (CPolyGridVertex*)g_TriVertList, pGrid, nNumVerts);
+		}
+
+		if(g_CV_PolyGridVertCache.m_Val)
+		{
+			g_PolyGridVertCache.SetVerts(g_TriVertList, nNumVerts, nVertexSize, vCameraPos);
+		}
+
+		pVertList = g_TriVertList;
+	}
+
 	// Set environment map texture coordinates.
 	if(bEnvMap && !bBumpMap)
 	{
@@ -1296,16 +1795,6 @@ void d3d_DrawPolyGrid(const ViewParams &Params, LTObject *pObj)
 		d3d_SetDefaultBlendStates();
 	}
 
-	//generate the alpha if we can use it
-	if(bBumpMap)
-	{
-		GeneratePolyGridFresnelAlphaAndCamera(Params.m_Pos, (CPolyGridBumpVertex*)g_TriVertList, pGrid, nNumVerts);
-	}
-	else if(bFresnel)
-	{
-		GeneratePolyGridFresnelAlpha(Params.m_Pos, (CPolyGridVertex*)g_TriVertList, pGrid, nNumVerts);
-	}
-
 	//make the backfacing polygons cull
 	StateSet ssCullMode(D3DRS_CULLMODE, (pGrid->m_nPGFlags & PG_NOBACKFACECULL) ? D3DCULL_NONE : D3DCULL_CCW);
 
@@ -1341,14 +1830,14 @@ void d3d_DrawPolyGrid(const ViewParams &Params, LTObject *pObj)
 			while(nRemainingPolies > 0)
 			{
 				uint32 nPoliesThisFrame = (nRemainingPolies > g_CV_PolyGridBufferSize) ? g_CV_PolyGridBufferSize: nRemainingPolies;
-				D3D_CALL(PD3DDEVICE->DrawIndexedPrimitiveUP(D3DPT_TRIANGLELIST,0,nNumVerts,nPoliesThisFrame,&pGrid->m_Indices[nCurrentVertPosition],D3DFMT_INDEX16,g_TriVertList, nVertexSize));
+				D3D_CALL(PD3DDEVICE->DrawIndexedPrimitiveUP(D3DPT_TRIANGLELIST,0,nNumVerts,nPoliesThisFrame,&pGrid->m_Indices[nCurrentVertPosition],D3DFMT_INDEX16,pVertList, nVertexSize));
 				nCurrentVertPosition += nPoliesThisFrame*3;
 				nRemainingPolies -= nPoliesThisFrame;
 			}
 		}
 		else
 		{
-			D3D_CALL(PD3DDEVICE->DrawIndexedPrimitiveUP(D3DPT_TRIANGLELIST,0,nNumVerts,(pGrid->m_nIndices)/3,pGrid->m_Indices,D3DFMT_INDEX16,g_TriVertList, nVertexSize));
+			D3D_CALL(PD3DDEVICE->DrawIndexedPrimitiveUP(D3DPT_TRIANGLELIST,0,nNumVerts,(pGrid->m_nIndices)/3,pGrid->m_Indices,D3DFMT_INDEX16,pVertList, nVertexSize));
 		}
 
 		// Uninstall the pixel shader.
@@ -1393,7 +1882,7 @@ void d3d_DrawPolyGrid(const ViewParams &Params, LTObject *pObj)
 						for(UINT i = 0; i < nPasses; ++i)
 						{
 							pD3DEffect->BeginPass(i);
-							D3D_CALL(PD3DDEVICE->DrawIndexedPrimitiveUP(D3DPT_TRIANGLELIST,0,nNumVerts,nPoliesThisFrame,&pGrid->m_Indices[nCurrentVertPosition],D3DFMT_INDEX16,g_TriVertList, nVertexSize));
+							D3D_CALL(PD3DDEVICE->DrawIndexedPrimitiveUP(D3DPT_TRIANGLELIST,0,nNumVerts,nPoliesThisFrame,&pGrid->m_Indices[nCurrentVertPosition],D3DFMT_INDEX16,pVertList, nVertexSize));
 							pD3DEffect->EndPass();
 						}
 
@@ -1404,7 +1893,7 @@ void d3d_DrawPolyGrid(const ViewParams &Params, LTObject *pObj)
 				else
 #endif // LTJS_USE_D3DX9
 				{
-					D3D_CALL(PD3DDEVICE->DrawIndexedPrimitiveUP(D3DPT_TRIANGLELIST,0,nNumVerts,nPoliesThisFrame,&pGrid->m_Indices[nCurrentVertPosition],D3DFMT_INDEX16,g_TriVertList, nVertexSize));
+					D3D_CALL(PD3DDEVICE->DrawIndexedPrimitiveUP(D3DPT_TRIANGLELIST,0,nNumVerts,nPoliesThisFrame,&pGrid->m_Indices[nCurrentVertPosition],D3DFMT_INDEX16,pVertList, nVertexSize));
 				}
 
 				nCurrentVertPosition += nPoliesThisFrame*3;
@@ -1430,7 +1919,7 @@ void d3d_DrawPolyGrid(const ViewParams &Params, LTObject *pObj)
 					for(UINT i = 0; i < nPasses; ++i)
 					{
 						pD3DEffect->BeginPass(i);
-						D3D_CALL(PD3DDEVICE->DrawIndexedPrimitiveUP(D3DPT_TRIANGLELIST,0,nNumVerts,(pGrid->m_nIndices)/3,pGrid->m_Indices,D3DFMT_INDEX16,g_TriVertList, nVertexSize));
+						D3D_CALL(PD3DDEVICE->DrawIndexedPrimitiveUP(D3DPT_TRIANGLELIST,0,nNumVerts,(pGrid->m_nIndices)/3,pGrid->m_Indices,D3DFMT_INDEX16,pVertList, nVertexSize));
 						pD3DEffect->EndPass();
 					}
 
@@ -1442,7 +1931,7 @@ void d3d_DrawPolyGrid(const ViewParams &Params, LTObject *pObj)
 #endif // LTJS_USE_D3DX9
 			{
 				// No Effect Shader, just fixed function.
-				D3D_CALL(PD3DDEVICE->DrawIndexedPrimitiveUP(D3DPT_TRIANGLELIST,0,nNumVerts,(pGrid->m_nIndices)/3,pGrid->m_Indices,D3DFMT_INDEX16,g_TriVertList, nVertexSize));
+				D3D_CALL(PD3DDEVICE->DrawIndexedPrimitiveUP(D3DPT_TRIANGLELIST,0,nNumVerts,(pGrid->m_nIndices)/3,pGrid->m_Indices,D3DFMT_INDEX16,pVertList, nVertexSize));
 			}
 			
 		}
@@ -1505,6 +1994,7 @@ void d3d_QueueTranslucentPolyGrids(const ViewParams& Params, ObjectDrawList& Dra
 void d3d_TermPolyGridDraw()
 {
 	dfree(g_TriVertList);
+	g_PolyGridVertCache.Free();
 
 	g_TriVertList = LTNULL;
 	g_TriVertListSize = 0;
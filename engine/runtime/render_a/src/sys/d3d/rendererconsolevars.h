@@ -99,6 +99,8 @@ RCONVAR(g_CV_DebugRBTime, "DebugRBTime", int, 0);
 RCONVAR(g_CV_DebugRBDraw, "DebugRBDraw", int, 1);
 RCONVAR(g_CV_DebugRBOldOccludeeShape, "DebugRBOldOccludeeShape", int, 0);
 RCONVAR(g_CV_DebugRBFindSlivers, "DebugRBFindSlivers", int, 0);
+RCONVAR(g_CV_RBOcclusionBuffer, "RBOcclusionBuffer", int, 1);
+RCONVAR(g_CV_DebugRBCompareOcclusion, "DebugRBCompareOcclusion", int, 0);
 //RCONVAR(g_CV_LockPVS, "LockPVS", int, 0);
 RCONVAR(g_CV_DisableRenderObjectGroups, "DisableRenderObjectGroups", int, 0);
 
@@ -246,6 +248,8 @@ RCONVAR(g_CV_EnvMapPolyGrids, "EnvMapPolyGrids", int, 1);
 RCONVAR(g_CV_BumpMapPolyGrids, "BumpMapPolyGrids", int, 1);
 RCONVAR(g_CV_FresnelPolyGrids, "FresnelPolyGrids", int, 1);
 RCONVAR(g_CV_PolyGridBufferSize, "PolyGridBufferSize", int, 2048);
+RCONVAR(g_CV_PolyGridVertCache, "PolyGridVertCache", int, 1);
+RCONVAR(g_CV_PolyGridVertCacheCameraDist, "PolyGridVertCacheCameraDist", float, 0.5f);
 
 //------------------------------
 // VolumeEffect Settings
@@ -10,6 +10,7 @@
 #include "rendererframestats.h"
 #include "..\shadows\d3dshadowtexture.h"
 #include "ltpixelshadermgr.h"
+#include "workerpool.h"
 #include <algorithm>
 
 //------------------------------------------------------------------
@@ -18,6 +19,18 @@
 
 #define MAX_SHADOW_TEXTURES 8
 
+//the scoring and projection setup passes are only split across threads for at least this many shadows
+#define SHADOW_THREAD_MIN_SHADOWS	64
+#define SHADOW_MAX_BANDS			8
+
+//runs Func(nStart, nEnd) over [0, nCount) on the worker pool when the list is large enough. Each shadow
+//must only depend on itself, so the results don't depend on how the list is split
+template<class F>
+static void ForEachShadowBand(uint32 nCount, F Func)
+{
+	wp_ForEachBand(nCount, (nCount >= SHADOW_THREAD_MIN_SHADOWS) ? SHADOW_MAX_BANDS : 1, Func);
+}
+
 //------------------------------------------------------------------
 // Holders and their headers.
 //------------------------------------------------------------------
@@ -805,6 +818,16 @@ float CRenderShadowList::CalcScore(const ViewParams& Params, const SQueuedShadow
 	return fScore;
 }
 
+//finds the bounds of the model and its attachments and builds the light's frame of reference
+//for a queued shadow
+void CRenderShadowList::SetupShadowProjection(SQueuedShadow& Shadow)
+{
+	FindBoundingInfo(Shadow.m_pInstance, Shadow.m_vModelPos, Shadow.m_vLightPos, Shadow.m_vLightDir, Shadow.m_vProjCenter, Shadow.m_fProjSize);
+	Shadow.m_fProjSize *= 2.0f;
+
+	BuildLightRefFrame(Shadow.m_vLightDir, Shadow.m_vLightUp, Shadow.m_vLightRight);
+}
+
 //this will render all shadows in the queue to the world and flush it
 void CRenderShadowList::RenderQueuedShadows(const ViewParams& Params)
 {
@@ -819,13 +842,21 @@ void CRenderShadowList::RenderQueuedShadows(const ViewParams& Params)
 		if(nShadowsToRender)
 		{
 			//calculate the score for all shadows
-			for(uint32 nCurrShadow = 0; nCurrShadow < m_cShadowList.size(); nCurrShadow++)
+			ForEachShadowBand(m_cShadowList.size(), [this, &Params](uint32 nStart, uint32 nEnd)
 			{
-				m_cShadowList[nCurrShadow].m_fScore = CalcScore(Params, m_cShadowList[nCurrShadow]);
-			}
+				for(uint32 nCurrShadow = nStart; nCurrShadow < nEnd; nCurrShadow++)
+				{
+					m_cShadowList[nCurrShadow].m_fScore = CalcScore(Params, m_cShadowList[nCurrShadow]);
+				}
+			});
 
-			//we need to limit the shadows, so sort them
-			sort(m_cShadowList.begin(), m_cShadowList.end());
+			//we need to limit the shadows, so pull the best ones to the front and only sort those
+			TShadowList::iterator itLast = m_cShadowList.begin() + nShadowsToRender;
+			if(itLast != m_cShadowList.end())
+			{
+				nth_element(m_cShadowList.begin(), itLast, m_cShadowList.end());
+			}
+			sort(m_cShadowList.begin(), itLast);
 		}
 	}
 	else
@@ -899,6 +930,16 @@ void CRenderShadowList::RenderQueuedShadows(const ViewParams& Params)
 	D3D_CALL(PD3DDEVICE->GetDepthStencilSurface(&pDepthStencilBuffer));
 	D3D_CALL(PD3DDEVICE->GetRenderTarget(&pPrevRenderTarget));
 
+	//figure out the projection of every shadow we are going to render before touching the device,
+	//this is needed by both the texture and the world passes
+	ForEachShadowBand(nShadowsToRender, [this](uint32 nStart, uint32 nEnd)
+	{
+		for(uint32 nCurrShadow = nStart; nCurrShadow < nEnd; nCurrShadow++)
+		{
+			SetupShadowProjection(m_cShadowList[nCurrShadow]);
+		}
+	});
+
 	//the current shadow tex that we want to render to
 	uint32 nCurrShadowTex = 0;
 	uint32 nNumShadowTex = m_cTextureList.size();
@@ -1065,25 +1106,14 @@ void CRenderShadowList::RenderTexturesOnWorld(const ViewParams& Params, uint32 n
 		ModelInstance* pInstance = ShadowInfo.m_pInstance;
 		assert(pInstance);
 
-		LTVector vModelPos  = ShadowInfo.m_vModelPos;
-
 		float fModelRadius	= pInstance->GetDims().Mag( );
-		float fSize			= fModelRadius * 2.0f;
 
 		//now that we have all the shadow textures ready, we must now run through and actually
 		//render the additional passes on the world
-		LTVector vLightPos(ShadowInfo.m_vLightPos);
-		LTVector vLightColor(ShadowInfo.m_vColor);
-
-		LTVector vLightDir = vModelPos - vLightPos;
-		vLightDir.Normalize();
-
-		FindBoundingInfo(pInstance, ShadowInfo.m_vModelPos, vLightPos, vLightDir, vModelPos, fSize);
-		fSize *= 2.0f;
-
-		// Setup the frame of reference
-		LTVector vLightUp, vLightRight;
-		BuildLightRefFrame(vLightDir, vLightUp, vLightRight);
+		const LTVector& vLightPos	= ShadowInfo.m_vLightPos;
+		const LTVector& vLightDir	= ShadowInfo.m_vLightDir;
+		const LTVector& vModelPos	= ShadowInfo.m_vProjCenter;
+		float fSize					= ShadowInfo.m_fProjSize;
 
 		//determine the texture that we should use
 		uint32 nTextureIndex = nCurrShadow - nStart;
@@ -1105,8 +1135,8 @@ void CRenderShadowList::RenderTexturesOnWorld(const ViewParams& Params, uint32 n
 		// Setup the frame of reference (up is (0,1,0) and right is generated).
 		ShadowLightInfo info;
 
-		info.m_Vecs[0]					= vLightRight;
-		info.m_Vecs[1]					= vLightUp;
+		info.m_Vecs[0]					= ShadowInfo.m_vLightRight;
+		info.m_Vecs[1]					= ShadowInfo.m_vLightUp;
 		info.m_Vecs[2]					= vLightDir;
 
 		info.m_fSizeX					= fSize;
@@ -1348,33 +1378,17 @@ bool CRenderShadowList::RenderShadowTexture(uint32 nShadow, uint32 nTexture)
 	SQueuedShadow&		ShadowInfo = m_cShadowList[nShadow];
 	ModelInstance*		pInstance = ShadowInfo.m_pInstance;
 
-	LTVector vModelPos  = pInstance->GetPos();
-
 	//disable lighting
 	for (uint32 i = 0; i < 8; ++i)
 		g_RenderStateMgr.LightEnable(i, false);
 
-	//	COMPUTE MODEL SHADOW LOD AND SIZE
-	float fModelRadius	= pInstance->GetDims().Mag();
-	float fSize			= fModelRadius * 2.0f;
-
-	LTVector vLightPos(ShadowInfo.m_vLightPos);
-	LTVector vLightColor(ShadowInfo.m_vColor);
-
-	LTVector vLightDir = vModelPos - vLightPos;
-	vLightDir.Normalize();
-
-	FindBoundingInfo(pInstance, ShadowInfo.m_vModelPos, vLightPos, vLightDir, vModelPos, fSize);
-	fSize *= 2.0f;
-
-	// Setup the frame of reference
-	LTVector vLightUp, vLightRight;
-	BuildLightRefFrame(vLightDir, vLightUp, vLightRight);
+	//the projection was set up in RenderQueuedShadows
+	float fSize			= ShadowInfo.m_fProjSize;
 
 	// For drawing the projection frustum...
 	if (g_CV_ModelShadow_Proj_DrawProjPlane.m_Val)
 	{
-		DrawLightPlanes(vModelPos, vLightPos, vLightUp, vLightRight, fSize);
+		DrawLightPlanes(ShadowInfo.m_vProjCenter, ShadowInfo.m_vLightPos, ShadowInfo.m_vLightUp, ShadowInfo.m_vLightRight, fSize);
 	}
 
 	// Set the ShadowTexture as the render target...
@@ -1386,7 +1400,7 @@ bool CRenderShadowList::RenderShadowTexture(uint32 nShadow, uint32 nTexture)
 		// Render the Model onto the texture...
 		if (PD3DDEVICE->SetRenderTarget(pTextureRenderSurface, NULL) == D3D_OK)
 		{
-			RenderModelShadow(pInstance, ShadowInfo.m_vModelPos, vLightPos, vLightDir, vLightUp, vLightColor, m_nTextureRes, fSize, fSize, !ShadowInfo.m_bOrtho);
+			RenderModelShadow(pInstance, ShadowInfo.m_vModelPos, ShadowInfo.m_vLightPos, ShadowInfo.m_vLightDir, ShadowInfo.m_vLightUp, ShadowInfo.m_vColor, m_nTextureRes, fSize, fSize, !ShadowInfo.m_bOrtho);
 		}
 
 		// Reset the render target...
@@ -1432,6 +1446,7 @@ void CRenderShadowList::QueueShadow(ModelInstance* pInstance, const LTVector& vM
 	Shadow.m_vLightPos	= vFinalLightPos;
 	Shadow.m_vColor		= vColor * fAlpha;
 	Shadow.m_bOrtho		= bOrtho;
+	Shadow.m_nQueueIndex = m_cShadowList.size();
 
 	m_cShadowList.push_back(Shadow);
 }
@@ -65,18 +65,35 @@ private:
 		LTVector		m_vLightPos;
 		bool			m_bOrtho;
 
+		//the order the shadow was queued in, used to break ties in the score so the selected
+		//shadows don't depend on how the list was partitioned
+		uint32			m_nQueueIndex;
+
 		//parameters for sorting based upon the score
 		bool operator<(const SQueuedShadow& rhs) const
 		{
-			return m_fScore > rhs.m_fScore;
+			if(m_fScore != rhs.m_fScore)
+				return m_fScore > rhs.m_fScore;
+			return m_nQueueIndex < rhs.m_nQueueIndex;
 		}
 
 		float			m_fScore;
+
+		//the projection frame, filled in by SetupShadowProjection for the shadows that will be rendered
+		LTVector		m_vLightDir;
+		LTVector		m_vLightUp;
+		LTVector		m_vLightRight;
+		LTVector		m_vProjCenter;
+		float			m_fProjSize;
 	};
 
 	//calculates the score for a queued shadow
 	float	CalcScore(const ViewParams& Params, const SQueuedShadow& rhs);
 
+	//finds the bounds of the model and its attachments and builds the light's frame of reference
+	//for a queued shadow
+	void	SetupShadowProjection(SQueuedShadow& Shadow);
+
 	typedef vector<SQueuedShadow>		TShadowList;
 	TShadowList							m_cShadowList;
 
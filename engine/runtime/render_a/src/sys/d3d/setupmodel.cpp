@@ -47,6 +47,9 @@ define_holder(IFindObj, g_pIFindObj);
 // Globals.
 // --------------------------------------------------------------- //
 
+// Animation LOD threshold, see engine_vars.cpp.
+extern float g_CV_ModelAnimLODScreenSize;
+
 // The model drawer..
 ModelDraw g_ModelDraw;
 
@@ -69,6 +72,20 @@ void d3d_QueueModel(const ViewParams& Params, LTObject *pObject)
 
 	ModelInstance *pModel = (ModelInstance*)pObject;
 
+	//record how big the model is on screen for the animation LOD in the client update. Any view
+	//that draws it counts, so keep the largest
+	float fDist = (pModel->GetPos() - Params.m_Pos).Mag();
+	float fScreenSize = (fDist > pModel->GetRadius()) ? pModel->GetRadius() * Params.m_mProjection.m[1][1] / fDist : 1.0f;
+	pModel->m_fAnimLODScreenSize = LTMAX(pModel->m_fAnimLODScreenSize, fScreenSize);
+
+	//the hold was decided from the size it was drawn at last frame. If it's now big enough to animate
+	//every frame (a camera cut or a zoom), drop the hold so this frame already draws the current pose
+	if(pModel->m_bAnimLODHoldPose && (fScreenSize >= g_CV_ModelAnimLODScreenSize))
+	{
+		pModel->m_bAnimLODHoldPose = false;
+		pModel->ResetCachedPose();
+	}
+
     if(!pModel->m_AnimTracker.IsValid())
 		return;
 
@@ -17,9 +17,9 @@
 #include "smoveabstract.h"
 #include "interlink.h"
 #include "systimer.h"
+#include "syscounter.h"
 #include "ltobjectcreate.h"
-
-#include <vector>
+#include "serializearena.h"
 
 //------------------------------------------------------------------
 //------------------------------------------------------------------
@@ -82,6 +82,8 @@ static uint32 __GS__dwCRC;  // Used in macros below...
 
 uint32 g_dwSaveFileVersion = 2002;
 
+extern int32 g_CV_ShowSaveTiming;
+
 static uint32 s_dwCurRestoreObject = 0;
 static uint32 s_dwNumRestoreObjects = 0;
 
@@ -304,45 +306,8 @@ namespace
 // Objects larger than this size are considered "suspicious" and spit out a warning.
 const uint32 	k_nSuspiciousObjectSize = 0x10000; // 64k
 
-//////////////////////////////////////////////////////////////////////////////
-// Internal serialization buffer
-// This is a static buffer used by the serialization routines so they can
-// avoid allocations from the stack without having to constantly hit the heap
-
-uint8* 			s_pTempBuffer 		= NULL;
-unsigned		s_nTempBufferSize 	= k_nSuspiciousObjectSize;
-
-void DeleteTempBuffer()
-{
-	// Delete the old buffer.
-	if (LTNULL != s_pTempBuffer)
-	{
-		delete [] s_pTempBuffer;
-		s_pTempBuffer = LTNULL;
-	}
-}
-
-void CreateTempBuffer(unsigned BufSize)
-{
-	DeleteTempBuffer();
-
-	// Allocate the new buffer.
-	LT_MEM_TRACK_ALLOC(s_pTempBuffer = new uint8[BufSize], LT_MEM_TYPE_MISC);
-	ASSERT(LTNULL != s_pTempBuffer);
-
-	// Reset the buffer size.
-	s_nTempBufferSize = BufSize;
-}
-
-void AdjustTempBufferSize(unsigned NewBufSize)
-{
-	if (NewBufSize > s_nTempBufferSize)
-	{
-		DeleteTempBuffer();
-		CreateTempBuffer(NewBufSize);
-	}
-}
-
+// Size of the last save, used to size the next save's arena up front.
+uint32			s_nLastSaveSize 	= 0x40000; // 256k
 
 } // unnamed namespace
 
@@ -352,7 +317,7 @@ void AdjustTempBufferSize(unsigned NewBufSize)
 // Internal helpers.
 // ----------------------------------------------------------------------------- //
 
-static void sm_SaveObjectData(LTObject *pObj, ILTStream *pStream, uint32 dwParam)
+static void sm_SaveObjectData(LTObject *pObj, CSerializeArena *pStream, uint32 dwParam)
 {
     // Make space for the 'next object' indicator.
     uint32 curPos = 0;
@@ -498,11 +463,7 @@ static void sm_SaveObjectData(LTObject *pObj, ILTStream *pStream, uint32 dwParam
 		uint16 nTemp = (uint16)nSpecialEffectLen;
         GS_STREAM_WRITE(nTemp);
 
-		// Make sure our buffer is large enough.
-		AdjustTempBufferSize(nSpecialEffectLen);
-
-		pObj->sd->m_cSpecialEffectMsg.PeekData(s_pTempBuffer, nSpecialEffectLen);
-        pStream->Write(s_pTempBuffer, (nSpecialEffectLen + 7) / 8);
+		pObj->sd->m_cSpecialEffectMsg.PeekData(pStream->WriteInPlace((nSpecialEffectLen + 7) / 8), nSpecialEffectLen);
     }
 
 	//write out the animation trackers if applicable
@@ -584,14 +545,10 @@ static void sm_SaveObjectData(LTObject *pObj, ILTStream *pStream, uint32 dwParam
     GS_STREAM_WRITE(curPos);
     pStream->SeekTo(curPos);
 
-	// Make sure our buffer is large enough.
-	AdjustTempBufferSize(nObjectMsgLen);
-
 	// Write out the object save packet
-	CPacket_Read cSaveMessage_Read(cSaveMessage.GetPacket());
-	cSaveMessage_Read.ReadData(s_pTempBuffer, nObjectMsgLen);
 	GS_STREAM_WRITE(nObjectMsgLen);
-	pStream->Write(s_pTempBuffer, (nObjectMsgLen + 7) / 8);
+	CPacket_Read cSaveMessage_Read(cSaveMessage.GetPacket());
+	cSaveMessage_Read.ReadData(pStream->WriteInPlace((nObjectMsgLen + 7) / 8), nObjectMsgLen);
 
     pStream->WriteVal((uint32)GAMESERIALIZE_CRC);
 
@@ -605,7 +562,7 @@ static void sm_SaveObjectData(LTObject *pObj, ILTStream *pStream, uint32 dwParam
 // ------------------------------------------------------------------------
 // CreateObject from a file.
 // ------------------------------------------------------------------------
-static LTRESULT sm_CreateNextObject(ILTStream *pStream,
+static LTRESULT sm_CreateNextObject(CSerializeArena *pStream,
 									LTObject  **pOut,
 									uint32 dwParam)
 {
@@ -745,13 +702,14 @@ static LTRESULT sm_CreateNextObject(ILTStream *pStream,
 	    uint16 messageLen;
         GS_STREAM_READ(messageLen);
 
-		// Make sure our buffer is large enough.
-		AdjustTempBufferSize(messageLen);
+		const uint8 *pMessageData = pStream->ReadInPlace((messageLen + 7) / 8);
+		if (!pMessageData)
+		{
+			RETURN_ERROR_PARAM(1, sm_CreateNextObject, LT_INVALIDFILE, className);
+		}
 
-		uint32 nMessageBytes = (messageLen + 7) / 8;
-		pStream->Read(s_pTempBuffer, nMessageBytes);
 		CPacket_Write cTempMsg;
-		cTempMsg.WriteData(s_pTempBuffer, messageLen);
+		cTempMsg.WriteData(pMessageData, messageLen);
 		pObj->sd->m_cSpecialEffectMsg = CPacket_Read(cTempMsg);
     }
 
@@ -877,7 +835,7 @@ static LTRESULT sm_CreateNextObject(ILTStream *pStream,
 }
 
 
-static LTRESULT sm_RestoreNextObject(ILTStream *pStream, LTObject *pObj, uint32 dwParam)
+static LTRESULT sm_RestoreNextObject(CSerializeArena *pStream, LTObject *pObj, uint32 dwParam)
 {
     // Next position indicators.
 	uint32 nextObjectPos;
@@ -898,13 +856,14 @@ static LTRESULT sm_RestoreNextObject(ILTStream *pStream, LTObject *pObj, uint32
 	uint32 nObjectMsgLen;
 	GS_STREAM_READ(nObjectMsgLen);
 
-	// Make sure our buffer is large enough.
-	AdjustTempBufferSize(nObjectMsgLen);
+	const uint8 *pObjectMsgData = pStream->ReadInPlace((nObjectMsgLen + 7) / 8);
+	if (!pObjectMsgData)
+	{
+		RETURN_ERROR_PARAM(1, sm_RestoreNextObject, LT_INVALIDFILE, className);
+	}
 
-	uint32 nObjectMsgBytes = (nObjectMsgLen + 7) / 8;
-	pStream->Read(s_pTempBuffer, nObjectMsgBytes);
 	CPacket_Write cTempMsg;
-	cTempMsg.WriteData(s_pTempBuffer, nObjectMsgLen);
+	cTempMsg.WriteData(pObjectMsgData, nObjectMsgLen);
 
     // Tell them to process their serialize message.
 	// Make sure nobody tries to free this message, since it's not allocated dynamically
@@ -1088,7 +1047,7 @@ static LTRESULT sm_RestoreInterlinks(LTObject *pObject, ILTStream *pStream,
 // ----------------------------------------------------------------------------- //
 
 
-void sm_SaveObjects(ILTStream *pStream, ObjectList *pList, uint32 dwParam, uint32 flags)
+void sm_SaveObjects(ILTStream *pFileStream, ObjectList *pList, uint32 dwParam, uint32 flags)
 {
     unsigned long terminator;
     LTObject *pObj;
@@ -1101,17 +1060,19 @@ void sm_SaveObjects(ILTStream *pStream, ObjectList *pList, uint32 dwParam, uint3
     LTObject **pObjects;
     int nObjects;
 	int i;
+	Counter cBuildCounter, cWriteCounter;
+
+	cBuildCounter.StartMicro();
 
-	// Create the temporary buffer.
-	CreateTempBuffer(s_nTempBufferSize);
+	// Build the save in memory.
+	CSerializeArena cArena(pFileStream->GetPos());
+	cArena.Reserve(s_nLastSaveSize);
+	CSerializeArena *pStream = &cArena;
 
 	// Make the actual list of ones we're going to save.
     LT_MEM_TRACK_ALLOC(pObjects = new LTObject*[pList->m_nInList],LT_MEM_TYPE_MISC);
     if (!pObjects)
 	{
-		// Free the temporary buffer.
-		DeleteTempBuffer();
-
 		return;
 	}
 
@@ -1199,8 +1160,20 @@ void sm_SaveObjects(ILTStream *pStream, ObjectList *pList, uint32 dwParam, uint3
     GS_STREAM_WRITE(bAnyMore);
     delete [] pObjects;
 
-	// Free the temporary buffer.
-	DeleteTempBuffer();
+	uint32 nBuildMicro = cBuildCounter.EndMicro();
+
+	// Write it out.
+	cWriteCounter.StartMicro();
+	cArena.WriteTo(pFileStream);
+	uint32 nWriteMicro = cWriteCounter.EndMicro();
+
+	s_nLastSaveSize = cArena.GetDataSize();
+
+	if (g_CV_ShowSaveTiming)
+	{
+		dsi_ConsolePrint("SaveObjects: %d objects, %u bytes, build %.2f ms, write %.2f ms",
+			nObjects, cArena.GetDataSize(), (float)nBuildMicro / 1000.0f, (float)nWriteMicro / 1000.0f);
+	}
 }
 
 LTRESULT sm_RestoreConsoleVars(ILTStream *pStream)
@@ -1228,15 +1201,25 @@ LTRESULT sm_RestoreConsoleVars(ILTStream *pStream)
 	return LT_OK;
 }
 
-LTRESULT sm_RestoreObjects(ILTStream *pStream, uint32 dwParam, uint32 flags)
+LTRESULT sm_RestoreObjects(ILTStream *pFileStream, uint32 dwParam, uint32 flags)
 {
     unsigned long startPos;
     LTRESULT dResult;
     LTObject **pObjects;
     int i, objectCount;
+	Counter cReadCounter, cParseCounter;
 
-	// Create the temporary buffer.
-	CreateTempBuffer(s_nTempBufferSize);
+	// Read the save into memory.
+	cReadCounter.StartMicro();
+	CSerializeArena cArena(pFileStream->GetPos());
+	if (cArena.ReadFrom(pFileStream) != LT_OK)
+	{
+		RETURN_ERROR(1, sm_RestoreObjects, LT_INVALIDFILE);
+	}
+	CSerializeArena *pStream = &cArena;
+	uint32 nReadMicro = cReadCounter.EndMicro();
+
+	cParseCounter.StartMicro();
 
 	// Load version
     GS_STREAM_READ(g_dwSaveFileVersion);
@@ -1268,17 +1251,11 @@ LTRESULT sm_RestoreObjects(ILTStream *pStream, uint32 dwParam, uint32 flags)
 	// here on.
     if( g_dwSaveFileVersion != 2001 && g_dwSaveFileVersion != 2002 )
 	{
-		// Delete our temporary buffer.
-		DeleteTempBuffer();
-
 		RETURN_ERROR(1, sm_RestoreObjects, LT_INVALIDVERSION);
     }
 
 	if (sm_RestoreConsoleVars(pStream) != LT_OK)
 	{
-		// Delete our temporary buffer.
-		DeleteTempBuffer();
-
 		RETURN_ERROR(1, sm_RestoreObjects, LT_INVALIDFILE);
 	}
 
@@ -1334,14 +1311,21 @@ LTRESULT sm_RestoreObjects(ILTStream *pStream, uint32 dwParam, uint32 flags)
 
     dfree(pObjects);
 
-	// Delete our temporary buffer.
-	DeleteTempBuffer();
-
     if (dResult != LT_OK && dResult != LT_FINISHED)
 	{// Was there an error?
         return dResult;
     }
 
+	// Leave the file where the save data ended.
+	pFileStream->SeekTo(pStream->GetPos());
+
+	if (g_CV_ShowSaveTiming)
+	{
+		dsi_ConsolePrint("RestoreObjects: %d objects, %u bytes, read %.2f ms, restore %.2f ms",
+			objectCount, cArena.GetDataSize(), (float)nReadMicro / 1000.0f,
+			(float)cParseCounter.EndMicro() / 1000.0f);
+	}
+
     return LT_OK;
 }
 
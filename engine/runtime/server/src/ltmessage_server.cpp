@@ -42,6 +42,11 @@ void CLTMessage_Write_Server::WriteCompPos(CPacket_Write &cPacket, const LTVecto
 
 	g_pWorld->EncodeCompressWorldPosition(&cCompPos, &vPos);
 
+	WriteCompPos(cPacket, cCompPos);
+}
+
+void CLTMessage_Write_Server::WriteCompPos(CPacket_Write &cPacket, const CompWorldPos &cCompPos)
+{
 	cPacket.Writeuint16(cCompPos.m_Pos[0]);
 	cPacket.Writeuint16(cCompPos.m_Pos[1]);
 	cPacket.Writeuint16(cCompPos.m_Pos[2]);
@@ -74,8 +74,9 @@ public:
 
 	static CLTMessage_Write_Server *Allocate_Server();
 
-	// Static function for writing straight to a CPacket_Write
+	// Static functions for writing straight to a CPacket_Write
 	static void WriteCompPos(CPacket_Write &cPacket, const LTVector &vPos);
+	static void WriteCompPos(CPacket_Write &cPacket, const CompWorldPos &cCompPos);
 
 public:
 	CLTMessage_Write_Server() : 
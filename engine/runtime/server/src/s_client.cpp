@@ -16,8 +16,10 @@
 #include "ltmessage_server.h"
 #include "netmgr.h"
 #include "clienthack.h"
+#include "server_bench.h"
 
 #include <queue>
+#include <vector>
 
 //------------------------------------------------------------------
 //------------------------------------------------------------------
@@ -52,6 +54,11 @@ define_holder(ILTServer, ilt_server);
 static IServerShell *i_server_shell;
 define_holder(IServerShell, i_server_shell);
 
+//compressor, for the unguaranteed object data.
+#include "compress.h"
+static ICompress *compress;
+define_holder(ICompress, compress);
+
 
 struct UpdateInfo {
 	Client			*m_pClient;
@@ -819,6 +826,107 @@ bool sm_FlushUpdate(UpdateInfo *pInfo, const CPacket_Read &cPacket, uint32 nPack
 }
 
 
+// The unguaranteed position, velocity and rotation of an object are the same for every
+// client, so they are compressed once per server update, a whole array at a time.
+struct UnguaranteedCache
+{
+	// Index + 1 of each object's compressed data, by object ID.  0 if it's not cached.
+	std::vector<uint32>			m_PosIndex;
+	std::vector<uint32>			m_RotIndex;
+	// The IDs with an index set, so they can be cleared
+	std::vector<uint16>			m_ObjectIDs;
+
+	std::vector<LTVector>		m_Positions;
+	std::vector<LTVector>		m_Velocities;
+	std::vector<LTRotation>		m_Rotations;
+
+	std::vector<CompWorldPos>	m_CompPositions;
+	std::vector<CompVector>		m_CompVelocities;
+	std::vector<CompRot>		m_CompRotations;
+};
+
+static UnguaranteedCache g_UnguaranteedCache;
+
+void sm_ClearUnguaranteedInfo()
+{
+	UnguaranteedCache &cCache = g_UnguaranteedCache;
+
+	for (uint32 i = 0; i < cCache.m_ObjectIDs.size(); i++)
+	{
+		cCache.m_PosIndex[cCache.m_ObjectIDs[i]] = 0;
+		cCache.m_RotIndex[cCache.m_ObjectIDs[i]] = 0;
+	}
+
+	// Note : Clearing keeps the memory around for the next update
+	cCache.m_ObjectIDs.clear();
+	cCache.m_Positions.clear();
+	cCache.m_Velocities.clear();
+	cCache.m_Rotations.clear();
+	cCache.m_CompPositions.clear();
+	cCache.m_CompVelocities.clear();
+	cCache.m_CompRotations.clear();
+}
+
+void sm_CompressUnguaranteedInfo()
+{
+	UnguaranteedCache &cCache = g_UnguaranteedCache;
+
+	sm_ClearUnguaranteedInfo();
+
+	ObjectMgr *pObjectMgr = &g_pServerMgr->m_ObjectMgr;
+	for (uint32 i = 0; i < NUM_OBJECTTYPES; i++)
+	{
+		LTLink *pListHead = &pObjectMgr->m_ObjectLists[i].m_Head;
+		for (LTLink *pCur = pListHead->m_pNext; pCur != pListHead; pCur = pCur->m_pNext)
+		{
+			LTObject *pObject = (LTObject*)pCur->m_pData;
+
+			bool bPos = !!(pObject->sd->m_NetFlags & NETFLAG_POSUNGUARANTEED);
+			bool bRot = (pObject->sd->m_NetFlags & NETFLAG_ROTUNGUARANTEED) && !(pObject->m_Flags & FLAG_YROTATION);
+			if (!bPos && !bRot)
+				continue;
+
+			uint16 nID = pObject->m_ObjectID;
+			if (nID >= cCache.m_PosIndex.size())
+			{
+				cCache.m_PosIndex.resize(nID + 1, 0);
+				cCache.m_RotIndex.resize(nID + 1, 0);
+			}
+
+			if (bPos)
+			{
+				cCache.m_Positions.push_back(pObject->GetPos());
+				cCache.m_Velocities.push_back(pObject->m_Velocity);
+				cCache.m_PosIndex[nID] = (uint32)cCache.m_Positions.size();
+			}
+
+			if (bRot)
+			{
+				cCache.m_Rotations.push_back(pObject->m_Rotation);
+				cCache.m_RotIndex[nID] = (uint32)cCache.m_Rotations.size();
+			}
+
+			cCache.m_ObjectIDs.push_back(nID);
+		}
+	}
+
+	uint32 nPositions = (uint32)cCache.m_Positions.size();
+	if (nPositions)
+	{
+		cCache.m_CompPositions.resize(nPositions);
+		cCache.m_CompVelocities.resize(nPositions);
+		world_bsp_server->EncodeCompressWorldPositions(&cCache.m_CompPositions[0], &cCache.m_Positions[0], nPositions);
+		compress->EncodeCompressVectors(&cCache.m_CompVelocities[0], &cCache.m_Velocities[0], nPositions);
+	}
+
+	uint32 nRotations = (uint32)cCache.m_Rotations.size();
+	if (nRotations)
+	{
+		cCache.m_CompRotations.resize(nRotations);
+		compress->EncodeCompressRotations(&cCache.m_Rotations[0], &cCache.m_CompRotations[0], nRotations);
+	}
+}
+
 void WriteUnguaranteedInfo(LTObject *pObject, CPacket_Write &cPacket) 
 {
 	uint32 flags = 0;
@@ -853,13 +961,30 @@ void WriteUnguaranteedInfo(LTObject *pObject, CPacket_Write &cPacket)
 	cPacket.WriteBits(flags, UUF_FLAGCOUNT);
 
  	// Write position/rotation.
+	const UnguaranteedCache &cCache = g_UnguaranteedCache;
+	uint32 nPosIndex = 0, nRotIndex = 0;
+	if (pObject->m_ObjectID < cCache.m_PosIndex.size())
+	{
+		nPosIndex = cCache.m_PosIndex[pObject->m_ObjectID];
+		nRotIndex = cCache.m_RotIndex[pObject->m_ObjectID];
+	}
+
 	if (flags & UUF_POS)
 	{
-		CLTMessage_Write_Server::WriteCompPos(cPacket, pObject->GetPos());
+		if (nPosIndex)
+			CLTMessage_Write_Server::WriteCompPos(cPacket, cCache.m_CompPositions[nPosIndex - 1]);
+		else
+			CLTMessage_Write_Server::WriteCompPos(cPacket, pObject->GetPos());
+
 		bool bWriteVelocity = pObject->m_Velocity.MagSqr() > 0.00001f;
 		cPacket.Writebool(bWriteVelocity);
 		if (bWriteVelocity)
-			CLTMessage_Write_Server::WriteCompLTVector(cPacket, pObject->m_Velocity);
+		{
+			if (nPosIndex)
+				CLTMessage_Write_Server::WriteCompLTVector(cPacket, cCache.m_CompVelocities[nPosIndex - 1]);
+			else
+				CLTMessage_Write_Server::WriteCompLTVector(cPacket, pObject->m_Velocity);
+		}
 	}
 
 	if (flags & UUF_YROTATION) 
@@ -868,7 +993,10 @@ void WriteUnguaranteedInfo(LTObject *pObject, CPacket_Write &cPacket)
 	}
 	else if (flags & UUF_ROT) 
 	{
-		CLTMessage_Write_Server::WriteCompLTRotation(cPacket, pObject->m_Rotation);
+		if (nRotIndex)
+			CLTMessage_Write_Server::WriteCompLTRotation(cPacket, cCache.m_CompRotations[nRotIndex - 1]);
+		else
+			CLTMessage_Write_Server::WriteCompLTRotation(cPacket, pObject->m_Rotation);
 	}
 
 	// Write anim info.
@@ -1504,8 +1632,12 @@ void sm_UpdateClientInWorld(Client *pClient)
 	WriteEndUpdateInfo(pClient, updateInfo.m_cUnguaranteed);
 
 	// Send them..
-	sm_FlushUpdate(&updateInfo, CPacket_Read(updateInfo.m_cPacket), MESSAGE_GUARANTEED);
-	sm_FlushUpdate(&updateInfo, CPacket_Read(updateInfo.m_cUnguaranteed), 0);
+	CPacket_Read cGuaranteed(updateInfo.m_cPacket);
+	CPacket_Read cUnguaranteed(updateInfo.m_cUnguaranteed);
+	sbench_AddClientUpdate((cGuaranteed.Size() + cUnguaranteed.Size() + 7) / 8);
+
+	sm_FlushUpdate(&updateInfo, cGuaranteed, MESSAGE_GUARANTEED);
+	sm_FlushUpdate(&updateInfo, cUnguaranteed, 0);
 
 	pClient->m_iPrevSentList = !pClient->m_iPrevSentList; // Swap this..
 
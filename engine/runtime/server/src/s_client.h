@@ -208,6 +208,11 @@ void sm_UpdateClientState(Client *pClient);
 // Updates the client if it's in the world.
 void sm_UpdateClientInWorld(Client *pClient);
 
+// Compress the unguaranteed object data once for all the sm_UpdateClientInWorld
+// calls in a server update, and forget it afterwards.
+void sm_CompressUnguaranteedInfo();
+void sm_ClearUnguaranteedInfo();
+
 // Finds a client given its connection ID.
 Client* sm_FindClient(CBaseConn *connID);
 
@@ -7,6 +7,8 @@
 #include "dhashtable.h"
 #include "s_client.h"
 #include "ltobjectcreate.h"
+#include "server_bench.h"
+#include "server_bots.h"
 
 //------------------------------------------------------------------
 //------------------------------------------------------------------
@@ -30,6 +32,12 @@ define_holder(IServerConsoleState, console_state);
 static ILTServer *ilt_server;
 define_holder(ILTServer, ilt_server);
 
+//the server world
+#include "world_server_bsp.h"
+#include "world_tree.h"
+static IWorldServerBSP *world_bsp_server;
+define_holder(IWorldServerBSP, world_bsp_server);
+
 
 
 
@@ -273,6 +281,97 @@ void con_SpawnObject(int argc, const char **argv)
 }
 
 
+void con_ServerBench(int argc, const char **argv)
+{
+    if (argc == 0)
+    {
+        dsi_ConsolePrint("ServerBench <number of updates>  (0 to stop)");
+        return;
+    }
+
+    int32 nUpdates = atoi(argv[0]);
+    if (nUpdates <= 0)
+    {
+        sbench_Stop();
+        dsi_ConsolePrint("Server benchmark stopped");
+        return;
+    }
+
+    sbench_Start((uint32)nUpdates);
+    dsi_ConsolePrint("Server benchmark: capturing %d updates", nUpdates);
+}
+
+
+void con_ServerBots(int argc, const char **argv)
+{
+    if (argc == 0)
+    {
+        dsi_ConsolePrint("ServerBots <number of bots> [script file]  (0 to remove them all)");
+        dsi_ConsolePrint("%d bots, %d in the world", sbots_GetNumBots(), sbots_GetNumInWorld());
+        return;
+    }
+
+    int32 nBots = atoi(argv[0]);
+    if (nBots <= 0)
+    {
+        sbots_RemoveAll();
+        dsi_ConsolePrint("Server bots removed");
+        return;
+    }
+
+    if (sbots_Add((uint32)nBots, (argc > 1) ? argv[1] : LTNULL) == LT_OK)
+        dsi_ConsolePrint("Server bots: added %d, %d total", nBots, sbots_GetNumBots());
+}
+
+
+static void PrintHashStats(const char *pName, HHashTable *hTable)
+{
+    if (!hTable)
+        return;
+
+    dsi_ConsolePrint("%-12s elements: %5d  collisions: %5d  max probe: %d", 
+        pName, 
+        hs_GetNumElements(hTable), 
+        hs_GetNumCollisions(hTable), 
+        hs_GetMaxProbeLength(hTable));
+}
+
+void con_HashStats(int argc, const char **argv)
+{
+    ConsoleState *pState;
+
+    if (!g_pServerMgr)
+        return;
+
+    pState = console_state->State();
+    dsi_ConsolePrint("Hash tables ------------------");
+
+    PrintHashStats("Objects", g_pServerMgr->m_hNameTable);
+    PrintHashStats("Classes", g_pServerMgr->m_ClassMgr.m_hClassNameHash);
+    PrintHashStats("Files", server_filemgr->m_hFileTable);
+    PrintHashStats("Game vars", pState->m_VarHash);
+    PrintHashStats("Strings", pState->m_StringHash);
+}
+
+void con_WorldTreeStats(int argc, const char **argv)
+{
+    if (!world_bsp_server->IsLoaded())
+        return;
+
+    WorldTree *pTree = world_bsp_server->ServerTree();
+
+    dsi_ConsolePrint("World tree relinks -----------");
+    dsi_ConsolePrint("Skipped: %u  Performed: %u", 
+        pTree->GetNumRelinksSkipped(), 
+        pTree->GetNumRelinksPerformed());
+
+    if (argc > 0 && stricmp(argv[0], "reset") == 0)
+    {
+        pTree->ResetRelinkCounts();
+    }
+}
+
+
 // ------------------------------------------------------------------ //
 // Tables.
 // ------------------------------------------------------------------ //
@@ -286,6 +385,10 @@ static LTCommandStruct g_ServerCommandStructs[] =
     { "DisableWMPhysics", con_DisableWMPhysics, 0 },
     { "ExhaustMemory", con_ExhaustMemory, 0 },
     { "SpawnObject", con_SpawnObject, 0 },
+    { "ServerBench", con_ServerBench, 0 },
+    { "ServerBots", con_ServerBots, 0 },
+    { "HashStats", con_HashStats, 0 },
+    { "WorldTreeStats", con_WorldTreeStats, 0 },
 	{ "Mem", LTMemConsole, 0 },
 };
 
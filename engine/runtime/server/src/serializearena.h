@@ -0,0 +1,146 @@
+// Serialization arena used by the save game code.
+// Saves are built in memory and written to the real stream with one Write.
+// Restores read the rest of the real stream in once and parse from memory.
+// Positions include the real stream's starting position, so the offsets stored
+// in the save are the same as if it had been written to the real stream directly.
+
+#ifndef __SERIALIZEARENA_H__
+#define __SERIALIZEARENA_H__
+
+#ifndef __GENLTSTREAM_H__
+#include "genltstream.h"
+#endif
+
+#include <string.h>
+#include <vector>
+
+
+class CSerializeArena : public CGenLTStream
+{
+public:
+
+	CSerializeArena(uint32 nBasePos)
+	{
+		m_nBasePos = nBasePos;
+		m_nPos = 0;
+		m_bError = LTFALSE;
+	}
+
+	// Lives on the stack.
+	void		Release() {}
+
+	LTRESULT	Read(void *pData, uint32 size)
+	{
+		const uint8 *pSrc = ReadInPlace(size);
+		if (!pSrc)
+		{
+			memset(pData, 0, size);
+			return LT_ERROR;
+		}
+
+		memcpy(pData, pSrc, size);
+		return LT_OK;
+	}
+
+	LTRESULT	Write(const void *pData, uint32 size)
+	{
+		memcpy(WriteInPlace(size), pData, size);
+		return LT_OK;
+	}
+
+	LTRESULT	ErrorStatus()
+	{
+		return m_bError ? LT_ERROR : LT_OK;
+	}
+
+	LTRESULT	SeekTo(uint32 offset)
+	{
+		if ((offset < m_nBasePos) || ((offset - m_nBasePos) > m_Data.size()))
+			return LT_ERROR;
+
+		m_nPos = offset - m_nBasePos;
+		return LT_OK;
+	}
+
+	LTRESULT	GetPos(uint32 *offset)
+	{
+		*offset = m_nBasePos + m_nPos;
+		return LT_OK;
+	}
+
+	LTRESULT	GetLen(uint32 *len)
+	{
+		*len = m_nBasePos + (uint32)m_Data.size();
+		return LT_OK;
+	}
+
+	using ILTStream::GetPos;
+	using ILTStream::GetLen;
+
+	// Returns size bytes at the current position and moves past them,
+	// or NULL if that would read past the end.
+	const uint8* ReadInPlace(uint32 size)
+	{
+		if ((m_nPos + size) > m_Data.size())
+		{
+			m_nPos = (uint32)m_Data.size();
+			m_bError = LTTRUE;
+			return LTNULL;
+		}
+
+		const uint8 *pResult = m_Data.data() + m_nPos;
+		m_nPos += size;
+		return pResult;
+	}
+
+	// Returns space for size bytes at the current position and moves past it.
+	uint8* WriteInPlace(uint32 size)
+	{
+		if ((m_nPos + size) > m_Data.size())
+		{
+			m_Data.resize(m_nPos + size);
+		}
+
+		uint8 *pResult = m_Data.data() + m_nPos;
+		m_nPos += size;
+		return pResult;
+	}
+
+	void		Reserve(uint32 size) { m_Data.reserve(size); }
+	uint32		GetDataSize() const { return (uint32)m_Data.size(); }
+
+	// Reads the rest of pStream into the arena.
+	LTRESULT	ReadFrom(ILTStream *pStream)
+	{
+		uint32 nLen = pStream->GetLen();
+		if (nLen < m_nBasePos)
+			return LT_ERROR;
+
+		m_Data.resize(nLen - m_nBasePos);
+		m_nPos = 0;
+
+		if (m_Data.empty())
+			return LT_OK;
+
+		return pStream->Read(m_Data.data(), (uint32)m_Data.size());
+	}
+
+	// Writes the whole arena to pStream.
+	LTRESULT	WriteTo(ILTStream *pStream)
+	{
+		if (m_Data.empty())
+			return LT_OK;
+
+		return pStream->Write(m_Data.data(), (uint32)m_Data.size());
+	}
+
+private:
+
+	std::vector<uint8>	m_Data;
+	uint32				m_nBasePos;
+	uint32				m_nPos;
+	LTBOOL				m_bError;
+};
+
+
+#endif  // __SERIALIZEARENA_H__
@@ -0,0 +1,235 @@
+
+#include "bdefs.h"
+
+#include "server_bench.h"
+#include "servermgr.h"
+#include "s_client.h"
+
+
+extern uint32 g_Ticks_MoveObject;
+extern uint32 g_nMoveObjectCalls;
+extern uint32 g_Ticks_Intersect, g_nIntersectCalls;
+
+// Total dalloc calls (de_memory.cpp).
+extern uint32 g_nTotalAllocations;
+
+
+// ------------------------------------------------------------------ //
+// Internal structures.
+// ------------------------------------------------------------------ //
+
+struct SBenchPhaseStat
+{
+	uint32	m_nTotalTicks;
+	uint32	m_nMaxTicks;		// Worst single update.
+	uint32	m_nCurTicks;		// This update.
+};
+
+struct SBenchState
+{
+	uint32			m_nUpdatesLeft;
+	uint32			m_nUpdates;
+
+	SBenchPhaseStat	m_Phases[eSBench_NumPhases];
+	SBenchPhaseStat	m_Physics;
+	SBenchPhaseStat	m_Intersect;
+
+	uint32			m_nMoveObjectCalls;
+	uint32			m_nIntersectCalls;
+
+	uint32			m_nClientUpdates;
+	uint32			m_nClientBytes;
+	uint32			m_nMaxClients;
+	uint32			m_nClientSum;		// Sum of in-world clients over the updates.
+
+	Counter			m_UpdateCounter;
+
+	uint32			m_nStartAllocations;
+	uint32			m_nUpdateStartAllocations;
+	uint32			m_nMaxUpdateAllocations;
+};
+
+static SBenchState g_SBench;
+
+// Updates requested by sbench_Start; the capture begins with the next update.
+static uint32 g_nSBenchPendingUpdates;
+
+static const char *g_SBenchPhaseNames[eSBench_NumPhases] =
+{
+	"Packets",
+	"ServerShell",
+	"Objects",
+	"ClientUpdates",
+	"Total",
+};
+
+
+// ------------------------------------------------------------------ //
+// Internal functions.
+// ------------------------------------------------------------------ //
+
+static void sbench_AddTicks(SBenchPhaseStat *pStat, uint32 nTicks)
+{
+	pStat->m_nTotalTicks += nTicks;
+	pStat->m_nCurTicks += nTicks;
+}
+
+static void sbench_FinishUpdate(SBenchPhaseStat *pStat)
+{
+	pStat->m_nMaxTicks = LTMAX(pStat->m_nMaxTicks, pStat->m_nCurTicks);
+	pStat->m_nCurTicks = 0;
+}
+
+static uint32 sbench_CountInWorldClients()
+{
+	uint32 nClients = 0;
+
+	LTLink *pListHead = &g_pServerMgr->m_Clients.m_Head;
+	for (LTLink *pCur = pListHead->m_pNext; pCur != pListHead; pCur = pCur->m_pNext)
+	{
+		Client *pClient = (Client*)pCur->m_pData;
+		if (pClient->m_State == CLIENT_INWORLD)
+			++nClients;
+	}
+
+	return nClients;
+}
+
+static void sbench_PrintPhase(const char *pName, const SBenchPhaseStat &Stat, float fMSPerTick, uint32 nUpdates)
+{
+	dsi_ConsolePrint("  %-14s avg %8.3f ms  max %8.3f ms  total %9.2f ms",
+		pName,
+		(float)Stat.m_nTotalTicks * fMSPerTick / (float)nUpdates,
+		(float)Stat.m_nMaxTicks * fMSPerTick,
+		(float)Stat.m_nTotalTicks * fMSPerTick);
+}
+
+static void sbench_Report()
+{
+	const SBenchState &State = g_SBench;
+	uint32 nUpdates = LTMAX(State.m_nUpdates, (uint32)1);
+	float fMSPerTick = 1000.0f / (float)cnt_NumTicksPerSecond();
+
+	dsi_ConsolePrint("Server benchmark: %u updates, %.2f clients in world on average (max %u)",
+		State.m_nUpdates, (float)State.m_nClientSum / (float)nUpdates, State.m_nMaxClients);
+
+	for (uint32 i = 0; i < eSBench_NumPhases; i++)
+	{
+		sbench_PrintPhase(g_SBenchPhaseNames[i], State.m_Phases[i], fMSPerTick, nUpdates);
+	}
+
+	sbench_PrintPhase("MoveObject", State.m_Physics, fMSPerTick, nUpdates);
+	sbench_PrintPhase("Intersect", State.m_Intersect, fMSPerTick, nUpdates);
+
+	dsi_ConsolePrint("  MoveObject calls: %.1f per update, IntersectSegment calls: %.1f per update",
+		(float)State.m_nMoveObjectCalls / (float)nUpdates,
+		(float)State.m_nIntersectCalls / (float)nUpdates);
+
+	if (State.m_nClientUpdates)
+	{
+		dsi_ConsolePrint("  Client snapshots: %u, %.1f bytes each, %.3f ms each",
+			State.m_nClientUpdates,
+			(float)State.m_nClientBytes / (float)State.m_nClientUpdates,
+			(float)State.m_Phases[eSBench_ClientUpdates].m_nTotalTicks * fMSPerTick / (float)State.m_nClientUpdates);
+	}
+	else
+	{
+		dsi_ConsolePrint("  Client snapshots: none (no clients in world)");
+	}
+
+	dsi_ConsolePrint("  Allocations: %.1f per update (max %u)",
+		(float)(g_nTotalAllocations - State.m_nStartAllocations) / (float)nUpdates,
+		State.m_nMaxUpdateAllocations);
+}
+
+
+// ------------------------------------------------------------------ //
+// Interface.
+// ------------------------------------------------------------------ //
+
+void sbench_Start(uint32 nUpdates)
+{
+	g_nSBenchPendingUpdates = nUpdates;
+}
+
+void sbench_Stop()
+{
+	g_nSBenchPendingUpdates = 0;
+	g_SBench.m_nUpdatesLeft = 0;
+}
+
+bool sbench_IsActive()
+{
+	return g_SBench.m_nUpdatesLeft != 0;
+}
+
+void sbench_BeginUpdate()
+{
+	if (g_nSBenchPendingUpdates)
+	{
+		memset(&g_SBench, 0, sizeof(g_SBench));
+		g_SBench.m_nUpdatesLeft = g_nSBenchPendingUpdates;
+		g_SBench.m_nStartAllocations = g_nTotalAllocations;
+		g_nSBenchPendingUpdates = 0;
+	}
+
+	if (!sbench_IsActive())
+		return;
+
+	g_SBench.m_nUpdateStartAllocations = g_nTotalAllocations;
+	cnt_StartCounter(g_SBench.m_UpdateCounter);
+}
+
+void sbench_EndUpdate()
+{
+	if (!sbench_IsActive())
+		return;
+
+	SBenchState &State = g_SBench;
+
+	sbench_AddTicks(&State.m_Phases[eSBench_Total], cnt_EndCounter(State.m_UpdateCounter));
+
+	// The physics counters are reset at the top of every server update.
+	sbench_AddTicks(&State.m_Physics, g_Ticks_MoveObject);
+	sbench_AddTicks(&State.m_Intersect, g_Ticks_Intersect);
+	State.m_nMoveObjectCalls += g_nMoveObjectCalls;
+	State.m_nIntersectCalls += g_nIntersectCalls;
+
+	for (uint32 i = 0; i < eSBench_NumPhases; i++)
+	{
+		sbench_FinishUpdate(&State.m_Phases[i]);
+	}
+
+	sbench_FinishUpdate(&State.m_Physics);
+	sbench_FinishUpdate(&State.m_Intersect);
+
+	uint32 nClients = sbench_CountInWorldClients();
+	State.m_nClientSum += nClients;
+	State.m_nMaxClients = LTMAX(State.m_nMaxClients, nClients);
+
+	State.m_nMaxUpdateAllocations = LTMAX(State.m_nMaxUpdateAllocations,
+		g_nTotalAllocations - State.m_nUpdateStartAllocations);
+
+	++State.m_nUpdates;
+	--State.m_nUpdatesLeft;
+
+	if (!State.m_nUpdatesLeft)
+	{
+		sbench_Report();
+	}
+}
+
+void sbench_AddPhaseTicks(ESBenchPhase ePhase, uint32 nTicks)
+{
+	ASSERT(ePhase < eSBench_NumPhases);
+	sbench_AddTicks(&g_SBench.m_Phases[ePhase], nTicks);
+}
+
+void sbench_AddClientUpdate(uint32 nBytes)
+{
+	if (!sbench_IsActive())
+		return;
+
+	++g_SBench.m_nClientUpdates;
+	g_SBench.m_nClientBytes += nBytes;
+}
@@ -0,0 +1,76 @@
+
+// Server benchmark capture.  Times the phases of a fixed number of server
+// updates and prints a report to the console when the capture completes.
+
+#ifndef __SERVER_BENCH_H__
+#define __SERVER_BENCH_H__
+
+	#include "counter.h"
+
+	// Phases timed by the capture.
+	enum ESBenchPhase
+	{
+		eSBench_Packets = 0,		// ProcessIncomingPackets
+		eSBench_ServerShell,		// IServerShell::Update
+		eSBench_Objects,			// PreUpdateObjects (includes physics)
+		eSBench_ClientUpdates,		// Per-client snapshot build and send
+		eSBench_Total,				// Between sbench_BeginUpdate and sbench_EndUpdate
+
+		eSBench_NumPhases
+	};
+
+	// Start capturing nUpdates server updates, beginning with the next one.
+	void sbench_Start(uint32 nUpdates);
+
+	// Abort the current capture without a report.
+	void sbench_Stop();
+
+	// Is a capture in progress?
+	bool sbench_IsActive();
+
+	// Called around each CServerMgr::Update.
+	void sbench_BeginUpdate();
+	void sbench_EndUpdate();
+
+	void sbench_AddPhaseTicks(ESBenchPhase ePhase, uint32 nTicks);
+
+	// Called for each snapshot sent to an in-world client.
+	void sbench_AddClientUpdate(uint32 nBytes);
+
+
+	// Adds the scope's ticks to a phase while a capture is in progress.
+	class CSBenchPhaseTimer
+	{
+	public:
+
+		CSBenchPhaseTimer(ESBenchPhase ePhase)
+		{
+			m_ePhase = ePhase;
+			m_bActive = sbench_IsActive();
+			if (m_bActive)
+				cnt_StartCounter(m_Counter);
+		}
+
+		~CSBenchPhaseTimer()
+		{
+			if (m_bActive)
+				sbench_AddPhaseTicks(m_ePhase, cnt_EndCounter(m_Counter));
+		}
+
+		ESBenchPhase	m_ePhase;
+		bool			m_bActive;
+		Counter			m_Counter;
+	};
+
+
+	// Calls sbench_BeginUpdate and sbench_EndUpdate around a scope, so every
+	// way out of the update closes the capture.
+	class CSBenchUpdateScope
+	{
+	public:
+
+		CSBenchUpdateScope()	{ sbench_BeginUpdate(); }
+		~CSBenchUpdateScope()	{ sbench_EndUpdate(); }
+	};
+
+#endif  // __SERVER_BENCH_H__
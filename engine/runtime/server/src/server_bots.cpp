@@ -0,0 +1,553 @@
+
+#include "bdefs.h"
+
+#include "server_bots.h"
+#include "servermgr.h"
+#include "netmgr.h"
+#include "packetdefs.h"
+#include "ftbase.h"
+
+#include <ctype.h>
+#include <deque>
+
+
+extern int32 g_CV_BandwidthTargetClient;
+
+
+// ------------------------------------------------------------------ //
+// Internal structures.
+// ------------------------------------------------------------------ //
+
+struct SBotScriptMessage
+{
+	uint32			m_nPeriod;
+	CPacket_Read	m_cPacket;		// CMSG_MESSAGE with the data.
+};
+
+class CServerBotScript
+{
+public:
+
+	CServerBotScript()
+	{
+		m_nBandwidth = (uint32)g_CV_BandwidthTargetClient;
+	}
+
+	CPacket_Read					m_cHello;		// CMSG_HELLO with the client data.
+	uint32							m_nBandwidth;
+	CMoArray<SBotScriptMessage*>	m_Messages;
+};
+
+
+enum EServerBotState
+{
+	eBot_Connecting = 0,		// Waiting for the server to load the world on it.
+	eBot_LoadingWorld,			// Waiting for the end of the preload list.
+	eBot_InWorld,
+};
+
+class CServerBotConn : public CBaseConn
+{
+public:
+
+	CServerBotConn()
+	{
+		m_nIndex = 0;
+		m_pScript = LTNULL;
+		m_eState = eBot_Connecting;
+		m_bNotified = false;
+		m_nWorldUpdates = 0;
+	}
+
+	uint32				m_nIndex;
+	CServerBotScript	*m_pScript;
+	EServerBotState		m_eState;
+	bool				m_bNotified;		// Has the server been told about the connection yet?
+	uint32				m_nWorldUpdates;	// Updates since it got into the world.
+
+	// Packets on their way to the server.
+	std::deque<CPacket_Read>	m_Outgoing;
+};
+
+
+// Plays both ends of the bots' connections.  What the server sends to a bot
+// is answered right away and the answers are handed back in GetPacket.
+class CServerBotDriver : public CBaseDriver
+{
+public:
+
+						CServerBotDriver();
+	virtual				~CServerBotDriver();
+
+	virtual bool		Init();
+	virtual void		Term();
+
+	virtual void		Update();
+
+	virtual void		Disconnect(CBaseConn *id, EDisconnectReason reason);
+
+	virtual bool		SendPacket(const CPacket_Read &cPacket, CBaseConn *idSendTo, bool bGuaranteed);
+	virtual bool		GetPacket(CPacket_Read *pPacket, CBaseConn **pSender);
+
+public:
+
+	void				AddBot(CServerBotScript *pScript);
+	uint32				GetNumInWorld() const;
+
+	CMoArray<CServerBotConn*>		m_Bots;
+	CMoArray<CServerBotScript*>		m_Scripts;		// Owned by the driver.
+
+	uint32				m_nNextIndex;
+
+private:
+
+	void				OnServerPacket(CServerBotConn *pBot, const CPacket_Read &cPacket);
+	void				RemoveBot(uint32 nIndex);
+};
+
+
+static CServerBotDriver *g_pBotDriver = LTNULL;
+
+
+// ------------------------------------------------------------------ //
+// Script loading.
+// ------------------------------------------------------------------ //
+
+static int sbots_HexDigit(char c)
+{
+	if (c >= '0' && c <= '9')
+		return c - '0';
+	if (c >= 'a' && c <= 'f')
+		return c - 'a' + 10;
+	if (c >= 'A' && c <= 'F')
+		return c - 'A' + 10;
+	return -1;
+}
+
+// Writes the hex bytes in pStr to the packet.  Whitespace between bytes is ignored.
+static bool sbots_WriteHex(const char *pStr, CPacket_Write &cPacket)
+{
+	while (*pStr)
+	{
+		if (isspace((unsigned char)*pStr))
+		{
+			++pStr;
+			continue;
+		}
+
+		int nHigh = sbots_HexDigit(pStr[0]);
+		int nLow = (nHigh >= 0) ? sbots_HexDigit(pStr[1]) : -1;
+		if (nLow < 0)
+			return false;
+
+		cPacket.Writeuint8((uint8)((nHigh << 4) | nLow));
+		pStr += 2;
+	}
+
+	return true;
+}
+
+static CServerBotScript* sbots_LoadScript(const char *pFilename)
+{
+	CServerBotScript *pScript;
+	LT_MEM_TRACK_ALLOC(pScript = new CServerBotScript, LT_MEM_TYPE_NETWORKING);
+
+	CPacket_Write cHello;
+	cHello.Writeuint8(CMSG_HELLO);
+
+	CPacket_Write cHelloData;
+
+	if (pFilename)
+	{
+		FILE *fp = fopen(pFilename, "rt");
+		if (!fp)
+		{
+			dsi_ConsolePrint("ServerBots: can't open script %s", pFilename);
+			delete pScript;
+			return LTNULL;
+		}
+
+		char line[1024];
+		uint32 nLine = 0;
+		while (fgets(line, sizeof(line), fp))
+		{
+			++nLine;
+
+			char *pComment = strstr(line, "//");
+			if (pComment)
+				*pComment = 0;
+			pComment = strchr(line, ';');
+			if (pComment)
+				*pComment = 0;
+
+			char command[32];
+			int nRead = 0;
+			if (sscanf(line, " %31s %n", command, &nRead) != 1)
+				continue;
+
+			const char *pArgs = &line[nRead];
+			bool bOK = true;
+
+			if (stricmp(command, "hello") == 0)
+			{
+				cHelloData.Reset();
+				bOK = sbots_WriteHex(pArgs, cHelloData);
+			}
+			else if (stricmp(command, "bandwidth") == 0)
+			{
+				pScript->m_nBandwidth = (uint32)atoi(pArgs);
+			}
+			else if (stricmp(command, "message") == 0)
+			{
+				int nPeriod = 0;
+				int nDataStart = 0;
+				CPacket_Write cMessage;
+				cMessage.Writeuint8(CMSG_MESSAGE);
+
+				bOK = (sscanf(pArgs, "%d %n", &nPeriod, &nDataStart) == 1) && (nPeriod > 0) &&
+					sbots_WriteHex(&pArgs[nDataStart], cMessage);
+
+				if (bOK)
+				{
+					SBotScriptMessage *pMessage;
+					LT_MEM_TRACK_ALLOC(pMessage = new SBotScriptMessage, LT_MEM_TYPE_NETWORKING);
+					pMessage->m_nPeriod = (uint32)nPeriod;
+					pMessage->m_cPacket = CPacket_Read(cMessage);
+					LT_MEM_TRACK_ALLOC(pScript->m_Messages.Append(pMessage), LT_MEM_TYPE_NETWORKING);
+				}
+			}
+			else
+			{
+				bOK = false;
+			}
+
+			if (!bOK)
+				dsi_ConsolePrint("ServerBots: %s(%d): bad command ignored", pFilename, nLine);
+		}
+
+		fclose(fp);
+	}
+
+	uint32 nHelloBytes = cHelloData.Size() / 8;
+	cHello.Writeuint16((uint16)nHelloBytes);
+	if (nHelloBytes)
+		cHello.WritePacket(CPacket_Read(cHelloData));
+	pScript->m_cHello = CPacket_Read(cHello);
+
+	return pScript;
+}
+
+static void sbots_FreeScript(CServerBotScript *pScript)
+{
+	for (uint32 i = 0; i < pScript->m_Messages.GetSize(); i++)
+	{
+		delete pScript->m_Messages[i];
+	}
+
+	delete pScript;
+}
+
+
+// ------------------------------------------------------------------ //
+// CServerBotDriver.
+// ------------------------------------------------------------------ //
+
+CServerBotDriver::CServerBotDriver()
+{
+	m_nNextIndex = 0;
+}
+
+
+CServerBotDriver::~CServerBotDriver()
+{
+	Term();
+
+	for (uint32 i = 0; i < m_Scripts.GetSize(); i++)
+	{
+		sbots_FreeScript(m_Scripts[i]);
+	}
+	m_Scripts.Term();
+
+	if (g_pBotDriver == this)
+		g_pBotDriver = LTNULL;
+}
+
+
+bool CServerBotDriver::Init()
+{
+	LTStrCpy(m_Name, "bots", sizeof(m_Name));
+	return true;
+}
+
+
+void CServerBotDriver::Term()
+{
+	while (m_Bots.GetSize())
+	{
+		Disconnect(m_Bots[m_Bots.GetSize() - 1], DISCONNECTREASON_SHUTDOWN);
+	}
+	m_Bots.Term();
+}
+
+
+void CServerBotDriver::AddBot(CServerBotScript *pScript)
+{
+	CServerBotConn *pBot;
+	LT_MEM_TRACK_ALLOC(pBot = new CServerBotConn, LT_MEM_TYPE_NETWORKING);
+
+	// No CONNFLAG_LOCAL, the server treats bots like any remote client.
+	pBot->m_pDriver = this;
+	pBot->m_nIndex = m_nNextIndex++;
+	pBot->m_pScript = pScript;
+
+	LT_MEM_TRACK_ALLOC(m_Bots.Append(pBot), LT_MEM_TYPE_NETWORKING);
+}
+
+
+uint32 CServerBotDriver::GetNumInWorld() const
+{
+	uint32 nInWorld = 0;
+	for (uint32 i = 0; i < m_Bots.GetSize(); i++)
+	{
+		if (m_Bots[i]->m_eState == eBot_InWorld)
+			++nInWorld;
+	}
+
+	return nInWorld;
+}
+
+
+void CServerBotDriver::RemoveBot(uint32 nIndex)
+{
+	CServerBotConn *pBot = m_Bots[nIndex];
+	m_Bots.Remove(nIndex);
+	delete pBot;
+}
+
+
+void CServerBotDriver::Update()
+{
+	uint32 i = 0;
+	while (i < m_Bots.GetSize())
+	{
+		CServerBotConn *pBot = m_Bots[i];
+
+		// Connections are announced here, like CLocalDriver does, so the
+		// notification doesn't come in at an inconvenient time.
+		if (!pBot->m_bNotified)
+		{
+			pBot->m_bNotified = true;
+
+			if (!m_pNetMgr->NewConnectionNotify(pBot))
+			{
+				dsi_ConsolePrint("ServerBots: the server refused bot %d", pBot->m_nIndex);
+				RemoveBot(i);
+				continue;
+			}
+		}
+
+		if (pBot->m_eState == eBot_InWorld)
+		{
+			// Spread the bots over the message periods so they don't all send on the same update.
+			uint32 nTime = pBot->m_nWorldUpdates + pBot->m_nIndex;
+
+			CServerBotScript *pScript = pBot->m_pScript;
+			for (uint32 iMessage = 0; iMessage < pScript->m_Messages.GetSize(); iMessage++)
+			{
+				SBotScriptMessage *pMessage = pScript->m_Messages[iMessage];
+				if ((nTime % pMessage->m_nPeriod) == 0)
+					pBot->m_Outgoing.push_back(pMessage->m_cPacket);
+			}
+
+			++pBot->m_nWorldUpdates;
+		}
+
+		++i;
+	}
+}
+
+
+void CServerBotDriver::Disconnect(CBaseConn *id, EDisconnectReason reason)
+{
+	uint32 nIndex = m_Bots.FindElement((CServerBotConn*)id);
+	if (nIndex == BAD_INDEX)
+		return;
+
+	if (m_Bots[nIndex]->m_bNotified)
+		m_pNetMgr->DisconnectNotify(id, reason);
+
+	RemoveBot(nIndex);
+}
+
+
+bool CServerBotDriver::SendPacket(const CPacket_Read &cPacket, CBaseConn *idSendTo, bool bGuaranteed)
+{
+	CServerBotConn *pBot = (CServerBotConn*)idSendTo;
+	OnServerPacket(pBot, cPacket);
+	return true;
+}
+
+
+bool CServerBotDriver::GetPacket(CPacket_Read *pPacket, CBaseConn **pSender)
+{
+	for (uint32 i = 0; i < m_Bots.GetSize(); i++)
+	{
+		CServerBotConn *pBot = m_Bots[i];
+		if (pBot->m_bNotified && !pBot->m_Outgoing.empty())
+		{
+			*pPacket = pBot->m_Outgoing.front();
+			*pSender = pBot;
+			pBot->m_Outgoing.pop_front();
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+// The client's side of the handshake.  Everything else is dropped.
+void CServerBotDriver::OnServerPacket(CServerBotConn *pBot, const CPacket_Read &cPacket)
+{
+	CPacket_Read cRead(cPacket);
+	cRead.SeekTo(0);
+
+	switch (cRead.Readuint8())
+	{
+		case SMSG_PACKETGROUP :
+		{
+			while (!cRead.EOP())
+			{
+				uint32 nLength = cRead.Readuint8();
+				if (!nLength || (nLength > cRead.TellEnd()))
+					break;
+
+				OnServerPacket(pBot, CPacket_Read(cRead, cRead.Tell(), nLength));
+				cRead.Seek(nLength);
+			}
+			break;
+		}
+
+		case SMSG_YOURID :
+		{
+			pBot->m_Outgoing.push_back(pBot->m_pScript->m_cHello);
+			break;
+		}
+
+		case STC_FILEDESC :
+		{
+			// The bots have every file.
+			CPacket_Write cStatus;
+			cStatus.Writeuint8(CTS_FILESTATUS);
+			while (!cRead.EOP())
+			{
+				uint16 nFileID = cRead.Readuint16();
+				cRead.Readuint32();
+				cRead.ReadString(LTNULL, 0);
+				cStatus.Writeuint16(nFileID | 0x8000);
+			}
+			pBot->m_Outgoing.push_back(CPacket_Read(cStatus));
+			break;
+		}
+
+		case SMSG_LOADWORLD :
+		{
+			CPacket_Write cStage;
+			cStage.Writeuint8(CMSG_CONNECTSTAGE);
+			cStage.Writeuint8(0);
+			pBot->m_Outgoing.push_back(CPacket_Read(cStage));
+
+			pBot->m_eState = eBot_LoadingWorld;
+			break;
+		}
+
+		case SMSG_PRELOADLIST :
+		{
+			if (cRead.Readuint8() != PRELOADTYPE_END)
+				break;
+
+			CPacket_Write cStage;
+			cStage.Writeuint8(CMSG_CONNECTSTAGE);
+			cStage.Writeuint8(1);
+			pBot->m_Outgoing.push_back(CPacket_Read(cStage));
+
+			CPacket_Write cUpdate;
+			cUpdate.Writeuint8(CMSG_UPDATE);
+			cUpdate.Writeuint16((uint16)LTCLAMP(pBot->m_pScript->m_nBandwidth / 8000, 0, 0xFFFF));
+			pBot->m_Outgoing.push_back(CPacket_Read(cUpdate));
+
+			pBot->m_eState = eBot_InWorld;
+			pBot->m_nWorldUpdates = 0;
+			break;
+		}
+
+		case SMSG_UNLOADWORLD :
+		{
+			pBot->m_eState = eBot_Connecting;
+			break;
+		}
+
+		default :
+			break;
+	}
+}
+
+
+// ------------------------------------------------------------------ //
+// Interface functions.
+// ------------------------------------------------------------------ //
+
+LTRESULT sbots_Add(uint32 nBots, const char *pScriptFilename)
+{
+	if (!g_pServerMgr)
+		return LT_NOTINITIALIZED;
+
+	CServerBotScript *pScript = sbots_LoadScript(pScriptFilename);
+	if (!pScript)
+		return LT_NOTFOUND;
+
+	if (!g_pBotDriver)
+	{
+		CServerBotDriver *pDriver;
+		LT_MEM_TRACK_ALLOC(pDriver = new CServerBotDriver, LT_MEM_TYPE_NETWORKING);
+
+		if (!g_pServerMgr->m_NetMgr.AddDriver(pDriver))
+		{
+			sbots_FreeScript(pScript);
+			return LT_ERROR;
+		}
+
+		g_pBotDriver = pDriver;
+	}
+
+	LT_MEM_TRACK_ALLOC(g_pBotDriver->m_Scripts.Append(pScript), LT_MEM_TYPE_NETWORKING);
+
+	for (uint32 i = 0; i < nBots; i++)
+	{
+		g_pBotDriver->AddBot(pScript);
+	}
+
+	return LT_OK;
+}
+
+
+void sbots_RemoveAll()
+{
+	if (!g_pBotDriver || !g_pServerMgr)
+		return;
+
+	// Deleting the driver disconnects the bots.
+	g_pServerMgr->m_NetMgr.RemoveDriver(g_pBotDriver);
+}
+
+
+uint32 sbots_GetNumBots()
+{
+	return g_pBotDriver ? g_pBotDriver->m_Bots.GetSize() : 0;
+}
+
+
+uint32 sbots_GetNumInWorld()
+{
+	return g_pBotDriver ? g_pBotDriver->GetNumInWorld() : 0;
+}
@@ -0,0 +1,28 @@
+// Scripted synthetic clients.  Bots connect to the server through their own
+// net driver as remote clients, answer the connection handshake like a real
+// client would, and then send the messages in their script, so the server can
+// be loaded and benchmarked without running any real clients.
+//
+// Bot script format, one command per line ('//' or ';' starts a comment):
+//
+//   hello <hex bytes>              Client data sent in CMSG_HELLO.
+//   bandwidth <bits per second>    Receive bandwidth sent in CMSG_UPDATE.
+//   message <period> <hex bytes>   Message sent to the server shell every
+//                                  <period> updates while in the world.
+
+#ifndef __SERVER_BOTS_H__
+#define __SERVER_BOTS_H__
+
+	// Connect nBots more bots running the given script (LTNULL for an empty one).
+	// Bots are added on top of the ones already running, which keep their script.
+	LTRESULT sbots_Add(uint32 nBots, const char *pScriptFilename);
+
+	// Disconnect all the bots.
+	void sbots_RemoveAll();
+
+	uint32 sbots_GetNumBots();
+
+	// How many bots have made it into the world.
+	uint32 sbots_GetNumInWorld();
+
+#endif  // __SERVER_BOTS_H__
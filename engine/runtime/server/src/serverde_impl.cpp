@@ -37,6 +37,11 @@
 
 #include "fullintersectline.h"
 
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define SERVERDE_SSE2
+#include <emmintrin.h>
+#endif
+
 //------------------------------------------------------------------
 //------------------------------------------------------------------
 // Holders and their headers.
@@ -119,6 +124,27 @@ public:
 	ObjectList	*m_pBoxTouchList;
 };
 
+// How many candidates are collected before testing them against the sphere.
+#define OBJFIND_BATCH_SIZE	16
+
+// Used by the queries that fill in a BaseObjArray.
+class ObjArrayFindStruct {
+public:
+
+	BaseObjArray<HOBJECT>	*m_pObjArray;
+	uint32		m_nTypeMask;
+	uint32		m_nFlags;
+	uint32		m_nTotalFound;
+
+	// Sphere queries only.
+	LTVector	m_SphereTouchPos;
+	float		m_SphereTouchRadius;
+
+	// Candidates that passed the filters, waiting for the sphere test.
+	LTObject	*m_pBatch[OBJFIND_BATCH_SIZE];
+	uint32		m_nBatch;
+};
+
 class GPCStruct {
 public:
 
@@ -293,6 +319,10 @@ public:
 	virtual bool SetClientData(HCLIENT hClient, uint8 const* pData, int len);
 
 	virtual LTRESULT FindNamedObjects(const char *pName, BaseObjArray<HOBJECT> &objArray, uint32 *nTotalFound);
+	virtual LTRESULT FindObjectsInSphere(const LTVector &vPos, float fRadius, BaseObjArray<HOBJECT> &objArray,
+		uint32 nTypeMask, uint32 nFlags, uint32 *nTotalFound);
+	virtual LTRESULT FindObjectsInBox(const LTVector &vMin, const LTVector &vMax, BaseObjArray<HOBJECT> &objArray,
+		uint32 nTypeMask, uint32 nFlags, uint32 *nTotalFound);
 
 	virtual LTRESULT FindWorldModelObjectIntersections(HOBJECT hObj,
 		const LTVector &vNewPos, const LTRotation &rNewRot, BaseObjArray<HOBJECT> &objArray);
@@ -1610,6 +1640,160 @@ ObjectList* si_GetBoxIntersectors(const LTVector *pMin, const LTVector *pMax)
 	return BFStruct.m_pBoxTouchList;
 }
 
+// Does the object pass the type and flag filters of an array query?
+inline bool ObjArrayFindFilter(const ObjArrayFindStruct *pStruct, const LTObject *pServerObj)
+{
+	if (!(pStruct->m_nTypeMask & OBJTYPE_MASK(pServerObj->m_ObjectType)))
+		return false;
+
+	if ((pServerObj->m_Flags & pStruct->m_nFlags) != pStruct->m_nFlags)
+		return false;
+
+	return !(pServerObj->m_InternalFlags & IFLAG_OBJECTGOINGAWAY);
+}
+
+inline void ObjArrayFindAdd(ObjArrayFindStruct *pStruct, LTObject *pServerObj)
+{
+	pStruct->m_pObjArray->AddObject(ServerObjToHandle(pServerObj));
+	++pStruct->m_nTotalFound;
+}
+
+// Test the batched candidates against the sphere.
+static void ObjArrayFlushSphereBatch(ObjArrayFindStruct *pStruct)
+{
+	uint32 nBatch = pStruct->m_nBatch;
+	uint32 i = 0;
+
+#ifdef SERVERDE_SSE2
+	const __m128 vSphereX = _mm_set1_ps(pStruct->m_SphereTouchPos.x);
+	const __m128 vSphereY = _mm_set1_ps(pStruct->m_SphereTouchPos.y);
+	const __m128 vSphereZ = _mm_set1_ps(pStruct->m_SphereTouchPos.z);
+	const __m128 vSphereRadius = _mm_set1_ps(pStruct->m_SphereTouchRadius);
+
+	for (; (i + 4) <= nBatch; i += 4)
+	{
+		LTObject **ppObj = &pStruct->m_pBatch[i];
+
+		__m128 vX = _mm_setr_ps(ppObj[0]->m_Pos.x, ppObj[1]->m_Pos.x, ppObj[2]->m_Pos.x, ppObj[3]->m_Pos.x);
+		__m128 vY = _mm_setr_ps(ppObj[0]->m_Pos.y, ppObj[1]->m_Pos.y, ppObj[2]->m_Pos.y, ppObj[3]->m_Pos.y);
+		__m128 vZ = _mm_setr_ps(ppObj[0]->m_Pos.z, ppObj[1]->m_Pos.z, ppObj[2]->m_Pos.z, ppObj[3]->m_Pos.z);
+		__m128 vRadius = _mm_setr_ps(ppObj[0]->m_Radius, ppObj[1]->m_Radius, ppObj[2]->m_Radius, ppObj[3]->m_Radius);
+
+		vX = _mm_sub_ps(vX, vSphereX);
+		vY = _mm_sub_ps(vY, vSphereY);
+		vZ = _mm_sub_ps(vZ, vSphereZ);
+		__m128 vDistSqr = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vX, vX), _mm_mul_ps(vY, vY)), _mm_mul_ps(vZ, vZ));
+
+		vRadius = _mm_add_ps(vRadius, vSphereRadius);
+		int nMask = _mm_movemask_ps(_mm_cmplt_ps(vDistSqr, _mm_mul_ps(vRadius, vRadius)));
+
+		for (uint32 j = 0; j < 4; j++)
+		{
+			if (nMask & (1 << j))
+				ObjArrayFindAdd(pStruct, ppObj[j]);
+		}
+	}
+#endif
+
+	for (; i < nBatch; i++)
+	{
+		LTObject *pServerObj	= pStruct->m_pBatch[i];
+		float fFullRadius		= pServerObj->GetRadius() + pStruct->m_SphereTouchRadius;
+
+		if ((pServerObj->GetPos() - pStruct->m_SphereTouchPos).MagSqr() < fFullRadius * fFullRadius)
+			ObjArrayFindAdd(pStruct, pServerObj);
+	}
+
+	pStruct->m_nBatch = 0;
+}
+
+void ObjArraySphereFindCallback(WorldTreeObj *pObj, void *pCBUser)
+{
+	if (pObj->GetObjType() != WTObj_DObject)
+		return;
+
+	ObjArrayFindStruct *pStruct	= (ObjArrayFindStruct*)pCBUser;
+	LTObject *pServerObj		= (LTObject*)pObj;
+
+	if (!ObjArrayFindFilter(pStruct, pServerObj))
+		return;
+
+	pStruct->m_pBatch[pStruct->m_nBatch++] = pServerObj;
+	if (pStruct->m_nBatch == OBJFIND_BATCH_SIZE)
+		ObjArrayFlushSphereBatch(pStruct);
+}
+
+void ObjArrayBoxFindCallback(WorldTreeObj *pObj, void *pCBUser)
+{
+	if (pObj->GetObjType() != WTObj_DObject)
+		return;
+
+	ObjArrayFindStruct *pStruct	= (ObjArrayFindStruct*)pCBUser;
+	LTObject *pServerObj		= (LTObject*)pObj;
+
+	if (ObjArrayFindFilter(pStruct, pServerObj))
+		ObjArrayFindAdd(pStruct, pServerObj);
+}
+
+LTRESULT CLTServer::FindObjectsInSphere(const LTVector &vPos, float fRadius, BaseObjArray<HOBJECT> &objArray,
+	uint32 nTypeMask, uint32 nFlags, uint32 *nTotalFound)
+{
+	FN_NAME(CLTServer::FindObjectsInSphere);
+
+	// Make sure array is clean...
+	objArray.Reset();
+
+	ObjArrayFindStruct theStruct;
+	theStruct.m_pObjArray = &objArray;
+	theStruct.m_nTypeMask = nTypeMask;
+	theStruct.m_nFlags = nFlags;
+	theStruct.m_nTotalFound = 0;
+	theStruct.m_SphereTouchPos = vPos;
+	theStruct.m_SphereTouchRadius = fRadius;
+	theStruct.m_nBatch = 0;
+
+	Counter cntTicks;
+	cnt_StartCounter(cntTicks);
+
+	LTVector boxMin = vPos - LTVector(fRadius, fRadius, fRadius);
+	LTVector boxMax = vPos + LTVector(fRadius, fRadius, fRadius);
+
+	world_bsp_server->ServerTree()->FindObjectsInBox(&boxMin, &boxMax, ObjArraySphereFindCallback, &theStruct);
+	ObjArrayFlushSphereBatch(&theStruct);
+
+	g_SphereFindTicks += cnt_EndCounter(cntTicks);
+
+	g_SphereFindCount += theStruct.m_nTotalFound;
+
+	if (nTotalFound)
+		*nTotalFound = theStruct.m_nTotalFound;
+
+	return LT_OK;
+}
+
+LTRESULT CLTServer::FindObjectsInBox(const LTVector &vMin, const LTVector &vMax, BaseObjArray<HOBJECT> &objArray,
+	uint32 nTypeMask, uint32 nFlags, uint32 *nTotalFound)
+{
+	FN_NAME(CLTServer::FindObjectsInBox);
+
+	// Make sure array is clean...
+	objArray.Reset();
+
+	ObjArrayFindStruct theStruct;
+	theStruct.m_pObjArray = &objArray;
+	theStruct.m_nTypeMask = nTypeMask;
+	theStruct.m_nFlags = nFlags;
+	theStruct.m_nTotalFound = 0;
+	theStruct.m_nBatch = 0;
+
+	world_bsp_server->ServerTree()->FindObjectsInBox(&vMin, &vMax, ObjArrayBoxFindCallback, &theStruct);
+
+	if (nTotalFound)
+		*nTotalFound = theStruct.m_nTotalFound;
+
+	return LT_OK;
+}
+
 void si_RelinquishList(ObjectList *pList)
 {
 	if (!pList) 
@@ -45,6 +45,10 @@
 #include <time.h>
 #include "ltobjref.h"
 
+#include "server_bench.h"
+
+#include "ltjs_profiler.h"
+
 
 // [KLS 4/19/02] - All the class-tick stuff is really just debugging info, so make sure we aren't
 // wasting anytime doing anything in final builds...
@@ -110,6 +114,7 @@ extern int32 g_CV_ShowClassTicks;
 
 extern int32 g_CV_ShowGameTime;
 extern int32 g_CV_ShowSphereFindTicks;
+extern int32 g_CV_ShowPoseCacheStats;
 
 extern int32 g_CV_BandwidthTargetServer;
 
@@ -337,12 +342,22 @@ void sm_UpdateClientStates()
 void sm_UpdateClientsInWorld() 
 {
 	LTLink *pListHead = &g_pServerMgr->m_Clients.m_Head;
+
+	if (pListHead->m_pNext != pListHead)
+	{
+		CSBenchPhaseTimer cBenchClient(eSBench_ClientUpdates);
+		sm_CompressUnguaranteedInfo();
+	}
+
 	for (LTLink *pCur = pListHead->m_pNext; pCur != pListHead; pCur = pCur->m_pNext) 
 	{
 		Client *pClient = (Client*)pCur->m_pData;
+		CSBenchPhaseTimer cBenchClient(eSBench_ClientUpdates);
 		sm_UpdateClientInWorld(pClient);
 	}
 
+	sm_ClearUnguaranteedInfo();
+
 	// Clear the send/drop counts
 	g_pServerMgr->m_nSendPackets = 0;
 	g_pServerMgr->m_nDroppedSendPackets = 0;
@@ -1066,10 +1081,14 @@ void CServerMgr::RemoveSounds()
 
 bool CServerMgr::Update(int32 updateFlags, uint32 nCurTimeMS)
 {
+	LTJS_PROFILE_ZONE("ServerMgr::Update");
+
 	#ifdef DE_SERVER_COMPILE
 	static float s_serverSleepSecs = 0.0f;
 	#endif // DE_SERVER_COMPILE
 
+	CSBenchUpdateScope cBenchUpdate;
+
 	int32 nOffsetTimeMS = (int32)nCurTimeMS + m_nTimeOffsetMS;
 
 	float curTime = nOffsetTimeMS / 1000.0f;
@@ -1087,6 +1106,7 @@ bool CServerMgr::Update(int32 updateFlags, uint32 nCurTimeMS)
 	g_Ticks_Intersect = g_nIntersectCalls = 0;
 	g_SphereFindTicks = 0;
 	g_SphereFindCount = 0;
+	ModelInstance::GetPoseCacheStats(ServerType).Clear();
 
 
 	// Update the client flow control if necessary
@@ -1108,8 +1128,11 @@ bool CServerMgr::Update(int32 updateFlags, uint32 nCurTimeMS)
 		if (g_LockServerFPS)
 			timeStart = time_GetTime();
 
-		if (ProcessIncomingPackets() != LT_OK)
-			return false;
+		{
+			CSBenchPhaseTimer cBenchPackets(eSBench_Packets);
+			if (ProcessIncomingPackets() != LT_OK)
+				return false;
+		}
 
 		if (g_LockServerFPS)
 		{
@@ -1132,8 +1155,11 @@ bool CServerMgr::Update(int32 updateFlags, uint32 nCurTimeMS)
 	s_serverSleepSecs = 0.0f; // reset
 #else
 	
-	if (ProcessIncomingPackets() != LT_OK)
-		return false;
+	{
+		CSBenchPhaseTimer cBenchPackets(eSBench_Packets);
+		if (ProcessIncomingPackets() != LT_OK)
+			return false;
+	}
 
 #endif // if DE_SERVER_COMPILE
 
@@ -1182,11 +1208,15 @@ bool CServerMgr::Update(int32 updateFlags, uint32 nCurTimeMS)
 
 			// Update the server shell.
 			if (i_server_shell != NULL) {
+				CSBenchPhaseTimer cBenchShell(eSBench_ServerShell);
 				i_server_shell->Update(m_FrameTime);
 			}
 
 			// Update the objects.
-			PreUpdateObjects();
+			{
+				CSBenchPhaseTimer cBenchObjects(eSBench_Objects);
+				PreUpdateObjects();
+			}
 
 			m_nTrueFrameTimeMS = 0; // Reset 
 
@@ -1237,6 +1267,13 @@ bool CServerMgr::Update(int32 updateFlags, uint32 nCurTimeMS)
 		dsi_ConsolePrint("ILTServer::FindObjectsTouchingSphere count: %d", g_SphereFindCount);
 	}
 
+	if (g_CV_ShowPoseCacheStats)
+	{
+		const ModelInstance::SPoseCacheStats &PoseStats = ModelInstance::GetPoseCacheStats(ServerType);
+		dsi_ConsolePrint("Server pose cache: %u hits, %u misses, %u evaluations", 
+			PoseStats.m_nHits, PoseStats.m_nMisses, PoseStats.m_nEvaluations);
+	}
+
 	return true;
 }
 
@@ -11,6 +11,11 @@
 #include "compress.h"
 #include "packetdefs.h"
 
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define COMPRESS_SSE2
+#include <emmintrin.h>
+#endif
+
 class CCompress : public ICompress
 {
 public:
@@ -27,6 +32,17 @@ public:
 	void EncodeCompressRotation(const LTRotation *pRot, CompRot *pCompRot);
 	void UncompressRotation(char *bytes, LTRotation *pRot);
 
+	void EncodeCompressVectors( CompVector *pCVecs, const LTVector *pVals, uint32 nCount );
+	void DecodeCompressVectors( LTVector *pVals, const CompVector *pCVecs, uint32 nCount );
+	void EncodeCompressWorldPositions(CompWorldPos *pPos, const LTVector *pVals, uint32 nCount,
+		const LTVector &world_pos_min, const LTVector &world_pos_inv_diff,
+		bool bHiRes = true);
+	void DecodeCompressWorldPositions(LTVector *pVals, const CompWorldPos *pPos, uint32 nCount,
+		const LTVector &world_pos_min, const LTVector &world_pos_max,
+		bool bHiRes = true);
+	void EncodeCompressRotations(const LTRotation *pRots, CompRot *pCompRots, uint32 nCount);
+	void UncompressRotations(const CompRot *pCompRots, LTRotation *pRots, uint32 nCount);
+
 	// CCompress helper function (not in ICompress)
 protected:
 	void UncompressSuperRotation(const char *bytes, LTVector *up, LTVector *forward);
@@ -330,3 +346,563 @@ void CCompress::EncodeCompressRotation(const LTRotation *pRot, CompRot *pCompRot
 	}
 }
 
+
+// ------------------------------------------------------------------ //
+// Array versions
+//
+// The SSE2 paths work on 4 elements at a time, transposed so that each register
+// holds one component of 4 elements.  Every operation is done in the same order
+// as in the single versions, so the results are identical.  Leftover elements
+// go through the single versions.
+// ------------------------------------------------------------------ //
+
+#ifdef COMPRESS_SSE2
+
+// 4 vectors, one component per register
+struct SVector4
+{
+	__m128 x, y, z;
+};
+
+static inline SVector4 LoadVectors4(const LTVector *pVals)
+{
+	SVector4 vResult;
+	vResult.x = _mm_setr_ps(pVals[0].x, pVals[1].x, pVals[2].x, pVals[3].x);
+	vResult.y = _mm_setr_ps(pVals[0].y, pVals[1].y, pVals[2].y, pVals[3].y);
+	vResult.z = _mm_setr_ps(pVals[0].z, pVals[1].z, pVals[2].z, pVals[3].z);
+	return vResult;
+}
+
+static inline void StoreVectors4(LTVector *pVals, const SVector4 &vVals)
+{
+	float aX[4], aY[4], aZ[4];
+	_mm_storeu_ps(aX, vVals.x);
+	_mm_storeu_ps(aY, vVals.y);
+	_mm_storeu_ps(aZ, vVals.z);
+
+	for (uint32 i = 0; i < 4; i++)
+	{
+		pVals[i].Init(aX[i], aY[i], aZ[i]);
+	}
+}
+
+// Per-element (mask ? a : b)
+static inline __m128 Select4(__m128 vMask, __m128 vA, __m128 vB)
+{
+	return _mm_or_ps(_mm_and_ps(vMask, vA), _mm_andnot_ps(vMask, vB));
+}
+
+static inline SVector4 Select4(__m128 vMask, const SVector4 &vA, const SVector4 &vB)
+{
+	SVector4 vResult;
+	vResult.x = Select4(vMask, vA.x, vB.x);
+	vResult.y = Select4(vMask, vA.y, vB.y);
+	vResult.z = Select4(vMask, vA.z, vB.z);
+	return vResult;
+}
+
+// a.Dot(b)
+static inline __m128 Dot4(const SVector4 &vA, const SVector4 &vB)
+{
+	return _mm_add_ps(_mm_add_ps(_mm_mul_ps(vA.x, vB.x), _mm_mul_ps(vA.y, vB.y)), _mm_mul_ps(vA.z, vB.z));
+}
+
+// a.Cross(b)
+static inline SVector4 Cross4(const SVector4 &vA, const SVector4 &vB)
+{
+	SVector4 vResult;
+	vResult.x = _mm_sub_ps(_mm_mul_ps(vB.y, vA.z), _mm_mul_ps(vB.z, vA.y));
+	vResult.y = _mm_sub_ps(_mm_mul_ps(vB.z, vA.x), _mm_mul_ps(vB.x, vA.z));
+	vResult.z = _mm_sub_ps(_mm_mul_ps(vB.x, vA.y), _mm_mul_ps(vB.y, vA.x));
+	return vResult;
+}
+
+static inline SVector4 Scale4(const SVector4 &vA, __m128 vScale)
+{
+	SVector4 vResult;
+	vResult.x = _mm_mul_ps(vA.x, vScale);
+	vResult.y = _mm_mul_ps(vA.y, vScale);
+	vResult.z = _mm_mul_ps(vA.z, vScale);
+	return vResult;
+}
+
+// a.Norm(), which leaves zero length vectors alone
+static inline SVector4 Norm4(const SVector4 &vA)
+{
+	__m128 vMag = _mm_sqrt_ps(Dot4(vA, vA));
+	__m128 vInv = _mm_div_ps(_mm_set1_ps(1.0f), vMag);
+	return Select4(_mm_cmpneq_ps(vMag, _mm_setzero_ps()), Scale4(vA, vInv), vA);
+}
+
+// The (char) cast of a float : truncate, then keep the low byte
+static inline __m128i FloatToChar4(__m128 vVal)
+{
+	return _mm_srai_epi32(_mm_slli_epi32(_mm_cvttps_epi32(vVal), 24), 24);
+}
+
+// Set the lanes one by one rather than loading the array, which was just written a lane at a
+// time and would stall the load until the stores retire
+static inline __m128 IntsToFloat4(const int32 *pVals)
+{
+	return _mm_cvtepi32_ps(_mm_setr_epi32(pVals[0], pVals[1], pVals[2], pVals[3]));
+}
+
+// Forward vector of a compressed rotation, from bytes 0-2
+static inline SVector4 UncompressForward4(__m128 vByte0, __m128 vByte1, __m128 vByte2)
+{
+	const __m128 v127 = _mm_set1_ps(127.0f);
+	const __m128 vHalf = _mm_set1_ps(0.5f);
+	const __m128 vTwo = _mm_set1_ps(2.0f);
+
+	SVector4 vForward;
+	vForward.x = _mm_mul_ps(_mm_sub_ps(_mm_div_ps(vByte1, v127), vHalf), vTwo);
+	vForward.y = _mm_mul_ps(_mm_sub_ps(_mm_div_ps(vByte0, v127), vHalf), vTwo);
+	vForward.z = _mm_div_ps(vByte2, v127);
+	return vForward;
+}
+
+// Up vector of a super-compressed rotation, see UncompressSuperRotation
+static inline SVector4 UncompressSuperUp4(const SVector4 &vForward)
+{
+	SVector4 vUp = vForward;
+	vUp.y = _mm_add_ps(vUp.y, _mm_set1_ps(50.0f));
+
+	__m128 vT = _mm_div_ps(_mm_xor_ps(Dot4(vForward, vUp), _mm_set1_ps(-0.0f)), Dot4(vForward, vForward));
+
+	vUp.x = _mm_add_ps(vUp.x, _mm_mul_ps(vForward.x, vT));
+	vUp.y = _mm_add_ps(vUp.y, _mm_mul_ps(vForward.y, vT));
+	vUp.z = _mm_add_ps(vUp.z, _mm_mul_ps(vForward.z, vT));
+	return vUp;
+}
+
+#endif // COMPRESS_SSE2
+
+void CCompress::EncodeCompressVectors( CompVector *pCVecs, const LTVector *pVals, uint32 nCount )
+{
+	uint32 i = 0;
+
+#ifdef COMPRESS_SSE2
+	const __m128 vAbsMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+	const __m128 vZero = _mm_setzero_ps();
+	const __m128 vRange = _mm_set1_ps(( float )(( 1 << 18 ) - 1 ));
+	const __m128i vValueMask = _mm_set1_epi32(( 1 << 18 ) - 1 );
+	const __m128i vHighMask = _mm_set1_epi32(0x03);
+
+	for ( ; (i + 4) <= nCount; i += 4)
+	{
+		SVector4 vVal = LoadVectors4(&pVals[i]);
+
+		__m128 vAbsX = _mm_and_ps(vVal.x, vAbsMask);
+		__m128 vAbsY = _mm_and_ps(vVal.y, vAbsMask);
+		__m128 vAbsZ = _mm_and_ps(vVal.z, vAbsMask);
+
+		// Pick the coord with the largest mag...
+		__m128 vUseY = _mm_cmpgt_ps(vAbsY, vAbsX);
+		__m128 vA = Select4(vUseY, vVal.y, vVal.x);
+		__m128 vB = Select4(vUseY, vVal.x, vVal.y);
+		__m128 vC = vVal.z;
+		__m128 vAbsA = Select4(vUseY, vAbsY, vAbsX);
+
+		__m128 vUseZ = _mm_cmpgt_ps(vAbsZ, vAbsA);
+		vA = Select4(vUseZ, vVal.z, vA);
+		vB = Select4(vUseZ, vVal.x, vB);
+		vC = Select4(vUseZ, vVal.y, vC);
+		vAbsA = Select4(vUseZ, vAbsZ, vAbsA);
+
+		// Create the scaled values.  The mask only matters for a zero vector, where
+		// the ratio is 0/0, and gives the same 0 the single version ends up with.
+		__m128i vDWB = _mm_and_si128(_mm_cvttps_epi32(_mm_mul_ps(_mm_div_ps(_mm_and_ps(vB, vAbsMask), vAbsA), vRange)), vValueMask);
+		__m128i vDWC = _mm_and_si128(_mm_cvttps_epi32(_mm_mul_ps(_mm_div_ps(_mm_and_ps(vC, vAbsMask), vAbsA), vRange)), vValueMask);
+
+		__m128 vANeg = _mm_cmplt_ps(vA, vZero);
+		__m128i vFlipB = _mm_castps_si128(_mm_xor_ps(_mm_cmplt_ps(vB, vZero), vANeg));
+		__m128i vFlipC = _mm_castps_si128(_mm_xor_ps(_mm_cmplt_ps(vC, vZero), vANeg));
+
+		__m128i vOrder = _mm_or_si128(
+			_mm_and_si128(_mm_castps_si128(_mm_andnot_ps(vUseZ, vUseY)), _mm_set1_epi32( 1 << 6 )),
+			_mm_and_si128(_mm_castps_si128(vUseZ), _mm_set1_epi32( 1 << 7 )));
+		vOrder = _mm_or_si128(vOrder, _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(vDWB, 16), vHighMask), 3));
+		vOrder = _mm_or_si128(vOrder, _mm_and_si128(vFlipB, _mm_set1_epi32( 1 << 5 )));
+		vOrder = _mm_or_si128(vOrder, _mm_and_si128(_mm_srli_epi32(vDWC, 16), vHighMask));
+		vOrder = _mm_or_si128(vOrder, _mm_and_si128(vFlipC, _mm_set1_epi32( 1 << 2 )));
+
+		float aA[4];
+		uint32 aB[4], aC[4], aOrder[4];
+		_mm_storeu_ps(aA, vA);
+		_mm_storeu_si128((__m128i*)aB, vDWB);
+		_mm_storeu_si128((__m128i*)aC, vDWC);
+		_mm_storeu_si128((__m128i*)aOrder, vOrder);
+
+		for (uint32 j = 0; j < 4; j++)
+		{
+			CompVector *pCVec = &pCVecs[i + j];
+			pCVec->fA = aA[j];
+			pCVec->dwB = aB[j];
+			pCVec->dwC = aC[j];
+			pCVec->order = ( unsigned char )aOrder[j];
+		}
+	}
+#endif // COMPRESS_SSE2
+
+	for ( ; i < nCount; i++)
+	{
+		EncodeCompressVector( &pCVecs[i], &pVals[i] );
+	}
+}
+
+void CCompress::DecodeCompressVectors( LTVector *pVals, const CompVector *pCVecs, uint32 nCount )
+{
+	uint32 i = 0;
+
+#ifdef COMPRESS_SSE2
+	const __m128i vHighMask = _mm_set1_epi32(0x03);
+	const __m128 vScale = _mm_set1_ps(( float )( 1 << 18 ));
+	const __m128 vOne = _mm_set1_ps(1.0f);
+	const __m128 vNegOne = _mm_set1_ps(-1.0f);
+	const __m128i vFlipB = _mm_set1_epi32( 1 << 5 );
+	const __m128i vFlipC = _mm_set1_epi32( 1 << 2 );
+
+	for ( ; (i + 4) <= nCount; i += 4)
+	{
+		// Note : dwB and dwC are never more than 16 bits, so the signed conversion is safe
+		float aA[4];
+		uint32 aB[4], aC[4], aOrder[4];
+		for (uint32 j = 0; j < 4; j++)
+		{
+			const CompVector *pCVec = &pCVecs[i + j];
+			aA[j] = pCVec->fA;
+			aB[j] = pCVec->dwB;
+			aC[j] = pCVec->dwC;
+			aOrder[j] = pCVec->order;
+		}
+
+		__m128 vA = _mm_loadu_ps(aA);
+		__m128i vOrder = _mm_loadu_si128((const __m128i*)aOrder);
+
+		__m128i vDWB = _mm_add_epi32(_mm_loadu_si128((const __m128i*)aB), _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(vOrder, 3), vHighMask), 16));
+		__m128 vB = _mm_div_ps(_mm_mul_ps(vA, _mm_cvtepi32_ps(vDWB)), vScale);
+		vB = _mm_mul_ps(vB, Select4(_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(vOrder, vFlipB), vFlipB)), vNegOne, vOne));
+
+		__m128i vDWC = _mm_add_epi32(_mm_loadu_si128((const __m128i*)aC), _mm_slli_epi32(_mm_and_si128(vOrder, vHighMask), 16));
+		__m128 vC = _mm_div_ps(_mm_mul_ps(vA, _mm_cvtepi32_ps(vDWC)), vScale);
+		vC = _mm_mul_ps(vC, Select4(_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(vOrder, vFlipC), vFlipC)), vNegOne, vOne));
+
+		// Put the coords back in place (order 3 is treated as 0)
+		__m128i vCase = _mm_srli_epi32(vOrder, 6);
+		__m128 vCase1 = _mm_castsi128_ps(_mm_cmpeq_epi32(vCase, _mm_set1_epi32(1)));
+		__m128 vCase2 = _mm_castsi128_ps(_mm_cmpeq_epi32(vCase, _mm_set1_epi32(2)));
+
+		SVector4 vVal;
+		vVal.x = Select4(_mm_or_ps(vCase1, vCase2), vB, vA);
+		vVal.y = Select4(vCase1, vA, Select4(vCase2, vC, vB));
+		vVal.z = Select4(vCase2, vA, vC);
+
+		StoreVectors4(&pVals[i], vVal);
+	}
+#endif // COMPRESS_SSE2
+
+	for ( ; i < nCount; i++)
+	{
+		DecodeCompressVector( &pVals[i], &pCVecs[i] );
+	}
+}
+
+void CCompress::EncodeCompressWorldPositions(CompWorldPos *pPos, const LTVector *pVals, uint32 nCount,
+	const LTVector &world_pos_min, const LTVector &world_pos_inv_diff, bool bHiRes)
+{
+	uint32 i = 0;
+
+#ifdef COMPRESS_SSE2
+	const SVector4 vMin = { _mm_set1_ps(world_pos_min.x), _mm_set1_ps(world_pos_min.y), _mm_set1_ps(world_pos_min.z) };
+	const SVector4 vInvDiff = { _mm_set1_ps(world_pos_inv_diff.x), _mm_set1_ps(world_pos_inv_diff.y), _mm_set1_ps(world_pos_inv_diff.z) };
+	const SVector4 vScale = {
+		_mm_set1_ps((float)((1 << NUM_POSITION_BITS_X) - 1)),
+		_mm_set1_ps((float)((1 << NUM_POSITION_BITS_Y) - 1)),
+		_mm_set1_ps((float)((1 << NUM_POSITION_BITS_Z) - 1)) };
+	const __m128 vZero = _mm_setzero_ps();
+	const __m128 vHalf = _mm_set1_ps(0.5f);
+
+	for ( ; (i + 4) <= nCount; i += 4)
+	{
+		SVector4 vVal = LoadVectors4(&pVals[i]);
+
+		// Scale, clamp to the valid range, and round
+		__m128 vX = _mm_mul_ps(_mm_mul_ps(_mm_sub_ps(vVal.x, vMin.x), vInvDiff.x), vScale.x);
+		__m128 vY = _mm_mul_ps(_mm_mul_ps(_mm_sub_ps(vVal.y, vMin.y), vInvDiff.y), vScale.y);
+		__m128 vZ = _mm_mul_ps(_mm_mul_ps(_mm_sub_ps(vVal.z, vMin.z), vInvDiff.z), vScale.z);
+
+		__m128i vXVal = _mm_cvttps_epi32(_mm_add_ps(_mm_max_ps(_mm_min_ps(vX, vScale.x), vZero), vHalf));
+		__m128i vYVal = _mm_cvttps_epi32(_mm_add_ps(_mm_max_ps(_mm_min_ps(vY, vScale.y), vZero), vHalf));
+		__m128i vZVal = _mm_cvttps_epi32(_mm_add_ps(_mm_max_ps(_mm_min_ps(vZ, vScale.z), vZero), vHalf));
+
+		__m128i vExtra = _mm_setzero_si128();
+		if( bHiRes )
+		{
+			vExtra = _mm_and_si128(vXVal, _mm_set1_epi32((1 << NUM_EXTRA_BITS_X) - 1));
+			vExtra = _mm_or_si128(vExtra, _mm_slli_epi32(_mm_and_si128(vYVal, _mm_set1_epi32((1 << NUM_EXTRA_BITS_Y) - 1)), NUM_EXTRA_BITS_X));
+			vExtra = _mm_or_si128(vExtra, _mm_slli_epi32(_mm_and_si128(vZVal, _mm_set1_epi32((1 << NUM_EXTRA_BITS_Z) - 1)), NUM_EXTRA_BITS_X + NUM_EXTRA_BITS_Y));
+		}
+
+		uint32 aX[4], aY[4], aZ[4], aExtra[4];
+		_mm_storeu_si128((__m128i*)aX, _mm_srli_epi32(vXVal, NUM_EXTRA_BITS_X));
+		_mm_storeu_si128((__m128i*)aY, _mm_srli_epi32(vYVal, NUM_EXTRA_BITS_Y));
+		_mm_storeu_si128((__m128i*)aZ, _mm_srli_epi32(vZVal, NUM_EXTRA_BITS_Z));
+		_mm_storeu_si128((__m128i*)aExtra, vExtra);
+
+		for (uint32 j = 0; j < 4; j++)
+		{
+			CompWorldPos *pCur = &pPos[i + j];
+			pCur->m_Pos[0] = (uint16)(aX[j] & 0xFFFF);
+			pCur->m_Pos[1] = (uint16)(aY[j] & 0xFFFF);
+			pCur->m_Pos[2] = (uint16)(aZ[j] & 0xFFFF);
+			pCur->m_Extra = (uint8)aExtra[j];
+		}
+	}
+#endif // COMPRESS_SSE2
+
+	for ( ; i < nCount; i++)
+	{
+		EncodeCompressWorldPosition(&pPos[i], &pVals[i], world_pos_min, world_pos_inv_diff, bHiRes);
+	}
+}
+
+void CCompress::DecodeCompressWorldPositions(LTVector *pVals, const CompWorldPos *pPos, uint32 nCount,
+	const LTVector &world_pos_min, const LTVector &world_pos_max, bool bHiRes)
+{
+	uint32 i = 0;
+
+#ifdef COMPRESS_SSE2
+	const LTVector vLowBias((1 << NUM_EXTRA_BITS_X) / 2, (1 << NUM_EXTRA_BITS_Y) / 2, (1 << NUM_EXTRA_BITS_Z) / 2);
+	const LTVector vHighBias(0.5f, 0.5f, 0.5f);
+	const LTVector &vBias = (bHiRes) ? vHighBias : vLowBias;
+	const LTVector vDiff = world_pos_max - world_pos_min;
+
+	const SVector4 vMin = { _mm_set1_ps(world_pos_min.x), _mm_set1_ps(world_pos_min.y), _mm_set1_ps(world_pos_min.z) };
+	const SVector4 vRange = { _mm_set1_ps(vDiff.x), _mm_set1_ps(vDiff.y), _mm_set1_ps(vDiff.z) };
+	const SVector4 vBias4 = { _mm_set1_ps(vBias.x), _mm_set1_ps(vBias.y), _mm_set1_ps(vBias.z) };
+	// The scales are powers of two, so multiplying by their inverse rounds the same as the divide
+	const SVector4 vInvScale = {
+		_mm_set1_ps(1.0f / (float)(1 << NUM_POSITION_BITS_X)),
+		_mm_set1_ps(1.0f / (float)(1 << NUM_POSITION_BITS_Y)),
+		_mm_set1_ps(1.0f / (float)(1 << NUM_POSITION_BITS_Z)) };
+
+	for ( ; (i + 4) <= nCount; i += 4)
+	{
+		int32 aX[4], aY[4], aZ[4];
+		for (uint32 j = 0; j < 4; j++)
+		{
+			const CompWorldPos *pCur = &pPos[i + j];
+			aX[j] = (pCur->m_Pos[0] << NUM_EXTRA_BITS_X);
+			aY[j] = (pCur->m_Pos[1] << NUM_EXTRA_BITS_Y);
+			aZ[j] = (pCur->m_Pos[2] << NUM_EXTRA_BITS_Z);
+
+			if( bHiRes )
+			{
+				aX[j] += (pCur->m_Extra & ((1 << NUM_EXTRA_BITS_X) - 1));
+				aY[j] += (pCur->m_Extra & ((1 << (NUM_EXTRA_BITS_X + NUM_EXTRA_BITS_Y)) - 1)) >> NUM_EXTRA_BITS_X;
+				aZ[j] += (pCur->m_Extra & ((1 << (NUM_EXTRA_BITS_X + NUM_EXTRA_BITS_Y + NUM_EXTRA_BITS_Z)) - 1)) >> (NUM_EXTRA_BITS_X + NUM_EXTRA_BITS_Y);
+			}
+		}
+
+		SVector4 vVal;
+		vVal.x = _mm_add_ps(vMin.x, _mm_mul_ps(vRange.x, _mm_mul_ps(_mm_add_ps(IntsToFloat4(aX), vBias4.x), vInvScale.x)));
+		vVal.y = _mm_add_ps(vMin.y, _mm_mul_ps(vRange.y, _mm_mul_ps(_mm_add_ps(IntsToFloat4(aY), vBias4.y), vInvScale.y)));
+		vVal.z = _mm_add_ps(vMin.z, _mm_mul_ps(vRange.z, _mm_mul_ps(_mm_add_ps(IntsToFloat4(aZ), vBias4.z), vInvScale.z)));
+
+		StoreVectors4(&pVals[i], vVal);
+	}
+#endif // COMPRESS_SSE2
+
+	for ( ; i < nCount; i++)
+	{
+		DecodeCompressWorldPosition(&pVals[i], &pPos[i], world_pos_min, world_pos_max, bHiRes);
+	}
+}
+
+void CCompress::EncodeCompressRotations(const LTRotation *pRots, CompRot *pCompRots, uint32 nCount)
+{
+	uint32 i = 0;
+
+#ifdef COMPRESS_SSE2
+	const __m128 vOne = _mm_set1_ps(1.0f);
+	const __m128 vHalfRange = _mm_set1_ps(63.9f);
+	const __m128 vRange = _mm_set1_ps(127.9f);
+	const __m128 vLimit = _mm_set1_ps(ROTATION_COMPRESS_LIMIT);
+	const __m128 vNegLimit = _mm_set1_ps(-ROTATION_COMPRESS_LIMIT);
+
+	for ( ; (i + 4) <= nCount; i += 4)
+	{
+		const LTRotation *pRot = &pRots[i];
+		__m128 vQX = _mm_setr_ps(pRot[0].m_Quat[0], pRot[1].m_Quat[0], pRot[2].m_Quat[0], pRot[3].m_Quat[0]);
+		__m128 vQY = _mm_setr_ps(pRot[0].m_Quat[1], pRot[1].m_Quat[1], pRot[2].m_Quat[1], pRot[3].m_Quat[1]);
+		__m128 vQZ = _mm_setr_ps(pRot[0].m_Quat[2], pRot[1].m_Quat[2], pRot[2].m_Quat[2], pRot[3].m_Quat[2]);
+		__m128 vQW = _mm_setr_ps(pRot[0].m_Quat[3], pRot[1].m_Quat[3], pRot[2].m_Quat[3], pRot[3].m_Quat[3]);
+
+		// The parts of quat_ConvertToMatrix we need
+		__m128 vS = _mm_div_ps(_mm_set1_ps(2.0f),
+			_mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(vQX, vQX), _mm_mul_ps(vQY, vQY)), _mm_mul_ps(vQZ, vQZ)), _mm_mul_ps(vQW, vQW)));
+
+		__m128 vXS = _mm_mul_ps(vQX, vS);
+		__m128 vYS = _mm_mul_ps(vQY, vS);
+		__m128 vZS = _mm_mul_ps(vQZ, vS);
+
+		__m128 vWX = _mm_mul_ps(vQW, vXS);
+		__m128 vWY = _mm_mul_ps(vQW, vYS);
+		__m128 vWZ = _mm_mul_ps(vQW, vZS);
+
+		__m128 vXX = _mm_mul_ps(vQX, vXS);
+		__m128 vXY = _mm_mul_ps(vQX, vYS);
+		__m128 vXZ = _mm_mul_ps(vQX, vZS);
+
+		__m128 vYY = _mm_mul_ps(vQY, vYS);
+		__m128 vYZ = _mm_mul_ps(vQY, vZS);
+
+		__m128 vZZ = _mm_mul_ps(vQZ, vZS);
+
+		__m128 vM01 = _mm_sub_ps(vXY, vWZ);
+		__m128 vM02 = _mm_add_ps(vXZ, vWY);
+		__m128 vM11 = _mm_sub_ps(vOne, _mm_add_ps(vXX, vZZ));
+		__m128 vM12 = _mm_sub_ps(vYZ, vWX);
+		__m128 vM21 = _mm_add_ps(vYZ, vWX);
+		__m128 vM22 = _mm_sub_ps(vOne, _mm_add_ps(vXX, vYY));
+
+		__m128i vBytes[6];
+		vBytes[0] = FloatToChar4(_mm_mul_ps(_mm_add_ps(vOne, vM12), vHalfRange));
+		vBytes[1] = FloatToChar4(_mm_mul_ps(_mm_add_ps(vOne, vM02), vHalfRange));
+		vBytes[2] = FloatToChar4(_mm_mul_ps(vM22, vRange));
+		vBytes[3] = FloatToChar4(_mm_mul_ps(vM01, vRange));
+		vBytes[4] = FloatToChar4(_mm_mul_ps(vM11, vRange));
+		vBytes[5] = FloatToChar4(_mm_mul_ps(vM21, vRange));
+
+		// Figure out if we can reduce it to 3 bytes.
+		SVector4 vRealUp = { vM01, vM11, vM21 };
+		SVector4 vForward = UncompressForward4(_mm_cvtepi32_ps(vBytes[0]), _mm_cvtepi32_ps(vBytes[1]), _mm_cvtepi32_ps(vBytes[2]));
+		SVector4 vTestUp = UncompressSuperUp4(vForward);
+
+		__m128 vMagSqr = Dot4(vTestUp, vTestUp);
+		__m128 vValid = _mm_cmpgt_ps(vMagSqr, _mm_set1_ps(0.1f));
+		vTestUp = Scale4(vTestUp, _mm_div_ps(vOne, _mm_sqrt_ps(vMagSqr)));
+
+		__m128 vDot = Dot4(vTestUp, vRealUp);
+		__m128 vSame = _mm_and_ps(vValid, _mm_cmpgt_ps(vDot, vLimit));
+		__m128 vFlipped = _mm_and_ps(vValid, _mm_andnot_ps(vSame, _mm_cmplt_ps(vDot, vNegLimit)));
+
+		int32 aBytes[6][4];
+		for (uint32 nByte = 0; nByte < 6; nByte++)
+		{
+			_mm_storeu_si128((__m128i*)aBytes[nByte], vBytes[nByte]);
+		}
+
+		int nSame = _mm_movemask_ps(vSame);
+		int nFlipped = _mm_movemask_ps(vFlipped);
+
+		for (uint32 j = 0; j < 4; j++)
+		{
+			CompRot *pCompRot = &pCompRots[i + j];
+			for (uint32 nByte = 0; nByte < 6; nByte++)
+			{
+				pCompRot->m_Bytes[nByte] = (char)aBytes[nByte][j];
+			}
+
+			if(nFlipped & (1 << j))
+			{
+				pCompRot->m_Bytes[1] = pCompRot->m_Bytes[1] == 0 ? -1 : -pCompRot->m_Bytes[1];
+			}
+
+			if((nSame | nFlipped) & (1 << j))
+			{
+				pCompRot->m_Bytes[0] = pCompRot->m_Bytes[0] == 0 ? -1 : -pCompRot->m_Bytes[0];
+			}
+		}
+	}
+#endif // COMPRESS_SSE2
+
+	for ( ; i < nCount; i++)
+	{
+		EncodeCompressRotation(&pRots[i], &pCompRots[i]);
+	}
+}
+
+void CCompress::UncompressRotations(const CompRot *pCompRots, LTRotation *pRots, uint32 nCount)
+{
+	uint32 i = 0;
+
+#ifdef COMPRESS_SSE2
+	const __m128 v127 = _mm_set1_ps(127.0f);
+
+	for ( ; (i + 4) <= nCount; i += 4)
+	{
+		// Undo the super-compression markers, as UncompressRotation does, without branching on
+		// them since they're different from one rotation to the next
+		int32 aBytes[6][4];
+		int32 aSuper[4], aFlip[4];
+		for (uint32 j = 0; j < 4; j++)
+		{
+			const char *bytes = pCompRots[i + j].m_Bytes;
+
+			int32 nSuper = -(int32)(bytes[0] < 0);
+			int32 nFlip = nSuper & -(int32)(bytes[1] < 0);
+			aSuper[j] = nSuper;
+			aFlip[j] = nFlip;
+
+			aBytes[0][j] = nSuper ? (char)-bytes[0] : bytes[0];
+			aBytes[1][j] = nFlip ? (char)-bytes[1] : bytes[1];
+			aBytes[2][j] = bytes[2];
+
+			// Only the first 3 bytes are sent for these
+			aBytes[3][j] = bytes[3] & ~nSuper;
+			aBytes[4][j] = bytes[4] & ~nSuper;
+			aBytes[5][j] = bytes[5] & ~nSuper;
+		}
+
+		__m128 vSuper = _mm_castsi128_ps(_mm_setr_epi32(aSuper[0], aSuper[1], aSuper[2], aSuper[3]));
+		__m128 vFlip = _mm_castsi128_ps(_mm_setr_epi32(aFlip[0], aFlip[1], aFlip[2], aFlip[3]));
+
+		SVector4 vForward = UncompressForward4(IntsToFloat4(aBytes[0]), IntsToFloat4(aBytes[1]), IntsToFloat4(aBytes[2]));
+
+		SVector4 vUp;
+		vUp.x = _mm_div_ps(IntsToFloat4(aBytes[3]), v127);
+		vUp.y = _mm_div_ps(IntsToFloat4(aBytes[4]), v127);
+		vUp.z = _mm_div_ps(IntsToFloat4(aBytes[5]), v127);
+
+		SVector4 vSuperUp = Norm4(UncompressSuperUp4(vForward));
+		SVector4 vSuperForward = Norm4(vForward);
+
+		SVector4 vFlippedUp;
+		vFlippedUp.x = _mm_xor_ps(vSuperUp.x, _mm_set1_ps(-0.0f));
+		vFlippedUp.y = _mm_xor_ps(vSuperUp.y, _mm_set1_ps(-0.0f));
+		vFlippedUp.z = _mm_xor_ps(vSuperUp.z, _mm_set1_ps(-0.0f));
+		vSuperUp = Select4(vFlip, vFlippedUp, vSuperUp);
+
+		vUp = Select4(vSuper, vSuperUp, vUp);
+		vForward = Select4(vSuper, vSuperForward, vForward);
+
+		// Fixup.
+		SVector4 vRight = Cross4(vForward, vUp);
+		vForward = Cross4(vUp, vRight); // This ensures that all 3 are orthogonal.
+		vRight = Norm4(vRight);
+		vForward = Norm4(vForward);
+		vUp = Cross4(vRight, vForward);
+
+		LTVector aRight[4], aUp[4], aForward[4];
+		StoreVectors4(aRight, vRight);
+		StoreVectors4(aUp, vUp);
+		StoreVectors4(aForward, vForward);
+
+		// The matrix to quaternion conversion branches on the matrix, so finish each one separately
+		for (uint32 j = 0; j < 4; j++)
+		{
+			LTMatrix mat;
+			Mat_SetBasisVectors(&mat, &aRight[j], &aUp[j], &aForward[j]);
+			quat_ConvertFromMatrix((float*)&pRots[i + j], mat.m);
+		}
+	}
+#endif // COMPRESS_SSE2
+
+	for ( ; i < nCount; i++)
+	{
+		// UncompressRotation changes the bytes it's given
+		CompRot compRot = pCompRots[i];
+		UncompressRotation(compRot.m_Bytes, &pRots[i]);
+	}
+}
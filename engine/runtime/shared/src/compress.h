@@ -43,6 +43,23 @@ public:
 
 	virtual void EncodeCompressRotation(const LTRotation *pRot, CompRot *pCompRot) = 0;
 	virtual void UncompressRotation(char *bytes, LTRotation *pRot) = 0;
+
+	// Array versions of the above.  These give exactly the same results as calling
+	// the single versions on each element, but work on several elements at a time.
+	// Unlike UncompressRotation, UncompressRotations doesn't modify the source bytes.
+
+	virtual void EncodeCompressVectors( CompVector *pCVecs, const LTVector *pVals, uint32 nCount ) = 0;
+	virtual void DecodeCompressVectors( LTVector *pVals, const CompVector *pCVecs, uint32 nCount ) = 0;
+
+	virtual void EncodeCompressWorldPositions(CompWorldPos *pPos, const LTVector *pVals, uint32 nCount,
+		const LTVector &world_pos_min, const LTVector &world_pos_inv_diff,
+		bool bHiRes = true) = 0;
+	virtual void DecodeCompressWorldPositions(LTVector *pVals, const CompWorldPos *pPos, uint32 nCount,
+		const LTVector &world_pos_min, const LTVector &world_pos_max,
+		bool bHiRes = true) = 0;
+
+	virtual void EncodeCompressRotations(const LTRotation *pRots, CompRot *pCompRots, uint32 nCount) = 0;
+	virtual void UncompressRotations(const CompRot *pCompRots, LTRotation *pRots, uint32 nCount) = 0;
 };
 
 
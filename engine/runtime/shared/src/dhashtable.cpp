@@ -11,45 +11,57 @@ extern void dfree(void *ptr);
 // Structures.
 // ------------------------------------------------------------ //
 
-typedef uint32 (*GetCodeFn)(const void *pData, uint32 dataLen);
-typedef int (*CompareKeyFn)(const void *pData1, const void *pData2, uint32 dataLen);
+// The table is open addressed with linear probing over a power of 2 number of slots.
+// Elements are allocated separately so the handles stay valid when the slots are rehashed.
+// Removed elements leave a marker in their slot until the next rehash, so nothing moves
+// on removal and it's safe to remove elements while iterating.
 
 struct HashTable;
 
-struct MapEntry
-{
-	HashTable		*m_pHashTable;
-	uint32	m_Index;
-	uint32	m_nElements;
-	LTLink			m_Elements;
-};
-
 struct HashElement
 {
-	LTLink			m_Link;
-	MapEntry		*m_pMapEntry;
+	HashTable		*m_pHashTable;
+	uint32			m_Index;		// Slot this element is in.
+	uint32			m_Hash;			// Hash of the folded key.
 	void			*m_pUser;
 	unsigned short	m_KeySize;
 	char			m_Key[2];
 };
 
+struct HashSlot
+{
+	uint32			m_Hash;
+	HashElement		*m_pElement;	// NULL if the slot has never been used.
+};
+
 struct HashTable
 {
 	int				m_HashType;
 	uint32	m_nCollisions;
-	uint32	m_MapSize;
-	MapEntry		m_Map[1];
+	uint32	m_nElements;
+	uint32	m_nUsedSlots;		// Elements plus removed markers.
+	uint32	m_MaxProbe;			// Longest distance of an element from its home slot.
+	uint32	m_SlotMask;
+	HashSlot		*m_pSlots;
 };
 
+// Minimum number of slots in a table.
+#define HASH_MIN_SLOTS		16
+
+// Rehash when more than 3/4 of the slots are used.
+#define HASH_MAX_LOAD(nSlots)	(((nSlots) >> 1) + ((nSlots) >> 2))
+
 
 // ------------------------------------------------------------ //
 // Globals.
 // ------------------------------------------------------------ //
 
-static GetCodeFn g_GetHashCodeFns[NUM_HASH_TYPES];
-static CompareKeyFn g_CompareKeyFns[NUM_HASH_TYPES];
 static ObjectBank< HashElement > g_HashElementBank( 32, 64 );
 
+// Marks the slot of a removed element.
+static HashElement g_RemovedElement;
+#define REMOVED_ELEMENT		(&g_RemovedElement)
+
 
 // ------------------------------------------------------------ //
 // Internal functions.
@@ -63,187 +75,255 @@ inline char hs_Toupper(const char theChar)
 		return theChar;
 }
 
-
-static uint32 hs_GetCode_2ByteNumber(const void *pData, uint32 dataLen)
+inline char hs_FilenameChar(char theChar)
 {
-	return *((const unsigned short*)pData);
+	theChar = hs_Toupper(theChar);
+	if(theChar == '/')
+		theChar = '\\';
+
+	return theChar;
 }
 
 
-static uint32 hs_GetCode_StringNoCase(const void *pData, uint32 dataLen)
-{
-	const char *pCurByte;
-	uint32 sum, i;
+// FNV-1a over the key, folded the same way the keys are compared.
+#define FNV_OFFSET_BASIS	2166136261U
+#define FNV_PRIME			16777619U
 
-	sum = 0;
+static uint32 hs_HashKey(int hashType, const void *pData, uint32 dataLen)
+{
+	const char *pCurByte, *pEnd;
+	uint32 hash;
 
+	hash = FNV_OFFSET_BASIS;
 	pCurByte = (const char*)pData;
-	for(i=0; i < dataLen; i++)
-	{
-		sum += ((uint32)hs_Toupper(*pCurByte)) * i;
-		++pCurByte;
-	}
 
-	return sum;
-}
+	switch(hashType)
+	{
+		case HASH_2BYTENUMBER:
+		{
+			hash = (hash ^ (uint8)pCurByte[0]) * FNV_PRIME;
+			hash = (hash ^ (uint8)pCurByte[1]) * FNV_PRIME;
+		}
+		break;
 
-static uint32 hs_GetCode_Raw(const void *pData, uint32 dataLen)
-{
-	const char *pCurByte;
-	uint32 sum, i;
+		case HASH_STRING_NOCASE:
+		{
+			for(pEnd = pCurByte + dataLen; pCurByte < pEnd; ++pCurByte)
+				hash = (hash ^ (uint8)hs_Toupper(*pCurByte)) * FNV_PRIME;
+		}
+		break;
 
-	sum = 0;
+		case HASH_FILENAME:
+		{
+			for(pEnd = pCurByte + dataLen; pCurByte < pEnd; ++pCurByte)
+				hash = (hash ^ (uint8)hs_FilenameChar(*pCurByte)) * FNV_PRIME;
+		}
+		break;
 
-	pCurByte = (const char*)pData;
-	for(i=0; i < dataLen; i++)
-	{
-		sum += ((uint32)*pCurByte) * i;
-		++pCurByte;
+		default:
+		{
+			for(pEnd = pCurByte + dataLen; pCurByte < pEnd; ++pCurByte)
+				hash = (hash ^ (uint8)*pCurByte) * FNV_PRIME;
+		}
+		break;
 	}
 
-	return sum;
+	return hash;
 }
 
-inline char hs_FilenameChar(char theChar)
-{
-	theChar = hs_Toupper(theChar);
-	if(theChar == '/')
-		theChar = '\\';
 
-	return theChar;
-}
-
-static uint32 hs_GetCode_Filename(const void *pData, uint32 dataLen)
+static int hs_CompareKeys(int hashType, const char *pKey1, const char *pKey2, uint32 len)
 {
-	const char *pCurByte;
-	uint32 sum, i;
+	const char *pEndKey1;
 
-	sum = 0;
+	pEndKey1 = pKey1 + len;
 
-	pCurByte = (const char*)pData;
-	for(i=0; i < dataLen; i++)
+	switch(hashType)
 	{
-		sum += ((uint32)hs_FilenameChar(*pCurByte)) * i;
-		++pCurByte;
-	}
+		case HASH_2BYTENUMBER:
+		{
+			return *((const unsigned short*)pKey1) == *((const unsigned short*)pKey2);
+		}
 
-	return sum;
-}
+		case HASH_STRING_NOCASE:
+		{
+			for(; pKey1 < pEndKey1; ++pKey1, ++pKey2)
+			{
+				if(hs_Toupper(*pKey1) != hs_Toupper(*pKey2))
+					return 0;
+			}
+		}
+		break;
 
-static int hs_CompareKey_2ByteNumber(const void *pData1, const void *pData2, uint32 dataLen)
-{
-	unsigned short num1, num2;
+		case HASH_FILENAME:
+		{
+			for(; pKey1 < pEndKey1; ++pKey1, ++pKey2)
+			{
+				if(hs_FilenameChar(*pKey1) != hs_FilenameChar(*pKey2))
+					return 0;
+			}
+		}
+		break;
 
-	num1 = *((const unsigned short*)pData1);
-	num2 = *((const unsigned short*)pData2);
+		default:
+		{
+			return memcmp(pKey1, pKey2, len) == 0;
+		}
+	}
 
-	return num1 == num2;
+	return 1;
 }
 
-static int hs_CompareKey_StringNoCase(const void *pData1, const void *pData2, uint32 dataLen)
+
+// Look for an element with the key, starting at the slot after iStart.
+static HashElement* hs_Probe(HashTable *pTable, uint32 hash, uint32 iStart, const void *pKey, uint32 keyLen)
 {
-	const char *pEndKey1, *pKey1, *pKey2;
+	HashSlot *pSlot;
+	HashElement *pElement;
+	uint32 iSlot;
 
-	pKey1 = (const char*)pData1;
-	pKey2 = (const char*)pData2;
-	pEndKey1 = pKey1 + dataLen;
-	
-	while(pKey1 < pEndKey1)
+	for(iSlot = (iStart + 1) & pTable->m_SlotMask; ; iSlot = (iSlot + 1) & pTable->m_SlotMask)
 	{
-		if(hs_Toupper(*pKey1) != hs_Toupper(*pKey2))
+		pSlot = &pTable->m_pSlots[iSlot];
+		pElement = pSlot->m_pElement;
+
+		if(!pElement)
 			return 0;
 
-		++pKey1;
-		++pKey2;
+		if(pSlot->m_Hash == hash && 
+			pElement != REMOVED_ELEMENT && 
+			pElement->m_KeySize == keyLen &&
+			hs_CompareKeys(pTable->m_HashType, pElement->m_Key, (const char*)pKey, keyLen))
+		{
+			return pElement;
+		}
 	}
-
-	return 1;
 }
 
-static int hs_CompareKey_Raw(const void *pData1, const void *pData2, uint32 dataLen)
+
+// Put the element in the first free slot along its probe sequence, starting at iStart.
+static void hs_InsertElement(HashTable *pTable, HashElement *pElement, uint32 iStart)
 {
-	const char *pEndKey1, *pKey1, *pKey2;
+	HashSlot *pSlot;
+	uint32 iSlot, nProbe;
 
-	pKey1 = (const char*)pData1;
-	pKey2 = (const char*)pData2;
-	pEndKey1 = pKey1 + dataLen;
-	
-	while(pKey1 < pEndKey1)
+	for(iSlot = iStart; ; iSlot = (iSlot + 1) & pTable->m_SlotMask)
 	{
-		if(*pKey1 != *pKey2)
-			return 0;
-
-		++pKey1;
-		++pKey2;
+		pSlot = &pTable->m_pSlots[iSlot];
+		if(!pSlot->m_pElement || pSlot->m_pElement == REMOVED_ELEMENT)
+			break;
 	}
 
-	return 1;
+	if(!pSlot->m_pElement)
+		++pTable->m_nUsedSlots;
+
+	pSlot->m_Hash = pElement->m_Hash;
+	pSlot->m_pElement = pElement;
+	pElement->m_Index = iSlot;
+
+	nProbe = (iSlot - pElement->m_Hash) & pTable->m_SlotMask;
+	if(nProbe > 0)
+		++pTable->m_nCollisions;
+
+	if(nProbe > pTable->m_MaxProbe)
+		pTable->m_MaxProbe = nProbe;
 }
 
-static int hs_CompareKey_Filename(const void *pData1, const void *pData2, uint32 dataLen)
+
+// Elements with the same key are found newest first, as they were when the buckets were
+// lists added to at the head.  The new element takes the slot of the first one with its key,
+// each of those moves up to the next one's slot, and the oldest goes in a free slot after the last.
+static void hs_InsertDuplicate(HashTable *pTable, HashElement *pElement, HashElement *pFirst)
 {
-	const char *pEndKey1, *pKey1, *pKey2;
+	HashElement *pMove, *pCur, *pNext;
+	uint32 iSlot;
 
-	pKey1 = (const char*)pData1;
-	pKey2 = (const char*)pData2;
-	pEndKey1 = pKey1 + dataLen;
-	
-	while(pKey1 < pEndKey1)
+	pMove = pElement;
+	pCur = pFirst;
+	do
 	{
-		if(hs_FilenameChar(*pKey1) != hs_FilenameChar(*pKey2))
-			return 0;
+		iSlot = pCur->m_Index;
+		pNext = hs_Probe(pTable, pElement->m_Hash, iSlot, pElement->m_Key, pElement->m_KeySize);
+
+		pTable->m_pSlots[iSlot].m_pElement = pMove;
+		pMove->m_Index = iSlot;
 
-		++pKey1;
-		++pKey2;
+		pMove = pCur;
+		pCur = pNext;
 	}
+	while(pCur);
 
-	return 1;
+	hs_InsertElement(pTable, pMove, (iSlot + 1) & pTable->m_SlotMask);
 }
 
 
-
-static LTLink* hs_SeekToNext(MapEntry *pMapEntry, LTLink *pCur)
+// Re-insert all the elements into nSlots slots, dropping the removed markers.
+static bool hs_Rehash(HashTable *pTable, uint32 nSlots)
 {
-	for(;;)
-	{
-		pCur = pCur->m_pNext;
-		
-		// If we're at the end, seek to the next map entry.
-		if(pCur == &pMapEntry->m_Elements)
-		{
-			if(pMapEntry->m_Index == (pMapEntry->m_pHashTable->m_MapSize-1))
-			{
-				// All thru..
-				return 0;
-			}
-			else
-			{
-				++pMapEntry;
-				pCur = &pMapEntry->m_Elements;
-				continue;
-			}
-		}
+	HashSlot *pOldSlots, *pNewSlots;
+	HashElement *pElement;
+	uint32 nOldSlots, iStart, i;
 
-		break;
+	LT_MEM_TRACK_ALLOC(pNewSlots = (HashSlot*)dalloc(sizeof(HashSlot) * nSlots),LT_MEM_TYPE_HASHTABLE);
+	if(!pNewSlots)
+		return false;
+
+	memset(pNewSlots, 0, sizeof(HashSlot) * nSlots);
+
+	pOldSlots = pTable->m_pSlots;
+	nOldSlots = pOldSlots ? (pTable->m_SlotMask + 1) : 0;
+
+	// Start from an empty slot so no probe sequence wraps around past the start.  The elements
+	// of each key then go back in the order they're found in, which keeps them newest first.
+	iStart = 0;
+	while(iStart < nOldSlots && pOldSlots[iStart].m_pElement)
+		++iStart;
+
+	pTable->m_pSlots = pNewSlots;
+	pTable->m_SlotMask = nSlots - 1;
+	pTable->m_nUsedSlots = 0;
+	pTable->m_MaxProbe = 0;
+
+	for(i=0; i < nOldSlots; i++)
+	{
+		pElement = pOldSlots[(iStart + i) & (nOldSlots - 1)].m_pElement;
+		if(pElement && pElement != REMOVED_ELEMENT)
+			hs_InsertElement(pTable, pElement, pElement->m_Hash & pTable->m_SlotMask);
 	}
 
-	return pCur;
+	if(pOldSlots)
+		dfree(pOldSlots);
+
+	return true;
 }
 
 
-inline int hs_CompareKeys(HashTable *pTable, const char *pKey1, const char *pKey2, uint32 len)
+// Returns the first element at or after iSlot.
+static HashElement* hs_SeekToNext(HashTable *pTable, uint32 iSlot)
 {
-	return g_CompareKeyFns[pTable->m_HashType](pKey1, pKey2, len);
+	HashElement *pElement;
+
+	for(; iSlot <= pTable->m_SlotMask; iSlot++)
+	{
+		pElement = pTable->m_pSlots[iSlot].m_pElement;
+		if(pElement && pElement != REMOVED_ELEMENT)
+			return pElement;
+	}
+
+	return 0;
 }
 
 
-static uint32 hs_GetMapEntryIndex(HashTable *pTable, const void *pKey, uint32 keyLen)
+static void hs_FreeElement(HashTable *pTable, HashElement *pElement)
 {
-	uint32 sum;
-
-	sum = g_GetHashCodeFns[pTable->m_HashType](pKey, keyLen);
-	sum %= pTable->m_MapSize - 1;
-	return sum;
+	if( pTable->m_HashType == HASH_2BYTENUMBER )
+	{
+		g_HashElementBank.Free( pElement );
+	}
+	else
+	{
+		dfree(pElement);
+	}
 }
 
 
@@ -254,7 +334,7 @@ static uint32 hs_GetMapEntryIndex(HashTable *pTable, const void *pKey, uint32 ke
 HHashTable *hs_CreateHashTable(uint32 mapSize, int hashType)
 {
 	HashTable *pTable;
-	uint32 size, i;
+	uint32 nSlots;
 
 	if(mapSize == 0)
 		return 0;
@@ -262,30 +342,20 @@ HHashTable *hs_CreateHashTable(uint32 mapSize, int hashType)
 	if(hashType < 0 || hashType >= NUM_HASH_TYPES)
 		return 0;
 
-	size = sizeof(HashTable) + (sizeof(MapEntry) * (mapSize-1));
-	LT_MEM_TRACK_ALLOC(pTable = (HashTable*)dalloc(size),LT_MEM_TYPE_HASHTABLE);
-	memset(pTable, 0, size);
+	nSlots = HASH_MIN_SLOTS;
+	while(nSlots < mapSize)
+		nSlots <<= 1;
+
+	LT_MEM_TRACK_ALLOC(pTable = (HashTable*)dalloc(sizeof(HashTable)),LT_MEM_TYPE_HASHTABLE);
+	memset(pTable, 0, sizeof(HashTable));
 	pTable->m_HashType = hashType;
 
-	pTable->m_MapSize = mapSize;
-	for(i=0; i < mapSize; i++)
+	if(!hs_Rehash(pTable, nSlots))
 	{
-		pTable->m_Map[i].m_pHashTable = pTable;
-		pTable->m_Map[i].m_Index = i;
-		dl_TieOff(&pTable->m_Map[i].m_Elements);
+		dfree(pTable);
+		return 0;
 	}
 
-	// Initialize the global hashing tables..
-	g_GetHashCodeFns[HASH_2BYTENUMBER] = hs_GetCode_2ByteNumber;
-	g_GetHashCodeFns[HASH_STRING_NOCASE] = hs_GetCode_StringNoCase;
-	g_GetHashCodeFns[HASH_RAW] = hs_GetCode_Raw;
-	g_GetHashCodeFns[HASH_FILENAME] = hs_GetCode_Filename;
-
-	g_CompareKeyFns[HASH_2BYTENUMBER] = hs_CompareKey_2ByteNumber;
-	g_CompareKeyFns[HASH_STRING_NOCASE] = hs_CompareKey_StringNoCase;
-	g_CompareKeyFns[HASH_RAW] = hs_CompareKey_Raw;
-	g_CompareKeyFns[HASH_FILENAME] = hs_CompareKey_Filename;
-
 	return (HHashTable *)pTable;
 }
 
@@ -294,7 +364,6 @@ void hs_DestroyHashTable(HHashTable *hTable)
 {
 	HashTable *pTable;
 	HashElement *pElement;
-	LTLink *pCur, *pNext;
 	uint32 i;
 
 	if(!hTable)
@@ -303,28 +372,15 @@ void hs_DestroyHashTable(HHashTable *hTable)
 	pTable = (HashTable*)hTable;
 
 	// Free all the elements.
-	for(i=0; i < pTable->m_MapSize; i++)
+	for(i=0; i <= pTable->m_SlotMask; i++)
 	{
-		pCur = pTable->m_Map[i].m_Elements.m_pNext;
-		while(pCur != &pTable->m_Map[i].m_Elements)
-		{
-			pNext = pCur->m_pNext;
-			pElement = ( HashElement * )pCur->m_pData;
-
-			if( pTable->m_HashType == HASH_2BYTENUMBER )
-			{
-				g_HashElementBank.Free( pElement );
-			}
-			else
-			{
-				dfree(pElement);
-			}
-
-			pCur = pNext;
-		}
+		pElement = pTable->m_pSlots[i].m_pElement;
+		if(pElement && pElement != REMOVED_ELEMENT)
+			hs_FreeElement(pTable, pElement);
 	}
 
 	// Free the table.
+	dfree(pTable->m_pSlots);
 	dfree(pTable);
 }
 
@@ -338,19 +394,46 @@ uint32 hs_GetNumCollisions(HHashTable *hTable)
 }
 
 
+uint32 hs_GetNumElements(HHashTable *hTable)
+{
+	if(!hTable)
+		return 0;
+
+	return ((HashTable*)hTable)->m_nElements;
+}
+
+
+uint32 hs_GetMaxProbeLength(HHashTable *hTable)
+{
+	if(!hTable)
+		return 0;
+
+	return ((HashTable*)hTable)->m_MaxProbe;
+}
+
+
 HHashElement *hs_AddElement(HHashTable *hTable, const void *pKey, uint32 keyLen)
 {
 	HashTable *pTable;
-	uint32 mapEl;
-	HashElement *pElement;
-	MapEntry *pMapEntry;
+	HashElement *pElement, *pFirst;
+	uint32 nSlots;
 
 	if(!hTable)
 		return 0;
 
 	pTable = (HashTable*)hTable;
-	mapEl = hs_GetMapEntryIndex(pTable, pKey, keyLen);
-	pMapEntry = &pTable->m_Map[mapEl];
+
+	// Make room first.  Grow if the elements alone are over half the slots,
+	// otherwise just clear out the removed markers.
+	nSlots = pTable->m_SlotMask + 1;
+	if(pTable->m_nUsedSlots + 1 > HASH_MAX_LOAD(nSlots))
+	{
+		if((pTable->m_nElements + 1) * 2 > nSlots)
+			nSlots <<= 1;
+
+		if(!hs_Rehash(pTable, nSlots))
+			return 0;
+	}
 
 	if( pTable->m_HashType == HASH_2BYTENUMBER )
 	{
@@ -363,16 +446,15 @@ HHashElement *hs_AddElement(HHashTable *hTable, const void *pKey, uint32 keyLen)
 	pElement->m_KeySize = (unsigned short)keyLen;
 	memcpy(pElement->m_Key, pKey, keyLen);
 	pElement->m_pUser = 0;
-	pElement->m_pMapEntry = pMapEntry;
-	pElement->m_Link.m_pData = pElement;
+	pElement->m_pHashTable = pTable;
+	pElement->m_Hash = hs_HashKey(pTable->m_HashType, pKey, keyLen);
 
-	dl_Insert(&pMapEntry->m_Elements, &pElement->m_Link);
-	++pMapEntry->m_nElements;
-	
-	if(pMapEntry->m_nElements > 1)
-	{
-		++pTable->m_nCollisions;
-	}
+	pFirst = hs_Probe(pTable, pElement->m_Hash, (pElement->m_Hash - 1) & pTable->m_SlotMask, pKey, keyLen);
+	if(pFirst)
+		hs_InsertDuplicate(pTable, pElement, pFirst);
+	else
+		hs_InsertElement(pTable, pElement, pElement->m_Hash & pTable->m_SlotMask);
+	++pTable->m_nElements;
 
 	return (HHashElement *)pElement;
 }
@@ -391,81 +473,42 @@ void hs_RemoveElement(HHashTable *hTable, HHashElement *hElement)
 	pTable = (HashTable*)hTable;
 
 	pElement = (HashElement*)hElement;
-	pElement->m_pMapEntry->m_nElements--;
-	dl_Remove(&pElement->m_Link);
-	if( pTable->m_HashType == HASH_2BYTENUMBER )
-	{
-		g_HashElementBank.Free( pElement );
-	}
-	else
-	{
-		dfree(pElement);
-	}
+	pTable->m_pSlots[pElement->m_Index].m_pElement = REMOVED_ELEMENT;
+	--pTable->m_nElements;
+
+	hs_FreeElement(pTable, pElement);
 }
 
 
 HHashElement *hs_FindElement(HHashTable *hTable, const void *pKey, uint32 keyLen) {
 	HashTable *pTable;
-	uint32 mapEl;
-	MapEntry *pMapEntry;
-	HashElement *pElement;
-	LTLink *pCur;
+	uint32 hash;
 
 	if(!hTable)
 		return 0;
 
 	pTable = (HashTable*)hTable;
 	
-	mapEl = hs_GetMapEntryIndex(pTable, pKey, keyLen);
-	pMapEntry = &pTable->m_Map[mapEl];
-
-	pCur = pMapEntry->m_Elements.m_pNext;
-	while(pCur != &pMapEntry->m_Elements)
-	{
-		pElement = (HashElement*)pCur->m_pData;
-
-		if(pElement->m_KeySize == keyLen)
-		{
-			if(hs_CompareKeys(pTable, (const char*)pElement->m_Key, (const char*)pKey, keyLen))
-				return (HHashElement *)pElement;
-		}
-
-		pCur = pCur->m_pNext;
-	}
-
-	return 0;
+	hash = hs_HashKey(pTable->m_HashType, pKey, keyLen);
+	return (HHashElement *)hs_Probe(pTable, hash, (hash - 1) & pTable->m_SlotMask, pKey, keyLen);
 }
 
 
 HHashElement *hs_FindNextElement(HHashTable *hTable, HHashElement *hInElement, const void *pKey, uint32 keyLen)
 {
 	HashTable *pTable;
-	MapEntry *pMapEntry;
-	HashElement *pElement, *pInElement;
-	LTLink *pCur;
+	HashElement *pInElement;
+	uint32 hash;
 
 	if(!hTable || !hInElement)
 		return 0;
 
 	pInElement = (HashElement*)hInElement;
 	pTable = (HashTable*)hTable;
-	pMapEntry = pInElement->m_pMapEntry;
 
-	pCur = pInElement->m_Link.m_pNext;
-	while(pCur != &pMapEntry->m_Elements)
-	{
-		pElement = (HashElement*)pCur->m_pData;
-
-		if(pElement->m_KeySize == keyLen)
-		{
-			if(hs_CompareKeys(pTable, (const char*)pElement->m_Key, (const char*)pKey, keyLen))
-				return (HHashElement *)pElement;
-		}
-
-		pCur = pCur->m_pNext;
-	}
-
-	return 0;
+	// Duplicates are further along the same probe sequence, in order from newest to oldest.
+	hash = hs_HashKey(pTable->m_HashType, pKey, keyLen);
+	return (HHashElement *)hs_Probe(pTable, hash, pInElement->m_Index, pKey, keyLen);
 }
 
 
@@ -501,29 +544,25 @@ void hs_SetElementUserData(HHashElement *hElement, void *pUser)
 
 HHashIterator *hs_GetFirstElement(HHashTable *hTable)
 {
-	LTLink *pIterator;
-	HashTable *pTable;
-
 	if(!hTable)
 		return 0;
 
-	pTable = (HashTable*)hTable;
-	pIterator = &pTable->m_Map[0].m_Elements;
-	return (HHashIterator *)hs_SeekToNext(&pTable->m_Map[0], pIterator);
+	return (HHashIterator *)hs_SeekToNext((HashTable*)hTable, 0);
 }
 
 
 HHashElement *hs_GetNextElement(HHashIterator *&pIterator)
 {
-	LTLink *pRet;
+	HashElement *pRet;
 
 	if(!pIterator)
 		return 0;
 
-	pRet = (LTLink*)(pIterator);
+	// The iterator is the next element to return.
+	pRet = (HashElement*)pIterator;
 	
-	pIterator = (HHashIterator *)hs_SeekToNext(((HashElement*)pRet)->m_pMapEntry, pRet);
-	return (HHashElement *)pRet->m_pData;
+	pIterator = (HHashIterator *)hs_SeekToNext(pRet->m_pHashTable, pRet->m_Index + 1);
+	return (HHashElement *)pRet;
 }
 
 
@@ -22,15 +22,22 @@ class HHashElement;
 class HHashIterator;
 
 
-// Create and destroy hash tables.  mapSize controls how large the
-// internal table is.  The larger it is, the less collisions are likely,
-// but larger numbers means more memory usage.
+// Create and destroy hash tables.  mapSize is the initial number of slots
+// (rounded up to a power of 2).  The table grows as elements are added, so
+// this only needs to be large enough to avoid rehashing early on.
 HHashTable *hs_CreateHashTable(uint32 mapSize, int hashType);
 void hs_DestroyHashTable(HHashTable *hTable);
 
 // Just a helper to see how many key collisions have happened.
 uint32 hs_GetNumCollisions(HHashTable *hTable);
 
+// Number of elements currently in the table.
+uint32 hs_GetNumElements(HHashTable *hTable);
+
+// Longest distance any element has been placed from its home slot since
+// the table was last rehashed.  Finding an element never probes further than this.
+uint32 hs_GetMaxProbeLength(HHashTable *hTable);
+
 // Add an element to the hash table.
 HHashElement *hs_AddElement(HHashTable *hTable, const void *pKey, uint32 keyLen);
 
@@ -41,7 +48,7 @@ void hs_RemoveElement(HHashTable *hTable, HHashElement *hElement);
 HHashElement *hs_FindElement(HHashTable *hTable, const void *pKey, uint32 keyLen);
 
 // If there are more than one elements with the same key, you can call this (after hs_FindElement)
-// to find the rest of them.
+// to find the rest of them.  Elements with the same key are found newest first.
 HHashElement *hs_FindNextElement(HHashTable *hTable, HHashElement *hInElement, const void *pKey, uint32 keyLen);
 
 // The hash table will store the key for you so you don't have to store
@@ -63,7 +70,8 @@ void hs_SetElementUserData(HHashElement *hElement, void *pUser);
 //     hElement = hs_GetNextElement(hIterator);
 //     process hElement...
 // }
-// Note: it is safe to remove hElement while iterating.
+// Note: it is safe to remove hElement while iterating.  Adding elements can
+// rehash the table, so elements may be skipped or repeated if you add while iterating.
 
 HHashIterator *hs_GetFirstElement(HHashTable *hTable);
 HHashElement *hs_GetNextElement(HHashIterator *&pIterator);
@@ -46,6 +46,7 @@ int32	g_CV_UDPDebug = LTFALSE;
 
 float	g_CV_IPQueryTimeout = 30.0f;
 float	g_CV_MaxFPS = 0.0f;
+int32	g_CV_MaxFPSSpinUS = 1500;	// How long before the MaxFPS deadline the client stops sleeping and spins.
 
 int32	g_CV_InputDebug = LTFALSE;
 int32	g_CV_JoystickDisable = LTFALSE;
@@ -72,6 +73,11 @@ int32	g_CV_ModelTransitionMS = 200;
 
 int32	g_CV_ModelOnlyUpdateDirtyTrackers = 1;
 
+int32	g_CV_ModelAnimLOD = 1;					// Evaluate the poses of small or hidden models at a reduced rate on the client?
+float	g_CV_ModelAnimLODScreenSize = 0.1f;		// Models drawn at least this big (radius over half the screen height) evaluate their pose every frame
+int32	g_CV_ModelAnimLODDrawnMS = 100;			// Longest time between pose evaluations for models that are drawn smaller than that
+int32	g_CV_ModelAnimLODHiddenMS = 200;		// Time between pose evaluations for models that weren't drawn
+
 float	g_CV_LatencySim = 0.0f;	// Simulate latency.
 float	g_CV_DropRate = 0.0f;   // Simulate packet drops - affects both client and server at the same time
 
@@ -156,6 +162,11 @@ char	*g_CV_ShowClassTicksSpecific = LTNULL;
 
 int32	g_CV_ShowSphereFindTicks = LTFALSE;
 
+int32	g_CV_ShowSaveTiming = LTFALSE;	// Print save/restore sizes and times.
+
+int32	g_CV_ShowPoseCacheStats = LTFALSE;	// Model pose cache hits/misses/evaluations per frame.
+int32	g_CV_ShowModelSkinRebinds = LTFALSE;	// Client model sprite skin texture lookups per frame.
+
 // Console attributes
 int32	g_CV_ConsoleHistoryLen = 20;
 int32	g_CV_ConsoleBufferLen = 500;
@@ -272,6 +283,9 @@ static LTEngineVar g_LTEngineVars[] =
 	EV_LONG("SoundEnable", &g_bSoundEnable),
 	EV_LONG("ForceSoundDisable", &g_CV_ForceSoundDisable),
 	EV_LONG("ShowSphereFindTicks", &g_CV_ShowSphereFindTicks),
+	EV_LONG("ShowSaveTiming", &g_CV_ShowSaveTiming),
+	EV_LONG("ShowPoseCacheStats", &g_CV_ShowPoseCacheStats),
+	EV_LONG("ShowModelSkinRebinds", &g_CV_ShowModelSkinRebinds),
 	EV_LONG("ShowClassTicks", &g_CV_ShowClassTicks),
 	EV_STRING("ShowClassTicksSpecific", &g_CV_ShowClassTicksSpecific),
 	EV_LONG("ShowGameTime", &g_CV_ShowGameTime),
@@ -281,6 +295,9 @@ static LTEngineVar g_LTEngineVars[] =
 	EV_LONG("FullLightScale", &g_CV_FullLightScale),
 	EV_LONG("ForceClear", &g_CV_ForceClear),
 	EV_LONG("ModelTransitionMS", &g_CV_ModelTransitionMS),
+	EV_LONG("ModelAnimLOD", &g_CV_ModelAnimLOD),
+	EV_LONG("ModelAnimLODDrawnMS", &g_CV_ModelAnimLODDrawnMS),
+	EV_LONG("ModelAnimLODHiddenMS", &g_CV_ModelAnimLODHiddenMS),
 	EV_LONG("HighPriority", &g_CV_HighPriority),
 	EV_LONG("ShowConnStats", &g_CV_ShowConnStats),
 	EV_LONG("MasterPaletteMode", &g_CV_MasterPaletteMode),
@@ -301,6 +318,8 @@ static LTEngineVar g_LTEngineVars[] =
 
 	EV_FLOAT("DefaultDrawIndexedDist", &g_CV_DefaultDrawIndexedDist),
 	EV_FLOAT("MaxFPS", &g_CV_MaxFPS),
+	EV_LONG("MaxFPSSpinUS", &g_CV_MaxFPSSpinUS),
+	EV_FLOAT("ModelAnimLODScreenSize", &g_CV_ModelAnimLODScreenSize),
 	EV_FLOAT("LatencySim", &g_CV_LatencySim),
 	EV_FLOAT("DropRate", &g_CV_DropRate),
 	EV_FLOAT("LODScale", &g_fLodScale),
@@ -6,7 +6,10 @@
 
 
 // How many file transfer blocks get sent before we wait for an ack packet?
+// The server grows its window from this up to MAX_UNVERIFIED_BLOCKS
+// depending on the round trip time and delivery rate it measures.
 #define NUM_UNVERIFIED_BLOCKS   6
+#define MAX_UNVERIFIED_BLOCKS   64
 
 
 #define PACKETID_FTBASE     50
@@ -26,6 +29,7 @@
 #define STC_CANCELFILETRANSFER  (PACKETID_FTBASE+2)
 
 // File data block.
+//     data: up to MAX_PACKET_LEN-40 bytes of the file.
 #define STC_FILEBLOCK           (PACKETID_FTBASE+3)
                             
 
@@ -34,6 +38,9 @@
 #define CTS_FILESTATUS          (PACKETID_FTBASE+4)
 
 // Client acknowledging data blocks.
+//     WORD: file ID
+//     DWORD: number of blocks received since the transfer started
+// (If the packet is empty, all the blocks sent so far are acknowledged.)
 #define CTS_DATARECEIVED        (PACKETID_FTBASE+6)
 
 
@@ -31,6 +31,9 @@ struct FTClient
     // The current file we're transferring.
     void            *m_pCurFile;
     uint16          m_CurFileID;
+
+    // Blocks received since the current transfer started.
+    uint32          m_nBlocksReceived;
     
     // All the function pointers.
     FTCInitStruct   m_Init;
@@ -93,6 +96,19 @@ void ftc_Update(FTClient *hClient)
 }
 
 
+// Acknowledge a data block so the server can keep its send window moving.
+static void ftc_OnFileBlock(FTClient *pClient)
+{
+    ++pClient->m_nBlocksReceived;
+
+    CPacket_Write cPacket_Response;
+    cPacket_Response.Writeuint8(CTS_DATARECEIVED);
+    cPacket_Response.Writeuint16(pClient->m_CurFileID);
+    cPacket_Response.Writeuint32(pClient->m_nBlocksReceived);
+    pClient->m_Init.m_pNetMgr->SendPacket(CPacket_Read(cPacket_Response), pClient->m_Init.m_ConnID);
+}
+
+
 void ftc_ProcessPacket(FTClient *pClient, const CPacket_Read &cPacket)
 {
     if (!pClient)
@@ -102,8 +118,27 @@ void ftc_ProcessPacket(FTClient *pClient, const CPacket_Read &cPacket)
 
 	cPacket_Incoming.SeekTo(0);
 	
-	if (cPacket_Incoming.Readuint8() != STC_FILEDESC)
-		return;
+	switch (cPacket_Incoming.Readuint8())
+	{
+		case STC_FILEDESC :
+			break;
+
+		case STC_STARTTRANSFER :
+		{
+			pClient->m_CurFileID = cPacket_Incoming.Readuint16();
+			pClient->m_nBlocksReceived = 0;
+			return;
+		}
+
+		case STC_FILEBLOCK :
+		{
+			ftc_OnFileBlock(pClient);
+			return;
+		}
+
+		default :
+			return;
+	}
 
 	CPacket_Write cPacket_Response;
 	bool bRespond = false;
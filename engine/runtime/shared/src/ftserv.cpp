@@ -16,6 +16,16 @@
 #define FTSTATE_NONE			0
 #define FTSTATE_TRANSFERRING	1
 
+// Size of the file data in each block.
+#define FTS_BLOCK_SIZE			(MAX_PACKET_LEN - 40)
+
+// How much of the file gets read at once.  A whole number of blocks, so a
+// block never straddles two reads.
+#define FTS_READ_AHEAD_SIZE		(FTS_BLOCK_SIZE * 48)
+
+// Packet loss above this shrinks the window.
+#define FTS_LOSS_THRESHOLD		0.02f
+
 // ----------------------------------------------------------------------- //
 // Structures.
 // ----------------------------------------------------------------------- //
@@ -53,11 +63,27 @@ struct FTServ
 	// Flags for how we're operating.
 	uint32		m_ServerFlags;
 
-	// The maximum transfer rate.
-	float		m_BytesPerSecond;
+	// Time since the server was created (only advanced while transferring).
+	float		m_fTime;
+	float		m_fFrameTime;
+
+	// How many blocks can be waiting for an ack.  Sized from the measured
+	// round trip time and delivery rate, and carried over between files.
+	uint32		m_nWindow;
+
+	// Smoothed and minimum round trip time of a block, in seconds.
+	float		m_fRTT;
+	float		m_fMinRTT;
 
-	// Time delta since the last packet was sent.
-	float		m_TimeDelta;
+	// Smoothed rate the client is acknowledging data at, in bytes per second.
+	float		m_fDeliveryRate;
+	float		m_fLastAckTime;
+	uint32		m_nRateBytes;
+
+	// File data read ahead of sending.
+	uint8		*m_pReadBuffer;
+	uint32		m_nReadPos;
+	uint32		m_nReadSize;
 
 	// The init structure is just copied over into here.
 	FTSInitStruct	m_InitStruct;
@@ -68,8 +94,13 @@ struct FTServ
 	// Info about the current file transfer.
 	ILTStream	*m_pCurFileStream;
 	FTFile		*m_pCurFile;
-	uint32		m_nUnverifiedBlocks;
+	uint32		m_nBlocksSent;
+	uint32		m_nBlocksAcked;
+	uint32		m_nAcksReceived;	// Most blocks the client has acked, applied in the next update.
 	uint32		m_nBytesLeft;
+
+	// When each unacknowledged block was sent, indexed by block number.
+	float		m_BlockSendTimes[MAX_UNVERIFIED_BLOCKS];
 };
 
 
@@ -124,56 +155,153 @@ static void fts_RemoveFile(FTServ *pServ, FTFile *pFile)
 }
 
 
-static void fts_MaybeSendDataBlock(FTServ *pServ)
+// Done sending the current file.
+static void fts_FinishTransfer(FTServ *pServ)
 {
-	ASSERT(pServ->m_State == FTSTATE_TRANSFERRING);
-	ASSERT(pServ->m_pCurFileStream);
+	fts_RemoveFile(pServ, pServ->m_pCurFile);
+	pServ->m_pCurFile = LTNULL;
+	
+	pServ->m_InitStruct.m_CloseFn(pServ, pServ->m_pCurFileStream);
+	pServ->m_pCurFileStream = LTNULL;
+	pServ->m_State = FTSTATE_NONE;
+}
 
-	if(pServ->m_nUnverifiedBlocks == NUM_UNVERIFIED_BLOCKS)
+
+// Size the window to twice the bandwidth-delay product.  While the round trip
+// time stays near its minimum the delivery rate keeps up with the window, so it
+// keeps growing.  Once the link is full the round trip time stretches instead,
+// and the window settles.
+static void fts_UpdateWindow(FTServ *pServ)
+{
+	uint32 nWindow;
+	float fLoss;
+
+	if(pServ->m_ServerFlags & FTSFLAG_LOCAL)
 	{
-		// Ok, wait for an ack packet before sending more.
+		pServ->m_nWindow = MAX_UNVERIFIED_BLOCKS;
 		return;
 	}
 
-	// Are we ready to send off another data block?
-	uint32 sendSize = MAX_PACKET_LEN - 40;
+	nWindow = (uint32)(2.0f * pServ->m_fDeliveryRate * pServ->m_fMinRTT / (float)FTS_BLOCK_SIZE) + 1;
 
-	float bytesPerSecond = (float)sendSize / pServ->m_TimeDelta;
-	if(bytesPerSecond > pServ->m_BytesPerSecond)
-	{
+	// Back off while the connection is dropping packets.
+	fLoss = pServ->m_InitStruct.m_ConnID->GetPacketLoss();
+	if(fLoss > FTS_LOSS_THRESHOLD)
+		nWindow = (uint32)((float)nWindow * (1.0f - fLoss));
+
+	pServ->m_nWindow = LTCLAMP(nWindow, NUM_UNVERIFIED_BLOCKS, MAX_UNVERIFIED_BLOCKS);
+}
+
+
+static void fts_OnBlocksAcked(FTServ *pServ, uint32 nAcked)
+{
+	float fRTT, fAckDelta;
+
+	if(nAcked <= pServ->m_nBlocksAcked || nAcked > pServ->m_nBlocksSent)
 		return;
-	}
 
-	uint8 tempData[MAX_PACKET_LEN];
-	bool bDone = false;
+	// Round trip of the newest block acknowledged.  Acks are applied in the
+	// update after they come in, and blocks only go out once per update, so
+	// anything quicker than that counts as one update.
+	fRTT = pServ->m_fTime - pServ->m_BlockSendTimes[(nAcked - 1) % MAX_UNVERIFIED_BLOCKS];
+	fRTT = LTMAX(fRTT, pServ->m_fFrameTime);
+	if(pServ->m_fRTT == 0.0f)
+	{
+		pServ->m_fRTT = fRTT;
+		pServ->m_fMinRTT = fRTT;
+	}
+	else
+	{
+		pServ->m_fRTT += (fRTT - pServ->m_fRTT) * 0.125f;
+		pServ->m_fMinRTT = LTMIN(pServ->m_fMinRTT, fRTT);
+	}
 
-	// Ok, send out a packet!
-	CPacket_Write cDataPacket;
-	cDataPacket.Writeuint8(STC_FILEBLOCK);
+	// Several acks can come in between updates, so the rate is measured
+	// over whatever has been acknowledged since time last moved.
+	pServ->m_nRateBytes += (nAcked - pServ->m_nBlocksAcked) * FTS_BLOCK_SIZE;
+	pServ->m_nBlocksAcked = nAcked;
 
-	if(sendSize >= pServ->m_nBytesLeft)
+	fAckDelta = pServ->m_fTime - pServ->m_fLastAckTime;
+	if(fAckDelta > 0.0f)
 	{
-		bDone = true;
-		sendSize = pServ->m_nBytesLeft;
+		float fRate = (float)pServ->m_nRateBytes / fAckDelta;
+		if(pServ->m_fDeliveryRate == 0.0f)
+			pServ->m_fDeliveryRate = fRate;
+		else
+			pServ->m_fDeliveryRate += (fRate - pServ->m_fDeliveryRate) * 0.125f;
+
+		pServ->m_nRateBytes = 0;
+		pServ->m_fLastAckTime = pServ->m_fTime;
 	}
 
-	// Send the block.
-	pServ->m_pCurFileStream->Read(tempData, sendSize);
-	cDataPacket.WriteData(tempData, (uint16)sendSize);
-	pServ->m_InitStruct.m_pNetMgr->SendPacket(CPacket_Read(cDataPacket), pServ->m_InitStruct.m_ConnID);
+	fts_UpdateWindow(pServ);
+}
+
+
+// Read the next chunk of the file into the read-ahead buffer.
+static void fts_ReadAhead(FTServ *pServ)
+{
+	uint32 nReadSize;
 
-	// If this file transfer is done, then cleanup.
-	if(bDone)
+	if(!pServ->m_pReadBuffer)
 	{
-		fts_RemoveFile(pServ, pServ->m_pCurFile);
-		pServ->m_pCurFile = LTNULL;
-		
-		pServ->m_InitStruct.m_CloseFn(pServ, pServ->m_pCurFileStream);
-		pServ->m_pCurFileStream = LTNULL;
+		LT_MEM_TRACK_ALLOC(pServ->m_pReadBuffer = new uint8[FTS_READ_AHEAD_SIZE],LT_MEM_TYPE_MISC);
 	}
 
-	++pServ->m_nUnverifiedBlocks;
-	pServ->m_TimeDelta = 0;
+	nReadSize = LTMIN(pServ->m_nBytesLeft, (uint32)FTS_READ_AHEAD_SIZE);
+	pServ->m_pCurFileStream->Read(pServ->m_pReadBuffer, nReadSize);
+	pServ->m_nReadPos = 0;
+	pServ->m_nReadSize = nReadSize;
+}
+
+
+// Send as many blocks as the window and the connection's bandwidth allow.
+static void fts_SendDataBlocks(FTServ *pServ, float timeDelta)
+{
+	ASSERT(pServ->m_State == FTSTATE_TRANSFERRING);
+	ASSERT(pServ->m_pCurFileStream);
+
+	// Budget for what can get onto the wire within a round trip, so the
+	// connection's send queue never holds more than that.
+	int32 nAvailableBits = pServ->m_InitStruct.m_ConnID->GetAvailableBandwidth(LTMAX(timeDelta, pServ->m_fRTT));
+
+	while(pServ->m_State == FTSTATE_TRANSFERRING)
+	{
+		uint32 nInFlight = pServ->m_nBlocksSent - pServ->m_nBlocksAcked;
+		if(nInFlight >= pServ->m_nWindow)
+		{
+			// Ok, wait for an ack packet before sending more.
+			break;
+		}
+
+		uint32 sendSize = LTMIN(pServ->m_nBytesLeft, (uint32)FTS_BLOCK_SIZE);
+
+		// Always let one block out when nothing is in flight so a slow link can't stall.
+		int32 nBlockBits = (int32)(sendSize * 8);
+		if(nBlockBits > nAvailableBits && nInFlight > 0)
+			break;
+		nAvailableBits -= nBlockBits;
+
+		if(pServ->m_nReadPos == pServ->m_nReadSize)
+			fts_ReadAhead(pServ);
+
+		ASSERT(sendSize <= (pServ->m_nReadSize - pServ->m_nReadPos));
+
+		// Ok, send out a packet!
+		CPacket_Write cDataPacket;
+		cDataPacket.Writeuint8(STC_FILEBLOCK);
+		cDataPacket.WriteData(&pServ->m_pReadBuffer[pServ->m_nReadPos], sendSize * 8);
+		pServ->m_InitStruct.m_pNetMgr->SendPacket(CPacket_Read(cDataPacket), pServ->m_InitStruct.m_ConnID);
+
+		pServ->m_BlockSendTimes[pServ->m_nBlocksSent % MAX_UNVERIFIED_BLOCKS] = pServ->m_fTime;
+		++pServ->m_nBlocksSent;
+		pServ->m_nReadPos += sendSize;
+		pServ->m_nBytesLeft -= sendSize;
+
+		// If this file transfer is done, then cleanup.
+		if(pServ->m_nBytesLeft == 0)
+			fts_FinishTransfer(pServ);
+	}
 }
 
 
@@ -215,11 +343,23 @@ FTServ *fts_Init(FTSInitStruct *pStruct, uint32 flags)
 	pRet->m_nTotalFiles = 0;
 	pRet->m_State = 0;
 	pRet->m_ServerFlags = flags;
-	pRet->m_TimeDelta = 0.0f;
+	pRet->m_fTime = 0.0f;
+	pRet->m_fFrameTime = 0.0f;
+	pRet->m_nWindow = NUM_UNVERIFIED_BLOCKS;
+	pRet->m_fRTT = 0.0f;
+	pRet->m_fMinRTT = 0.0f;
+	pRet->m_fDeliveryRate = 0.0f;
+	pRet->m_fLastAckTime = 0.0f;
+	pRet->m_nRateBytes = 0;
+	pRet->m_pReadBuffer = LTNULL;
+	pRet->m_nReadPos = 0;
+	pRet->m_nReadSize = 0;
 	pRet->m_UserData1 = LTNULL;
 	pRet->m_pCurFileStream = LTNULL;
 	pRet->m_pCurFile = LTNULL;
-	pRet->m_nUnverifiedBlocks = 0;
+	pRet->m_nBlocksSent = 0;
+	pRet->m_nBlocksAcked = 0;
+	pRet->m_nAcksReceived = 0;
 	pRet->m_nBytesLeft = 0;
 
 	pRet->m_Strings.SetAllocSize(4096);
@@ -228,7 +368,8 @@ FTServ *fts_Init(FTSInitStruct *pStruct, uint32 flags)
 	memcpy(&pRet->m_InitStruct, pStruct, sizeof(FTSInitStruct));
 	dl_TieOff(&pRet->m_Files);
 	pRet->m_State = FTSTATE_NONE;
-	pRet->m_BytesPerSecond = 100000.0f; // Basically, send as fast as possible.
+	if(flags & FTSFLAG_LOCAL)
+		pRet->m_nWindow = MAX_UNVERIFIED_BLOCKS;
 
 	// This was being reset causing models to be loaded more than once in single
 	// player games... contact Peter Higley if this causes a problem
@@ -242,6 +383,7 @@ void fts_Term(FTServ *pServ)
 {
 	fts_ClearFiles(pServ);
 	fts_StopTransfer(pServ);
+	delete [] pServ->m_pReadBuffer;
 	delete pServ;
 }
 
@@ -435,8 +577,22 @@ bool fts_ProcessPacket(FTServ *pServ, const CPacket_Read &cPacket)
 		}
 		case CTS_DATARECEIVED :
 		{
-			if(pServ->m_State == FTSTATE_TRANSFERRING)
-				pServ->m_nUnverifiedBlocks = 0;
+			if(pServ->m_State != FTSTATE_TRANSFERRING)
+				break;
+
+			// The acks are applied in the next update, once the time has moved up to
+			// when they came in.
+			if(cPacket_Input.EOP())
+			{
+				pServ->m_nAcksReceived = pServ->m_nBlocksSent;
+				break;
+			}
+
+			// Ignore acks left over from a previous file.
+			uint16 nFileID = cPacket_Input.Readuint16();
+			uint32 nAcked = cPacket_Input.Readuint32();
+			if(nFileID == (uint16)pServ->m_pCurFile->m_FileID)
+				pServ->m_nAcksReceived = LTMAX(pServ->m_nAcksReceived, nAcked);
 
 			break;
 		}
@@ -465,8 +621,6 @@ void fts_Update(FTServ *pServ, float timeDelta)
 		pFile = fts_FindFileToSend(pServ);
 		if(pFile)
 		{
-			pServ->m_TimeDelta = 0.0f;
-
 			// If they don't want us to send files at all right now, don't,
 			if(pServ->m_ServerFlags & FTSFLAG_DONTSENDANYTHING)
 				return;
@@ -489,8 +643,17 @@ void fts_Update(FTServ *pServ, float timeDelta)
 				pServ->m_pCurFile = pFile;
 				pServ->m_pCurFileStream = pStream;
 				pServ->m_State = FTSTATE_TRANSFERRING;
-				pServ->m_nUnverifiedBlocks = 0;
+				pServ->m_nBlocksSent = 0;
+				pServ->m_nBlocksAcked = 0;
+				pServ->m_nAcksReceived = 0;
 				pServ->m_nBytesLeft = pFile->m_FileSize;
+				pServ->m_nReadPos = 0;
+				pServ->m_nReadSize = 0;
+
+				CPacket_Write cPacket;
+				cPacket.Writeuint8(STC_STARTTRANSFER);
+				cPacket.Writeuint16((uint16)pFile->m_FileID);
+				pServ->m_InitStruct.m_pNetMgr->SendPacket(CPacket_Read(cPacket), pServ->m_InitStruct.m_ConnID);
 			}
 			else
 			{
@@ -509,9 +672,11 @@ void fts_Update(FTServ *pServ, float timeDelta)
 	}
 	else if(pServ->m_State == FTSTATE_TRANSFERRING)
 	{
-		pServ->m_TimeDelta += timeDelta;
+		pServ->m_fTime += timeDelta;
+		pServ->m_fFrameTime = timeDelta;
 
-		fts_MaybeSendDataBlock(pServ);
+		fts_OnBlocksAcked(pServ, pServ->m_nAcksReceived);
+		fts_SendDataBlocks(pServ, timeDelta);
 	}
 }
 
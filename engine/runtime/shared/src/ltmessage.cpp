@@ -48,6 +48,11 @@ void CLTMessage_Write::WriteCompLTVector(CPacket_Write &cPacket, const LTVector
 	CompVector compVec;
 	g_pCompressor->EncodeCompressVector(&compVec, &vVec);
 
+	WriteCompLTVector(cPacket, compVec);
+}
+
+void CLTMessage_Write::WriteCompLTVector(CPacket_Write &cPacket, const CompVector &compVec)
+{
 	cPacket.Writefloat(compVec.fA);
 	cPacket.Writeuint16((uint16)compVec.dwB);
 	cPacket.Writeuint16((uint16)compVec.dwC);
@@ -59,6 +64,11 @@ void CLTMessage_Write::WriteCompLTRotation(CPacket_Write &cPacket, const LTRotat
 	CompRot compRot;
 	g_pCompressor->EncodeCompressRotation(&cRotation, &compRot);
 
+	WriteCompLTRotation(cPacket, compRot);
+}
+
+void CLTMessage_Write::WriteCompLTRotation(CPacket_Write &cPacket, const CompRot &compRot)
+{
 	cPacket.Writeint8(compRot.m_Bytes[0]);
 	cPacket.Writeint8(compRot.m_Bytes[1]);
 	cPacket.Writeint8(compRot.m_Bytes[2]);
@@ -172,11 +182,7 @@ HSTRING CLTMessage_Read::ReadHString()
 LTVector CLTMessage_Read::ReadCompLTVector(CPacket_Read &cPacket)
 {
 	CompVector compVec;
-
-	compVec.fA = cPacket.Readfloat();
-	compVec.dwB = cPacket.Readuint16();
-	compVec.dwC = cPacket.Readuint16();
-	compVec.order = cPacket.Readuint8();
+	ReadCompLTVector(cPacket, compVec);
 
 	LTVector vResult;
 	g_pCompressor->DecodeCompressVector(&vResult, &compVec);
@@ -184,10 +190,27 @@ LTVector CLTMessage_Read::ReadCompLTVector(CPacket_Read &cPacket)
 	return vResult;
 }
 
+void CLTMessage_Read::ReadCompLTVector(CPacket_Read &cPacket, CompVector &compVec)
+{
+	compVec.fA = cPacket.Readfloat();
+	compVec.dwB = cPacket.Readuint16();
+	compVec.dwC = cPacket.Readuint16();
+	compVec.order = cPacket.Readuint8();
+}
+
 LTRotation CLTMessage_Read::ReadCompLTRotation(CPacket_Read &cPacket)
 {
 	CompRot compRot;
+	ReadCompLTRotation(cPacket, compRot);
+
+	LTRotation cResult;
+	g_pCompressor->UncompressRotation(compRot.m_Bytes, &cResult);
 
+	return cResult;
+}
+
+void CLTMessage_Read::ReadCompLTRotation(CPacket_Read &cPacket, CompRot &compRot)
+{
 	compRot.m_Bytes[0] = cPacket.Readint8();
 	compRot.m_Bytes[1] = cPacket.Readint8();
 	compRot.m_Bytes[2] = cPacket.Readint8();
@@ -197,11 +220,6 @@ LTRotation CLTMessage_Read::ReadCompLTRotation(CPacket_Read &cPacket)
 		compRot.m_Bytes[4] = cPacket.Readint8();
 		compRot.m_Bytes[5] = cPacket.Readint8();
 	}
-
-	LTRotation cResult;
-	g_pCompressor->UncompressRotation(compRot.m_Bytes, &cResult);
-
-	return cResult;
 }
 
 uint32 CLTMessage_Read::ReadHStringAsString(char *pDest, uint32 nMaxLen)
@@ -11,6 +11,9 @@
 #include "packet.h"
 
 class CLTMessage_Read;
+struct CompVector;
+class CompRot;
+class CompWorldPos;
 
 class CLTMessage_Write : public ILTMessage_Write {
 public:
@@ -56,6 +59,9 @@ public:
 	// Static functions for access to writing directly to a CPacket_Write
 	static void WriteCompLTVector(CPacket_Write &cPacket, const LTVector &vVec);
 	static void WriteCompLTRotation(CPacket_Write &cPacket, const LTRotation &cRotation);
+	// Write values that have already been compressed
+	static void WriteCompLTVector(CPacket_Write &cPacket, const CompVector &compVec);
+	static void WriteCompLTRotation(CPacket_Write &cPacket, const CompRot &compRot);
 	static void WriteObject(CPacket_Write &cPacket, HOBJECT hObj);
 	static void WriteYRotation(CPacket_Write &cPacket, const LTRotation &cRotation);
 protected:
@@ -136,6 +142,9 @@ public:
 	static LTVector ReadCompLTVector(CPacket_Read &cPacket);
 	static LTRotation ReadCompLTRotation(CPacket_Read &cPacket);
 	static LTRotation ReadYRotation(CPacket_Read &cPacket);
+	// Read values without decompressing them
+	static void ReadCompLTVector(CPacket_Read &cPacket, CompVector &compVec);
+	static void ReadCompLTRotation(CPacket_Read &cPacket, CompRot &compRot);
 
 	static LTVector PeekCompLTVector(const CPacket_Read &cPacket);
 	static LTRotation PeekCompLTRotation(const CPacket_Read &cPacket);
@@ -586,7 +586,7 @@ LTRESULT ILTModel::SetCurAnim(HOBJECT hModel, ANIMTRACKERID TrackerID,
 		return LT_NOTFOUND;
 
 	//we need to re-evaluate the nodes since we have changed the tracker
-	pModel->ResetCachedTransformNodeStates();
+	pModel->ResetCachedPose();
 
 	//The tracker is now dirty.
 	pTracker->m_bDirty = true;
@@ -607,7 +607,7 @@ LTRESULT ILTModel::ResetAnim(HOBJECT hModel, ANIMTRACKERID TrackerID)
     trk_Reset(pTracker);
 
 	//we need to re-evaluate the nodes since we have changed the tracker
-	pModel->ResetCachedTransformNodeStates();
+	pModel->ResetCachedPose();
 
 	//The tracker is now dirty.
 	pTracker->m_bDirty = true;
@@ -756,7 +756,7 @@ LTRESULT ILTModel::SetCurAnimTime(
     trk_SetCurTime(pTracker, curTime, false);
 
 	//we need to re-evaluate the nodes since we have changed the tracker
-	pModel->ResetCachedTransformNodeStates();
+	pModel->ResetCachedPose();
 
 	//The tracker is now dirty.
 	pTracker->m_bDirty = true;
@@ -231,6 +231,10 @@ bool LTObject::InsertSpecial(WorldTree *pTree) {
 
 }
 
+bool LTObject::HasSpecialInsert() {
+    return (m_Flags & FLAG_REALLYCLOSE) != 0;
+}
+
 void LTObject::NotifyObjRefList_Delete()
 {
 	while (!m_RefList.IsTiedOff())
@@ -324,6 +328,12 @@ bool WorldModelInstance::InsertSpecial(WorldTree *pTree)
     return LTFALSE;
 }
 
+bool WorldModelInstance::HasSpecialInsert()
+{
+    return m_pOriginalBsp && 
+        (m_pOriginalBsp->GetWorldInfoFlags() & (WIF_PHYSICSBSP | WIF_VISBSP)) != 0;
+}
+
 void WorldModelInstance::InitWorldData(const WorldBsp *pOriginalBsp, const WorldBsp *pWorldBsp)
 {
 	//store the specified BSP's
@@ -370,6 +380,8 @@ HPOLY WorldModelInstance::MakeHPoly(const Node *pNode)
 // ModelInstance.
 // ------------------------------------------------------------------------- //
 
+ModelInstance::SPoseCacheStats ModelInstance::s_PoseCacheStats[2];
+
 // ------------------------------------------------------------------------
 // ModelInstance Constructor
 // ------------------------------------------------------------------------
@@ -382,6 +394,10 @@ ModelInstance::ModelInstance()
 
     m_pNodeInfo		= NULL;
 	m_nNumNodeInfos	= 0;
+	m_nNumNodeControls = 0;
+
+	// nothing evaluated yet, the first read stamps the cache.
+	m_PoseCacheStamp.m_nTimeRefs = 0;
 
 	//note that the hidden pieces bit field relies upon the maximum number of pieces being
 	//divisible by the size of a hidden pieces component.
@@ -404,6 +420,7 @@ ModelInstance::ModelInstance()
 	{
         m_pSprites[i] = LTNULL;
 		m_pSkins[i] = LTNULL;
+		m_pSkinSpriteFrames[i] = LTNULL;
 	}
 	m_nNumSprites = 0;
     
@@ -416,6 +433,10 @@ ModelInstance::ModelInstance()
 	m_RenderingTransforms		= NULL;
 
     m_LastDirLightAmount		= -1.0f;
+	m_nAnimLODPendingMS			= 0;
+	m_bAnimLODHoldPose			= false;
+	m_fAnimLODScreenSize		= 0.0f;
+	m_bAnimUpdated				= false;
 	m_nRenderInfoIndex			= INVALID_MODEL_INFO_INDEX;
 	m_nRenderInfoParentIndex	= INVALID_MODEL_INFO_INDEX;
 
@@ -536,8 +557,12 @@ void ModelInstance::ClientUpdate( uint32 msFrameTime )
         trk_Update(pTracker, msFrameTime);
     }
 
-	//we need to reset all the transforms so they will be re-evaluated
-	ResetCachedTransformNodeStates();
+	// the pose cache notices animation time changes by itself, but node controls
+	// can move nodes every frame without the trackers changing.
+	if( (m_nNumNodeControls > 0) && !m_bAnimLODHoldPose )
+	{
+		ResetCachedTransformNodeStates();
+	}
 }
 
 
@@ -558,8 +583,12 @@ void ModelInstance::ServerUpdate( uint32 msFrameTime )
        trk_Update(pTracker, msFrameTime);
     }
 
-	//we need to reset all the transforms so they will be re-evaluated
-	ResetCachedTransformNodeStates();
+	// the pose cache notices animation time changes by itself, but node controls
+	// can move nodes every frame without the trackers changing.
+	if( m_nNumNodeControls > 0 )
+	{
+		ResetCachedTransformNodeStates();
+	}
 }
 
 
@@ -765,6 +794,7 @@ void ModelInstance::AddNodeControlFn( HMODELNODE hNode, NodeControlFn pFn, void
 
 	//add it into the list
 	m_pNodeInfo[hNode].m_pNodeControls = pInfo;
+	m_nNumNodeControls++;
 }
 
 // ------------------------------------------------------------------------
@@ -817,6 +847,9 @@ void ModelInstance::RemoveNodeControlFn( HMODELNODE hNode, NodeControlFn pFn, vo
 
 			//free the memory
 			delete pCurr;
+
+			ASSERT(m_nNumNodeControls > 0);
+			m_nNumNodeControls--;
 		}
 		else
 		{
@@ -1038,6 +1071,7 @@ void ModelInstance::FreeNodeInfo()
 	//clear everything out
 	m_pNodeInfo		= NULL;
 	m_nNumNodeInfos	= 0;
+	m_nNumNodeControls = 0;
 }
 
 //  ----------------------------------------------------------------
@@ -1090,6 +1124,9 @@ bool ModelInstance::ForceUpdateCachedTransforms()
 	LTMatrix	   mToWorld;
     LTAnimTracker *pCur;
 
+	// keep the stamp in sync with the state we evaluate for.
+	ValidatePoseCache();
+
 	SetupTransform(mToWorld);
 
     tMaker.m_nAnims = 0;
@@ -1107,6 +1144,7 @@ bool ModelInstance::ForceUpdateCachedTransforms()
 	tMaker.m_pStartMat		= &mToWorld; 
 	tMaker.m_pOutput		= m_CachedTransforms;
 	
+	s_PoseCacheStats[ GetCSType() ].m_nEvaluations++;
 	
 	if (!tMaker.SetupTransforms()) 
 	{
@@ -1130,15 +1168,24 @@ bool ModelInstance::GetCachedTransform( uint32 iNode, LTMatrix &transform )
 { 
 	if( iNode < GetModelDB()->NumNodes() ) 
 	{ 
+		// make sure the cached nodes are for the current transform and time.
+		ValidatePoseCache();
+
 		// first check if its already evaluated.
 		if( !IsNodeEvaluated(iNode) ) 
 		{
+			s_PoseCacheStats[ GetCSType() ].m_nMisses++;
+
 			//indicate that we need to evaluate this node
 			SetupNodePath( iNode );
 
 			//and evaluate the tree
 			UpdateCachedTransformsWithPath();	
 		}
+		else
+		{
+			s_PoseCacheStats[ GetCSType() ].m_nHits++;
+		}
 
 		//copy out the transform
 		transform = m_CachedTransforms[ iNode ]; 
@@ -1158,6 +1205,10 @@ bool ModelInstance::GetCachedTransform( uint32 iNode, LTMatrix &transform )
 // ------------------------------------------------------------------------
 DDMatrix*	ModelInstance::GetRenderingTransforms()
 { 
+	// the renderer sets up the lod paths first, which already validated the cache,
+	// so this only catches a move in between.
+	ValidatePoseCache();
+
 	UpdateCachedTransformsWithPath();	
 	
 	// only do this if we're the client
@@ -1202,6 +1253,85 @@ void ModelInstance::ResetCachedTransformNodeStates()
 	}
 }
 
+// ------------------------------------------------------------------------
+// ResetCachedPose()
+// a tracker jumped, so a pose held back by the animation LOD would show the
+// old animation until the hold runs out. Start the hold over from the new
+// pose instead.
+// ------------------------------------------------------------------------
+void ModelInstance::ResetCachedPose()
+{
+	m_nAnimLODPendingMS = 0;
+	ResetCachedTransformNodeStates();
+}
+
+
+// ------------------------------------------------------------------------
+// ValidatePoseCache()
+// compare the state the cached pose was evaluated for against the current
+// object transform and animation time. All the consumers within a frame 
+// (ray casts against the obbs, sockets, attachments, rendering) then share 
+// one evaluation, and a model that neither moved nor animated keeps its 
+// pose across frames.
+// ------------------------------------------------------------------------
+static inline bool i_IsSameFrameLocator( const FrameLocator &a, const FrameLocator &b )
+{
+	return a.m_iAnim == b.m_iAnim && a.m_iFrame == b.m_iFrame && a.m_Time == b.m_Time;
+}
+
+static inline bool i_IsSameTimeRef( const AnimTimeRef &a, const AnimTimeRef &b )
+{
+	return	a.m_pModel == b.m_pModel && 
+			a.m_Percent == b.m_Percent && 
+			a.m_iWeightSet == b.m_iWeightSet &&
+			i_IsSameFrameLocator(a.m_Prev, b.m_Prev) && 
+			i_IsSameFrameLocator(a.m_Cur, b.m_Cur);
+}
+
+static inline bool i_IsSameAnim( const AnimTimeRef &a, const AnimTimeRef &b )
+{
+	return	a.m_pModel == b.m_pModel && 
+			a.m_iWeightSet == b.m_iWeightSet &&
+			a.m_Prev.m_iAnim == b.m_Prev.m_iAnim && 
+			a.m_Cur.m_iAnim == b.m_Cur.m_iAnim;
+}
+
+void ModelInstance::ValidatePoseCache()
+{
+	SPoseCacheStamp &Stamp = m_PoseCacheStamp;
+
+	bool bValid =	(Stamp.m_Pos == m_Pos) && 
+					(Stamp.m_Scale == m_Scale) &&
+					(memcmp(Stamp.m_Rot.m_Quat, m_Rotation.m_Quat, sizeof(Stamp.m_Rot.m_Quat)) == 0) &&
+					(Stamp.m_hHintNode == m_AnimTrackers->m_hHintNode);
+
+	uint32 nTimeRefs = 0;
+	for( LTAnimTracker *pCur = m_AnimTrackers; pCur && bValid; pCur = pCur->GetNext() )
+	{
+		bValid =	(nTimeRefs < Stamp.m_nTimeRefs) && 
+					(m_bAnimLODHoldPose ? i_IsSameAnim(Stamp.m_TimeRefs[ nTimeRefs ], pCur->m_TimeRef) :
+										  i_IsSameTimeRef(Stamp.m_TimeRefs[ nTimeRefs ], pCur->m_TimeRef));
+		nTimeRefs++;
+	}
+
+	if( bValid && (nTimeRefs == Stamp.m_nTimeRefs) )
+		return;
+
+	// stale, everything has to be evaluated again for the current state.
+	ResetCachedTransformNodeStates();
+
+	Stamp.m_Pos			= m_Pos;
+	Stamp.m_Rot			= m_Rotation;
+	Stamp.m_Scale		= m_Scale;
+	Stamp.m_hHintNode	= m_AnimTrackers->m_hHintNode;
+	Stamp.m_nTimeRefs	= 0;
+
+	for( LTAnimTracker *pCur = m_AnimTrackers; pCur && (Stamp.m_nTimeRefs < MAX_GVP_ANIMS); pCur = pCur->GetNext() )
+	{
+		Stamp.m_TimeRefs[ Stamp.m_nTimeRefs++ ] = pCur->m_TimeRef;
+	}
+}
+
 
 // ------------------------------------------------------------------------
 // UpdateCachedTransformsWithPath() 
@@ -1233,6 +1363,11 @@ bool ModelInstance::UpdateCachedTransformsWithPath()
 	tMaker.m_pStartMat     = &mStartTransform; 
 	tMaker.m_pOutput       = m_CachedTransforms;
 
+	if( ShouldEvaluateNode( GetModelDB()->GetRootNode()->GetNodeIndex() ) )
+	{
+		s_PoseCacheStats[ GetCSType() ].m_nEvaluations++;
+	}
+
 	// evaluate the hierarchy with paths.
 	if (!tMaker.SetupTransformsWithPath()) 
 	{
@@ -1265,6 +1400,9 @@ void ModelInstance::SetupNodePath( uint32 iNode )
 	if(iNode >= NumNodes())
 		return;
 
+	//drop stale nodes before deciding what is on the path
+	ValidatePoseCache();
+
 	//has this node already been evaluated already?
 	if(IsNodeEvaluated(iNode))
 	{
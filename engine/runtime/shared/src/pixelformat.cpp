@@ -1,6 +1,14 @@
 
 #include "bdefs.h"
 #include "pixelformat.h"
+#include "workerpool.h"
+
+// DXT_DECODE_NO_SSE2 keeps 32-bit destinations on the scalar block decoder.
+#if !defined(DXT_DECODE_NO_SSE2) && \
+	(defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__))
+#define DXT_DECODE_SSE2
+#include <emmintrin.h>
+#endif
 
 
 #define SRC_8	(*pSrc)
@@ -18,92 +26,6 @@
 #define RGBA_GETB(color)			((uint8)((color & 0x000000FF)      ))
 #endif
 
-#define ALPHAVAL abstract.m_AlphaValues
-
-#define READROW_NORMAL(index, startOffset)\
-	A::Or(pDestPos, 0, ALPHAVAL[(alphaData[index] >> (startOffset+0)) & 0x7]);\
-	A::Or(pDestPos, 1, ALPHAVAL[(alphaData[index] >> (startOffset+3)) & 0x7]);\
-	A::Or(pDestPos, 2, ALPHAVAL[(alphaData[index] >> (startOffset+6)) & 0x7]);\
-	A::Or(pDestPos, 3, ALPHAVAL[(alphaData[index] >> (startOffset+9)) & 0x7]);\
-	pDestPos = (uint8*)pDestPos + pRequest->m_DestPitch;
-
-#define DECODE_LINE(lineShiftAmt)\
-	A::Set(pDestPos, 0, abstract.m_Ident[(blockData>>(lineShiftAmt+0)) & 3]);\
-	A::Set(pDestPos, 1, abstract.m_Ident[(blockData>>(lineShiftAmt+2)) & 3]);\
-	A::Set(pDestPos, 2, abstract.m_Ident[(blockData>>(lineShiftAmt+4)) & 3]);\
-	A::Set(pDestPos, 3, abstract.m_Ident[(blockData>>(lineShiftAmt+6)) & 3]);\
-	pDestPos = (((uint8*)pDestPos) + pRequest->m_DestPitch);
-
-#define DECODE_ALPHA_2ROWS() \
-	DECODE_ALPHA(0, 0)\
-	DECODE_ALPHA(4, 1)\
-	DECODE_ALPHA(8, 2)\
-	DECODE_ALPHA(12, 3)\
-	pDestPos = (uint8*)pDestPos + pRequest->m_DestPitch;\
-	DECODE_ALPHA(16, 0)\
-	DECODE_ALPHA(20, 1)\
-	DECODE_ALPHA(24, 2)\
-	DECODE_ALPHA(28, 3)\
-	pDestPos = (uint8*)pDestPos + pRequest->m_DestPitch;
-
-#define DECODE_ALPHA(shift, iPixel)\
-	A::Mask(pDestPos, iPixel, invAlphaMask);\
-	A::Or(pDestPos, iPixel, abstract.m_AlphaValues[(blockData>>shift) & 15]);
-
-static uint32 g_FullAlphaValues[16] =
-{
-	PValue_Set(0, 0, 0, 0), PValue_Set(17, 0, 0, 0), PValue_Set(34, 0, 0, 0), PValue_Set(51, 0, 0, 0),
-	PValue_Set(68, 0, 0, 0), PValue_Set(85, 0, 0, 0), PValue_Set(102, 0, 0, 0), PValue_Set(119, 0, 0, 0),
-	PValue_Set(136, 0, 0, 0), PValue_Set(153, 0, 0, 0), PValue_Set(170, 0, 0, 0), PValue_Set(187, 0, 0, 0),
-	PValue_Set(204, 0, 0, 0), PValue_Set(221, 0, 0, 0), PValue_Set(238, 0, 0, 0), PValue_Set(255, 0, 0, 0)
-};
-
-
-
-// These abstract out uint16/uint32 differences for certain routines.
-class Abstract_Word
-{
-public:
-	static uint32	GetShift()	{return 1;}
-	static void		Set(void *pDest, uint32 index, uint16 val)
-	{
-		((uint16*)pDest)[index] = val;
-	}
-	static void		Mask(void *pDest, uint32 index, uint32 mask)
-	{
-		((uint16*)pDest)[index] &= (uint16)mask;
-	}
-	static void		Or(void *pDest, uint32 index, uint16 mask)
-	{
-		((uint16*)pDest)[index] |= mask;
-	}
-	
-	uint16	m_Ident[4];
-	uint16	m_AlphaValues[16];
-};
-
-
-class Abstract_DWord
-{
-public:
-	static uint32	GetShift()	{return 2;}
-	static void		Set(void *pDest, uint32 index, uint32 val)
-	{
-		((uint32*)pDest)[index] = val;
-	}
-	static void		Mask(void *pDest, uint32 index, uint32 mask)
-	{
-		((uint32*)pDest)[index] &= mask;
-	}
-	static void		Or(void *pDest, uint32 index, uint32 mask)
-	{
-		((uint32*)pDest)[index] |= mask;
-	}
-	
-	uint32	m_Ident[4];
-	uint32	m_AlphaValues[16];
-};
-
 
 // ------------------------------------------------------------------------------ //
 // The conversion classes.
@@ -794,234 +716,382 @@ LTRESULT Convert32Pto32(FormatMgr *pFormatMgr, const FMConvertRequest *pRequest,
 }					   
 					   
 
-template<class C, class A>
-LTRESULT ConvertDXTGeneric(FormatMgr *pFormatMgr,
-	const FMConvertRequest *pRequest, C *pConvert, A *pAbstract)
+// --------------------------------------------------------------------------------- //
+// S3TC decompression.
+// --------------------------------------------------------------------------------- //
+
+// Surfaces with at least this many blocks are split across threads (512x512).
+#define DXT_THREAD_MIN_BLOCKS	16384
+#define DXT_MAX_BANDS			8
+
+// Everything needed to decode the blocks of one request.  The destination format
+// is folded into a table per color plane so a color is packed with 4 lookups and
+// gives the same result as CC_BFto16/CC_BFto32.
+struct DXTDecodeInfo
 {
-	A abstract;
-	C ccBFtoGeneric;
-	CC_16toBF cc16toBF;
-	uint32 nBlocksX, nBlocksY;
-	uint32 xBlock, yBlock;
-	uint32 ident32[4];
-	uint32 comp[2][4];
-	uint8 *pSrcPos8;
-	uint16 *pSrcPos16;
-	void *pDestPos;
-	uint16 val1, val2;
-	uint32 i, blockData, bytesPerBlockShift, alphaExtra, invAlphaMask;
-	LTBOOL bAlpha, bInterpolatedAlpha;
-	uint32 tempIndex;
-	uint32 alphaData[2], alphaShift = 0, defaultPValueAlphaMask, defaultByteAlphaMask;
-	uint8 *pAlphaScaleTable = nullptr;
+	BPPIdent		m_SrcType;
+	const uint8		*m_pSrc;
+	uint8			*m_pDest;
+	long			m_DestPitch;
+	uint32			m_nBlocksX;
+	uint32			m_nBlockBytes;
+
+	const uint8		*m_pScale5To8;
+	const uint8		*m_pScale6To8;
+
+	// Alpha of the opaque colors in the base format (0 for DXT5 since
+	// the alpha block is OR'd in).
+	uint32			m_DefaultAlpha;
 
+	uint32			m_InvAlphaMask;
+	uint32			m_PackTable[NUM_COLORPLANES][256];
 
-	// Will we be decompressing with alpha?
-	defaultPValueAlphaMask = PVALUE_ALPHAMASK;
-	defaultByteAlphaMask = 0xFF;
-	bAlpha = bInterpolatedAlpha = LTFALSE;
-	if(pRequest->m_pSrcFormat->GetType() == BPP_S3TC_DXT3)
+	// DXT3 explicit alpha values in the destination format.
+	uint32			m_AlphaValues[16];
+};
+
+
+inline uint32 dxt_Pack(const DXTDecodeInfo *pInfo, uint32 a, uint32 r, uint32 g, uint32 b)
+{
+	return pInfo->m_PackTable[CP_ALPHA][a] | pInfo->m_PackTable[CP_RED][r] |
+		pInfo->m_PackTable[CP_GREEN][g] | pInfo->m_PackTable[CP_BLUE][b];
+}
+
+// Fills in the 4 colors of a color block in the destination format.
+static void dxt_DecodeColors(const DXTDecodeInfo *pInfo, const uint8 *pBlock, uint32 colors[4])
+{
+	uint32 val1, val2, comp[2][3], alpha;
+
+	// 16-bit 565 values.
+	val1 = *((const uint16*)pBlock);
+	val2 = *((const uint16*)(pBlock + 2));
+
+	comp[0][0] = pInfo->m_pScale5To8[val1 >> 11];
+	comp[0][1] = pInfo->m_pScale6To8[(val1 >> 5) & 0x3F];
+	comp[0][2] = pInfo->m_pScale5To8[val1 & 0x1F];
+	comp[1][0] = pInfo->m_pScale5To8[val2 >> 11];
+	comp[1][1] = pInfo->m_pScale6To8[(val2 >> 5) & 0x3F];
+	comp[1][2] = pInfo->m_pScale5To8[val2 & 0x1F];
+
+	alpha = pInfo->m_DefaultAlpha;
+	colors[0] = dxt_Pack(pInfo, alpha, comp[0][0], comp[0][1], comp[0][2]);
+	colors[1] = dxt_Pack(pInfo, alpha, comp[1][0], comp[1][1], comp[1][2]);
+
+	if(val1 > val2)
 	{
-		bAlpha = LTTRUE;
+		// 4-color block, alpha is opaque.
+		colors[2] = dxt_Pack(pInfo, alpha,
+			(comp[0][0]*2 + comp[1][0]) / 3,
+			(comp[0][1]*2 + comp[1][1]) / 3,
+			(comp[0][2]*2 + comp[1][2]) / 3);
+
+		colors[3] = dxt_Pack(pInfo, alpha,
+			(comp[0][0] + comp[1][0]*2) / 3,
+			(comp[0][1] + comp[1][1]*2) / 3,
+			(comp[0][2] + comp[1][2]*2) / 3);
 	}
-	else if(pRequest->m_pSrcFormat->GetType() == BPP_S3TC_DXT5)
+	else
 	{
-		bAlpha = bInterpolatedAlpha = LTTRUE;
+		// 3-color block, last color is translucent alpha.
+		colors[2] = dxt_Pack(pInfo, alpha,
+			(comp[0][0] + comp[1][0]) >> 1,
+			(comp[0][1] + comp[1][1]) >> 1,
+			(comp[0][2] + comp[1][2]) >> 1);
+
+		colors[3] = dxt_Pack(pInfo, 0, 0, 0, 0);
+	}
+}
+
+// Fills in the 8 alpha values of a DXT5 alpha block in the destination format
+// and returns the 48 bits of 3-bit indices.
+static uint64 dxt_DecodeInterpolatedAlpha(const DXTDecodeInfo *pInfo, const uint8 *pBlock, uint32 alphas[8])
+{
+	uint32 alpha[8], i;
 
-		alphaShift = pRequest->m_pDestFormat->m_FirstBits[CP_ALPHA];
-		pAlphaScaleTable = pFormatMgr->m_ScaleFrom8[
-			pRequest->m_pDestFormat->m_nBits[CP_ALPHA]].GetArray();
+	// 2 bytes for the alpha values.
+	alpha[0] = pBlock[0];
+	alpha[1] = pBlock[1];
 
-		defaultByteAlphaMask = defaultPValueAlphaMask = 0;
+	if(alpha[0] > alpha[1])
+	{
+		// 8 values going between these alpha values.
+		alpha[2] = (alpha[0]*6 + alpha[1]*1) / 7;
+		alpha[3] = (alpha[0]*5 + alpha[1]*2) / 7;
+		alpha[4] = (alpha[0]*4 + alpha[1]*3) / 7;
+		alpha[5] = (alpha[0]*3 + alpha[1]*4) / 7;
+		alpha[6] = (alpha[0]*2 + alpha[1]*5) / 7;
+		alpha[7] = (alpha[0]*1 + alpha[1]*6) / 7;
+	}
+	else
+	{
+		// 6 values going between these alpha values.  The others are 0 and 0xFF.
+		alpha[2] = (alpha[0]*4 + alpha[1]*1) / 5;
+		alpha[3] = (alpha[0]*3 + alpha[1]*2) / 5;
+		alpha[4] = (alpha[0]*2 + alpha[1]*3) / 5;
+		alpha[5] = (alpha[0]*1 + alpha[1]*4) / 5;
+		alpha[6] = 0;
+		alpha[7] = 0xFF;
 	}
 
-	invAlphaMask = ~pRequest->m_pDestFormat->m_Masks[CP_ALPHA];
+	for(i=0; i < 8; i++)
+	{
+		alphas[i] = pInfo->m_PackTable[CP_ALPHA][alpha[i]];
+	}
 
-	cc16toBF.Init(pFormatMgr, &pFormatMgr->m_RGB565Format);
-	ccBFtoGeneric.Init(pFormatMgr, pRequest->m_pDestFormat);
+	// 6 bytes for the pixels (3 bits per pixel, 16 pixels, 3*16=48 bits=6 bytes).
+	return (uint64)*((const uint32*)(pBlock + 2)) | ((uint64)*((const uint16*)(pBlock + 6)) << 32);
+}
 
-	if(bAlpha)
+// Decodes a 4x4 block into texels[] (row-major).
+static void dxt_DecodeBlock(const DXTDecodeInfo *pInfo, const uint8 *pBlock, uint32 texels[16])
+{
+	uint32 colors[4], alphas[8], colorBits, alphaBits, i;
+	uint64 alphaIndices;
+
+	switch(pInfo->m_SrcType)
 	{
-		bytesPerBlockShift = 4;
-		alphaExtra = 8; // 8 bytes of alpha data.
-		
-		for(i=0; i < 16; i++)
+		case BPP_S3TC_DXT1:
+		{
+			dxt_DecodeColors(pInfo, pBlock, colors);
+			colorBits = *((const uint32*)(pBlock + 4));
+
+			for(i=0; i < 16; i++)
+			{
+				texels[i] = colors[(colorBits >> (i*2)) & 3];
+			}
+		}
+		break;
+
+		case BPP_S3TC_DXT3:
 		{
-			ccBFtoGeneric.Convert((uint8*)&g_FullAlphaValues[i], (uint8*)&abstract.m_AlphaValues[i]);
+			dxt_DecodeColors(pInfo, pBlock + 8, colors);
+			colorBits = *((const uint32*)(pBlock + 12));
+
+			for(i=0; i < 4; i++)
+			{
+				colors[i] &= pInfo->m_InvAlphaMask;
+			}
+
+			// 4 bits of explicit alpha per pixel.
+			alphaBits = *((const uint32*)pBlock);
+			for(i=0; i < 8; i++)
+			{
+				texels[i] = colors[(colorBits >> (i*2)) & 3] | pInfo->m_AlphaValues[(alphaBits >> (i*4)) & 15];
+			}
+
+			alphaBits = *((const uint32*)(pBlock + 4));
+			for(i=8; i < 16; i++)
+			{
+				texels[i] = colors[(colorBits >> (i*2)) & 3] | pInfo->m_AlphaValues[(alphaBits >> ((i-8)*4)) & 15];
+			}
 		}
+		break;
+
+		default:
+		{
+			dxt_DecodeColors(pInfo, pBlock + 8, colors);
+			colorBits = *((const uint32*)(pBlock + 12));
+
+			alphaIndices = dxt_DecodeInterpolatedAlpha(pInfo, pBlock, alphas);
+			for(i=0; i < 16; i++)
+			{
+				texels[i] = colors[(colorBits >> (i*2)) & 3] | alphas[(uint32)(alphaIndices >> (i*3)) & 7];
+			}
+		}
+		break;
 	}
-	else
+}
+
+
+#ifdef DXT_DECODE_SSE2
+
+// Decodes a 4x4 block straight to a 32-bit destination.  The colors are selected
+// for a whole row at once by comparing each texel's index against 0-3.
+static void dxt_DecodeBlockSSE2(const DXTDecodeInfo *pInfo, const uint8 *pBlock, uint8 *pDest)
+{
+	uint32 colors[4], alphas[8], colorBits, alphaBits, row;
+	uint64 alphaIndices = 0;
+	const uint8 *pColorBlock;
+	__m128i color[4], rowBits, indexMask, alphaRow, out;
+
+	pColorBlock = (pInfo->m_SrcType == BPP_S3TC_DXT1) ? pBlock : pBlock + 8;
+	dxt_DecodeColors(pInfo, pColorBlock, colors);
+	colorBits = *((const uint32*)(pColorBlock + 4));
+
+	if(pInfo->m_SrcType == BPP_S3TC_DXT3)
 	{
-		bytesPerBlockShift = 3;
-		alphaExtra = 0;
+		colors[0] &= pInfo->m_InvAlphaMask;
+		colors[1] &= pInfo->m_InvAlphaMask;
+		colors[2] &= pInfo->m_InvAlphaMask;
+		colors[3] &= pInfo->m_InvAlphaMask;
+	}
+	else if(pInfo->m_SrcType == BPP_S3TC_DXT5)
+	{
+		alphaIndices = dxt_DecodeInterpolatedAlpha(pInfo, pBlock, alphas);
 	}
 
-	nBlocksX = pRequest->m_Width >> 2;
-	nBlocksY = pRequest->m_Height >> 2;
+	color[0] = _mm_set1_epi32((int)colors[0]);
+	color[1] = _mm_set1_epi32((int)colors[1]);
+	color[2] = _mm_set1_epi32((int)colors[2]);
+	color[3] = _mm_set1_epi32((int)colors[3]);
 
-	// For each block...
-	for(yBlock=0; yBlock < nBlocksY; yBlock++)
+	// Texel i of a row has its index at bits 2i..2i+1.
+	indexMask = _mm_set_epi32(3 << 6, 3 << 4, 3 << 2, 3);
+
+	for(row=0; row < 4; row++)
 	{
-		for(xBlock=0; xBlock < nBlocksX; xBlock++)
+		rowBits = _mm_and_si128(_mm_set1_epi32((int)(colorBits >> (row*8))), indexMask);
+
+		out = _mm_and_si128(_mm_cmpeq_epi32(rowBits, _mm_setzero_si128()), color[0]);
+		out = _mm_or_si128(out, _mm_and_si128(
+			_mm_cmpeq_epi32(rowBits, _mm_set_epi32(1 << 6, 1 << 4, 1 << 2, 1)), color[1]));
+		out = _mm_or_si128(out, _mm_and_si128(
+			_mm_cmpeq_epi32(rowBits, _mm_set_epi32(2 << 6, 2 << 4, 2 << 2, 2)), color[2]));
+		out = _mm_or_si128(out, _mm_and_si128(
+			_mm_cmpeq_epi32(rowBits, indexMask), color[3]));
+
+		if(pInfo->m_SrcType == BPP_S3TC_DXT3)
+		{
+			alphaBits = *((const uint16*)(pBlock + row*2));
+			alphaRow = _mm_set_epi32(
+				(int)pInfo->m_AlphaValues[(alphaBits >> 12) & 15],
+				(int)pInfo->m_AlphaValues[(alphaBits >> 8) & 15],
+				(int)pInfo->m_AlphaValues[(alphaBits >> 4) & 15],
+				(int)pInfo->m_AlphaValues[alphaBits & 15]);
+			out = _mm_or_si128(out, alphaRow);
+		}
+		else if(pInfo->m_SrcType == BPP_S3TC_DXT5)
 		{
-			pSrcPos8 = pRequest->m_pSrc + (xBlock<<bytesPerBlockShift) + ((yBlock*nBlocksX)<<bytesPerBlockShift);
-			pSrcPos8 += alphaExtra;
-			pSrcPos16 = (uint16*)pSrcPos8;
+			alphaBits = (uint32)(alphaIndices >> (row*12));
+			alphaRow = _mm_set_epi32(
+				(int)alphas[(alphaBits >> 9) & 7],
+				(int)alphas[(alphaBits >> 6) & 7],
+				(int)alphas[(alphaBits >> 3) & 7],
+				(int)alphas[alphaBits & 7]);
+			out = _mm_or_si128(out, alphaRow);
+		}
 
-			// 16-bit 565 values.
-			val1 = *pSrcPos16;
-			val2 = *(pSrcPos16 + 1);
+		_mm_storeu_si128((__m128i*)pDest, out);
+		pDest += pInfo->m_DestPitch;
+	}
+}
 
-			// Convert to base format.
-			cc16toBF.Convert((uint8*)&val1, (uint8*)&ident32[0]);
-			cc16toBF.Convert((uint8*)&val2, (uint8*)&ident32[1]);
+#endif // DXT_DECODE_SSE2
 
-			// Get the components.
-			PValue_Get(ident32[0], comp[0][0], comp[0][1], comp[0][2], comp[0][3]);
-			PValue_Get(ident32[1], comp[1][0], comp[1][1], comp[1][2], comp[1][3]);
 
-			ident32[0] |= defaultPValueAlphaMask;
-			ident32[1] |= defaultPValueAlphaMask;
+// Decodes the block rows [yStart, yEnd) into the destination.  T is the destination
+// pixel type.
+template<class T>
+static void dxt_DecodeBlockRows(const DXTDecodeInfo *pInfo, uint32 yStart, uint32 yEnd)
+{
+	uint32 xBlock, yBlock, texels[16], row;
+	const uint8 *pBlock;
+	uint8 *pDestBlock;
+	T *pOut;
 
-			// Convert to output format.
-			if(val1 > val2)
+	for(yBlock=yStart; yBlock < yEnd; yBlock++)
+	{
+		pBlock = pInfo->m_pSrc + yBlock * pInfo->m_nBlocksX * pInfo->m_nBlockBytes;
+		pDestBlock = pInfo->m_pDest + (yBlock << 2) * pInfo->m_DestPitch;
+
+		for(xBlock=0; xBlock < pInfo->m_nBlocksX; xBlock++)
+		{
+#ifdef DXT_DECODE_SSE2
+			if(sizeof(T) == sizeof(uint32))
 			{
-				// 4-color block, alpha is opaque.
-				ident32[2] = PValue_Set(
-					defaultByteAlphaMask,
-					(comp[0][1]*2 + comp[1][1]) / 3,
-					(comp[0][2]*2 + comp[1][2]) / 3,
-					(comp[0][3]*2 + comp[1][3]) / 3);
-				
-				ident32[3] = PValue_Set(
-					defaultByteAlphaMask,
-					(comp[0][1] + comp[1][1]*2) / 3,
-					(comp[0][2] + comp[1][2]*2) / 3,
-					(comp[0][3] + comp[1][3]*2) / 3);
+				dxt_DecodeBlockSSE2(pInfo, pBlock, pDestBlock);
 			}
 			else
+#endif
 			{
-				// 3-color block, last color is translucent alpha.
-				ident32[2] = PValue_Set(
-					defaultByteAlphaMask,
-					(comp[0][1] + comp[1][1]) >> 1,
-					(comp[0][2] + comp[1][2]) >> 1,
-					(comp[0][3] + comp[1][3]) >> 1);
-
-				ident32[3] = 0;
+				dxt_DecodeBlock(pInfo, pBlock, texels);
+
+				for(row=0; row < 4; row++)
+				{
+					pOut = (T*)(pDestBlock + row * pInfo->m_DestPitch);
+					pOut[0] = (T)texels[row*4 + 0];
+					pOut[1] = (T)texels[row*4 + 1];
+					pOut[2] = (T)texels[row*4 + 2];
+					pOut[3] = (T)texels[row*4 + 3];
+				}
 			}
 
-			ccBFtoGeneric.Convert((uint8*)&ident32[0], (uint8*)&abstract.m_Ident[0]);
-			ccBFtoGeneric.Convert((uint8*)&ident32[1], (uint8*)&abstract.m_Ident[1]);
-			ccBFtoGeneric.Convert((uint8*)&ident32[2], (uint8*)&abstract.m_Ident[2]);
-			ccBFtoGeneric.Convert((uint8*)&ident32[3], (uint8*)&abstract.m_Ident[3]);
+			pBlock += pInfo->m_nBlockBytes;
+			pDestBlock += sizeof(T) * 4;
+		}
+	}
+}
 
-			// The next 4 bytes are the pixel data.
-			blockData = *((uint32*)(pSrcPos8 + 4));
-			pDestPos = pRequest->m_pDest + 
-				((yBlock<<2) * pRequest->m_DestPitch) + (xBlock<<(2+A::GetShift()));
-			
-			DECODE_LINE(0);
-			DECODE_LINE(8);
-			DECODE_LINE(16);
-			DECODE_LINE(24);
+// Decodes the request's blocks, splitting large surfaces into bands of block rows
+// that are decoded on the worker pool.
+template<class T>
+static void dxt_DecodeSurface(const DXTDecodeInfo *pInfo, uint32 nBlocksY)
+{
+	uint32 nMaxBands = 1;
+	if(pInfo->m_nBlocksX * nBlocksY >= DXT_THREAD_MIN_BLOCKS)
+	{
+		nMaxBands = DXT_MAX_BANDS;
+	}
 
-			// Read in the alpha block?
-			if(bAlpha)
-			{
-				pDestPos = pRequest->m_pDest + 
-					((yBlock<<2) * pRequest->m_DestPitch) + (xBlock<<(2+A::GetShift()));
+	wp_ForEachBand(nBlocksY, nMaxBands, [pInfo](uint32 yStart, uint32 yEnd)
+	{
+		dxt_DecodeBlockRows<T>(pInfo, yStart, yEnd);
+	});
+}
 
-				pSrcPos8 = pRequest->m_pSrc + (xBlock<<bytesPerBlockShift) + ((yBlock*nBlocksX)<<bytesPerBlockShift);
+template<class T>
+LTRESULT ConvertDXTGeneric(FormatMgr *pFormatMgr, const FMConvertRequest *pRequest, T *pDestType)
+{
+	DXTDecodeInfo info;
+	const PFormat *pDestFormat;
+	const uint8 *pScaleTable;
+	uint32 i, j;
 
-				if(bInterpolatedAlpha)
-				{
-					// 2 bytes for the alpha values.
-					ALPHAVAL[0] = *pSrcPos8;
-					ALPHAVAL[1] = *(pSrcPos8+1);
-
-					if(ALPHAVAL[0] > ALPHAVAL[1])
-					{
-						// 8 values going between these alpha values.
-						ALPHAVAL[2] = (ALPHAVAL[0]*6 + ALPHAVAL[1]*1) / 7;
-						ALPHAVAL[3] = (ALPHAVAL[0]*5 + ALPHAVAL[1]*2) / 7;
-						ALPHAVAL[4] = (ALPHAVAL[0]*4 + ALPHAVAL[1]*3) / 7;
-						ALPHAVAL[5] = (ALPHAVAL[0]*3 + ALPHAVAL[1]*4) / 7;
-						ALPHAVAL[6] = (ALPHAVAL[0]*2 + ALPHAVAL[1]*5) / 7;
-						ALPHAVAL[7] = (ALPHAVAL[0]*1 + ALPHAVAL[1]*6) / 7;
-					}
-					else
-					{
-						// 6 values going between these alpha values.  The others are 0 and 0xFF.						
-						ALPHAVAL[2] = (ALPHAVAL[0]*4 + ALPHAVAL[1]*1) / 5;
-						ALPHAVAL[3] = (ALPHAVAL[0]*3 + ALPHAVAL[1]*2) / 5;
-						ALPHAVAL[4] = (ALPHAVAL[0]*2 + ALPHAVAL[1]*3) / 5;
-						ALPHAVAL[5] = (ALPHAVAL[0]*1 + ALPHAVAL[1]*4) / 5;
-						ALPHAVAL[6] = 0;
-						ALPHAVAL[7] = 0xFF;
-					}
-
-					// Put them in the dest format.
-					ALPHAVAL[0] = pAlphaScaleTable[ALPHAVAL[0]] << alphaShift;
-					ALPHAVAL[1] = pAlphaScaleTable[ALPHAVAL[1]] << alphaShift;
-					ALPHAVAL[2] = pAlphaScaleTable[ALPHAVAL[2]] << alphaShift;
-					ALPHAVAL[3] = pAlphaScaleTable[ALPHAVAL[3]] << alphaShift;
-					ALPHAVAL[4] = pAlphaScaleTable[ALPHAVAL[4]] << alphaShift;
-					ALPHAVAL[5] = pAlphaScaleTable[ALPHAVAL[5]] << alphaShift;
-					ALPHAVAL[6] = pAlphaScaleTable[ALPHAVAL[6]] << alphaShift;
-					ALPHAVAL[7] = pAlphaScaleTable[ALPHAVAL[7]] << alphaShift;
-
-					// 6 bytes for the pixels (3 bits per pixel, 16 pixels, 
-					// 3*16=48 bits=6 bytes).  
-					alphaData[0] = *((uint32*)(pSrcPos8+2));
-					alphaData[1] = *((uint16*)(pSrcPos8+6));
-
-					// Row 1.
-						READROW_NORMAL(0, 0);
-
-					// Row 2.
-						READROW_NORMAL(0, 12);
-
-					// Row 3.	
-						A::Or(pDestPos, 0, ALPHAVAL[(alphaData[0] >> 24) & 0x7]);
-						A::Or(pDestPos, 1, ALPHAVAL[(alphaData[0] >> 27) & 0x7]);
-
-						// As luck would have it, one of the pixels spans the border.
-						tempIndex = alphaData[0] >> 30; // Get the 2 LSoBs.
-						tempIndex |= (alphaData[1] & 0x1) << 2; // The MSoB.
-						A::Or(pDestPos, 2, ALPHAVAL[tempIndex]);
-
-						A::Or(pDestPos, 3, ALPHAVAL[(alphaData[1] >> 1) & 0x7]);
-						pDestPos = (uint8*)pDestPos + pRequest->m_DestPitch;
-
-					// Row 4.
-						READROW_NORMAL(1, 4);
-				}
-				else
-				{
-					// 2 rows worth.
-					blockData = *((uint32*)pSrcPos8);
-					DECODE_ALPHA_2ROWS();
 
-					blockData = *((uint32*)(pSrcPos8 + 4));
-					DECODE_ALPHA_2ROWS();
-				}
-			}
+	pDestFormat = pRequest->m_pDestFormat;
+
+	info.m_SrcType = pRequest->m_pSrcFormat->GetType();
+	info.m_pSrc = pRequest->m_pSrc;
+	info.m_pDest = pRequest->m_pDest;
+	info.m_DestPitch = pRequest->m_DestPitch;
+	info.m_nBlocksX = pRequest->m_Width >> 2;
+	info.m_nBlockBytes = (info.m_SrcType == BPP_S3TC_DXT1) ? 8 : 16;
+
+	info.m_pScale5To8 = pFormatMgr->m_ScaleTo8[5];
+	info.m_pScale6To8 = pFormatMgr->m_ScaleTo8[6];
+
+	// DXT5 colors are written without alpha and the alpha block is OR'd in.
+	info.m_DefaultAlpha = (info.m_SrcType == BPP_S3TC_DXT5) ? 0 : 0xFF;
+	info.m_InvAlphaMask = ~pDestFormat->m_Masks[CP_ALPHA];
+
+	for(i=0; i < NUM_COLORPLANES; i++)
+	{
+		pScaleTable = pFormatMgr->m_ScaleFrom8[pDestFormat->m_nBits[i]].GetArray();
+		for(j=0; j < 256; j++)
+		{
+			info.m_PackTable[i][j] = (uint32)pScaleTable[j] << pDestFormat->m_FirstBits[i];
 		}
 	}
 
+	for(i=0; i < 16; i++)
+	{
+		info.m_AlphaValues[i] = info.m_PackTable[CP_ALPHA][i * 17];
+	}
+
+	dxt_DecodeSurface<T>(&info, pRequest->m_Height >> 2);
+
 	return LT_OK;
 }
 
 
 LTRESULT ConvertDXTto16(FormatMgr *pFormatMgr, const FMConvertRequest *pRequest, LTRGB* pTransColor)
 {
-	return ConvertDXTGeneric(pFormatMgr, pRequest, (CC_BFto16*)LTNULL, (Abstract_Word*)LTNULL);
+	return ConvertDXTGeneric(pFormatMgr, pRequest, (uint16*)LTNULL);
 }
 
 LTRESULT ConvertDXTto32(FormatMgr *pFormatMgr, const FMConvertRequest *pRequest, LTRGB* pTransColor)
 {
-	return ConvertDXTGeneric(pFormatMgr, pRequest, (CC_BFto32*)LTNULL, (Abstract_DWord*)LTNULL);
+	return ConvertDXTGeneric(pFormatMgr, pRequest, (uint32*)LTNULL);
 }
 
 
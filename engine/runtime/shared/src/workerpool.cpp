@@ -0,0 +1,247 @@
+
+#include "bdefs.h"
+#include "workerpool.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+
+//the most threads a loop is split across, including the calling thread
+#define WORKERPOOL_MAX_THREADS	16
+
+
+//set on a thread while it runs bands, so a loop started from inside a band runs inline
+static thread_local bool g_bInWorkerBand = false;
+
+
+class CWorkerPool
+{
+public:
+
+	CWorkerPool();
+	~CWorkerPool();
+
+	uint32	GetNumThreads() const	{ return m_nNumThreads; }
+	void	SetNumThreads(uint32 nThreads);
+
+	//returns false if the pool is already running another loop
+	bool	Run(uint32 nCount, uint32 nBands, WorkerBandFn pFn, void *pUser);
+
+private:
+
+	void	StartThreads();
+	void	WorkerThread();
+
+	//runs bands of the current loop until there are none left
+	void	RunBands();
+
+	uint32				m_nNumThreads;
+	bool				m_bStarted;
+
+	//held by the thread running a loop, for as long as it runs
+	std::mutex			m_RunLock;
+
+	//guards the rest of the state below
+	std::mutex			m_Lock;
+	std::condition_variable	m_WakeCV;
+	std::condition_variable	m_DoneCV;
+	std::thread			m_Threads[WORKERPOOL_MAX_THREADS - 1];
+	uint32				m_nNumWorkers;
+	uint32				m_nLoopSerial;
+	uint32				m_nBusyWorkers;
+	bool				m_bStop;
+
+	//the current loop, set while m_RunLock is held
+	WorkerBandFn		m_pFn;
+	void				*m_pUser;
+	uint32				m_nCount;
+	uint32				m_nBandSize;
+	uint32				m_nBands;
+	std::atomic<uint32>	m_nNextBand;
+	std::atomic<uint32>	m_nBandsDone;
+};
+
+
+CWorkerPool::CWorkerPool()
+{
+	m_nNumThreads = 1;
+	m_bStarted = false;
+	SetNumThreads(0);
+
+	m_nNumWorkers = 0;
+	m_nLoopSerial = 0;
+	m_nBusyWorkers = 0;
+	m_bStop = false;
+
+	m_pFn = LTNULL;
+	m_pUser = LTNULL;
+	m_nCount = 0;
+	m_nBandSize = 0;
+	m_nBands = 0;
+	m_nNextBand = 0;
+	m_nBandsDone = 0;
+}
+
+CWorkerPool::~CWorkerPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Lock);
+		m_bStop = true;
+	}
+	m_WakeCV.notify_all();
+
+	for(uint32 nCurr = 0; nCurr < m_nNumWorkers; nCurr++)
+	{
+		m_Threads[nCurr].join();
+	}
+}
+
+void CWorkerPool::SetNumThreads(uint32 nThreads)
+{
+	std::lock_guard<std::mutex> runLock(m_RunLock);
+
+	if(!m_bStarted)
+	{
+		m_nNumThreads = LTCLAMP(nThreads ? nThreads : std::thread::hardware_concurrency(), 1, WORKERPOOL_MAX_THREADS);
+	}
+}
+
+void CWorkerPool::StartThreads()
+{
+	m_bStarted = true;
+
+	//if a thread can't be started the loops just get split across fewer threads, since
+	//the calling thread takes on any bands that are left over
+	for(uint32 nCurr = 0; nCurr + 1 < m_nNumThreads; nCurr++)
+	{
+		try
+		{
+			m_Threads[m_nNumWorkers] = std::thread(&CWorkerPool::WorkerThread, this);
+			m_nNumWorkers++;
+		}
+		catch(...)
+		{
+			break;
+		}
+	}
+}
+
+void CWorkerPool::WorkerThread()
+{
+	g_bInWorkerBand = true;
+
+	uint32 nLastSerial = 0;
+
+	std::unique_lock<std::mutex> lock(m_Lock);
+
+	for(;;)
+	{
+		m_WakeCV.wait(lock, [&] { return m_bStop || (m_nLoopSerial != nLastSerial); });
+
+		if(m_bStop)
+			break;
+
+		nLastSerial = m_nLoopSerial;
+
+		//the loop stays set until no worker is in it any more
+		m_nBusyWorkers++;
+		lock.unlock();
+
+		RunBands();
+
+		lock.lock();
+		m_nBusyWorkers--;
+
+		if(!m_nBusyWorkers)
+		{
+			m_DoneCV.notify_all();
+		}
+	}
+}
+
+void CWorkerPool::RunBands()
+{
+	for(;;)
+	{
+		uint32 nBand = m_nNextBand.fetch_add(1);
+		if(nBand >= m_nBands)
+			break;
+
+		uint32 nStart	= LTMIN(nBand * m_nBandSize, m_nCount);
+		uint32 nEnd		= LTMIN(nStart + m_nBandSize, m_nCount);
+
+		m_pFn(m_pUser, nStart, nEnd);
+
+		m_nBandsDone.fetch_add(1);
+	}
+}
+
+bool CWorkerPool::Run(uint32 nCount, uint32 nBands, WorkerBandFn pFn, void *pUser)
+{
+	std::unique_lock<std::mutex> runLock(m_RunLock, std::try_to_lock);
+	if(!runLock.owns_lock())
+		return false;
+
+	if(!m_bStarted)
+	{
+		StartThreads();
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(m_Lock);
+
+		//a worker that woke up late for the last loop may still be on its way out of it
+		m_DoneCV.wait(lock, [&] { return !m_nBusyWorkers; });
+
+		m_pFn = pFn;
+		m_pUser = pUser;
+		m_nCount = nCount;
+		m_nBands = nBands;
+		m_nBandSize = (nCount + nBands - 1) / nBands;
+		m_nNextBand = 0;
+		m_nBandsDone = 0;
+		m_nLoopSerial++;
+	}
+	m_WakeCV.notify_all();
+
+	g_bInWorkerBand = true;
+	RunBands();
+	g_bInWorkerBand = false;
+
+	//wait for the bands the workers picked up, and for the workers to let go of the loop so
+	//the next one can be set up
+	std::unique_lock<std::mutex> lock(m_Lock);
+	m_DoneCV.wait(lock, [&] { return (m_nBandsDone == m_nBands) && !m_nBusyWorkers; });
+
+	return true;
+}
+
+
+static CWorkerPool& wp_GetPool()
+{
+	static CWorkerPool s_Pool;
+	return s_Pool;
+}
+
+uint32 wp_GetNumThreads()
+{
+	return wp_GetPool().GetNumThreads();
+}
+
+void wp_SetNumThreads(uint32 nThreads)
+{
+	wp_GetPool().SetNumThreads(nThreads);
+}
+
+void wp_RunBands(uint32 nCount, uint32 nMaxBands, WorkerBandFn pFn, void *pUser)
+{
+	uint32 nBands = LTMIN(LTMIN(nMaxBands, nCount), wp_GetNumThreads());
+
+	if((nBands <= 1) || g_bInWorkerBand || !wp_GetPool().Run(nCount, nBands, pFn, pUser))
+	{
+		pFn(pUser, 0, nCount);
+	}
+}
+
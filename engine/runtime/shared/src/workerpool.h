@@ -0,0 +1,44 @@
+// The worker pool runs data parallel loops on a set of threads that are started
+// once and kept around, so per frame work can be split up without paying for
+// thread creation every time.
+
+#ifndef __WORKERPOOL_H__
+#define __WORKERPOOL_H__
+
+#ifndef __LTINTEGER_H__
+#include "ltinteger.h"
+#endif
+
+
+typedef void (*WorkerBandFn)(void *pUser, uint32 nStart, uint32 nEnd);
+
+// How many threads a loop can be split across, counting the calling thread.
+// It's one per hardware thread unless wp_SetNumThreads changed it.
+uint32 wp_GetNumThreads();
+
+// Changes the number of threads, 0 for one per hardware thread.  Only has an
+// effect before the first loop starts the pool up.
+void wp_SetNumThreads(uint32 nThreads);
+
+// Runs pFn(pUser, nStart, nEnd) over [0, nCount) in at most nMaxBands contiguous
+// bands of the same size and returns when they are all done.  The calling thread
+// works on the bands too.  Each item must only depend on itself, since the bands
+// run in no particular order.  The loop runs on the calling thread alone if the
+// pool is busy with another loop or it's called from inside a band.
+void wp_RunBands(uint32 nCount, uint32 nMaxBands, WorkerBandFn pFn, void *pUser);
+
+template<class F>
+static void wp_BandThunk(void *pUser, uint32 nStart, uint32 nEnd)
+{
+	(*(F*)pUser)(nStart, nEnd);
+}
+
+// wp_RunBands for a function object taking (nStart, nEnd).
+template<class F>
+inline void wp_ForEachBand(uint32 nCount, uint32 nMaxBands, F Func)
+{
+	wp_RunBands(nCount, nMaxBands, wp_BandThunk<F>, &Func);
+}
+
+
+#endif  // __WORKERPOOL_H__
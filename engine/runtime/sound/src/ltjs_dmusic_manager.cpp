@@ -43,6 +43,12 @@
 #include "ltjs_dmusic_manager.h"
 #include "ltjs_dmusic_segment.h"
 #include "ltjs_audio_utils.h"
+#include "ltjs_profiler.h"
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define LTJS_DMUSIC_SSE2
+#include <emmintrin.h>
+#endif
 
 
 #ifndef NOLITHTECH
@@ -95,12 +101,14 @@ public:
 		device_buffer_{},
 		mix_buffer_{},
 		music_stream_{},
+		music_stream_queue_size_{},
 		mt_mixer_thread_{},
 		mt_mixer_cv_{},
 		mt_mixer_cv_mutex_{},
 		mt_mixer_mutex_{},
 		mt_mixer_cv_flag_{},
-		mt_is_quit_mixer_{}
+		mt_is_quit_mixer_{},
+		mt_mixer_stats_{}
 	{
 	}
 
@@ -141,12 +149,14 @@ public:
 		device_buffer_{std::move(that.device_buffer_)},
 		mix_buffer_{std::move(that.mix_buffer_)},
 		music_stream_{std::move(that.music_stream_)},
+		music_stream_queue_size_{std::move(that.music_stream_queue_size_)},
 		mt_mixer_thread_{std::move(that.mt_mixer_thread_)},
 		mt_mixer_cv_{},
 		mt_mixer_cv_mutex_{},
 		mt_mixer_mutex_{},
 		mt_mixer_cv_flag_{std::move(that.mt_mixer_cv_flag_)},
-		mt_is_quit_mixer_{std::move(that.mt_is_quit_mixer_)}
+		mt_is_quit_mixer_{std::move(that.mt_is_quit_mixer_)},
+		mt_mixer_stats_{std::move(that.mt_mixer_stats_)}
 	{
 		that.is_initialized_ = false;
 		that.is_level_initialized_ = false;
@@ -375,6 +385,8 @@ public:
 			return LT_ERROR;
 		}
 
+		music_stream_queue_size_ = sound_sys_->ltjs_get_generic_stream_queue_size();
+
 		// Initialize misc fields.
 		//
 		mix_offset_ = 0;
@@ -395,6 +407,7 @@ public:
 		//
 		mt_mixer_cv_flag_ = false;
 		mt_is_quit_mixer_ = false;
+		mt_mixer_stats_ = {};
 		mt_mixer_thread_ = MtThread{std::bind(&Impl::mt_mixer_worker, this)};
 
 		is_level_initialized_ = true;
@@ -423,6 +436,8 @@ public:
 			mt_notify_mixer();
 
 			mt_mixer_thread_.join();
+
+			log_mixer_stats();
 		}
 
 		if (music_stream_)
@@ -431,6 +446,8 @@ public:
 			music_stream_ = nullptr;
 		}
 
+		music_stream_queue_size_ = 0;
+
 		working_directory_.clear();
 		control_file_name_.clear();
 
@@ -840,6 +857,20 @@ private:
 	using BufferF = std::vector<float>;
 
 
+	struct MixerStats
+	{
+		// Mixed buffers.
+		int buffer_count_;
+
+		// How many times the stream ran out of queued buffers while playing.
+		int underrun_count_;
+
+		// Time spent in mixing and converting (nanoseconds).
+		std::int64_t mix_time_ns_;
+		std::int64_t max_mix_time_ns_;
+	}; // MixerStats
+
+
 	const char* method_name_;
 
 	ILTSoundSys* sound_sys_;
@@ -888,6 +919,7 @@ private:
 	BufferS16 device_buffer_;
 	BufferF mix_buffer_;
 	LtjsLtSoundSysGenericStream* music_stream_;
+	int music_stream_queue_size_;
 	MtThread mt_mixer_thread_;
 	MtCondVar mt_mixer_cv_;
 	MtMutex mt_mixer_cv_mutex_;
@@ -895,6 +927,9 @@ private:
 	bool mt_mixer_cv_flag_;
 	bool mt_is_quit_mixer_;
 
+	// Owned by the mixer thread while it runs.
+	MixerStats mt_mixer_stats_;
+
 
 	static const char* const unsupported_method_message;
 
@@ -1415,10 +1450,7 @@ private:
 				const auto adjusted_decoded_size = sample_count * byte_depth;
 				const auto mix_sample_offset = mix_byte_offset / byte_depth;
 
-				for (auto i = 0; i < sample_count; ++i)
-				{
-					mix_buffer_[i + mix_sample_offset] += decoder_buffer_[i] / 32768.0F;
-				}
+				mix_add_s16(decoder_buffer_.data(), mix_buffer_.data() + mix_sample_offset, sample_count);
 
 				wave.decoded_offset_ += adjusted_decoded_size;
 
@@ -1606,23 +1638,150 @@ private:
 		mt_mixer_cv_flag_ = false;
 	}
 
-	void update_device_buffer()
+	// Waits for a notification or a deadline whichever comes first.
+	//
+	template<typename TTimePoint>
+	void mt_wait_for_mixer_cv_until(
+		const TTimePoint& deadline)
+	{
+		MtUniqueLock cv_lock{mt_mixer_cv_mutex_};
+		mt_mixer_cv_.wait_until(cv_lock, deadline, [&](){ return mt_mixer_cv_flag_; });
+		mt_mixer_cv_flag_ = false;
+	}
+
+	//
+	// Adds 16-bit samples to the mix buffer.
+	//
+	static void mix_add_s16(
+		const std::int16_t* const src_samples,
+		float* const dst_samples,
+		const int sample_count)
+	{
+		// Multiplying by a power of two is exact, so both paths match "sample / 32768.0F".
+		//
+		constexpr auto s16_to_f = 1.0F / 32768.0F;
+
+		auto i = 0;
+
+#ifdef LTJS_DMUSIC_SSE2
+		const auto sse_s16_to_f = _mm_set1_ps(s16_to_f);
+
+		for ( ; (i + 8) <= sample_count; i += 8)
+		{
+			const auto src_s16 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_samples + i));
+
+			// Sign-extend to 32 bits.
+			//
+			const auto src_lo = _mm_srai_epi32(_mm_unpacklo_epi16(src_s16, src_s16), 16);
+			const auto src_hi = _mm_srai_epi32(_mm_unpackhi_epi16(src_s16, src_s16), 16);
+
+			const auto dst_lo = _mm_add_ps(
+				_mm_loadu_ps(dst_samples + i), _mm_mul_ps(_mm_cvtepi32_ps(src_lo), sse_s16_to_f));
+
+			const auto dst_hi = _mm_add_ps(
+				_mm_loadu_ps(dst_samples + i + 4), _mm_mul_ps(_mm_cvtepi32_ps(src_hi), sse_s16_to_f));
+
+			_mm_storeu_ps(dst_samples + i, dst_lo);
+			_mm_storeu_ps(dst_samples + i + 4, dst_hi);
+		}
+#endif // LTJS_DMUSIC_SSE2
+
+		for ( ; i < sample_count; ++i)
+		{
+			dst_samples[i] += src_samples[i] * s16_to_f;
+		}
+	}
+
+	//
+	// Finds a minimum and a maximum amplitude of the mix buffer.
+	// The range always includes [-1..1].
+	//
+	static void mix_get_amplitude_range(
+		const float* const samples,
+		const int sample_count,
+		float& min_amplitude,
+		float& max_amplitude)
 	{
-		auto min_amplitude = -1.0F;
-		auto max_amplitude = 1.0F;
+		min_amplitude = -1.0F;
+		max_amplitude = 1.0F;
+
+		auto i = 0;
+
+#ifdef LTJS_DMUSIC_SSE2
+		auto sse_min = _mm_set1_ps(min_amplitude);
+		auto sse_max = _mm_set1_ps(max_amplitude);
+
+		for ( ; (i + 4) <= sample_count; i += 4)
+		{
+			const auto values = _mm_loadu_ps(samples + i);
 
-		for (auto i = 0; i < mix_sample_count_; ++i)
+			sse_min = _mm_min_ps(sse_min, values);
+			sse_max = _mm_max_ps(sse_max, values);
+		}
+
+		sse_min = _mm_min_ps(sse_min, _mm_shuffle_ps(sse_min, sse_min, _MM_SHUFFLE(1, 0, 3, 2)));
+		sse_min = _mm_min_ps(sse_min, _mm_shuffle_ps(sse_min, sse_min, _MM_SHUFFLE(2, 3, 0, 1)));
+		sse_max = _mm_max_ps(sse_max, _mm_shuffle_ps(sse_max, sse_max, _MM_SHUFFLE(1, 0, 3, 2)));
+		sse_max = _mm_max_ps(sse_max, _mm_shuffle_ps(sse_max, sse_max, _MM_SHUFFLE(2, 3, 0, 1)));
+
+		min_amplitude = _mm_cvtss_f32(sse_min);
+		max_amplitude = _mm_cvtss_f32(sse_max);
+#endif // LTJS_DMUSIC_SSE2
+
+		for ( ; i < sample_count; ++i)
 		{
-			if (mix_buffer_[i] < min_amplitude)
+			if (samples[i] < min_amplitude)
 			{
-				min_amplitude = mix_buffer_[i];
+				min_amplitude = samples[i];
 			}
 
-			if (mix_buffer_[i] > max_amplitude)
+			if (samples[i] > max_amplitude)
 			{
-				max_amplitude = mix_buffer_[i];
+				max_amplitude = samples[i];
 			}
 		}
+	}
+
+	//
+	// Scales the samples and converts them to 16-bit ones with saturation.
+	//
+	static void mix_convert_to_s16(
+		const float* const src_samples,
+		std::int16_t* const dst_samples,
+		const int sample_count,
+		const float scale)
+	{
+		auto i = 0;
+
+#ifdef LTJS_DMUSIC_SSE2
+		const auto sse_scale = _mm_set1_ps(scale);
+
+		for ( ; (i + 8) <= sample_count; i += 8)
+		{
+			// Truncate like "static_cast<int>" does; the pack saturates to [-32768..32767].
+			//
+			const auto lo = _mm_cvttps_epi32(_mm_mul_ps(_mm_loadu_ps(src_samples + i), sse_scale));
+			const auto hi = _mm_cvttps_epi32(_mm_mul_ps(_mm_loadu_ps(src_samples + i + 4), sse_scale));
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst_samples + i), _mm_packs_epi32(lo, hi));
+		}
+#endif // LTJS_DMUSIC_SSE2
+
+		for ( ; i < sample_count; ++i)
+		{
+			const auto sample = ul::Algorithm::clamp(
+				static_cast<int>(src_samples[i] * scale), -32768, 32767);
+
+			dst_samples[i] = static_cast<std::int16_t>(sample);
+		}
+	}
+
+	void update_device_buffer()
+	{
+		auto min_amplitude = 0.0F;
+		auto max_amplitude = 0.0F;
+
+		mix_get_amplitude_range(mix_buffer_.data(), mix_sample_count_, min_amplitude, max_amplitude);
 
 		auto scale = 32768.0F;
 
@@ -1631,35 +1790,83 @@ private:
 			scale /= max_amplitude - min_amplitude;
 		}
 
-		for (auto i = 0; i < mix_sample_count_; ++i)
-		{
-			const auto sample = ul::Algorithm::clamp(
-				static_cast<int>(mix_buffer_[i] * scale), -32768, 32767);
+		mix_convert_to_s16(mix_buffer_.data(), device_buffer_.data(), mix_sample_count_, scale);
+	}
 
-			device_buffer_[i] = static_cast<std::int16_t>(sample);
+	void log_mixer_stats()
+	{
+		const auto& stats = mt_mixer_stats_;
+
+		if (stats.buffer_count_ == 0)
+		{
+			return;
 		}
+
+		log_info(
+			1,
+			"Mixer: %d buffers, %d underruns, %.3f ms average, %.3f ms max.",
+			stats.buffer_count_,
+			stats.underrun_count_,
+			static_cast<double>(stats.mix_time_ns_) / stats.buffer_count_ / 1'000'000.0,
+			static_cast<double>(stats.max_mix_time_ns_) / 1'000'000.0
+		);
 	}
 
 	void mt_mixer_worker()
 	{
-		const auto delay = std::chrono::milliseconds{25};
+		using Clock = std::chrono::steady_clock;
+
+		// Playback time of one buffer.
+		const auto buffer_duration = std::chrono::milliseconds{mix_size_ms};
+
+		// Retry interval when the expected buffer has not been processed yet.
+		const auto retry_delay = std::chrono::milliseconds{mix_size_ms / 5};
+
+		LTJS_PROFILE_THREAD("DMusicMixer");
+
+		// Were the buffers of the stream filled since the last start?
+		auto is_primed = false;
 
 		while (!mt_is_quit_mixer_)
 		{
-			auto is_delay = true;
+			// Wait for a notification only by default.
+			auto is_delay = false;
+			auto deadline = Clock::time_point{};
 
 			if (!music_stream_->get_pause())
 			{
+				LTJS_PROFILE_ZONE("DMusicManager::mix");
+
 				const auto free_buffer_count = music_stream_->get_free_buffer_count();
 
 				if (free_buffer_count > 0)
 				{
+					if (is_primed && free_buffer_count >= music_stream_queue_size_)
+					{
+						mt_mixer_stats_.underrun_count_ += 1;
+					}
+
+					is_primed = true;
+					is_delay = true;
+
 					for (auto i = 0; i < free_buffer_count; ++i)
 					{
+						const auto mix_begin_ns = get_profiler_time_ns();
+
 						const auto is_last = !mix();
 
 						update_device_buffer();
 
+						const auto mix_time_ns = get_profiler_time_ns() - mix_begin_ns;
+
+						mt_mixer_stats_.buffer_count_ += 1;
+						mt_mixer_stats_.mix_time_ns_ += mix_time_ns;
+
+						if (mix_time_ns > mt_mixer_stats_.max_mix_time_ns_)
+						{
+							mt_mixer_stats_.max_mix_time_ns_ = mix_time_ns;
+						}
+
 						if (!music_stream_->enqueue_buffer(device_buffer_.data()))
 						{
 							return;
@@ -1667,20 +1874,32 @@ private:
 
 						if (is_last)
 						{
+							is_primed = false;
 							is_delay = false;
 							break;
 						}
 					}
+
+					// The oldest queued buffer is processed one buffer duration later at most.
+					//
+					deadline = Clock::now() + buffer_duration;
+				}
+				else
+				{
+					// Woke up a bit early.
+					//
+					is_delay = true;
+					deadline = Clock::now() + retry_delay;
 				}
 			}
 			else
 			{
-				is_delay = false;
+				is_primed = false;
 			}
 
 			if (is_delay)
 			{
-				std::this_thread::sleep_for(delay);
+				mt_wait_for_mixer_cv_until(deadline);
 			}
 			else
 			{
@@ -12,7 +12,8 @@ namespace ltjs
 
 OalLtSoundSys::OalLtSoundSys()
 {
-	logger_ = make_logger("snddrv_oal", "ltjs_snddrv_log.txt");
+	// The driver logs from the streaming and mixing threads; keep file I/O off them.
+	logger_ = make_async_logger("snddrv_oal", "ltjs_snddrv_log.txt", AsyncLoggerParam{});
 	logger_->info("<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<");
 }
 
@@ -1788,11 +1789,14 @@ void OalLtSoundSys::sound_worker()
 {
 	const auto sleep_delay = std::chrono::milliseconds{10};
 
+	LTJS_PROFILE_THREAD("Sound");
+
 	while (!mt_is_stop_sound_worker_)
 	{
 		auto are_samples_idle = false;
 
 		{
+			LTJS_PROFILE_ZONE("OalLtSoundSys::mix_samples");
 			MtUniqueLock lock{mt_samples_mutex_};
 
 			if (mt_open_samples_.empty())
@@ -1828,6 +1832,7 @@ void OalLtSoundSys::sound_worker()
 		auto are_3d_objects_idle = false;
 
 		{
+			LTJS_PROFILE_ZONE("OalLtSoundSys::mix_3d_objects");
 			MtUniqueLock lock{mt_3d_objects_mutex_};
 
 			if (mt_open_3d_objects_.empty())
@@ -1863,6 +1868,7 @@ void OalLtSoundSys::sound_worker()
 		auto are_streams_idle = false;
 
 		{
+			LTJS_PROFILE_ZONE("OalLtSoundSys::mix_streams");
 			MtUniqueLock lock{mt_streams_mutex_};
 
 			if (mt_open_streams_.empty())
@@ -13,6 +13,7 @@
 
 #include "ltjs_audio_utils.h"
 #include "ltjs_logger.h"
+#include "ltjs_profiler.h"
 #include "ltjs_oal_lt_sound_sys_generic_stream.h"
 #include "ltjs_oal_lt_sound_sys_streaming_source.h"
 #include "ltjs_oal_lt_filter.h"
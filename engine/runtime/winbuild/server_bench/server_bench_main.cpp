@@ -0,0 +1,205 @@
+
+// Headless server benchmark.  Starts a world on the server module without any
+// real clients, connects scripted bots to it, and prints the ServerBench report
+// for a fixed number of updates.
+//
+//   ltjs_server_bench -world <world> [options]
+//
+//   -rez <file>        Add a resource file or directory (in order, repeatable).
+//   -bots <n>          Number of bots to connect (default 16).
+//   -script <file>     Bot script (see server_bots.h).
+//   -warmup <n>        Updates to run before the capture, while the bots get in (default 100).
+//   -updates <n>       Updates to capture (default 600).
+//   -cmd <string>      Run a console command before the world starts (repeatable).
+//   -profile <file>    Write the profiler zones of the captured updates to a Chrome trace
+//                      (needs LTJS_PROFILER).
+
+#include "ltbasedefs.h"
+#include "server_interface.h"
+#include "ltjs_logger.h"
+#include "ltjs_profiler.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+#define MAX_BENCH_REZ_FILES		32
+#define MAX_BENCH_COMMANDS		32
+
+
+class CBenchAppHandler : public ServerAppHandler
+{
+public:
+
+	virtual LTRESULT ConsoleOutputFn(const char *pMsg)
+	{
+		printf("%s\n", pMsg);
+		return LT_OK;
+	}
+
+	virtual LTRESULT OutOfMemory()
+	{
+		printf("Out of memory\n");
+		exit(1);
+		return LT_OK;
+	}
+};
+
+
+static void PrintUsage()
+{
+	printf("ltjs_server_bench -world <world> [-rez <file>]... [-bots <n>] [-script <file>]\n");
+	printf("                  [-warmup <n>] [-updates <n>] [-cmd <string>]... [-profile <file>]\n");
+}
+
+
+int main(int argc, char **argv)
+{
+	const char *pRezFiles[MAX_BENCH_REZ_FILES];
+	uint32 nRezFiles = 0;
+	const char *pCommands[MAX_BENCH_COMMANDS];
+	uint32 nCommands = 0;
+
+	const char *pWorld = LTNULL;
+	const char *pScript = LTNULL;
+	const char *pProfileFile = LTNULL;
+	int nBots = 16;
+	int nWarmup = 100;
+	int nUpdates = 600;
+
+	ltjs::install_crash_logger_flush();
+
+#ifdef LTJS_PROFILER
+	ltjs::initialize_profiler();
+	LTJS_PROFILE_THREAD("Main");
+#endif // LTJS_PROFILER
+
+	for (int i = 1; i < argc; i++)
+	{
+		const char *pArg = argv[i];
+		const char *pValue = (i + 1 < argc) ? argv[i + 1] : LTNULL;
+
+		if (!pValue)
+		{
+			PrintUsage();
+			return 1;
+		}
+
+		if (stricmp(pArg, "-world") == 0)
+			pWorld = pValue;
+		else if (stricmp(pArg, "-rez") == 0 && nRezFiles < MAX_BENCH_REZ_FILES)
+			pRezFiles[nRezFiles++] = pValue;
+		else if (stricmp(pArg, "-bots") == 0)
+			nBots = atoi(pValue);
+		else if (stricmp(pArg, "-script") == 0)
+			pScript = pValue;
+		else if (stricmp(pArg, "-warmup") == 0)
+			nWarmup = atoi(pValue);
+		else if (stricmp(pArg, "-updates") == 0)
+			nUpdates = atoi(pValue);
+		else if (stricmp(pArg, "-cmd") == 0 && nCommands < MAX_BENCH_COMMANDS)
+			pCommands[nCommands++] = pValue;
+		else if (stricmp(pArg, "-profile") == 0)
+			pProfileFile = pValue;
+		else
+		{
+			PrintUsage();
+			return 1;
+		}
+
+		++i;
+	}
+
+	if (!pWorld || nUpdates <= 0)
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	ServerInterface *pServer = LTNULL;
+	LTGUID cAppGuid;
+	memset(&cAppGuid, 0, sizeof(cAppGuid));
+
+	if (CreateServer(SI_VERSION, cAppGuid, &pServer) != SI_OK || !pServer)
+	{
+		printf("Can't create the server\n");
+		return 1;
+	}
+
+	CBenchAppHandler cHandler;
+	pServer->SetAppHandler(&cHandler);
+
+	bool bOK = pServer->AddResources(pRezFiles, nRezFiles) && pServer->LoadBinaries();
+	if (!bOK)
+		printf("Can't load the resources or the server shell\n");
+
+	if (bOK)
+	{
+		pServer->InitNetworking(LTNULL, 0);
+
+		for (uint32 i = 0; i < nCommands; i++)
+		{
+			pServer->RunConsoleString((char*)pCommands[i]);
+		}
+
+		StartGameRequest cRequest;
+		LTStrCpy(cRequest.m_WorldName, pWorld, sizeof(cRequest.m_WorldName));
+
+		bOK = pServer->StartWorld(&cRequest);
+		if (!bOK)
+			printf("Can't start world %s\n", pWorld);
+	}
+
+	char command[512];
+
+	if (bOK)
+	{
+		if (pScript)
+			LTSNPrintF(command, sizeof(command), "ServerBots %d \"%s\"", nBots, pScript);
+		else
+			LTSNPrintF(command, sizeof(command), "ServerBots %d", nBots);
+		pServer->RunConsoleString(command);
+
+		for (int i = 0; bOK && (i < nWarmup); i++)
+		{
+			LTJS_PROFILE_FRAME();
+			bOK = pServer->Update(0);
+		}
+
+		pServer->RunConsoleString((char*)"ServerBots");
+
+		// The capture starts with the update after the command and reports when it's done.
+		LTSNPrintF(command, sizeof(command), "ServerBench %d", nUpdates);
+		pServer->RunConsoleString(command);
+
+		for (int i = 0; bOK && (i < nUpdates); i++)
+		{
+			LTJS_PROFILE_FRAME();
+			bOK = pServer->Update(0);
+		}
+
+		if (pProfileFile)
+		{
+#ifdef LTJS_PROFILER
+			if (!ltjs::get_profiler()->dump_chrome_trace(nUpdates, pProfileFile))
+				printf("Can't write the profile to %s\n", pProfileFile);
+#else // LTJS_PROFILER
+			printf("Built without LTJS_PROFILER, no profile written\n");
+#endif // LTJS_PROFILER
+		}
+
+		if (!bOK)
+		{
+			pServer->GetErrorString(command, sizeof(command));
+			printf("Server update failed: %s\n", command);
+		}
+
+		pServer->RunConsoleString((char*)"ServerBots 0");
+	}
+
+	pServer->SetAppHandler(LTNULL);
+	DeleteServer();
+
+	return bOK ? 0 : 1;
+}
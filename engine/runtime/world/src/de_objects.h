@@ -283,6 +283,7 @@ public:
 
     // WorldTreeObj overrides.
     virtual bool InsertSpecial(WorldTree *pTree);
+    virtual bool HasSpecialInsert();
 
     //
     //Stuff above here relies on the BSP world rep.
@@ -304,6 +305,7 @@ public:
     void                Clear();
 
     virtual bool		InsertSpecial(WorldTree *pTree);
+    virtual bool		HasSpecialInsert();
 
     // Makes an HPOLY given a node.  This has to check both the BSPs in
     // m_pWorldData to see which one the Node is in.
@@ -467,7 +469,8 @@ public:
 	uint32				NodeGetChild( uint32 inode, uint32 index );
 	uint32				NodeGetParent( uint32 inode );
 
-	// transform access returns false if no cached transforms.
+	// transform access returns false if no cached transforms. On the client a model whose pose
+	// the animation LOD holds (m_bAnimLODHoldPose) returns the held pose, the one that's drawn.
 	bool				GetCachedTransform( uint32 iNode, LTMatrix &transform );
 	
 	// get transforms used for rendering, these are device dependant matrices.
@@ -507,6 +510,23 @@ public:
 	//this will mark all nodes as needing to be re-evaluated
 	void				ResetCachedTransformNodeStates();
 
+	//call when a tracker is moved to another animation or time. Drops the cached pose, including
+	//one the client animation LOD is holding back
+	void				ResetCachedPose();
+
+	// pose cache counters. There is one set for the client and one for the server,
+	// the owner of the frame loop prints and clears them.
+	struct SPoseCacheStats
+	{
+		uint32		m_nHits;			// node reads served from the cached pose
+		uint32		m_nMisses;			// node reads that had to evaluate the hierarchy
+		uint32		m_nEvaluations;		// transform maker passes (full or path-limited)
+
+		void		Clear()				{ m_nHits = 0; m_nMisses = 0; m_nEvaluations = 0; }
+	};
+
+	static SPoseCacheStats&	GetPoseCacheStats( ClientServerType cs )	{ return s_PoseCacheStats[ cs ]; }
+
 	// Helpers.
 public:
 
@@ -541,12 +561,17 @@ public:
 
     Sprite*             m_pSprites[MAX_MODEL_TEXTURES];         // It might be using a sprite to update the texture frames.
     SpriteTracker       m_SpriteTrackers[MAX_MODEL_TEXTURES];
+    SpriteEntry*        m_pSkinSpriteFrames[MAX_MODEL_TEXTURES];   // The sprite frame each sprite skin was last bound from (client only).
 
     LTVector            m_LastDirLightPos;                      // Last position at which this instance was directionally lit (used for static sunlight)
     float               m_LastDirLightAmount;                   // Previous amount of directional lighting applied to the model (-1 if never previously lit)
 	uint16				m_nRenderInfoIndex;						// Index to use during rendering of the global model info cache (used for client side rendering only, this will be INVALID_MODEL_INFO_INDEX outside of rendering)
 	uint16				m_nRenderInfoParentIndex;				// Index of parent's render information. Used in rendering to work around attachments
 	uint8				m_nNumSprites;							// The number of sprites this model has loaded on it. Primarily for optimizing away the need to update sprites
+	uint32				m_nAnimLODPendingMS;					// Animation time the held pose is behind the trackers (client only)
+	bool				m_bAnimLODHoldPose;						// Keep the cached pose while the trackers play on, the model is evaluated at a reduced rate (client only)
+	float				m_fAnimLODScreenSize;					// Largest size the model was drawn at since its last animation update, as its radius over half the screen height. 0 if it wasn't drawn (client only)
+	bool				m_bAnimUpdated;							// Was animated in the parallel pass of this frame's object update (client only)
 
 #if(MODEL_OBB)
 	// Oriented Bounding Box (OBB) Methods.
@@ -594,6 +619,28 @@ protected :
 	
 	SCachedTransformInfo   *m_CachedTransformInfo;
 
+	// what the cached pose was evaluated for. Everything the transform maker reads
+	// from the instance is in here, so a read can tell whether the evaluated nodes
+	// are still good without relying on every tracker change resetting the cache.
+	struct SPoseCacheStamp
+	{
+		LTVector	m_Pos;
+		LTRotation	m_Rot;
+		LTVector	m_Scale;
+		HMODELNODE	m_hHintNode;
+		uint32		m_nTimeRefs;
+		AnimTimeRef	m_TimeRefs[ MAX_GVP_ANIMS ];
+	};
+
+	SPoseCacheStamp		m_PoseCacheStamp;
+
+	// drop the cached nodes if the object moved or the animation time changed since
+	// they were evaluated, and restamp the cache with the current state. While the
+	// pose is held only a change of animation counts, not the time moving on.
+	void				ValidatePoseCache();
+
+	static SPoseCacheStats	s_PoseCacheStats[2];
+
 	StringKeyCallback   m_StringKeyCallBack;
 
 	struct SNodeControlInfo
@@ -620,6 +667,11 @@ protected :
 	SNodeInfo			*m_pNodeInfo;
 	uint32				m_nNumNodeInfos;
 
+	//how many node controls are installed over all nodes. Node controls can change
+	//the pose without the animation changing, so their presence disables cache reuse
+	//across updates.
+	uint32				m_nNumNodeControls;
+
 	// update the movement encoding hint node. 
 	// this is done only on the client.s
 	void DoMoveHint( LTAnimTracker *pTracker );
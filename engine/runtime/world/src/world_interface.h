@@ -27,6 +27,10 @@ public:
 	virtual void EncodeCompressWorldPosition(CompWorldPos *pPos, const LTVector *pVal) = 0;
 	virtual void DecodeCompressWorldPosition(LTVector *pVal, const CompWorldPos *pPos) = 0;
 
+	// array versions of the above
+	virtual void EncodeCompressWorldPositions(CompWorldPos *pPos, const LTVector *pVals, uint32 nCount) = 0;
+	virtual void DecodeCompressWorldPositions(LTVector *pVals, const CompWorldPos *pPos, uint32 nCount) = 0;
+
     //
     //
     //Physics stuff will most likely go here, since it could work
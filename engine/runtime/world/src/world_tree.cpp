@@ -13,12 +13,11 @@ typedef void (*FilterFn_R)(WorldTreeNode *pNode, void *pData);
 class FilterObjInfo
 {
 public:
-	WorldTreeObj		*m_pObj;
-	NodeObjArray		m_iObjArray;
 	LTVector			m_Min;
 	LTVector			m_Max;
 	float				m_MaxSize;
-	uint32				m_iCurLink;
+	uint32				m_nNodes;
+	WorldTreeNode		*m_pNodes[MAX_OBJ_NODE_LINKS];
 };
 
 
@@ -70,26 +69,23 @@ inline void FilterBox(	const LTVector *pMin, const LTVector *pMax,
 }
 	
 
+// Finds the nodes an object's box belongs on.  Nothing is linked here so the
+// result can be compared against where the object already is.
 static void FilterObj_R(WorldTreeNode *pNode, FilterObjInfo *pInfo)
 {
 	if(pInfo->m_MaxSize >= (pNode->GetSmallestDim() * 0.5f) || !pNode->HasChildren())
 	{
 		// This shouldn't ever happen.  If it does, the object won't be
 		// located correctly.
-		if(pInfo->m_iCurLink >= MAX_OBJ_NODE_LINKS)
+		if(pInfo->m_nNodes >= MAX_OBJ_NODE_LINKS)
 		{
 			ASSERT(false);
 			return;
 		}
 	
-		// Ok, it's likely to cover the space of all the nodes below us anyways, so add it
-		// to this node and stop recursing.
-		WTObjLink *pLink = &pInfo->m_pObj->m_Links[pInfo->m_iCurLink];
-		ASSERT(pLink->m_Link.IsTiedOff());
-
-		pNode->AddObjectToList(pLink, pInfo->m_iObjArray);
-
-		pInfo->m_iCurLink++;
+		// Ok, it's likely to cover the space of all the nodes below us anyways, so it
+		// goes on this node and we stop recursing.
+		pInfo->m_pNodes[pInfo->m_nNodes++] = pNode;
 	}
 	else
 	{
@@ -333,6 +329,8 @@ WorldTreeObj::WorldTreeObj(WTObjType objType)
 
 	m_ObjType = objType;
 	m_WTFrameCode = FRAMECODE_NOTINTREE;
+	m_nFilterLinks = 0;
+	m_iFilterArray = NOA_Objects;
 }
 
 
@@ -345,6 +343,7 @@ WorldTreeObj::~WorldTreeObj()
 void WorldTreeObj::RemoveFromWorldTree()
 {
 	m_WTFrameCode = FRAMECODE_NOTINTREE;
+	m_nFilterLinks = 0;
 	for(uint32 i=0; i < MAX_OBJ_NODE_LINKS; i++)
 	{
 		WTObjLink *pLink = &m_Links[i];
@@ -423,6 +422,52 @@ void WorldTreeNode::RemoveLink(WTObjLink* pLink)
 	}
 }
 
+//moves a link to another node, only updating the counts of the nodes below the
+//common ancestor of the two nodes
+void WorldTreeNode::MoveLink(WTObjLink* pLink, WorldTreeNode* pNewNode, NodeObjArray iArray)
+{
+	WorldTreeNode *pOldNode = pLink->m_pNode;
+	WorldTreeNode *pTempNode;
+	uint32 nOldDepth, nNewDepth;
+
+	pLink->m_Link.Remove();
+	dl_Insert(&pNewNode->m_Objects[iArray], &pLink->m_Link);
+	pLink->m_pNode = pNewNode;
+
+	//find the depths of the two nodes so we can walk them up to the same level
+	nOldDepth = 0;
+	for(pTempNode = pOldNode->m_pParent; pTempNode; pTempNode = pTempNode->m_pParent)
+		nOldDepth++;
+
+	nNewDepth = 0;
+	for(pTempNode = pNewNode->m_pParent; pTempNode; pTempNode = pTempNode->m_pParent)
+		nNewDepth++;
+
+	for(; nOldDepth > nNewDepth; nOldDepth--)
+	{
+		assert(pOldNode->GetNumObjectsOnOrBelow());
+		pOldNode->m_nObjectsOnOrBelow--;
+		pOldNode = pOldNode->m_pParent;
+	}
+
+	for(; nNewDepth > nOldDepth; nNewDepth--)
+	{
+		pNewNode->m_nObjectsOnOrBelow++;
+		pNewNode = pNewNode->m_pParent;
+	}
+
+	//the counts of the common ancestor and everything above it don't change
+	while(pOldNode != pNewNode)
+	{
+		assert(pOldNode->GetNumObjectsOnOrBelow());
+		pOldNode->m_nObjectsOnOrBelow--;
+		pOldNode = pOldNode->m_pParent;
+
+		pNewNode->m_nObjectsOnOrBelow++;
+		pNewNode = pNewNode->m_pParent;
+	}
+}
+
 void WorldTreeNode::Term()
 {
 	uint32 i;
@@ -539,7 +584,9 @@ void WorldTreeNode::AddObjectToList(WTObjLink *pLink, NodeObjArray iArray)
 WorldTree::WorldTree() :
 	m_pHelper(NULL),
 	m_pNodes(NULL),
-	m_nNumNodes(1)
+	m_nNumNodes(1),
+	m_nRelinksSkipped(0),
+	m_nRelinksPerformed(0)
 {
 	m_AlwaysVisObjects.TieOff();
 }
@@ -585,24 +632,151 @@ void WorldTree::InsertObject2(WorldTreeObj *pObj,
 {
 	FilterObjInfo foInfo;
 	LTVector vDiff;
-
-	pObj->RemoveFromWorldTree();
+	uint32 i;
 
 	vDiff = vMax - vMin;
 	
-	foInfo.m_pObj = pObj;
-	foInfo.m_iObjArray = iArray;
 	foInfo.m_Min = vMin;
 	foInfo.m_Max = vMax;
 	foInfo.m_MaxSize = LTMAX(vDiff.x, vDiff.z);
-	foInfo.m_iCurLink = 0;
+	foInfo.m_nNodes = 0;
+
+	// If the object was filtered into this array last time and will be again, 
+	// only the links that land on different nodes need to change.
+	if(pObj->m_nFilterLinks && pObj->m_iFilterArray == iArray && !pObj->HasSpecialInsert())
+	{
+		FilterObj_R(&m_RootNode, &foInfo);
+		RelinkObject(pObj, foInfo.m_pNodes, foInfo.m_nNodes, iArray);
+		return;
+	}
+
+	pObj->RemoveFromWorldTree();
 
 	if(!pObj->InsertSpecial(this))
 	{
 		FilterObj_R(&m_RootNode, &foInfo);
+
+		for(i=0; i < foInfo.m_nNodes; i++)
+		{
+			WTObjLink *pLink = &pObj->m_Links[i];
+			ASSERT(pLink->m_Link.IsTiedOff());
+
+			foInfo.m_pNodes[i]->AddObjectToList(pLink, iArray);
+		}
+
+		pObj->m_nFilterLinks = foInfo.m_nNodes;
+		pObj->m_iFilterArray = iArray;
 	}
 }
 
+void WorldTree::RelinkObject(WorldTreeObj *pObj, 
+	WorldTreeNode **ppNodes, 
+	uint32 nNodes, 
+	NodeObjArray iArray)
+{
+	bool bLinkKept[MAX_OBJ_NODE_LINKS];
+	bool bNodeUsed[MAX_OBJ_NODE_LINKS];
+	uint32 nOldLinks, nKept, i, j, iDest;
+	WTObjLink *pLink;
+
+	// Same as removing and inserting it, queries will see the object again.
+	pObj->m_WTFrameCode = FRAMECODE_NOTINTREE;
+
+	nOldLinks = pObj->m_nFilterLinks;
+	nKept = 0;
+
+	for(j=0; j < nNodes; j++)
+	{
+		bNodeUsed[j] = false;
+	}
+
+	// Keep any links that are already on one of the new nodes.
+	for(i=0; i < nOldLinks; i++)
+	{
+		bLinkKept[i] = false;
+
+		for(j=0; j < nNodes; j++)
+		{
+			if(!bNodeUsed[j] && pObj->m_Links[i].m_pNode == ppNodes[j])
+			{
+				bLinkKept[i] = true;
+				bNodeUsed[j] = true;
+				nKept++;
+				break;
+			}
+		}
+	}
+
+	if(nKept == nOldLinks && nKept == nNodes)
+	{
+		m_nRelinksSkipped++;
+		return;
+	}
+
+	m_nRelinksPerformed++;
+
+	// Move the rest of the old links over to the new nodes, removing the ones
+	// left over if the object is on fewer nodes now.
+	j = 0;
+	for(i=0; i < nOldLinks; i++)
+	{
+		if(bLinkKept[i])
+			continue;
+
+		while(j < nNodes && bNodeUsed[j])
+			j++;
+
+		if(j < nNodes)
+		{
+			WorldTreeNode::MoveLink(&pObj->m_Links[i], ppNodes[j], iArray);
+			bNodeUsed[j] = true;
+		}
+		else
+		{
+			WorldTreeNode::RemoveLink(&pObj->m_Links[i]);
+		}
+	}
+
+	// If it's on more nodes now, every old link got used, so the new ones go after them.
+	for(j=0; j < nNodes; j++)
+	{
+		if(bNodeUsed[j])
+			continue;
+
+		pLink = &pObj->m_Links[i++];
+		ASSERT(pLink->m_Link.IsTiedOff());
+
+		ppNodes[j]->AddObjectToList(pLink, iArray);
+	}
+
+	// Pack the links back down to the front of the array if any were removed.
+	iDest = 0;
+	for(i=0; i < nOldLinks; i++)
+	{
+		pLink = &pObj->m_Links[i];
+		if(!pLink->m_pNode)
+			continue;
+
+		if(i != iDest)
+		{
+			WTObjLink *pDest = &pObj->m_Links[iDest];
+			ASSERT(pDest->m_Link.IsTiedOff());
+
+			// Take its place in the node's list, the counts don't change.
+			dl_Insert(pLink->m_Link.m_pPrev, &pDest->m_Link);
+			pDest->m_pNode = pLink->m_pNode;
+
+			pLink->m_Link.Remove();
+			pLink->m_Link.TieOff();
+			pLink->m_pNode = NULL;
+		}
+
+		iDest++;
+	}
+
+	pObj->m_nFilterLinks = nNodes;
+}
+
 void WorldTree::FindObjectsInBox(const LTVector *pMin, const LTVector *pMax, 
 	WTObjCallback cb, void *pCBUser, NodeObjArray iArray)
 {
@@ -113,6 +113,11 @@ public:
     // If you return LTTRUE, then it assumes you added yourself.
     virtual bool InsertSpecial(WorldTree *pTree) {return LTFALSE;}
 
+    // Returns true if InsertSpecial would add the object itself.  Objects that
+    // are filtered down like normal get relinked in place when they move, so this
+    // must agree with InsertSpecial.
+    virtual bool HasSpecialInsert() {return LTFALSE;}
+
     // Unlink everything from the world tree.
     void RemoveFromWorldTree();
 
@@ -141,6 +146,12 @@ public:
     // Used in conjunction with WorldTree::m_CurFrameCode.
     // Set to FRAMECODE_NOTINTREE if the object is not in the WorldTree.
     uint32          m_WTFrameCode;
+
+    // How many of m_Links were filled in by filtering the object down the tree,
+    // and which node array they're in.  0 if the object isn't in the tree or 
+    // inserted itself.
+    uint32          m_nFilterLinks;
+    NodeObjArray    m_iFilterArray;
 };
 
 
@@ -189,6 +200,10 @@ public:
 	//static member to handle the cleanup of a world tree link so that it can remove any dependancies
 	static void				RemoveLink(WTObjLink* pLink);
 
+	//moves a link to another node, only updating the counts of the nodes below the
+	//common ancestor of the two nodes
+	static void				MoveLink(WTObjLink* pLink, WorldTreeNode* pNewNode, NodeObjArray iArray);
+
 private:
 
 	// Load the tree layout, and use the node list for the children
@@ -272,6 +287,12 @@ public:
 	//gets the current temporary frame code of the tree
 	uint32			GetTempFrameCode() const		{ return m_nTempFrameCode; }
 
+	//gets the number of moves of filtered objects that didn't change their nodes,
+	//and the number that moved only the links that changed
+	uint32			GetNumRelinksSkipped() const	{ return m_nRelinksSkipped; }
+	uint32			GetNumRelinksPerformed() const	{ return m_nRelinksPerformed; }
+	void			ResetRelinkCounts()				{ m_nRelinksSkipped = m_nRelinksPerformed = 0; }
+
     WorldTreeNode*			GetRootNode()			{ return &m_RootNode; }
 	const WorldTreeNode*	GetRootNode() const		{ return &m_RootNode; }
 
@@ -280,6 +301,10 @@ public:
 
 private:
 
+    // Moves an object that was filtered into the tree before to the nodes its
+    // new box filters to, touching only the links that changed.
+    void            RelinkObject(WorldTreeObj *pObj, WorldTreeNode **ppNodes, uint32 nNodes, NodeObjArray iArray);
+
     // Used by Inherit to recursively copy nodes over
     void            CopyNodeLayout_R(WorldTreeNode *pDest, const WorldTreeNode *pSrc, 
 									 WorldTreeNode* pNodeList, uint32& nCurrOffset);
@@ -293,6 +318,10 @@ private:
     // Gotten from m_pHelper and used during queries.
     uint32          m_nTempFrameCode;
 
+    // Relink statistics, see GetNumRelinksSkipped.
+    uint32          m_nRelinksSkipped;
+    uint32          m_nRelinksPerformed;
+
     // Root of tree (depth value 0).        
     WorldTreeNode   m_RootNode;
 
@@ -122,6 +122,9 @@ position and rotation).
   revaluated for every call to get GetSocketTransform. If this function is going to be called
   a lot, consider caching the animation data by enabling the transformation cache.
 
+  \note On the client this is the pose the model is drawn with, which the animation LOD can
+  hold back for small or hidden models, see GetNodeTransform().
+
 Used for: Models and Animation.
 */
 	virtual LTRESULT GetSocketTransform(HOBJECT hObj,
@@ -248,6 +251,14 @@ Get the transformation for a node on a model.  If \b bWorldSpace is \b
 TRUE, then the transform is returned in world space. Otherwise, the
 transform is local to the model.
 
+\note On the client, the pose of a model that is drawn small or not at
+all is only evaluated every so often (see the \b ModelAnimLOD console
+variables), and this returns the pose the model is drawn with, which
+can be up to \b ModelAnimLODHiddenMS behind its animation time.  Models
+with \b FLAG_UPDATEUNSEEN or \b FLAG_REALLYCLOSE are evaluated every
+frame.  Changing an animation or its time drops the held pose.  The
+server always returns the current pose.
+
 \see GetNode
 
 Used for: Models and Animation.
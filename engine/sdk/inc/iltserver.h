@@ -1917,6 +1917,57 @@ Used for: Special FX.
 */
     LTRESULT (*SetGlobalLightObject)(HOBJECT hObj);
 
+/*!
+Object queries.  These are at the end so the rest of the vtable keeps its
+layout for game modules built against older headers.
+*/
+
+/*!
+\param vPos        Center of the sphere.
+
+\param fRadius     Radius of the sphere.
+
+\param objArray    (return) The objects touching the sphere.
+
+\param nTypeMask   Only objects whose OBJTYPE_MASK() is in this mask are returned.
+
+\param nFlags      Only objects with all of these flags (FLAG_) set are returned.
+
+\param nTotalFound (return) Number of objects found, which can be more than fit in objArray.
+
+Get the objects touching a sphere, like FindObjectsTouchingSphere(), without
+allocating an ObjectList.  Objects that are going away are skipped.
+
+Used for: Object.  
+*/
+    virtual LTRESULT FindObjectsInSphere(const LTVector &vPos, float fRadius,
+                     BaseObjArray<HOBJECT> &objArray,
+                     uint32 nTypeMask=OBJTYPE_MASK_ALL, uint32 nFlags=0,
+                     uint32 *nTotalFound=NULL)=0;
+
+/*!
+\param vMin        Minimum corner of the box.
+
+\param vMax        Maximum corner of the box.
+
+\param objArray    (return) The objects touching the box.
+
+\param nTypeMask   Only objects whose OBJTYPE_MASK() is in this mask are returned.
+
+\param nFlags      Only objects with all of these flags (FLAG_) set are returned.
+
+\param nTotalFound (return) Number of objects found, which can be more than fit in objArray.
+
+Get the objects touching a box, like GetBoxIntersecters(), without
+allocating an ObjectList.  Objects that are going away are skipped.
+
+Used for: Object.  
+*/
+    virtual LTRESULT FindObjectsInBox(const LTVector &vMin, const LTVector &vMax,
+                     BaseObjArray<HOBJECT> &objArray,
+                     uint32 nTypeMask=OBJTYPE_MASK_ALL, uint32 nFlags=0,
+                     uint32 *nTotalFound=NULL)=0;
+
 };
 
 #endif  //! __ILTSERVER_H__
@@ -2108,6 +2108,12 @@ ALSO NOTE: The networking assumes there are < 16 object types!
     NUM_OBJECTTYPES =     12,
 };
 
+/*!
+Object type masks, for filtering object queries by type.
+*/
+#define OBJTYPE_MASK(type)      (1 << (type))
+#define OBJTYPE_MASK_ALL        ((1 << NUM_OBJECTTYPES) - 1)
+
 /*!
 Size defines used for Parse functions
 Use these to size your argument buffer and argument pointer
@@ -0,0 +1,223 @@
+#ifndef __BVH4_H__
+#define __BVH4_H__
+
+#ifndef __AABB_H__
+#include "aabb.h"
+#endif
+
+#ifndef __TRIANGLE_H__
+#include "triangle.h"
+#endif
+
+
+//---------------------------------------------------------------------------//
+/*!
+The LTBVH4_Node data type is one node of a 4-wide bounding volume hierarchy.
+The bounds of the four children are stored one component per array so that
+all four can be tested at once.
+
+\note	Unused lanes have inverted bounds (min > max), so they never pass a test.
+
+\see	LTBVH4
+
+Used for:  Physics
+*/
+struct LTBVH4_Node
+{
+	/*!Child bounds, lane i is child i.*/
+	float MinX[4], MinY[4], MinZ[4];
+	float MaxX[4], MaxY[4], MaxZ[4];
+
+	/*!Interior child: index of the child node.
+	Leaf child: index of its first entry in the triangle index array.*/
+	uint32 Child[4];
+
+	/*!Number of triangles in a leaf child, 0 for interior children.*/
+	uint32 Count[4];
+};
+
+
+//---------------------------------------------------------------------------//
+/*!
+The LTBVH4_Callback function object interface receives the triangles found
+by an LTBVH4 query as they are found, so a query never has to drop any.
+
+\see	LTBVH4::BoxSweep(), LTBVH4::BoxIntersect()
+
+Used for:  Physics
+*/
+struct LTBVH4_Callback
+{
+	/*!
+	\param	ti	Index of a triangle whose bounds passed the test.
+	\return		\b false to stop the query, \b true to continue.
+
+	Used for:  Physics.
+	*/
+	virtual bool Triangle( const uint32 ti ) = 0;
+};
+
+
+//---------------------------------------------------------------------------//
+/*!
+The LTTriangleIndexList collects the triangles found by an LTBVH4 query.
+The first 128 indices are stored in the object, after that the list grows
+on the heap.
+
+Used for:  Physics
+*/
+class LTTriangleIndexList : public LTBVH4_Callback
+{
+public:
+
+	LTTriangleIndexList()
+		:	m_pIndex(m_Local),
+			m_Count(0),
+			m_Size(LOCAL_SIZE)
+	{}
+
+	~LTTriangleIndexList()
+	{
+		if( m_pIndex != m_Local )
+			delete [] m_pIndex;
+	}
+
+	bool Triangle( const uint32 ti )
+	{
+		if( m_Count == m_Size )
+			Grow();
+
+		m_pIndex[m_Count++] = ti;
+
+		return true;
+	}
+
+	/*!\return	the number of triangles found*/
+	uint32 Count() const
+	{
+		return m_Count;
+	}
+
+	uint32 operator [] ( const uint32 i ) const
+	{
+		return m_pIndex[i];
+	}
+
+private:
+
+	enum { LOCAL_SIZE = 128 };
+
+	void Grow();
+
+	//not copyable
+	LTTriangleIndexList( const LTTriangleIndexList& );
+	LTTriangleIndexList& operator = ( const LTTriangleIndexList& );
+
+	uint32* m_pIndex;
+	uint32 m_Count;
+	uint32 m_Size;
+	uint32 m_Local[LOCAL_SIZE];
+};
+
+
+//---------------------------------------------------------------------------//
+/*!
+The LTBVH4 class is a 4-wide bounding volume hierarchy over a triangle mesh,
+built with the surface area heuristic.  Unlike the LTAABB_Node tree it is not
+part of the collision data file format, it is built from the mesh at runtime,
+and it uses 32-bit node and triangle indices.
+
+\see	LTBVH4_Node, LTCollisionMesh
+
+Used for:  Physics
+*/
+class LTBVH4
+{
+public:
+
+	LTBVH4();
+	~LTBVH4();
+
+	/*!
+	\param	tri		Triangle array.
+	\param	tc		Triangle count.
+	\param	V		Vertex array.
+	\return			\b false if the triangle count is 0, \b true otherwise.
+
+	Build the hierarchy over the triangles, replacing any previous one.
+	Triangle bounds are taken from \b V, so they should be the same vertices
+	that the triangles are tested against.
+
+	Used for:  Physics.
+	*/
+	bool Build( const LTTriangle tri[], const uint32 tc, const LTVector3f V[] );
+
+	/*!
+	Free the hierarchy.
+
+	Used for:  Physics.
+	*/
+	void Term();
+
+	/*!
+	\param	cb	Receives the triangles that could have been hit.
+	\param	p0	First position of the swept box.
+	\param	p1	Last position of the swept box.
+	\param	d	Box half-dimensions.
+	\return		\b true if any triangles could have been hit,
+				\b false otherwise.
+
+	Report every triangle whose bounds were touched by an AABB with
+	half-dimensions \b d moving along a linear path from \f$ {\bf p}_0 \f$
+	to \f$ {\bf p}_1 \f$.
+
+	Used for:  Physics.
+	*/
+	bool BoxSweep
+	(
+		LTBVH4_Callback&	cb,
+		const LTVector3f&	p0,
+		const LTVector3f&	p1,
+		const LTVector3f&	d
+	) const;
+
+	/*!
+	\param	cb	Receives the triangles that could be intersected.
+	\param	box	The box to test.
+	\return		\b true if any triangles could be intersected,
+				\b false otherwise.
+
+	Report every triangle whose bounds intersect \b box.
+
+	Used for:  Physics.
+	*/
+	bool BoxIntersect( LTBVH4_Callback& cb, const LTAABB& box ) const;
+
+	/*!\return	the number of nodes*/
+	uint32 NodeCount() const
+	{
+		return m_NCount;
+	}
+
+	/*!\return	the number of nodes on the longest path from the root*/
+	uint32 Depth() const
+	{
+		return m_Depth;
+	}
+
+private:
+
+	//not copyable
+	LTBVH4( const LTBVH4& );
+	LTBVH4& operator = ( const LTBVH4& );
+
+	LTBVH4_Node*	m_pNode;	//node array, root is node 0
+	uint32			m_NCount;	//node count
+	uint32*			m_pTri;		//triangle indices, grouped by leaf
+	uint32			m_TCount;	//triangle count
+	uint32			m_Depth;	//max node depth
+};
+
+
+#endif
+//EOF
@@ -9,6 +9,14 @@
 #include "collision_data.h"
 #endif
 
+#ifndef __BVH4_H__
+#include "bvh4.h"
+#endif
+
+#ifndef __GJK_H__
+#include "gjk.h"
+#endif
+
 
 //---------------------------------------------------------------------------//
 /*!
@@ -222,6 +230,60 @@ enum COLLISION_OBJECT_TYPE
 };
 
 
+//---------------------------------------------------------------------------//
+/*!
+The LTGJKPairCache keeps the last GJK simplex of pairs of objects that are
+tested against each other, so that the closest point queries of objects
+that stay close, such as resting or stacked bodies, can be warm started.
+
+Pairs are ordered (the object whose support map is \b A comes first) and
+hashed into a fixed table; a pair that lands on a slot owned by another pair
+simply takes it over.  Stale entries are harmless, see LTGJKCache.
+
+\see	LTGJKCache, ILTCollisionObject::FindGJKCache()
+
+Used for:  Physics
+*/
+class LTGJKPairCache
+{
+public:
+
+	LTGJKPairCache()
+	{
+		Clear();
+	}
+
+	/*!
+	\param	hA	Object whose support map is \b A
+	\param	hB	Object whose support map is \b B
+	\return		the cache for the pair, NULL if either object is static
+
+	Used For: Physics.
+	*/
+	LTGJKCache* Find( const HOBJECT hA, const HOBJECT hB );
+
+	/*!
+	Forget every pair.
+
+	Used For: Physics.
+	*/
+	void Clear();
+
+private:
+
+	enum { TABLE_SIZE = 256 };
+
+	struct Entry
+	{
+		HOBJECT		m_hA;
+		HOBJECT		m_hB;
+		LTGJKCache	m_Cache;
+	};
+
+	Entry m_Table[TABLE_SIZE];
+};
+
+
 //---------------------------------------------------------------------------//
 /*!
 The ILTCollisionObject interface represents a geometric shape to the
@@ -289,6 +351,8 @@ public:
 	LTOrientation m_R0;
 	/*! Orientation at time \f$ t_0 + \Delta t \f$ */
 	LTOrientation m_R1;
+	/*! Pair cache of the ILTCollisionMgr this object was added to, NULL if none */
+	LTGJKPairCache* m_pGJKCache;
 
 public:
 
@@ -317,12 +381,25 @@ public:
 	)
 		:	m_Type(t), m_hObj(hobj),
 			m_P0(p0), m_P1(p1),
-			m_R0(R0), m_R1(R1)
+			m_R0(R0), m_R1(R1),
+			m_pGJKCache(NULL)
 	{}
 
 	virtual ~ILTCollisionObject()
 	{}
 
+	/*!
+	\param	hA	Object whose support map is \b A
+	\param	hB	Object whose support map is \b B
+	\return		the GJK cache for the pair, NULL if there is none
+
+	Used For: Physics.
+	*/
+	LTGJKCache* FindGJKCache( const HOBJECT hA, const HOBJECT hB ) const
+	{
+		return m_pGJKCache ? m_pGJKCache->Find( hA, hB ) : NULL;
+	}
+
 	/*!
 	\param	i	[Return parameter] Collision information.
 	\param	o	Another ILTCollisionObject
@@ -844,6 +921,9 @@ public:
 	LTCollisionData* m_pData;
 	/*!\b true if collision data should be deleted, \b false otherwise.*/
 	bool m_Delete;
+	/*!Triangle hierarchy, built from the collision data on first use
+	and owned by the mesh.*/
+	mutable LTBVH4* m_pBVH;
 
 public:
 
@@ -873,11 +953,27 @@ public:
 	)
 		:	ILTCollisionObject(COT_MESH,h,p0,p1,R0,R1),
 			m_pData(d),
-			m_Delete(del)
+			m_Delete(del),
+			m_pBVH(NULL)
 	{}
 
 	~LTCollisionMesh();
 
+	/*!
+	\return	the triangle hierarchy of the collision data
+
+	The hierarchy is built the first time it is needed, from the same
+	unpacked vertices that the triangles are tested against.
+
+	\note	The build is not synchronized.  A mesh must not be queried from
+			more than one thread until the first query has returned, so
+			either call BVH() once when the mesh is created or keep its
+			queries on one thread.
+
+	Used For: Physics.
+	*/
+	const LTBVH4& BVH() const;
+
 
 	//Hit
 	virtual bool Hit
@@ -948,6 +1044,12 @@ public:
 		const LTVector3f&				p1,
 		const LTIntersectInfo::Filter&	iif
 	) const;
+
+private:
+
+	//not copyable, the mesh owns m_pBVH (and m_pData if m_Delete)
+	LTCollisionMesh( const LTCollisionMesh& );
+	LTCollisionMesh& operator = ( const LTCollisionMesh& );
 };
 
 
@@ -5,6 +5,9 @@
 #include "coordinate_frame.h"
 
 
+struct LTGJKCache;
+
+
 //---------------------------------------------------------------------------//
 //Check if the swept sphere hit the swept cylinder.  Unit normal n points from
 //cylinder to sphere.
@@ -20,7 +23,8 @@ bool SphereCylinderSweep
 	const LTCoordinateFrameQ& B0,
 	const LTCoordinateFrameQ& B1,
 	const float			rb,
-	const float			hh
+	const float			hh,
+	LTGJKCache*			pCache = NULL	//GJK simplex of the last query
 );
 
 //---------------------------------------------------------------------------//
@@ -37,7 +41,8 @@ bool CylinderBoxSweep
 	const float			hh,
 	const LTCoordinateFrameQ& B0,
 	const LTCoordinateFrameQ& B1,
-	const LTVector3f&	dim
+	const LTVector3f&	dim,
+	LTGJKCache*			pCache = NULL	//GJK simplex of the last query
 );
 
 //---------------------------------------------------------------------------//
@@ -55,7 +60,8 @@ bool CylinderSweep
 	const LTCoordinateFrameQ& B0,
 	const LTCoordinateFrameQ& B1,
 	const float			rb,
-	const float			hb
+	const float			hb,
+	LTGJKCache*			pCache = NULL	//GJK simplex of the last query
 );
 
 
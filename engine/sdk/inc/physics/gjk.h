@@ -257,6 +257,32 @@ public:
 };
 
 
+//---------------------------------------------------------------------------//
+/*!
+The LTGJKCache data type lets GJK_ClosestPoints() start from the simplex it
+ended with on the last query for the same pair of objects.  Only the search
+directions are kept, the support points are recomputed from the current
+shapes, so a cache can never make the result wrong, only slower.
+
+\see	GJK_ClosestPoints(), LTGJKPairCache.
+
+Used for:  Physics.
+*/
+struct LTGJKCache
+{
+	/*!Search directions, parent frame, that produced the simplex vertices.*/
+	LTVector3f m_Dir[4];
+	/*!Number of simplex vertices, 0 if empty.*/
+	int32 m_Count;
+	/*!Number of iterations used by the last query.*/
+	int32 m_Iterations;
+
+	LTGJKCache()
+		:	m_Count(0), m_Iterations(0)
+	{}
+};
+
+
 //---------------------------------------------------------------------------//
 /*!
 \param a	[Return parameter] Closest point on \b A to \b B, world frame
@@ -285,4 +311,76 @@ float GJK_ClosestPoints
 );
 
 
+//---------------------------------------------------------------------------//
+/*!
+\param a		[Return parameter] Closest point on \b A to \b B, world frame
+\param b		[Return parameter] Closest point on \b B to \b A, world frame
+\param Sa		[Return parameter] \b A's support map
+\param Sb		[Return parameter] \b B's support map
+\param pCache	[Return parameter] Simplex from the last query for this pair,
+				updated on return (may be NULL)
+\return			\f$ d \f$, the distance between \b A and \b B
+
+Same as GJK_ClosestPoints() above, but the iteration starts from the simplex
+in \b pCache instead of an empty one.  For objects that move little from one
+query to the next, this usually leaves only one or two iterations.
+
+The overloads for the concrete support maps below call the support mappings
+directly instead of through the virtual interface.
+
+\see	LTGJKCache
+
+Used for: Physics.
+*/
+float GJK_ClosestPoints
+(
+	LTVector3f& a,
+	LTVector3f& b,
+	ILTSupportMap& sA,
+	ILTSupportMap& sB,
+	LTGJKCache* pCache,
+	const float eps = FLT_EPSILON
+);
+
+float GJK_ClosestPoints
+(
+	LTVector3f& a,
+	LTVector3f& b,
+	LTSphereSupportMap& sA,
+	LTCylinderSupportMap& sB,
+	LTGJKCache* pCache,
+	const float eps = FLT_EPSILON
+);
+
+float GJK_ClosestPoints
+(
+	LTVector3f& a,
+	LTVector3f& b,
+	LTCylinderSupportMap& sA,
+	LTBoxSupportMap& sB,
+	LTGJKCache* pCache,
+	const float eps = FLT_EPSILON
+);
+
+float GJK_ClosestPoints
+(
+	LTVector3f& a,
+	LTVector3f& b,
+	LTCylinderSupportMap& sA,
+	LTCylinderSupportMap& sB,
+	LTGJKCache* pCache,
+	const float eps = FLT_EPSILON
+);
+
+float GJK_ClosestPoints
+(
+	LTVector3f& a,
+	LTVector3f& b,
+	LTBoxSupportMap& sA,
+	LTBoxSupportMap& sB,
+	LTGJKCache* pCache,
+	const float eps = FLT_EPSILON
+);
+
+
 #endif
@@ -5,6 +5,9 @@
 #include "coordinate_frame.h"
 
 
+struct LTGJKCache;
+
+
 //---------------------------------------------------------------------------//
 /*!
 \param	C	Sphere position.
@@ -143,11 +146,14 @@ bool OBBIntersect
 \param da	\b A's half-dimensions
 \param B	\b B's local coordinate frame
 \param db	\b B's half-dimensions
+\param pCache	GJK simplex of the last query for this pair (may be NULL)
 \return		\b false if \b A and \b B intersect, \b true otherwise
 
 Given two OBB's \b A and \b B, find the closest points \b a and \b b between
 them.  If A and B intersect, the function returns false.
 
+\see	LTGJKCache
+
 Used for: Physics.
 */
 bool OBBClosestPoints
@@ -157,7 +163,8 @@ bool OBBClosestPoints
 	const LTCoordinateFrameQ&	A,
 	const LTVector3f&			da,
 	const LTCoordinateFrameQ&	B,
-	const LTVector3f&			db
+	const LTVector3f&			db,
+	LTGJKCache*					pCache = NULL
 );
 
 
@@ -173,6 +180,7 @@ bool OBBClosestPoints
 \param B0	\b B's local coordinate frame at time \f$u=0\f$
 \param B1	\b B's local coordinate frame at time \f$u=1\f$
 \param db	\b B's half-dimensions
+\param pCache	GJK simplex of the last query for this pair (may be NULL)
 \return		\b false if \b A and \b B intersect at \f$u=0\f$, \b true otherwise
 
 Given two OBB's \b A and \b B, find the normalized time of collision
@@ -193,7 +201,8 @@ bool OBBSweep
 	const LTVector3f&			da,
 	const LTCoordinateFrameQ&	B0,
 	const LTCoordinateFrameQ&	B1,
-	const LTVector3f&			db
+	const LTVector3f&			db,
+	LTGJKCache*					pCache = NULL
 );
 
 
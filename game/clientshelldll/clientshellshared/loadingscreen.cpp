@@ -23,6 +23,8 @@
 #include "screenpostload.h"
 #include "clientresshared.h"
 
+#include "ltjs_profiler.h"
+
 extern CGameClientShell* g_pGameClientShell;
 
 CLoadingScreen::CLoadingScreen() :
@@ -678,11 +680,16 @@ int CLoadingScreen::RunThread()
 	// Tell the main thread we're now in our main loop
 	SetEvent(m_hEventThreadRunning);
 
+	LTJS_PROFILE_THREAD("LoadingScreen");
+
 	// The main rendering loop...  (i.e. keep drawing until someone tells us to stop)
 	while (WaitForSingleObject(m_hEventEnd, 0) == WAIT_TIMEOUT)
 	{
 		// Draw the frame..
-		Update();
+		{
+			LTJS_PROFILE_ZONE("LoadingScreen::Update");
+			Update();
+		}
 		
 		// Make sure we're not running faster than 10fps so stuff can still happen in the background
 		Sleep(100);
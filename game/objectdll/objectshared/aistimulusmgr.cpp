@@ -37,6 +37,12 @@ static HOBJECT s_hStimulusModel[MAX_STIMULUS_RENDER];
 #define STIMULUS_RADIUS_LARGE		512.0f
 #define INTERSECT_SEGMENT_QUOTA		3
 
+// Stimuli are bucketed by position in cells of this size on the horizontal plane.
+// Stimuli with a larger radius than STIMULUS_GRID_LARGE_RADIUS are kept out of the
+// grid, so one huge stimulus does not make every sensing object query every cell.
+#define STIMULUS_GRID_CELL_SIZE		1024.0f
+#define STIMULUS_GRID_LARGE_RADIUS	4096.0f
+
 
 //
 // CAIStimulusRecord functions.
@@ -242,6 +248,9 @@ CAIStimulusMgr::CAIStimulusMgr()
 	m_bRenderStimulus	= LTFALSE;
 	m_nNextTargetMatchID = 0;
 
+	m_fMaxGridStimulusRadius = 0.f;
+	m_dwStimulusSenseFlags	= 0;
+
 	// ResponseIndex differentiates instances of AIs responding to stimulus.
 	// AIs get the next available index when they activate a stimulated goal.
 	// This index can be used by AI to determine if an Ally is alert due to
@@ -335,6 +344,12 @@ void CAIStimulusMgr::Term()
 	// Remove all sensing objects.
 
 	m_lstSensing.clear();
+
+	// Remove the bucketed stimuli.
+
+	m_mapStimulusGrid.clear();
+	m_lstLargeStimuli.clear();
+	m_lstCandidateStimuli.clear();
 }
 
 
@@ -1201,17 +1216,23 @@ void CAIStimulusMgr::Update()
 //----------------------------------------------------------------------------
 void CAIStimulusMgr::UpdateSensingList()
 {
-	AISTIMULUS_MAP::iterator itRecordPair;
+	AISTIMULUS_GRID_LIST::iterator itCandidate;
 	
 	CAIStimulusRecord* pRecord = LTNULL;
 	IAISensing* pSensing;
 
 	LTBOOL bNewSenseUpdate;
+	LTBOOL bExhaustedStimuli;
 	int cPermittedIntersectSegmentCalls;
 	int cIntersectSegmentCallsPrev;
 
 	LTFLOAT fCurTime = g_pLTServer->GetTime();
 
+	// Stimuli cannot be registered or removed until the update is done,
+	// so bucket them once for all sensing objects.
+
+	BuildStimulusGrid();
+
 	// The list of sensing AI is treated like a time-share system.
 	// Each AI gets to process the stimuli until a relevant one is found,
 	// or an expensive check has been performed.
@@ -1289,6 +1310,7 @@ void CAIStimulusMgr::UpdateSensingList()
 		}
 
 		cIntersectSegmentCallsPrev = g_cIntersectSegmentCalls;
+		bExhaustedStimuli = LTFALSE;
 
 
 		// Try to sense the nearest player, so that AI in multiplayer
@@ -1299,15 +1321,18 @@ void CAIStimulusMgr::UpdateSensingList()
 			pSensing->SetDoneProcessingStimuli( LTTRUE );
 		}
 
-		// Iterate over existing stimulus records.
+		// Iterate over the stimulus records that may be in range,
+		// in alarm level order.
 		
 		else {
 
-			for(itRecordPair = m_stmStimuliMap.begin();
-				itRecordPair != m_stmStimuliMap.end();
-				++itRecordPair)
+			GatherCandidateStimuli( pSensing );
+
+			for(itCandidate = m_lstCandidateStimuli.begin();
+				itCandidate != m_lstCandidateStimuli.end();
+				++itCandidate)
 			{
-				pRecord = itRecordPair->second;
+				pRecord = itCandidate->pRecord;
 
 				if( !pSensing->ProcessStimulus( pRecord ) )
 				{
@@ -1346,12 +1371,14 @@ void CAIStimulusMgr::UpdateSensingList()
 					}
 				}
 			}
+
+			bExhaustedStimuli = ( itCandidate == m_lstCandidateStimuli.end() );
 		}
 		
 		// Call HandleSenses to increment/decrement sense values after a
 		// a stimulus has been found, or the list has been exhausted.
 
-		if( ( itRecordPair == m_stmStimuliMap.end() ) ||
+		if( bExhaustedStimuli ||
 			( pSensing->GetDoneProcessingStimuli() ) )
 		{
 			// Handle senses in the AI's sense recorder.  This will check the cycle stamp to
@@ -1363,6 +1390,169 @@ void CAIStimulusMgr::UpdateSensingList()
 	}
 }
 
+//----------------------------------------------------------------------------
+//              
+//	ROUTINE:	CAIStimulusMgr::BuildStimulusGrid()
+//              
+//	PURPOSE:	Bucket the existing stimuli by position, so each sensing
+//				object only tests stimuli that may be in range.
+//              
+//----------------------------------------------------------------------------
+
+static uint32 GetStimulusGridCell(int nCellX, int nCellZ)
+{
+	return ( (uint32)( nCellX & 0xffff ) << 16 ) | (uint32)( nCellZ & 0xffff );
+}
+
+static int GetStimulusGridCoord(LTFLOAT fPos)
+{
+	return (int)floorf( fPos / STIMULUS_GRID_CELL_SIZE );
+}
+
+void CAIStimulusMgr::BuildStimulusGrid()
+{
+	// Keep the storage of cells that were used last update.
+	// Drop cells that were already empty.
+
+	AISTIMULUS_GRID_MAP::iterator itCell = m_mapStimulusGrid.begin();
+	while( itCell != m_mapStimulusGrid.end() )
+	{
+		if( itCell->second.empty() )
+		{
+			AISTIMULUS_GRID_MAP::iterator next = itCell;
+			++next;
+			m_mapStimulusGrid.erase( itCell );
+			itCell = next;
+		}
+		else {
+			itCell->second.clear();
+			++itCell;
+		}
+	}
+
+	m_lstLargeStimuli.clear();
+	m_fMaxGridStimulusRadius = 0.f;
+	m_dwStimulusSenseFlags = 0;
+
+	AISTIMULUS_GRID_ENTRY Entry;
+	Entry.nOrder = 0;
+
+	AISTIMULUS_MAP::iterator itRecordPair;
+	for(itRecordPair = m_stmStimuliMap.begin();
+		itRecordPair != m_stmStimuliMap.end();
+		++itRecordPair, ++Entry.nOrder)
+	{
+		Entry.pRecord = itRecordPair->second;
+
+		m_dwStimulusSenseFlags |= Entry.pRecord->m_pAIBM_Stimulus->eSenseType;
+
+		if( Entry.pRecord->m_fDistance > STIMULUS_GRID_LARGE_RADIUS )
+		{
+			m_lstLargeStimuli.push_back( Entry );
+			continue;
+		}
+
+		const LTVector& vPos = Entry.pRecord->m_vStimulusPos;
+		uint32 nCell = GetStimulusGridCell( GetStimulusGridCoord( vPos.x ), GetStimulusGridCoord( vPos.z ) );
+		m_mapStimulusGrid[nCell].push_back( Entry );
+
+		m_fMaxGridStimulusRadius = Max( m_fMaxGridStimulusRadius, Entry.pRecord->m_fDistance );
+	}
+}
+
+//----------------------------------------------------------------------------
+//              
+//	ROUTINE:	CAIStimulusMgr::GatherCandidateStimuli()
+//              
+//	PURPOSE:	Fill the candidate list with the stimuli the sensing object
+//				has a sense for and that are within its largest sense
+//				distance, sorted in alarm level order.  Only these can
+//				pass CanSense.
+//              
+//----------------------------------------------------------------------------
+
+static void AddCandidateStimuli(AISTIMULUS_GRID_LIST& lstCandidates, const AISTIMULUS_GRID_LIST& lstStimuli,
+								const LTVector& vSensingPos, LTFLOAT fMaxSenseDistance, uint32 dwSenseFlags)
+{
+	AISTIMULUS_GRID_LIST::const_iterator itEntry;
+	for( itEntry = lstStimuli.begin(); itEntry != lstStimuli.end(); ++itEntry )
+	{
+		CAIStimulusRecord* pRecord = itEntry->pRecord;
+		if( !( pRecord->m_pAIBM_Stimulus->eSenseType & dwSenseFlags ) )
+		{
+			continue;
+		}
+
+		LTFLOAT fRange = fMaxSenseDistance + pRecord->m_fDistance;
+		if( vSensingPos.DistSqr( pRecord->m_vStimulusPos ) < fRange * fRange )
+		{
+			lstCandidates.push_back( *itEntry );
+		}
+	}
+}
+
+void CAIStimulusMgr::GatherCandidateStimuli(IAISensing* pSensing)
+{
+	m_lstCandidateStimuli.clear();
+
+	// Check sense types before any geometry.
+
+	uint32 dwSenseFlags = pSensing->GetCurSenseFlags() & m_dwStimulusSenseFlags;
+	if( !dwSenseFlags )
+	{
+		return;
+	}
+
+	LTFLOAT fMaxSenseDistance = 0.f;
+	for( int iSense = 0; iSense < kSense_Count; ++iSense )
+	{
+		uint32 dwSense = ( 1 << iSense );
+		if( dwSenseFlags & dwSense )
+		{
+			fMaxSenseDistance = Max( fMaxSenseDistance, pSensing->GetSenseDistance( (EnumAISenseType)dwSense ) );
+		}
+	}
+
+	const LTVector& vSensingPos = pSensing->GetSensingPosition();
+
+	AddCandidateStimuli( m_lstCandidateStimuli, m_lstLargeStimuli, vSensingPos, fMaxSenseDistance, dwSenseFlags );
+
+	// Visit the cells within reach of the furthest stimulus the object could sense,
+	// or every cell if there are fewer of them.
+
+	LTFLOAT fReach = fMaxSenseDistance + m_fMaxGridStimulusRadius;
+	LTFLOAT fCellsAcross = ( 2.f * fReach / STIMULUS_GRID_CELL_SIZE ) + 2.f;
+
+	if( fCellsAcross * fCellsAcross > (LTFLOAT)m_mapStimulusGrid.size() )
+	{
+		AISTIMULUS_GRID_MAP::iterator itCell;
+		for( itCell = m_mapStimulusGrid.begin(); itCell != m_mapStimulusGrid.end(); ++itCell )
+		{
+			AddCandidateStimuli( m_lstCandidateStimuli, itCell->second, vSensingPos, fMaxSenseDistance, dwSenseFlags );
+		}
+	}
+	else {
+		int nMinX = GetStimulusGridCoord( vSensingPos.x - fReach );
+		int nMaxX = GetStimulusGridCoord( vSensingPos.x + fReach );
+		int nMinZ = GetStimulusGridCoord( vSensingPos.z - fReach );
+		int nMaxZ = GetStimulusGridCoord( vSensingPos.z + fReach );
+
+		for( int nX = nMinX; nX <= nMaxX; ++nX )
+		{
+			for( int nZ = nMinZ; nZ <= nMaxZ; ++nZ )
+			{
+				AISTIMULUS_GRID_MAP::iterator itCell = m_mapStimulusGrid.find( GetStimulusGridCell( nX, nZ ) );
+				if( itCell != m_mapStimulusGrid.end() )
+				{
+					AddCandidateStimuli( m_lstCandidateStimuli, itCell->second, vSensingPos, fMaxSenseDistance, dwSenseFlags );
+				}
+			}
+		}
+	}
+
+	std::sort( m_lstCandidateStimuli.begin(), m_lstCandidateStimuli.end() );
+}
+
 //----------------------------------------------------------------------------
 //              
 //	ROUTINE:	CAIStimulusMgr::SenseNearestPlayer()
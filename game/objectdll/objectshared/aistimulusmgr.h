@@ -139,6 +139,29 @@ typedef std::multimap<uint8 /*nAIAlarmLevel*/, CAIStimulusRecord* /*srStimulusRe
 typedef std::map<HOBJECT /*hTarget*/, EnumAITargetMatchID> AITARGET_MATCH_MAP;
 
 
+//
+// STRUCT: Stimulus record bucketed by position.  The order is the
+//         record's position in the alarm level sorted stimuli map.
+//
+struct AISTIMULUS_GRID_ENTRY
+{
+	uint32 nOrder;
+	CAIStimulusRecord* pRecord;
+
+	bool operator< (const AISTIMULUS_GRID_ENTRY& entry) const { return bool(nOrder < entry.nOrder); }
+};
+
+//
+// VECTOR: List of bucketed stimulus records.
+//
+typedef std::vector<AISTIMULUS_GRID_ENTRY> AISTIMULUS_GRID_LIST;
+
+//
+// MAP: Uniform grid on the horizontal plane of stimulus records, keyed by cell.
+//
+typedef std::map<uint32 /*nCell*/, AISTIMULUS_GRID_LIST> AISTIMULUS_GRID_MAP;
+
+
 //
 // STRUCT: Struct used to sort stimulus by distance to player.
 //         Used to render stimulus for debugging.
@@ -236,6 +259,8 @@ class CAIStimulusMgr : public ILTObjRefReceiver
 		const CAIStimulusRecord::_listAlignments& AlignmentRequirement ) const;
 
 		void	UpdateSensingList();
+		void	BuildStimulusGrid();
+		void	GatherCandidateStimuli(IAISensing* pSensing);
 		LTBOOL	SenseNearestPlayer(IAISensing* pSensing);
 		bool	CanSense(IAISensing* pSensing,CAIStimulusRecord* pRecord) const;
 
@@ -255,6 +280,12 @@ class CAIStimulusMgr : public ILTObjRefReceiver
 		// Do NOT save the following:
 
 		AISENSING_LIST			m_lstSensing;			// List of sensing objects. Recreated as objects activate/deactivate.
+
+		AISTIMULUS_GRID_MAP		m_mapStimulusGrid;		// Stimuli bucketed by position. Rebuilt every update.
+		AISTIMULUS_GRID_LIST	m_lstLargeStimuli;		// Stimuli too large for the grid, tested by every sensing object.
+		AISTIMULUS_GRID_LIST	m_lstCandidateStimuli;	// Stimuli that may be in range of the sensing object being updated.
+		LTFLOAT					m_fMaxGridStimulusRadius;	// Largest radius of a stimulus in the grid.
+		uint32					m_dwStimulusSenseFlags;	// Sense types of all existing stimuli.
 };
 
 #endif
@@ -24,6 +24,9 @@
 
 #define MIN_RADIUS_PERCENT				0.25f
 
+// Objects a blast can damage without falling back to an engine object list.
+#define MAX_EXPLOSION_OBJECTS			128
+
 LINKFROM_MODULE( Explosion );
 
 #pragma force_active on
@@ -498,18 +501,7 @@ void Explosion::ProgDamageObject(HOBJECT hObj)
 
 void Explosion::ProgDamageObjectsInSphere()
 {
-    ObjectList* pList = g_pLTServer->FindObjectsTouchingSphere(&m_vPos,
-		m_fProgDamageRadius);
-	if (!pList) return;
-
-	ObjectLink* pLink = pList->m_pFirstLink;
-	while (pLink)
-	{
-		ProgDamageObject(pLink->m_hObject);
-		pLink = pLink->m_pNext;
-	}
-
-    g_pLTServer->RelinquishList(pList);
+	DamageObjectsInSphere(m_fProgDamageRadius, &Explosion::ProgDamageObject);
 }
 
 // ----------------------------------------------------------------------- //
@@ -522,13 +514,44 @@ void Explosion::ProgDamageObjectsInSphere()
 
 void Explosion::AreaDamageObjectsInSphere()
 {
-    ObjectList* pList = g_pLTServer->FindObjectsTouchingSphere(&m_vPos, m_fDamageRadius);
+	DamageObjectsInSphere(m_fDamageRadius, &Explosion::AreaDamageObject);
+}
+
+// ----------------------------------------------------------------------- //
+//
+//	ROUTINE:	Explosion::DamageObjectsInSphere()
+//
+//	PURPOSE:	Damage all the objects touching the sphere
+//
+// ----------------------------------------------------------------------- //
+
+void Explosion::DamageObjectsInSphere(LTFLOAT fRadius, void (Explosion::*pDamageFn)(HOBJECT hObj))
+{
+	// This happens every frame for progressive damage, so use an array
+	// rather than having the engine allocate a list...
+
+	ObjArray<HOBJECT, MAX_EXPLOSION_OBJECTS> objArray;
+	uint32 nTotalFound = 0;
+	g_pLTServer->FindObjectsInSphere(m_vPos, fRadius, objArray, OBJTYPE_MASK_ALL, 0, &nTotalFound);
+
+	if (nTotalFound <= objArray.NumObjects())
+	{
+		for (uint32 i = 0; i < objArray.NumObjects(); i++)
+		{
+			(this->*pDamageFn)(objArray.GetObject(i));
+		}
+		return;
+	}
+
+	// Too many to fit, so get them all in a list...
+
+    ObjectList* pList = g_pLTServer->FindObjectsTouchingSphere(&m_vPos, fRadius);
 	if (!pList) return;
 
 	ObjectLink* pLink = pList->m_pFirstLink;
 	while (pLink)
 	{
-		AreaDamageObject(pLink->m_hObject);
+		(this->*pDamageFn)(pLink->m_hObject);
 		pLink = pLink->m_pNext;
 	}
 
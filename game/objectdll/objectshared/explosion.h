@@ -62,6 +62,7 @@ class Explosion : public GameBase
 		void AreaDamageObject(HOBJECT hObj);
 		void ProgDamageObjectsInSphere();
 		void ProgDamageObject(HOBJECT hObj);
+		void DamageObjectsInSphere(LTFLOAT fRadius, void (Explosion::*pDamageFn)(HOBJECT hObj));
 
         void Save(ILTMessage_Write *pMsg, uint32 dwSaveFlags);
         void Load(ILTMessage_Read *pMsg, uint32 dwLoadFlags);
@@ -116,9 +116,10 @@ LTBOOL NoPlayerTrigger::Update()
 	LTVector vMin = vPos - vDims;
 	LTVector vMax = vPos + vDims;
 
-	ObjectList *pObjList = g_pLTServer->GetBoxIntersecters( &vMin, &vMax );
-	if( !pObjList )
-		return LTFALSE;
+	// Players are models, so that's all we need to look at.
+	ObjArray<HOBJECT, MAX_OBJECT_ARRAY_SIZE> objArray;
+	uint32 nTotalFound = 0;
+	g_pLTServer->FindObjectsInBox( vMin, vMax, objArray, OBJTYPE_MASK(OT_MODEL), 0, &nTotalFound );
 
 	// Count the number of players in the trigger and activate only if
 	// NO players in the game are within the trigger...
@@ -128,23 +129,19 @@ LTBOOL NoPlayerTrigger::Update()
     static_cast<void>(nPlayersInGame);
 	bool	bPlayersInTrigger = false;
 
-	ObjectLink *pLink = pObjList->m_pFirstLink;
-	while( pLink )
+	for( uint32 i = 0; i < objArray.NumObjects( ); ++i )
 	{
-		hObj = pLink->m_hObject;
+		hObj = objArray.GetObject( i );
 		
 		if( hObj && IsPlayer( hObj ))
 		{
 			bPlayersInTrigger = true;
 			break;
 		}
-	
-		pLink = pLink->m_pNext;
 	}
-	
-	g_pLTServer->RelinquishList( pObjList );
 
-	if( bPlayersInTrigger )
+	// If there were too many models to check them all, try again next update.
+	if( bPlayersInTrigger || nTotalFound > objArray.NumObjects( ))
 		return LTFALSE;
 
 	SetNextUpdate( UPDATE_NEVER );
@@ -152,6 +152,14 @@ bool PlayerTrigger::InitialUpdate()
 }
 
 
+// Only count live players with loaded clients.
+static bool IsCountedPlayer( HOBJECT hObj )
+{
+	CPlayerObj* pPlayerObj = dynamic_cast< CPlayerObj* >( g_pLTServer->HandleToObject( hObj ));
+	return pPlayerObj && !pPlayerObj->IsDead( ) && pPlayerObj->IsClientLoaded( );
+}
+
+
 // ----------------------------------------------------------------------- //
 //
 //	ROUTINE:	PlayerTrigger::~Activate()
@@ -178,14 +186,14 @@ LTBOOL PlayerTrigger::Activate()
 	LTVector vMin = vPos - vDims;
 	LTVector vMax = vPos + vDims;
 
-	ObjectList *pObjList = g_pLTServer->GetBoxIntersecters( &vMin, &vMax );
-	if( !pObjList )
-		return LTFALSE;
+	// Players are models, so that's all we need to look at.
+	ObjArray<HOBJECT, MAX_OBJECT_ARRAY_SIZE> objArray;
+	uint32 nTotalFound = 0;
+	g_pLTServer->FindObjectsInBox( vMin, vMax, objArray, OBJTYPE_MASK(OT_MODEL), 0, &nTotalFound );
 
 	// Count the number of players in the trigger and activate only if
 	// ALL players in the game are within the trigger...
 
-	HOBJECT hObj;
 	uint32	nPlayersInGame = CPlayerObj::GetNumberPlayersWithClients( );
 
 	// Don't trigger if there are no players in the game.
@@ -194,22 +202,33 @@ LTBOOL PlayerTrigger::Activate()
 
 	uint32	nPlayersInTrigger = 0;
 
-	ObjectLink *pLink = pObjList->m_pFirstLink;
-	while( pLink )
+	if( nTotalFound <= objArray.NumObjects( ))
+	{
+		for( uint32 i = 0; i < objArray.NumObjects( ); ++i )
+		{
+			if( IsCountedPlayer( objArray.GetObject( i )))
+				++nPlayersInTrigger;
+		}
+	}
+	else
 	{
-		hObj = pLink->m_hObject;
-		CPlayerObj* pPlayerObj = dynamic_cast< CPlayerObj* >( g_pLTServer->HandleToObject( hObj ));
+		// Too many to fit, so get them all in a list...
 
-		// Only count live players with loaded clients.
-		if( pPlayerObj && !pPlayerObj->IsDead( ) && pPlayerObj->IsClientLoaded( ))
+		ObjectList *pObjList = g_pLTServer->GetBoxIntersecters( &vMin, &vMax );
+		if( !pObjList )
+			return LTFALSE;
+
+		ObjectLink *pLink = pObjList->m_pFirstLink;
+		while( pLink )
 		{
-			++nPlayersInTrigger;
+			if( IsCountedPlayer( pLink->m_hObject ))
+				++nPlayersInTrigger;
+
+			pLink = pLink->m_pNext;
 		}
-	
-		pLink = pLink->m_pNext;
+
+		g_pLTServer->RelinquishList( pObjList );
 	}
-	
-	g_pLTServer->RelinquishList( pObjList );
 
 	if( nPlayersInTrigger != nPlayersInGame )
 		return LTFALSE;
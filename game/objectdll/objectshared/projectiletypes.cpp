@@ -677,52 +677,85 @@ void CLipstickProx::UpdateGrenade()
 
         LTVector vPos;
 		g_pLTServer->GetObjectPos(m_hObject, &vPos);
+
+		// Characters are models, so that's all we need to look at.
+		ObjArray<HOBJECT, MAX_OBJECT_ARRAY_SIZE> objArray;
+		uint32 nTotalFound = 0;
+		g_pLTServer->FindObjectsInSphere(vPos, fRadius, objArray, OBJTYPE_MASK(OT_MODEL), 0, &nTotalFound);
+
+		if (nTotalFound <= objArray.NumObjects())
+		{
+			for (uint32 i = 0; i < objArray.NumObjects(); i++)
+			{
+				if (ActivateOnObject(objArray.GetObject(i)))
+					break;
+			}
+			return;
+		}
+
+		// Too many to fit, so get them all in a list...
+
         ObjectList* pList = g_pLTServer->FindObjectsTouchingSphere(&vPos, fRadius);
 		if (!pList) return;
 
 		ObjectLink* pLink = pList->m_pFirstLink;
 		while (pLink)
 		{
-			if( IsMultiplayerGame( ))
-			{
-				if( g_vtNetFriendlyFire.GetFloat() < 1.0f && IsMyTeam( pLink->m_hObject ))
-				{
-					//go to next obj
-					pLink = pLink->m_pNext;
-					continue;
-				}
-			}
+			if (ActivateOnObject(pLink->m_hObject))
+				break;
+
+			pLink = pLink->m_pNext;
+		}
+
+        g_pLTServer->RelinquishList(pList);
+	}
+}
 
-			if (IsCharacter(pLink->m_hObject))
-			{
-                m_bActivated = LTTRUE;
 
-                LTFLOAT fDelay = g_vtProxGrenadeDetonateDelay.GetFloat() < 0.0f ?
-					m_pClassData->fActivateDelay : g_vtProxGrenadeDetonateDelay.GetFloat();
+// ----------------------------------------------------------------------- //
+//
+//	ROUTINE:	CLipstickProx::ActivateOnObject
+//
+//	PURPOSE:	Start the detonation if the object should set us off
+//
+// ----------------------------------------------------------------------- //
 
-				m_DetonateTime.Start(fDelay);
+LTBOOL CLipstickProx::ActivateOnObject(HOBJECT hObj)
+{
+	if( IsMultiplayerGame( ))
+	{
+		if( g_vtNetFriendlyFire.GetFloat() < 1.0f && IsMyTeam( hObj ))
+		{
+			// Teammates don't set it off
+            return LTFALSE;
+		}
+	}
 
-				// Play activation sound...
+	if (!IsCharacter(hObj))
+        return LTFALSE;
 
-				if (m_pClassData->szActivateSound[0])
-				{
-					int nVolume = IsLiquid(m_eContainerCode) ? 50 : 100;
+    m_bActivated = LTTRUE;
 
-                    LTVector vPos;
-                    g_pLTServer->GetObjectPos(m_hObject, &vPos);
+    LTFLOAT fDelay = g_vtProxGrenadeDetonateDelay.GetFloat() < 0.0f ?
+		m_pClassData->fActivateDelay : g_vtProxGrenadeDetonateDelay.GetFloat();
 
-					g_pServerSoundMgr->PlaySoundFromPos(vPos, m_pClassData->szActivateSound,
-                        (LTFLOAT) m_pClassData->nActivateSndRadius,
-						SOUNDPRIORITY_MISC_MEDIUM, 0, static_cast<uint8>(nVolume));
-				}
+	m_DetonateTime.Start(fDelay);
 
-				break;
-			}
+	// Play activation sound...
 
-			pLink = pLink->m_pNext;
-		}
-        g_pLTServer->RelinquishList(pList);
+	if (m_pClassData->szActivateSound[0])
+	{
+		int nVolume = IsLiquid(m_eContainerCode) ? 50 : 100;
+
+        LTVector vPos;
+        g_pLTServer->GetObjectPos(m_hObject, &vPos);
+
+		g_pServerSoundMgr->PlaySoundFromPos(vPos, m_pClassData->szActivateSound,
+            (LTFLOAT) m_pClassData->nActivateSndRadius,
+			SOUNDPRIORITY_MISC_MEDIUM, 0, static_cast<uint8>(nVolume));
 	}
+
+    return LTTRUE;
 }
 
 
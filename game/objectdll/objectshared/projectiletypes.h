@@ -97,6 +97,8 @@ class CLipstickProx : public CGrenade
         virtual void Save(ILTMessage_Write *pMsg, uint32 dwSaveFlags);
         virtual void Load(ILTMessage_Read *pMsg, uint32 dwLoadFlags);
 
+        LTBOOL ActivateOnObject(HOBJECT hObj);
+
         LTVector m_vSurfaceNormal;
         LTBOOL   m_bArmed;
         LTBOOL   m_bActivated;
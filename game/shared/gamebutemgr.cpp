@@ -71,6 +71,61 @@ void GBM_DisplayError(const char* szMsg)
 #endif
 }
 
+// ----------------------------------------------------------------------- //
+//
+//	ROUTINE:	GBM_SetupCache()
+//
+//	PURPOSE:	Point the bute mgr at its binary cache file, if the
+//				"ButeCacheDir" console variable names a cache directory.
+//
+// ----------------------------------------------------------------------- //
+
+static void GBM_SetupCache(CButeMgr & buteMgr, const char* sButeFile)
+{
+	const char* szCacheDir = LTNULL;
+
+#ifdef _CLIENTBUILD
+	if (g_pLTClient)
+	{
+		HCONSOLEVAR hVar = g_pLTClient->GetConsoleVar("ButeCacheDir");
+		if (hVar)
+		{
+			szCacheDir = g_pLTClient->GetVarValueString(hVar);
+		}
+	}
+#else
+	if (g_pLTServer)
+	{
+		HCONVAR hVar = g_pLTServer->GetGameConVar("ButeCacheDir");
+		if (hVar)
+		{
+			szCacheDir = g_pLTServer->GetVarValueString(hVar);
+		}
+	}
+#endif
+
+	if (!szCacheDir || !szCacheDir[0])
+	{
+		buteMgr.SetCacheFilename("");
+		return;
+	}
+
+	// One flat file per attribute file, named after its path.
+	char szCacheFile[_MAX_PATH];
+	LTSNPrintF(szCacheFile, sizeof(szCacheFile), "%s\\%s.btc", szCacheDir, sButeFile);
+
+	size_t nNameStart = LTMIN(strlen(szCacheDir) + 1, strlen(szCacheFile));
+	for (char* pCur = &szCacheFile[nNameStart]; *pCur; pCur++)
+	{
+		if (*pCur == '\\' || *pCur == '/' || *pCur == ':')
+		{
+			*pCur = '_';
+		}
+	}
+
+	buteMgr.SetCacheFilename(szCacheFile);
+}
+
 // ----------------------------------------------------------------------- //
 //
 //	ROUTINE:	CGameButeMgr::Parse()
@@ -88,6 +143,8 @@ LTBOOL CGameButeMgr::Parse(const char* sButeFile)
 
 	BOOL bRet = TRUE;
 
+	GBM_SetupCache(m_buteMgr, sButeFile);
+
 
 	//if there is no g_pLTBase, then we can't read from the stream
 	if (!g_pLTBase || !m_bInRezFile)
@@ -10,7 +10,7 @@
 	#define new DEBUG_NEW
 #endif
 
-const int nLineBufferSize = 256;  // Increase this to a large value to buffer the input.
+#include <vector>
 
 /////////////////////////////////////////////////////////////////////
 //
@@ -257,6 +257,115 @@ static TranType TransTable[NumStates][NumClasses] = {
 
 
 
+/////////////////////////////////////////////////////////////////////
+//
+//  Binary cache
+//
+//  Header, string table, then for each tag its name, item count and
+//  items.  Strings are stored once with their terminators and referred
+//  to by index.
+//
+/////////////////////////////////////////////////////////////////////
+
+const DWORD ButeCacheMagic   = 0x43455442;  // "BTEC"
+const DWORD ButeCacheVersion = 1;
+
+struct ButeCacheHeader
+{
+	DWORD m_dwMagic;
+	DWORD m_dwVersion;
+	DWORD m_dwSourceCRC;
+	DWORD m_dwSourceSize;
+	DWORD m_dwDecryptCode;
+	DWORD m_dwChecksum;
+	DWORD m_nStrings;
+	DWORD m_nTags;
+};
+
+// Bounds-checked reads from a cache file held in memory.
+class CButeCacheReader
+{
+public:
+
+	CButeCacheReader(const char* pData, size_t size) { m_pPos = pData; m_pEnd = pData + size; }
+
+	bool Read(void* pDest, size_t size)
+	{
+		if (size > static_cast<size_t>(m_pEnd - m_pPos))
+			return false;
+		memcpy(pDest, m_pPos, size);
+		m_pPos += size;
+		return true;
+	}
+
+	template<typename T>
+	bool Read(T& value) { return Read(&value, sizeof(T)); }
+
+	// Returns a terminated string of nLength characters inside the data.
+	const char* ReadString(DWORD nLength)
+	{
+		if (nLength >= static_cast<size_t>(m_pEnd - m_pPos) || m_pPos[nLength] != '\0')
+			return NULL;
+		const char* pString = m_pPos;
+		m_pPos += nLength + 1;
+		return pString;
+	}
+
+	bool IsEnd() const { return m_pPos == m_pEnd; }
+
+private:
+
+	const char* m_pPos;
+	const char* m_pEnd;
+};
+
+template<typename T>
+static void PutCacheValue(std::string& sCache, const T& value)
+{
+	sCache.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// Maps interned strings to their index in the cache string table.
+typedef std::unordered_map< char const*, DWORD > ButeCacheStringIndices;
+
+static DWORD GetCacheStringIndex(ButeCacheStringIndices& indices, std::vector< char const* >& strings, char const* pszString)
+{
+	std::pair< ButeCacheStringIndices::iterator, bool > pr = indices.insert(
+		ButeCacheStringIndices::value_type(pszString, static_cast<DWORD>(strings.size())));
+
+	if (pr.second)
+		strings.push_back(pszString);
+
+	return (*pr.first).second;
+}
+
+// CRC-32 of the attribute file the cache was built from.
+static DWORD CalcCacheCRC(const char* pData, unsigned long size)
+{
+	static DWORD s_crcTable[256];
+	static bool s_bCrcTableInit = false;
+
+	if (!s_bCrcTableInit)
+	{
+		for (DWORD i = 0; i < 256; i++)
+		{
+			DWORD crc = i;
+			for (int j = 0; j < 8; j++)
+				crc = (crc & 1) ? (0xEDB88320 ^ (crc >> 1)) : (crc >> 1);
+			s_crcTable[i] = crc;
+		}
+		s_bCrcTableInit = true;
+	}
+
+	DWORD crc = 0xFFFFFFFF;
+	for (unsigned long i = 0; i < size; i++)
+		crc = s_crcTable[(crc ^ static_cast<BYTE>(pData[i])) & 0xFF] ^ (crc >> 8);
+
+	return crc ^ 0xFFFFFFFF;
+}
+
+
+
 CButeMgr::CButeMgr()
 {
 	m_decryptCode = 0;
@@ -280,11 +389,15 @@ CButeMgr::CButeMgr()
 
 	m_pCurrTabOfItems = 0;
 
-	m_pData = 0;
+	m_pLastTabOfItems[0] = 0;
+	m_pLastTabOfItems[1] = 0;
+	m_pLastTabOfItems[2] = 0;
+	m_bLastTagValid = false;
+
 	m_pSaveData = 0;
 
-	m_szLineBuffer = 0;
-	m_szLineBufferPtr = 0;
+	m_pBufferPos = 0;
+	m_pBufferEnd = 0;
 
 	m_currentChar = 0;
 	m_token = 0;
@@ -295,6 +408,7 @@ CButeMgr::CButeMgr()
 	m_sTagName.Empty();
 	m_sAttribute.Empty();
 	m_sAttributeFilename.Empty();
+	m_sCacheFilename.Empty();
 
 	m_bPutChar = false;
 	m_bCrypt = false;
@@ -339,10 +453,58 @@ void CButeMgr::Reset()
 	m_sTagName = "";
 	m_sAttribute = "";
 
-	if( m_szLineBuffer )
-		*m_szLineBuffer = 0;
+	m_pBufferPos = 0;
+	m_pBufferEnd = 0;
+}
+
+
+
+bool CButeMgr::ParseBuffer(const char* pData, unsigned long size, int decryptCode)
+{
+	Reset();
+	m_decryptCode = decryptCode;
+
+	// Decrypted data is never written to the cache.
+	bool bUseCache = !m_sCacheFilename.IsEmpty() && !m_bCrypt && m_tagTab.empty();
+	DWORD dwSourceCRC = 0;
+
+	if (bUseCache)
+	{
+		dwSourceCRC = CalcCacheCRC(pData, size);
+		if (LoadCache(dwSourceCRC, size))
+			return true;
+	}
+
+	m_pBufferPos = pData;
+	m_pBufferEnd = pData + size;
 
-	m_szLineBufferPtr = m_szLineBuffer;
+	bool retVal = true;
+	if (!TagList())
+	{
+		m_bErrorFlag = true;
+		retVal = false;
+	}
+
+	m_pBufferPos = NULL;
+	m_pBufferEnd = NULL;
+
+	if (retVal && bUseCache)
+		SaveCache(dwSourceCRC, size);
+
+	return retVal;
+}
+
+
+
+void CButeMgr::ReadStream(std::istream& iStream, std::string& sBuffer)
+{
+	char buf[4096];
+
+	while (iStream.good())
+	{
+		iStream.read(buf, sizeof(buf));
+		sBuffer.append(buf, static_cast<size_t>(iStream.gcount()));
+	}
 }
 
 
@@ -434,61 +596,20 @@ void CButeMgr::Term( )
 
 	m_stringHolder.clear();
 
-	delete[] m_szLineBuffer;
-	m_szLineBuffer = 0;
-	m_szLineBufferPtr = 0;
+	m_bLastTagValid = false;
 }
 
 
 void CButeMgr::ConsumeChar()
 {
-	int c;
-
-	if( !m_szLineBuffer && nLineBufferSize > 0)
-	{
-		m_szLineBuffer = new char[nLineBufferSize];
-		m_szLineBufferPtr = m_szLineBuffer;
-		memset(m_szLineBuffer, 0, nLineBufferSize);
-	}
-
-	if( m_szLineBuffer )
+	// The data ends at the end of the buffer or at a terminator.
+	if (m_pBufferPos >= m_pBufferEnd || !*m_pBufferPos)
 	{
-		// Do we need to refresh our buffer?
-		if( !m_szLineBufferPtr || !*m_szLineBufferPtr || m_szLineBufferPtr >= m_szLineBuffer + nLineBufferSize )
-		{
-			if (m_pData->eof())
-			{
-				m_currentChar = 0;
-				return;
-			}
-
-			m_pData->read(m_szLineBuffer,nLineBufferSize-1);  // don't use getline!
-
-			ASSERT( m_pData->gcount() < nLineBufferSize );
-
-			// terminate the string.
-			m_szLineBuffer[ m_pData->gcount() ] = 0;
-
-			m_szLineBufferPtr = m_szLineBuffer;
-		}
-
-		ASSERT( m_szLineBufferPtr );
-
-		// Grab the next character from our buffer.
-		c = *m_szLineBufferPtr++;
+		m_currentChar = 0;
+		return;
 	}
-	else
-	{
-		// We're not using buffers, just get
-		// one character at a time.
-		c = m_pData->get();
 
-		if (m_pData->eof())
-		{
-			m_currentChar = 0;
-			return;
-		}
-	}
+	int c = *m_pBufferPos++;
 
 	c -= m_decryptCode;
 
@@ -1139,11 +1260,15 @@ bool CButeMgr::Save(
 
     m_pSaveData->flags(m_pSaveData->flags() | std::ios_base::showpoint | std::ios_base::fixed);
 
-    ss.clear();
-    m_pData = &ss;
+    const std::string sSource = ss.str();
+    m_pBufferPos = sSource.data();
+    m_pBufferEnd = m_pBufferPos + sSource.size();
 
     TagList();
 
+    m_pBufferPos = NULL;
+    m_pBufferEnd = NULL;
+
     // add new tag items
     TraverseTableOfTags(m_newTagTab, NewTabsSave, m_pSaveData);
 
@@ -1341,6 +1466,9 @@ CButeMgr::TableOfItems* CButeMgr::CreateTableOfItems( TableOfTags& tableOfTags,
 	// Add the table of items to the table of tags.
 	tableOfTags[pszTagString] = pTableOfItems;
 
+	// The tables of the last tag looked up may have changed.
+	m_bLastTagValid = false;
+
 	// Return the table of items we created.
 	return pTableOfItems;
 }
@@ -1464,28 +1592,25 @@ CButeMgr::CSymTabItem* CButeMgr::FindSymTabItem( char const* pszTagName, char co
 		return NULL;
 	}
 
-	TableOfItems* pTabOfItems;
-
-	pTabOfItems = FindTableOfItems( m_tagTab, pszTagName );
-	if( pTabOfItems )
-	{
-		CSymTabItem* pItem = FindSymTabItem( *pTabOfItems, pszAttName );
-		if (pItem)
-			return pItem;
-	}
-	pTabOfItems = FindTableOfItems( m_auxTagTab, pszTagName );
-	if( pTabOfItems )
+	// Look up the tag in each table of tags unless it was the last tag looked up.
+	if( !m_bLastTagValid || stricmp( m_sLastTagName, pszTagName ) != 0 )
 	{
-		CSymTabItem* pItem = FindSymTabItem( *pTabOfItems, pszAttName );
-		if (pItem)
-			return pItem;
+		m_sLastTagName = pszTagName;
+		m_pLastTabOfItems[0] = FindTableOfItems( m_tagTab, pszTagName );
+		m_pLastTabOfItems[1] = FindTableOfItems( m_auxTagTab, pszTagName );
+		m_pLastTabOfItems[2] = FindTableOfItems( m_newTagTab, pszTagName );
+		m_bLastTagValid = true;
 	}
-	pTabOfItems = FindTableOfItems( m_newTagTab, pszTagName );
-	if( pTabOfItems )
+
+	for( int i = 0; i < 3; i++ )
 	{
-		CSymTabItem* pItem = FindSymTabItem( *pTabOfItems, pszAttName );
-		if (pItem)
-			return pItem;
+		TableOfItems* pTabOfItems = m_pLastTabOfItems[i];
+		if( pTabOfItems )
+		{
+			CSymTabItem* pItem = FindSymTabItem( *pTabOfItems, pszAttName );
+			if (pItem)
+				return pItem;
+		}
 	}
 
 	return NULL;
@@ -2260,3 +2385,323 @@ void CButeMgr::TraverseTableOfTags( TableOfTags& tableOfTags, TraverseTableOfTag
 		iter++;
 	}
 }
+
+
+////////////////////////////////////////////////////////////////////////
+//
+// CButeMgr::LoadCache
+//
+// Return:		bool - true if the tags were loaded from the cache.
+// Argument:	DWORD dwSourceCRC - CRC of the attribute file being parsed.
+// Argument:	unsigned long nSourceSize - Size of the attribute file being parsed.
+//
+// Description:	Loads the main table of tags from the cache file if it was
+//				built from the same attribute file.  Nothing is created
+//				unless the whole cache is valid.
+//
+////////////////////////////////////////////////////////////////////////
+bool CButeMgr::LoadCache( DWORD dwSourceCRC, unsigned long nSourceSize )
+{
+	std::ifstream is( m_sCacheFilename, std::ios_base::binary );
+	if( !is.is_open( ))
+		return false;
+
+	std::string sCache;
+	ReadStream( is, sCache );
+
+	CButeCacheReader reader( sCache.data( ), sCache.size( ));
+
+	ButeCacheHeader header;
+	if( !reader.Read( header ) ||
+		header.m_dwMagic != ButeCacheMagic ||
+		header.m_dwVersion != ButeCacheVersion ||
+		header.m_dwSourceCRC != dwSourceCRC ||
+		header.m_dwSourceSize != nSourceSize ||
+		header.m_dwDecryptCode != m_decryptCode )
+	{
+		return false;
+	}
+
+	// Each string takes at least its length and terminator.
+	if( header.m_nStrings > sCache.size( ) / ( sizeof( DWORD ) + 1 ))
+		return false;
+
+	std::vector< char const* > strings;
+	strings.reserve( header.m_nStrings );
+
+	for( DWORD i = 0; i < header.m_nStrings; i++ )
+	{
+		DWORD nLength;
+		if( !reader.Read( nLength ))
+			return false;
+
+		char const* pszString = reader.ReadString( nLength );
+		if( !pszString )
+			return false;
+
+		strings.push_back( pszString );
+	}
+
+	// The first pass validates the tags, the second creates them.
+	for( int nPass = 0; nPass < 2; nPass++ )
+	{
+		bool bCreate = ( nPass == 1 );
+		CButeCacheReader tagReader = reader;
+
+		if( bCreate )
+			m_tagTab.reserve( header.m_nTags );
+
+		for( DWORD i = 0; i < header.m_nTags; i++ )
+		{
+			DWORD nTagName;
+			DWORD nItems;
+			if( !tagReader.Read( nTagName ) || !tagReader.Read( nItems ) || nTagName >= strings.size( ))
+				return false;
+
+			TableOfItems* pTableOfItems = NULL;
+			if( bCreate )
+			{
+				pTableOfItems = CreateTableOfItems( m_tagTab, strings[nTagName] );
+				if( !pTableOfItems )
+					return false;
+
+				pTableOfItems->reserve( nItems );
+			}
+
+			for( DWORD j = 0; j < nItems; j++ )
+			{
+				DWORD nAttName;
+				BYTE nType;
+				if( !tagReader.Read( nAttName ) || !tagReader.Read( nType ) || nAttName >= strings.size( ))
+					return false;
+
+				CSymTabItem* pItem = NULL;
+				if( pTableOfItems )
+					pItem = CreateSymTabItem( *pTableOfItems, strings[nAttName] );
+
+				switch( nType )
+				{
+					case IntType:
+					{
+						int32 val;
+						if( !tagReader.Read( val ))
+							return false;
+						if( pItem )
+							pItem->Init( *this, IntType, static_cast<int>( val ));
+						break;
+					}
+					case DwordType:
+					{
+						DWORD val;
+						if( !tagReader.Read( val ))
+							return false;
+						if( pItem )
+							pItem->Init( *this, DwordType, val );
+						break;
+					}
+					case ByteType:
+					{
+						BYTE val;
+						if( !tagReader.Read( val ))
+							return false;
+						if( pItem )
+							pItem->Init( *this, ByteType, val );
+						break;
+					}
+					case BoolType:
+					{
+						BYTE val;
+						if( !tagReader.Read( val ))
+							return false;
+						if( pItem )
+							pItem->Init( *this, BoolType, val != 0 );
+						break;
+					}
+					case DoubleType:
+					{
+						double val;
+						if( !tagReader.Read( val ))
+							return false;
+						if( pItem )
+							pItem->Init( *this, DoubleType, val );
+						break;
+					}
+					case FloatType:
+					{
+						float val;
+						if( !tagReader.Read( val ))
+							return false;
+						if( pItem )
+							pItem->Init( *this, FloatType, val );
+						break;
+					}
+					case StringType:
+					{
+						DWORD val;
+						if( !tagReader.Read( val ) || val >= strings.size( ))
+							return false;
+						if( pItem )
+							pItem->Init( *this, StringType, strings[val] );
+						break;
+					}
+					case RectType:
+					{
+						int32 val[4];
+						if( !tagReader.Read( val ))
+							return false;
+						if( pItem )
+							pItem->Init( *this, RectType, CRect( val[0], val[1], val[2], val[3] ));
+						break;
+					}
+					case PointType:
+					{
+						int32 val[2];
+						if( !tagReader.Read( val ))
+							return false;
+						if( pItem )
+							pItem->Init( *this, PointType, CPoint( val[0], val[1] ));
+						break;
+					}
+					case VectorType:
+					{
+						double val[3];
+						if( !tagReader.Read( val ))
+							return false;
+						if( pItem )
+							pItem->Init( *this, VectorType, CAVector( val[0], val[1], val[2] ));
+						break;
+					}
+					case RangeType:
+					{
+						double val[2];
+						if( !tagReader.Read( val ))
+							return false;
+						if( pItem )
+							pItem->Init( *this, RangeType, CARange( val[0], val[1] ));
+						break;
+					}
+					default:
+						return false;
+				}
+			}
+		}
+
+		if( !tagReader.IsEnd( ))
+			return false;
+	}
+
+	m_checksum = header.m_dwChecksum;
+
+	return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////
+//
+// CButeMgr::SaveCache
+//
+// Return:		bool - true if the cache file was written.
+// Argument:	DWORD dwSourceCRC - CRC of the attribute file just parsed.
+// Argument:	unsigned long nSourceSize - Size of the attribute file just parsed.
+//
+// Description:	Writes the main table of tags to the cache file.
+//
+////////////////////////////////////////////////////////////////////////
+bool CButeMgr::SaveCache( DWORD dwSourceCRC, unsigned long nSourceSize )
+{
+	ButeCacheStringIndices stringIndices;
+	std::vector< char const* > strings;
+	std::string sTags;
+
+	for( TableOfTags::iterator tagIter = m_tagTab.begin( ); tagIter != m_tagTab.end( ); tagIter++ )
+	{
+		TableOfItems& tableOfItems = *(*tagIter).second;
+
+		PutCacheValue( sTags, GetCacheStringIndex( stringIndices, strings, (*tagIter).first ));
+		PutCacheValue( sTags, static_cast<DWORD>( tableOfItems.size( )));
+
+		for( TableOfItems::iterator itemIter = tableOfItems.begin( ); itemIter != tableOfItems.end( ); itemIter++ )
+		{
+			CSymTabItem& theItem = *(*itemIter).second;
+
+			PutCacheValue( sTags, GetCacheStringIndex( stringIndices, strings, (*itemIter).first ));
+			PutCacheValue( sTags, static_cast<BYTE>( theItem.SymType ));
+
+			switch( theItem.SymType )
+			{
+				case IntType:
+					PutCacheValue( sTags, static_cast<int32>( theItem.data.i ));
+					break;
+				case DwordType:
+					PutCacheValue( sTags, theItem.data.dw );
+					break;
+				case ByteType:
+					PutCacheValue( sTags, theItem.data.byte );
+					break;
+				case BoolType:
+					PutCacheValue( sTags, static_cast<BYTE>( theItem.data.b ));
+					break;
+				case DoubleType:
+					PutCacheValue( sTags, theItem.data.d );
+					break;
+				case FloatType:
+					PutCacheValue( sTags, theItem.data.f );
+					break;
+				case StringType:
+					PutCacheValue( sTags, GetCacheStringIndex( stringIndices, strings, *theItem.data.s ));
+					break;
+				case RectType:
+					PutCacheValue( sTags, theItem.data.r->left );
+					PutCacheValue( sTags, theItem.data.r->top );
+					PutCacheValue( sTags, theItem.data.r->right );
+					PutCacheValue( sTags, theItem.data.r->bottom );
+					break;
+				case PointType:
+					PutCacheValue( sTags, theItem.data.point->x );
+					PutCacheValue( sTags, theItem.data.point->y );
+					break;
+				case VectorType:
+					PutCacheValue( sTags, theItem.data.v->Geti( ));
+					PutCacheValue( sTags, theItem.data.v->Getj( ));
+					PutCacheValue( sTags, theItem.data.v->Getk( ));
+					break;
+				case RangeType:
+					PutCacheValue( sTags, theItem.data.range->GetMin( ));
+					PutCacheValue( sTags, theItem.data.range->GetMax( ));
+					break;
+				default:
+					return false;
+			}
+		}
+	}
+
+	ButeCacheHeader header;
+	header.m_dwMagic = ButeCacheMagic;
+	header.m_dwVersion = ButeCacheVersion;
+	header.m_dwSourceCRC = dwSourceCRC;
+	header.m_dwSourceSize = nSourceSize;
+	header.m_dwDecryptCode = m_decryptCode;
+	header.m_dwChecksum = m_checksum;
+	header.m_nStrings = static_cast<DWORD>( strings.size( ));
+	header.m_nTags = static_cast<DWORD>( m_tagTab.size( ));
+
+	std::string sCache;
+	PutCacheValue( sCache, header );
+
+	for( size_t i = 0; i < strings.size( ); i++ )
+	{
+		DWORD nLength = static_cast<DWORD>( strlen( strings[i] ));
+		PutCacheValue( sCache, nLength );
+		sCache.append( strings[i], nLength + 1 );
+	}
+
+	sCache += sTags;
+
+	std::ofstream os( m_sCacheFilename, std::ios_base::binary | std::ios_base::trunc );
+	if( !os.is_open( ))
+		return false;
+
+	os.write( sCache.data( ), sCache.size( ));
+
+	return !os.fail( );
+}
@@ -23,6 +23,7 @@
 #include <functional>
 #include <unordered_set>
 #include <unordered_map>
+#include <string>
 #include <iosfwd>
 #include <sstream>
 #include <iostream>
@@ -62,10 +63,14 @@ private:
 
 	size_t		Convert(const char *pKey) const
 	{
+		// Same as toupper in the "C" locale, without the per-character call.
 		uint32 nHash = 0;
 		for (; *pKey; ++pKey)
 		{
-			nHash = 13 * nHash + (toupper(*pKey) - '@');
+			int c = *pKey;
+			if (c >= 'a' && c <= 'z')
+				c -= 'a' - 'A';
+			nHash = 13 * nHash + (c - '@');
 		}
 
 		return nHash;
@@ -200,6 +205,11 @@ public:
 
 	bool Save(const char* szNewFileName = NULL);
 
+	// Binary cache of the parsed tags.  When a cache file is set, parsing an
+	// unencrypted attribute file loads the tags from the cache if it was built
+	// from the same source, otherwise it parses the source and rewrites the cache.
+	void SetCacheFilename(const char* szCacheFilename) { m_sCacheFilename = szCacheFilename; }
+
 	typedef bool (*GetTagsCallback)( const char* pszTagName, void* pContext );
 	void GetTags( GetTagsCallback pCallback, void* pContext = NULL);
 
@@ -264,6 +274,16 @@ private:
 
 	void Reset();
 
+	// Parses an attribute file held in memory.
+	bool ParseBuffer(const char* pData, unsigned long size, int decryptCode);
+
+	// Reads the rest of a stream into a buffer.
+	static void ReadStream(std::istream& iStream, std::string& sBuffer);
+
+	// Binary cache.
+	bool LoadCache(DWORD dwSourceCRC, unsigned long nSourceSize);
+	bool SaveCache(DWORD dwSourceCRC, unsigned long nSourceSize);
+
 	void DisplayMessage(const char* szMsg, ...);
 
 	// Parser stuff
@@ -320,6 +340,12 @@ private:
 	// Current table of items.
 	TableOfItems* m_pCurrTabOfItems;
 
+	// Tables of the last tag looked up by FindSymTabItem.  Attributes are usually
+	// read a tag at a time, so this saves hashing the tag name for each table.
+	CString m_sLastTagName;
+	TableOfItems* m_pLastTabOfItems[3];
+	bool m_bLastTagValid;
+
 
 	// Callback function passed to TraverseTableOfTags.  Returns false to stop iterating.
 	typedef bool (*TraverseTableOfTagsCallback)( char const* pszTagName, TableOfItems& theTableOfItems, void* pContext );
@@ -361,11 +387,11 @@ private:
 	};
 	static bool GetTagsTraverseFunc( char const* pszTagName, TableOfItems& theTableOfItems, void* pContext );
 
-	std::istream* m_pData;
 	std::iostream *m_pSaveData;
 
-	char * m_szLineBuffer;
-	const char * m_szLineBufferPtr;
+	// Attribute data being scanned.
+	const char * m_pBufferPos;
+	const char * m_pBufferEnd;
 
 	unsigned char  m_currentChar;
 	short m_token;
@@ -377,6 +403,7 @@ private:
 	CString m_sAttribute;
 
 	CString m_sAttributeFilename;
+	CString m_sCacheFilename;
 
 	bool m_bPutChar;
 
@@ -420,20 +447,11 @@ private:
 
 inline bool CButeMgr::Parse( std::istream& iStream, int decryptCode)
 {
-	Reset();
-	m_pData = &iStream;
-	m_decryptCode = decryptCode;
-
-	bool retVal = true;
-	if (!TagList())
-	{
-		m_bErrorFlag = true;
-		retVal = false;
-	}
+	// The scanner works on the whole file in memory.
+	std::string sBuffer;
+	ReadStream( iStream, sBuffer );
 
-	m_pData = NULL;
-
-	return retVal;
+	return ParseBuffer( sBuffer.data(), static_cast<unsigned long>(sBuffer.size()), decryptCode );
 }
 
 inline bool CButeMgr::Parse(
@@ -500,13 +518,10 @@ inline bool CButeMgr::Parse(
     if (!pData)
         return false;
 
-    std::string string(static_cast<const char*>(pData), size);
-    std::istringstream iss(string);
-
     // Need to set the attribute filename if we want to Save the butemgr later...
     m_sAttributeFilename = sAttributeFilename;
 
-    bool retVal = Parse(iss, decryptCode);
+    bool retVal = ParseBuffer(static_cast<const char*>(pData), size, decryptCode);
 
     return retVal;
 }
@@ -49,6 +49,9 @@ public:
 	void warn(std::string_view message);
 	void error(std::string_view message);
 
+	// Blocks until every message logged so far is written and flushed by all sinks.
+	virtual void flush() = 0;
+
 	template<typename... TArgs>
 	requires (sizeof...(TArgs) > 0)
 	void info(std::format_string<TArgs...> format, TArgs&&... args)
@@ -99,6 +102,39 @@ using LoggerUPtr = std::unique_ptr<Logger>;
 
 LoggerUPtr make_logger(const char* logger_name, const char* file_path);
 
+// -------------------------------------
+
+// What an asynchronous logger does when its queue is full.
+enum class LoggerOverflowPolicy
+{
+	none = 0,
+	drop, // Discard the message and count it; the count is reported by the writer.
+	block // Wait until the writer frees a slot.
+};
+
+struct AsyncLoggerParam
+{
+	// Number of queued messages (rounded up to a power of two).
+	int queue_capacity{4096};
+	// Maximum interval between flushes of the sinks.
+	int flush_interval_ms{100};
+	LoggerOverflowPolicy overflow_policy{LoggerOverflowPolicy::drop};
+};
+
+// Makes a logger which formats messages on the calling thread and hands them
+// over through a lock-free queue to a background writer thread.
+// Error messages wake the writer and are flushed immediately.
+LoggerUPtr make_async_logger(const char* logger_name, const char* file_path, const AsyncLoggerParam& param);
+
+// Flushes every asynchronous logger alive in the process, whichever module made it.
+// Each wait is bounded, so it may be called from a crash handler.
+void flush_loggers();
+
+// Makes an unhandled exception or std::terminate flush the loggers before the process goes down.
+// The handlers installed before keep running after the flush.
+// Called once by the executable; a module that may be unloaded must not call it.
+void install_crash_logger_flush();
+
 } // namespace ltjs
 
 #endif // LTJS_LOGGER_INCLUDED
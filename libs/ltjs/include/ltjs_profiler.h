@@ -0,0 +1,117 @@
+/*
+LTJS: Source port of LithTech Jupiter System
+Copyright (c) 2021-2026 Boris I. Bendovsky (bibendovsky@hotmail.com) and Contributors
+SPDX-License-Identifier: GPL-2.0
+*/
+
+// Scoped-zone profiler
+
+#ifndef LTJS_PROFILER_INCLUDED
+#define LTJS_PROFILER_INCLUDED
+
+#include <chrono>
+#include <cstdint>
+
+namespace ltjs {
+
+// Profiler time (nanoseconds).
+inline std::int64_t get_profiler_time_ns() noexcept
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// =====================================
+
+// One instance per process, shared by all modules.
+// Each thread records completed zones into its own ring buffer.
+class Profiler
+{
+public:
+	Profiler() = default;
+	virtual ~Profiler() = default;
+
+	// Names the calling thread in the trace.
+	// The name must have static storage duration.
+	virtual void set_thread_name(const char* name) = 0;
+
+	// Records a completed zone of the calling thread.
+	// The name must have static storage duration; its address identifies the zone.
+	virtual void add_zone(const char* name, std::int64_t begin_ns, std::int64_t end_ns) noexcept = 0;
+
+	// Marks the beginning of a new frame.
+	virtual void mark_frame() = 0;
+
+	// Writes zones of all threads for the last frame_count frames as Chrome trace-event JSON.
+	virtual bool dump_chrome_trace(int frame_count, const char* file_path) = 0;
+};
+
+// =====================================
+
+// Creates the process-wide profiler and makes it visible to the other modules.
+// Uses the one already published if there is one.
+// Must be called by the executable before any other module uses the profiler.
+void initialize_profiler();
+
+// Returns the process-wide profiler or null if it was not initialized.
+Profiler* get_profiler() noexcept;
+
+// -------------------------------------
+
+class ProfilerZone
+{
+public:
+	explicit ProfilerZone(const char* name) noexcept
+		:
+		profiler_{get_profiler()},
+		name_{name},
+		begin_ns_{profiler_ != nullptr ? get_profiler_time_ns() : 0}
+	{}
+
+	ProfilerZone(const ProfilerZone&) = delete;
+	ProfilerZone& operator=(const ProfilerZone&) = delete;
+
+	~ProfilerZone()
+	{
+		if (profiler_ != nullptr)
+		{
+			profiler_->add_zone(name_, begin_ns_, get_profiler_time_ns());
+		}
+	}
+
+private:
+	Profiler* profiler_;
+	const char* name_;
+	std::int64_t begin_ns_;
+};
+
+// -------------------------------------
+
+void profiler_set_thread_name(const char* name);
+void profiler_mark_frame();
+
+} // namespace ltjs
+
+// =====================================
+
+#ifdef LTJS_PROFILER
+
+#define LTJS_PROFILER_CONCAT_2(a, b) a##b
+#define LTJS_PROFILER_CONCAT(a, b) LTJS_PROFILER_CONCAT_2(a, b)
+
+// Records the enclosing scope as a zone.
+#define LTJS_PROFILE_ZONE(name) const ::ltjs::ProfilerZone LTJS_PROFILER_CONCAT(ltjs_profiler_zone_, __LINE__){name}
+// Names the calling thread.
+#define LTJS_PROFILE_THREAD(name) ::ltjs::profiler_set_thread_name(name)
+// Marks the beginning of a new frame.
+#define LTJS_PROFILE_FRAME() ::ltjs::profiler_mark_frame()
+
+#else // LTJS_PROFILER
+
+#define LTJS_PROFILE_ZONE(name) static_cast<void>(0)
+#define LTJS_PROFILE_THREAD(name) static_cast<void>(0)
+#define LTJS_PROFILE_FRAME() static_cast<void>(0)
+
+#endif // LTJS_PROFILER
+
+#endif // LTJS_PROFILER_INCLUDED
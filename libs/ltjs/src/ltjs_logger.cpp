@@ -10,7 +10,14 @@ SPDX-License-Identifier: GPL-2.0
 #include "ltjs_sys_time.h"
 #include <cassert>
 #include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
 #include <mutex>
+#include <thread>
 #include "SDL3/SDL.h"
 
 namespace ltjs {
@@ -74,12 +81,60 @@ bool FileLoggerSink::is_open() const noexcept
 
 // =====================================
 
+// Formats a log line: "[date time] [logger name] [type] message\n".
+void format_logger_message(
+	std::string_view logger_name,
+	LoggerMessageType message_type,
+	std::string_view message,
+	std::string& buffer)
+{
+	// Date/Time.
+	const sys::TimeNsOpt time_ns_opt = sys::get_current_time_ns();
+	const sys::DateTimeOpt date_time_opt = sys::time_ns_to_date_time_local(time_ns_opt.value());
+	const sys::DateTime date_time = date_time_opt.value_or(sys::DateTime{});
+	// Message type.
+	char type_char;
+	switch (message_type)
+	{
+		case LoggerMessageType::info:
+			type_char = 'I';
+			break;
+		case LoggerMessageType::warn:
+			type_char = 'W';
+			break;
+		case LoggerMessageType::error:
+			type_char = 'E';
+			break;
+		default:
+			type_char = '?';
+			assert(false && "Unknown message type.");
+			break;
+	}
+	// Format it.
+	std::format_to(std::back_inserter(buffer),
+		"[{:04}-{:02}-{:02} {:02}:{:02}:{:02}.{:03}] [{}] [{}] {}\n",
+		date_time.year,
+		date_time.month,
+		date_time.day,
+		date_time.hour,
+		date_time.minute,
+		date_time.second,
+		date_time.nanosecond / 1'000'000,
+		logger_name,
+		type_char,
+		message);
+}
+
+// =====================================
+
 class LoggerImpl final : public Logger
 {
 public:
 	LoggerImpl(const char* logger_name, const char* file_path);
 	~LoggerImpl() override = default;
 
+	void flush() override;
+
 private:
 	std::mutex mutex_{};
 	std::string logger_name_{};
@@ -101,45 +156,16 @@ LoggerImpl::LoggerImpl(const char* logger_name, const char* file_path)
 	message_buffer_.reserve(1024);
 }
 
+void LoggerImpl::flush()
+{
+	// Messages are flushed as they are logged.
+}
+
 void LoggerImpl::log_message(LoggerMessageType message_type, std::string_view message)
 {
 	std::lock_guard state_sentinel{mutex_};
 	message_buffer_.clear();
-	// Date/Time.
-	const sys::TimeNsOpt time_ns_opt = sys::get_current_time_ns();
-	const sys::DateTimeOpt date_time_opt = sys::time_ns_to_date_time_local(time_ns_opt.value());
-	const sys::DateTime date_time = date_time_opt.value_or(sys::DateTime{});
-	// Message type.
-	char type_char;
-	switch (message_type)
-	{
-		case LoggerMessageType::info:
-			type_char = 'I';
-			break;
-		case LoggerMessageType::warn:
-			type_char = 'W';
-			break;
-		case LoggerMessageType::error:
-			type_char = 'E';
-			break;
-		default:
-			type_char = '?';
-			assert(false && "Unknown message type.");
-			break;
-	}
-	// Format it.
-	std::format_to(std::back_inserter(message_buffer_),
-		"[{:04}-{:02}-{:02} {:02}:{:02}:{:02}.{:03}] [{}] [{}] {}\n",
-		date_time_opt->year,
-		date_time_opt->month,
-		date_time_opt->day,
-		date_time_opt->hour,
-		date_time_opt->minute,
-		date_time_opt->second,
-		date_time_opt->nanosecond / 1'000'000,
-		logger_name_,
-		type_char,
-		message);
+	format_logger_message(logger_name_, message_type, message, message_buffer_);
 	//
 	[[maybe_unused]] const bool console_written = console_sink_->write(message_type, message_buffer_);
 	assert(console_written);
@@ -152,6 +178,341 @@ void LoggerImpl::log_message(LoggerMessageType message_type, std::string_view me
 	assert(file_flushed);
 }
 
+// =====================================
+
+// Asynchronous loggers of every module in the process, so a crash handler in any module can flush them all.
+// The table lives in SDL's global properties and heap because SDL is the one module they all share.
+constexpr int max_registered_loggers = 32;
+constexpr const char* logger_registry_property_name = "ltjs.logger.registry";
+
+struct LoggerRegistry
+{
+	Logger* loggers[max_registered_loggers];
+};
+
+void register_logger(Logger* logger)
+{
+	const SDL_PropertiesID properties = SDL_GetGlobalProperties();
+	if (properties == 0 || !SDL_LockProperties(properties))
+	{
+		return;
+	}
+	auto registry = static_cast<LoggerRegistry*>(SDL_GetPointerProperty(properties, logger_registry_property_name, nullptr));
+	if (registry == nullptr)
+	{
+		registry = static_cast<LoggerRegistry*>(SDL_calloc(1, sizeof(LoggerRegistry)));
+		if (registry != nullptr)
+		{
+			SDL_SetPointerProperty(properties, logger_registry_property_name, registry);
+		}
+	}
+	if (registry != nullptr)
+	{
+		for (Logger*& registered_logger : registry->loggers)
+		{
+			if (registered_logger == nullptr)
+			{
+				registered_logger = logger;
+				break;
+			}
+		}
+	}
+	SDL_UnlockProperties(properties);
+}
+
+void unregister_logger(Logger* logger)
+{
+	const SDL_PropertiesID properties = SDL_GetGlobalProperties();
+	if (properties == 0 || !SDL_LockProperties(properties))
+	{
+		return;
+	}
+	const auto registry = static_cast<LoggerRegistry*>(SDL_GetPointerProperty(properties, logger_registry_property_name, nullptr));
+	if (registry != nullptr)
+	{
+		std::replace(std::begin(registry->loggers), std::end(registry->loggers), logger, static_cast<Logger*>(nullptr));
+	}
+	SDL_UnlockProperties(properties);
+}
+
+// =====================================
+
+class AsyncLoggerImpl final : public Logger
+{
+public:
+	AsyncLoggerImpl(const char* logger_name, const char* file_path, const AsyncLoggerParam& param);
+	~AsyncLoggerImpl() override;
+
+	void flush() override;
+
+private:
+	static constexpr int max_flush_wait_ms = 1000;
+
+	// Bounded multi-producer queue (D. Vyukov).
+	// A slot is free for the producer when its sequence equals the enqueue position,
+	// and ready for the writer when its sequence equals the dequeue position plus one.
+	struct Record
+	{
+		std::atomic<std::size_t> sequence{};
+		LoggerMessageType message_type{};
+		std::string text{};
+	};
+
+	using Records = std::unique_ptr<Record[]>;
+
+	std::string logger_name_{};
+	LoggerSinkUPtr console_sink_{};
+	LoggerSinkUPtr file_sink_{};
+	std::chrono::milliseconds flush_interval_{};
+	LoggerOverflowPolicy overflow_policy_{};
+	std::size_t capacity_{};
+	std::size_t capacity_mask_{};
+	Records records_{};
+	alignas(64) std::atomic<std::size_t> enqueue_position_{};
+	alignas(64) std::atomic<std::size_t> dequeue_position_{};
+	std::atomic<std::uint32_t> dequeue_counter_{};
+	std::atomic<std::uint32_t> dropped_count_{};
+	std::mutex mutex_{};
+	std::condition_variable writer_cv_{};
+	std::condition_variable flushed_cv_{};
+	bool is_wake_requested_{};
+	bool is_stop_requested_{};
+	std::size_t flushed_position_{};
+	std::string batch_buffer_{};
+	std::thread writer_thread_{};
+
+	void log_message(LoggerMessageType message_type, std::string_view message) override;
+	bool try_enqueue(LoggerMessageType message_type, std::string_view text);
+	void wake_writer();
+	// Writes out all ready records as one batch. Returns true if anything was written.
+	bool write_batch();
+	void flush_sinks();
+	void write_dropped_count();
+	void writer_thread_func();
+};
+
+// -------------------------------------
+
+AsyncLoggerImpl::AsyncLoggerImpl(const char* logger_name, const char* file_path, const AsyncLoggerParam& param)
+	:
+	logger_name_{logger_name},
+	console_sink_{make_console_logger_sink()},
+	file_sink_{make_file_logger_sink(file_path)},
+	flush_interval_{std::max(param.flush_interval_ms, 1)},
+	overflow_policy_{param.overflow_policy}
+{
+	assert(param.queue_capacity > 0);
+	assert(overflow_policy_ == LoggerOverflowPolicy::drop || overflow_policy_ == LoggerOverflowPolicy::block);
+	capacity_ = std::bit_ceil(static_cast<std::size_t>(std::max(param.queue_capacity, 2)));
+	capacity_mask_ = capacity_ - 1;
+	records_ = std::make_unique<Record[]>(capacity_);
+	for (std::size_t i = 0; i < capacity_; ++i)
+	{
+		records_[i].sequence.store(i, std::memory_order_relaxed);
+		records_[i].text.reserve(256);
+	}
+	batch_buffer_.reserve(64 * 1024);
+	writer_thread_ = std::thread{&AsyncLoggerImpl::writer_thread_func, this};
+	register_logger(this);
+}
+
+AsyncLoggerImpl::~AsyncLoggerImpl()
+{
+	unregister_logger(this);
+	{
+		std::lock_guard state_sentinel{mutex_};
+		is_stop_requested_ = true;
+	}
+	writer_cv_.notify_one();
+	writer_thread_.join();
+}
+
+void AsyncLoggerImpl::flush()
+{
+	std::unique_lock state_sentinel{mutex_};
+	if (is_stop_requested_)
+	{
+		return;
+	}
+	const std::size_t target_position = enqueue_position_.load(std::memory_order_relaxed);
+	is_wake_requested_ = true;
+	writer_cv_.notify_one();
+	// Bounded wait: a producer which claimed a slot may never publish it (e.g. when called from a crash handler).
+	flushed_cv_.wait_for(
+		state_sentinel,
+		std::chrono::milliseconds{max_flush_wait_ms},
+		[this, target_position]()
+		{
+			return static_cast<std::ptrdiff_t>(flushed_position_ - target_position) >= 0 || is_stop_requested_;
+		});
+}
+
+void AsyncLoggerImpl::log_message(LoggerMessageType message_type, std::string_view message)
+{
+	static thread_local std::string message_buffer{};
+	message_buffer.clear();
+	message_buffer.reserve(1024);
+	format_logger_message(logger_name_, message_type, message, message_buffer);
+	while (!try_enqueue(message_type, message_buffer))
+	{
+		if (overflow_policy_ == LoggerOverflowPolicy::drop)
+		{
+			dropped_count_.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		// Block until the writer releases at least one slot.
+		const std::uint32_t dequeue_counter = dequeue_counter_.load(std::memory_order_acquire);
+		wake_writer();
+		if (!try_enqueue(message_type, message_buffer))
+		{
+			dequeue_counter_.wait(dequeue_counter, std::memory_order_acquire);
+			continue;
+		}
+		break;
+	}
+	if (message_type == LoggerMessageType::error)
+	{
+		wake_writer();
+	}
+}
+
+bool AsyncLoggerImpl::try_enqueue(LoggerMessageType message_type, std::string_view text)
+{
+	std::size_t position = enqueue_position_.load(std::memory_order_relaxed);
+	Record* record;
+	while (true)
+	{
+		record = &records_[position & capacity_mask_];
+		const std::size_t sequence = record->sequence.load(std::memory_order_acquire);
+		const std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence - position);
+		if (difference == 0)
+		{
+			if (enqueue_position_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+			{
+				break;
+			}
+		}
+		else if (difference < 0)
+		{
+			return false;
+		}
+		else
+		{
+			position = enqueue_position_.load(std::memory_order_relaxed);
+		}
+	}
+	record->message_type = message_type;
+	record->text.assign(text);
+	record->sequence.store(position + 1, std::memory_order_release);
+	return true;
+}
+
+void AsyncLoggerImpl::wake_writer()
+{
+	{
+		std::lock_guard state_sentinel{mutex_};
+		is_wake_requested_ = true;
+	}
+	writer_cv_.notify_one();
+}
+
+bool AsyncLoggerImpl::write_batch()
+{
+	batch_buffer_.clear();
+	std::size_t position = dequeue_position_.load(std::memory_order_relaxed);
+	while (true)
+	{
+		Record& record = records_[position & capacity_mask_];
+		if (record.sequence.load(std::memory_order_acquire) != position + 1)
+		{
+			break;
+		}
+		[[maybe_unused]] const bool console_written = console_sink_->write(record.message_type, record.text);
+		assert(console_written);
+		batch_buffer_ += record.text;
+		record.sequence.store(position + capacity_, std::memory_order_release);
+		++position;
+	}
+	if (position == dequeue_position_.load(std::memory_order_relaxed))
+	{
+		return false;
+	}
+	dequeue_position_.store(position, std::memory_order_relaxed);
+	dequeue_counter_.fetch_add(1, std::memory_order_release);
+	if (overflow_policy_ == LoggerOverflowPolicy::block)
+	{
+		dequeue_counter_.notify_all();
+	}
+	[[maybe_unused]] const bool file_written = file_sink_->write(LoggerMessageType::none, batch_buffer_);
+	assert(file_written);
+	return true;
+}
+
+void AsyncLoggerImpl::flush_sinks()
+{
+	[[maybe_unused]] const bool console_flushed = console_sink_->flush();
+	assert(console_flushed);
+	[[maybe_unused]] const bool file_flushed = file_sink_->flush();
+	assert(file_flushed);
+}
+
+void AsyncLoggerImpl::write_dropped_count()
+{
+	const std::uint32_t dropped_count = dropped_count_.exchange(0, std::memory_order_relaxed);
+	if (dropped_count == 0)
+	{
+		return;
+	}
+	batch_buffer_.clear();
+	std::string message{};
+	std::format_to(std::back_inserter(message), "Dropped {} message(s) on queue overflow.", dropped_count);
+	format_logger_message(logger_name_, LoggerMessageType::warn, message, batch_buffer_);
+	[[maybe_unused]] const bool console_written = console_sink_->write(LoggerMessageType::warn, batch_buffer_);
+	assert(console_written);
+	[[maybe_unused]] const bool file_written = file_sink_->write(LoggerMessageType::warn, batch_buffer_);
+	assert(file_written);
+}
+
+void AsyncLoggerImpl::writer_thread_func()
+{
+	bool is_stop_requested = false;
+	while (!is_stop_requested)
+	{
+		{
+			std::unique_lock state_sentinel{mutex_};
+			writer_cv_.wait_for(
+				state_sentinel,
+				flush_interval_,
+				[this]()
+				{
+					return is_wake_requested_ || is_stop_requested_;
+				});
+			is_wake_requested_ = false;
+			is_stop_requested = is_stop_requested_;
+		}
+		// Drain everything on stop; producers must not log concurrently with the destructor.
+		bool is_written = false;
+		while (write_batch())
+		{
+			is_written = true;
+			if (!is_stop_requested)
+			{
+				break;
+			}
+		}
+		write_dropped_count();
+		if (is_written || is_stop_requested)
+		{
+			flush_sinks();
+		}
+		{
+			std::lock_guard state_sentinel{mutex_};
+			flushed_position_ = dequeue_position_.load(std::memory_order_relaxed);
+		}
+		flushed_cv_.notify_all();
+	}
+}
+
 } // namespace
 
 // =====================================
@@ -193,6 +554,33 @@ LoggerUPtr make_logger(const char* logger_name, const char* file_path)
 	return std::make_unique<LoggerImpl>(logger_name, file_path);
 }
 
+LoggerUPtr make_async_logger(const char* logger_name, const char* file_path, const AsyncLoggerParam& param)
+{
+	return std::make_unique<AsyncLoggerImpl>(logger_name, file_path, param);
+}
+
+void flush_loggers()
+{
+	const SDL_PropertiesID properties = SDL_GetGlobalProperties();
+	if (properties == 0 || !SDL_LockProperties(properties))
+	{
+		return;
+	}
+	// Keep the table locked so no logger is destroyed while it is being flushed.
+	const auto registry = static_cast<LoggerRegistry*>(SDL_GetPointerProperty(properties, logger_registry_property_name, nullptr));
+	if (registry != nullptr)
+	{
+		for (Logger* logger : registry->loggers)
+		{
+			if (logger != nullptr)
+			{
+				logger->flush();
+			}
+		}
+	}
+	SDL_UnlockProperties(properties);
+}
+
 // -------------------------------------
 
 LoggerSinkUPtr make_file_logger_sink(const char* file_path)
@@ -10,6 +10,8 @@ SPDX-License-Identifier: GPL-2.0
 
 #include "ltjs_logger.h"
 #include <cassert>
+#include <cstdlib>
+#include <exception>
 #include <string>
 #include <windows.h>
 
@@ -135,6 +137,31 @@ bool LoggerConsoleSink::flush()
 	return !is_failed;
 }
 
+// =====================================
+
+LPTOP_LEVEL_EXCEPTION_FILTER g_previous_exception_filter{};
+std::terminate_handler g_previous_terminate_handler{};
+
+LONG WINAPI flush_loggers_exception_filter(EXCEPTION_POINTERS* exception_pointers)
+{
+	flush_loggers();
+	if (g_previous_exception_filter != nullptr)
+	{
+		return g_previous_exception_filter(exception_pointers);
+	}
+	return EXCEPTION_CONTINUE_SEARCH;
+}
+
+[[noreturn]] void flush_loggers_terminate_handler()
+{
+	flush_loggers();
+	if (g_previous_terminate_handler != nullptr)
+	{
+		g_previous_terminate_handler();
+	}
+	std::abort();
+}
+
 } // namespace
 
 // =====================================
@@ -144,6 +171,12 @@ LoggerSinkUPtr make_console_logger_sink()
 	return std::make_unique<LoggerConsoleSink>();
 }
 
+void install_crash_logger_flush()
+{
+	g_previous_exception_filter = ::SetUnhandledExceptionFilter(flush_loggers_exception_filter);
+	g_previous_terminate_handler = std::set_terminate(flush_loggers_terminate_handler);
+}
+
 } // namespace ltjs
 
 #endif // _WIN32
@@ -0,0 +1,439 @@
+/*
+LTJS: Source port of LithTech Jupiter System
+Copyright (c) 2021-2026 Boris I. Bendovsky (bibendovsky@hotmail.com) and Contributors
+SPDX-License-Identifier: GPL-2.0
+*/
+
+// Scoped-zone profiler
+
+#include "ltjs_profiler.h"
+#include "ltjs_exception.h"
+#include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstdint>
+#include <format>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "SDL3/SDL_iostream.h"
+#include "SDL3/SDL_stdinc.h"
+
+namespace ltjs {
+
+namespace {
+
+class ProfilerImpl final : public Profiler
+{
+public:
+	ProfilerImpl();
+	~ProfilerImpl() override = default;
+
+	void set_thread_name(const char* name) override;
+	void add_zone(const char* name, std::int64_t begin_ns, std::int64_t end_ns) noexcept override;
+	void mark_frame() override;
+	bool dump_chrome_trace(int frame_count, const char* file_path) override;
+
+private:
+	static constexpr std::uint64_t thread_zone_capacity = 1U << 15;
+	static constexpr std::uint64_t frame_capacity = 1U << 10;
+
+	struct Zone
+	{
+		const char* name;
+		std::int64_t begin_ns;
+		std::int64_t end_ns;
+	};
+
+	// A ring slot; read by the dump while the owner may be rewriting it.
+	struct ZoneSlot
+	{
+		std::atomic<const char*> name{};
+		std::atomic<std::int64_t> begin_ns{};
+		std::atomic<std::int64_t> end_ns{};
+	};
+
+	using ZoneSlots = std::unique_ptr<ZoneSlot[]>;
+
+	// Written by the owning thread only.
+	// Zone N is written between write_count becoming N + 1 and zone_count becoming N + 1,
+	// so the dump can tell which of the slots it copied were being overwritten meanwhile.
+	struct ThreadBuffer
+	{
+		int id{};
+		std::atomic<const char*> name{};
+		std::atomic<std::uint64_t> write_count{};
+		std::atomic<std::uint64_t> zone_count{};
+		ZoneSlots zones{};
+	};
+
+	using ThreadBufferUPtr = std::unique_ptr<ThreadBuffer>;
+	using ThreadBuffers = std::vector<ThreadBufferUPtr>;
+	using Frames = std::vector<std::int64_t>;
+
+	static thread_local ThreadBuffer* thread_buffer_;
+
+	std::mutex mutex_{};
+	ThreadBuffers thread_buffers_{};
+	Frames frames_{};
+	std::uint64_t frame_count_{};
+
+	ThreadBuffer& get_thread_buffer();
+	static void append_json_string(std::string_view string, std::string& buffer);
+};
+
+// -------------------------------------
+
+thread_local ProfilerImpl::ThreadBuffer* ProfilerImpl::thread_buffer_{};
+
+ProfilerImpl::ProfilerImpl()
+	:
+	frames_(frame_capacity)
+{
+	thread_buffers_.reserve(32);
+}
+
+void ProfilerImpl::set_thread_name(const char* name)
+{
+	assert(name != nullptr);
+	get_thread_buffer().name.store(name, std::memory_order_relaxed);
+}
+
+void ProfilerImpl::add_zone(const char* name, std::int64_t begin_ns, std::int64_t end_ns) noexcept
+{
+	ThreadBuffer* thread_buffer = thread_buffer_;
+	if (thread_buffer == nullptr)
+	{
+		try
+		{
+			thread_buffer = &get_thread_buffer();
+		}
+		catch (...)
+		{
+			return;
+		}
+	}
+	const std::uint64_t zone_count = thread_buffer->zone_count.load(std::memory_order_relaxed);
+	thread_buffer->write_count.store(zone_count + 1, std::memory_order_relaxed);
+	// Orders the store above before the slot stores for a dump that sees any of them.
+	std::atomic_thread_fence(std::memory_order_release);
+	ZoneSlot& zone_slot = thread_buffer->zones[zone_count & (thread_zone_capacity - 1)];
+	zone_slot.name.store(name, std::memory_order_relaxed);
+	zone_slot.begin_ns.store(begin_ns, std::memory_order_relaxed);
+	zone_slot.end_ns.store(end_ns, std::memory_order_relaxed);
+	thread_buffer->zone_count.store(zone_count + 1, std::memory_order_release);
+}
+
+void ProfilerImpl::mark_frame()
+{
+	const std::int64_t time_ns = get_profiler_time_ns();
+	std::lock_guard state_sentinel{mutex_};
+	frames_[frame_count_ & (frame_capacity - 1)] = time_ns;
+	++frame_count_;
+}
+
+bool ProfilerImpl::dump_chrome_trace(int frame_count, const char* file_path)
+{
+	assert(file_path != nullptr);
+	const std::int64_t end_ns = get_profiler_time_ns();
+	std::vector<ThreadBuffer*> thread_buffers{};
+	Frames frames{};
+	{
+		std::lock_guard state_sentinel{mutex_};
+		thread_buffers.reserve(thread_buffers_.size());
+		for (const ThreadBufferUPtr& thread_buffer : thread_buffers_)
+		{
+			thread_buffers.emplace_back(thread_buffer.get());
+		}
+		const std::uint64_t stored_frame_count = std::min(frame_count_, frame_capacity);
+		const std::uint64_t dump_frame_count = std::min(
+			static_cast<std::uint64_t>(std::max(frame_count, 1)),
+			stored_frame_count);
+		frames.reserve(static_cast<std::size_t>(dump_frame_count));
+		for (std::uint64_t i = frame_count_ - dump_frame_count; i < frame_count_; ++i)
+		{
+			frames.emplace_back(frames_[i & (frame_capacity - 1)]);
+		}
+	}
+	// Copy the rings up to their published zone counts, then drop the slots the owners started
+	// to overwrite meanwhile. Without frame markers dump everything recorded so far.
+	const std::int64_t begin_ns = frames.empty() ? 0 : frames.front();
+	std::int64_t base_ns = frames.empty() ? end_ns : begin_ns;
+	std::vector<std::vector<Zone>> thread_zones(thread_buffers.size());
+	for (std::size_t i = 0; i < thread_buffers.size(); ++i)
+	{
+		const ThreadBuffer& thread_buffer = *thread_buffers[i];
+		std::vector<Zone>& zones = thread_zones[i];
+		const std::uint64_t head_count = thread_buffer.zone_count.load(std::memory_order_acquire);
+		const std::uint64_t first_count = head_count > thread_zone_capacity ? head_count - thread_zone_capacity : 0;
+		zones.reserve(static_cast<std::size_t>(head_count - first_count));
+		for (std::uint64_t j = first_count; j < head_count; ++j)
+		{
+			const ZoneSlot& zone_slot = thread_buffer.zones[j & (thread_zone_capacity - 1)];
+			zones.emplace_back(Zone{
+				zone_slot.name.load(std::memory_order_relaxed),
+				zone_slot.begin_ns.load(std::memory_order_relaxed),
+				zone_slot.end_ns.load(std::memory_order_relaxed)});
+		}
+		// Any slot store seen above makes the write_count store before it visible below.
+		std::atomic_thread_fence(std::memory_order_acquire);
+		const std::uint64_t write_count = thread_buffer.write_count.load(std::memory_order_relaxed);
+		const std::uint64_t valid_count = write_count > thread_zone_capacity ? write_count - thread_zone_capacity : 0;
+		if (valid_count > first_count)
+		{
+			const std::uint64_t overwritten_count = std::min(valid_count, head_count) - first_count;
+			zones.erase(zones.begin(), zones.begin() + static_cast<std::ptrdiff_t>(overwritten_count));
+		}
+		std::erase_if(
+			zones,
+			[begin_ns, end_ns](const Zone& zone)
+			{
+				return zone.end_ns < begin_ns || zone.begin_ns > end_ns;
+			});
+		for (const Zone& zone : zones)
+		{
+			base_ns = std::min(base_ns, zone.begin_ns);
+		}
+	}
+	std::string json{};
+	json.reserve(1024 * 1024);
+	json += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	bool is_first_event = true;
+	const auto begin_event = [&json, &is_first_event]()
+	{
+		if (!is_first_event)
+		{
+			json += ",\n";
+		}
+		is_first_event = false;
+	};
+	for (std::size_t i = 0; i < thread_buffers.size(); ++i)
+	{
+		const std::vector<Zone>& zones = thread_zones[i];
+		if (zones.empty())
+		{
+			continue;
+		}
+		const ThreadBuffer& thread_buffer = *thread_buffers[i];
+		// Thread name.
+		const char* const thread_name = thread_buffer.name.load(std::memory_order_relaxed);
+		begin_event();
+		std::format_to(
+			std::back_inserter(json),
+			"{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":",
+			thread_buffer.id);
+		if (thread_name != nullptr)
+		{
+			append_json_string(thread_name, json);
+		}
+		else
+		{
+			std::format_to(std::back_inserter(json), "\"Thread {}\"", thread_buffer.id);
+		}
+		json += "}}";
+		// Zones.
+		for (const Zone& zone : zones)
+		{
+			begin_event();
+			json += "{\"name\":";
+			append_json_string(zone.name, json);
+			std::format_to(
+				std::back_inserter(json),
+				",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}",
+				thread_buffer.id,
+				static_cast<double>(zone.begin_ns - base_ns) / 1'000.0,
+				static_cast<double>(zone.end_ns - zone.begin_ns) / 1'000.0);
+		}
+	}
+	// Frame markers.
+	for (const std::int64_t frame_ns : frames)
+	{
+		begin_event();
+		std::format_to(
+			std::back_inserter(json),
+			"{{\"name\":\"Frame\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":0,\"ts\":{:.3f}}}",
+			static_cast<double>(frame_ns - base_ns) / 1'000.0);
+	}
+	json += "\n]}\n";
+	// Write it.
+	SDL_IOStream* const sdl_io_stream = SDL_IOFromFile(file_path, "wb");
+	if (sdl_io_stream == nullptr)
+	{
+		return false;
+	}
+	const bool is_written = SDL_WriteIO(sdl_io_stream, json.data(), json.size()) == json.size();
+	const bool is_closed = SDL_CloseIO(sdl_io_stream);
+	return is_written && is_closed;
+}
+
+ProfilerImpl::ThreadBuffer& ProfilerImpl::get_thread_buffer()
+{
+	if (thread_buffer_ != nullptr)
+	{
+		return *thread_buffer_;
+	}
+	ThreadBufferUPtr thread_buffer = std::make_unique<ThreadBuffer>();
+	thread_buffer->zones = std::make_unique<ZoneSlot[]>(thread_zone_capacity);
+	std::lock_guard state_sentinel{mutex_};
+	thread_buffer->id = static_cast<int>(thread_buffers_.size()) + 1;
+	thread_buffer_ = thread_buffer.get();
+	thread_buffers_.emplace_back(std::move(thread_buffer));
+	return *thread_buffer_;
+}
+
+void ProfilerImpl::append_json_string(std::string_view string, std::string& buffer)
+{
+	buffer += '"';
+	for (const char ch : string)
+	{
+		switch (ch)
+		{
+			case '"':
+				buffer += "\\\"";
+				break;
+			case '\\':
+				buffer += "\\\\";
+				break;
+			default:
+				if (static_cast<unsigned char>(ch) < 0x20)
+				{
+					buffer += ' ';
+				}
+				else
+				{
+					buffer += ch;
+				}
+				break;
+		}
+	}
+	buffer += '"';
+}
+
+// =====================================
+
+constexpr const char* profiler_env_name = "LTJS_PROFILER_5QJXNMBW2RDKVHTA";
+
+using ProfilerUPtr = std::unique_ptr<Profiler>;
+
+// The profiler as seen by this module.
+std::atomic<Profiler*> g_profiler{};
+std::atomic<bool> g_is_profiler_resolved{};
+// Calls made while the profiler was not published yet; the lookup is retried once per this many calls.
+constexpr std::uint32_t profiler_lookup_interval = 256;
+std::atomic<std::uint32_t> g_profiler_lookup_counter{};
+
+[[noreturn]] void fail_profiler(std::string_view message)
+{
+	throw Exception{"LTJS_PROFILER", message};
+}
+
+// Looks up the profiler published by the executable.
+Profiler* find_published_profiler() noexcept
+{
+	const char* const env_value_chars = SDL_getenv(profiler_env_name);
+	if (env_value_chars == nullptr)
+	{
+		return nullptr;
+	}
+	const std::string_view env_value_string{env_value_chars};
+	std::uintptr_t env_value = 0;
+	const auto [env_value_string_iter, ec] = std::from_chars(
+		env_value_string.data(),
+		env_value_string.data() + env_value_string.size(),
+		env_value,
+		16);
+	if (ec != std::errc{})
+	{
+		return nullptr;
+	}
+	return reinterpret_cast<Profiler*>(env_value);
+}
+
+} // namespace
+
+// =====================================
+
+void initialize_profiler()
+{
+	static ProfilerUPtr profiler{};
+	if (profiler != nullptr)
+	{
+		return;
+	}
+	// Another module of the process got there first.
+	Profiler* const published_profiler = find_published_profiler();
+	if (published_profiler != nullptr)
+	{
+		g_profiler.store(published_profiler, std::memory_order_release);
+		g_is_profiler_resolved.store(true, std::memory_order_release);
+		return;
+	}
+	profiler = std::make_unique<ProfilerImpl>();
+	const std::uintptr_t profiler_as_integer = reinterpret_cast<std::uintptr_t>(profiler.get());
+	constexpr int char_buffer_size = 32;
+	char chars_buffer[char_buffer_size];
+	const auto [char_buffer_end, ec] = std::to_chars(
+		std::begin(chars_buffer),
+		std::end(chars_buffer) - 1,
+		profiler_as_integer,
+		16);
+	if (ec != std::errc{})
+	{
+		fail_profiler("Failed to format env value.");
+	}
+	*char_buffer_end = '\0';
+	const int sdl_result = SDL_setenv_unsafe(profiler_env_name, chars_buffer, true);
+	if (sdl_result != 0)
+	{
+		fail_profiler("Failed to set env value.");
+	}
+	g_profiler.store(profiler.get(), std::memory_order_release);
+	g_is_profiler_resolved.store(true, std::memory_order_release);
+}
+
+Profiler* get_profiler() noexcept
+{
+	if (!g_is_profiler_resolved.load(std::memory_order_acquire))
+	{
+		// Modules loaded after initialization pick up the executable's instance on first use.
+		// Until the executable publishes it, keep looking now and then rather than on every zone.
+		if (g_profiler_lookup_counter.fetch_add(1, std::memory_order_relaxed) % profiler_lookup_interval != 0)
+		{
+			return nullptr;
+		}
+		Profiler* const profiler = find_published_profiler();
+		if (profiler == nullptr)
+		{
+			return nullptr;
+		}
+		g_profiler.store(profiler, std::memory_order_release);
+		g_is_profiler_resolved.store(true, std::memory_order_release);
+	}
+	return g_profiler.load(std::memory_order_acquire);
+}
+
+// -------------------------------------
+
+void profiler_set_thread_name(const char* name)
+{
+	Profiler* const profiler = get_profiler();
+	if (profiler != nullptr)
+	{
+		profiler->set_thread_name(name);
+	}
+}
+
+void profiler_mark_frame()
+{
+	Profiler* const profiler = get_profiler();
+	if (profiler != nullptr)
+	{
+		profiler->mark_frame();
+	}
+}
+
+} // namespace ltjs
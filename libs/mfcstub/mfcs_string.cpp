@@ -47,7 +47,8 @@ void CString::FormatV(LPCTSTR pFormat, va_list args)
 	if (!pFormat)
 		return;
 
-	va_list argListSave = args;
+	va_list argListSave;
+	va_copy(argListSave, args);
 
 	// make a guess at the maximum length of the resulting string
 	int nMaxLen = 0;
@@ -135,7 +136,7 @@ void CString::FormatV(LPCTSTR pFormat, va_list args)
 			case 'c':
 			case 'C':
 				nItemLen = 2;
-				va_arg(args, char);
+				va_arg(args, int);
 				break;
 
 			case 's':
@@ -0,0 +1,210 @@
+// CButeMgr benchmark.  Times parsing attribute files from their text, loading
+// them from the binary cache, and looking up every key in them.
+//
+//   butemgr_bench [attribute file]...
+//
+// Without any files it runs on a generated one with 400 tags of 40 keys.
+
+#include "stdafx.h"
+#include "butemgr.h"
+#include "ltjs_test.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#define BENCH_PARSE_RUNS	5
+#define BENCH_LOOKUP_RUNS	20
+
+static const char* s_szCacheFile = "butemgr_bench.btc";
+
+
+struct BenchKey
+{
+	std::string	m_sTag;
+	std::string	m_sKey;
+	CButeMgr::SymTypes m_eType;
+};
+
+struct BenchKeyContext
+{
+	std::vector<BenchKey>* m_pKeys;
+	CButeMgr* m_pButeMgr;
+	const char* m_pszTag;
+};
+
+
+static std::string GenerateSource()
+{
+	std::string sSource;
+	char szLine[128];
+
+	for (int nTag = 0; nTag < 400; nTag++)
+	{
+		snprintf(szLine, sizeof(szLine), "[Tag%d]\n", nTag);
+		sSource += szLine;
+
+		for (int nKey = 0; nKey < 40; nKey++)
+		{
+			switch (nKey % 4)
+			{
+				case 0: snprintf(szLine, sizeof(szLine), "Int%d = %d\n", nKey, nTag * nKey); break;
+				case 1: snprintf(szLine, sizeof(szLine), "Float%d = %d.25f\n", nKey, nKey); break;
+				case 2: snprintf(szLine, sizeof(szLine), "Str%d = \"Value %d %d\"\n", nKey, nTag, nKey); break;
+				case 3: snprintf(szLine, sizeof(szLine), "Vec%d = <%d.0, 1.0, 2.0>\n", nKey, nKey); break;
+			}
+			sSource += szLine;
+		}
+
+		sSource += "\n";
+	}
+
+	return sSource;
+}
+
+static bool GetKeysCB(const char* pszKeyName, CButeMgr::CSymTabItem* pItem, void* pContext)
+{
+	BenchKeyContext* pKeyContext = (BenchKeyContext*)pContext;
+
+	BenchKey key;
+	key.m_sTag = pKeyContext->m_pszTag;
+	key.m_sKey = pszKeyName;
+	key.m_eType = pKeyContext->m_pButeMgr->GetType(pKeyContext->m_pszTag, pszKeyName);
+	pKeyContext->m_pKeys->push_back(key);
+	return true;
+}
+
+static bool GetTagsCB(const char* pszTagName, void* pContext)
+{
+	BenchKeyContext* pKeyContext = (BenchKeyContext*)pContext;
+
+	pKeyContext->m_pszTag = pszTagName;
+	pKeyContext->m_pButeMgr->GetKeys(pszTagName, GetKeysCB, pContext);
+	return true;
+}
+
+// Best time of a few parses, with or without the cache.
+static double TimeParse(const std::string & sSource, bool bCache, CButeMgr* & pKeep)
+{
+	double fBest = 1.0e9;
+
+	for (int i = 0; i < BENCH_PARSE_RUNS; i++)
+	{
+		CButeMgr* pButeMgr = new CButeMgr;
+		pButeMgr->SetCacheFilename(bCache ? s_szCacheFile : "");
+
+		CBenchTimer timer;
+		if (!pButeMgr->Parse((void*)sSource.data(), (unsigned long)sSource.size()))
+		{
+			delete pButeMgr;
+			return -1.0;
+		}
+		fBest = std::min(fBest, timer.GetMS());
+
+		delete pKeep;
+		pKeep = pButeMgr;
+	}
+
+	return fBest;
+}
+
+static void RunBench(const char* pszName, const std::string & sSource)
+{
+	CButeMgr* pButeMgr = NULL;
+
+	remove(s_szCacheFile);
+
+	double fText = TimeParse(sSource, false, pButeMgr);
+	if (fText < 0.0)
+	{
+		printf("%s: parse failed\n", pszName);
+		delete pButeMgr;
+		return;
+	}
+
+	// The first parse with a cache file set writes the cache, the rest load it.
+	CBenchTimer timer;
+	{
+		CButeMgr buteMgr;
+		buteMgr.SetCacheFilename(s_szCacheFile);
+		buteMgr.Parse((void*)sSource.data(), (unsigned long)sSource.size());
+	}
+	double fSave = timer.GetMS();
+	double fCached = TimeParse(sSource, true, pButeMgr);
+
+	std::vector<BenchKey> keys;
+	BenchKeyContext context;
+	context.m_pKeys = &keys;
+	context.m_pButeMgr = pButeMgr;
+	context.m_pszTag = NULL;
+	pButeMgr->GetTags(GetTagsCB, &context);
+
+	// Look up every key by its type, as the game's attribute managers do.
+	char szBuffer[256];
+	double fSum = 0.0;
+
+	timer.Start();
+	for (int nRun = 0; nRun < BENCH_LOOKUP_RUNS; nRun++)
+	{
+		for (size_t i = 0; i < keys.size(); i++)
+		{
+			const char* pszTag = keys[i].m_sTag.c_str();
+			const char* pszKey = keys[i].m_sKey.c_str();
+
+			switch (keys[i].m_eType)
+			{
+				case CButeMgr::IntType:		fSum += pButeMgr->GetInt(pszTag, pszKey); break;
+				case CButeMgr::FloatType:	fSum += pButeMgr->GetFloat(pszTag, pszKey); break;
+				case CButeMgr::DoubleType:	fSum += pButeMgr->GetDouble(pszTag, pszKey); break;
+				case CButeMgr::VectorType:	fSum += pButeMgr->GetVector(pszTag, pszKey).Geti(); break;
+				case CButeMgr::StringType:
+					pButeMgr->GetString(pszTag, pszKey, szBuffer, sizeof(szBuffer));
+					fSum += szBuffer[0];
+					break;
+				default:
+					fSum += pButeMgr->Exist(pszTag, pszKey) ? 1.0 : 0.0;
+					break;
+			}
+		}
+	}
+	double fLookup = timer.GetMS();
+	size_t nLookups = keys.size() * BENCH_LOOKUP_RUNS;
+
+	printf("%s: %u bytes, %u keys\n", pszName, (unsigned)sSource.size(), (unsigned)keys.size());
+	printf("  text parse     %8.3f ms\n", fText);
+	printf("  parse + save   %8.3f ms\n", fSave);
+	printf("  cached load    %8.3f ms\n", fCached);
+	printf("  lookups        %8.3f ms (%.1f ns each, sum %g)\n", fLookup,
+		nLookups ? fLookup * 1.0e6 / nLookups : 0.0, fSum);
+
+	delete pButeMgr;
+	remove(s_szCacheFile);
+}
+
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		RunBench("generated", GenerateSource());
+		return 0;
+	}
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::ifstream file(argv[i], std::ios::binary);
+		if (!file)
+		{
+			printf("%s: can't open\n", argv[i]);
+			continue;
+		}
+
+		std::string sSource((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		RunBench(argv[i], sSource);
+	}
+
+	return 0;
+}
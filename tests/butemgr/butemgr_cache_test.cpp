@@ -0,0 +1,119 @@
+// CButeMgr binary cache: every value type reads back the same from the cache
+// as from the text, and a changed source file rebuilds the cache.
+
+#include "stdafx.h"
+#include "butemgr.h"
+#include "ltjs_test.h"
+
+#include <stdio.h>
+#include <string>
+
+static const char* s_szCacheFile = "butemgr_cache_test.btc";
+
+static const char* s_szSource =
+	"// comment\n"
+	"[Weapon0]\n"
+	"Name = \"Pistol\"\n"
+	"Ammo = 12\n"
+	"Speed = 1.5f\n"
+	"Dmg = (DWORD)7\n"
+	"On = TRUE\n"
+	"R = (1, 2, 3, 4)\n"
+	"V = <1.0, 2.0, 3.0>\n"
+	"Rg = [0.5, 2.5]\n"
+	"\n"
+	"[Weapon1]\n"
+	"Name = \"Rifle\"\n"
+	"Ammo = -30\n";
+
+
+static bool ParseSource(CButeMgr & buteMgr, const std::string & sSource)
+{
+	buteMgr.SetCacheFilename(s_szCacheFile);
+	return buteMgr.Parse((void*)sSource.data(), (unsigned long)sSource.size());
+}
+
+static bool CacheExists()
+{
+	FILE* pFile = fopen(s_szCacheFile, "rb");
+	if (pFile)
+		fclose(pFile);
+	return pFile != NULL;
+}
+
+static void CheckValues(CButeMgr & buteMgr, int nAmmo)
+{
+	LTJS_CHECK(strcmp(buteMgr.GetString("Weapon0", "Name"), "Pistol") == 0);
+	LTJS_CHECK(buteMgr.GetInt("Weapon0", "Ammo") == nAmmo);
+	LTJS_CHECK(buteMgr.GetInt("weapon0", "ammo") == nAmmo);
+	LTJS_CHECK_NEAR(buteMgr.GetFloat("Weapon0", "Speed"), 1.5, 0.0);
+	LTJS_CHECK(buteMgr.GetDword("Weapon0", "Dmg") == 7);
+	LTJS_CHECK(buteMgr.GetBool("Weapon0", "On"));
+
+	CRect & rect = buteMgr.GetRect("Weapon0", "R");
+	LTJS_CHECK(rect.left == 1 && rect.top == 2 && rect.right == 3 && rect.bottom == 4);
+
+	CAVector & vec = buteMgr.GetVector("Weapon0", "V");
+	LTJS_CHECK_NEAR(vec.Geti(), 1.0, 0.0);
+	LTJS_CHECK_NEAR(vec.Getj(), 2.0, 0.0);
+	LTJS_CHECK_NEAR(vec.Getk(), 3.0, 0.0);
+
+	CARange & range = buteMgr.GetRange("Weapon0", "Rg");
+	LTJS_CHECK_NEAR(range.GetMin(), 0.5, 0.0);
+	LTJS_CHECK_NEAR(range.GetMax(), 2.5, 0.0);
+
+	LTJS_CHECK(strcmp(buteMgr.GetString("Weapon1", "Name"), "Rifle") == 0);
+	LTJS_CHECK(buteMgr.GetInt("Weapon1", "Ammo") == -30);
+
+	LTJS_CHECK(buteMgr.Exist("Weapon1"));
+	LTJS_CHECK(!buteMgr.Exist("Weapon2"));
+	LTJS_CHECK(buteMgr.GetType("Weapon0", "Missing") == CButeMgr::NullType);
+}
+
+
+int main()
+{
+	std::string sSource = s_szSource;
+
+	remove(s_szCacheFile);
+
+	// Parsed from the text, which writes the cache.
+	DWORD dwChecksum = 0;
+	{
+		CButeMgr buteMgr;
+		LTJS_CHECK(ParseSource(buteMgr, sSource));
+		CheckValues(buteMgr, 12);
+		dwChecksum = buteMgr.GetChecksum();
+	}
+
+	LTJS_CHECK(CacheExists());
+
+	// Loaded from the cache.
+	{
+		CButeMgr buteMgr;
+		LTJS_CHECK(ParseSource(buteMgr, sSource));
+		CheckValues(buteMgr, 12);
+		LTJS_CHECK(buteMgr.GetChecksum() == dwChecksum);
+
+		// Tags loaded from the cache still take new values.
+		buteMgr.SetInt("Weapon1", "New", 5);
+		LTJS_CHECK(buteMgr.GetInt("Weapon1", "New") == 5);
+	}
+
+	// A changed source doesn't match the cache any more.
+	sSource.replace(sSource.find("Ammo = 12"), 9, "Ammo = 13");
+	{
+		CButeMgr buteMgr;
+		LTJS_CHECK(ParseSource(buteMgr, sSource));
+		CheckValues(buteMgr, 13);
+	}
+	{
+		CButeMgr buteMgr;
+		LTJS_CHECK(ParseSource(buteMgr, sSource));
+		CheckValues(buteMgr, 13);
+	}
+
+	remove(s_szCacheFile);
+
+	return LTJS_TEST_RESULT();
+}
@@ -0,0 +1,113 @@
+// Anim trackers: trk_PassesStringKey says an update goes past a string key
+// whenever trk_Update with the same time fires one, through looping and
+// one-shot animations, rate changes, seeks and transitions, and only rarely
+// says so when none fires.
+
+#include "bdefs.h"
+#include "model.h"
+#include "animtracker.h"
+#include "ltjs_test.h"
+
+#include <stdlib.h>
+#include <vector>
+
+
+// Referenced by model.cpp.
+int32 g_CV_DebugModelRez = 0;
+void dsi_PrintToConsole(const char *pMsg, ...) {}
+
+
+static uint32 g_nKeysFired;
+
+static void CountStringKey(LTAnimTracker *pTracker, AnimKeyFrame *pFrame)
+{
+	g_nKeysFired++;
+}
+
+
+// Keys every 50ms, with a string on every nEvery'th one.
+static ModelAnim* MakeAnim(Model *pModel, uint32 nKeys, uint32 nEvery, uint32 nInterpolationMS)
+{
+	ModelAnim *pAnim = new ModelAnim(pModel);
+	std::vector<uint32> commandKeys;
+
+	pAnim->m_KeyFrames.SetSize(nKeys);
+	for (uint32 i = 0; i < nKeys; i++)
+	{
+		bool bCommand = nEvery && ((i % nEvery) == 3);
+
+		pAnim->m_KeyFrames[i].m_Time = i * 50;
+		pAnim->m_KeyFrames[i].m_pString = bCommand ? "fire" : "";
+		if (bCommand)
+			commandKeys.push_back(i);
+	}
+
+	pAnim->m_CommandKeys.SetSize((uint32)commandKeys.size());
+	for (uint32 i = 0; i < commandKeys.size(); i++)
+		pAnim->m_CommandKeys[i] = commandKeys[i];
+
+	pAnim->m_InterpolationMS = nInterpolationMS;
+	return pAnim;
+}
+
+
+static void CheckPassesStringKey()
+{
+	// The anims are left to the process, the model doesn't own them
+	Model *pModel = new Model;
+	pModel->m_Anims.SetSize(4);
+	pModel->m_Anims[0].m_pAnim = MakeAnim(pModel, 40, 7, 0);
+	pModel->m_Anims[1].m_pAnim = MakeAnim(pModel, 40, 7, 200);
+	pModel->m_Anims[2].m_pAnim = MakeAnim(pModel, 1, 0, 0);
+	pModel->m_Anims[3].m_pAnim = MakeAnim(pModel, 300, 100, 100);
+
+	uint32 nUpdates = 0, nFired = 0, nMissed = 0, nFalse = 0;
+
+	srand(1);
+	for (uint32 nRun = 0; nRun < 1000; nRun++)
+	{
+		LTAnimTracker tracker;
+		trk_Init(&tracker, pModel, rand() % 4);
+		if (rand() & 1)
+			tracker.m_Flags &= ~AT_LOOPING;
+		tracker.m_RateModifier = (rand() & 1) ? 1.0f : 0.3f + (rand() % 100) * 0.03f;
+		tracker.m_StringKeyCallback = CountStringKey;
+
+		for (uint32 nFrame = 0; nFrame < 200; nFrame++)
+		{
+			// Start a transition now and then
+			if ((rand() % 50) == 0)
+			{
+				trk_SetCurAnim(&tracker, rand() % 4, true);
+				tracker.m_InterpolationMS = 0;
+			}
+
+			if ((rand() % 80) == 0)
+				trk_SetCurTime(&tracker, rand() % 3000, false);
+
+			// Mostly frame sized steps, some long ones like a model that wasn't updated for a while
+			uint32 nDeltaMS = ((rand() % 10) == 0) ? rand() % 1000 : rand() % 40;
+			bool bPasses = trk_PassesStringKey(&tracker, nDeltaMS);
+
+			g_nKeysFired = 0;
+			trk_Update(&tracker, nDeltaMS);
+
+			nUpdates++;
+			nFired += (g_nKeysFired > 0);
+			nMissed += (g_nKeysFired > 0) && !bPasses;
+			nFalse += (g_nKeysFired == 0) && bPasses;
+		}
+	}
+
+	LTJS_CHECK(nFired > nUpdates / 50);
+	LTJS_CHECK(nMissed == 0);
+	LTJS_CHECK(nFalse < nUpdates / 50);
+}
+
+
+int main()
+{
+	CheckPassesStringKey();
+
+	return LTJS_TEST_RESULT();
+}
@@ -0,0 +1,137 @@
+// Collision mesh hierarchy benchmark.  Times building the LTBVH4 for a bumpy
+// grid, and short sweeps and small box queries against it and against the
+// packed LTAABB_Node tree from the collision data that queries used before.
+//
+//   bvh4_bench [cells]
+
+#include "ltbasedefs.h"
+#include "collision_object.h"
+#include "ltjs_test.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+
+#define BENCH_QUERIES	20000
+#define BENCH_BUILDS	20
+
+// Candidate limit of the old queries
+#define OLD_MAX_TRIS	128
+
+
+static float RandFloat(float fMax)
+{
+	return fMax * (float)rand() / (float)RAND_MAX;
+}
+
+
+static void Report(const char *pName, double fMS, uint32 nOps)
+{
+	printf("  %-28s %10.2f us\n", pName, fMS * 1000.0 / nOps);
+}
+
+
+int main(int argc, char **argv)
+{
+	uint32 nCells = (argc > 1) ? (uint32)atoi(argv[1]) : 100;
+	nCells = LTMIN(nCells, (uint32)180);
+
+	uint32 nRow = nCells + 1;
+	std::vector<LTVector3f> verts(nRow * nRow);
+	for (uint32 y = 0; y < nRow; y++)
+	{
+		for (uint32 x = 0; x < nRow; x++)
+			verts[y * nRow + x] = LTVector3f((float)x, (float)y, RandFloat(1.0f));
+	}
+
+	std::vector<LTTriangle> tris;
+	for (uint32 y = 0; y < nCells; y++)
+	{
+		for (uint32 x = 0; x < nCells; x++)
+		{
+			uint16 i = (uint16)(y * nRow + x);
+			tris.push_back(LTTriangle(i, i + 1, i + nRow + 1));
+			tris.push_back(LTTriangle(i, i + nRow + 1, i + nRow));
+		}
+	}
+
+	LTPhysSurf surf(0, 0.5f, 0.3f, 0.1f, 0, (uint16)(tris.size() - 1));
+	uint32 nSize;
+	LTCollisionData *pData = BuildCollisionData(nSize, &surf, 1, &tris[0], (uint16)tris.size(), &verts[0], (uint16)verts.size());
+	LTCollisionMesh mesh(pData, LTVector3f(0, 0, 0), LTVector3f(0, 0, 0), LTOrientation(), LTOrientation(), false);
+
+	CBenchTimer timer;
+	printf("%u triangles\n", pData->m_TCount);
+
+	// Builds
+	timer.Start();
+	uint32 nNodes = 0;
+	for (uint32 i = 0; i < BENCH_BUILDS; i++)
+	{
+		LTBVH4 bvh;
+		bvh.Build(pData->Triangles(), pData->m_TCount, &verts[0]);
+		nNodes = bvh.NodeCount();
+	}
+	Report("build", timer.GetMS(), BENCH_BUILDS);
+	printf("  %u nodes, depth %u\n", nNodes, mesh.BVH().Depth());
+
+	// Sweeps of a player sized box over a couple of cells
+	std::vector<LTVector3f> p0(BENCH_QUERIES), p1(BENCH_QUERIES);
+	for (uint32 i = 0; i < BENCH_QUERIES; i++)
+	{
+		p0[i] = LTVector3f(RandFloat((float)nCells), RandFloat((float)nCells), 0.5f + RandFloat(1.0f));
+		p1[i] = p0[i] + LTVector3f(RandFloat(4.0f) - 2.0f, RandFloat(4.0f) - 2.0f, RandFloat(1.0f) - 0.5f);
+	}
+
+	const LTVector3f d(0.4f, 0.4f, 0.9f);
+	const LTBVH4 &bvh = mesh.BVH();
+	uint32 nFound = 0, nDropped = 0;
+
+	timer.Start();
+	for (uint32 i = 0; i < BENCH_QUERIES; i++)
+	{
+		LTTriangleIndexList ti;
+		bvh.BoxSweep(ti, p0[i], p1[i], d);
+		nFound += ti.Count();
+		nDropped += (ti.Count() > OLD_MAX_TRIS) ? ti.Count() - OLD_MAX_TRIS : 0;
+	}
+	Report("sweep, bvh4", timer.GetMS(), BENCH_QUERIES);
+
+	timer.Start();
+	for (uint32 i = 0; i < BENCH_QUERIES; i++)
+	{
+		uint16 ti[OLD_MAX_TRIS];
+		uint16 tc = 0;
+		AABBTreeBoxSweep(ti, tc, OLD_MAX_TRIS, pData->m_Min, pData->m_Max, pData->Nodes(), p0[i], p1[i], d);
+		nFound += tc;
+	}
+	Report("sweep, packed tree", timer.GetMS(), BENCH_QUERIES);
+
+	// Boxes around the start of each sweep
+	timer.Start();
+	for (uint32 i = 0; i < BENCH_QUERIES; i++)
+	{
+		LTTriangleIndexList ti;
+		bvh.BoxIntersect(ti, LTAABB(p0[i] - d, p0[i] + d));
+		nFound += ti.Count();
+	}
+	Report("box, bvh4", timer.GetMS(), BENCH_QUERIES);
+
+	timer.Start();
+	for (uint32 i = 0; i < BENCH_QUERIES; i++)
+	{
+		uint16 ti[OLD_MAX_TRIS];
+		uint16 tc = 0;
+		AABBTreeBoxIntersect(ti, tc, OLD_MAX_TRIS, pData->m_Min, pData->m_Max, pData->Nodes(), LTAABB(p0[i] - d, p0[i] + d));
+		nFound += tc;
+	}
+	Report("box, packed tree", timer.GetMS(), BENCH_QUERIES);
+
+	printf("  %u candidates past the old limit\n", nDropped);
+
+	delete [] (uint32*)pData;
+
+	// Keeps the queries from being optimized out
+	return (nFound > 0) ? 0 : 1;
+}
@@ -0,0 +1,209 @@
+// Collision mesh hierarchy: LTBVH4 sweeps and box queries report every
+// triangle whose bounds they touch exactly once, and LTCollisionMesh segment
+// queries find the same hits as testing every triangle, also when more than
+// the old 128 triangles are candidates.
+
+#include "ltbasedefs.h"
+#include "collision_object.h"
+#include "ltjs_test.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+
+static float RandFloat(float fMax)
+{
+	return fMax * (float)rand() / (float)RAND_MAX;
+}
+
+
+static LTVector3f RandPoint(float fMax)
+{
+	return LTVector3f(RandFloat(fMax), RandFloat(fMax), RandFloat(fMax));
+}
+
+
+static LTAABB TriangleBounds(const LTTriangle &t, const LTVector3f V[])
+{
+	LTVector3f vMin = V[t.v[0]], vMax = V[t.v[0]];
+	for (uint32 k = 1; k < 3; k++)
+	{
+		const LTVector3f &v = V[t.v[k]];
+		for (uint32 a = 0; a < 3; a++)
+		{
+			vMin[a] = LTMIN(vMin[a], v[a]);
+			vMax[a] = LTMAX(vMax[a], v[a]);
+		}
+	}
+
+	return LTAABB(vMin, vMax);
+}
+
+
+// Random triangle soups, some flat and some with every triangle the same,
+// queried with random sweeps (including still and axis-aligned ones) and
+// boxes.  Leaves are tested as a whole, so triangles next to a touched one
+// may be reported too.
+static void CheckQueries()
+{
+	uint32 nDuplicates = 0, nMissed = 0, nBoxWrong = 0, nTooManyNodes = 0;
+
+	srand(1);
+	for (uint32 nMesh = 0; nMesh < 200; nMesh++)
+	{
+		uint32 nVerts = 3 + rand() % 600;
+		uint32 nTris = 1 + rand() % 400;
+
+		std::vector<LTVector3f> verts(nVerts);
+		for (uint32 i = 0; i < nVerts; i++)
+		{
+			verts[i] = RandPoint(100.0f);
+			if ((nMesh % 3) == 0)
+				verts[i].z = 0.0f;
+		}
+
+		std::vector<LTTriangle> tris(nTris);
+		for (uint32 i = 0; i < nTris; i++)
+		{
+			uint32 a = rand() % nVerts;
+			tris[i] = LTTriangle(a, (a + 1 + rand() % 5) % nVerts, (a + 2 + rand() % 5) % nVerts);
+			if ((nMesh % 7) == 0)
+				tris[i] = tris[0];
+		}
+
+		std::vector<LTAABB> bounds(nTris);
+		for (uint32 i = 0; i < nTris; i++)
+			bounds[i] = TriangleBounds(tris[i], &verts[0]);
+
+		LTBVH4 bvh;
+		bvh.Build(&tris[0], nTris, &verts[0]);
+		nTooManyNodes += bvh.NodeCount() > nTris;
+
+		for (uint32 nQuery = 0; nQuery < 200; nQuery++)
+		{
+			LTVector3f p0 = RandPoint(100.0f), p1 = RandPoint(100.0f), d = RandPoint(5.0f);
+			if ((nQuery % 5) == 0)
+				p1 = p0;
+			else if ((nQuery % 5) == 1)
+				p1.y = p0.y;
+
+			LTTriangleIndexList sweep;
+			bvh.BoxSweep(sweep, p0, p1, d);
+
+			std::vector<uint32> hits(nTris, 0);
+			for (uint32 i = 0; i < sweep.Count(); i++)
+				hits[sweep[i]]++;
+
+			for (uint32 i = 0; i < nTris; i++)
+			{
+				bool bTouched = AABBSegmentIntersect(bounds[i].Min - d, bounds[i].Max + d, p0, p1);
+				nDuplicates += hits[i] > 1;
+				nMissed += bTouched && !hits[i];
+			}
+
+			LTAABB box(p0 - d * 4.0f, p0 + d * 4.0f);
+			LTTriangleIndexList inBox;
+			bvh.BoxIntersect(inBox, box);
+
+			std::fill(hits.begin(), hits.end(), 0);
+			for (uint32 i = 0; i < inBox.Count(); i++)
+				hits[inBox[i]]++;
+
+			for (uint32 i = 0; i < nTris; i++)
+				nBoxWrong += (bounds[i].Intersects(box) && !hits[i]) || hits[i] > 1;
+		}
+	}
+
+	LTJS_CHECK(nDuplicates == 0);
+	LTJS_CHECK(nMissed == 0);
+	LTJS_CHECK(nBoxWrong == 0);
+	LTJS_CHECK(nTooManyNodes == 0);
+}
+
+
+// A bumpy grid built into collision data, so the vertices are packed the
+// way they are in the world files.
+static LTCollisionData* BuildGrid(uint32 nCells)
+{
+	uint32 nRow = nCells + 1;
+	std::vector<LTVector3f> verts(nRow * nRow);
+	for (uint32 y = 0; y < nRow; y++)
+	{
+		for (uint32 x = 0; x < nRow; x++)
+			verts[y * nRow + x] = LTVector3f((float)x, (float)y, RandFloat(1.0f));
+	}
+
+	std::vector<LTTriangle> tris;
+	for (uint32 y = 0; y < nCells; y++)
+	{
+		for (uint32 x = 0; x < nCells; x++)
+		{
+			uint16 i = (uint16)(y * nRow + x);
+			tris.push_back(LTTriangle(i, i + 1, i + nRow + 1));
+			tris.push_back(LTTriangle(i, i + nRow + 1, i + nRow));
+		}
+	}
+
+	LTPhysSurf surf(0, 0.5f, 0.3f, 0.1f, 0, (uint16)(tris.size() - 1));
+
+	uint32 nSize;
+	return BuildCollisionData(nSize, &surf, 1, &tris[0], (uint16)tris.size(), &verts[0], (uint16)verts.size());
+}
+
+
+// Segments skimming a bumpy grid, so their path touches the bounds of many
+// more triangles than they hit.  The mesh has to find every crossing that
+// testing each triangle finds.
+static void CheckMeshSegments()
+{
+	const uint32 nCells = 100;
+	LTCollisionData *pData = BuildGrid(nCells);
+	LTCollisionMesh mesh(pData, LTVector3f(0, 0, 0), LTVector3f(0, 0, 0), LTOrientation(), LTOrientation(), false);
+
+	const LTTriangle *pTris = pData->Triangles();
+	const LTVector3f e = pData->m_Max - pData->m_Min;
+	const float s = 1 / float(0xFFFF);
+	std::vector<LTVector3f> verts(pData->m_VCount);
+	for (uint32 i = 0; i < pData->m_VCount; i++)
+		verts[i] = UnpackVector(pData->Vertices()[i], pData->m_Min, e, s);
+
+	std::vector<LTIntersectInfo> hits(pData->m_TCount);
+	uint32 nWrong = 0, nMostCandidates = 0;
+
+	for (uint32 nQuery = 0; nQuery < 100; nQuery++)
+	{
+		LTVector3f p0(RandFloat((float)nCells), RandFloat((float)nCells), 0.2f + RandFloat(0.6f));
+		LTVector3f p1(RandFloat((float)nCells), RandFloat((float)nCells), 0.2f + RandFloat(0.6f));
+
+		uint32 nExpected = 0;
+		for (uint32 i = 0; i < pData->m_TCount; i++)
+		{
+			const LTTriangle &t = pTris[i];
+			LTVector3f vHit;
+			nExpected += TriangleSegmentIntersection(vHit, verts[t.v[0]], verts[t.v[1]], verts[t.v[2]], p0, p1);
+		}
+
+		int32 nFound = 0;
+		mesh.IntersectSegment(&hits[0], nFound, (int32)hits.size(), p0, p1, LTIntersectInfo::EmptyFilter());
+		nWrong += (uint32)nFound != nExpected;
+
+		LTTriangleIndexList candidates;
+		mesh.BVH().BoxSweep(candidates, p0, p1, LTVector3f(0, 0, 0));
+		nMostCandidates = LTMAX(nMostCandidates, candidates.Count());
+	}
+
+	LTJS_CHECK(nWrong == 0);
+	LTJS_CHECK(nMostCandidates > 128);
+
+	delete [] (uint32*)pData;
+}
+
+
+int main()
+{
+	CheckQueries();
+	CheckMeshSegments();
+
+	return LTJS_TEST_RESULT();
+}
@@ -0,0 +1,121 @@
+// CCompress benchmark.  Times encoding and decoding vectors, world positions
+// and rotations one at a time and with the array versions.
+//
+//   compress_bench [count]
+
+#include "bdefs.h"
+#include "compress.h"
+#include "compress_data.h"
+#include "ltjs_test.h"
+
+#include <stdlib.h>
+
+static ICompress* g_pCompress;
+define_holder(ICompress, g_pCompress);
+
+#define BENCH_RUNS	10
+
+
+static void Report(const char* pszName, double fSingleMS, double fArrayMS, uint32 nCount)
+{
+	printf("  %-22s %8.2f ns single  %8.2f ns array  (%.2fx)\n", pszName,
+		fSingleMS * 1.0e6 / nCount, fArrayMS * 1.0e6 / nCount, fArrayMS > 0.0 ? fSingleMS / fArrayMS : 0.0);
+}
+
+
+int main(int argc, char** argv)
+{
+	uint32 nCount = (argc > 1) ? (uint32)atoi(argv[1]) : 100000;
+	if (!g_pCompress || !nCount)
+		return 1;
+
+	std::vector<LTVector> aVecs;
+	std::vector<LTRotation> aRots;
+	GenerateCompressData(nCount, aVecs, aRots);
+
+	LTVector vMin(-1100.0f, -1050.0f, -1200.0f);
+	LTVector vMax(1000.0f, 1200.0f, 1100.0f);
+	LTVector vInvDiff(1.0f / (vMax.x - vMin.x), 1.0f / (vMax.y - vMin.y), 1.0f / (vMax.z - vMin.z));
+
+	std::vector<CompVector> aCompVecs(nCount);
+	std::vector<CompWorldPos> aCompPos(nCount);
+	std::vector<CompRot> aCompRots(nCount);
+	std::vector<LTVector> aOutVecs(nCount);
+	std::vector<LTRotation> aOutRots(nCount);
+
+	double fSingle, fArray;
+	CBenchTimer timer;
+	uint32 nTotal = nCount * BENCH_RUNS;
+
+	printf("%u values, %u runs\n", nCount, BENCH_RUNS);
+
+	timer.Start();
+	for (uint32 nRun = 0; nRun < BENCH_RUNS; ++nRun)
+		for (uint32 i = 0; i < nCount; ++i)
+			g_pCompress->EncodeCompressVector(&aCompVecs[i], &aVecs[i]);
+	fSingle = timer.GetMS();
+	timer.Start();
+	for (uint32 nRun = 0; nRun < BENCH_RUNS; ++nRun)
+		g_pCompress->EncodeCompressVectors(&aCompVecs[0], &aVecs[0], nCount);
+	fArray = timer.GetMS();
+	Report("encode vector", fSingle, fArray, nTotal);
+
+	timer.Start();
+	for (uint32 nRun = 0; nRun < BENCH_RUNS; ++nRun)
+		for (uint32 i = 0; i < nCount; ++i)
+			g_pCompress->DecodeCompressVector(&aOutVecs[i], &aCompVecs[i]);
+	fSingle = timer.GetMS();
+	timer.Start();
+	for (uint32 nRun = 0; nRun < BENCH_RUNS; ++nRun)
+		g_pCompress->DecodeCompressVectors(&aOutVecs[0], &aCompVecs[0], nCount);
+	fArray = timer.GetMS();
+	Report("decode vector", fSingle, fArray, nTotal);
+
+	timer.Start();
+	for (uint32 nRun = 0; nRun < BENCH_RUNS; ++nRun)
+		for (uint32 i = 0; i < nCount; ++i)
+			g_pCompress->EncodeCompressWorldPosition(&aCompPos[i], &aVecs[i], vMin, vInvDiff);
+	fSingle = timer.GetMS();
+	timer.Start();
+	for (uint32 nRun = 0; nRun < BENCH_RUNS; ++nRun)
+		g_pCompress->EncodeCompressWorldPositions(&aCompPos[0], &aVecs[0], nCount, vMin, vInvDiff);
+	fArray = timer.GetMS();
+	Report("encode world position", fSingle, fArray, nTotal);
+
+	timer.Start();
+	for (uint32 nRun = 0; nRun < BENCH_RUNS; ++nRun)
+		for (uint32 i = 0; i < nCount; ++i)
+			g_pCompress->DecodeCompressWorldPosition(&aOutVecs[i], &aCompPos[i], vMin, vMax);
+	fSingle = timer.GetMS();
+	timer.Start();
+	for (uint32 nRun = 0; nRun < BENCH_RUNS; ++nRun)
+		g_pCompress->DecodeCompressWorldPositions(&aOutVecs[0], &aCompPos[0], nCount, vMin, vMax);
+	fArray = timer.GetMS();
+	Report("decode world position", fSingle, fArray, nTotal);
+
+	timer.Start();
+	for (uint32 nRun = 0; nRun < BENCH_RUNS; ++nRun)
+		for (uint32 i = 0; i < nCount; ++i)
+			g_pCompress->EncodeCompressRotation(&aRots[i], &aCompRots[i]);
+	fSingle = timer.GetMS();
+	timer.Start();
+	for (uint32 nRun = 0; nRun < BENCH_RUNS; ++nRun)
+		g_pCompress->EncodeCompressRotations(&aRots[0], &aCompRots[0], nCount);
+	fArray = timer.GetMS();
+	Report("encode rotation", fSingle, fArray, nTotal);
+
+	// UncompressRotation may change its source, so it works on copies
+	std::vector<CompRot> aCompCopies(aCompRots);
+	timer.Start();
+	for (uint32 nRun = 0; nRun < BENCH_RUNS; ++nRun)
+		for (uint32 i = 0; i < nCount; ++i)
+			g_pCompress->UncompressRotation(aCompCopies[i].m_Bytes, &aOutRots[i]);
+	fSingle = timer.GetMS();
+	timer.Start();
+	for (uint32 nRun = 0; nRun < BENCH_RUNS; ++nRun)
+		g_pCompress->UncompressRotations(&aCompRots[0], &aOutRots[0], nCount);
+	fArray = timer.GetMS();
+	Report("decode rotation", fSingle, fArray, nTotal);
+
+	return 0;
+}
@@ -0,0 +1,55 @@
+// Random vectors and rotations for the CCompress test and benchmark, with the
+// zero, axis aligned and tied cases the encoders branch on mixed in.
+
+#ifndef __COMPRESS_DATA_H__
+#define __COMPRESS_DATA_H__
+
+#include "compress.h"
+
+#include <random>
+#include <vector>
+
+
+static void GenerateCompressData(uint32 nCount, std::vector<LTVector> & aVecs, std::vector<LTRotation> & aRots)
+{
+	std::mt19937 random(7);
+	std::uniform_real_distribution<float> pos(-1000.0f, 1000.0f);
+	std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+	aVecs.resize(nCount);
+	aRots.resize(nCount);
+
+	for (uint32 i = 0; i < nCount; ++i)
+	{
+		aVecs[i].Init(pos(random), pos(random), pos(random));
+		if ((i % 17) == 0)
+			aVecs[i].Init(0.0f, 0.0f, 0.0f);
+		if ((i % 13) == 0)
+			aVecs[i].y = 0.0f;
+		if ((i % 11) == 0)
+			aVecs[i].x = -aVecs[i].z;
+
+		LTRotation & rot = aRots[i];
+		rot.m_Quat[0] = unit(random);
+		rot.m_Quat[1] = unit(random);
+		rot.m_Quat[2] = unit(random);
+		rot.m_Quat[3] = unit(random);
+
+		// Yaw only, which gets the short encoding
+		if ((i % 5) == 0)
+		{
+			rot.m_Quat[0] = 0.0f;
+			rot.m_Quat[2] = 0.0f;
+		}
+
+		if ((i % 7) == 0)
+			rot.Init();
+
+		float fMag = sqrtf(rot.m_Quat[0] * rot.m_Quat[0] + rot.m_Quat[1] * rot.m_Quat[1] +
+			rot.m_Quat[2] * rot.m_Quat[2] + rot.m_Quat[3] * rot.m_Quat[3]);
+		for (uint32 nComp = 0; nComp < 4; ++nComp)
+			rot.m_Quat[nComp] /= fMag;
+	}
+}
+
+#endif  // __COMPRESS_DATA_H__
@@ -0,0 +1,170 @@
+// CCompress: the array versions give exactly the same bytes and values as the
+// single ones, and values come back within the precision of their encoding.
+
+#include "bdefs.h"
+#include "compress.h"
+#include "packetdefs.h"
+#include "compress_data.h"
+#include "ltjs_test.h"
+
+static ICompress* g_pCompress;
+define_holder(ICompress, g_pCompress);
+
+#define TEST_COUNT	100003
+
+
+static float RotationError(const LTRotation & rotA, const LTRotation & rotB)
+{
+	// q and -q are the same rotation
+	float fDot = 0.0f;
+	for (uint32 nComp = 0; nComp < 4; ++nComp)
+		fDot += rotA.m_Quat[nComp] * rotB.m_Quat[nComp];
+	return 1.0f - fabsf(fDot);
+}
+
+static void TestVectors(const std::vector<LTVector> & aVecs)
+{
+	uint32 nCount = (uint32)aVecs.size();
+
+	std::vector<CompVector> aComp(nCount), aCompSingle(nCount);
+	g_pCompress->EncodeCompressVectors(&aComp[0], &aVecs[0], nCount);
+
+	uint32 nEncodeDiffs = 0;
+	for (uint32 i = 0; i < nCount; ++i)
+	{
+		g_pCompress->EncodeCompressVector(&aCompSingle[i], &aVecs[i]);
+		if ((memcmp(&aComp[i].fA, &aCompSingle[i].fA, sizeof(float)) != 0) || (aComp[i].dwB != aCompSingle[i].dwB) ||
+			(aComp[i].dwC != aCompSingle[i].dwC) || (aComp[i].order != aCompSingle[i].order))
+			++nEncodeDiffs;
+	}
+	LTJS_CHECK(nEncodeDiffs == 0);
+
+	// Only the low 16 bits of dwB and dwC go over the wire, their high bits travel in order
+	for (uint32 i = 0; i < nCount; ++i)
+	{
+		aComp[i].dwB &= 0xFFFF;
+		aComp[i].dwC &= 0xFFFF;
+	}
+
+	std::vector<LTVector> aOut(nCount), aOutSingle(nCount);
+	g_pCompress->DecodeCompressVectors(&aOut[0], &aComp[0], nCount);
+
+	uint32 nDecodeDiffs = 0;
+	float fMaxError = 0.0f;
+	for (uint32 i = 0; i < nCount; ++i)
+	{
+		g_pCompress->DecodeCompressVector(&aOutSingle[i], &aComp[i]);
+		if (memcmp(&aOut[i], &aOutSingle[i], sizeof(LTVector)) != 0)
+			++nDecodeDiffs;
+
+		// The two small coordinates keep 18 bits relative to the largest one
+		float fLargest = LTMAX(LTMAX(fabsf(aVecs[i].x), fabsf(aVecs[i].y)), fabsf(aVecs[i].z));
+		if (fLargest > 0.0f)
+			fMaxError = LTMAX(fMaxError, (aOut[i] - aVecs[i]).Mag() / fLargest);
+	}
+	LTJS_CHECK(nDecodeDiffs == 0);
+	LTJS_CHECK(fMaxError < 2.0f / (1 << 17));
+	printf("vectors: max error %g of the largest coordinate\n", fMaxError);
+}
+
+static void TestWorldPositions(const std::vector<LTVector> & aVecs, bool bHiRes)
+{
+	uint32 nCount = (uint32)aVecs.size();
+
+	LTVector vMin(-1100.0f, -1050.0f, -1200.0f);
+	LTVector vMax(1000.0f, 1200.0f, 1100.0f);
+	LTVector vInvDiff(1.0f / (vMax.x - vMin.x), 1.0f / (vMax.y - vMin.y), 1.0f / (vMax.z - vMin.z));
+
+	std::vector<CompWorldPos> aComp(nCount), aCompSingle(nCount);
+	g_pCompress->EncodeCompressWorldPositions(&aComp[0], &aVecs[0], nCount, vMin, vInvDiff, bHiRes);
+
+	uint32 nEncodeDiffs = 0;
+	for (uint32 i = 0; i < nCount; ++i)
+	{
+		g_pCompress->EncodeCompressWorldPosition(&aCompSingle[i], &aVecs[i], vMin, vInvDiff, bHiRes);
+		if (!(aComp[i] == aCompSingle[i]))
+			++nEncodeDiffs;
+	}
+	LTJS_CHECK(nEncodeDiffs == 0);
+
+	std::vector<LTVector> aOut(nCount), aOutSingle(nCount);
+	g_pCompress->DecodeCompressWorldPositions(&aOut[0], &aComp[0], nCount, vMin, vMax, bHiRes);
+
+	// A step of the encoding on each axis, and a bit for the float math.  Encoding scales by
+	// 2^n - 1 and decoding by 2^n, so values end up to a step off at the far end of the range
+	LTVector vStep = vMax - vMin;
+	vStep.x /= (float)(1 << (bHiRes ? NUM_POSITION_BITS_X : 16));
+	vStep.y /= (float)(1 << (bHiRes ? NUM_POSITION_BITS_Y : 16));
+	vStep.z /= (float)(1 << (bHiRes ? NUM_POSITION_BITS_Z : 16));
+
+	uint32 nDecodeDiffs = 0;
+	uint32 nOutOfRange = 0;
+	for (uint32 i = 0; i < nCount; ++i)
+	{
+		g_pCompress->DecodeCompressWorldPosition(&aOutSingle[i], &aComp[i], vMin, vMax, bHiRes);
+		if (memcmp(&aOut[i], &aOutSingle[i], sizeof(LTVector)) != 0)
+			++nDecodeDiffs;
+
+		LTVector vError = aOut[i] - aVecs[i];
+		if ((fabsf(vError.x) > vStep.x + 0.001f) || (fabsf(vError.y) > vStep.y + 0.001f) ||
+			(fabsf(vError.z) > vStep.z + 0.001f))
+			++nOutOfRange;
+	}
+	LTJS_CHECK(nDecodeDiffs == 0);
+	LTJS_CHECK(nOutOfRange == 0);
+}
+
+static void TestRotations(const std::vector<LTRotation> & aRots)
+{
+	uint32 nCount = (uint32)aRots.size();
+
+	std::vector<CompRot> aComp(nCount), aCompSingle(nCount);
+	g_pCompress->EncodeCompressRotations(&aRots[0], &aComp[0], nCount);
+
+	uint32 nEncodeDiffs = 0;
+	for (uint32 i = 0; i < nCount; ++i)
+	{
+		g_pCompress->EncodeCompressRotation(&aRots[i], &aCompSingle[i]);
+		if (memcmp(aComp[i].m_Bytes, aCompSingle[i].m_Bytes, sizeof(aComp[i].m_Bytes)) != 0)
+			++nEncodeDiffs;
+	}
+	LTJS_CHECK(nEncodeDiffs == 0);
+
+	std::vector<LTRotation> aOut(nCount), aOutSingle(nCount);
+	g_pCompress->UncompressRotations(&aComp[0], &aOut[0], nCount);
+
+	uint32 nDecodeDiffs = 0;
+	float fMaxError = 0.0f;
+	for (uint32 i = 0; i < nCount; ++i)
+	{
+		// UncompressRotation may modify its source bytes
+		CompRot compCopy = aComp[i];
+		g_pCompress->UncompressRotation(compCopy.m_Bytes, &aOutSingle[i]);
+		if (memcmp(&aOut[i], &aOutSingle[i], sizeof(LTRotation)) != 0)
+			++nDecodeDiffs;
+
+		fMaxError = LTMAX(fMaxError, RotationError(aOut[i], aRots[i]));
+	}
+	LTJS_CHECK(nDecodeDiffs == 0);
+	LTJS_CHECK(fMaxError < 0.001f);
+	printf("rotations: max error %g (1 - |q.q'|)\n", fMaxError);
+}
+
+
+int main()
+{
+	LTJS_CHECK(g_pCompress != NULL);
+	if (!g_pCompress)
+		return LTJS_TEST_RESULT();
+
+	std::vector<LTVector> aVecs;
+	std::vector<LTRotation> aRots;
+	GenerateCompressData(TEST_COUNT, aVecs, aRots);
+
+	TestVectors(aVecs);
+	TestWorldPositions(aVecs, true);
+	TestWorldPositions(aVecs, false);
+	TestRotations(aRots);
+
+	return LTJS_TEST_RESULT();
+}
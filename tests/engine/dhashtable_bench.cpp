@@ -0,0 +1,89 @@
+// Hash table benchmark.  Times adding, finding, missing and iterating
+// filename keys laid out like the file and object name tables.
+//
+//   dhashtable_bench [count]
+
+#include "bdefs.h"
+#include "dhashtable.h"
+#include "ltjs_test.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+
+#define BENCH_RUNS	20
+
+
+static void Report(const char *pName, double fMS, uint32 nOps)
+{
+	printf("  %-24s %8.2f ns\n", pName, fMS * 1000000.0 / nOps);
+}
+
+
+int main(int argc, char **argv)
+{
+	uint32 nCount = (argc > 1) ? (uint32)atoi(argv[1]) : 4000;
+
+	std::vector<std::string> keys(nCount), missKeys(nCount);
+	for (uint32 i = 0; i < nCount; i++)
+	{
+		char key[64];
+		sprintf(key, "Textures/World/Level%u/Wall_%03u.dtx", i % 7, i);
+		keys[i] = key;
+
+		sprintf(key, "Textures/World/Level%u/Floor_%03u.dtx", i % 7, i);
+		missKeys[i] = key;
+	}
+
+	printf("%u keys, %u runs\n", nCount, BENCH_RUNS);
+
+	CBenchTimer timer;
+	double fAddMS = 0.0, fFindMS = 0.0, fMissMS = 0.0, fIterateMS = 0.0;
+	uint32 nFound = 0;
+
+	for (uint32 nRun = 0; nRun < BENCH_RUNS; ++nRun)
+	{
+		// Same initial size as the server's file table
+		HHashTable *hTable = hs_CreateHashTable(500, HASH_FILENAME);
+
+		timer.Start();
+		for (uint32 i = 0; i < nCount; i++)
+			hs_AddElement(hTable, keys[i].c_str(), (uint32)keys[i].size() + 1);
+		fAddMS += timer.GetMS();
+
+		timer.Start();
+		for (uint32 i = 0; i < nCount; i++)
+			nFound += hs_FindElement(hTable, keys[i].c_str(), (uint32)keys[i].size() + 1) != LTNULL;
+		fFindMS += timer.GetMS();
+
+		timer.Start();
+		for (uint32 i = 0; i < nCount; i++)
+			nFound += hs_FindElement(hTable, missKeys[i].c_str(), (uint32)missKeys[i].size() + 1) != LTNULL;
+		fMissMS += timer.GetMS();
+
+		timer.Start();
+		HHashIterator *hIterator = hs_GetFirstElement(hTable);
+		while (hIterator)
+		{
+			hs_GetNextElement(hIterator);
+			nFound++;
+		}
+		fIterateMS += timer.GetMS();
+
+		if (nRun == 0)
+			printf("max probe %u, collisions %u\n", hs_GetMaxProbeLength(hTable), hs_GetNumCollisions(hTable));
+
+		hs_DestroyHashTable(hTable);
+	}
+
+	uint32 nTotal = nCount * BENCH_RUNS;
+	Report("add", fAddMS, nTotal);
+	Report("find", fFindMS, nTotal);
+	Report("find missing", fMissMS, nTotal);
+	Report("iterate", fIterateMS, nTotal);
+
+	// Keeps the finds from being optimized out
+	return (nFound == 2 * nTotal) ? 0 : 1;
+}
@@ -0,0 +1,196 @@
+// Hash table: finds match a reference multimap through random adds and
+// removes, elements with the same key come back newest first (also after the
+// table grows), keys fold the way the hash type says, and removing while
+// iterating visits everything once.
+
+#include "bdefs.h"
+#include "dhashtable.h"
+#include "ltjs_test.h"
+
+#include <algorithm>
+#include <map>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+
+static std::string FoldFilename(const char *pKey)
+{
+	std::string folded(pKey);
+	for (size_t i = 0; i < folded.size(); i++)
+	{
+		folded[i] = (char)toupper(folded[i]);
+		if (folded[i] == '/')
+			folded[i] = '\\';
+	}
+
+	return folded;
+}
+
+
+// All the elements found for the key, in the order the table gives them.
+static std::vector<HHashElement*> FindAll(HHashTable *hTable, const char *pKey)
+{
+	uint32 keyLen = (uint32)strlen(pKey) + 1;
+
+	std::vector<HHashElement*> found;
+	for (HHashElement *hElement = hs_FindElement(hTable, pKey, keyLen); hElement;
+		hElement = hs_FindNextElement(hTable, hElement, pKey, keyLen))
+	{
+		found.push_back(hElement);
+	}
+
+	return found;
+}
+
+
+// Random adds, finds and removes of filenames checked against a reference
+// that keeps each key's elements oldest first.
+static void CheckRandomOps()
+{
+	HHashTable *hTable = hs_CreateHashTable(16, HASH_FILENAME);
+	std::map<std::string, std::vector<HHashElement*>> ref;
+	uint32 nRefElements = 0;
+	bool bOrderOK = true;
+
+	srand(1);
+	for (uint32 i = 0; i < 200000; i++)
+	{
+		char key[32];
+		sprintf(key, "Tex/Wall%d.dtx", rand() % 3000);
+		if (rand() & 1)
+		{
+			for (char *pCur = key; *pCur; pCur++)
+				*pCur = (char)tolower(*pCur);
+		}
+
+		std::vector<HHashElement*> &elements = ref[FoldFilename(key)];
+
+		switch (rand() % 3)
+		{
+			case 0:
+			{
+				elements.push_back(hs_AddElement(hTable, key, (uint32)strlen(key) + 1));
+				nRefElements++;
+			}
+			break;
+
+			case 1:
+			{
+				std::vector<HHashElement*> expected(elements.rbegin(), elements.rend());
+				bOrderOK = bOrderOK && (FindAll(hTable, key) == expected);
+			}
+			break;
+
+			default:
+			{
+				// Remove one from anywhere in the run so the markers end up between duplicates
+				if (!elements.empty())
+				{
+					size_t iRemove = rand() % elements.size();
+					hs_RemoveElement(hTable, elements[iRemove]);
+					elements.erase(elements.begin() + iRemove);
+					nRefElements--;
+				}
+			}
+			break;
+		}
+	}
+
+	LTJS_CHECK(bOrderOK);
+	LTJS_CHECK(hs_GetNumElements(hTable) == nRefElements);
+
+	hs_DestroyHashTable(hTable);
+}
+
+
+// Duplicates added across several growths keep their order.
+static void CheckDuplicatesAcrossGrowth()
+{
+	HHashTable *hTable = hs_CreateHashTable(16, HASH_STRING_NOCASE);
+
+	std::vector<HHashElement*> added;
+	for (uint32 i = 0; i < 2000; i++)
+	{
+		char key[32];
+		sprintf(key, "Object%u", i);
+		hs_AddElement(hTable, key, (uint32)strlen(key) + 1);
+
+		if ((i % 100) == 0)
+			added.push_back(hs_AddElement(hTable, "Door", 5));
+	}
+
+	std::vector<HHashElement*> expected(added.rbegin(), added.rend());
+	LTJS_CHECK(FindAll(hTable, "DOOR") == expected);
+
+	hs_DestroyHashTable(hTable);
+}
+
+
+static void CheckKeyFolding()
+{
+	HHashTable *hFiles = hs_CreateHashTable(16, HASH_FILENAME);
+	HHashElement *hFile = hs_AddElement(hFiles, "Models/Door.ltb", 16);
+	LTJS_CHECK(hs_FindElement(hFiles, "MODELS\\DOOR.LTB", 16) == hFile);
+	LTJS_CHECK(hs_FindElement(hFiles, "Models/Door.lta", 16) == LTNULL);
+	hs_DestroyHashTable(hFiles);
+
+	HHashTable *hNoCase = hs_CreateHashTable(16, HASH_STRING_NOCASE);
+	HHashElement *hName = hs_AddElement(hNoCase, "Door", 5);
+	LTJS_CHECK(hs_FindElement(hNoCase, "dOOR", 5) == hName);
+	LTJS_CHECK(hs_FindElement(hNoCase, "Door", 4) == LTNULL);
+	hs_DestroyHashTable(hNoCase);
+
+	HHashTable *hRaw = hs_CreateHashTable(16, HASH_RAW);
+	HHashElement *hRawKey = hs_AddElement(hRaw, "Door", 5);
+	LTJS_CHECK(hs_FindElement(hRaw, "Door", 5) == hRawKey);
+	LTJS_CHECK(hs_FindElement(hRaw, "door", 5) == LTNULL);
+	hs_DestroyHashTable(hRaw);
+
+	HHashTable *hNumbers = hs_CreateHashTable(100, HASH_2BYTENUMBER);
+	bool bNumbersOK = true;
+	for (uint16 i = 0; i < 5000; i++)
+		hs_SetElementUserData(hs_AddElement(hNumbers, &i, 2), (void*)(size_t)(i + 1));
+	for (uint16 i = 0; i < 5000; i++)
+		bNumbersOK = bNumbersOK && ((size_t)hs_GetElementUserData(hs_FindElement(hNumbers, &i, 2)) == (size_t)(i + 1));
+	LTJS_CHECK(bNumbersOK);
+	hs_DestroyHashTable(hNumbers);
+}
+
+
+static void CheckRemoveWhileIterating()
+{
+	HHashTable *hTable = hs_CreateHashTable(16, HASH_STRING_NOCASE);
+	for (uint32 i = 0; i < 1000; i++)
+	{
+		char key[32];
+		sprintf(key, "Light%u", i % 700);
+		hs_AddElement(hTable, key, (uint32)strlen(key) + 1);
+	}
+
+	uint32 nVisited = 0;
+	HHashIterator *hIterator = hs_GetFirstElement(hTable);
+	while (hIterator)
+	{
+		HHashElement *hElement = hs_GetNextElement(hIterator);
+		if (nVisited & 1)
+			hs_RemoveElement(hTable, hElement);
+		nVisited++;
+	}
+
+	LTJS_CHECK(nVisited == 1000);
+	LTJS_CHECK(hs_GetNumElements(hTable) == 500);
+
+	hs_DestroyHashTable(hTable);
+}
+
+
+int main()
+{
+	CheckRandomOps();
+	CheckDuplicatesAcrossGrowth();
+	CheckKeyFolding();
+	CheckRemoveWhileIterating();
+
+	return LTJS_TEST_RESULT();
+}
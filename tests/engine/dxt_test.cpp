@@ -0,0 +1,304 @@
+// S3TC decoding: ConvertPixels turns DXT1/3/5 surfaces into the same bytes
+// as the per-texel decoder it replaced, for 16 and 32-bit destinations with
+// and without alpha, for single blocks, small surfaces and surfaces large
+// enough to be decoded in bands, and leaves the padding past each row alone.
+// Built as dxt_test, which takes the SSE2 path for 32-bit destinations, and
+// as dxt_scalar_test with DXT_DECODE_NO_SSE2, which doesn't.
+
+#include "bdefs.h"
+#include "pixelformat.h"
+#include "workerpool.h"
+#include "ltjs_test.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+
+#define DEST_PADDING	12
+#define PADDING_BYTE	0xCD
+
+
+// CC_16toBF from the RGB565 format.
+static uint32 RefToPValue(FormatMgr &formatMgr, uint16 val)
+{
+	const PFormat &src = formatMgr.m_RGB565Format;
+	uint32 comp[NUM_COLORPLANES];
+
+	for (uint32 i = 0; i < NUM_COLORPLANES; i++)
+		comp[i] = formatMgr.m_ScaleTo8[src.m_nBits[i]][(val & src.m_Masks[i]) >> src.m_FirstBits[i]];
+
+	return PValue_Set(comp[CP_ALPHA], comp[CP_RED], comp[CP_GREEN], comp[CP_BLUE]);
+}
+
+// CC_BFto16 and CC_BFto32.
+static uint32 RefFromPValue(FormatMgr &formatMgr, const PFormat &dest, uint32 val)
+{
+	uint32 comp[NUM_COLORPLANES];
+	PValue_Get(val, comp[CP_ALPHA], comp[CP_RED], comp[CP_GREEN], comp[CP_BLUE]);
+
+	uint32 ret = 0;
+	for (uint32 i = 0; i < NUM_COLORPLANES; i++)
+		ret |= (uint32)formatMgr.m_ScaleFrom8[dest.m_nBits[i]][comp[i]] << dest.m_FirstBits[i];
+
+	return ret;
+}
+
+
+// The decoder ConvertDXTGeneric had before it decoded whole blocks: the
+// colors are set through the base format, then the alpha is masked and OR'd
+// in texel by texel.
+template<class T>
+static void RefDecode(FormatMgr &formatMgr, BPPIdent srcType, const uint8 *pSrc,
+	const PFormat &destFormat, uint8 *pDest, long destPitch, uint32 width, uint32 height)
+{
+	bool bAlpha = (srcType != BPP_S3TC_DXT1);
+	bool bInterpolatedAlpha = (srcType == BPP_S3TC_DXT5);
+	uint32 defaultPValueAlphaMask = bInterpolatedAlpha ? 0 : PVALUE_ALPHAMASK;
+	uint32 defaultByteAlphaMask = bInterpolatedAlpha ? 0 : 0xFF;
+	T invAlphaMask = (T)~destFormat.m_Masks[CP_ALPHA];
+	uint32 nBlockBytes = bAlpha ? 16 : 8;
+	uint32 nBlocksX = width >> 2;
+
+	T fullAlphaValues[16];
+	for (uint32 i = 0; i < 16; i++)
+		fullAlphaValues[i] = (T)RefFromPValue(formatMgr, destFormat, PValue_Set(i * 17, 0, 0, 0));
+
+	for (uint32 yBlock = 0; yBlock < (height >> 2); yBlock++)
+	{
+		for (uint32 xBlock = 0; xBlock < nBlocksX; xBlock++)
+		{
+			const uint8 *pBlock = pSrc + (yBlock * nBlocksX + xBlock) * nBlockBytes;
+			const uint8 *pColorBlock = pBlock + (bAlpha ? 8 : 0);
+			uint16 val1, val2;
+			memcpy(&val1, pColorBlock, 2);
+			memcpy(&val2, pColorBlock + 2, 2);
+
+			uint32 ident32[4], comp[2][4];
+			ident32[0] = RefToPValue(formatMgr, val1);
+			ident32[1] = RefToPValue(formatMgr, val2);
+			PValue_Get(ident32[0], comp[0][0], comp[0][1], comp[0][2], comp[0][3]);
+			PValue_Get(ident32[1], comp[1][0], comp[1][1], comp[1][2], comp[1][3]);
+			ident32[0] |= defaultPValueAlphaMask;
+			ident32[1] |= defaultPValueAlphaMask;
+
+			if (val1 > val2)
+			{
+				ident32[2] = PValue_Set(defaultByteAlphaMask,
+					(comp[0][1]*2 + comp[1][1]) / 3, (comp[0][2]*2 + comp[1][2]) / 3, (comp[0][3]*2 + comp[1][3]) / 3);
+				ident32[3] = PValue_Set(defaultByteAlphaMask,
+					(comp[0][1] + comp[1][1]*2) / 3, (comp[0][2] + comp[1][2]*2) / 3, (comp[0][3] + comp[1][3]*2) / 3);
+			}
+			else
+			{
+				ident32[2] = PValue_Set(defaultByteAlphaMask,
+					(comp[0][1] + comp[1][1]) >> 1, (comp[0][2] + comp[1][2]) >> 1, (comp[0][3] + comp[1][3]) >> 1);
+				ident32[3] = 0;
+			}
+
+			T ident[4];
+			for (uint32 i = 0; i < 4; i++)
+				ident[i] = (T)RefFromPValue(formatMgr, destFormat, ident32[i]);
+
+			uint32 colorBits;
+			memcpy(&colorBits, pColorBlock + 4, 4);
+
+			uint64 alphaBits = 0;
+			T alphaValues[8];
+			if (bInterpolatedAlpha)
+			{
+				uint32 alpha[8];
+				alpha[0] = pBlock[0];
+				alpha[1] = pBlock[1];
+				if (alpha[0] > alpha[1])
+				{
+					for (uint32 i = 2; i < 8; i++)
+						alpha[i] = (alpha[0] * (8 - i) + alpha[1] * (i - 1)) / 7;
+				}
+				else
+				{
+					for (uint32 i = 2; i < 6; i++)
+						alpha[i] = (alpha[0] * (6 - i) + alpha[1] * (i - 1)) / 5;
+					alpha[6] = 0;
+					alpha[7] = 0xFF;
+				}
+
+				for (uint32 i = 0; i < 8; i++)
+				{
+					alphaValues[i] = (T)((uint32)formatMgr.m_ScaleFrom8[destFormat.m_nBits[CP_ALPHA]][alpha[i]]
+						<< destFormat.m_FirstBits[CP_ALPHA]);
+				}
+
+				// 3 bits per texel
+				for (uint32 i = 0; i < 6; i++)
+					alphaBits |= (uint64)pBlock[2 + i] << (i * 8);
+			}
+			else if (bAlpha)
+			{
+				// 4 bits per texel
+				for (uint32 i = 0; i < 8; i++)
+					alphaBits |= (uint64)pBlock[i] << (i * 8);
+			}
+
+			for (uint32 i = 0; i < 16; i++)
+			{
+				T *pOut = (T*)(pDest + ((yBlock << 2) + (i >> 2)) * destPitch) + (xBlock << 2) + (i & 3);
+				*pOut = ident[(colorBits >> (i * 2)) & 3];
+
+				if (bInterpolatedAlpha)
+				{
+					*pOut |= alphaValues[(alphaBits >> (i * 3)) & 7];
+				}
+				else if (bAlpha)
+				{
+					*pOut &= invAlphaMask;
+					*pOut |= fullAlphaValues[(alphaBits >> (i * 4)) & 15];
+				}
+			}
+		}
+	}
+}
+
+
+// Random blocks, with the endpoints forced into order on some of them so
+// there are plenty of 3-color and 6-alpha blocks, and equal endpoints too.
+static void MakeBlocks(std::vector<uint8> &data, BPPIdent srcType, uint32 nBlocks)
+{
+	uint32 nBlockBytes = (srcType == BPP_S3TC_DXT1) ? 8 : 16;
+	data.resize(nBlocks * nBlockBytes);
+
+	for (uint32 i = 0; i < data.size(); i++)
+		data[i] = (uint8)(rand() >> 4);
+
+	for (uint32 i = 0; i < nBlocks; i++)
+	{
+		uint8 *pBlock = &data[i * nBlockBytes];
+		uint8 *pColorBlock = pBlock + nBlockBytes - 8;
+
+		switch (rand() % 4)
+		{
+			case 0:
+				pColorBlock[2] = pColorBlock[0];
+				pColorBlock[3] = pColorBlock[1];
+				if (srcType == BPP_S3TC_DXT5)
+					pBlock[1] = pBlock[0];
+				break;
+
+			case 1:
+				pColorBlock[1] = 0x00;
+				pColorBlock[3] = 0xFF;
+				if (srcType == BPP_S3TC_DXT5 && pBlock[0] > pBlock[1])
+					pBlock[0] = pBlock[1];
+				break;
+
+			default:
+				break;
+		}
+	}
+}
+
+
+struct DestFormat
+{
+	const char	*m_pName;
+	BPPIdent	m_Type;
+	uint32		m_Masks[NUM_COLORPLANES];
+};
+
+static const DestFormat s_DestFormats[] =
+{
+	{ "ARGB8888",	BPP_32, { 0xFF000000, 0x00FF0000, 0x0000FF00, 0x000000FF } },
+	{ "XRGB8888",	BPP_32, { 0x00000000, 0x00FF0000, 0x0000FF00, 0x000000FF } },
+	{ "ABGR8888",	BPP_32, { 0xFF000000, 0x000000FF, 0x0000FF00, 0x00FF0000 } },
+	{ "RGB565",		BPP_16, { 0x0000, 0xF800, 0x07E0, 0x001F } },
+	{ "ARGB4444",	BPP_16, { 0xF000, 0x0F00, 0x00F0, 0x000F } },
+	{ "ARGB1555",	BPP_16, { 0x8000, 0x7C00, 0x03E0, 0x001F } },
+};
+
+
+static bool CheckDecode(FormatMgr &formatMgr, BPPIdent srcType, const DestFormat &destFormat,
+	uint32 width, uint32 height)
+{
+	std::vector<uint8> src;
+	MakeBlocks(src, srcType, (width >> 2) * (height >> 2));
+
+	PFormat srcFormat, destPFormat;
+	srcFormat.Init(srcType, 0, 0, 0, 0);
+	destPFormat.Init(destFormat.m_Type, destFormat.m_Masks[CP_ALPHA], destFormat.m_Masks[CP_RED],
+		destFormat.m_Masks[CP_GREEN], destFormat.m_Masks[CP_BLUE]);
+
+	uint32 nPixelBytes = (destFormat.m_Type == BPP_32) ? 4 : 2;
+	long destPitch = width * nPixelBytes + DEST_PADDING;
+	std::vector<uint8> dest(destPitch * height, PADDING_BYTE), ref(destPitch * height, PADDING_BYTE);
+
+	FMConvertRequest request;
+	request.m_pSrcFormat = &srcFormat;
+	request.m_pSrc = &src[0];
+	request.m_pDestFormat = &destPFormat;
+	request.m_pDest = &dest[0];
+	request.m_DestPitch = destPitch;
+	request.m_Width = width;
+	request.m_Height = height;
+
+	if (formatMgr.ConvertPixels(&request) != LT_OK)
+		return false;
+
+	if (nPixelBytes == 4)
+		RefDecode<uint32>(formatMgr, srcType, &src[0], destPFormat, &ref[0], destPitch, width, height);
+	else
+		RefDecode<uint16>(formatMgr, srcType, &src[0], destPFormat, &ref[0], destPitch, width, height);
+
+	if (dest != ref)
+	{
+		for (uint32 i = 0; i < dest.size(); i++)
+		{
+			if (dest[i] != ref[i])
+			{
+				printf("  DXT%d to %s, %ux%u: byte %u (row %u) is %02X, should be %02X\n",
+					(srcType == BPP_S3TC_DXT1) ? 1 : (srcType == BPP_S3TC_DXT3) ? 3 : 5,
+					destFormat.m_pName, width, height, i, (uint32)(i / destPitch), dest[i], ref[i]);
+				break;
+			}
+		}
+		return false;
+	}
+
+	return true;
+}
+
+
+static void CheckFormats()
+{
+	static const BPPIdent srcTypes[] = { BPP_S3TC_DXT1, BPP_S3TC_DXT3, BPP_S3TC_DXT5 };
+
+	// One block, a small surface decoded in one band, and a surface big enough
+	// to be split into bands
+	static const uint32 sizes[][2] = { { 4, 4 }, { 64, 32 }, { 512, 512 } };
+
+	FormatMgr formatMgr;
+	srand(1);
+
+	for (uint32 nSrc = 0; nSrc < sizeof(srcTypes) / sizeof(srcTypes[0]); nSrc++)
+	{
+		for (uint32 nDest = 0; nDest < sizeof(s_DestFormats) / sizeof(s_DestFormats[0]); nDest++)
+		{
+			for (uint32 nSize = 0; nSize < sizeof(sizes) / sizeof(sizes[0]); nSize++)
+			{
+				LTJS_CHECK(CheckDecode(formatMgr, srcTypes[nSrc], s_DestFormats[nDest],
+					sizes[nSize][0], sizes[nSize][1]));
+			}
+		}
+	}
+}
+
+
+int main()
+{
+	// Bands on worker threads even on a machine with one core
+	wp_SetNumThreads(4);
+
+	CheckFormats();
+
+	return LTJS_TEST_RESULT();
+}
@@ -0,0 +1,378 @@
+// File transfer loopback: a file server and client talk over a simulated link
+// with latency, limited bandwidth and packet loss.  Every file arrives whole
+// and in order, and the throughput for each link is reported.
+//
+// The link stands in for the guaranteed channel the transfer runs over: lost
+// packets cost bandwidth and come back after a resend timeout, and packets are
+// delivered in the order they were sent.
+
+#include "bdefs.h"
+#include "ftserv.h"
+#include "ftclient.h"
+#include "ftbase.h"
+#include "netmgr.h"
+#include "packet.h"
+#include "client_filemgr.h"
+#include "ltjs_test.h"
+
+#include <deque>
+#include <stdlib.h>
+#include <vector>
+
+
+// Simulated frame rate of both ends.
+#define SIM_FRAME_TIME		(1.0f / 60.0f)
+
+// Give up on a transfer after this long.
+#define SIM_MAX_TIME		600.0f
+
+// Size of the file data in each block, as the server sends it.
+#define SIM_BLOCK_SIZE		(MAX_PACKET_LEN - 40)
+
+
+// One direction of the link.
+class CSimConn : public CBaseConn
+{
+public:
+
+	CSimConn(float fLatency, float fLoss, uint32 nBitsPerSecond)
+	{
+		m_fLatency = fLatency;
+		m_fLoss = fLoss;
+		m_nBitsPerSecond = nBitsPerSecond;
+		m_fTime = 0.0f;
+		m_fLinkFree = 0.0f;
+		m_fLastArrival = 0.0f;
+		m_pDriver = LTNULL;
+	}
+
+	virtual int32 GetAvailableBandwidth(float fTime) const
+	{
+		float fQueued = LTMAX(m_fLinkFree - m_fTime, 0.0f);
+		return (int32)((fTime - fQueued) * (float)m_nBitsPerSecond);
+	}
+
+	virtual uint32	GetBandwidth() const	{ return m_nBitsPerSecond; }
+	virtual float	GetPacketLoss() const	{ return m_fLoss; }
+	virtual float	GetPing()				{ return m_fLatency * 2.0f; }
+
+	void Send(const CPacket_Read &cPacket)
+	{
+		float fSendTime = (float)(cPacket.Size() + UDP_HEADER_BITS) / (float)m_nBitsPerSecond;
+
+		// Each lost copy takes its turn on the wire.  The UDP driver first resends
+		// a guaranteed frame two pings after it went out (each at least a
+		// heartbeat), and every ping after that.
+		float fResendTime = LTMAX(m_fLatency * 2.0f, HEARTBEAT_TIME);
+		float fStart = LTMAX(m_fTime, m_fLinkFree);
+		float fNextResend = fStart + fResendTime * 2.0f;
+		float fArrival;
+		for (;;)
+		{
+			m_fLinkFree = fStart + fSendTime;
+			fArrival = m_fLinkFree + m_fLatency;
+			if (((float)rand() / (float)RAND_MAX) >= m_fLoss)
+				break;
+
+			fStart = LTMAX(fNextResend, m_fLinkFree);
+			fNextResend = fStart + fResendTime;
+		}
+
+		fArrival = LTMAX(fArrival, m_fLastArrival);
+		m_fLastArrival = fArrival;
+
+		SimPacket packet;
+		packet.m_fArrival = fArrival;
+		packet.m_cPacket = cPacket;
+		m_Packets.push_back(packet);
+	}
+
+	bool IsEmpty() const { return m_Packets.empty(); }
+
+	// The next packet that has arrived by now, if there is one.
+	bool Receive(CPacket_Read &cPacket)
+	{
+		if (m_Packets.empty() || (m_Packets.front().m_fArrival > m_fTime))
+			return false;
+
+		cPacket = m_Packets.front().m_cPacket;
+		m_Packets.pop_front();
+		return true;
+	}
+
+	float	m_fTime;
+
+private:
+
+	// IP and UDP headers plus the guaranteed channel's own.
+	enum { UDP_HEADER_BITS = 36 * 8 };
+
+	// Shortest ping the UDP driver resends on.
+	static constexpr float HEARTBEAT_TIME = 0.017f;
+
+	struct SimPacket
+	{
+		float			m_fArrival;
+		CPacket_Read	m_cPacket;
+	};
+
+	float	m_fLatency;
+	float	m_fLoss;
+	uint32	m_nBitsPerSecond;
+	float	m_fLinkFree;
+	float	m_fLastArrival;
+
+	std::deque<SimPacket>	m_Packets;
+};
+
+
+// Link seams: the parts of netmgr.cpp the file transfer calls, routed to the
+// simulated link.
+
+CBaseConn::CBaseConn()
+{
+	m_ConnFlags = 0;
+}
+
+CBaseConn::~CBaseConn()
+{
+}
+
+CNetMgr::CNetMgr()
+{
+}
+
+CNetMgr::~CNetMgr()
+{
+}
+
+bool CNetMgr::SendPacket(const CPacket_Read &cPacket, CBaseConn *idSendTo, uint32 packetFlags)
+{
+	((CSimConn*)idSendTo)->Send(cPacket);
+	return true;
+}
+
+
+// A file to send, held in memory.
+class CMemStream : public ILTStream
+{
+public:
+
+	CMemStream(const std::vector<uint8> &data) : m_Data(data), m_nPos(0) {}
+
+	virtual void Release() { delete this; }
+
+	virtual LTRESULT Read(void *pData, uint32 size)
+	{
+		if (m_nPos + size > m_Data.size())
+		{
+			memset(pData, 0, size);
+			return LT_ERROR;
+		}
+
+		memcpy(pData, &m_Data[m_nPos], size);
+		m_nPos += size;
+		return LT_OK;
+	}
+
+	virtual LTRESULT ReadString(char *pStr, uint32 maxBytes)	{ return LT_ERROR; }
+	virtual LTRESULT ErrorStatus()								{ return LT_OK; }
+	virtual LTRESULT SeekTo(uint32 offset)						{ m_nPos = offset; return LT_OK; }
+	virtual LTRESULT GetPos(uint32 *offset)						{ *offset = m_nPos; return LT_OK; }
+	virtual LTRESULT GetLen(uint32 *len)						{ *len = (uint32)m_Data.size(); return LT_OK; }
+	virtual LTRESULT WriteStream(ILTStream &dsSource, uint32 dwMin, uint32 dwMax) { return LT_ERROR; }
+	virtual LTRESULT Write(const void *pData, uint32 size)		{ return LT_ERROR; }
+	virtual LTRESULT WriteString(const char *pStr)				{ return LT_ERROR; }
+
+private:
+
+	const std::vector<uint8>	&m_Data;
+	uint32						m_nPos;
+};
+
+
+static std::vector<uint8> g_FileData;
+static uint32 g_nStreamsOpen = 0;
+
+static ILTStream* OpenTestFile(FTServ *hServ, char *pFilename)
+{
+	g_nStreamsOpen++;
+	return new CMemStream(g_FileData);
+}
+
+static void CloseTestFile(FTServ *hServ, ILTStream *pStream)
+{
+	g_nStreamsOpen--;
+	pStream->Release();
+}
+
+static int CantOpenTestFile(FTServ *hServ, char *pFilename)
+{
+	return TODO_REMOVEFILE;
+}
+
+
+// The client doesn't have any of the server's files.
+class CTestClientFileMgr : public IClientFileMgr
+{
+public:
+
+	declare_interface(CTestClientFileMgr);
+
+	virtual void Init() {}
+	virtual void Term() {}
+	virtual void ProcessPacket(const CPacket_Read &cPacket) {}
+	virtual void OnConnect(CBaseConn *serverID) {}
+	virtual void OnDisconnect() {}
+	virtual void AddResourceTrees(const char **pTreeNames, int nTrees, TreeType *pTreeTypes, int *nTreesLoaded) {}
+	virtual const char* GetFilename(FileRef *pFileRef) { return LTNULL; }
+	virtual FileEntry* GetFileList(const char *pDirName) { return LTNULL; }
+	virtual FileIdentifier* GetFileIdentifier(FileRef *pDesc, uint8 typeCode) { return LTNULL; }
+	virtual ILTStream* OpenFileIdentifier(FileIdentifier *pFile) { return LTNULL; }
+	virtual ILTStream* OpenFile(FileRef *pDesc) { return LTNULL; }
+	virtual FileIdentifier* FindFileIdentifier(const char *pFilename, uint8 typeCode) { return LTNULL; }
+	virtual LTRESULT CopyFile(const char *pSrc, const char *pDest) { return LT_ERROR; }
+	virtual int OnNewFile(FTClient *hClient, const char *pFilename, uint32 size, uint32 fileID) { return NF_DONTHAVEFILE; }
+	virtual FTClient* GetFTClient() { return LTNULL; }
+};
+
+define_interface(CTestClientFileMgr, IClientFileMgr);
+
+
+struct LinkDesc
+{
+	const char	*m_pName;
+	float		m_fLatency;			// One way, in seconds.
+	float		m_fLoss;
+	uint32		m_nBitsPerSecond;
+};
+
+
+// Sends the files over the link and checks what arrives.  Returns the
+// throughput in bytes per second.
+static float RunTransfer(const LinkDesc &link, uint32 nFiles)
+{
+	static CNetMgr s_NetMgr;
+
+	CSimConn cToClient(link.m_fLatency, link.m_fLoss, link.m_nBitsPerSecond);
+	CSimConn cToServer(link.m_fLatency, link.m_fLoss, link.m_nBitsPerSecond);
+
+	FTSInitStruct serverInit;
+	serverInit.m_OpenFn = OpenTestFile;
+	serverInit.m_CloseFn = CloseTestFile;
+	serverInit.m_CantOpenFileFn = CantOpenTestFile;
+	serverInit.m_pNetMgr = &s_NetMgr;
+	serverInit.m_ConnID = &cToClient;
+	FTServ *pServer = fts_Init(&serverInit, 0);
+
+	FTCInitStruct clientInit;
+	clientInit.m_pNetMgr = &s_NetMgr;
+	clientInit.m_ConnID = &cToServer;
+	FTClient *pClient = ftc_Init(&clientInit);
+
+	char aFilenames[4][32];
+	for (uint32 i = 0; i < nFiles; i++)
+	{
+		sprintf(aFilenames[i], "Worlds/Custom%u.dat", i);
+		fts_AddFile(pServer, aFilenames[i], (uint32)g_FileData.size(), i, FFLAG_NEEDED);
+	}
+
+	// What the client has been sent of the current file.
+	uint32 nReceived = 0;
+	uint32 nFilesReceived = 0;
+	bool bDataOK = true;
+
+	float fTime = 0.0f;
+	while (((fts_GetNumTotalFiles(pServer) > 0) || !cToClient.IsEmpty()) && (fTime < SIM_MAX_TIME))
+	{
+		fTime += SIM_FRAME_TIME;
+		cToClient.m_fTime = fTime;
+		cToServer.m_fTime = fTime;
+
+		CPacket_Read cPacket;
+		while (cToClient.Receive(cPacket))
+		{
+			cPacket.SeekTo(0);
+			uint8 nPacketID = cPacket.Readuint8();
+			if (nPacketID == STC_STARTTRANSFER)
+			{
+				nReceived = 0;
+			}
+			else if (nPacketID == STC_FILEBLOCK)
+			{
+				uint32 nSize = cPacket.TellEnd() / 8;
+				bDataOK = bDataOK && (nReceived + nSize <= g_FileData.size());
+
+				uint8 aBlock[SIM_BLOCK_SIZE];
+				cPacket.ReadData(aBlock, nSize * 8);
+				bDataOK = bDataOK && (memcmp(aBlock, &g_FileData[nReceived], nSize) == 0);
+
+				nReceived += nSize;
+				if (nReceived == g_FileData.size())
+					nFilesReceived++;
+			}
+
+			ftc_ProcessPacket(pClient, cPacket);
+		}
+
+		while (cToServer.Receive(cPacket))
+		{
+			fts_ProcessPacket(pServer, cPacket);
+		}
+
+		fts_Update(pServer, SIM_FRAME_TIME);
+	}
+
+	LTJS_CHECK(bDataOK);
+	LTJS_CHECK(nFilesReceived == nFiles);
+	LTJS_CHECK(fts_GetNumTotalFiles(pServer) == 0);
+	LTJS_CHECK(g_nStreamsOpen == 0);
+
+	ftc_Term(pClient);
+	fts_Term(pServer);
+
+	float fThroughput = (float)(g_FileData.size() * nFiles) / fTime;
+	float fLinkBytes = (float)link.m_nBitsPerSecond / 8.0f;
+	printf("  %-22s %5.0f ms %4.1f%% %6u kbit/s  %8.1f KB/s  %5.1f%% of the link\n",
+		link.m_pName, link.m_fLatency * 2000.0f, link.m_fLoss * 100.0f, link.m_nBitsPerSecond / 1000,
+		fThroughput / 1024.0f, 100.0f * fThroughput / fLinkBytes);
+
+	return fThroughput;
+}
+
+
+int main()
+{
+	// Not a whole number of blocks or read-ahead chunks, so the ends get used.
+	g_FileData.resize(2 * 1024 * 1024 + 777);
+	srand(3);
+	for (size_t i = 0; i < g_FileData.size(); i++)
+		g_FileData[i] = (uint8)rand();
+
+	static const LinkDesc s_Links[] =
+	{
+		{ "LAN",			0.001f,		0.0f,	10000000 },
+		{ "broadband",		0.030f,		0.01f,	4000000 },
+		{ "long, lossy",	0.100f,		0.05f,	1000000 },
+		{ "modem",			0.080f,		0.01f,	56000 },
+	};
+
+	// The most the server could send when it was one block per update.
+	float fOneBlockPerUpdate = (float)SIM_BLOCK_SIZE / SIM_FRAME_TIME;
+
+	printf("%u byte files, %.0f updates per second, one block per update is %.1f KB/s\n",
+		(uint32)g_FileData.size(), 1.0f / SIM_FRAME_TIME, fOneBlockPerUpdate / 1024.0f);
+	printf("  link                   round trip, loss, bandwidth\n");
+
+	float fLAN = RunTransfer(s_Links[0], 2);
+	float fBroadband = RunTransfer(s_Links[1], 1);
+	RunTransfer(s_Links[2], 1);
+	RunTransfer(s_Links[3], 1);
+
+	// Fast links get well past one block per update.  On the lossy ones the
+	// window stalls behind each resend, since blocks are delivered in order.
+	LTJS_CHECK(fLAN > 4.0f * fOneBlockPerUpdate);
+	LTJS_CHECK(fBroadband > 2.0f * fOneBlockPerUpdate);
+
+	return LTJS_TEST_RESULT();
+}
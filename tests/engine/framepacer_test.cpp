@@ -0,0 +1,204 @@
+// Frame pacer, driven by a clock that only moves when the test or the pacer
+// moves it: unpaced frames are only measured, paced frames end on their
+// deadlines without drifting however late the sleeps wake up, a frame a bit
+// late is made up for on the next one, a long hitch starts the schedule over
+// instead of rushing, and a new cap schedules from the last frame.
+
+#include "bdefs.h"
+#include "framepacer.h"
+#include "ltjs_test.h"
+
+
+#define MS_NS		1000000ULL
+
+
+// Every read moves time on by a microsecond like a spinning caller would, and
+// sleeps oversleep by a set amount.
+class CFakeClock : public IFramePacerClock
+{
+public:
+
+	CFakeClock(uint64 nOversleepNS) :
+		m_nTimeNS(1000 * MS_NS),
+		m_nOversleepNS(nOversleepNS),
+		m_nSleeps(0),
+		m_nSpins(0)
+	{
+	}
+
+	virtual uint64 GetTimeNS()
+	{
+		m_nTimeNS += 1000;
+		return m_nTimeNS;
+	}
+
+	virtual void Sleep(uint32 nMS)
+	{
+		if (nMS)
+		{
+			m_nTimeNS += nMS * MS_NS + m_nOversleepNS;
+			m_nSleeps++;
+		}
+		else
+		{
+			m_nSpins++;
+		}
+	}
+
+	// The frame's own work.
+	void Work(uint64 nNS)	{ m_nTimeNS += nNS; }
+
+	uint64	m_nTimeNS;
+	uint64	m_nOversleepNS;
+	uint32	m_nSleeps;
+	uint32	m_nSpins;
+};
+
+
+static void CheckUnpaced()
+{
+	CFakeClock clock(0);
+	CFramePacer pacer(&clock);
+	FramePacerStats stats;
+
+	// The first frame has nothing to measure against
+	pacer.EndFrame(0.0f, 1500);
+	for (uint32 i = 0; i < 100; i++)
+	{
+		clock.Work((i & 1) ? 9 * MS_NS : 11 * MS_NS);
+		pacer.EndFrame(0.0f, 1500);
+	}
+
+	pacer.GetStats(stats);
+	LTJS_CHECK(stats.m_nFrames == 100);
+	LTJS_CHECK(stats.m_nLateFrames == 0);
+	LTJS_CHECK_NEAR(stats.m_fMeanMS, 10.001, 1e-6);
+	LTJS_CHECK_NEAR(stats.m_fStdDevMS, 1.0, 1e-6);
+	LTJS_CHECK_NEAR(stats.m_fMinMS, 9.001, 1e-6);
+	LTJS_CHECK_NEAR(stats.m_fMaxMS, 11.001, 1e-6);
+	LTJS_CHECK(stats.m_fMeanOvershootMS == 0.0);
+	LTJS_CHECK(clock.m_nSleeps == 0 && clock.m_nSpins == 0);
+
+	pacer.ResetStats();
+	pacer.GetStats(stats);
+	LTJS_CHECK(stats.m_nFrames == 0 && stats.m_fMeanMS == 0.0 && stats.m_fMaxMS == 0.0);
+}
+
+
+// Cheap frames at 240 fps with sleeps that wake up 0.7ms late.  The spin
+// margin covers that, so every frame ends within a clock tick of its deadline.
+static void CheckPaced()
+{
+	CFakeClock clock(700000);
+	CFramePacer pacer(&clock);
+	FramePacerStats stats;
+
+	pacer.EndFrame(240.0f, 1500);
+	uint64 nStart = clock.m_nTimeNS;
+
+	for (uint32 i = 0; i < 1000; i++)
+	{
+		clock.Work(1 * MS_NS + (i % 7) * 300000);
+		pacer.EndFrame(240.0f, 1500);
+	}
+
+	pacer.GetStats(stats);
+	double fPeriodMS = 1000.0 / 240.0;
+
+	LTJS_CHECK(stats.m_nFrames == 1000);
+	LTJS_CHECK(stats.m_nLateFrames == 0);
+	LTJS_CHECK_NEAR(stats.m_fMeanMS, fPeriodMS, 0.002);
+	LTJS_CHECK(stats.m_fStdDevMS < 0.002);
+	LTJS_CHECK(stats.m_fMeanOvershootMS <= 0.001);
+	LTJS_CHECK(clock.m_nSleeps > 0 && clock.m_nSpins > 0);
+
+	// No drift: a thousand frames take a thousand periods
+	LTJS_CHECK_NEAR((double)(clock.m_nTimeNS - nStart) / MS_NS, 1000 * fPeriodMS, 0.01);
+}
+
+
+static void CheckLateFrames()
+{
+	CFakeClock clock(0);
+	CFramePacer pacer(&clock);
+	FramePacerStats stats;
+	const uint64 nPeriod = 10 * MS_NS;
+
+	pacer.EndFrame(100.0f, 1000);
+	uint64 nStart = clock.m_nTimeNS;
+	for (uint32 i = 0; i < 10; i++)
+	{
+		clock.Work(2 * MS_NS);
+		pacer.EndFrame(100.0f, 1000);
+	}
+
+	// Half a period late, the next frame ends on its usual deadline
+	clock.Work(nPeriod + nPeriod / 2);
+	pacer.EndFrame(100.0f, 1000);
+	clock.Work(1 * MS_NS);
+	pacer.EndFrame(100.0f, 1000);
+
+	pacer.GetStats(stats);
+	LTJS_CHECK(stats.m_nLateFrames == 1);
+	LTJS_CHECK_NEAR((double)(clock.m_nTimeNS - nStart), 12.0 * nPeriod, 5000.0);
+
+	// After a hitch of several periods the schedule starts over from the late
+	// frame, the frames after it still take a whole period each
+	clock.Work(5 * nPeriod);
+	pacer.EndFrame(100.0f, 1000);
+	uint64 nHitchEnd = clock.m_nTimeNS;
+
+	pacer.ResetStats();
+	for (uint32 i = 0; i < 10; i++)
+	{
+		clock.Work(1 * MS_NS);
+		pacer.EndFrame(100.0f, 1000);
+	}
+
+	pacer.GetStats(stats);
+	LTJS_CHECK(stats.m_nLateFrames == 0);
+	LTJS_CHECK(stats.m_fMinMS > 9.99);
+	LTJS_CHECK_NEAR((double)(clock.m_nTimeNS - nHitchEnd), 10.0 * nPeriod, 5000.0);
+}
+
+
+static void CheckCapChange()
+{
+	CFakeClock clock(0);
+	CFramePacer pacer(&clock);
+	FramePacerStats stats;
+
+	for (uint32 i = 0; i < 5; i++)
+	{
+		clock.Work(1 * MS_NS);
+		pacer.EndFrame(100.0f, 1000);
+	}
+
+	// Going from 100 to 50 fps, the first frame at the new cap is a whole new
+	// period after the last one rather than the rest of an old one
+	uint64 nLastEnd = clock.m_nTimeNS;
+	clock.Work(1 * MS_NS);
+	pacer.EndFrame(50.0f, 1000);
+	LTJS_CHECK_NEAR((double)(clock.m_nTimeNS - nLastEnd), 20.0 * MS_NS, 5000.0);
+
+	// Turning the cap off and on again schedules from the last frame too
+	pacer.EndFrame(0.0f, 1000);
+	nLastEnd = clock.m_nTimeNS;
+	clock.Work(1 * MS_NS);
+	pacer.EndFrame(50.0f, 1000);
+	LTJS_CHECK_NEAR((double)(clock.m_nTimeNS - nLastEnd), 20.0 * MS_NS, 5000.0);
+
+	pacer.GetStats(stats);
+	LTJS_CHECK(stats.m_nLateFrames == 0);
+}
+
+
+int main()
+{
+	CheckUnpaced();
+	CheckPaced();
+	CheckLateFrames();
+	CheckCapChange();
+
+	return LTJS_TEST_RESULT();
+}
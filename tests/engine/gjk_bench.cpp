@@ -0,0 +1,129 @@
+// GJK benchmark.  Times closest point queries on resting box and cylinder
+// pairs that jitter a little each frame, cold through the virtual support
+// maps, and warm through the concrete ones with a cache per pair.
+//
+//   gjk_bench [pairs]
+
+#include "ltbasedefs.h"
+#include "collision_object.h"
+#include "ltjs_test.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+
+#define BENCH_FRAMES	100
+
+
+static float RandFloat(float fMin, float fMax)
+{
+	return fMin + (fMax - fMin) * (float)rand() / (float)RAND_MAX;
+}
+
+
+struct BenchPair
+{
+	LTVector3f	m_PosA, m_PosB;
+	LTBasis		m_BasisA, m_BasisB;
+	LTVector3f	m_DimA, m_DimB;
+	LTGJKCache	m_Cache;
+};
+
+
+template<class SA, class SB>
+static void RunPairs(const char *pName, std::vector<BenchPair> &pairs,
+	SA (*MakeA)(const BenchPair&), SB (*MakeB)(const BenchPair&))
+{
+	CBenchTimer timer;
+	double fColdMS = 0.0, fWarmMS = 0.0;
+	int32 nColdIterations = 0, nWarmIterations = 0;
+	float fDistSum = 0.0f;
+
+	for (uint32 nFrame = 0; nFrame < BENCH_FRAMES; nFrame++)
+	{
+		// Resting bodies settle by a hair each frame
+		for (uint32 i = 0; i < pairs.size(); i++)
+			pairs[i].m_PosA += LTVector3f(RandFloat(-0.002f, 0.002f), RandFloat(-0.002f, 0.002f), RandFloat(-0.002f, 0.002f));
+
+		timer.Start();
+		for (uint32 i = 0; i < pairs.size(); i++)
+		{
+			SA sA = MakeA(pairs[i]);
+			SB sB = MakeB(pairs[i]);
+			LTVector3f a, b;
+			fDistSum += GJK_ClosestPoints(a, b, (ILTSupportMap&)sA, (ILTSupportMap&)sB);
+		}
+		fColdMS += timer.GetMS();
+
+		// Iterations of the cold queries, outside the timing
+		for (uint32 i = 0; i < pairs.size(); i++)
+		{
+			SA sA = MakeA(pairs[i]);
+			SB sB = MakeB(pairs[i]);
+			LTVector3f a, b;
+			LTGJKCache cold;
+			GJK_ClosestPoints(a, b, (ILTSupportMap&)sA, (ILTSupportMap&)sB, &cold);
+			nColdIterations += cold.m_Iterations;
+		}
+
+		timer.Start();
+		for (uint32 i = 0; i < pairs.size(); i++)
+		{
+			SA sA = MakeA(pairs[i]);
+			SB sB = MakeB(pairs[i]);
+			LTVector3f a, b;
+			fDistSum -= GJK_ClosestPoints(a, b, sA, sB, &pairs[i].m_Cache);
+			nWarmIterations += pairs[i].m_Cache.m_Iterations;
+		}
+		fWarmMS += timer.GetMS();
+	}
+
+	uint32 nQueries = (uint32)pairs.size() * BENCH_FRAMES;
+	printf("  %-20s cold %7.1f ns %5.2f it, warm %7.1f ns %5.2f it, distance diff %g\n", pName,
+		fColdMS * 1000000.0 / nQueries, (double)nColdIterations / nQueries,
+		fWarmMS * 1000000.0 / nQueries, (double)nWarmIterations / nQueries,
+		fDistSum / nQueries);
+}
+
+
+static LTBoxSupportMap MakeBoxA(const BenchPair &p) { return LTBoxSupportMap(p.m_PosA, p.m_BasisA, p.m_DimA); }
+static LTBoxSupportMap MakeBoxB(const BenchPair &p) { return LTBoxSupportMap(p.m_PosB, p.m_BasisB, p.m_DimB); }
+static LTCylinderSupportMap MakeCylinderA(const BenchPair &p) { return LTCylinderSupportMap(p.m_PosA, p.m_BasisA, p.m_DimA.x, p.m_DimA.y); }
+static LTCylinderSupportMap MakeCylinderB(const BenchPair &p) { return LTCylinderSupportMap(p.m_PosB, p.m_BasisB, p.m_DimB.x, p.m_DimB.y); }
+
+
+int main(int argc, char **argv)
+{
+	uint32 nPairs = (argc > 1) ? (uint32)atoi(argv[1]) : 200;
+
+	// Each pair sits a little apart along a random direction
+	std::vector<BenchPair> pairs(nPairs);
+	for (uint32 i = 0; i < nPairs; i++)
+	{
+		BenchPair &p = pairs[i];
+		p.m_DimA = LTVector3f(RandFloat(0.3f, 1.5f), RandFloat(0.3f, 1.5f), RandFloat(0.3f, 1.5f));
+		p.m_DimB = LTVector3f(RandFloat(0.3f, 1.5f), RandFloat(0.3f, 1.5f), RandFloat(0.3f, 1.5f));
+		p.m_BasisA = LTBasis(RandFloat(-3.0f, 3.0f), RandFloat(-3.0f, 3.0f), RandFloat(-3.0f, 3.0f));
+		p.m_BasisB = LTBasis(RandFloat(-3.0f, 3.0f), RandFloat(-3.0f, 3.0f), RandFloat(-3.0f, 3.0f));
+
+		LTVector3f vDir(RandFloat(-1.0f, 1.0f), RandFloat(-1.0f, 1.0f), RandFloat(-1.0f, 1.0f));
+		vDir.Normalize();
+		p.m_PosA = LTVector3f(0, 0, 0);
+		p.m_PosB = vDir * (p.m_DimA.Length() + p.m_DimB.Length() + RandFloat(0.01f, 0.1f));
+	}
+
+	printf("%u pairs, %u frames\n", nPairs, BENCH_FRAMES);
+
+	RunPairs("box / box", pairs, MakeBoxA, MakeBoxB);
+
+	for (uint32 i = 0; i < nPairs; i++)
+		pairs[i].m_Cache = LTGJKCache();
+	RunPairs("cylinder / box", pairs, MakeCylinderA, MakeBoxB);
+
+	for (uint32 i = 0; i < nPairs; i++)
+		pairs[i].m_Cache = LTGJKCache();
+	RunPairs("cylinder / cylinder", pairs, MakeCylinderA, MakeCylinderB);
+
+	return 0;
+}
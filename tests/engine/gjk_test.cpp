@@ -0,0 +1,272 @@
+// GJK closest points: warm-started queries on jittering box and cylinder
+// pairs, and queries from a cache left by other pairs, return distances that
+// are certified by their own closest points, overlapping shapes report no
+// distance, and warm starts take fewer iterations than cold ones.
+
+#include "ltbasedefs.h"
+#include "collision_object.h"
+#include "ltjs_test.h"
+
+#include <stdlib.h>
+
+
+static float RandFloat(float fMin, float fMax)
+{
+	return fMin + (fMax - fMin) * (float)rand() / (float)RAND_MAX;
+}
+
+
+static LTVector3f RandDir()
+{
+	LTVector3f v(RandFloat(-1.0f, 1.0f), RandFloat(-1.0f, 1.0f), RandFloat(-1.0f, 1.0f));
+	float fLength = v.Length();
+	return (fLength > 0.01f) ? v / fLength : LTVector3f(1, 0, 0);
+}
+
+
+// Farthest point of the shape along a parent frame direction.
+static LTVector3f Support(ILTSupportMap &s, const LTVector3f &n)
+{
+	return s.TransformPointToParent(s(s.TransformVectorToLocal(n)));
+}
+
+
+static bool InBox(const LTBoxSupportMap &s, const LTVector3f &vDim, const LTVector3f &p, float fTol)
+{
+	LTVector3f l = s.TransformPointToLocal(p);
+	return fabsf(l.x) <= vDim.x + fTol && fabsf(l.y) <= vDim.y + fTol && fabsf(l.z) <= vDim.z + fTol;
+}
+
+
+static bool InCylinder(const LTCylinderSupportMap &s, float fRadius, float fHHeight, const LTVector3f &p, float fTol)
+{
+	LTVector3f l = s.TransformPointToLocal(p);
+	return sqrtf(l.x * l.x + l.z * l.z) <= fRadius + fTol && fabsf(l.y) <= fHHeight + fTol;
+}
+
+
+// A distance is right if the points are that far apart and no closer than
+// the gap the shapes leave along the line between them.
+static bool IsClosest(float fDist, const LTVector3f &a, const LTVector3f &b, ILTSupportMap &sA, ILTSupportMap &sB)
+{
+	const float fTol = 1e-3f * (1.0f + fDist);
+
+	if (fDist <= 0.0f || fabsf((b - a).Length() - fDist) > fTol)
+		return false;
+
+	LTVector3f n = (b - a) / fDist;
+	float fGap = n.Dot(Support(sB, -n)) - n.Dot(Support(sA, n));
+
+	return fDist - fGap <= fTol;
+}
+
+
+// One shape of each kind, size and orientation picked per pair.
+struct Shape
+{
+	LTVector3f	m_Pos;
+	float		m_Pitch, m_Yaw, m_Roll;
+	LTVector3f	m_Dim;
+
+	void Randomize()
+	{
+		m_Pos = LTVector3f(0, 0, 0);
+		m_Pitch = RandFloat(-3.0f, 3.0f);
+		m_Yaw = RandFloat(-3.0f, 3.0f);
+		m_Roll = RandFloat(-3.0f, 3.0f);
+		m_Dim = LTVector3f(RandFloat(0.2f, 1.5f), RandFloat(0.2f, 1.5f), RandFloat(0.2f, 1.5f));
+	}
+
+	// Radius of a sphere around the shape, box or cylinder
+	float BoxRadius() const { return m_Dim.Length(); }
+	float CylinderRadius() const { return sqrtf(m_Dim.x * m_Dim.x + m_Dim.y * m_Dim.y); }
+
+	LTBasis Basis() const { return LTBasis(m_Pitch, m_Yaw, m_Roll); }
+};
+
+
+enum EPairType
+{
+	PAIR_BOX_BOX,
+	PAIR_CYLINDER_BOX,
+	PAIR_CYLINDER_CYLINDER,
+	PAIR_SPHERE_CYLINDER,
+	NUM_PAIR_TYPES
+};
+
+
+// Runs the query for the pair through the concrete support map overload and
+// checks the result.  Returns the iterations it took.
+static int32 Query(EPairType eType, const Shape &A, const Shape &B, LTGJKCache *pCache, bool bSeparated, bool &bOK)
+{
+	LTVector3f a, b;
+	float fDist;
+
+	switch (eType)
+	{
+		case PAIR_BOX_BOX:
+		{
+			LTBoxSupportMap sA(A.m_Pos, A.Basis(), A.m_Dim), sB(B.m_Pos, B.Basis(), B.m_Dim);
+			fDist = GJK_ClosestPoints(a, b, sA, sB, pCache);
+			bOK = bSeparated ? IsClosest(fDist, a, b, sA, sB) && InBox(sA, A.m_Dim, a, 1e-3f) && InBox(sB, B.m_Dim, b, 1e-3f) : fDist <= 1e-5f;
+		}
+		break;
+
+		case PAIR_CYLINDER_BOX:
+		{
+			LTCylinderSupportMap sA(A.m_Pos, A.Basis(), A.m_Dim.x, A.m_Dim.y);
+			LTBoxSupportMap sB(B.m_Pos, B.Basis(), B.m_Dim);
+			fDist = GJK_ClosestPoints(a, b, sA, sB, pCache);
+			bOK = bSeparated ? IsClosest(fDist, a, b, sA, sB) && InCylinder(sA, A.m_Dim.x, A.m_Dim.y, a, 1e-3f) && InBox(sB, B.m_Dim, b, 1e-3f) : fDist <= 1e-5f;
+		}
+		break;
+
+		case PAIR_CYLINDER_CYLINDER:
+		{
+			LTCylinderSupportMap sA(A.m_Pos, A.Basis(), A.m_Dim.x, A.m_Dim.y);
+			LTCylinderSupportMap sB(B.m_Pos, B.Basis(), B.m_Dim.x, B.m_Dim.y);
+			fDist = GJK_ClosestPoints(a, b, sA, sB, pCache);
+			bOK = bSeparated ? IsClosest(fDist, a, b, sA, sB) && InCylinder(sA, A.m_Dim.x, A.m_Dim.y, a, 1e-3f) && InCylinder(sB, B.m_Dim.x, B.m_Dim.y, b, 1e-3f) : fDist <= 1e-5f;
+		}
+		break;
+
+		default:
+		{
+			LTSphereSupportMap sA(A.m_Pos, A.m_Dim.x);
+			LTCylinderSupportMap sB(B.m_Pos, B.Basis(), B.m_Dim.x, B.m_Dim.y);
+			fDist = GJK_ClosestPoints(a, b, sA, sB, pCache);
+			bOK = bSeparated ? IsClosest(fDist, a, b, sA, sB) && (a - A.m_Pos).Length() <= A.m_Dim.x + 1e-3f && InCylinder(sB, B.m_Dim.x, B.m_Dim.y, b, 1e-3f) : fDist <= 1e-5f;
+		}
+		break;
+	}
+
+	return pCache->m_Iterations;
+}
+
+
+static float BoundingRadius(EPairType eType, const Shape &s, bool bFirst)
+{
+	if (eType == PAIR_BOX_BOX || (eType == PAIR_CYLINDER_BOX && !bFirst))
+		return s.BoxRadius();
+	if (eType == PAIR_SPHERE_CYLINDER && bFirst)
+		return s.m_Dim.x;
+	return s.CylinderRadius();
+}
+
+
+// Places B a random gap away from A, past both bounding spheres.
+static void Separate(EPairType eType, const Shape &A, Shape &B)
+{
+	float fCenters = BoundingRadius(eType, A, true) + BoundingRadius(eType, B, false) + RandFloat(0.01f, 2.0f);
+	B.m_Pos = A.m_Pos + RandDir() * fCenters;
+}
+
+
+// Pairs that drift and turn a little each frame, queried once with a cache
+// of their own and once with a cache last used by some other pair.
+static void CheckJitteringPairs()
+{
+	uint32 nWrong = 0, nForeignWrong = 0;
+	int32 nWarmIterations = 0, nColdIterations = 0;
+	LTGJKCache foreign;
+
+	srand(1);
+	for (uint32 nPair = 0; nPair < 400; nPair++)
+	{
+		EPairType eType = (EPairType)(nPair % NUM_PAIR_TYPES);
+		Shape A, B;
+		A.Randomize();
+		B.Randomize();
+		Separate(eType, A, B);
+
+		LTGJKCache warm;
+		for (uint32 nFrame = 0; nFrame < 50; nFrame++)
+		{
+			A.m_Yaw += 0.002f;
+			A.m_Pos += (B.m_Pos - A.m_Pos) * RandFloat(-0.0005f, 0.0005f);
+
+			bool bOK;
+			int32 nWarm = Query(eType, A, B, &warm, true, bOK);
+			nWrong += !bOK;
+
+			LTGJKCache cold;
+			int32 nCold = Query(eType, A, B, &cold, true, bOK);
+			nWrong += !bOK;
+
+			Query(eType, A, B, &foreign, true, bOK);
+			nForeignWrong += !bOK;
+
+			if (nFrame > 0)
+			{
+				nWarmIterations += nWarm;
+				nColdIterations += nCold;
+			}
+		}
+	}
+
+	LTJS_CHECK(nWrong == 0);
+	LTJS_CHECK(nForeignWrong == 0);
+	LTJS_CHECK(nWarmIterations * 2 < nColdIterations);
+}
+
+
+// Shapes around the same center always touch, warm or cold.
+static void CheckOverlapping()
+{
+	uint32 nWrong = 0;
+
+	for (uint32 nPair = 0; nPair < 400; nPair++)
+	{
+		EPairType eType = (EPairType)(nPair % NUM_PAIR_TYPES);
+		Shape A, B;
+		A.Randomize();
+		B.Randomize();
+		B.m_Pos = A.m_Pos + RandDir() * 0.1f;
+
+		LTGJKCache cache;
+		for (uint32 nFrame = 0; nFrame < 3; nFrame++)
+		{
+			bool bOK;
+			Query(eType, A, B, &cache, false, bOK);
+			nWrong += !bOK;
+		}
+
+		// A cache from when they were apart
+		Separate(eType, A, B);
+		bool bOK;
+		Query(eType, A, B, &cache, true, bOK);
+		B.m_Pos = A.m_Pos;
+		Query(eType, A, B, &cache, false, bOK);
+		nWrong += !bOK;
+	}
+
+	LTJS_CHECK(nWrong == 0);
+}
+
+
+static void CheckPairCache()
+{
+	LTGJKPairCache pairs;
+	HOBJECT hA = (HOBJECT)(size_t)0x1000, hB = (HOBJECT)(size_t)0x2000;
+
+	LTJS_CHECK(pairs.Find(hA, LTNULL) == LTNULL);
+	LTJS_CHECK(pairs.Find(LTNULL, hB) == LTNULL);
+
+	LTGJKCache *pCache = pairs.Find(hA, hB);
+	LTJS_CHECK(pCache != LTNULL);
+	pCache->m_Count = 2;
+	LTJS_CHECK(pairs.Find(hA, hB) == pCache && pCache->m_Count == 2);
+
+	pairs.Clear();
+	LTJS_CHECK(pairs.Find(hA, hB)->m_Count == 0);
+}
+
+
+int main()
+{
+	CheckJitteringPairs();
+	CheckOverlapping();
+	CheckPairCache();
+
+	return LTJS_TEST_RESULT();
+}
@@ -0,0 +1,340 @@
+// Server object query benchmark.  Finds the models in random spheres and boxes
+// of a WorldTree full of objects the way the server's queries do.  The list
+// queries (FindObjectsTouchingSphere, GetBoxIntersecters) link every object
+// they touch out of a struct bank and the caller skips the ones it doesn't want
+// and gives the list back.  The array queries (FindObjectsInSphere,
+// FindObjectsInBox) filter in the tree callback, test the sphere candidates in
+// batches of 16, four at a time, and write handles into the caller's array.
+// The server code needs the whole server, so the callbacks are copied here
+// with bench objects in place of LTObject.
+//
+//   objectquery_bench [objects] [queries]
+
+#include "bdefs.h"
+#include "world_tree_layout.h"
+#include "struct_bank.h"
+#include "ltjs_test.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define BENCH_SSE2
+#include <emmintrin.h>
+#endif
+
+
+#define BENCH_BATCH_SIZE	16
+#define BENCH_ARRAY_SIZE	256
+
+
+class CBenchObj : public WorldTreeObj
+{
+public:
+
+	CBenchObj() : WorldTreeObj(WTObj_DObject), m_Radius(0.0f), m_ObjectType(0), m_Flags(0) {}
+
+	LTVector	m_Pos;
+	float		m_Radius;
+	uint32		m_ObjectType;
+	uint32		m_Flags;
+};
+
+
+struct BenchLink
+{
+	CBenchObj	*m_pObj;
+	BenchLink	*m_pNext;
+};
+
+struct BenchList
+{
+	BenchLink	*m_pFirstLink;
+	uint32		m_nInList;
+};
+
+static StructBank s_LinkBank;
+static StructBank s_ListBank;
+
+
+struct ListFindStruct
+{
+	BenchList		*m_pList;
+	LTVector		m_vPos;
+	float			m_fRadius;
+	bool			m_bSphere;
+};
+
+// SphereFindCallback and BoxFindCallback
+static void ListFindCallback(WorldTreeObj *pObj, void *pCBUser)
+{
+	if (pObj->GetObjType() != WTObj_DObject)
+		return;
+
+	ListFindStruct *pStruct = (ListFindStruct*)pCBUser;
+	CBenchObj *pBenchObj = (CBenchObj*)pObj;
+
+	if (pStruct->m_bSphere)
+	{
+		float fFullRadius = pBenchObj->m_Radius + pStruct->m_fRadius;
+		if ((pBenchObj->m_Pos - pStruct->m_vPos).MagSqr() >= fFullRadius * fFullRadius)
+			return;
+	}
+
+	BenchLink *pLink = (BenchLink*)sb_Allocate(&s_LinkBank);
+	if (!pLink)
+		return;
+
+	pLink->m_pObj = pBenchObj;
+	pLink->m_pNext = pStruct->m_pList->m_pFirstLink;
+	pStruct->m_pList->m_pFirstLink = pLink;
+	++pStruct->m_pList->m_nInList;
+}
+
+// A list query and the caller picking the models out of it
+static uint32 FindModelsList(WorldTree &tree, const LTVector &vMin, const LTVector &vMax, const LTVector &vPos, float fRadius,
+	bool bSphere, CBenchObj **pFound)
+{
+	ListFindStruct theStruct;
+	theStruct.m_pList = (BenchList*)sb_Allocate(&s_ListBank);
+	theStruct.m_pList->m_pFirstLink = NULL;
+	theStruct.m_pList->m_nInList = 0;
+	theStruct.m_vPos = vPos;
+	theStruct.m_fRadius = fRadius;
+	theStruct.m_bSphere = bSphere;
+
+	tree.FindObjectsInBox(&vMin, &vMax, ListFindCallback, &theStruct);
+
+	uint32 nFound = 0;
+	BenchLink *pLink = theStruct.m_pList->m_pFirstLink;
+	while (pLink)
+	{
+		if ((pLink->m_pObj->m_ObjectType == OT_MODEL) && (nFound < BENCH_ARRAY_SIZE))
+			pFound[nFound++] = pLink->m_pObj;
+
+		BenchLink *pNext = pLink->m_pNext;
+		sb_Free(&s_LinkBank, pLink);
+		pLink = pNext;
+	}
+	sb_Free(&s_ListBank, theStruct.m_pList);
+
+	return nFound;
+}
+
+
+struct ArrayFindStruct
+{
+	CBenchObj		**m_pFound;
+	uint32			m_nFound;
+	uint32			m_nTypeMask;
+	uint32			m_nFlags;
+	LTVector		m_vPos;
+	float			m_fRadius;
+	CBenchObj		*m_pBatch[BENCH_BATCH_SIZE];
+	uint32			m_nBatch;
+};
+
+// ObjArrayFindFilter
+inline bool ArrayFindFilter(const ArrayFindStruct *pStruct, const CBenchObj *pObj)
+{
+	if (!(pStruct->m_nTypeMask & OBJTYPE_MASK(pObj->m_ObjectType)))
+		return false;
+
+	return (pObj->m_Flags & pStruct->m_nFlags) == pStruct->m_nFlags;
+}
+
+inline void ArrayFindAdd(ArrayFindStruct *pStruct, CBenchObj *pObj)
+{
+	if (pStruct->m_nFound < BENCH_ARRAY_SIZE)
+		pStruct->m_pFound[pStruct->m_nFound++] = pObj;
+}
+
+// ObjArrayFlushSphereBatch
+static void ArrayFlushSphereBatch(ArrayFindStruct *pStruct)
+{
+	uint32 nBatch = pStruct->m_nBatch;
+	uint32 i = 0;
+
+#ifdef BENCH_SSE2
+	const __m128 vSphereX = _mm_set1_ps(pStruct->m_vPos.x);
+	const __m128 vSphereY = _mm_set1_ps(pStruct->m_vPos.y);
+	const __m128 vSphereZ = _mm_set1_ps(pStruct->m_vPos.z);
+	const __m128 vSphereRadius = _mm_set1_ps(pStruct->m_fRadius);
+
+	for (; (i + 4) <= nBatch; i += 4)
+	{
+		CBenchObj **ppObj = &pStruct->m_pBatch[i];
+
+		__m128 vX = _mm_setr_ps(ppObj[0]->m_Pos.x, ppObj[1]->m_Pos.x, ppObj[2]->m_Pos.x, ppObj[3]->m_Pos.x);
+		__m128 vY = _mm_setr_ps(ppObj[0]->m_Pos.y, ppObj[1]->m_Pos.y, ppObj[2]->m_Pos.y, ppObj[3]->m_Pos.y);
+		__m128 vZ = _mm_setr_ps(ppObj[0]->m_Pos.z, ppObj[1]->m_Pos.z, ppObj[2]->m_Pos.z, ppObj[3]->m_Pos.z);
+		__m128 vRadius = _mm_setr_ps(ppObj[0]->m_Radius, ppObj[1]->m_Radius, ppObj[2]->m_Radius, ppObj[3]->m_Radius);
+
+		vX = _mm_sub_ps(vX, vSphereX);
+		vY = _mm_sub_ps(vY, vSphereY);
+		vZ = _mm_sub_ps(vZ, vSphereZ);
+		__m128 vDistSqr = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vX, vX), _mm_mul_ps(vY, vY)), _mm_mul_ps(vZ, vZ));
+
+		vRadius = _mm_add_ps(vRadius, vSphereRadius);
+		int nMask = _mm_movemask_ps(_mm_cmplt_ps(vDistSqr, _mm_mul_ps(vRadius, vRadius)));
+
+		for (uint32 j = 0; j < 4; j++)
+		{
+			if (nMask & (1 << j))
+				ArrayFindAdd(pStruct, ppObj[j]);
+		}
+	}
+#endif
+
+	for (; i < nBatch; i++)
+	{
+		CBenchObj *pObj = pStruct->m_pBatch[i];
+		float fFullRadius = pObj->m_Radius + pStruct->m_fRadius;
+
+		if ((pObj->m_Pos - pStruct->m_vPos).MagSqr() < fFullRadius * fFullRadius)
+			ArrayFindAdd(pStruct, pObj);
+	}
+
+	pStruct->m_nBatch = 0;
+}
+
+// ObjArraySphereFindCallback
+static void ArraySphereFindCallback(WorldTreeObj *pObj, void *pCBUser)
+{
+	if (pObj->GetObjType() != WTObj_DObject)
+		return;
+
+	ArrayFindStruct *pStruct = (ArrayFindStruct*)pCBUser;
+	CBenchObj *pBenchObj = (CBenchObj*)pObj;
+
+	if (!ArrayFindFilter(pStruct, pBenchObj))
+		return;
+
+	pStruct->m_pBatch[pStruct->m_nBatch++] = pBenchObj;
+	if (pStruct->m_nBatch == BENCH_BATCH_SIZE)
+		ArrayFlushSphereBatch(pStruct);
+}
+
+// ObjArrayBoxFindCallback
+static void ArrayBoxFindCallback(WorldTreeObj *pObj, void *pCBUser)
+{
+	if (pObj->GetObjType() != WTObj_DObject)
+		return;
+
+	ArrayFindStruct *pStruct = (ArrayFindStruct*)pCBUser;
+	CBenchObj *pBenchObj = (CBenchObj*)pObj;
+
+	if (ArrayFindFilter(pStruct, pBenchObj))
+		ArrayFindAdd(pStruct, pBenchObj);
+}
+
+static uint32 FindModelsArray(WorldTree &tree, const LTVector &vMin, const LTVector &vMax, const LTVector &vPos, float fRadius,
+	bool bSphere, CBenchObj **pFound)
+{
+	ArrayFindStruct theStruct;
+	theStruct.m_pFound = pFound;
+	theStruct.m_nFound = 0;
+	theStruct.m_nTypeMask = OBJTYPE_MASK(OT_MODEL);
+	theStruct.m_nFlags = 0;
+	theStruct.m_vPos = vPos;
+	theStruct.m_fRadius = fRadius;
+	theStruct.m_nBatch = 0;
+
+	if (bSphere)
+	{
+		tree.FindObjectsInBox(&vMin, &vMax, ArraySphereFindCallback, &theStruct);
+		ArrayFlushSphereBatch(&theStruct);
+	}
+	else
+	{
+		tree.FindObjectsInBox(&vMin, &vMax, ArrayBoxFindCallback, &theStruct);
+	}
+
+	return theStruct.m_nFound;
+}
+
+
+static float RandFloat(float fMax)
+{
+	return fMax * (float)rand() / (float)RAND_MAX;
+}
+
+
+static void RunQueries(WorldTree &tree, uint32 nQueries, float fRadius, bool bSphere)
+{
+	std::vector<LTVector> queryPos(nQueries);
+	for (uint32 i = 0; i < nQueries; i++)
+		queryPos[i].Init(RandFloat(1024.0f), 50.0f, RandFloat(1024.0f));
+
+	CBenchObj *pFound[BENCH_ARRAY_SIZE];
+	const LTVector vExtents(fRadius, fRadius, fRadius);
+	uint32 nFound[2] = { 0, 0 };
+	double fMS[2];
+	CBenchTimer timer;
+
+	for (uint32 nMode = 0; nMode < 2; nMode++)
+	{
+		timer.Start();
+		for (uint32 i = 0; i < nQueries; i++)
+		{
+			LTVector vMin = queryPos[i] - vExtents;
+			LTVector vMax = queryPos[i] + vExtents;
+
+			if (nMode == 0)
+				nFound[nMode] += FindModelsList(tree, vMin, vMax, queryPos[i], fRadius, bSphere, pFound);
+			else
+				nFound[nMode] += FindModelsArray(tree, vMin, vMax, queryPos[i], fRadius, bSphere, pFound);
+		}
+		fMS[nMode] = timer.GetMS();
+	}
+
+	printf("  %-6s r %-5.0f %5.1f models  list %7.0f ns  array %7.0f ns%s\n", bSphere ? "sphere" : "box", fRadius,
+		(double)nFound[1] / nQueries, fMS[0] * 1000000.0 / nQueries, fMS[1] * 1000000.0 / nQueries,
+		(nFound[0] == nFound[1]) ? "" : "  (found counts differ)");
+}
+
+
+int main(int argc, char **argv)
+{
+	uint32 nObjects = (argc > 1) ? (uint32)atoi(argv[1]) : 2000;
+	uint32 nQueries = (argc > 2) ? (uint32)atoi(argv[2]) : 20000;
+
+	sb_Init(&s_LinkBank, sizeof(BenchLink), 256);
+	sb_Init(&s_ListBank, sizeof(BenchList), 16);
+
+	CTestTreeHelper helper;
+	WorldTree tree;
+	tree.InitWorldTree(&helper);
+	LoadTestLayout(tree, 5);
+
+	// A third of the objects are models, the rest are world models, lights,
+	// sounds and such that the model queries skip
+	std::vector<CBenchObj> objs(nObjects);
+	srand(1);
+	for (uint32 i = 0; i < nObjects; i++)
+	{
+		CBenchObj &obj = objs[i];
+		obj.m_Pos.Init(RandFloat(1024.0f), RandFloat(100.0f), RandFloat(1024.0f));
+		obj.m_Radius = 8.0f + RandFloat(24.0f);
+		obj.m_ObjectType = ((i % 3) == 0) ? OT_MODEL : (((i % 3) == 1) ? OT_NORMAL : OT_WORLDMODEL);
+
+		LTVector vDims(obj.m_Radius, obj.m_Radius, obj.m_Radius);
+		obj.UpdateBBox(obj.m_Pos, vDims);
+		tree.InsertObject2(&obj, obj.GetBBoxMin(), obj.GetBBoxMax());
+	}
+
+	printf("%u objects, %u queries\n", nObjects, nQueries);
+	RunQueries(tree, nQueries, 64.0f, true);
+	RunQueries(tree, nQueries, 256.0f, true);
+	RunQueries(tree, nQueries, 64.0f, false);
+	RunQueries(tree, nQueries, 256.0f, false);
+
+	for (uint32 i = 0; i < nObjects; i++)
+		objs[i].RemoveFromWorldTree();
+
+	sb_Term(&s_LinkBank);
+	sb_Term(&s_ListBank);
+
+	return 0;
+}
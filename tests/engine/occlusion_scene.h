@@ -0,0 +1,197 @@
+// Random occluder scenes for the occlusion buffer test and benchmark.  The
+// camera sits at the origin looking down +Z at a 640x480 screen, and the
+// occluders are convex polygons in random planes in front of it.
+
+#ifndef __OCCLUSION_SCENE_H__
+#define __OCCLUSION_SCENE_H__
+
+#include "d3d_renderworld_occlusionbuffer.h"
+#include "d3d_viewparams.h"
+
+#include <math.h>
+#include <random>
+#include <vector>
+
+#define SCENE_SCREEN_WIDTH	640.0f
+#define SCENE_SCREEN_HEIGHT	480.0f
+#define SCENE_FOCAL			320.0f
+
+
+struct SceneOccluder
+{
+	COccludee::COutline	m_cOutline;
+	std::vector<LTVector> m_aVerts;
+	LTVector	m_vNormal;
+	float		m_fDist;
+};
+
+class COcclusionScene
+{
+public:
+
+	COcclusionScene(uint32 nSeed) :
+		m_Params(),
+		m_Random(nSeed)
+	{
+		m_Params.m_Rect = LTRect(0, 0, (int)SCENE_SCREEN_WIDTH, (int)SCENE_SCREEN_HEIGHT);
+		m_Params.m_fScreenWidth = SCENE_SCREEN_WIDTH;
+		m_Params.m_fScreenHeight = SCENE_SCREEN_HEIGHT;
+
+		// x = f * x / z + w / 2, y = -f * y / z + h / 2, w = z
+		m_Params.m_FullTransform.Init(
+			SCENE_FOCAL, 0.0f, SCENE_SCREEN_WIDTH * 0.5f, 0.0f,
+			0.0f, -SCENE_FOCAL, SCENE_SCREEN_HEIGHT * 0.5f, 0.0f,
+			0.0f, 0.0f, 1.0f, 0.0f,
+			0.0f, 0.0f, 1.0f, 0.0f);
+
+		// The frustum the clipping occluders need, with the near plane at z = 1
+		float fHalfX = SCENE_SCREEN_WIDTH * 0.5f / SCENE_FOCAL;
+		float fHalfY = SCENE_SCREEN_HEIGHT * 0.5f / SCENE_FOCAL;
+		m_Params.m_NearZ = 1.0f;
+		m_Params.m_FarZ = 5000.0f;
+		m_Params.m_ViewPoints[0].Init(-fHalfX, fHalfY, 1.0f);
+		m_Params.m_ViewPoints[1].Init(fHalfX, fHalfY, 1.0f);
+		m_Params.m_ViewPoints[2].Init(-fHalfX, -fHalfY, 1.0f);
+		m_Params.m_ViewPoints[3].Init(fHalfX, -fHalfY, 1.0f);
+		m_Params.m_ClipPlanes[CPLANE_NEAR_INDEX].Init(LTVector(0.0f, 0.0f, 1.0f), 1.0f);
+	}
+
+	float Rand(float fMin, float fMax)
+	{
+		return std::uniform_real_distribution<float>(fMin, fMax)(m_Random);
+	}
+
+	uint32 RandInt(uint32 nMax)
+	{
+		return m_Random() % nMax;
+	}
+
+	// Fill the buffer with nOccluders random polygons
+	void Build(COcclusionBuffer & cBuffer, uint32 nOccluders)
+	{
+		m_aOccluders.clear();
+		cBuffer.Init(m_Params);
+
+		while (m_aOccluders.size() < nOccluders)
+		{
+			LTVector vCenter(Rand(-300.0f, 300.0f), Rand(-200.0f, 200.0f), Rand(50.0f, 1500.0f));
+			LTVector vAxisA(Rand(-1.0f, 1.0f), Rand(-1.0f, 1.0f), Rand(-1.0f, 1.0f));
+			LTVector vAxisB(Rand(-1.0f, 1.0f), Rand(-1.0f, 1.0f), Rand(-1.0f, 1.0f));
+			vAxisA.Normalize();
+			vAxisB = vAxisB - vAxisA * vAxisA.Dot(vAxisB);
+			vAxisB.Normalize();
+
+			uint32 nVerts = 3 + RandInt(6);
+			float fRadius = Rand(20.0f, 400.0f);
+
+			SceneOccluder cOccluder;
+			bool bInFront = true;
+			for (uint32 nVert = 0; nVert < nVerts; ++nVert)
+			{
+				float fAngle = 6.2831853f * (float)nVert / (float)nVerts;
+				LTVector vPt = vCenter + vAxisA * (fRadius * cosf(fAngle)) + vAxisB * (fRadius * sinf(fAngle));
+				bInFront = bInFront && (vPt.z >= 1.0f);
+				cOccluder.m_aVerts.push_back(vPt);
+				cOccluder.m_cOutline.push_back(vPt);
+			}
+
+			// The renderer clips occluders to the near plane first
+			if (!bInFront)
+				continue;
+
+			cOccluder.m_vNormal = vAxisA.Cross(vAxisB);
+			cOccluder.m_fDist = cOccluder.m_vNormal.Dot(vCenter);
+			m_aOccluders.push_back(cOccluder);
+
+			cBuffer.AddOccluder(cOccluder.m_cOutline);
+		}
+
+		cBuffer.Finish();
+	}
+
+	// A random box in front of the camera
+	void RandomBox(LTVector & vMin, LTVector & vMax)
+	{
+		LTVector vCenter(Rand(-400.0f, 400.0f), Rand(-300.0f, 300.0f), Rand(61.0f, 2500.0f));
+		LTVector vExtents(Rand(1.0f, 60.0f), Rand(1.0f, 60.0f), Rand(1.0f, 60.0f));
+		vMin = vCenter - vExtents;
+		vMax = vCenter + vExtents;
+	}
+
+	// Is the point on the screen and not behind any occluder?
+	bool IsPointVisible(const LTVector & vPt) const
+	{
+		float fX = SCENE_FOCAL * vPt.x / vPt.z + SCENE_SCREEN_WIDTH * 0.5f;
+		float fY = -SCENE_FOCAL * vPt.y / vPt.z + SCENE_SCREEN_HEIGHT * 0.5f;
+		if ((fX < 0.0f) || (fX > SCENE_SCREEN_WIDTH) || (fY < 0.0f) || (fY > SCENE_SCREEN_HEIGHT))
+			return false;
+
+		for (size_t i = 0; i < m_aOccluders.size(); ++i)
+		{
+			if (RayHits(m_aOccluders[i], vPt))
+				return false;
+		}
+
+		return true;
+	}
+
+	// Does any of nSamples points on and in the box show?
+	bool IsBoxVisible(const LTVector & vMin, const LTVector & vMax, uint32 nSamples)
+	{
+		for (uint32 nSample = 0; nSample < nSamples; ++nSample)
+		{
+			LTVector vPt(Rand(vMin.x, vMax.x), Rand(vMin.y, vMax.y), Rand(vMin.z, vMax.z));
+
+			// Push a third of the points onto a face
+			if ((nSample % 3) == 0)
+			{
+				uint32 nAxis = RandInt(3);
+				vPt[nAxis] = RandInt(2) ? vMax[nAxis] : vMin[nAxis];
+			}
+
+			if (IsPointVisible(vPt))
+				return true;
+		}
+
+		return false;
+	}
+
+	ViewParams	m_Params;
+	std::vector<SceneOccluder> m_aOccluders;
+
+private:
+
+	// Does the ray from the eye to the point go through the occluder before the point?
+	static bool RayHits(const SceneOccluder & cOccluder, const LTVector & vPt)
+	{
+		float fDot = cOccluder.m_vNormal.Dot(vPt);
+		if (fabsf(fDot) < 1.0e-9f)
+			return false;
+
+		float fT = cOccluder.m_fDist / fDot;
+		if ((fT <= 0.0f) || (fT >= 1.0f))
+			return false;
+
+		LTVector vHit = vPt * fT;
+		size_t nVerts = cOccluder.m_aVerts.size();
+		int nSide = 0;
+		for (size_t i = 0; i < nVerts; ++i)
+		{
+			LTVector vEdge = cOccluder.m_aVerts[(i + 1) % nVerts] - cOccluder.m_aVerts[i];
+			float fSide = vEdge.Cross(vHit - cOccluder.m_aVerts[i]).Dot(cOccluder.m_vNormal);
+			int nCurSide = (fSide > 0.0f) ? 1 : ((fSide < 0.0f) ? -1 : 0);
+			if (!nCurSide)
+				continue;
+			if (!nSide)
+				nSide = nCurSide;
+			else if (nCurSide != nSide)
+				return false;
+		}
+
+		return true;
+	}
+
+	std::mt19937	m_Random;
+};
+
+#endif  // __OCCLUSION_SCENE_H__
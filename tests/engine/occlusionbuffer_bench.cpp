@@ -0,0 +1,182 @@
+// Occlusion buffer benchmark.  Builds the buffer for random occluder scenes and
+// tests random boxes against it, reporting how many boxes it culls next to how
+// many a dense ray cast finds hidden, and how long building and testing take.
+// The same scenes also go through the screen space clipping occluders the
+// buffer replaced, built and tested the way CD3D_RenderWorld does.
+//
+//   occlusionbuffer_bench [scenes] [occluders per scene] [boxes per scene]
+
+#include "bdefs.h"
+#include "occlusion_scene.h"
+#include "d3d_convar.h"
+#include "ltjs_test.h"
+
+#include <algorithm>
+#include <stdlib.h>
+
+
+// Referenced by d3d_renderworld_occluder.cpp.
+BaseConVar *g_pConVars = NULL;
+ConVar<int> g_CV_DebugRBOldOccludeeShape("DebugRBOldOccludeeShape", 0);
+ConVar<int> g_CV_DebugRBFindSlivers("DebugRBFindSlivers", 0);
+void dsi_PrintToConsole(const char *pMsg, ...) {}
+
+
+typedef std::vector<COccluder_2D> TOccluderList;
+
+static bool IsLargerOccluder(const COccluder_2D &cLeft, const COccluder_2D &cRight)
+{
+	return cLeft.m_fScreenArea > cRight.m_fScreenArea;
+}
+
+// CD3D_RenderWorld::GetFrameOccluders for the scene's occluders, which are
+// already in front of the near plane.
+static void BuildClipOccluders(const COcclusionScene &cScene, COccluder_Frustum &cFrustum, TOccluderList &aOccluders, float &fScreenArea)
+{
+	cFrustum.InitFrustum(cScene.m_Params);
+
+	aOccluders.clear();
+	fScreenArea = 0.0f;
+
+	for (size_t i = 0; i < cScene.m_aOccluders.size(); ++i)
+	{
+		const SceneOccluder &cOccluder = cScene.m_aOccluders[i];
+
+		// The scene's outlines wind the other way around their normal from the world's polys
+		aOccluders.resize(aOccluders.size() + 1);
+		aOccluders.back().InitOutline(cScene.m_Params, cOccluder.m_cOutline, LTPlane(-cOccluder.m_vNormal, -cOccluder.m_fDist));
+		fScreenArea += aOccluders.back().m_fScreenArea;
+	}
+
+	std::sort(aOccluders.begin(), aOccluders.end(), IsLargerOccluder);
+}
+
+// CD3D_RenderWorld::IsAABBVisible_Clip
+static bool IsAABBVisible_Clip(const COcclusionScene &cScene, const COccluder_Frustum &cFrustum, const TOccluderList &aOccluders,
+	float fScreenArea, COccludee &cOccludee, const LTVector &vMin, const LTVector &vMax, PolySide nBoxSide)
+{
+	cOccludee.Init();
+	cOccludee.InitAABB(cScene.m_Params, vMin, vMax, true);
+	if ((nBoxSide == Intersect) && (cFrustum.Occlude2D(cOccludee) == BackSide))
+		return true;
+
+	bool bVisible = true;
+
+	float fOccludeeArea = cOccludee.CalcArea2D(true);
+	float fOccluderAreaRemaining = fScreenArea;
+
+	TOccluderList::const_iterator iCurOccluder = aOccluders.begin();
+	for (; bVisible && (fOccluderAreaRemaining >= fOccludeeArea) && (iCurOccluder != aOccluders.end()); ++iCurOccluder)
+	{
+		cOccludee.m_aOccluded.clear();
+		cOccludee.m_aOccluded.swap(cOccludee.m_aVisible);
+		PolySide nResult = iCurOccluder->Occlude2D(cOccludee);
+		bVisible = nResult != BackSide;
+
+		if (nResult == Intersect)
+			fOccludeeArea -= cOccludee.CalcArea2D(false);
+		fOccluderAreaRemaining -= iCurOccluder->m_fScreenArea;
+	}
+
+	return bVisible;
+}
+
+
+int main(int argc, char** argv)
+{
+	uint32 nScenes = (argc > 1) ? (uint32)atoi(argv[1]) : 500;
+	uint32 nOccluders = (argc > 2) ? (uint32)atoi(argv[2]) : 8;
+	uint32 nBoxes = (argc > 3) ? (uint32)atoi(argv[3]) : 1000;
+
+	COcclusionScene cScene(7);
+	COcclusionBuffer cBuffer;
+
+	COccluder_Frustum cFrustum;
+	TOccluderList aClipOccluders;
+	COccludee cOccludee;
+	float fClipScreenArea = 0.0f;
+
+	std::vector<LTVector> aBoxes(nBoxes * 2);
+	std::vector<PolySide> aBoxSides(nBoxes);
+	std::vector<bool> aOccluded(nBoxes);
+	std::vector<bool> aClipOccluded(nBoxes);
+
+	double fBuildMS = 0.0;
+	double fTestMS = 0.0;
+	double fClipBuildMS = 0.0;
+	double fClipTestMS = 0.0;
+	uint32 nInFrustum = 0;
+	uint32 nCulled = 0;
+	uint32 nClipCulled = 0;
+	uint32 nClipOnly = 0;
+	uint32 nBufferOnly = 0;
+	uint32 nHidden = 0;
+	uint32 nCheckedScenes = 0;
+
+	for (uint32 nScene = 0; nScene < nScenes; ++nScene)
+	{
+		for (uint32 nBox = 0; nBox < nBoxes; ++nBox)
+			cScene.RandomBox(aBoxes[nBox * 2], aBoxes[nBox * 2 + 1]);
+
+		CBenchTimer timer;
+		cScene.Build(cBuffer, nOccluders);
+		fBuildMS += timer.GetMS();
+
+		timer.Start();
+		for (uint32 nBox = 0; nBox < nBoxes; ++nBox)
+			aOccluded[nBox] = cBuffer.IsAABBOccluded(aBoxes[nBox * 2], aBoxes[nBox * 2 + 1]);
+		fTestMS += timer.GetMS();
+
+		for (uint32 nBox = 0; nBox < nBoxes; ++nBox)
+			nCulled += aOccluded[nBox] ? 1 : 0;
+
+		timer.Start();
+		BuildClipOccluders(cScene, cFrustum, aClipOccluders, fClipScreenArea);
+		fClipBuildMS += timer.GetMS();
+
+		// Both paths only see the boxes that got past the frustum
+		for (uint32 nBox = 0; nBox < nBoxes; ++nBox)
+			aBoxSides[nBox] = cFrustum.ClassifyAABB(aBoxes[nBox * 2], aBoxes[nBox * 2 + 1], cScene.m_Params.m_FarZ);
+
+		timer.Start();
+		for (uint32 nBox = 0; nBox < nBoxes; ++nBox)
+		{
+			aClipOccluded[nBox] = (aBoxSides[nBox] != BackSide) &&
+				!IsAABBVisible_Clip(cScene, cFrustum, aClipOccluders, fClipScreenArea, cOccludee, aBoxes[nBox * 2], aBoxes[nBox * 2 + 1], aBoxSides[nBox]);
+		}
+		fClipTestMS += timer.GetMS();
+
+		for (uint32 nBox = 0; nBox < nBoxes; ++nBox)
+		{
+			if (aBoxSides[nBox] == BackSide)
+				continue;
+
+			++nInFrustum;
+			nClipCulled += aClipOccluded[nBox] ? 1 : 0;
+			nClipOnly += (aClipOccluded[nBox] && !aOccluded[nBox]) ? 1 : 0;
+			nBufferOnly += (!aClipOccluded[nBox] && aOccluded[nBox]) ? 1 : 0;
+		}
+
+		// The ray cast is slow, so it only looks at some of the scenes
+		if ((nScene % 10) == 0)
+		{
+			++nCheckedScenes;
+			for (uint32 nBox = 0; nBox < nBoxes; ++nBox)
+				nHidden += cScene.IsBoxVisible(aBoxes[nBox * 2], aBoxes[nBox * 2 + 1], 500) ? 0 : 1;
+		}
+	}
+
+	uint32 nTotalBoxes = nScenes * nBoxes;
+	printf("%u scenes of %u occluders, %u boxes each\n", nScenes, nOccluders, nBoxes);
+	printf("  culled         %6.2f%% of the boxes\n", 100.0 * nCulled / LTMAX(nTotalBoxes, 1u));
+	printf("  ray cast       %6.2f%% hidden (%u scenes)\n", 100.0 * nHidden / LTMAX(nCheckedScenes * nBoxes, 1u), nCheckedScenes);
+	printf("  build          %8.3f ms per scene\n", fBuildMS / LTMAX(nScenes, 1u));
+	printf("  test           %8.3f us per box\n", fTestMS * 1000.0 / LTMAX(nTotalBoxes, 1u));
+	printf("clipping occluders\n");
+	printf("  culled         %6.2f%% of the boxes\n", 100.0 * nClipCulled / LTMAX(nTotalBoxes, 1u));
+	printf("  build          %8.3f ms per scene\n", fClipBuildMS / LTMAX(nScenes, 1u));
+	printf("  test           %8.3f us per box\n", fClipTestMS * 1000.0 / LTMAX(nTotalBoxes, 1u));
+	printf("  %u boxes in the frustum, %u culled only by clipping, %u only by the buffer\n", nInFrustum, nClipOnly, nBufferOnly);
+
+	return 0;
+}
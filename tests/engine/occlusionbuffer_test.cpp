@@ -0,0 +1,97 @@
+// Occlusion buffer: a box is only reported as occluded if it really is hidden
+// behind the occluders, and the buffer only answers for the view it was built for.
+
+#include "bdefs.h"
+#include "occlusion_scene.h"
+#include "ltjs_test.h"
+
+
+// One quad facing the camera at the given depth
+static void AddQuad(COcclusionBuffer & cBuffer, float fHalfSize, float fZ)
+{
+	COccludee::COutline cOutline;
+	cOutline.push_back(LTVector(-fHalfSize, -fHalfSize, fZ));
+	cOutline.push_back(LTVector(fHalfSize, -fHalfSize, fZ));
+	cOutline.push_back(LTVector(fHalfSize, fHalfSize, fZ));
+	cOutline.push_back(LTVector(-fHalfSize, fHalfSize, fZ));
+	cBuffer.AddOccluder(cOutline);
+}
+
+static void TestSimple()
+{
+	COcclusionScene cScene(1);
+	COcclusionBuffer cBuffer;
+
+	LTJS_CHECK(!cBuffer.IsValid(cScene.m_Params));
+
+	cBuffer.Init(cScene.m_Params);
+	cBuffer.Finish();
+	LTJS_CHECK(cBuffer.IsValid(cScene.m_Params));
+
+	// Nothing is hidden by an empty buffer
+	LTJS_CHECK(!cBuffer.IsAABBOccluded(LTVector(-10.0f, -10.0f, 500.0f), LTVector(10.0f, 10.0f, 520.0f)));
+
+	cBuffer.Init(cScene.m_Params);
+	AddQuad(cBuffer, 50.0f, 100.0f);
+	cBuffer.Finish();
+	LTJS_CHECK(cBuffer.GetNumOccluders() == 1);
+
+	// Behind the quad, in front of it, poking out the side, and straddling it
+	LTJS_CHECK(cBuffer.IsAABBOccluded(LTVector(-10.0f, -10.0f, 500.0f), LTVector(10.0f, 10.0f, 520.0f)));
+	LTJS_CHECK(!cBuffer.IsAABBOccluded(LTVector(-10.0f, -10.0f, 50.0f), LTVector(10.0f, 10.0f, 60.0f)));
+	LTJS_CHECK(!cBuffer.IsAABBOccluded(LTVector(-10.0f, -10.0f, 500.0f), LTVector(2000.0f, 10.0f, 520.0f)));
+	LTJS_CHECK(!cBuffer.IsAABBOccluded(LTVector(-10.0f, -10.0f, 90.0f), LTVector(10.0f, 10.0f, 110.0f)));
+
+	// Another view
+	ViewParams cOther = cScene.m_Params;
+	cOther.m_FullTransform.m[0][3] += 1.0f;
+	LTJS_CHECK(!cBuffer.IsValid(cOther));
+
+	cBuffer.Term();
+	LTJS_CHECK(!cBuffer.IsValid(cScene.m_Params));
+}
+
+// Boxes the buffer calls occluded are checked by casting rays at points in them
+static void TestRandomScenes()
+{
+	COcclusionScene cScene(5);
+	COcclusionBuffer cBuffer;
+
+	uint32 nTested = 0;
+	uint32 nOccluded = 0;
+	uint32 nWrong = 0;
+
+	for (uint32 nScene = 0; nScene < 200; ++nScene)
+	{
+		cScene.Build(cBuffer, 1 + cScene.RandInt(6));
+
+		for (uint32 nBox = 0; nBox < 200; ++nBox)
+		{
+			LTVector vMin, vMax;
+			cScene.RandomBox(vMin, vMax);
+			++nTested;
+
+			if (!cBuffer.IsAABBOccluded(vMin, vMax))
+				continue;
+
+			++nOccluded;
+			if (cScene.IsBoxVisible(vMin, vMax, 2000))
+				++nWrong;
+		}
+	}
+
+	printf("%u boxes, %u occluded, %u wrongly\n", nTested, nOccluded, nWrong);
+
+	LTJS_CHECK(nWrong == 0);
+	// The scenes hide plenty of boxes, so a buffer that culls nothing doesn't pass either
+	LTJS_CHECK(nOccluded > nTested / 20);
+}
+
+
+int main()
+{
+	TestSimple();
+	TestRandomScenes();
+
+	return LTJS_TEST_RESULT();
+}
@@ -0,0 +1,310 @@
+// Save game I/O benchmark.  Writes and reads back a save laid out like the
+// object records sm_SaveObjects writes: two offsets patched in after the
+// record is written, the ObjectCreateStruct fields, a few strings and the
+// special effect and object messages.  Once straight on a stdio file stream
+// like streamsim_Open's, with the small writes and the seeks back to patch
+// the offsets, and once built in a CSerializeArena that's written with one
+// Write and read back with one Read.  Only the stream traffic is timed, the
+// objects' OnSave/OnLoad and creating them aren't part of it.
+//
+//   serialize_bench [objects]
+
+#include "bdefs.h"
+#include "serializearena.h"
+#include "ltjs_test.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+
+#define BENCH_RUNS		10
+#define BENCH_FILE		"serialize_bench.sav"
+
+
+// The file stream streamsim_Open returns on Windows.
+class CBenchFileStream : public CGenLTStream
+{
+public:
+
+	CBenchFileStream(const char *pFilename, const char *pAccess)
+	{
+		m_pFile = fopen(pFilename, pAccess);
+	}
+
+	~CBenchFileStream()
+	{
+		if (m_pFile)
+			fclose(m_pFile);
+	}
+
+	void		Release() { delete this; }
+
+	LTRESULT	Read(void *pData, uint32 size)
+	{
+		if (fread(pData, 1, size, m_pFile) == size)
+			return LT_OK;
+
+		memset(pData, 0, size);
+		return LT_ERROR;
+	}
+
+	LTRESULT	Write(const void *pData, uint32 size)
+	{
+		return (fwrite(pData, 1, size, m_pFile) == size) ? LT_OK : LT_ERROR;
+	}
+
+	LTRESULT	ErrorStatus()			{ return LT_OK; }
+	LTRESULT	SeekTo(uint32 offset)	{ return (fseek(m_pFile, offset, SEEK_SET) == 0) ? LT_OK : LT_ERROR; }
+	LTRESULT	GetPos(uint32 *offset)	{ *offset = (uint32)ftell(m_pFile); return LT_OK; }
+
+	LTRESULT	GetLen(uint32 *len)
+	{
+		long curPos = ftell(m_pFile);
+		fseek(m_pFile, 0, SEEK_END);
+		*len = (uint32)ftell(m_pFile);
+		fseek(m_pFile, curPos, SEEK_SET);
+		return LT_OK;
+	}
+
+	using ILTStream::GetPos;
+	using ILTStream::GetLen;
+
+	FILE	*m_pFile;
+};
+
+
+struct BenchObject
+{
+	uint32	m_nSpecialEffectBytes;
+	uint32	m_nMessageBytes;
+	bool	m_bModel;
+};
+
+
+static std::vector<uint8> s_MessageData(0x10000);
+
+
+// The fields of an object record, in the order sm_SaveObjectData writes them.
+static void WriteFields(ILTStream *pStream, const BenchObject &obj)
+{
+	uint8 objectType = obj.m_bModel ? 1 : 0;
+	uint32 nFlags = 0x1234, nUserFlags = 0;
+	LTVector vPos(1.0f, 2.0f, 3.0f);
+	LTRotation rRot;
+
+	pStream->WriteString("BenchObjectClass");
+	pStream->Write(&objectType, sizeof(objectType));
+	pStream->Write(&nFlags, sizeof(nFlags));
+	pStream->Write(&nFlags, sizeof(nFlags));
+	pStream->Write(&objectType, sizeof(objectType));
+	*pStream << vPos;
+	*pStream << vPos;
+	*pStream << vPos;
+	pStream->Write(&rRot, sizeof(rRot));
+	pStream->Write(&nUserFlags, sizeof(nUserFlags));
+	pStream->WriteString("BenchObject");
+	pStream->WriteString("models/bench/object.ltb");
+
+	// Child models and textures
+	if (obj.m_bModel)
+	{
+		for (uint32 i = 0; i < 8; i++)
+			pStream->WriteString(i ? "" : "skins/bench/object.dtx");
+	}
+
+	for (uint32 i = 0; i < 10; i++)
+		pStream->Write(&nFlags, sizeof(nFlags));
+
+	uint16 nSpecialEffectLen = (uint16)(obj.m_nSpecialEffectBytes * 8);
+	pStream->Write(&nSpecialEffectLen, sizeof(nSpecialEffectLen));
+	pStream->Write(&s_MessageData[0], obj.m_nSpecialEffectBytes);
+}
+
+static void ReadFields(ILTStream *pStream, const BenchObject &obj, uint8 *pBuffer, uint32 &nSum)
+{
+	char str[256];
+	uint8 objectType;
+	uint32 nFlags;
+	LTVector vPos;
+	LTRotation rRot;
+
+	pStream->ReadString(str, sizeof(str));
+	pStream->Read(&objectType, sizeof(objectType));
+	pStream->Read(&nFlags, sizeof(nFlags));
+	pStream->Read(&nFlags, sizeof(nFlags));
+	pStream->Read(&objectType, sizeof(objectType));
+	*pStream >> vPos;
+	*pStream >> vPos;
+	*pStream >> vPos;
+	pStream->Read(&rRot, sizeof(rRot));
+	pStream->Read(&nFlags, sizeof(nFlags));
+	pStream->ReadString(str, sizeof(str));
+	pStream->ReadString(str, sizeof(str));
+
+	if (obj.m_bModel)
+	{
+		for (uint32 i = 0; i < 8; i++)
+			pStream->ReadString(str, sizeof(str));
+	}
+
+	for (uint32 i = 0; i < 10; i++)
+		pStream->Read(&nFlags, sizeof(nFlags));
+
+	uint16 nSpecialEffectLen;
+	pStream->Read(&nSpecialEffectLen, sizeof(nSpecialEffectLen));
+	pStream->Read(pBuffer, (nSpecialEffectLen + 7) / 8);
+	nSum += pBuffer[0] + nFlags + objectType;
+}
+
+
+// The record with its offsets patched in by seeking back, like the old
+// sm_SaveObjectData did on the file stream and the arena still does.
+static void WriteObject(ILTStream *pStream, const BenchObject &obj)
+{
+	uint32 curPos = 0;
+	uint32 nextPos = pStream->GetPos();
+	pStream->Write(&curPos, sizeof(curPos));
+	uint32 objDataPos = pStream->GetPos();
+	pStream->Write(&curPos, sizeof(curPos));
+
+	WriteFields(pStream, obj);
+
+	curPos = pStream->GetPos();
+	pStream->SeekTo(objDataPos);
+	pStream->Write(&curPos, sizeof(curPos));
+	pStream->SeekTo(curPos);
+
+	uint32 nMessageLen = obj.m_nMessageBytes * 8;
+	pStream->Write(&nMessageLen, sizeof(nMessageLen));
+	pStream->Write(&s_MessageData[0], obj.m_nMessageBytes);
+
+	curPos = pStream->GetPos();
+	pStream->SeekTo(nextPos);
+	pStream->Write(&curPos, sizeof(curPos));
+	pStream->SeekTo(curPos);
+}
+
+// The old restore: the fields, then the object message through a temp buffer.
+static void ReadObject(ILTStream *pStream, const BenchObject &obj, uint8 *pBuffer, uint32 &nSum)
+{
+	uint32 nextPos, objDataPos, nMessageLen;
+	pStream->Read(&nextPos, sizeof(nextPos));
+	pStream->Read(&objDataPos, sizeof(objDataPos));
+
+	ReadFields(pStream, obj, pBuffer, nSum);
+
+	pStream->SeekTo(objDataPos);
+	pStream->Read(&nMessageLen, sizeof(nMessageLen));
+	pStream->Read(pBuffer, (nMessageLen + 7) / 8);
+	nSum += pBuffer[nMessageLen / 16];
+
+	pStream->SeekTo(nextPos);
+}
+
+// The arena restore: the object message is used where it lies.
+static void ReadObjectInPlace(CSerializeArena *pStream, const BenchObject &obj, uint8 *pBuffer, uint32 &nSum)
+{
+	uint32 nextPos, objDataPos, nMessageLen;
+	pStream->Read(&nextPos, sizeof(nextPos));
+	pStream->Read(&objDataPos, sizeof(objDataPos));
+
+	ReadFields(pStream, obj, pBuffer, nSum);
+
+	pStream->SeekTo(objDataPos);
+	pStream->Read(&nMessageLen, sizeof(nMessageLen));
+	const uint8 *pMessage = pStream->ReadInPlace((nMessageLen + 7) / 8);
+	nSum += pMessage ? pMessage[nMessageLen / 16] : 0;
+
+	pStream->SeekTo(nextPos);
+}
+
+
+static void RunSaveRestore(const std::vector<BenchObject> &objects)
+{
+	std::vector<uint8> buffer(0x10000);
+	uint32 nHeader = 2002;
+	double fSaveMS[2] = { 0.0, 0.0 }, fRestoreMS[2] = { 0.0, 0.0 };
+	uint32 nSum[2] = { 0, 0 }, nBytes = 0;
+	CBenchTimer timer;
+
+	for (uint32 nRun = 0; nRun < BENCH_RUNS; nRun++)
+	{
+		// Straight on the file stream
+		timer.Start();
+		{
+			CBenchFileStream stream(BENCH_FILE, "wb");
+			stream.Write(&nHeader, sizeof(nHeader));
+			for (uint32 i = 0; i < objects.size(); i++)
+				WriteObject(&stream, objects[i]);
+		}
+		fSaveMS[0] += timer.GetMS();
+
+		timer.Start();
+		{
+			CBenchFileStream stream(BENCH_FILE, "rb");
+			stream.Read(&nHeader, sizeof(nHeader));
+			for (uint32 i = 0; i < objects.size(); i++)
+				ReadObject(&stream, objects[i], &buffer[0], nSum[0]);
+		}
+		fRestoreMS[0] += timer.GetMS();
+
+		// Through the arena
+		timer.Start();
+		{
+			CBenchFileStream stream(BENCH_FILE, "wb");
+			stream.Write(&nHeader, sizeof(nHeader));
+
+			CSerializeArena arena(stream.GetPos());
+			arena.Reserve(nBytes);
+			for (uint32 i = 0; i < objects.size(); i++)
+				WriteObject(&arena, objects[i]);
+
+			arena.WriteTo(&stream);
+			nBytes = arena.GetDataSize();
+		}
+		fSaveMS[1] += timer.GetMS();
+
+		timer.Start();
+		{
+			CBenchFileStream stream(BENCH_FILE, "rb");
+			stream.Read(&nHeader, sizeof(nHeader));
+
+			CSerializeArena arena(stream.GetPos());
+			arena.ReadFrom(&stream);
+			for (uint32 i = 0; i < objects.size(); i++)
+				ReadObjectInPlace(&arena, objects[i], &buffer[0], nSum[1]);
+		}
+		fRestoreMS[1] += timer.GetMS();
+	}
+
+	remove(BENCH_FILE);
+
+	printf("  %u objects, %u bytes\n", (uint32)objects.size(), nBytes);
+	printf("  file stream   save %8.3f ms  restore %8.3f ms\n", fSaveMS[0] / BENCH_RUNS, fRestoreMS[0] / BENCH_RUNS);
+	printf("  arena         save %8.3f ms  restore %8.3f ms%s\n", fSaveMS[1] / BENCH_RUNS, fRestoreMS[1] / BENCH_RUNS,
+		(nSum[0] == nSum[1]) ? "" : "  (restored data differs)");
+}
+
+
+int main(int argc, char **argv)
+{
+	uint32 nObjects = (argc > 1) ? (uint32)atoi(argv[1]) : 2000;
+
+	for (uint32 i = 0; i < s_MessageData.size(); i++)
+		s_MessageData[i] = (uint8)i;
+
+	// Mostly small objects, a quarter of them models, now and then a big one
+	std::vector<BenchObject> objects(nObjects);
+	srand(1);
+	for (uint32 i = 0; i < nObjects; i++)
+	{
+		objects[i].m_nSpecialEffectBytes = 8 + rand() % 56;
+		objects[i].m_nMessageBytes = ((i % 50) == 0) ? 4096 + rand() % 8192 : 64 + rand() % 512;
+		objects[i].m_bModel = ((i % 4) == 0);
+	}
+
+	RunSaveRestore(objects);
+
+	return 0;
+}
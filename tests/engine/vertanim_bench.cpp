@@ -0,0 +1,173 @@
+// Vertex animation benchmark.  Blends two keyframes of a vertex animated mesh
+// into a vertex buffer the way CD3DVAMesh::UpdateVA does: the old per-vertex
+// lerp through CDefVertexLst::getValue with the dup verts read back from the
+// buffer, and va_LerpFloats into the blend buffer with va_WriteVerts writing
+// the buffer and the dup verts.  Then a frame with a few instances in the same
+// anim state and a couple of passes each, with and without the VABlendState
+// check that skips the updates the buffer already has.  The buffer is plain
+// memory here, not a locked write combined VB.
+//
+//   vertanim_bench [verts] [instances] [passes]
+
+#include "bdefs.h"
+#include "model.h"
+#include "d3dmeshrendobj_vablend.h"
+#include "ltjs_test.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+
+// Referenced by model.cpp.
+int32 g_CV_DebugModelRez = 0;
+void dsi_PrintToConsole(const char *pMsg, ...) {}
+
+
+#define BENCH_FRAMES		2000
+#define BENCH_KEYFRAMES		16
+#define BENCH_VERTEX_SIZE	32
+
+
+struct BenchMesh
+{
+	uint32					m_nUnDupVerts;
+	std::vector<DupMap>		m_DupMap;
+	std::vector<float>		m_BlendedVerts;
+	std::vector<uint8>		m_VB;
+	VABlendState			m_VBBlend;
+};
+
+
+// UpdateVA before the blend buffer.
+static void UpdateOld(BenchMesh &mesh, const CDefVertexLst *pPrev, const CDefVertexLst *pCur, float percent)
+{
+	uint8 *pVertData = &mesh.m_VB[0];
+	for (uint32 i = 0; i < mesh.m_nUnDupVerts; ++i)
+	{
+		const float *prv_val = pPrev->getValue(i);
+		const float *cur_val = pCur->getValue(i);
+
+		float *pPos = (float*)pVertData;
+		pPos[0] = prv_val[0] + ((cur_val[0] - prv_val[0]) * percent);
+		pPos[1] = prv_val[1] + ((cur_val[1] - prv_val[1]) * percent);
+		pPos[2] = prv_val[2] + ((cur_val[2] - prv_val[2]) * percent);
+
+		pVertData += BENCH_VERTEX_SIZE;
+	}
+
+	pVertData = &mesh.m_VB[0];
+	for (uint32 i = 0; i < mesh.m_DupMap.size(); ++i)
+	{
+		float *pDstVert = (float*)(pVertData + ((uint32)mesh.m_DupMap[i].iDstVert * BENCH_VERTEX_SIZE));
+		const float *pSrcVert = (const float*)(pVertData + ((uint32)mesh.m_DupMap[i].iSrcVert * BENCH_VERTEX_SIZE));
+		pDstVert[0] = pSrcVert[0]; pDstVert[1] = pSrcVert[1]; pDstVert[2] = pSrcVert[2];
+	}
+}
+
+// UpdateVA now.
+static void UpdateNew(BenchMesh &mesh, const CDefVertexLst *pPrev, const CDefVertexLst *pCur, float percent, bool bCheckBlend)
+{
+	if (bCheckBlend && mesh.m_VBBlend.Matches(pPrev, pCur, percent))
+		return;
+
+	va_LerpFloats(&mesh.m_BlendedVerts[0], pPrev->getArray(), pCur->getArray(), percent, mesh.m_nUnDupVerts * 3);
+	va_WriteVerts(&mesh.m_VB[0], BENCH_VERTEX_SIZE, &mesh.m_BlendedVerts[0], mesh.m_nUnDupVerts,
+		mesh.m_DupMap.empty() ? NULL : &mesh.m_DupMap[0], (uint32)mesh.m_DupMap.size());
+
+	mesh.m_VBBlend.Set(pPrev, pCur, percent);
+}
+
+
+int main(int argc, char **argv)
+{
+	uint32 nVerts = (argc > 1) ? (uint32)atoi(argv[1]) : 2000;
+	uint32 nInstances = (argc > 2) ? (uint32)atoi(argv[2]) : 4;
+	uint32 nPasses = (argc > 3) ? (uint32)atoi(argv[3]) : 3;
+
+	// The dup map indices are 16 bit
+	nVerts = LTCLAMP(nVerts, 1u, 52000u);
+
+	// A quarter of the verts more are dups of the first ones (UV seams)
+	BenchMesh mesh;
+	mesh.m_nUnDupVerts = nVerts;
+	srand(1);
+	for (uint32 i = 0; i < nVerts / 4; ++i)
+	{
+		DupMap dup;
+		dup.iSrcVert = (uint16)(rand() % nVerts);
+		dup.iDstVert = (uint16)(nVerts + i);
+		mesh.m_DupMap.push_back(dup);
+	}
+	mesh.m_BlendedVerts.resize(nVerts * 3);
+	mesh.m_VB.resize((nVerts + mesh.m_DupMap.size()) * BENCH_VERTEX_SIZE);
+
+	std::vector<CDefVertexLst*> keyFrames;
+	for (uint32 nKey = 0; nKey < BENCH_KEYFRAMES; ++nKey)
+	{
+		CDefVertexLst *pFrame = new CDefVertexLst(nVerts, &g_DefAlloc);
+		float *pPos = pFrame->getArray();
+		for (uint32 i = 0; i < nVerts * 3; ++i)
+			pPos[i] = (float)(rand() % 2000) * 0.05f - 50.0f;
+		keyFrames.push_back(pFrame);
+	}
+
+	// The anim states the frames are in
+	std::vector<uint32> frameKeys(BENCH_FRAMES);
+	std::vector<float> framePercents(BENCH_FRAMES);
+	for (uint32 nFrame = 0; nFrame < BENCH_FRAMES; ++nFrame)
+	{
+		frameKeys[nFrame] = rand() % (BENCH_KEYFRAMES - 1);
+		framePercents[nFrame] = (float)(rand() % 1000) / 1000.0f;
+	}
+
+	std::vector<uint8> oldVB;
+	CBenchTimer timer;
+	double fOldMS, fNewMS, fOldFrameMS, fNewFrameMS;
+
+	// One blend into the VB
+	timer.Start();
+	for (uint32 nFrame = 0; nFrame < BENCH_FRAMES; ++nFrame)
+		UpdateOld(mesh, keyFrames[frameKeys[nFrame]], keyFrames[frameKeys[nFrame] + 1], framePercents[nFrame]);
+	fOldMS = timer.GetMS();
+	oldVB = mesh.m_VB;
+
+	timer.Start();
+	for (uint32 nFrame = 0; nFrame < BENCH_FRAMES; ++nFrame)
+		UpdateNew(mesh, keyFrames[frameKeys[nFrame]], keyFrames[frameKeys[nFrame] + 1], framePercents[nFrame], false);
+	fNewMS = timer.GetMS();
+
+	bool bSame = (memcmp(&oldVB[0], &mesh.m_VB[0], oldVB.size()) == 0);
+
+	// Every pass of every instance updates the VB
+	uint32 nUpdates = nInstances * nPasses;
+	timer.Start();
+	for (uint32 nFrame = 0; nFrame < BENCH_FRAMES; ++nFrame)
+	{
+		for (uint32 nUpdate = 0; nUpdate < nUpdates; ++nUpdate)
+			UpdateOld(mesh, keyFrames[frameKeys[nFrame]], keyFrames[frameKeys[nFrame] + 1], framePercents[nFrame]);
+	}
+	fOldFrameMS = timer.GetMS();
+
+	mesh.m_VBBlend.Clear();
+	timer.Start();
+	for (uint32 nFrame = 0; nFrame < BENCH_FRAMES; ++nFrame)
+	{
+		for (uint32 nUpdate = 0; nUpdate < nUpdates; ++nUpdate)
+			UpdateNew(mesh, keyFrames[frameKeys[nFrame]], keyFrames[frameKeys[nFrame] + 1], framePercents[nFrame], true);
+	}
+	fNewFrameMS = timer.GetMS();
+
+	printf("%u verts, %u dups, %u byte vertices\n", nVerts, (uint32)mesh.m_DupMap.size(), BENCH_VERTEX_SIZE);
+	printf("  per-vertex lerp      %8.3f us per update\n", fOldMS * 1000.0 / BENCH_FRAMES);
+	printf("  va_LerpFloats        %8.3f us per update%s\n", fNewMS * 1000.0 / BENCH_FRAMES, bSame ? "" : "  (VB differs)");
+	printf("%u instances x %u passes in the same anim state\n", nInstances, nPasses);
+	printf("  every update         %8.3f us per frame\n", fOldFrameMS * 1000.0 / BENCH_FRAMES);
+	printf("  VABlendState         %8.3f us per frame\n", fNewFrameMS * 1000.0 / BENCH_FRAMES);
+
+	for (uint32 nKey = 0; nKey < keyFrames.size(); ++nKey)
+		delete keyFrames[nKey];
+
+	return 0;
+}
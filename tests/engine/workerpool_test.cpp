@@ -0,0 +1,116 @@
+// Worker pool: every item runs exactly once in the expected bands, from any
+// number of callers at once and from inside another loop.
+
+#include "bdefs.h"
+#include "workerpool.h"
+#include "ltjs_test.h"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+// Runs a loop that counts how many times each item was visited and records its bands.
+static void CheckLoop(uint32 nCount, uint32 nMaxBands)
+{
+	std::vector<std::atomic<uint32>> visits(nCount);
+	for (uint32 i = 0; i < nCount; i++)
+		visits[i] = 0;
+
+	std::mutex bandLock;
+	std::vector<std::pair<uint32, uint32>> bands;
+
+	wp_ForEachBand(nCount, nMaxBands, [&](uint32 nStart, uint32 nEnd)
+	{
+		for (uint32 i = nStart; i < nEnd; i++)
+			visits[i]++;
+
+		std::lock_guard<std::mutex> lock(bandLock);
+		bands.push_back(std::make_pair(nStart, nEnd));
+	});
+
+	bool bAllOnce = true;
+	for (uint32 i = 0; i < nCount; i++)
+		bAllOnce = bAllOnce && (visits[i] == 1);
+	LTJS_CHECK(bAllOnce);
+
+	// The bands are the same no matter which threads end up running them.
+	uint32 nBands = LTMIN(LTMIN(nMaxBands, nCount), wp_GetNumThreads());
+	if (nBands <= 1)
+	{
+		LTJS_CHECK(bands.size() == 1);
+		LTJS_CHECK(bands[0].first == 0 && bands[0].second == nCount);
+		return;
+	}
+
+	uint32 nBandSize = (nCount + nBands - 1) / nBands;
+	LTJS_CHECK(bands.size() == nBands);
+	for (size_t i = 0; i < bands.size(); i++)
+	{
+		LTJS_CHECK((bands[i].first % nBandSize) == 0);
+		LTJS_CHECK(bands[i].second == LTMIN(bands[i].first + nBandSize, nCount));
+	}
+}
+
+
+int main()
+{
+	// Split up to 8 ways whatever the machine has, so the workers get used.
+	wp_SetNumThreads(8);
+	LTJS_CHECK(wp_GetNumThreads() == 8);
+
+	CheckLoop(0, 8);
+	CheckLoop(1, 8);
+	CheckLoop(7, 8);
+	CheckLoop(1000, 1);
+	CheckLoop(1000, 3);
+	CheckLoop(1001, 8);
+	CheckLoop(100000, 16);
+
+	// A single band runs on the calling thread.
+	std::thread::id callerId = std::this_thread::get_id();
+	bool bOnCaller = false;
+	wp_ForEachBand(100, 1, [&](uint32 nStart, uint32 nEnd) { bOnCaller = (std::this_thread::get_id() == callerId); });
+	LTJS_CHECK(bOnCaller);
+
+	// A loop started from inside a band runs inline.
+	std::atomic<uint32> nInner(0);
+	wp_ForEachBand(64, 8, [&](uint32 nStart, uint32 nEnd)
+	{
+		wp_ForEachBand(nEnd - nStart, 8, [&](uint32 nInnerStart, uint32 nInnerEnd)
+		{
+			nInner += nInnerEnd - nInnerStart;
+		});
+	});
+	LTJS_CHECK(nInner == 64);
+
+	// Loops from several threads at once, only one of which gets the pool at a time.
+	std::atomic<uint32> nTotal(0);
+	std::vector<std::thread> callers;
+	for (uint32 nThread = 0; nThread < 4; nThread++)
+	{
+		callers.push_back(std::thread([&]
+		{
+			for (uint32 nLoop = 0; nLoop < 500; nLoop++)
+			{
+				wp_ForEachBand(256, 8, [&](uint32 nStart, uint32 nEnd) { nTotal += nEnd - nStart; });
+			}
+		}));
+	}
+	for (size_t i = 0; i < callers.size(); i++)
+		callers[i].join();
+	LTJS_CHECK(nTotal == 4 * 500 * 256);
+
+	// Lots of back to back loops, the way a frame uses the pool.
+	for (uint32 nLoop = 0; nLoop < 2000; nLoop++)
+	{
+		CheckLoop(64 + (nLoop % 7), 8);
+	}
+
+	// Too late to change once the pool has started.
+	wp_SetNumThreads(2);
+	LTJS_CHECK(wp_GetNumThreads() == 8);
+
+	return LTJS_TEST_RESULT();
+}
@@ -0,0 +1,99 @@
+// WorldTree benchmark.  Times moving objects with InsertObject2, which
+// relinks them in place, against removing them and inserting them again, for
+// small objects walking around and for large ones that span many nodes.
+//
+//   world_tree_bench [objects]
+
+#include "bdefs.h"
+#include "world_tree_layout.h"
+#include "ltjs_test.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+
+#define BENCH_FRAMES	200
+
+
+class CBenchObj : public WorldTreeObj
+{
+public:
+
+	CBenchObj() : WorldTreeObj(WTObj_DObject) {}
+};
+
+
+static float RandFloat(float fMax)
+{
+	return fMax * (float)rand() / (float)RAND_MAX;
+}
+
+
+static void RunMoves(const char *pName, uint32 nObjects, float fSize, float fStep)
+{
+	CTestTreeHelper helper;
+	WorldTree tree;
+	tree.InitWorldTree(&helper);
+	LoadTestLayout(tree, 5);
+
+	std::vector<CBenchObj> objs(nObjects);
+	std::vector<LTVector> pos(nObjects);
+	const LTVector vDims(fSize, fSize, fSize);
+	CBenchTimer timer;
+
+	for (uint32 nMode = 0; nMode < 2; nMode++)
+	{
+		bool bReinsert = (nMode == 0);
+
+		srand(1);
+		for (uint32 i = 0; i < nObjects; i++)
+		{
+			pos[i].Init(RandFloat(1024.0f), 50.0f, RandFloat(1024.0f));
+			objs[i].RemoveFromWorldTree();
+			tree.InsertObject2(&objs[i], pos[i] - vDims, pos[i] + vDims);
+		}
+		tree.ResetRelinkCounts();
+
+		timer.Start();
+		for (uint32 nFrame = 0; nFrame < BENCH_FRAMES; nFrame++)
+		{
+			for (uint32 i = 0; i < nObjects; i++)
+			{
+				pos[i].x += RandFloat(2.0f * fStep) - fStep;
+				pos[i].z += RandFloat(2.0f * fStep) - fStep;
+
+				if (bReinsert)
+					objs[i].RemoveFromWorldTree();
+				tree.InsertObject2(&objs[i], pos[i] - vDims, pos[i] + vDims);
+			}
+		}
+		double fMS = timer.GetMS();
+
+		uint32 nMoves = nObjects * BENCH_FRAMES;
+		printf("  %-14s %-9s %7.1f ns", pName, bReinsert ? "reinsert" : "relink", fMS * 1000000.0 / nMoves);
+		if (!bReinsert)
+		{
+			printf(", %.0f%% skipped, %.0f%% relinked",
+				100.0 * tree.GetNumRelinksSkipped() / nMoves, 100.0 * tree.GetNumRelinksPerformed() / nMoves);
+		}
+		printf("\n");
+	}
+
+	for (uint32 i = 0; i < nObjects; i++)
+		objs[i].RemoveFromWorldTree();
+}
+
+
+int main(int argc, char **argv)
+{
+	uint32 nObjects = (argc > 1) ? (uint32)atoi(argv[1]) : 5000;
+
+	printf("%u objects, %u frames, 1024 nodes at the bottom\n", nObjects, BENCH_FRAMES);
+
+	RunMoves("small, walking", nObjects, 2.0f, 1.0f);
+	RunMoves("small, running", nObjects, 2.0f, 6.0f);
+	RunMoves("large", nObjects / 10, 60.0f, 2.0f);
+
+	return 0;
+}
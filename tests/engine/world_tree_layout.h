@@ -0,0 +1,112 @@
+// A WorldTree over a 1024 x 100 x 1024 level, subdivided evenly to a fixed
+// depth, for the WorldTree test and benchmark.
+
+#ifndef __WORLD_TREE_LAYOUT_H__
+#define __WORLD_TREE_LAYOUT_H__
+
+#include "world_tree.h"
+#include "worldtreehelper.h"
+
+#include <string.h>
+#include <vector>
+
+
+class CTestTreeHelper : public WorldTreeHelper
+{
+public:
+
+	CTestTreeHelper() : m_nFrameCode(1) {}
+
+	virtual uint32 IncFrameCode()	{ return ++m_nFrameCode; }
+	virtual uint32 GetFrameCode()	{ return m_nFrameCode; }
+
+private:
+
+	uint32	m_nFrameCode;
+};
+
+
+// Reads the layout LoadLayout expects out of memory.
+class CLayoutStream : public ILTStream
+{
+public:
+
+	CLayoutStream() : m_nPos(0) {}
+
+	virtual void Release() {}
+
+	virtual LTRESULT Read(void *pData, uint32 size)
+	{
+		if (m_nPos + size > m_Data.size())
+		{
+			memset(pData, 0, size);
+			return LT_ERROR;
+		}
+
+		memcpy(pData, &m_Data[m_nPos], size);
+		m_nPos += size;
+		return LT_OK;
+	}
+
+	virtual LTRESULT Write(const void *pData, uint32 size)
+	{
+		m_Data.insert(m_Data.end(), (const uint8*)pData, (const uint8*)pData + size);
+		return LT_OK;
+	}
+
+	virtual LTRESULT ReadString(char *pStr, uint32 maxBytes)	{ return LT_ERROR; }
+	virtual LTRESULT ErrorStatus()								{ return LT_OK; }
+	virtual LTRESULT SeekTo(uint32 offset)						{ m_nPos = offset; return LT_OK; }
+	virtual LTRESULT GetPos(uint32 *offset)						{ *offset = m_nPos; return LT_OK; }
+	virtual LTRESULT GetLen(uint32 *len)						{ *len = (uint32)m_Data.size(); return LT_OK; }
+	virtual LTRESULT WriteStream(ILTStream &dsSource, uint32 dwMin, uint32 dwMax) { return LT_ERROR; }
+	virtual LTRESULT WriteString(const char *pStr)				{ return LT_ERROR; }
+
+private:
+
+	std::vector<uint8>	m_Data;
+	uint32				m_nPos;
+};
+
+
+// One subdivide bit per node, depth first.
+static void AddLayoutNodes(std::vector<bool> &subdivide, uint32 nDepth, uint32 nMaxDepth)
+{
+	subdivide.push_back(nDepth < nMaxDepth);
+	if (nDepth < nMaxDepth)
+	{
+		for (uint32 i = 0; i < MAX_WTNODE_CHILDREN; i++)
+			AddLayoutNodes(subdivide, nDepth + 1, nMaxDepth);
+	}
+}
+
+
+static bool LoadTestLayout(WorldTree &tree, uint32 nMaxDepth)
+{
+	std::vector<bool> subdivide;
+	AddLayoutNodes(subdivide, 0, nMaxDepth);
+
+	CLayoutStream stream;
+	LTVector vMin(0.0f, 0.0f, 0.0f), vMax(1024.0f, 100.0f, 1024.0f);
+	uint32 nNodes = (uint32)subdivide.size(), nTerrainDepth = 0;
+	stream.Write(&vMin, sizeof(vMin));
+	stream.Write(&vMax, sizeof(vMax));
+	stream.Write(&nNodes, sizeof(nNodes));
+	stream.Write(&nTerrainDepth, sizeof(nTerrainDepth));
+
+	for (uint32 i = 0; i < subdivide.size(); i += 8)
+	{
+		uint8 curByte = 0;
+		for (uint32 nBit = 0; nBit < 8 && i + nBit < subdivide.size(); nBit++)
+		{
+			if (subdivide[i + nBit])
+				curByte |= 1 << nBit;
+		}
+		stream.Write(&curByte, 1);
+	}
+
+	return tree.LoadLayout(&stream);
+}
+
+
+#endif
@@ -0,0 +1,133 @@
+// WorldTree: objects moved with InsertObject2 end up on the same nodes, with
+// the same counts, as the same objects removed and inserted again, their
+// filter links stay packed, and most small moves don't touch any links.
+
+#include "bdefs.h"
+#include "world_tree_layout.h"
+#include "ltjs_test.h"
+
+#include <algorithm>
+#include <stdlib.h>
+#include <vector>
+
+
+class CTestObj : public WorldTreeObj
+{
+public:
+
+	CTestObj() : WorldTreeObj(WTObj_DObject), m_nID(0) {}
+
+	uint32	m_nID;
+};
+
+
+static float RandFloat(float fMax)
+{
+	return fMax * (float)rand() / (float)RAND_MAX;
+}
+
+
+// Compares the object lists of the nodes below a and b and checks the counts
+// of both against them.  Returns the links on or below the node.
+static uint32 CompareNodes(WorldTreeNode *a, WorldTreeNode *b, bool &bSame)
+{
+	std::vector<uint32> idsA, idsB;
+
+	CheapLTLink *pListA = &a->m_Objects[NOA_Objects];
+	for (LTLink *pCur = pListA->m_pNext; pCur != pListA->AsDLink(); pCur = pCur->m_pNext)
+		idsA.push_back(((CTestObj*)pCur->m_pData)->m_nID);
+
+	CheapLTLink *pListB = &b->m_Objects[NOA_Objects];
+	for (LTLink *pCur = pListB->m_pNext; pCur != pListB->AsDLink(); pCur = pCur->m_pNext)
+		idsB.push_back(((CTestObj*)pCur->m_pData)->m_nID);
+
+	std::sort(idsA.begin(), idsA.end());
+	std::sort(idsB.begin(), idsB.end());
+	bSame = bSame && (idsA == idsB);
+
+	uint32 nLinks = (uint32)idsA.size();
+	if (a->HasChildren())
+	{
+		for (uint32 i = 0; i < MAX_WTNODE_CHILDREN; i++)
+			nLinks += CompareNodes(a->GetChild(i), b->GetChild(i), bSame);
+	}
+
+	bSame = bSame && (a->GetNumObjectsOnOrBelow() == nLinks) && (b->GetNumObjectsOnOrBelow() == nLinks);
+	return nLinks;
+}
+
+
+// Small objects wandering around, a few large ones spanning many nodes, and
+// now and then an object that grows or shrinks past a node size.
+static void CheckRelinkMatchesReinsert()
+{
+	CTestTreeHelper helper;
+	WorldTree relinked, reinserted;
+	relinked.InitWorldTree(&helper);
+	reinserted.InitWorldTree(&helper);
+	LTJS_CHECK(LoadTestLayout(relinked, 5));
+	LTJS_CHECK(LoadTestLayout(reinserted, 5));
+
+	const uint32 nObjects = 3000;
+	std::vector<CTestObj> objsA(nObjects), objsB(nObjects);
+	std::vector<LTVector> pos(nObjects), dims(nObjects);
+
+	srand(1);
+	for (uint32 i = 0; i < nObjects; i++)
+	{
+		objsA[i].m_nID = objsB[i].m_nID = i;
+		pos[i].Init(RandFloat(1024.0f), 50.0f, RandFloat(1024.0f));
+
+		float fSize = ((i % 50) == 0) ? 100.0f + RandFloat(200.0f) : 1.0f + RandFloat(8.0f);
+		dims[i].Init(fSize, fSize, fSize);
+	}
+
+	bool bSame = true, bPacked = true;
+	for (uint32 nFrame = 0; nFrame < 200; nFrame++)
+	{
+		for (uint32 i = 0; i < nObjects; i++)
+		{
+			pos[i].x += RandFloat(6.0f) - 3.0f;
+			pos[i].z += RandFloat(6.0f) - 3.0f;
+			if ((i % 97) == (nFrame % 97))
+			{
+				float fSize = (rand() & 1) ? 2.0f : 150.0f;
+				dims[i].Init(fSize, fSize, fSize);
+			}
+
+			LTVector vMin = pos[i] - dims[i], vMax = pos[i] + dims[i];
+			relinked.InsertObject2(&objsA[i], vMin, vMax);
+			objsB[i].RemoveFromWorldTree();
+			reinserted.InsertObject2(&objsB[i], vMin, vMax);
+
+			for (uint32 nLink = 0; nLink < MAX_OBJ_NODE_LINKS; nLink++)
+				bPacked = bPacked && ((nLink < objsA[i].m_nFilterLinks) == (objsA[i].m_Links[nLink].m_pNode != LTNULL));
+		}
+
+		CompareNodes(relinked.GetRootNode(), reinserted.GetRootNode(), bSame);
+	}
+
+	LTJS_CHECK(bSame);
+	LTJS_CHECK(bPacked);
+
+	// Most moves stay on the same nodes
+	LTJS_CHECK(relinked.GetNumRelinksSkipped() > 4 * relinked.GetNumRelinksPerformed());
+	LTJS_CHECK(reinserted.GetNumRelinksSkipped() == 0 && reinserted.GetNumRelinksPerformed() == 0);
+
+	for (uint32 i = 0; i < nObjects; i++)
+	{
+		objsA[i].RemoveFromWorldTree();
+		objsB[i].RemoveFromWorldTree();
+	}
+
+	LTJS_CHECK(relinked.GetRootNode()->GetNumObjectsOnOrBelow() == 0);
+	LTJS_CHECK(reinserted.GetRootNode()->GetNumObjectsOnOrBelow() == 0);
+}
+
+
+int main()
+{
+	CheckRelinkMatchesReinsert();
+
+	return LTJS_TEST_RESULT();
+}
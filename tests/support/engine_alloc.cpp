@@ -0,0 +1,15 @@
+//////////////////////////////////////////////////////////////////////////////
+// Test implementation of the engine allocator
+
+#include "bdefs.h"
+#include <stdlib.h>
+
+void* dalloc(uint32 size)
+{
+	return malloc((size_t)size);
+}
+
+void dfree(void *ptr)
+{
+	free(ptr);
+}
@@ -0,0 +1,53 @@
+// Minimal checks for the test executables.  A test's main() runs its checks
+// and returns LTJS_TEST_RESULT(), which is non-zero if any of them failed.
+
+#ifndef __LTJS_TEST_H__
+#define __LTJS_TEST_H__
+
+#include <chrono>
+#include <stdio.h>
+
+inline int& ltjs_test_failures()
+{
+	static int nFailures = 0;
+	return nFailures;
+}
+
+#define LTJS_CHECK(expr) \
+	do { \
+		if (!(expr)) { \
+			printf("%s(%d): check failed: %s\n", __FILE__, __LINE__, #expr); \
+			ltjs_test_failures()++; \
+		} \
+	} while (0)
+
+#define LTJS_CHECK_NEAR(a, b, eps) \
+	do { \
+		double fCheckA = (double)(a), fCheckB = (double)(b); \
+		if (!(fCheckA - fCheckB <= (eps) && fCheckB - fCheckA <= (eps))) { \
+			printf("%s(%d): check failed: %s == %s (%g != %g)\n", __FILE__, __LINE__, #a, #b, fCheckA, fCheckB); \
+			ltjs_test_failures()++; \
+		} \
+	} while (0)
+
+#define LTJS_TEST_RESULT() \
+	(ltjs_test_failures() ? (printf("%d check(s) failed\n", ltjs_test_failures()), 1) : (printf("passed\n"), 0))
+
+
+// Wall clock for the benchmarks, in milliseconds.
+class CBenchTimer
+{
+public:
+	CBenchTimer() { Start(); }
+
+	void	Start()		{ m_Start = std::chrono::steady_clock::now(); }
+	double	GetMS() const
+	{
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_Start).count();
+	}
+
+private:
+	std::chrono::steady_clock::time_point m_Start;
+};
+
+#endif  // __LTJS_TEST_H__
@@ -0,0 +1 @@
+// Empty on Linux.
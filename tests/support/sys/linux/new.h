@@ -0,0 +1,2 @@
+// <new.h> is MSVC only.
+#include <new>
@@ -0,0 +1,40 @@
+// Just enough of the Win32 declarations for the libraries under test to
+// build on Linux.
+
+#ifndef __TESTS_LINUX_WINDOWS_H__
+#define __TESTS_LINUX_WINDOWS_H__
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+
+typedef unsigned long DWORD;
+typedef unsigned short WORD;
+typedef unsigned char BYTE;
+typedef unsigned int UINT;
+typedef long LONG;
+typedef int BOOL;
+typedef void* HANDLE;
+typedef char* LPSTR;
+typedef const char* LPCSTR;
+typedef const char* LPCTSTR;
+
+#define __int64 long long
+
+#define FALSE 0
+#define TRUE 1
+
+#define WINAPI
+
+#define stricmp strcasecmp
+#define strnicmp strncasecmp
+#define _stricmp strcasecmp
+#define _strnicmp strncasecmp
+#define _vsnprintf vsnprintf
+
+inline char* _strupr(char* s) { for (char* p = s; *p; p++) { if (*p >= 'a' && *p <= 'z') *p -= 'a' - 'A'; } return s; }
+inline char* _strlwr(char* s) { for (char* p = s; *p; p++) { if (*p >= 'A' && *p <= 'Z') *p += 'a' - 'A'; } return s; }
+inline char* _strrev(char* s) { size_t n = strlen(s); for (size_t i = 0; i < n / 2; i++) { char c = s[i]; s[i] = s[n - 1 - i]; s[n - 1 - i] = c; } return s; }
+
+#endif  // __TESTS_LINUX_WINDOWS_H__